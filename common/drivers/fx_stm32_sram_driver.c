@@ -34,6 +34,10 @@ UCHAR *destination_buffer;
 UINT   bytes_per_sector;
 UCHAR *destination_buffer_end;
 UCHAR *source_buffer_end;
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+ULONG  i;
+FX_DRIVER_SEGMENT *segment_ptr;
+#endif
 /* Calculate SRAM disk end address */
 UCHAR *sram_disk_end = ((UCHAR *)(FX_SRAM_DISK_BASE_ADDRESS + FX_SRAM_DISK_SIZE));
     /* Process the driver request specified in the media control block.  */
@@ -52,6 +56,10 @@ UCHAR *sram_disk_end = ((UCHAR *)(FX_SRAM_DISK_BASE_ADDRESS + FX_SRAM_DISK_SIZE)
                 _fx_utility_memory_set((UCHAR *)FX_SRAM_DISK_BASE_ADDRESS, '\0', FX_SRAM_DISK_SIZE);
                 is_initialized = 1;
             }
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+            /* Fragmented file reads and writes are sent as one request with a list of segments */
+            media_ptr -> fx_media_driver_scatter_gather_supported =  FX_TRUE;
+#endif
             media_ptr -> fx_media_driver_status =  FX_SUCCESS;
             break;
         }
@@ -120,6 +128,44 @@ UCHAR *sram_disk_end = ((UCHAR *)(FX_SRAM_DISK_BASE_ADDRESS + FX_SRAM_DISK_SIZE)
             }
         }
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+        case FX_DRIVER_SCATTER_READ:
+        case FX_DRIVER_GATHER_WRITE:
+        {
+
+            /* Copy each segment between the SRAM disk and its buffer. */
+            media_ptr -> fx_media_driver_status =  FX_SUCCESS;
+            segment_ptr = media_ptr->fx_media_driver_segment_list;
+            for (i = 0; i < media_ptr->fx_media_driver_segments; i++, segment_ptr++)
+            {
+
+                /* Calculate the SRAM disk sector offset of the segment */
+                source_buffer = ((UCHAR *)FX_SRAM_DISK_BASE_ADDRESS) +
+                                 ((segment_ptr->fx_driver_segment_logical_sector + media_ptr->fx_media_hidden_sectors) * media_ptr->fx_media_bytes_per_sector);
+                source_buffer_end = source_buffer + (segment_ptr->fx_driver_segment_sectors * media_ptr->fx_media_bytes_per_sector);
+
+                /* Check the segment does not exceed sram disk end address */
+                if (source_buffer_end  > sram_disk_end)
+                {
+                  media_ptr -> fx_media_driver_status =  FX_PTR_ERROR;
+                  break;
+                }
+
+                if (media_ptr->fx_media_driver_request == FX_DRIVER_SCATTER_READ)
+                {
+                  _fx_utility_memory_copy(source_buffer, segment_ptr->fx_driver_segment_buffer,
+                                          segment_ptr->fx_driver_segment_sectors * media_ptr->fx_media_bytes_per_sector);
+                }
+                else
+                {
+                  _fx_utility_memory_copy(segment_ptr->fx_driver_segment_buffer, source_buffer,
+                                          segment_ptr->fx_driver_segment_sectors * media_ptr->fx_media_bytes_per_sector);
+                }
+            }
+            break;
+        }
+#endif
+
         case FX_DRIVER_FLUSH:
         {
 
@@ -60,6 +60,11 @@ VOID  fx_stm32_custom_driver(FX_MEDIA *media_ptr)
 
      /* USER CODE END DRIVER_INIT */
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+      /* Fragmented file reads and writes are sent as one request with a list of segments */
+      media_ptr->fx_media_driver_scatter_gather_supported = FX_TRUE;
+#endif
+
       media_ptr->fx_media_driver_status = FX_SUCCESS;
 
 
@@ -140,6 +145,44 @@ VOID  fx_stm32_custom_driver(FX_MEDIA *media_ptr)
       break;
     }
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+    case FX_DRIVER_SCATTER_READ:
+    {
+    /* USER CODE BEGIN DRIVER_SCATTER_READ */
+
+    /* Read media_ptr->fx_media_driver_segments segments, each segment of
+       media_ptr->fx_media_driver_segment_list holds a logical sector, a number of sectors
+       and the destination buffer */
+
+     /* USER CODE END DRIVER_SCATTER_READ */
+
+      media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+    /* USER CODE BEGIN POST_DRIVER_SCATTER_READ */
+
+     /* USER CODE END POST_DRIVER_SCATTER_READ */
+      break;
+    }
+
+    case FX_DRIVER_GATHER_WRITE:
+    {
+    /* USER CODE BEGIN DRIVER_GATHER_WRITE */
+
+    /* Write media_ptr->fx_media_driver_segments segments, each segment of
+       media_ptr->fx_media_driver_segment_list holds a logical sector, a number of sectors
+       and the source buffer */
+
+     /* USER CODE END DRIVER_GATHER_WRITE */
+
+      media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+    /* USER CODE BEGIN POST_DRIVER_GATHER_WRITE */
+
+     /* USER CODE END POST_DRIVER_GATHER_WRITE */
+      break;
+    }
+#endif
+
     case FX_DRIVER_FLUSH:
     {
     /* USER CODE BEGIN DRIVER_FLUSH */
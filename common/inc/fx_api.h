@@ -381,6 +381,8 @@ VOID _fx_trace_event_update(TX_TRACE_BUFFER_ENTRY *event, ULONG timestamp, ULONG
 #define FX_FILE_CLOSED_ID                      ((ULONG)0x46494C43)
 #define FX_FILE_ABORTED_ID                     ((ULONG)0x46494C41)
 
+#define FX_SECTOR_CACHE_POOL_ID                ((ULONG)0x5343504C)
+
 
 /* The maximum path includes the entire path and the file name.  */
 
@@ -429,6 +431,291 @@ VOID _fx_trace_event_update(TX_TRACE_BUFFER_ENTRY *event, ULONG timestamp, ULONG
 #define FX_SECTOR_CACHE_HASH_ENABLE            16
 #define FX_SECTOR_CACHE_DEPTH                  4
 
+/* Define the alternate logical sector cache organization. If FX_ENABLE_LRU_SECTOR_CACHE is defined,
+   cached sectors are located through a chained hash table and kept on a doubly-linked least recently
+   used list, so both lookups and replacement take constant time regardless of the cache size. Up to
+   FX_MAX_SECTOR_CACHE sectors are managed with the control blocks built into FX_MEDIA. Larger buffers
+   supplied to fx_media_open are not truncated; instead, the control blocks and hash buckets for all
+   sectors are allocated from the end of the supplied buffer. When fx_media_cache_resize moves the
+   cache to a different buffer, the valid sectors are carried over to the new buffer.  */
+
+/* Define the scan resistant logical sector cache policy. If FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE is
+   defined, data sectors (FX_DATA_SECTOR) that enter the cache are placed on a separate probationary
+   queue instead of the head of the least recently used list, similar to the 2Q replacement policy.
+   Only a data sector that is referenced again after another data sector was cached is promoted to
+   the protected list, so streaming through a large file cannot push FAT and directory sectors out
+   of the cache. The probationary queue holds at most 1/(2^FX_SECTOR_CACHE_PROBATION_SHIFT) of the
+   cached sectors. This policy is built on FX_ENABLE_LRU_SECTOR_CACHE, which is enabled with it.  */
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+#ifndef FX_ENABLE_LRU_SECTOR_CACHE
+#define FX_ENABLE_LRU_SECTOR_CACHE
+#endif
+
+#ifndef FX_SECTOR_CACHE_PROBATION_SHIFT
+#define FX_SECTOR_CACHE_PROBATION_SHIFT        2
+#endif
+#endif
+
+/* Define the logical sector cache partitions. If FX_ENABLE_SECTOR_CACHE_PARTITION is defined,
+   fx_media_cache_partition_set can reserve a share of the logical sector cache for FAT sectors, for
+   directory sectors (including boot and unknown sectors) and for data sectors. Each partition is
+   replaced in least recently used order on its own, so a burst of one sector type cannot evict the
+   sectors of another type. The data partition gets the entries the other two leave, so its share
+   must not be zero and the percentages must not add up to more than 100. This option is built on FX_ENABLE_LRU_SECTOR_CACHE, which is enabled
+   with it.  */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+#ifndef FX_ENABLE_LRU_SECTOR_CACHE
+#define FX_ENABLE_LRU_SECTOR_CACHE
+#endif
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+#error "FX_ENABLE_SECTOR_CACHE_PARTITION cannot be used with FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE"
+#endif
+
+#define FX_SECTOR_CACHE_PARTITION_FAT          0
+#define FX_SECTOR_CACHE_PARTITION_DIRECTORY    1
+#define FX_SECTOR_CACHE_PARTITION_DATA         2
+#define FX_SECTOR_CACHE_PARTITIONS             3
+#endif
+
+/* Define the zero-copy file read. If FX_ENABLE_FILE_READ_BORROW is defined, fx_file_read_borrow
+   returns a pointer to the file data at the current offset inside the logical sector cache instead
+   of copying it, up to the end of the current sector or of the file, and advances the offset past
+   these bytes. The cache entry stays pinned, so it is not replaced until the file calls
+   fx_file_read_release, borrows again or is closed. At most half of the cache entries available
+   to data sectors may be pinned at the same time. The borrowed bytes must not be modified. They
+   reflect later writes of the sector through the cache, but not direct writes of whole sectors.
+   This option is built on FX_ENABLE_LRU_SECTOR_CACHE, which is enabled with it.  */
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+#ifndef FX_ENABLE_LRU_SECTOR_CACHE
+#define FX_ENABLE_LRU_SECTOR_CACHE
+#endif
+#endif
+
+/* Define the shared logical sector cache pool. If FX_ENABLE_SECTOR_CACHE_POOL is defined,
+   fx_media_cache_pool_create builds a pool of cache entries in application memory. A media
+   attached to the pool with fx_media_cache_pool_attach caches its sectors in pool entries instead
+   of the memory supplied to fx_media_open. When it needs another entry, it takes a free entry, or
+   the least recently used clean entry of another media that holds more entries than it reserved.
+   Up to FX_SECTOR_CACHE_POOL_MEDIA media can be attached to a pool. This option is built on
+   FX_ENABLE_LRU_SECTOR_CACHE, which is enabled with it.  */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+#ifndef FX_ENABLE_LRU_SECTOR_CACHE
+#define FX_ENABLE_LRU_SECTOR_CACHE
+#endif
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+#error "FX_ENABLE_SECTOR_CACHE_POOL cannot be used with FX_ENABLE_SECTOR_CACHE_PARTITION"
+#endif
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+#error "FX_ENABLE_SECTOR_CACHE_POOL cannot be used with FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE"
+#endif
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+#error "FX_ENABLE_SECTOR_CACHE_POOL cannot be used with FX_ENABLE_FILE_READ_BORROW"
+#endif
+#endif
+
+#ifndef FX_SECTOR_CACHE_POOL_MEDIA
+#define FX_SECTOR_CACHE_POOL_MEDIA             4
+#endif
+
+/* Define the background writeback of dirty sectors. If FX_ENABLE_BACKGROUND_WRITEBACK is defined,
+   fx_media_writeback_poll writes out the dirty sectors of the logical sector cache that were first
+   written at least the maximum age ago, counted in polls of the media. When more than the high-water
+   percentage of the cache is dirty, the oldest dirty sectors are written out until half of that is
+   left. Changes held in the FAT cache are moved to the sector cache and written out once they reach
+   the maximum age as well. fx_media_writeback_set changes the policy of a media. Unless
+   FX_SINGLE_THREAD is defined, fx_system_initialize creates a writeback thread that polls every
+   opened media each FX_WRITEBACK_INTERVAL_TICKS, otherwise the application calls
+   fx_media_writeback_poll. This option is built on FX_ENABLE_LRU_SECTOR_CACHE, which is enabled
+   with it.  */
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+#ifndef FX_ENABLE_LRU_SECTOR_CACHE
+#define FX_ENABLE_LRU_SECTOR_CACHE
+#endif
+
+#ifndef FX_WRITEBACK_MAX_AGE
+#define FX_WRITEBACK_MAX_AGE                   10
+#endif
+
+#ifndef FX_WRITEBACK_HIGH_WATER_PERCENT
+#define FX_WRITEBACK_HIGH_WATER_PERCENT        50
+#endif
+
+#ifndef FX_WRITEBACK_INTERVAL_TICKS
+#define FX_WRITEBACK_INTERVAL_TICKS            10
+#endif
+
+#ifndef FX_WRITEBACK_THREAD_PRIORITY
+#define FX_WRITEBACK_THREAD_PRIORITY           16
+#endif
+
+#ifndef FX_WRITEBACK_THREAD_STACK_SIZE
+#define FX_WRITEBACK_THREAD_STACK_SIZE         2048
+#endif
+#endif
+
+/* Define the free cluster bitmap of FAT12/16/32 media. If FX_ENABLE_FAT_CLUSTER_BITMAP is defined,
+   fx_media_cluster_bitmap_enable builds a bitmap with one bit per cluster in memory supplied by the
+   application, set for clusters in use. The bitmap is updated with every FAT entry written, and the
+   cluster allocation of files and directories searches it a word at a time instead of reading the
+   FAT entry of each cluster. Every cluster found is checked against its FAT entry before it is used.
+   The bitmap needs one ULONG for every 32 clusters of the media, plus the bytes needed to align
+   it. It is not used after the media is closed.  */
+
+/* Define the deferred free cluster count of FAT12/16/32 media. If FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+   is defined, fx_media_open does not read the whole FAT to count the free clusters. The free cluster
+   count and the next free cluster hint of a valid FAT32 additional information (FSInfo) sector are
+   used as they are. Otherwise the free clusters are counted the first time the count is needed, by
+   an allocation or by fx_media_space_available. Until then, flush and close report the count as
+   unknown in the FSInfo sector, and the counted value is written back by the next flush or close.  */
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+#ifdef FX_DISABLE_CACHE
+#error "FX_ENABLE_LRU_SECTOR_CACHE cannot be used with FX_DISABLE_CACHE"
+#endif
+#endif
+
+/* Define the coalesced flush of the logical sector cache. If FX_ENABLE_COALESCED_SECTOR_FLUSH is
+   defined, a flush gathers up to FX_SECTOR_FLUSH_BATCH dirty sectors at a time, sorts them by
+   logical sector and writes each run of consecutive sectors with a single driver request. When the
+   cache buffers of a run are not adjacent in memory, the run is copied into a bounce buffer of
+   FX_SECTOR_FLUSH_BUFFER_SIZE bytes inside FX_MEDIA, which limits the length of such runs.  */
+
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+#ifdef FX_DISABLE_CACHE
+#error "FX_ENABLE_COALESCED_SECTOR_FLUSH cannot be used with FX_DISABLE_CACHE"
+#endif
+
+#ifndef FX_SECTOR_FLUSH_BATCH
+#define FX_SECTOR_FLUSH_BATCH                  32
+#endif
+
+#ifndef FX_SECTOR_FLUSH_BUFFER_SIZE
+#define FX_SECTOR_FLUSH_BUFFER_SIZE            4096 /* Must be a multiple of 4.  */
+#endif
+#endif
+
+/* Define the sequential read-ahead of files. If FX_ENABLE_FILE_READ_AHEAD is defined, fx_file_read
+   detects sequential reads of each file. The read-ahead window starts at two sectors and doubles with
+   each sequential read up to fx_file_read_ahead_max_sectors of the file, which fx_file_open sets to
+   FX_FILE_READ_AHEAD_SECTORS and the application may change like fx_file_disable_burst_cache (zero
+   disables the read-ahead of the file). When the next sector of the file must be read, the rest of
+   the window within the current cluster and the following contiguous clusters is fetched into the
+   logical sector cache with one driver request, through a buffer of FX_READ_AHEAD_BUFFER_SIZE bytes
+   inside FX_MEDIA. Any other access pattern closes the window again.  */
+
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+#ifdef FX_DISABLE_CACHE
+#error "FX_ENABLE_FILE_READ_AHEAD cannot be used with FX_DISABLE_CACHE"
+#endif
+
+#ifdef FX_DISABLE_DIRECT_DATA_READ_CACHE_FILL
+#error "FX_ENABLE_FILE_READ_AHEAD cannot be used with FX_DISABLE_DIRECT_DATA_READ_CACHE_FILL"
+#endif
+
+#ifndef FX_FILE_READ_AHEAD_SECTORS
+#define FX_FILE_READ_AHEAD_SECTORS             16
+#endif
+
+#ifndef FX_READ_AHEAD_BUFFER_SIZE
+#define FX_READ_AHEAD_BUFFER_SIZE              8192 /* Must be a multiple of 4.  */
+#endif
+#endif
+
+/* Define the write buffer of files. If FX_ENABLE_FILE_WRITE_BUFFER is defined, the application may
+   give an open file a buffer with fx_file_write_buffer_set. Writes that append to the file are then
+   gathered in this buffer and are written to the file only when an append overflows the buffer, in
+   which case the data up to the last complete sector is written, or when the file is read, seeked,
+   truncated, allocated or closed, or the media is flushed or closed. Data in the buffer is not yet
+   part of the file: the file offset and size do not include it, it is lost if power fails or the
+   media is aborted, and the write notify function is called when it is written. Write errors such
+   as FX_NO_MORE_SPACE are returned by the call that writes the buffer, after which the data in the
+   buffer is discarded: a failed fx_file_write stores none of its data, and fx_file_close,
+   fx_media_flush and fx_media_close still close or flush the file and the media and then return
+   the error.  */
+
+/* Define the delayed allocation of files on FAT12/16/32 media. If FX_ENABLE_FILE_DELAYED_ALLOCATION
+   is defined, the clusters needed by a write are taken as one run of consecutive free clusters: the
+   clusters after the last cluster of the file if they are free, otherwise the first run long enough
+   from the free cluster search start, found in the free cluster bitmap if FX_ENABLE_FAT_CLUSTER_BITMAP
+   is defined. Without the bitmap, only FX_FILE_DELAYED_ALLOCATION_SEARCH_CLUSTERS FAT entries from
+   the search start are searched, so a write does not read the whole FAT when no run is long enough.
+   Only if there is no such run are the free clusters taken one by one as before. The write buffer
+   of FX_ENABLE_FILE_WRITE_BUFFER, which this option enables, delays the allocation of the appends
+   it gathers until it is written, when the clusters for all of them are allocated in one write, so
+   files appended at the same time keep runs of a buffer size or more and their FAT entries are
+   linked a run at a time. A full media is then only found when the buffer is written:
+   the data in the buffer is discarded and the call that writes it returns FX_NO_MORE_SPACE, as for
+   any write error of the buffer, so fx_file_close and fx_media_close still close the file and the
+   media.  */
+
+#ifdef FX_ENABLE_FILE_DELAYED_ALLOCATION
+#ifndef FX_ENABLE_FILE_WRITE_BUFFER
+#define FX_ENABLE_FILE_WRITE_BUFFER
+#endif
+#ifndef FX_FILE_DELAYED_ALLOCATION_SEARCH_CLUSTERS
+#define FX_FILE_DELAYED_ALLOCATION_SEARCH_CLUSTERS    1024
+#endif
+#endif
+
+/* Define the extent map of files. If FX_ENABLE_FILE_EXTENT_MAP is defined, the application may give
+   an open file an array of FX_FILE_EXTENT with fx_file_extent_map_set. Each extent describes a run
+   of consecutive clusters of the file. The map is filled as the cluster chain of the file is
+   followed, and seek, read, write and truncate then find the clusters it describes with a binary
+   search instead of reading the FAT entry of each cluster. When the array is full the rest of the
+   chain is followed as before. The map is cleared when clusters of the file are released or
+   replaced.  */
+
+/* Define the defragmentation of FAT12/16/32 media. If FX_ENABLE_MEDIA_DEFRAGMENT is defined,
+   fx_file_defragment moves the clusters of a file opened for writing to one run of free clusters, and
+   fx_media_defragment does the same for the files of the media that are not open, going through the
+   directory tree in steps. Each call continues where the previous one stopped and returns once it has
+   moved at least budget clusters, or with FX_NO_MORE_ENTRIES when it has gone through all directories,
+   the next call starting a new pass. A budget of zero goes through the rest of the pass. The data is
+   copied through the scratch memory, several sectors per request, or through the logical sector cache
+   if it holds less than one sector. Files are moved whole and only if a run of free clusters long
+   enough exists; directories are not moved. The data and the new chain are written before the
+   directory entry is changed to the new chain, within a fault tolerant transaction if it is enabled,
+   and the old chain is released after, so a power loss leaves the file on either chain and at most
+   lost clusters that fx_media_check recovers.  */
+
+/* Define the asynchronous driver interface. If FX_ENABLE_ASYNC_DRIVER is defined and the I/O driver
+   sets fx_media_driver_async_supported to FX_TRUE during FX_DRIVER_INIT, FileX may keep up to
+   FX_ASYNC_DRIVER_QUEUE_DEPTH requests outstanding. Each request is described by an FX_DRIVER_REQUEST
+   passed in fx_media_driver_async_request. The driver returns from FX_DRIVER_ASYNC_SUBMIT as soon as
+   the request is queued, and from FX_DRIVER_ASYNC_WAIT with one completed request, whose completion
+   function FileX then calls in its own context. All outstanding requests are completed before the
+   media is accessed with synchronous requests again. Currently the runs of a coalesced sector flush
+   are submitted this way. Drivers that do not set fx_media_driver_async_supported are called
+   synchronously.  */
+
+#ifdef FX_ENABLE_ASYNC_DRIVER
+#ifndef FX_ASYNC_DRIVER_QUEUE_DEPTH
+#define FX_ASYNC_DRIVER_QUEUE_DEPTH            8
+#endif
+#endif
+
+/* Define the scatter-gather driver interface. If FX_ENABLE_SCATTER_GATHER_DRIVER is defined and the
+   I/O driver sets fx_media_driver_scatter_gather_supported to FX_TRUE during FX_DRIVER_INIT, direct
+   file reads and writes that span several cluster runs are sent to the driver as one
+   FX_DRIVER_SCATTER_READ or FX_DRIVER_GATHER_WRITE request. The request holds a list of up to
+   FX_SCATTER_GATHER_SEGMENTS segments in fx_media_driver_segment_list, and fx_media_driver_segments
+   is the number of segments used.  */
+
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+#ifndef FX_SCATTER_GATHER_SEGMENTS
+#define FX_SCATTER_GATHER_SEGMENTS             16
+#endif
+#endif
+
 #ifndef FX_FAT_MAP_SIZE
 #define FX_FAT_MAP_SIZE                        128  /* Minimum 1, maximum any. This represents how many 32-bit words used for the written FAT sector bit map. */
 #endif
@@ -456,6 +743,105 @@ VOID _fx_trace_event_update(TX_TRACE_BUFFER_ENTRY *event, ULONG timestamp, ULONG
 #define FX_FAT_CACHE_HASH_MASK                 ((FX_MAX_FAT_CACHE / FX_FAT_CACHE_DEPTH) - 1)
 
 
+/* Define the configurable FAT entry cache. If FX_ENABLE_CONFIGURABLE_FAT_CACHE is defined,
+   fx_media_fat_cache_configure moves the FAT entry cache of an opened media to memory supplied by
+   the application and sets the number of ways, that is the number of entries each set holds. The
+   number of sets is the largest power of 2 that fits in the memory. The entries of a set are kept
+   in least recently used order, and when the oldest entry of a set is dirty only the FAT sector
+   that holds it is written, instead of every dirty entry of the cache. Opening the media returns
+   to the FX_MAX_FAT_CACHE entries of fx_media_fat_cache, in sets of FX_FAT_CACHE_DEPTH.  */
+
+
+/* Define the precise mirroring of the secondary FATs. If FX_ENABLE_FAT_MIRROR_RANGES is defined, the
+   written primary FAT sectors are recorded in a sorted list of up to FX_FAT_MIRROR_RANGES ranges
+   instead of the bits of fx_media_fat_secondary_update_map, each of which may stand for many FAT
+   sectors. Adjacent and overlapping ranges are merged, and when the list is full the closest range
+   is extended. On a FAT flush only the sectors of the ranges are copied to the secondary FATs, each
+   range through a buffer of FX_FAT_MIRROR_BUFFER_SIZE bytes inside FX_MEDIA with one read and one
+   write per FAT for each buffer.  */
+
+/* Define the deferred mirroring of the secondary FATs. If FX_ENABLE_FAT_MIRROR_DEFER is defined,
+   fx_media_fat_mirror_defer selects a record sector of an opened media, an unused reserved sector or a
+   sector of a file kept for it, after which a FAT flush no longer copies the written primary FAT sectors to the secondary FATs. Their ranges are
+   kept instead, rounded to FX_FAT_MIRROR_DEFER_GRANULE sectors, and written to the record sector
+   each time a new granule is written, before the FAT sectors leave the sector cache. The ranges are
+   mirrored and the record cleared when the media is closed, when deferral is stopped, or, with
+   FX_ENABLE_BACKGROUND_WRITEBACK, after the FAT has not been written for the given number of polls.
+   If the media was not closed, the next call to fx_media_fat_mirror_defer copies the recorded
+   ranges. This option is built on FX_ENABLE_FAT_MIRROR_RANGES, which is enabled with it.  */
+
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+#ifndef FX_ENABLE_FAT_MIRROR_RANGES
+#define FX_ENABLE_FAT_MIRROR_RANGES
+#endif
+
+#ifndef FX_FAT_MIRROR_DEFER_GRANULE
+#define FX_FAT_MIRROR_DEFER_GRANULE            16
+#endif
+
+#define FX_FAT_MIRROR_RECORD_SIGNATURE         0x52494D46
+#endif
+
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+#ifndef FX_FAT_MIRROR_RANGES
+#define FX_FAT_MIRROR_RANGES                   8
+#endif
+
+#ifndef FX_FAT_MIRROR_BUFFER_SIZE
+#define FX_FAT_MIRROR_BUFFER_SIZE              4096 /* Must be a multiple of 4.  */
+#endif
+#endif
+
+
+/* Define the exFAT cluster reservation. If FX_ENABLE_EXFAT_CLUSTER_RESERVATION is defined, a file
+   written on an exFAT media takes its new clusters from a window of free clusters reserved for it while
+   it is open, FX_EXFAT_RESERVATION_CLUSTERS or the clusters of the write if that is more. The window
+   continues the file when the clusters after the file are free, otherwise it is the first run of that
+   many free clusters, so files written at the same time do not take each other's next clusters and keep
+   their contiguous layout without a FAT chain. The clusters of a window stay free in the allocation
+   bitmap and other allocations skip them. A window is released when its file is closed, and all of them
+   when no other free cluster is left. The free run search of FX_ENABLE_EXFAT_BITMAP_WINDOWS is used.  */
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+#ifndef FX_ENABLE_EXFAT
+#error "FX_ENABLE_EXFAT_CLUSTER_RESERVATION requires FX_ENABLE_EXFAT"
+#endif
+
+#ifndef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+#define FX_ENABLE_EXFAT_BITMAP_WINDOWS
+#endif
+
+#ifndef FX_EXFAT_RESERVATION_CLUSTERS
+#define FX_EXFAT_RESERVATION_CLUSTERS          64
+#endif
+#endif
+
+
+/* Define the exFAT allocation bitmap windows. If FX_ENABLE_EXFAT_BITMAP_WINDOWS is defined,
+   fx_media_exfat_bitmap_cache_configure moves the allocation bitmap cache of an opened exFAT media to
+   memory supplied by the application, as many windows of the given number of bitmap sectors as fit.
+   Windows start on a multiple of their size and the least recently used one is replaced. The same
+   memory holds a summary with one bit for each bitmap sector, set once a search found every cluster of
+   the sector used and cleared when one of them is released, so searches skip full sectors without
+   reading them. Free clusters and runs of free clusters are searched 64 clusters at a time, with
+   FX_TRAILING_ZEROS_64 counting the trailing zero bits of a word. Opening the media returns to the one
+   window of fx_media_exfat_bitmap_cache without a summary.  */
+
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+#ifndef FX_ENABLE_EXFAT
+#error "FX_ENABLE_EXFAT_BITMAP_WINDOWS requires FX_ENABLE_EXFAT"
+#endif
+
+#ifndef FX_TRAILING_ZEROS_64
+#if defined(__GNUC__)
+#define FX_TRAILING_ZEROS_64(value)            ((UINT)__builtin_ctzll(value))
+#else
+#define FX_TRAILING_ZEROS_64(value)            _fx_utility_64_trailing_zeros(value)
+#endif
+#endif
+#endif
+
+
 /* FileX API input parameters and general constants.  */
 
 #define FX_TRUE                                1
@@ -581,6 +967,10 @@ VOID _fx_trace_event_update(TX_TRACE_BUFFER_ENTRY *event, ULONG timestamp, ULONG
 #define FX_DRIVER_RELEASE_SECTORS              6
 #define FX_DRIVER_BOOT_WRITE                   7
 #define FX_DRIVER_UNINIT                       8
+#define FX_DRIVER_ASYNC_SUBMIT                 9
+#define FX_DRIVER_ASYNC_WAIT                   10
+#define FX_DRIVER_SCATTER_READ                 11
+#define FX_DRIVER_GATHER_WRITE                 12
 
 
 /* Define relative seek constants.  */
@@ -795,6 +1185,23 @@ typedef struct FX_FAT_CACHE_ENTRY_STRUCT
 } FX_FAT_CACHE_ENTRY;
 
 
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+
+/* Define a window of the exFAT allocation bitmap cache. A window holds the bitmap sectors of
+   the clusters from the start to the end cluster, a window without sectors is not in use.  */
+
+typedef struct FX_EXFAT_BITMAP_WINDOW_STRUCT
+{
+    UCHAR  *fx_exfat_bitmap_window_buffer;
+    ULONG   fx_exfat_bitmap_window_start_cluster;
+    ULONG   fx_exfat_bitmap_window_end_cluster;
+    ULONG   fx_exfat_bitmap_window_sectors;
+    ULONG   fx_exfat_bitmap_window_last_used;
+    UINT    fx_exfat_bitmap_window_dirty;
+} FX_EXFAT_BITMAP_WINDOW;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
+
+
 /* Define the directory entry structure that contains information about a specific
    directory entry.  */
 
@@ -885,9 +1292,108 @@ typedef struct FX_CACHED_SECTOR_STRUCT
     struct FX_CACHED_SECTOR_STRUCT
                         *fx_cached_sector_next_used;
 
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+    /* Define the previous cached sector pointer.  Together with the next pointer
+       this forms a doubly-linked list, so an entry can be moved to either end
+       of the "last used" list without searching for it.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_cached_sector_previous_used;
+
+    /* Define the next entry in the same hash bucket.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_cached_sector_hash_next;
+
+    /* Define the sector number this entry is currently indexed under in the
+       hash table. This can differ from fx_cached_sector after the entry is
+       invalidated, all ones means the entry is not in the hash table.  */
+    ULONG64             fx_cached_sector_hash_key;
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* Define the flag that indicates whether this entry is on the probationary
+       queue instead of the protected "last used" list.  */
+    UCHAR               fx_cached_sector_probation;
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    /* Define the cache partition this entry is reserved for.  */
+    UCHAR               fx_cached_sector_partition;
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+    /* Define the number of files that borrowed this sector with
+       fx_file_read_borrow. A pinned entry is never replaced.  */
+    ULONG               fx_cached_sector_pin_count;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+
+    /* Define the media that owns this entry of a cache pool and the pool clock
+       value of its last use, which orders the entries of different media.  */
+    struct FX_MEDIA_STRUCT
+                       *fx_cached_sector_media;
+    ULONG               fx_cached_sector_last_used;
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+
+    /* Define the writeback clock value of the media when this entry became
+       dirty, which gives the age of the change.  */
+    ULONG               fx_cached_sector_dirty_time;
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
+
 } FX_CACHED_SECTOR;
 
 
+#ifdef FX_ENABLE_ASYNC_DRIVER
+
+/* Define the asynchronous driver request descriptor. FileX fills in the request,
+   the driver sets the status when the request is complete.  */
+
+struct FX_MEDIA_STRUCT;
+
+typedef struct FX_DRIVER_REQUEST_STRUCT
+{
+
+    /* Define the request, which is FX_DRIVER_READ or FX_DRIVER_WRITE, and its status.  */
+    UINT                fx_driver_request_type;
+    UINT                fx_driver_request_status;
+
+    /* Define the sectors of the request.  */
+    UCHAR               *fx_driver_request_buffer;
+    ULONG64             fx_driver_request_logical_sector;
+    ULONG               fx_driver_request_sectors;
+    UINT                fx_driver_request_sector_type;
+
+    /* Define the function called when the request is complete and its context.  */
+    VOID                (*fx_driver_request_complete)(struct FX_MEDIA_STRUCT *, struct FX_DRIVER_REQUEST_STRUCT *);
+    VOID                *fx_driver_request_context;
+
+    /* Define the link pointer, which the driver may use while it owns the request.  */
+    struct FX_DRIVER_REQUEST_STRUCT
+                        *fx_driver_request_next;
+} FX_DRIVER_REQUEST;
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+
+
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+/* Define a segment of a scatter-gather driver request, which is a run of consecutive
+   logical sectors and the buffer they are transferred from or to.  */
+
+typedef struct FX_DRIVER_SEGMENT_STRUCT
+{
+    ULONG64             fx_driver_segment_logical_sector;
+    ULONG               fx_driver_segment_sectors;
+    UCHAR               *fx_driver_segment_buffer;
+} FX_DRIVER_SEGMENT;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
+
+
 /* Determine if the media control block has an extension defined. If not, 
    define the extension to whitespace.  */
 
@@ -934,6 +1440,45 @@ typedef struct FX_MEDIA_STRUCT
     struct FX_CACHED_SECTOR_STRUCT
                         *fx_media_sector_cache_list_ptr;
 
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+    /* Define the list tail of the cached sector entries.  This pointer
+       points to the least recently used cache sector, which is the next
+       entry to be replaced.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_media_sector_cache_list_tail;
+
+    /* Define the hash table used to locate cached sectors.  The number of
+       buckets is a power of 2, fx_media_sector_cache_hash_mask + 1.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        **fx_media_sector_cache_hash_table;
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* Define the head and tail of the probationary queue of cached data
+       sectors, the number of entries on it and its maximum number of entries.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_media_sector_cache_probation_ptr;
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_media_sector_cache_probation_tail;
+    ULONG               fx_media_sector_cache_probation_count;
+    ULONG               fx_media_sector_cache_probation_limit;
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    /* Define the head and tail of the "last used" list of each cache partition
+       and the number of entries reserved for each partition. If the cache is
+       not partitioned, all entries belong to the data partition.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_media_sector_cache_partition_ptr[FX_SECTOR_CACHE_PARTITIONS];
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_media_sector_cache_partition_tail[FX_SECTOR_CACHE_PARTITIONS];
+    ULONG               fx_media_sector_cache_partition_size[FX_SECTOR_CACHE_PARTITIONS];
+    UINT                fx_media_sector_cache_partitioned;
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
     /* Define the bit map that represents the hashed cache sectors that are
        valid. This bit map will help optimize the invalidation of the hashed
        sector cache.  */
@@ -942,6 +1487,56 @@ typedef struct FX_MEDIA_STRUCT
     /* Define the outstanding dirty sector counter. This is used to optimize
        the searching of sectors to flush to the media.  */
     ULONG               fx_media_sector_cache_dirty_count;
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+    /* Define the number of cache entries pinned by borrowing files.  */
+    ULONG               fx_media_sector_cache_pinned_count;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+
+    /* Define the cache pool this media is attached to, the number of pool entries
+       it owns and the number of entries reserved for it. The memory supplied to
+       fx_media_open is used again when the media is detached from the pool.  */
+    struct FX_SECTOR_CACHE_POOL_STRUCT
+                        *fx_media_sector_cache_pool;
+    ULONG               fx_media_sector_cache_pool_entries;
+    ULONG               fx_media_sector_cache_pool_reserved;
+    UCHAR               *fx_media_sector_cache_private_memory;
+    ULONG               fx_media_sector_cache_private_size;
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+
+    /* Define the writeback policy of the media: the age in polls after which a
+       dirty sector is written out, and the percentage of the cache that may be
+       dirty before the oldest dirty sectors are written out.  */
+    ULONG               fx_media_writeback_max_age;
+    ULONG               fx_media_writeback_high_water;
+
+    /* Define the writeback clock, which advances on each poll, and the clock
+       value when changes were first seen in the FAT cache.  */
+    ULONG               fx_media_writeback_clock;
+    ULONG               fx_media_writeback_fat_time;
+    UINT                fx_media_writeback_fat_pending;
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
+
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+
+    /* Define the list used to sort the dirty sectors during a flush and the
+       bounce buffer for runs of sectors whose cache buffers are not adjacent.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_media_sector_flush_list[FX_SECTOR_FLUSH_BATCH];
+    ULONG               fx_media_sector_flush_buffer[FX_SECTOR_FLUSH_BUFFER_SIZE >> 2];
+#endif /* FX_ENABLE_COALESCED_SECTOR_FLUSH */
+
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+    /* Define the buffer the read-ahead sectors of a file are read into before
+       they are placed in the logical sector cache.  */
+    ULONG               fx_media_read_ahead_buffer[FX_READ_AHEAD_BUFFER_SIZE >> 2];
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
 #endif /* FX_DISABLE_CACHE */
 
     /* Define the basic information about the associated media.  */
@@ -952,6 +1547,15 @@ typedef struct FX_MEDIA_STRUCT
     ULONG64             fx_media_total_sectors;
     ULONG               fx_media_total_clusters;
 
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+
+    /* Define the free cluster bitmap, one bit per cluster starting with
+       cluster 2, set when the cluster is in use. The bitmap is not used
+       if the pointer is FX_NULL.  */
+    ULONG               *fx_media_cluster_bitmap;
+    ULONG               fx_media_cluster_bitmap_words;
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
 #ifdef FX_ENABLE_EXFAT
     /* Define exFAT media information.  */
     ULONG               fx_media_exfat_volume_serial_number;
@@ -983,6 +1587,26 @@ typedef struct FX_MEDIA_STRUCT
 
     /* Define is Bitmap table was changed or not.  */
     UINT                fx_media_exfat_bitmap_cache_dirty;
+
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+
+    /* Define the windows of the Bitmap cache and the window in use, whose clusters are
+       given by the cache start and end cluster above. Until the cache is configured the
+       only window is fx_media_exfat_bitmap_window, holding fx_media_exfat_bitmap_cache,
+       and the cache dirty flag above is set when any window is changed.  */
+    FX_EXFAT_BITMAP_WINDOW
+                        fx_media_exfat_bitmap_window;
+    FX_EXFAT_BITMAP_WINDOW
+                       *fx_media_exfat_bitmap_windows;
+    FX_EXFAT_BITMAP_WINDOW
+                       *fx_media_exfat_bitmap_window_current;
+    ULONG               fx_media_exfat_bitmap_windows_count;
+    ULONG               fx_media_exfat_bitmap_window_clock;
+
+    /* Define the summary of the Bitmap, one bit for each Bitmap sector set when all of
+       its clusters are known to be used, or FX_NULL if there is no summary.  */
+    ULONG              *fx_media_exfat_bitmap_summary;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 #endif /* FX_ENABLE_EXFAT */
 
     UINT                fx_media_reserved_sectors;
@@ -1005,6 +1629,20 @@ typedef struct FX_MEDIA_STRUCT
     UINT                fx_media_root_directory_entries;
     ULONG               fx_media_available_clusters;
     ULONG               fx_media_cluster_search_start;
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* Define the flag that indicates the free clusters of a FAT12/16/32 media
+       have not been counted yet, so fx_media_available_clusters is not valid.  */
+    UINT                fx_media_free_cluster_count_pending;
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+#ifdef FX_ENABLE_MEDIA_DEFRAGMENT
+
+    /* Define where the next fx_media_defragment call continues: the first
+       cluster of the directory being scanned, zero for the root directory,
+       and the next entry of that directory.  */
+    ULONG               fx_media_defragment_directory;
+    ULONG               fx_media_defragment_entry;
+#endif /* FX_ENABLE_MEDIA_DEFRAGMENT */
 
     /* Define the information pertinent to the I/O driver interface.  */
 
@@ -1026,6 +1664,22 @@ typedef struct FX_MEDIA_STRUCT
     UINT                fx_media_driver_system_write;
     UINT                fx_media_driver_data_sector_read;
     UINT                fx_media_driver_sector_type;
+#ifdef FX_ENABLE_ASYNC_DRIVER
+    UINT                fx_media_driver_async_supported;    /* The driver sets this to FX_TRUE when it accepts asynchronous requests.  */
+    FX_DRIVER_REQUEST   *fx_media_driver_async_request;
+
+    /* Define the asynchronous request descriptors, the list of free descriptors,
+       the number of outstanding requests and the first error they completed with.  */
+    FX_DRIVER_REQUEST   fx_media_driver_async_requests[FX_ASYNC_DRIVER_QUEUE_DEPTH];
+    FX_DRIVER_REQUEST   *fx_media_driver_async_free_list;
+    ULONG               fx_media_driver_async_outstanding;
+    UINT                fx_media_driver_async_status;
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+    UINT                fx_media_driver_scatter_gather_supported;   /* The driver sets this to FX_TRUE when it accepts scatter-gather requests.  */
+    FX_DRIVER_SEGMENT   fx_media_driver_segment_list[FX_SCATTER_GATHER_SEGMENTS];
+    ULONG               fx_media_driver_segments;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
 
     /* Define the driver entry point.  */
     VOID                (*fx_media_driver_entry)(struct FX_MEDIA_STRUCT *);
@@ -1107,6 +1761,12 @@ typedef struct FX_MEDIA_STRUCT
     ULONG               fx_media_logical_sector_writes;
     ULONG               fx_media_logical_sector_cache_read_hits;
     ULONG               fx_media_logical_sector_cache_read_misses;
+    ULONG               fx_media_logical_sector_cache_metadata_read_hits;
+    ULONG               fx_media_logical_sector_cache_metadata_read_misses;
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+    ULONG               fx_media_logical_sector_cache_partition_read_hits[FX_SECTOR_CACHE_PARTITIONS];
+    ULONG               fx_media_logical_sector_cache_partition_read_misses[FX_SECTOR_CACHE_PARTITIONS];
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
     ULONG               fx_media_driver_read_requests;
     ULONG               fx_media_driver_write_requests;
     ULONG               fx_media_driver_boot_read_requests;
@@ -1146,9 +1806,39 @@ typedef struct FX_MEDIA_STRUCT
     /* Define FAT entry cache and the variable used to index the cache.  */
     FX_FAT_CACHE_ENTRY  fx_media_fat_cache[FX_MAX_FAT_CACHE];
 
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    /* Define the FAT entry cache in use, either fx_media_fat_cache or the memory
+       supplied to fx_media_fat_cache_configure. The cache holds the number of
+       sets given by the set mask plus one, each of the given number of ways.  */
+    FX_FAT_CACHE_ENTRY  *fx_media_fat_cache_entries;
+    ULONG               fx_media_fat_cache_size;
+    ULONG               fx_media_fat_cache_ways;
+    ULONG               fx_media_fat_cache_set_mask;
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+
     /* Define the FAT secondary update map.  This will be used on flush and
        close to update sectors of any secondary FATs in the media.  */
     UCHAR               fx_media_fat_secondary_update_map[FX_FAT_MAP_SIZE];
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+
+    /* Define the sorted ranges of primary FAT sectors written since the last
+       FAT map flush, and the buffer they are mirrored through.  */
+    ULONG               fx_media_fat_mirror_range_start[FX_FAT_MIRROR_RANGES];
+    ULONG               fx_media_fat_mirror_range_end[FX_FAT_MIRROR_RANGES];
+    UINT                fx_media_fat_mirror_ranges;
+    ULONG               fx_media_fat_mirror_buffer[FX_FAT_MIRROR_BUFFER_SIZE >> 2];
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+
+    /* Define the reserved sector that records the ranges while mirroring is
+       deferred, the number of idle polls after which they are mirrored, and
+       the writeback clock value when the FAT was last written.  */
+    ULONG               fx_media_fat_mirror_record_sector;
+    ULONG               fx_media_fat_mirror_idle_polls;
+    ULONG               fx_media_fat_mirror_time;
+    UINT                fx_media_fat_mirror_deferred;
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
 
     /* Define a variable for the application's use.  */
     ALIGN_TYPE          fx_media_reserved_for_user;
@@ -1166,9 +1856,24 @@ typedef struct FX_MEDIA_STRUCT
 #endif
 
 #ifndef FX_DISABLE_CACHE
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+    /* Define the sector cache control structures for this media.  This points
+       either to the built-in control structures below or to control structures
+       allocated from the memory supplied to fx_media_open.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_media_sector_cache;
+
+    /* Define the built-in control structures and hash buckets that are used
+       when no more than FX_MAX_SECTOR_CACHE sectors are cached.  */
+    struct FX_CACHED_SECTOR_STRUCT
+                        fx_media_sector_cache_built_in[FX_MAX_SECTOR_CACHE];
+    struct FX_CACHED_SECTOR_STRUCT
+                        *fx_media_sector_cache_hash_built_in[FX_MAX_SECTOR_CACHE];
+#else
     /* Define the sector cache control structures for this media.  */
     struct FX_CACHED_SECTOR_STRUCT
                         fx_media_sector_cache[FX_MAX_SECTOR_CACHE];
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 
     /* Define the sector cache hash mask so that the hash algorithm can be used with
        any power of 2 number of cache sectors.  */
@@ -1235,6 +1940,45 @@ typedef struct FX_MEDIA_STRUCT
 typedef FX_MEDIA *      FX_MEDIA_PTR;
 
 
+/* Define the logical sector cache pool that can be shared by several media.  */
+
+typedef struct FX_SECTOR_CACHE_POOL_STRUCT
+{
+
+    /* Define the pool ID used for error checking.  */
+    ULONG               fx_sector_cache_pool_id;
+
+    /* Define the sector size of the pool, the cache entries, their number and the
+       last byte of the sector buffers.  */
+    ULONG               fx_sector_cache_pool_bytes_per_sector;
+    FX_CACHED_SECTOR    *fx_sector_cache_pool_entries;
+    ULONG               fx_sector_cache_pool_size;
+    UCHAR               *fx_sector_cache_pool_memory_end;
+
+    /* Define the list of entries not owned by any media and their number.  */
+    FX_CACHED_SECTOR    *fx_sector_cache_pool_free_list;
+    ULONG               fx_sector_cache_pool_free_count;
+
+    /* Define the sum of the entries reserved by the attached media.  */
+    ULONG               fx_sector_cache_pool_reserved;
+
+    /* Define the clock that is advanced each time an entry is used.  */
+    ULONG               fx_sector_cache_pool_clock;
+
+    /* Define the attached media.  */
+    FX_MEDIA            *fx_sector_cache_pool_media[FX_SECTOR_CACHE_POOL_MEDIA];
+
+    /* Define the number of entries taken from one media for another.  */
+    ULONG               fx_sector_cache_pool_steals;
+
+#ifndef FX_SINGLE_THREAD
+
+    /* Define the pool protection mutex.  */
+    TX_MUTEX            fx_sector_cache_pool_protect;
+#endif
+} FX_SECTOR_CACHE_POOL;
+
+
 /* Determine if the file control block has an extension defined. If not, 
    define the extension to whitespace.  */
 
@@ -1243,6 +1987,20 @@ typedef FX_MEDIA *      FX_MEDIA_PTR;
 #endif
 
 
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+/* Define the extent of a file, a run of consecutive clusters starting with
+   the relative cluster of the file.  */
+
+typedef struct FX_FILE_EXTENT_STRUCT
+{
+    ULONG               fx_file_extent_relative_cluster;
+    ULONG               fx_file_extent_physical_cluster;
+    ULONG               fx_file_extent_clusters;
+} FX_FILE_EXTENT;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+
 /* Define the FileX file control block.  All information about open
    files are found in this data type.  */
 
@@ -1294,6 +2052,55 @@ typedef struct FX_FILE_STRUCT
     /* Define a variable for the application's use */
     ULONG               fx_file_disable_burst_cache;
 
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+    /* Define the maximum number of sectors read ahead of sequential reads,
+       which the application may change. Zero disables the read-ahead.  */
+    ULONG               fx_file_read_ahead_max_sectors;
+
+    /* Define the current read-ahead window in sectors, the file offset that
+       continues the sequential reads and the range of logical sectors that
+       was read ahead last.  */
+    ULONG               fx_file_read_ahead_window;
+    ULONG64             fx_file_read_ahead_offset;
+    ULONG64             fx_file_read_ahead_start_sector;
+    ULONG64             fx_file_read_ahead_end_sector;
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Define the buffer that gathers the data appended to the file, its size
+       and the number of bytes not yet written to the file.  */
+    UCHAR              *fx_file_write_buffer;
+    ULONG               fx_file_write_buffer_size;
+    ULONG               fx_file_write_buffer_bytes;
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+    /* Define the cache entry the file data was last borrowed from.  */
+    FX_CACHED_SECTOR   *fx_file_borrowed_sector;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+    /* Define the extent map of the file, the number of extents it can hold,
+       the number of extents used and the number of leading clusters of the
+       file the extents describe.  */
+    FX_FILE_EXTENT     *fx_file_extent_map;
+    ULONG               fx_file_extent_map_size;
+    ULONG               fx_file_extent_map_count;
+    ULONG               fx_file_extent_map_clusters;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+
+    /* Define the window of free clusters reserved for the file, its first
+       cluster and the number of clusters left in it.  */
+    ULONG               fx_file_reserved_cluster;
+    ULONG               fx_file_reserved_clusters;
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
+
     /* Define a notify function called when file is written to. */
     VOID               (*fx_file_write_notify)(struct FX_FILE_STRUCT *);
 
@@ -1366,6 +2173,8 @@ typedef FX_FILE  *FX_FILE_PTR;
 #define fx_file_delete                        _fx_file_delete
 #define fx_file_open                          _fx_file_open
 #define fx_file_read                          _fx_file_read
+#define fx_file_read_borrow                   _fx_file_read_borrow
+#define fx_file_read_release                  _fx_file_read_release
 #ifndef FX_DISABLE_ONE_LINE_FUNCTION
 #define fx_file_relative_seek                 _fx_file_relative_seek
 #endif /* FX_DISABLE_ONE_LINE_FUNCTION */
@@ -1377,6 +2186,9 @@ typedef FX_FILE  *FX_FILE_PTR;
 #endif /* FX_DISABLE_ONE_LINE_FUNCTION */
 #define fx_file_write                         _fx_file_write
 #define fx_file_write_notify_set              _fx_file_write_notify_set
+#define fx_file_write_buffer_set              _fx_file_write_buffer_set
+#define fx_file_extent_map_set                _fx_file_extent_map_set
+#define fx_file_defragment                    _fx_file_defragment
 #define fx_file_extended_allocate             _fx_file_extended_allocate
 #define fx_file_extended_best_effort_allocate _fx_file_extended_best_effort_allocate
 #define fx_file_extended_relative_seek        _fx_file_extended_relative_seek
@@ -1386,12 +2198,22 @@ typedef FX_FILE  *FX_FILE_PTR;
 
 #define fx_media_abort                        _fx_media_abort
 #define fx_media_cache_invalidate             _fx_media_cache_invalidate
+#define fx_media_cache_partition_set          _fx_media_cache_partition_set
+#define fx_media_cache_resize                 _fx_media_cache_resize
+#define fx_media_cache_pool_create            _fx_media_cache_pool_create
+#define fx_media_cache_pool_attach            _fx_media_cache_pool_attach
+#define fx_media_cache_pool_detach            _fx_media_cache_pool_detach
+#define fx_media_cluster_bitmap_enable        _fx_media_cluster_bitmap_enable
 #define fx_media_check                        _fx_media_check
 #define fx_media_close                        _fx_media_close
+#define fx_media_defragment                   _fx_media_defragment
+#define fx_media_fat_cache_configure          _fx_media_fat_cache_configure
+#define fx_media_fat_mirror_defer             _fx_media_fat_mirror_defer
 #define fx_media_flush                        _fx_media_flush
 #define fx_media_format                       _fx_media_format
 #ifdef FX_ENABLE_EXFAT
 #define fx_media_exFAT_format                 _fx_media_exFAT_format
+#define fx_media_exfat_bitmap_cache_configure _fx_media_exfat_bitmap_cache_configure
 #endif /* FX_ENABLE_EXFAT */
 #define fx_media_open                         _fx_media_open
 #define fx_media_read                         _fx_media_read
@@ -1400,6 +2222,8 @@ typedef FX_FILE  *FX_FILE_PTR;
 #define fx_media_volume_get_extended          _fx_media_volume_get_extended
 #define fx_media_volume_set                   _fx_media_volume_set
 #define fx_media_write                        _fx_media_write
+#define fx_media_writeback_set                _fx_media_writeback_set
+#define fx_media_writeback_poll               _fx_media_writeback_poll
 #define fx_media_open_notify_set              _fx_media_open_notify_set
 #define fx_media_close_notify_set             _fx_media_close_notify_set
 #define fx_media_extended_space_available     _fx_media_extended_space_available
@@ -1465,6 +2289,8 @@ typedef FX_FILE  *FX_FILE_PTR;
 #define fx_file_delete                        _fxe_file_delete
 #define fx_file_open(m, f, n, t)              _fxe_file_open(m, f, n, t, sizeof(FX_FILE))
 #define fx_file_read                          _fxe_file_read
+#define fx_file_read_borrow                   _fxe_file_read_borrow
+#define fx_file_read_release                  _fxe_file_read_release
 #ifndef FX_DISABLE_ONE_LINE_FUNCTION
 #define fx_file_relative_seek                 _fxe_file_relative_seek
 #endif /* FX_DISABLE_ONE_LINE_FUNCTION */
@@ -1476,6 +2302,9 @@ typedef FX_FILE  *FX_FILE_PTR;
 #endif /* FX_DISABLE_ONE_LINE_FUNCTION */
 #define fx_file_write                         _fxe_file_write
 #define fx_file_write_notify_set              _fxe_file_write_notify_set
+#define fx_file_write_buffer_set              _fxe_file_write_buffer_set
+#define fx_file_extent_map_set                _fxe_file_extent_map_set
+#define fx_file_defragment                    _fxe_file_defragment
 #define fx_file_extended_allocate             _fxe_file_extended_allocate
 #define fx_file_extended_best_effort_allocate _fxe_file_extended_best_effort_allocate
 #define fx_file_extended_relative_seek        _fxe_file_extended_relative_seek
@@ -1485,12 +2314,22 @@ typedef FX_FILE  *FX_FILE_PTR;
 
 #define fx_media_abort                        _fxe_media_abort
 #define fx_media_cache_invalidate             _fxe_media_cache_invalidate
+#define fx_media_cache_partition_set          _fxe_media_cache_partition_set
+#define fx_media_cache_resize                 _fxe_media_cache_resize
+#define fx_media_cache_pool_create            _fxe_media_cache_pool_create
+#define fx_media_cache_pool_attach            _fxe_media_cache_pool_attach
+#define fx_media_cache_pool_detach            _fxe_media_cache_pool_detach
+#define fx_media_cluster_bitmap_enable        _fxe_media_cluster_bitmap_enable
 #define fx_media_check                        _fxe_media_check
 #define fx_media_close                        _fxe_media_close
+#define fx_media_defragment                   _fxe_media_defragment
+#define fx_media_fat_cache_configure          _fxe_media_fat_cache_configure
+#define fx_media_fat_mirror_defer             _fxe_media_fat_mirror_defer
 #define fx_media_flush                        _fxe_media_flush
 #define fx_media_format                       _fxe_media_format
 #ifdef FX_ENABLE_EXFAT
 #define fx_media_exFAT_format                 _fxe_media_exFAT_format
+#define fx_media_exfat_bitmap_cache_configure _fxe_media_exfat_bitmap_cache_configure
 #endif /* FX_ENABLE_EXFAT */
 #define fx_media_open(m, n, d, i, p, s)       _fxe_media_open(m, n, d, i, p, s, sizeof(FX_MEDIA))
 #define fx_media_read                         _fxe_media_read
@@ -1499,6 +2338,8 @@ typedef FX_FILE  *FX_FILE_PTR;
 #define fx_media_volume_get_extended          _fxe_media_volume_get_extended
 #define fx_media_volume_set                   _fxe_media_volume_set
 #define fx_media_write                        _fxe_media_write
+#define fx_media_writeback_set                _fxe_media_writeback_set
+#define fx_media_writeback_poll               _fxe_media_writeback_poll
 #define fx_media_open_notify_set              _fxe_media_open_notify_set
 #define fx_media_close_notify_set             _fxe_media_close_notify_set
 #define fx_media_extended_space_available     _fxe_media_extended_space_available
@@ -1578,6 +2419,8 @@ UINT _fxe_file_open(FX_MEDIA *media_ptr, FX_FILE *file_ptr, CHAR *file_name,
                     UINT open_type, UINT file_control_block_size);
 #endif
 UINT fx_file_read(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG request_size, ULONG *actual_size);
+UINT fx_file_read_borrow(FX_FILE *file_ptr, UCHAR **data_ptr, ULONG *data_size);
+UINT fx_file_read_release(FX_FILE *file_ptr);
 #ifndef FX_DISABLE_ONE_LINE_FUNCTION
 UINT fx_file_relative_seek(FX_FILE *file_ptr, ULONG byte_offset, UINT seek_from);
 #endif /* FX_DISABLE_ONE_LINE_FUNCTION */
@@ -1589,6 +2432,9 @@ UINT fx_file_truncate_release(FX_FILE *file_ptr, ULONG size);
 #endif /* FX_DISABLE_ONE_LINE_FUNCTION */
 UINT fx_file_write(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG size);
 UINT fx_file_write_notify_set(FX_FILE *file_ptr, VOID (*file_write_notify)(FX_FILE *));
+UINT fx_file_write_buffer_set(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG buffer_size);
+UINT fx_file_extent_map_set(FX_FILE *file_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT fx_file_defragment(FX_FILE *file_ptr);
 UINT fx_file_extended_allocate(FX_FILE *file_ptr, ULONG64 size);
 UINT fx_file_extended_best_effort_allocate(FX_FILE *file_ptr, ULONG64 size, ULONG64 *actual_size_allocated);
 UINT fx_file_extended_relative_seek(FX_FILE *file_ptr, ULONG64 byte_offset, UINT seek_from);
@@ -1598,8 +2444,17 @@ UINT fx_file_extended_truncate_release(FX_FILE *file_ptr, ULONG64 size);
 
 UINT fx_media_abort(FX_MEDIA *media_ptr);
 UINT fx_media_cache_invalidate(FX_MEDIA *media_ptr);
+UINT fx_media_cache_partition_set(FX_MEDIA *media_ptr, UINT fat_percent, UINT directory_percent, UINT data_percent);
+UINT fx_media_cache_resize(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT fx_media_cache_pool_create(FX_SECTOR_CACHE_POOL *pool_ptr, VOID *memory_ptr, ULONG memory_size, UINT bytes_per_sector);
+UINT fx_media_cache_pool_attach(FX_MEDIA *media_ptr, FX_SECTOR_CACHE_POOL *pool_ptr, ULONG reserved_sectors);
+UINT fx_media_cache_pool_detach(FX_MEDIA *media_ptr);
+UINT fx_media_cluster_bitmap_enable(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size);
 UINT fx_media_check(FX_MEDIA *media_ptr, UCHAR *scratch_memory_ptr, ULONG scratch_memory_size, ULONG error_correction_option, ULONG *errors_detected);
 UINT fx_media_close(FX_MEDIA *media_ptr);
+UINT fx_media_defragment(FX_MEDIA *media_ptr, VOID *scratch_ptr, ULONG scratch_size, ULONG budget);
+UINT fx_media_fat_cache_configure(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size, UINT ways);
+UINT fx_media_fat_mirror_defer(FX_MEDIA *media_ptr, ULONG record_sector, ULONG idle_polls);
 UINT fx_media_flush(FX_MEDIA *media_ptr);
 UINT fx_media_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOID *driver_info_ptr, UCHAR *memory_ptr, UINT memory_size,
                      CHAR *volume_name, UINT number_of_fats, UINT directory_entries, UINT hidden_sectors,
@@ -1609,6 +2464,7 @@ UINT fx_media_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOID
 UINT fx_media_exFAT_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOID *driver_info_ptr, UCHAR *memory_ptr, UINT memory_size,
                            CHAR *volume_name, UINT number_of_fats, ULONG64 hidden_sectors, ULONG64 total_sectors,
                            UINT bytes_per_sector, UINT sectors_per_cluster, UINT volume_serial_number, UINT boundary_unit);
+UINT fx_media_exfat_bitmap_cache_configure(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size, ULONG window_sectors);
 #endif /* FX_ENABLE_EXFAT */
 #ifdef FX_DISABLE_ERROR_CHECKING
 UINT _fx_media_open(FX_MEDIA *media_ptr, CHAR *media_name,
@@ -1625,6 +2481,8 @@ UINT fx_media_volume_get(FX_MEDIA *media_ptr, CHAR *volume_name, UINT volume_sou
 UINT fx_media_volume_get_extended(FX_MEDIA *media_ptr, CHAR *volume_name, UINT volume_name_buffer_length, UINT volume_source);
 UINT fx_media_volume_set(FX_MEDIA *media_ptr, CHAR *volume_name);
 UINT fx_media_write(FX_MEDIA *media_ptr, ULONG logical_sector, VOID *buffer_ptr);
+UINT fx_media_writeback_set(FX_MEDIA *media_ptr, ULONG max_age, ULONG high_water_percent);
+UINT fx_media_writeback_poll(FX_MEDIA *media_ptr);
 UINT fx_media_open_notify_set(FX_MEDIA *media_ptr, VOID (*media_open_notify)(FX_MEDIA *));
 UINT fx_media_close_notify_set(FX_MEDIA *media_ptr, VOID (*media_close_notify)(FX_MEDIA *));
 UINT fx_media_extended_space_available(FX_MEDIA *media_ptr, ULONG64 *available_bytes_ptr);
@@ -71,6 +71,8 @@ UINT _fx_file_delete(FX_MEDIA *media_ptr, CHAR *file_name);
 UINT _fx_file_open(FX_MEDIA *media_ptr, FX_FILE *file_ptr, CHAR *file_name,
                    UINT open_type);
 UINT _fx_file_read(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG request_size, ULONG *actual_size);
+UINT _fx_file_read_borrow(FX_FILE *file_ptr, UCHAR **data_ptr, ULONG *data_size);
+UINT _fx_file_read_release(FX_FILE *file_ptr);
 #ifndef FX_DISABLE_ONE_LINE_FUNCTION
 UINT _fx_file_relative_seek(FX_FILE *file_ptr, ULONG byte_offset, UINT seek_from);
 #else
@@ -88,6 +90,9 @@ UINT _fx_file_truncate_release(FX_FILE *file_ptr, ULONG size);
 #endif /* FX_DISABLE_ONE_LINE_FUNCTION */
 UINT _fx_file_write(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG size);
 UINT _fx_file_write_notify_set(FX_FILE *file_ptr, VOID (*file_write_notify)(FX_FILE *));
+UINT _fx_file_write_buffer_set(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG buffer_size);
+UINT _fx_file_extent_map_set(FX_FILE *file_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _fx_file_defragment(FX_FILE *file_ptr);
 UINT _fx_file_extended_allocate(FX_FILE *file_ptr, ULONG64 size);
 UINT _fx_file_extended_best_effort_allocate(FX_FILE *file_ptr, ULONG64 size, ULONG64 *actual_size_allocated);
 UINT _fx_file_extended_relative_seek(FX_FILE *file_ptr, ULONG64 byte_offset, UINT seek_from);
@@ -107,6 +112,8 @@ UINT _fxe_file_delete(FX_MEDIA *media_ptr, CHAR *file_name);
 UINT _fxe_file_open(FX_MEDIA *media_ptr, FX_FILE *file_ptr, CHAR *file_name,
                     UINT open_type, UINT file_control_block_size);
 UINT _fxe_file_read(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG request_size, ULONG *actual_size);
+UINT _fxe_file_read_borrow(FX_FILE *file_ptr, UCHAR **data_ptr, ULONG *data_size);
+UINT _fxe_file_read_release(FX_FILE *file_ptr);
 UINT _fxe_file_relative_seek(FX_FILE *file_ptr, ULONG byte_offset, UINT seek_from);
 UINT _fxe_file_rename(FX_MEDIA *media_ptr, CHAR *old_file_name, CHAR *new_file_name);
 UINT _fxe_file_seek(FX_FILE *file_ptr, ULONG byte_offset);
@@ -114,6 +121,9 @@ UINT _fxe_file_truncate(FX_FILE *file_ptr, ULONG size);
 UINT _fxe_file_truncate_release(FX_FILE *file_ptr, ULONG size);
 UINT _fxe_file_write(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG size);
 UINT _fxe_file_write_notify_set(FX_FILE *file_ptr, VOID (*file_write_notify)(FX_FILE *));
+UINT _fxe_file_write_buffer_set(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG buffer_size);
+UINT _fxe_file_extent_map_set(FX_FILE *file_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _fxe_file_defragment(FX_FILE *file_ptr);
 UINT _fxe_file_extended_allocate(FX_FILE *file_ptr, ULONG64 size);
 UINT _fxe_file_extended_best_effort_allocate(FX_FILE *file_ptr, ULONG64 size, ULONG64 *actual_size_allocated);
 UINT _fxe_file_extended_relative_seek(FX_FILE *file_ptr, ULONG64 byte_offset, UINT seek_from);
@@ -121,5 +131,22 @@ UINT _fxe_file_extended_seek(FX_FILE *file_ptr, ULONG64 byte_offset);
 UINT _fxe_file_extended_truncate(FX_FILE *file_ptr, ULONG64 size);
 UINT _fxe_file_extended_truncate_release(FX_FILE *file_ptr, ULONG64 size);
 
+
+/* Define the internal File component function prototypes.  */
+
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+VOID _fx_file_read_ahead(FX_FILE *file_ptr);
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+UINT _fx_file_write_buffer_flush(FX_FILE *file_ptr, UINT all_bytes);
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+UINT _fx_file_extent_map_find(FX_FILE *file_ptr, ULONG *relative_cluster, ULONG *cluster);
+VOID _fx_file_extent_map_invalidate(FX_FILE *file_ptr);
+UINT _fx_file_extent_map_next(FX_FILE *file_ptr, ULONG relative_cluster, ULONG cluster, ULONG *next_cluster);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
 #endif
 
@@ -55,8 +55,17 @@
 
 UINT _fx_media_abort(FX_MEDIA *media_ptr);
 UINT _fx_media_cache_invalidate(FX_MEDIA *media_ptr);
+UINT _fx_media_cache_partition_set(FX_MEDIA *media_ptr, UINT fat_percent, UINT directory_percent, UINT data_percent);
+UINT _fx_media_cache_resize(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _fx_media_cache_pool_create(FX_SECTOR_CACHE_POOL *pool_ptr, VOID *memory_ptr, ULONG memory_size, UINT bytes_per_sector);
+UINT _fx_media_cache_pool_attach(FX_MEDIA *media_ptr, FX_SECTOR_CACHE_POOL *pool_ptr, ULONG reserved_sectors);
+UINT _fx_media_cache_pool_detach(FX_MEDIA *media_ptr);
+UINT _fx_media_cluster_bitmap_enable(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size);
 UINT _fx_media_check(FX_MEDIA *media_ptr, UCHAR *scratch_memory_ptr, ULONG scratch_memory_size, ULONG error_correction_option, ULONG *errors_detected);
 UINT _fx_media_close(FX_MEDIA *media_ptr);
+UINT _fx_media_defragment(FX_MEDIA *media_ptr, VOID *scratch_ptr, ULONG scratch_size, ULONG budget);
+UINT _fx_media_fat_cache_configure(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size, UINT ways);
+UINT _fx_media_fat_mirror_defer(FX_MEDIA *media_ptr, ULONG record_sector, ULONG idle_polls);
 UINT _fx_media_flush(FX_MEDIA *media_ptr);
 UINT _fx_media_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOID *driver_info_ptr, UCHAR *memory_ptr, UINT memory_size,
                       CHAR *volume_name, UINT number_of_fats, UINT directory_entries, UINT hidden_sectors,
@@ -64,6 +73,7 @@ UINT _fx_media_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOID
                       UINT heads, UINT sectors_per_track);
 UINT _fx_media_exFAT_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOID *driver_info_ptr, UCHAR *memory_ptr, UINT memory_size,
                             CHAR *volume_name, UINT number_of_fats, ULONG64 hidden_sectors, ULONG64 total_sectors, UINT bytes_per_sector, UINT sectors_per_cluster, UINT volume_serial_number, UINT boundary_unit);
+UINT _fx_media_exfat_bitmap_cache_configure(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size, ULONG window_sectors);
 UINT _fx_media_open(FX_MEDIA *media_ptr, CHAR *media_name,
                     VOID (*media_driver)(FX_MEDIA *), VOID *driver_info_ptr,
                     VOID *memory_ptr, ULONG memory_size);
@@ -73,6 +83,8 @@ UINT _fx_media_volume_get(FX_MEDIA *media_ptr, CHAR *volume_name, UINT volume_so
 UINT _fx_media_volume_get_extended(FX_MEDIA *media_ptr, CHAR *volume_name, UINT volume_name_buffer_length, UINT volume_source);
 UINT _fx_media_volume_set(FX_MEDIA *media_ptr, CHAR *volume_name);
 UINT _fx_media_write(FX_MEDIA *media_ptr, ULONG logical_sector, VOID *buffer_ptr);
+UINT _fx_media_writeback_set(FX_MEDIA *media_ptr, ULONG max_age, ULONG high_water_percent);
+UINT _fx_media_writeback_poll(FX_MEDIA *media_ptr);
 UINT _fx_media_open_notify_set(FX_MEDIA *media_ptr, VOID (*media_open_notify)(FX_MEDIA *));
 UINT _fx_media_close_notify_set(FX_MEDIA *media_ptr, VOID (*media_close_notify)(FX_MEDIA *));
 UINT _fx_media_extended_space_available(FX_MEDIA *media_ptr, ULONG64 *available_bytes_ptr);
@@ -80,8 +92,17 @@ UINT _fx_media_extended_space_available(FX_MEDIA *media_ptr, ULONG64 *available_
 
 UINT _fxe_media_abort(FX_MEDIA *media_ptr);
 UINT _fxe_media_cache_invalidate(FX_MEDIA *media_ptr);
+UINT _fxe_media_cache_partition_set(FX_MEDIA *media_ptr, UINT fat_percent, UINT directory_percent, UINT data_percent);
+UINT _fxe_media_cache_resize(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size);
+UINT _fxe_media_cache_pool_create(FX_SECTOR_CACHE_POOL *pool_ptr, VOID *memory_ptr, ULONG memory_size, UINT bytes_per_sector);
+UINT _fxe_media_cache_pool_attach(FX_MEDIA *media_ptr, FX_SECTOR_CACHE_POOL *pool_ptr, ULONG reserved_sectors);
+UINT _fxe_media_cache_pool_detach(FX_MEDIA *media_ptr);
+UINT _fxe_media_cluster_bitmap_enable(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size);
 UINT _fxe_media_check(FX_MEDIA *media_ptr, UCHAR *scratch_memory_ptr, ULONG scratch_memory_size, ULONG error_correction_option, ULONG *errors_detected);
 UINT _fxe_media_close(FX_MEDIA *media_ptr);
+UINT _fxe_media_defragment(FX_MEDIA *media_ptr, VOID *scratch_ptr, ULONG scratch_size, ULONG budget);
+UINT _fxe_media_fat_cache_configure(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size, UINT ways);
+UINT _fxe_media_fat_mirror_defer(FX_MEDIA *media_ptr, ULONG record_sector, ULONG idle_polls);
 UINT _fxe_media_flush(FX_MEDIA *media_ptr);
 UINT _fxe_media_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOID *driver_info_ptr, UCHAR *memory_ptr, UINT memory_size,
                        CHAR *volume_name, UINT number_of_fats, UINT directory_entries, UINT hidden_sectors,
@@ -89,6 +110,7 @@ UINT _fxe_media_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOI
                        UINT heads, UINT sectors_per_track);
 UINT _fxe_media_exFAT_format(FX_MEDIA *media_ptr, VOID (*driver)(FX_MEDIA *media), VOID *driver_info_ptr, UCHAR *memory_ptr, UINT memory_size,
                              CHAR *volume_name, UINT number_of_fats, ULONG64 hidden_sectors, ULONG64 total_sectors, UINT bytes_per_sector, UINT sectors_per_cluster, UINT volume_serial_number, UINT boundary_unit);
+UINT _fxe_media_exfat_bitmap_cache_configure(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size, ULONG window_sectors);
 UINT _fxe_media_open(FX_MEDIA *media_ptr, CHAR *media_name,
                      VOID (*media_driver)(FX_MEDIA *), VOID *driver_info_ptr,
                      VOID *memory_ptr, ULONG memory_size, UINT media_control_block_size);
@@ -98,6 +120,8 @@ UINT _fxe_media_volume_get(FX_MEDIA *media_ptr, CHAR *volume_name, UINT volume_s
 UINT _fxe_media_volume_get_extended(FX_MEDIA *media_ptr, CHAR *volume_name, UINT volume_name_buffer_length, UINT volume_source);
 UINT _fxe_media_volume_set(FX_MEDIA *media_ptr, CHAR *volume_name);
 UINT _fxe_media_write(FX_MEDIA *media_ptr, ULONG logical_sector, VOID *buffer_ptr);
+UINT _fxe_media_writeback_set(FX_MEDIA *media_ptr, ULONG max_age, ULONG high_water_percent);
+UINT _fxe_media_writeback_poll(FX_MEDIA *media_ptr);
 UINT _fxe_media_open_notify_set(FX_MEDIA *media_ptr, VOID (*media_open_notify)(FX_MEDIA *));
 UINT _fxe_media_close_notify_set(FX_MEDIA *media_ptr, VOID (*media_close_notify)(FX_MEDIA *));
 UINT _fxe_media_extended_space_available(FX_MEDIA *media_ptr, ULONG64 *available_bytes_ptr);
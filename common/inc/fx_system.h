@@ -54,6 +54,7 @@
 /* Define System component constants.  */
 
 #define FX_TIMER_ID                 ((ULONG) 0x46585359)
+#define FX_WRITEBACK_THREAD_ID      ((ULONG) 0x46585742)
 
 
 /* Define the external System component function prototypes.  */
@@ -64,6 +65,9 @@ UINT _fx_system_time_set(UINT hour, UINT minute, UINT second);
 UINT _fx_system_date_get(UINT *year, UINT *month, UINT *day);
 UINT _fx_system_time_get(UINT *hour, UINT *minute, UINT *second);
 VOID _fx_system_timer_entry(ULONG id);
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+VOID _fx_system_writeback_thread_entry(ULONG id);
+#endif
 
 UINT _fxe_system_date_set(UINT year, UINT month, UINT day);
 UINT _fxe_system_time_set(UINT hour, UINT minute, UINT second);
@@ -124,13 +128,17 @@ SYSTEM_DECLARE  ULONG  _fx_system_media_max_fat_cache;
 
                     31-24               FX_MAX_LONG_NAME_LEN
                     23-16               FX_MAX_LAST_NAME_LEN
-                    15-11               Reserved
+                    15                  FX_ENABLE_FILE_READ_AHEAD defined
+                    14                  FX_ENABLE_COALESCED_SECTOR_FLUSH defined
+                    13                  FX_ENABLE_SECTOR_CACHE_PARTITION defined
+                    12                  FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE defined
+                    11                  FX_ENABLE_LRU_SECTOR_CACHE defined
                     10                  FX_NO_TIMER defined
                     9                   FX_SINGLE_THREAD defined
                     8                   FX_DONT_UPDATE_OPEN_FILES defined
                     7                   FX_MEDIA_DISABLE_SEARCH_CACHE defined
                     6                   FX_MEDIA_STATISTICS_DISABLE defined
-                    5                   Reserved
+                    5                   FX_ENABLE_FILE_WRITE_BUFFER defined
                     4                   FX_SINGLE_OPEN_LEGACY defined
                     3                   FX_RENAME_PATH_INHERIT defined
                     2                   FX_NO_LOCAL_PATH defined
@@ -149,7 +157,14 @@ SYSTEM_DECLARE  ULONG  _fx_system_media_max_fat_cache;
 
                     Bit(s)                   Meaning
 
-                    31-24               Reserved
+                    31                  FX_ENABLE_LAZY_FREE_CLUSTER_COUNT defined
+                    30                  FX_ENABLE_FILE_EXTENT_MAP defined
+                    29                  FX_ENABLE_FAT_CLUSTER_BITMAP defined
+                    28                  FX_ENABLE_BACKGROUND_WRITEBACK defined
+                    27                  FX_ENABLE_SECTOR_CACHE_POOL defined
+                    26                  FX_ENABLE_FILE_READ_BORROW defined
+                    25                  FX_ENABLE_SCATTER_GATHER_DRIVER defined
+                    24                  FX_ENABLE_ASYNC_DRIVER defined
                     23-16               FX_UPDATE_RATE_IN_SECONDS
                     15-0                FX_UPDATE_RATE_IN_TICKS
 
@@ -171,5 +186,17 @@ SYSTEM_DECLARE  ULONG _fx_system_build_options_3;
 SYSTEM_DECLARE  TX_TIMER _fx_system_timer;
 #endif
 
+
+/* Define the writeback thread control block and stack.  The thread writes
+   out the dirty sectors of the opened media in the background, it is not
+   present if FX_SINGLE_THREAD is defined.  */
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+#ifndef FX_SINGLE_THREAD
+SYSTEM_DECLARE  TX_THREAD _fx_system_writeback_thread;
+SYSTEM_DECLARE  ULONG _fx_system_writeback_thread_stack[FX_WRITEBACK_THREAD_STACK_SIZE / sizeof(ULONG)];
+#endif
+#endif
+
 #endif
 
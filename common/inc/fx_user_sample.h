@@ -87,6 +87,185 @@
 /*#define FX_MAX_SECTOR_CACHE             256   */      /* Minimum value is 2, all other values must be power of 2.  */
 
 
+/* Defined, the logical sector cache uses a hash table and a doubly-linked least recently used
+   list instead of the 4-way hashed or linear cache. Lookups and replacement take constant time,
+   and the number of cached sectors is only limited by the memory supplied to fx_media_open. When
+   more than FX_MAX_SECTOR_CACHE sectors fit, the cache control blocks and hash buckets are taken
+   from the end of that memory.  */
+
+/*#define FX_ENABLE_LRU_SECTOR_CACHE  */
+
+
+/* Defined, data sectors entering the logical sector cache are kept on a probationary queue and
+   are only promoted to the main list when referenced again, so bulk data reads cannot evict the
+   FAT and directory sectors. The probationary queue holds at most 1/(2^FX_SECTOR_CACHE_PROBATION_SHIFT)
+   of the cache. This option enables FX_ENABLE_LRU_SECTOR_CACHE.  */
+
+/*#define FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE  */
+/*#define FX_SECTOR_CACHE_PROBATION_SHIFT         2   */
+
+
+/* Defined, fx_media_cache_partition_set can reserve a percentage of the logical sector cache for
+   FAT, directory and data sectors, each of which is then replaced on its own. This option enables
+   FX_ENABLE_LRU_SECTOR_CACHE and cannot be combined with FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE.  */
+
+/*#define FX_ENABLE_SECTOR_CACHE_PARTITION  */
+
+
+/* Defined, flushing the logical sector cache sorts the dirty sectors and writes each run of
+   consecutive sectors with one driver request. Runs whose cache buffers are not adjacent are
+   copied into a bounce buffer of FX_SECTOR_FLUSH_BUFFER_SIZE bytes. FX_SECTOR_FLUSH_BATCH is the
+   number of dirty sectors sorted at a time.  */
+
+/*#define FX_ENABLE_COALESCED_SECTOR_FLUSH  */
+/*#define FX_SECTOR_FLUSH_BATCH           32   */
+/*#define FX_SECTOR_FLUSH_BUFFER_SIZE     4096 */
+
+
+/* Defined, fx_file_read detects sequential reads of a file and reads the following sectors of the
+   file into the logical sector cache with one driver request. The read-ahead window grows up to
+   FX_FILE_READ_AHEAD_SECTORS, which can be changed for each open file in fx_file_read_ahead_max_sectors.
+   The sectors are read through a buffer of FX_READ_AHEAD_BUFFER_SIZE bytes.  */
+
+/*#define FX_ENABLE_FILE_READ_AHEAD  */
+/*#define FX_FILE_READ_AHEAD_SECTORS      16   */
+/*#define FX_READ_AHEAD_BUFFER_SIZE       8192 */
+
+
+/* Defined, fx_file_write_buffer_set gives an open file a buffer that gathers small appends, which
+   are written to the file in whole sectors when the buffer fills and completely when the file is
+   read, seeked, truncated, allocated or closed, or the media is flushed or closed. Buffered data
+   is lost if power fails before it is written, and is discarded if writing it fails, in which case
+   the call that wrote it returns the error.  */
+
+/*#define FX_ENABLE_FILE_WRITE_BUFFER  */
+
+
+/* Defined, the clusters needed by a write to a FAT12/16/32 file are allocated as one run of
+   consecutive free clusters where there is one, after the file if possible. The write buffer is
+   enabled as well, so the appends it gathers are allocated together when it is written.  */
+
+/*#define FX_ENABLE_FILE_DELAYED_ALLOCATION  */
+
+
+/* Defines the number of FAT entries searched for a run of free clusters by a write with
+   FX_ENABLE_FILE_DELAYED_ALLOCATION when there is no free cluster bitmap. By default this value
+   is 1024.  */
+
+/*#define FX_FILE_DELAYED_ALLOCATION_SEARCH_CLUSTERS  1024  */
+
+
+/* Defined, drivers that set fx_media_driver_async_supported during FX_DRIVER_INIT receive
+   FX_DRIVER_ASYNC_SUBMIT and FX_DRIVER_ASYNC_WAIT requests, so several driver requests can be
+   outstanding. FX_ASYNC_DRIVER_QUEUE_DEPTH is the maximum number of outstanding requests.  */
+
+/*#define FX_ENABLE_ASYNC_DRIVER  */
+/*#define FX_ASYNC_DRIVER_QUEUE_DEPTH     8    */
+
+
+/* Defined, drivers that set fx_media_driver_scatter_gather_supported during FX_DRIVER_INIT receive
+   FX_DRIVER_SCATTER_READ and FX_DRIVER_GATHER_WRITE requests, so a direct file read or write of a
+   fragmented file takes one driver request. FX_SCATTER_GATHER_SEGMENTS is the maximum number of
+   segments in a request.  */
+
+/*#define FX_ENABLE_SCATTER_GATHER_DRIVER  */
+/*#define FX_SCATTER_GATHER_SEGMENTS      16   */
+
+
+/* Defined, fx_file_read_borrow returns a pointer to the file data inside the logical sector cache
+   instead of copying it, and pins the cache entry until fx_file_read_release is called. This
+   option enables FX_ENABLE_LRU_SECTOR_CACHE.  */
+
+/*#define FX_ENABLE_FILE_READ_BORROW  */
+
+
+/* Defined, fx_media_cache_pool_attach lets several media take their logical sector cache entries
+   from one pool built with fx_media_cache_pool_create. FX_SECTOR_CACHE_POOL_MEDIA is the maximum
+   number of media attached to a pool. This option enables FX_ENABLE_LRU_SECTOR_CACHE.  */
+
+/*#define FX_ENABLE_SECTOR_CACHE_POOL  */
+/*#define FX_SECTOR_CACHE_POOL_MEDIA      4    */
+
+
+/* Defined, fx_media_writeback_poll writes out dirty logical sectors once they reach a maximum age
+   or when too much of the cache is dirty. Unless FX_SINGLE_THREAD is defined, a FileX writeback
+   thread polls the opened media every FX_WRITEBACK_INTERVAL_TICKS. The age is counted in polls.
+   This option enables FX_ENABLE_LRU_SECTOR_CACHE.  */
+
+/*#define FX_ENABLE_BACKGROUND_WRITEBACK  */
+/*#define FX_WRITEBACK_MAX_AGE            10   */
+/*#define FX_WRITEBACK_HIGH_WATER_PERCENT 50   */
+/*#define FX_WRITEBACK_INTERVAL_TICKS     10   */
+/*#define FX_WRITEBACK_THREAD_PRIORITY    16   */
+/*#define FX_WRITEBACK_THREAD_STACK_SIZE  2048 */
+
+
+/* Defined, fx_media_cluster_bitmap_enable keeps a bitmap of the clusters in use of a FAT12/16/32
+   media in application memory, so allocating clusters does not read the FAT entry of every
+   cluster in use on the way to a free one.  */
+
+/*#define FX_ENABLE_FAT_CLUSTER_BITMAP  */
+
+
+/* Defined, fx_file_extent_map_set gives an open file an array of extents that remembers where the
+   runs of its clusters are, so seeks and random access do not follow the cluster chain from the
+   start of the file.  */
+
+/*#define FX_ENABLE_FILE_EXTENT_MAP  */
+
+
+/* Defined, fx_file_defragment moves the clusters of an open file on a FAT12/16/32 media to one run
+   of free clusters, and fx_media_defragment does the same for the files that are not open, moving at
+   least the given number of clusters per call and continuing with the next call.  */
+
+/*#define FX_ENABLE_MEDIA_DEFRAGMENT  */
+
+
+/* Defined, fx_media_open trusts the free cluster count of the FAT32 FSInfo sector and otherwise
+   counts the free clusters only when they are first needed, so the time to open a media does not
+   depend on the size of its FAT.  */
+
+/*#define FX_ENABLE_LAZY_FREE_CLUSTER_COUNT  */
+
+
+/* Defined, fx_media_fat_cache_configure gives the FAT entry cache of an opened media its size and
+   number of ways at run time, in memory supplied by the application.  */
+
+/*#define FX_ENABLE_CONFIGURABLE_FAT_CACHE  */
+
+
+/* Defined, the written primary FAT sectors are recorded in a list of FX_FAT_MIRROR_RANGES ranges,
+   so a FAT flush copies only those sectors to the secondary FATs, several sectors per request
+   through a buffer of FX_FAT_MIRROR_BUFFER_SIZE bytes.  */
+
+/*#define FX_ENABLE_FAT_MIRROR_RANGES  */
+/*#define FX_FAT_MIRROR_RANGES            8    */
+/*#define FX_FAT_MIRROR_BUFFER_SIZE       4096 */
+
+
+/* Defined, fx_media_fat_mirror_defer can defer the copy of the primary FAT to the secondary FATs
+   until the media is closed or idle. The ranges not yet copied, in granules of
+   FX_FAT_MIRROR_DEFER_GRANULE sectors, are recorded in a sector chosen by the application and
+   copied at the next mount if the media was not closed.  */
+
+/*#define FX_ENABLE_FAT_MIRROR_DEFER  */
+/*#define FX_FAT_MIRROR_DEFER_GRANULE     16   */
+
+
+/* Defined, fx_media_exfat_bitmap_cache_configure gives the allocation bitmap cache of an opened exFAT
+   media several windows in memory supplied by the application, replaced in least recently used order,
+   together with a summary of the full bitmap sectors. Free clusters are searched 64 at a time.  */
+
+/*#define FX_ENABLE_EXFAT_BITMAP_WINDOWS  */
+
+
+/* Defines that each open exFAT file holds a window of free clusters in memory that its writes are allocated from,
+   so files written at the same time stay contiguous. FX_EXFAT_RESERVATION_CLUSTERS sets the window size.  */
+
+/*#define FX_ENABLE_EXFAT_CLUSTER_RESERVATION  */
+/*#define FX_EXFAT_RESERVATION_CLUSTERS   64  */
+
+
 /* Defines the size in bytes of the bit map used to update the secondary FAT sectors. The larger the value the
    less unnecessary secondary FAT sector writes.   */
 
@@ -56,6 +56,33 @@
 #define FX_UTILITY_H
 
 
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+/* Define the macros that map a sector type to its logical sector cache partition and to
+   the partition that caches it with the current partitioning of the media.  */
+
+#define FX_SECTOR_CACHE_PARTITION_OF(sector_type)                                           \
+    (((sector_type) == FX_FAT_SECTOR) ? FX_SECTOR_CACHE_PARTITION_FAT :                     \
+     (((sector_type) == FX_DATA_SECTOR) ? FX_SECTOR_CACHE_PARTITION_DATA :                  \
+      FX_SECTOR_CACHE_PARTITION_DIRECTORY))
+
+#define FX_SECTOR_CACHE_PARTITION_GET(media_ptr, sector_type)                               \
+    (((media_ptr) -> fx_media_sector_cache_partitioned) ?                                   \
+     FX_SECTOR_CACHE_PARTITION_OF(sector_type) : FX_SECTOR_CACHE_PARTITION_DATA)
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+
+/* Define the macro that determines if a cache entry belongs to the media. Without a cache
+   pool, all entries of the cache array belong to the media.  */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+#define FX_CACHED_SECTOR_OWNED(media_ptr, cache_entry)                                      \
+    ((cache_entry) -> fx_cached_sector_media == (media_ptr))
+#else
+#define FX_CACHED_SECTOR_OWNED(media_ptr, cache_entry)      FX_TRUE
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+
 /* Define the internal Utility component function prototypes.  */
 
 UINT    _fx_utility_16_unsigned_read(UCHAR *source_ptr);
@@ -64,6 +91,9 @@ ULONG   _fx_utility_32_unsigned_read(UCHAR *source_ptr);
 VOID    _fx_utility_32_unsigned_write(UCHAR *dest_ptr, ULONG value);
 ULONG64 _fx_utility_64_unsigned_read(UCHAR *source_ptr);
 VOID    _fx_utility_64_unsigned_write(UCHAR *dest_ptr, ULONG64 value);
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+UINT    _fx_utility_64_trailing_zeros(ULONG64 value);
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 VOID    _fx_utility_memory_copy(UCHAR *source_ptr, UCHAR *dest_ptr, ULONG size);
 VOID    _fx_utility_memory_set(UCHAR *dest_ptr, UCHAR value, ULONG size);
 FX_CACHED_SECTOR
@@ -73,10 +103,68 @@ UINT    _fx_utility_logical_sector_read(FX_MEDIA *media_ptr, ULONG64 logical_sec
 UINT    _fx_utility_logical_sector_write(FX_MEDIA *media_ptr, ULONG64 logical_sector,
                                          VOID *buffer_ptr, ULONG sectors, UCHAR sector_type);
 UINT    _fx_utility_logical_sector_flush(FX_MEDIA *media_ptr, ULONG64 starting_sector, ULONG64 sectors, UINT invalidate);
+UINT    _fx_utility_logical_sector_cache_initialize(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size);
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+UINT    _fx_utility_logical_sector_flush_coalesced(FX_MEDIA *media_ptr, ULONG64 starting_sector, ULONG64 sectors);
+#ifdef FX_ENABLE_ASYNC_DRIVER
+VOID    _fx_utility_logical_sector_flush_complete(FX_MEDIA *media_ptr, FX_DRIVER_REQUEST *request_ptr);
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+#endif /* FX_ENABLE_COALESCED_SECTOR_FLUSH */
+#ifdef FX_ENABLE_ASYNC_DRIVER
+UINT    _fx_utility_driver_request_submit(FX_MEDIA *media_ptr, UINT request_type, ULONG64 logical_sector, VOID *buffer_ptr,
+                                          ULONG sectors, UINT sector_type,
+                                          VOID (*request_complete)(FX_MEDIA *, FX_DRIVER_REQUEST *), VOID *context_ptr);
+UINT    _fx_utility_driver_request_wait(FX_MEDIA *media_ptr, ULONG outstanding);
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+UINT    _fx_utility_logical_sector_scatter_gather(FX_MEDIA *media_ptr, UINT request_type, ULONG segments, UCHAR sector_type);
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+FX_CACHED_SECTOR
+       *_fx_utility_logical_sector_cache_lookup(FX_MEDIA *media_ptr, ULONG64 logical_sector);
+VOID    _fx_utility_logical_sector_cache_entry_insert(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry);
+VOID    _fx_utility_logical_sector_cache_entry_promote(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry);
+VOID    _fx_utility_logical_sector_cache_entry_demote(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry);
+VOID    _fx_utility_logical_sector_cache_entry_link(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry, UINT append);
+VOID    _fx_utility_logical_sector_cache_entry_unlink(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry);
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+#ifdef FX_ENABLE_FILE_READ_BORROW
+FX_CACHED_SECTOR
+       *_fx_utility_logical_sector_cache_entry_unpinned(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry);
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+FX_CACHED_SECTOR
+       *_fx_utility_logical_sector_cache_pool_entry_get(FX_MEDIA *media_ptr);
+VOID    _fx_utility_logical_sector_cache_pool_release(FX_MEDIA *media_ptr);
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+UINT    _fx_utility_FAT_chain_read(FX_MEDIA *media_ptr, ULONG cluster, ULONG max_clusters,
+                                   ULONG *run_clusters_ptr, ULONG *next_cluster_ptr);
+UINT    _fx_utility_FAT_chain_write(FX_MEDIA *media_ptr, ULONG cluster, ULONG clusters, ULONG last_entry);
+#ifdef FX_ENABLE_MEDIA_DEFRAGMENT
+UINT    _fx_utility_FAT_chain_relocate(FX_MEDIA *media_ptr, FX_DIR_ENTRY *entry_ptr, VOID *scratch_ptr, ULONG scratch_size,
+                                       ULONG *clusters_moved);
+#endif /* FX_ENABLE_MEDIA_DEFRAGMENT */
 UINT    _fx_utility_FAT_entry_read(FX_MEDIA *media_ptr, ULONG cluster, ULONG *entry_ptr);
 UINT    _fx_utility_FAT_entry_write(FX_MEDIA *media_ptr, ULONG cluster, ULONG next_cluster);
 UINT    _fx_utility_FAT_flush(FX_MEDIA *media_ptr);
 UINT    _fx_utility_FAT_map_flush(FX_MEDIA *media_ptr);
+UINT    _fx_utility_FAT_map_set(FX_MEDIA *media_ptr, ULONG FAT_sector, ULONG sectors);
+UINT    _fx_utility_FAT_mirror_record_write(FX_MEDIA *media_ptr);
+UINT    _fx_utility_FAT_mirror_sync(FX_MEDIA *media_ptr);
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+UINT    _fx_utility_FAT_bitmap_free_cluster_find(FX_MEDIA *media_ptr, ULONG search_start_cluster, ULONG *free_cluster);
+UINT    _fx_utility_FAT_bitmap_free_run_find(FX_MEDIA *media_ptr, ULONG clusters, ULONG *start_cluster, ULONG *run_clusters);
+VOID    _fx_utility_FAT_bitmap_update(FX_MEDIA *media_ptr, ULONG cluster, ULONG next_cluster);
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+UINT    _fx_utility_FAT_free_cluster_count(FX_MEDIA *media_ptr);
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+ULONG   _fx_utility_FAT_free_entries_count(UCHAR *buffer_ptr, ULONG entries, UINT entry_size, ULONG *first_free_entry);
+#if defined(FX_ENABLE_FILE_DELAYED_ALLOCATION) || defined(FX_ENABLE_MEDIA_DEFRAGMENT)
+UINT    _fx_utility_FAT_free_run_find(FX_MEDIA *media_ptr, ULONG last_cluster, ULONG clusters, ULONG search_clusters,
+                                      ULONG *start_cluster);
+#endif /* FX_ENABLE_FILE_DELAYED_ALLOCATION || FX_ENABLE_MEDIA_DEFRAGMENT */
+UINT    _fx_utility_FAT_sector_flush(FX_MEDIA *media_ptr, ULONG index);
 ULONG   _fx_utility_FAT_sector_get(FX_MEDIA *media_ptr, ULONG cluster);
 UINT    _fx_utility_string_length_get(CHAR *string, UINT max_length);
 
@@ -110,6 +198,17 @@ UINT   _fx_utility_exFAT_bitmap_cache_prepare(FX_MEDIA *media_ptr, ULONG cluster
 UINT   _fx_utility_exFAT_cluster_state_get(FX_MEDIA *media_ptr, ULONG cluster, UCHAR *cluster_state);
 UINT   _fx_utility_exFAT_cluster_state_set(FX_MEDIA *media_ptr, ULONG cluster, UCHAR new_cluster_state);
 UINT   _fx_utility_exFAT_bitmap_free_cluster_find(FX_MEDIA *media_ptr, ULONG start, ULONG *free_cluster);
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+UINT   _fx_utility_exFAT_bitmap_free_run_find(FX_MEDIA *media_ptr, ULONG first_cluster, ULONG last_cluster, ULONG clusters,
+                                              ULONG *start_cluster, ULONG *run_clusters);
+UINT   _fx_utility_exFAT_bitmap_window_flush(FX_MEDIA *media_ptr, FX_EXFAT_BITMAP_WINDOW *window_ptr);
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+ULONG64 _fx_utility_exFAT_reservation_mask(FX_MEDIA *media_ptr, ULONG cluster, ULONG clusters);
+ULONG  _fx_utility_exFAT_reservation_release(FX_MEDIA *media_ptr);
+UINT   _fx_utility_exFAT_reserved_cluster_get(FX_MEDIA *media_ptr, FX_FILE *file_ptr, ULONG last_cluster, ULONG clusters,
+                                              ULONG *cluster);
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
 USHORT _fx_utility_exFAT_upcase_get(USHORT character);
 USHORT _fx_utility_exFAT_name_hash_get(CHAR *name);
 USHORT _fx_utility_exFAT_unicode_name_hash_get(CHAR *unicode_name, ULONG unicode_length);
@@ -74,9 +74,12 @@
 /*    _fx_utility_exFAT_bitmap_free_cluster_find                          */
 /*                                            Find exFAT free cluster     */
 /*    _fx_utility_exFAT_cluster_state_set   Set cluster state             */
+/*    _fx_utility_FAT_bitmap_free_cluster_find                            */
+/*                                          Find free cluster in bitmap   */
 /*    _fx_utility_FAT_flush                 Flush written FAT entries     */
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
 /*    _fx_utility_FAT_entry_write           Write a FAT entry             */
+/*    _fx_utility_FAT_free_cluster_count    Count the free clusters       */
 /*    _fx_utility_logical_sector_flush      Flush the written log sector  */
 /*    _fx_utility_logical_sector_read       Read logical sector           */
 /*    _fx_fault_tolerant_transaction_start  Start fault tolerant          */
@@ -195,6 +198,23 @@ FX_INT_SAVE_AREA
         return(FX_WRITE_PROTECT);
     }
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* Make sure the free clusters of the media have been counted.  */
+    status =  _fx_utility_FAT_free_cluster_count(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the bad status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+
     /* Make sure there is at least one cluster remaining for the new file.  */
     if (!media_ptr -> fx_media_available_clusters)
     {
@@ -306,6 +326,43 @@ FX_INT_SAVE_AREA
         FAT_index    =      media_ptr -> fx_media_cluster_search_start;
         total_clusters =    media_ptr -> fx_media_total_clusters;
 
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+        /* Determine if the free cluster bitmap is available.  */
+        if (media_ptr -> fx_media_cluster_bitmap)
+        {
+
+            /* Yes, find the next free cluster in the bitmap instead of reading the FAT.  */
+            status =  _fx_utility_FAT_bitmap_free_cluster_find(media_ptr, FAT_index, &FAT_index);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+                FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Move cluster search pointer forward.  */
+            media_ptr -> fx_media_cluster_search_start =  FAT_index + 1;
+
+            /* Determine if this needs to be wrapped.  */
+            if (media_ptr -> fx_media_cluster_search_start >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
+            {
+
+                /* Wrap the search to the beginning FAT entry.  */
+                media_ptr -> fx_media_cluster_search_start =  FX_FAT_ENTRY_START;
+            }
+        }
+        else
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
         /* Loop to find the first available cluster.  */
         do
         {
@@ -69,6 +69,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _fx_directory_exFAT_entry_read        Read exFAT entries            */
+/*    _fx_utility_FAT_chain_read            Read a run of the FAT chain   */
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
 /*    _fx_utility_logical_sector_read       Read directory sector         */
 /*    _fx_utility_16_unsigned_read          Read a UINT from memory       */
@@ -100,6 +101,7 @@ UINT   i, j, card, dotflag, get_short_name;
 UINT   number_of_lfns;
 UINT   status;
 ULONG  cluster, next_cluster = 0;
+ULONG  run_clusters;
 UINT   relative_cluster;
 UINT   relative_sector;
 ULONG  logical_sector;
@@ -212,8 +214,8 @@ ULONG  entry = *entry_ptr;
                 return(FX_FILE_CORRUPT);
             }
 
-            /* Read the next cluster.  */
-            status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &next_cluster);
+            /* Read the run of consecutive clusters from this cluster.  */
+            status =  _fx_utility_FAT_chain_read(media_ptr, cluster, relative_cluster - i, &run_clusters, &next_cluster);
 
             /* There is a potential for loop, but hardly anything can be done */
 
@@ -228,8 +230,8 @@ ULONG  entry = *entry_ptr;
             /* Setup the actual cluster.  */
             cluster = next_cluster;
 
-            /* Increment the relative cluster number.  */
-            i++;
+            /* Skip the clusters of the run.  */
+            i =  i + (UINT)run_clusters;
         }
 
         /* At this point, the directory data sector needs to be read.  */
@@ -334,7 +334,8 @@ ULONG             bytes_per_cluster;
                new directory.  We don't need to worry about the first sector since it
                was read using the logical sector read utility earlier.  */
             if ((cache_entry_ptr -> fx_cached_sector >= (logical_sector + 1)) &&
-                (cache_entry_ptr -> fx_cached_sector <  (logical_sector + sectors)))
+                (cache_entry_ptr -> fx_cached_sector <  (logical_sector + sectors)) &&
+                (FX_CACHED_SECTOR_OWNED(media_ptr, cache_entry_ptr)))
             {
 
                 /* Yes, we have found a logical sector in the cache that is one of the directory
@@ -344,11 +345,19 @@ ULONG             bytes_per_cluster;
                 cache_entry_ptr -> fx_cached_sector_buffer_dirty =   FX_FALSE;
             }
 
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+            /* The cached sector list does not start with the first entry, so simply
+               move to the next entry in memory.  */
+            cache_entry_ptr++;
+#else
+
             /* Move to next entry in the cached sector list.  */
             if (cache_entry_ptr -> fx_cached_sector_next_used)
             {
                 cache_entry_ptr =  cache_entry_ptr -> fx_cached_sector_next_used;
             }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
         }
 #endif
 
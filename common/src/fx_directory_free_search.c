@@ -64,9 +64,12 @@
 /*                                                                        */
 /*    _fx_directory_entry_read              Read entries from directory   */
 /*    _fx_directory_entry_write             Write entries to directory    */
+/*    _fx_utility_FAT_bitmap_free_cluster_find                            */
+/*                                          Find free cluster in bitmap   */
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
 /*    _fx_utility_FAT_entry_write           Write a FAT entry             */
 /*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*    _fx_utility_FAT_free_cluster_count    Count the free clusters       */
 /*    _fx_utility_logical_sector_flush      Flush logical sector cache    */
 /*    _fx_utility_logical_sector_read       Read logical sector           */
 /*    _fx_utility_logical_sector_write      Write logical sector          */
@@ -436,6 +439,20 @@ FX_INT_SAVE_AREA
             /* Now calculate how many clusters we need for the new directory entry.  */
             clusters_needed = (sectors + (media_ptr -> fx_media_sectors_per_cluster - 1)) / media_ptr -> fx_media_sectors_per_cluster;
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+            /* Make sure the free clusters of the media have been counted.  */
+            status =  _fx_utility_FAT_free_cluster_count(media_ptr);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+
             /* Not enough empty entries were found.  If the specified directory is a sub-directory,
                attempt to allocate another cluster to it.  */
             if (((search_dir_ptr) || (media_ptr -> fx_media_32_bit_FAT)) && (media_ptr -> fx_media_available_clusters >= clusters_needed))
@@ -455,6 +472,36 @@ FX_INT_SAVE_AREA
                     /* Decrease the cluster count.  */
                     clusters--;
 
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+                    /* Determine if the free cluster bitmap is available.  */
+                    if (media_ptr -> fx_media_cluster_bitmap)
+                    {
+
+                        /* Yes, find the next free cluster in the bitmap instead of reading the FAT.  */
+                        status =  _fx_utility_FAT_bitmap_free_cluster_find(media_ptr, FAT_index, &FAT_index);
+
+                        /* Check for a bad status.  */
+                        if (status != FX_SUCCESS)
+                        {
+
+                            /* Return the bad status.  */
+                            return(status);
+                        }
+
+                        /* Move cluster search pointer forward.  */
+                        media_ptr -> fx_media_cluster_search_start =  FAT_index + 1;
+
+                        /* Determine if this needs to be wrapped.  */
+                        if (media_ptr -> fx_media_cluster_search_start >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
+                        {
+
+                            /* Wrap the search to the beginning FAT entry.  */
+                            media_ptr -> fx_media_cluster_search_start =  FX_FAT_ENTRY_START;
+                        }
+                    }
+                    else
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
                     /* Loop to find the first available cluster.  */
                     do
                     {
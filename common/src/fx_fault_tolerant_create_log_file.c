@@ -65,6 +65,7 @@
 /*                                          Write checksum of boot sector */
 /*    _fx_utility_exFAT_bitmap_free_cluster_find                          */
 /*                                          Find a free cluster           */
+/*    _fx_utility_FAT_free_cluster_count    Count the free clusters       */
 /*    _fx_utility_logical_sector_read       Read a logical sector         */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -100,6 +101,20 @@ UCHAR *byte_ptr;
 UCHAR  cluster_state;
 #endif /* FX_ENABLE_EXFAT */
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* Make sure the free clusters of the media have been counted.  */
+    status =  _fx_utility_FAT_free_cluster_count(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the bad status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+
     /* Yes. Create a log file. */
     /* First find a free cluster. */
     if (media_ptr -> fx_media_available_clusters < media_ptr -> fx_media_fault_tolerant_clusters)
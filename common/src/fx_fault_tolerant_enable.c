@@ -74,6 +74,7 @@
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
 /*    _fx_utility_16_unsigned_read          Read a USHORT from memory     */
 /*    _fx_utility_32_unsigned_read          Read a ULONG from memory      */
+/*    _fx_utility_FAT_free_entries_count    Count free FAT entries        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -101,10 +102,13 @@ ULONG                         checksum;
 ULONG                         total_size;
 FX_FAULT_TOLERANT_LOG_HEADER *log_header;
 FX_FAULT_TOLERANT_FAT_CHAIN  *FAT_chain;
+ULONG                         i;
+#ifndef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
 ULONG                         cluster_number;
-ULONG                         i, j;
-ULONG                         FAT_entry, FAT_sector, FAT_read_sectors;
+ULONG                         FAT_sector, FAT_read_sectors;
+ULONG                         FAT_entries, free_entries, first_free_entry;
 ULONG                         bytes_in_buffer;
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
 ULONG                         clusters;
 ULONG                         bytes_per_sector; 
 ULONG                         bytes_per_cluster; 
@@ -112,6 +116,20 @@ ULONG                         bytes_per_cluster;
     /* Protect against other threads accessing the media.  */
     FX_PROTECT
 
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+
+    /* The FAT may be read into the whole cache memory, which must not be the memory of a
+       cache pool shared with other media.  */
+    if (media_ptr -> fx_media_sector_cache_pool)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        return(FX_NOT_AVAILABLE);
+    }
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
     /* Calculate clusters needed for fault tolerant log. */
     bytes_per_sector = media_ptr -> fx_media_bytes_per_sector;
     bytes_per_cluster = bytes_per_sector * media_ptr -> fx_media_sectors_per_cluster;
@@ -139,6 +157,15 @@ ULONG                         bytes_per_cluster;
     }
 
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+    if (media_ptr -> fx_media_FAT32_additional_info_sector)
+    {
+
+        /* The count of the additional information sector may not match the FAT the logs
+           recover. Count the free clusters again when they are next needed.  */
+        media_ptr -> fx_media_free_cluster_count_pending =  FX_TRUE;
+    }
+#else
     if (media_ptr -> fx_media_FAT32_additional_info_sector)
     {
 
@@ -216,49 +243,38 @@ ULONG                         bytes_per_cluster;
             /* Calculate the number of bytes in the buffer.  */
             bytes_in_buffer =  (media_ptr -> fx_media_bytes_per_sector * FAT_read_sectors);
 
-            /* Walk through the sector cache memory to search for available clusters and the first
-               available if not already found.  */
-            for (j = 0; j < bytes_in_buffer;)
-            {
-
-                /* Pickup 32-bit FAT entry.  */
-                FAT_entry =  *((ULONG *)&(media_ptr -> fx_media_memory_buffer[j]));
-
-                /* Advance to next FAT entry.  */
-                j = j + 4;
-
-                /* Determine if the FAT entry is free.  */
-                if (FAT_entry == FX_FREE_CLUSTER)
-                {
+            /* Calculate the number of 32-bit FAT entries in the buffer.  */
+            FAT_entries =  bytes_in_buffer / 4;
 
-                    /* Entry is free, increment available clusters.  */
-                    media_ptr -> fx_media_available_clusters++;
+            /* Determine if the buffer reaches the last FAT entry.  */
+            if (FAT_entries >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START - cluster_number))
+            {
 
-                    /* Determine if the starting free cluster has been found yet.  */
-                    if (media_ptr -> fx_media_cluster_search_start == 0)
-                    {
+                /* Yes, only examine the FAT entries up to the last one.  */
+                FAT_entries =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START - cluster_number;
 
-                        /* Remember the first free cluster to start further searches from.  */
-                        media_ptr -> fx_media_cluster_search_start =  cluster_number;
-                    }
-                }
-
-                /* Increment the cluster number.  */
-                cluster_number++;
+                /* Ensure that the outer loop terminates as well.  */
+                i = media_ptr -> fx_media_sectors_per_FAT;
+            }
 
-                /* Determine if we have reviewed all FAT entries.  */
-                if (cluster_number >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
-                {
+            /* Count the available clusters in the sector cache memory and find the first
+               available if not already found.  */
+            free_entries =  _fx_utility_FAT_free_entries_count(media_ptr -> fx_media_memory_buffer, FAT_entries, 4, &first_free_entry);
+            media_ptr -> fx_media_available_clusters =  media_ptr -> fx_media_available_clusters + free_entries;
 
-                    /* Yes, we have looked at all the FAT entries.  */
+            /* Determine if the starting free cluster has been found yet.  */
+            if ((free_entries) && (media_ptr -> fx_media_cluster_search_start == 0))
+            {
 
-                    /* Ensure that the outer loop terminates as well.  */
-                    i = media_ptr -> fx_media_sectors_per_FAT;
-                    break;
-                }
+                /* Remember the first free cluster to start further searches from.  */
+                media_ptr -> fx_media_cluster_search_start =  cluster_number + first_free_entry;
             }
+
+            /* Move to the cluster of the next FAT entry.  */
+            cluster_number =  cluster_number + FAT_entries;
         }
     }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
 
     /* Store memory buffer and size. */
     media_ptr -> fx_media_fault_tolerant_memory_buffer = (UCHAR *)memory_buffer;
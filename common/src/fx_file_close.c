@@ -48,6 +48,9 @@
 /*    to this function will also write the directory entry (with the new  */
 /*    size and time/date stamp) out to disk.                              */
 /*                                                                        */
+/*    If the data in the write buffer of the file cannot be written, it   */
+/*    is discarded, the file is still closed and the error is returned.   */
+/*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    file_ptr                              File control block pointer    */
@@ -59,6 +62,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _fx_directory_entry_write             Write the directory entry     */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -78,6 +82,12 @@ UINT  _fx_file_close(FX_FILE *file_ptr)
 
 UINT      status;
 FX_MEDIA *media_ptr;
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+UINT      buffer_status;
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+#ifdef FX_ENABLE_FILE_READ_BORROW
+FX_CACHED_SECTOR *cache_entry;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
 FX_INT_SAVE_AREA
 
 
@@ -103,6 +113,37 @@ FX_INT_SAVE_AREA
 
     /* Protect against other threads accessing the media.  */
     FX_PROTECT
+
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first. If this fails, the
+       data is discarded, the file is closed anyway and the error is returned at the end.  */
+    buffer_status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+    /* Determine if the file still holds a borrowed sector.  */
+    cache_entry =  file_ptr -> fx_file_borrowed_sector;
+    if (cache_entry)
+    {
+
+        /* Yes, unpin its cache entry.  */
+        cache_entry -> fx_cached_sector_pin_count--;
+        if (cache_entry -> fx_cached_sector_pin_count == 0)
+        {
+            media_ptr -> fx_media_sector_cache_pinned_count--;
+        }
+        file_ptr -> fx_file_borrowed_sector =  FX_NULL;
+    }
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+
+    /* Release the clusters reserved for the file.  */
+    file_ptr -> fx_file_reserved_clusters =  0;
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
+
     /* If trace is enabled, unregister this object.  */
     FX_TRACE_OBJECT_UNREGISTER(file_ptr)
 
@@ -192,7 +233,14 @@ FX_INT_SAVE_AREA
     /* Release media protection.  */
     FX_UNPROTECT
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Return the status of writing the buffered data to the caller.  */
+    return(buffer_status);
+#else
+
     /* Return status to the caller.  */
     return(FX_SUCCESS);
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
 }
 
@@ -0,0 +1,236 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_file.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_defragment                                 PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function moves the clusters of the file to one run of free     */
+/*    clusters of the media if they are not consecutive, so the file is   */
+/*    read and written without following its FAT chain. The data is       */
+/*    copied through the logical sector cache. The file must be opened    */
+/*    for writing. Nothing is moved if there is no run of free clusters   */
+/*    long enough. The other open handles on the same file are updated    */
+/*    to the new clusters.                                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_file_extent_map_invalidate        Invalidate file extent maps   */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
+/*    _fx_utility_FAT_chain_relocate        Move a FAT chain to one run   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_file_defragment(FX_FILE *file_ptr)
+{
+
+#ifdef FX_ENABLE_MEDIA_DEFRAGMENT
+UINT      status;
+ULONG     clusters;
+ULONG     new_cluster;
+ULONG     open_count;
+FX_FILE  *search_ptr;
+FX_MEDIA *media_ptr;
+#endif /* FX_ENABLE_MEDIA_DEFRAGMENT */
+
+
+    /* First, determine if the file is still open.  */
+    if (file_ptr -> fx_file_id != FX_FILE_ID)
+    {
+
+        /* Return the file not open error status.  */
+        return(FX_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_MEDIA_DEFRAGMENT
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Setup pointer to media structure.  */
+    media_ptr =  file_ptr -> fx_file_media_ptr;
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Make sure this file is open for writing.  */
+    if (file_ptr -> fx_file_open_mode != FX_OPEN_FOR_WRITE)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the access error exception - a write was attempted from
+           a file opened for reading!  */
+        return(FX_ACCESS_ERROR);
+    }
+
+    /* Check for write protect at the media level (set by driver).  */
+    if (media_ptr -> fx_media_driver_write_protect)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return write protect error.  */
+        return(FX_WRITE_PROTECT);
+    }
+
+#ifdef FX_ENABLE_EXFAT
+
+    /* Only the FAT chains of FAT12/16/32 media are moved.  */
+    if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the not implemented error.  */
+        return(FX_NOT_IMPLEMENTED);
+    }
+#endif /* FX_ENABLE_EXFAT */
+
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
+    /* The chain of the file starts at its first cluster.  */
+    file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster =  file_ptr -> fx_file_first_physical_cluster;
+
+    /* Move the clusters of the file, copying the data through the cache.  */
+    status =  _fx_utility_FAT_chain_relocate(media_ptr, &(file_ptr -> fx_file_dir_entry), FX_NULL, 0, &clusters);
+
+    /* Determine if the clusters of the file were moved.  */
+    if ((status == FX_SUCCESS) && (clusters))
+    {
+
+        /* Pickup the first cluster of the new chain.  */
+        new_cluster =  file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster;
+
+        /* Update the open handles on the same file, including this one.  */
+        open_count =  media_ptr -> fx_media_opened_file_count;
+        search_ptr =  media_ptr -> fx_media_opened_file_list;
+        while (open_count)
+        {
+
+            /* Determine if this is the same file.  */
+            if ((search_ptr -> fx_file_dir_entry.fx_dir_entry_log_sector ==
+                 file_ptr -> fx_file_dir_entry.fx_dir_entry_log_sector) &&
+                (search_ptr -> fx_file_dir_entry.fx_dir_entry_byte_offset ==
+                 file_ptr -> fx_file_dir_entry.fx_dir_entry_byte_offset))
+            {
+
+                /* Yes, all of its clusters are now consecutive from the new first cluster.  */
+                search_ptr -> fx_file_dir_entry.fx_dir_entry_cluster =  new_cluster;
+                search_ptr -> fx_file_first_physical_cluster =          new_cluster;
+                search_ptr -> fx_file_last_physical_cluster =           new_cluster + clusters - 1;
+                search_ptr -> fx_file_consecutive_cluster =             clusters;
+
+                /* Determine if the handle is positioned in a cluster.  */
+                if (search_ptr -> fx_file_current_physical_cluster)
+                {
+
+                    /* Yes, move its position to the same relative cluster of the new chain.  */
+                    search_ptr -> fx_file_current_physical_cluster =  new_cluster + search_ptr -> fx_file_current_relative_cluster;
+                    search_ptr -> fx_file_current_logical_sector =    media_ptr -> fx_media_data_sector_start +
+                        (((ULONG64)search_ptr -> fx_file_current_physical_cluster - FX_FAT_ENTRY_START) *
+                         ((ULONG64)media_ptr -> fx_media_sectors_per_cluster)) +
+                        search_ptr -> fx_file_current_relative_sector;
+                }
+
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+                /* The sectors read ahead belong to the old chain.  */
+                search_ptr -> fx_file_read_ahead_start_sector =  0;
+                search_ptr -> fx_file_read_ahead_end_sector =    0;
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+            }
+
+            /* Adjust the pointer and decrement the search count.  */
+            search_ptr =  search_ptr -> fx_file_opened_next;
+            open_count--;
+        }
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+        /* The extent maps of the file describe the old chain.  */
+        _fx_file_extent_map_invalidate(file_ptr);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+    }
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return the status.  */
+    return(status);
+#endif /* FX_ENABLE_MEDIA_DEFRAGMENT */
+}
@@ -71,9 +71,16 @@
 /*                                            Find exFAT free cluster     */
 /*    _fx_utility_exFAT_cluster_state_get   Get cluster state             */
 /*    _fx_utility_exFAT_cluster_state_set   Set cluster state             */
+/*    _fx_utility_exFAT_reservation_mask    Get reserved clusters         */
+/*    _fx_utility_exFAT_reservation_release Release reserved clusters     */
+/*    _fx_utility_FAT_bitmap_free_run_find  Find free clusters in bitmap  */
+/*    _fx_utility_exFAT_bitmap_free_run_find                              */
+/*                                          Find free clusters in bitmap  */
+/*    _fx_utility_FAT_chain_write           Link a run of clusters        */
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
 /*    _fx_utility_FAT_entry_write           Write a FAT entry             */
 /*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*    _fx_utility_FAT_free_cluster_count    Count the free clusters       */
 /*    _fx_utility_logical_sector_flush      Flush the written log sector  */
 /*    _fx_fault_tolerant_transaction_start  Start fault tolerant          */
 /*                                            transaction                 */
@@ -81,6 +88,7 @@
 /*    _fx_fault_tolerant_recover            Recover FAT chain             */
 /*    _fx_fault_tolerant_reset_log_file     Reset the log file            */
 /*    _fx_fault_tolerant_set_FAT_chain      Set data of FAT chain         */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -162,6 +170,23 @@ ULONG                  trace_timestamp;
     /* Protect against other threads accessing the media.  */
     FX_PROTECT
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
 #ifdef FX_ENABLE_FAULT_TOLERANT
     /* Start transaction. */
     _fx_fault_tolerant_transaction_start(media_ptr);
@@ -220,6 +245,27 @@ ULONG                  trace_timestamp;
         return(FX_NO_MORE_SPACE);
     }
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* Make sure the free clusters of the media have been counted.  */
+    status =  _fx_utility_FAT_free_cluster_count(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+        FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the bad status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+
     /* Determine if there are no available clusters on the media.  */
     if (!media_ptr -> fx_media_available_clusters)
     {
@@ -258,6 +304,12 @@ ULONG                  trace_timestamp;
     /* Now we need to find the consecutive clusters.  */
     found =             FX_FALSE;
 #ifdef FX_ENABLE_EXFAT
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+
+    /* Release the clusters reserved for the file, so they can be allocated to it now.  */
+    file_ptr -> fx_file_reserved_clusters =  0;
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
+
     if ((file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1) &&
         (file_ptr -> fx_file_last_physical_cluster > FX_FAT_ENTRY_START) &&
         (file_ptr -> fx_file_last_physical_cluster < media_ptr -> fx_media_total_clusters - clusters + FX_FAT_ENTRY_START))
@@ -288,6 +340,15 @@ ULONG                  trace_timestamp;
                 return(status);
             }
 
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+
+            /* A cluster reserved for another open file is not free either.  */
+            if (_fx_utility_exFAT_reservation_mask(media_ptr, FAT_index, 1))
+            {
+                cluster_state =  FX_EXFAT_BITMAP_CLUSTER_OCCUPIED;
+            }
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
+
             /* Determine if the entry is free.  */
             if (cluster_state == FX_EXFAT_BITMAP_CLUSTER_OCCUPIED)
             {
@@ -305,6 +366,72 @@ ULONG                  trace_timestamp;
         maximum_clusters =  0;
         start_FAT_index =   FAT_index;
 
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+        /* Determine if the media is exFAT.  */
+        if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+        {
+
+            /* Yes, find the consecutive clusters in the allocation bitmap a word at a time. If
+               there are not enough, the longest run of free clusters is returned.  */
+            status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, FX_FAT_ENTRY_START,
+                                                             media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START,
+                                                             clusters, &start_FAT_index, &maximum_clusters);
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+
+            /* If the run is too short, release the clusters reserved for open files and search again.  */
+            if ((status == FX_SUCCESS) && (maximum_clusters < clusters) && (_fx_utility_exFAT_reservation_release(media_ptr)))
+            {
+                status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, FX_FAT_ENTRY_START,
+                                                                 media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START,
+                                                                 clusters, &start_FAT_index, &maximum_clusters);
+            }
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
+
+            /* Check for a successful status.  */
+            if (status != FX_SUCCESS)
+            {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+                FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+
+                /* Return the error status.  */
+                return(status);
+            }
+        }
+        else
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
+
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+        /* Determine if the free cluster bitmap is available.  */
+        if (media_ptr -> fx_media_cluster_bitmap)
+        {
+
+            /* Yes, find the consecutive clusters in the bitmap instead of reading the FAT. If
+               there are not enough, the longest run of free clusters is returned.  */
+            status =  _fx_utility_FAT_bitmap_free_run_find(media_ptr, clusters, &start_FAT_index, &maximum_clusters);
+
+            /* Check for a successful status.  */
+            if (status != FX_SUCCESS)
+            {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+                FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+
+                /* Return the error status.  */
+                return(status);
+            }
+        }
+        else
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
         while (FAT_index < (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
         {
 
@@ -491,30 +618,9 @@ ULONG                  trace_timestamp;
                 /* Clusters are not consecutive.  */
                 file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat &= (CHAR)0xfe; /* Set 0bit to 0.  */
 
-                /* Rebuild FAT.  */
-                FAT_value = file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster +
-                            file_ptr -> fx_file_total_clusters - 1; /* Last cluster */
-
-                for (i = file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster; i < FAT_value; ++i)
-                {
-                    status = _fx_utility_FAT_entry_write(media_ptr, i, i + 1);
-                    if (status != FX_SUCCESS)
-                    {
-
-#ifdef FX_ENABLE_FAULT_TOLERANT
-                        FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
-#endif /* FX_ENABLE_FAULT_TOLERANT */
-
-                        /* Release media protection.  */
-                        FX_UNPROTECT
-
-                        /* Return the bad status.  */
-                        return(status);
-                    }
-                }
-
-                /* Close chain.  */
-                status = _fx_utility_FAT_entry_write(media_ptr, FAT_value, media_ptr -> fx_media_fat_last);
+                /* Rebuild FAT by linking the clusters and closing the chain.  */
+                status = _fx_utility_FAT_chain_write(media_ptr, file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster,
+                                                     file_ptr -> fx_file_total_clusters, media_ptr -> fx_media_fat_last);
                 if (status != FX_SUCCESS)
                 {
 
@@ -568,44 +674,50 @@ ULONG                  trace_timestamp;
         }
 #endif /* FX_ENABLE_EXFAT */
 
-        /* Update the link pointers in the new clusters.  */
-        for (i = 0; i < (clusters - 1); i++)
+#ifdef FX_ENABLE_EXFAT
+        status =  FX_SUCCESS;
+        if (!(file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1))
         {
+#endif /* FX_ENABLE_EXFAT */
+
+            /* Update the link pointers in the new clusters.  Since the allocation
+               is sequential, we just have to link each FAT entry to the next one,
+               and place an EOF in the last cluster entry.  */
+            status =  _fx_utility_FAT_chain_write(media_ptr, FAT_index, clusters, media_ptr -> fx_media_fat_last);
 #ifdef FX_ENABLE_EXFAT
-            if (!(file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1)
+        }
 #ifdef FX_ENABLE_FAULT_TOLERANT
-                || (media_ptr -> fx_media_fault_tolerant_enabled == FX_TRUE)
+        else if ((media_ptr -> fx_media_fault_tolerant_enabled == FX_TRUE) && (clusters > 1))
+        {
+
+            /* Link the new clusters, the last cluster entry is not written.  */
+            status =  _fx_utility_FAT_chain_write(media_ptr, FAT_index, clusters - 1, FAT_index + clusters - 1);
+        }
 #endif /* FX_ENABLE_FAULT_TOLERANT */
-               )
-            {
 #endif /* FX_ENABLE_EXFAT */
 
-                /* Update the cluster links.  Since the allocation is
-                   sequential, we just have to link each FAT entry to the
-                   next one.  */
-                status =  _fx_utility_FAT_entry_write(media_ptr, FAT_index + i, FAT_index + i + 1);
-
-                /* Check for a bad status.  */
-                if (status != FX_SUCCESS)
-                {
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
 
 #ifdef FX_ENABLE_FAULT_TOLERANT
-                    FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+            FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
 #endif /* FX_ENABLE_FAULT_TOLERANT */
 
-                    /* Release media protection.  */
-                    FX_UNPROTECT
+            /* Release media protection.  */
+            FX_UNPROTECT
 
-                    /* Return the error status.  */
-                    return(status);
-                }
+            /* Return the error status.  */
+            return(status);
+        }
 #ifdef FX_ENABLE_EXFAT
-            }
 
-            if (media_ptr -> fx_media_FAT_type == FX_exFAT)
-            {
+        if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+        {
 
-                /* Mark the cluster as used.  */
+            /* Mark the new clusters as used.  */
+            for (i = 0; i < clusters; i++)
+            {
                 status = _fx_utility_exFAT_cluster_state_set(media_ptr, FAT_index + i, FX_EXFAT_BITMAP_CLUSTER_OCCUPIED);
 
                 /* Check for a bad status.  */
@@ -623,54 +735,6 @@ ULONG                  trace_timestamp;
                     return(status);
                 }
             }
-#endif /* FX_ENABLE_EXFAT */
-        }
-
-#ifdef FX_ENABLE_EXFAT
-        if (!(file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1))
-        {
-#endif /* FX_ENABLE_EXFAT */
-
-            /* Now place an EOF in the last cluster entry.  */
-            status =  _fx_utility_FAT_entry_write(media_ptr, FAT_index + clusters - 1, media_ptr -> fx_media_fat_last);
-
-            /* Check for a bad status.  */
-            if (status != FX_SUCCESS)
-            {
-
-#ifdef FX_ENABLE_FAULT_TOLERANT
-                FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
-#endif /* FX_ENABLE_FAULT_TOLERANT */
-
-                /* Release media protection.  */
-                FX_UNPROTECT
-
-                /* Return the error status.  */
-                return(status);
-            }
-#ifdef FX_ENABLE_EXFAT
-        }
-
-        if (media_ptr -> fx_media_FAT_type == FX_exFAT)
-        {
-
-            /* Mark the cluster as used.  */
-            status = _fx_utility_exFAT_cluster_state_set(media_ptr, FAT_index + clusters - 1, FX_EXFAT_BITMAP_CLUSTER_OCCUPIED);
-
-            /* Check for a bad status.  */
-            if (status != FX_SUCCESS)
-            {
-
-#ifdef FX_ENABLE_FAULT_TOLERANT
-                FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
-#endif /* FX_ENABLE_FAULT_TOLERANT */
-
-                /* Release media protection.  */
-                FX_UNPROTECT
-
-                /* Return the error status.  */
-                return(status);
-            }
         }
 #endif /* FX_ENABLE_EXFAT */
 
@@ -67,6 +67,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _fx_file_extended_seek                Seek to specified position    */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -84,6 +85,10 @@
 UINT  _fx_file_extended_relative_seek(FX_FILE *file_ptr, ULONG64 byte_offset, UINT seek_from)
 {
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+UINT      status;
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
 #ifndef FX_MEDIA_STATISTICS_DISABLE
 FX_MEDIA *media_ptr;
 
@@ -105,6 +110,21 @@ FX_MEDIA *media_ptr;
     /* If trace is enabled, insert this event into the trace buffer.  */
     FX_TRACE_IN_LINE_INSERT(FX_TRACE_FILE_RELATIVE_SEEK, file_ptr, byte_offset, seek_from, file_ptr -> fx_file_current_file_offset, FX_TRACE_FILE_EVENTS, 0, 0)
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first, so the
+       current offset and size of the file include it.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the error status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
     /* Determine if seeking from the beginning is requested.  */
     if (seek_from == FX_SEEK_BEGIN)
     {
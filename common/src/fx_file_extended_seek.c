@@ -60,7 +60,10 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_file_extent_map_find              Find a cluster in extent map  */
+/*    _fx_file_extent_map_next              Find the next cluster         */
+/*    _fx_utility_FAT_chain_read            Read a run of the FAT chain   */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -89,6 +92,13 @@ ULONG     last_cluster;
 ULONG     cluster_count;
 ULONG64   bytes_remaining;
 FX_MEDIA *media_ptr;
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+ULONG     relative_cluster;
+#else
+ULONG     run_start = 0;
+ULONG     run_clusters = 0;
+ULONG     run_next = 0;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 
 
     /* First, determine if the file is still open.  */
@@ -116,6 +126,23 @@ FX_MEDIA *media_ptr;
     /* Protect against other threads accessing the media.  */
     FX_PROTECT
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
     /* Check if we actually have to do anything.  */
     if (byte_offset == file_ptr -> fx_file_current_file_offset)
     {
@@ -203,6 +230,21 @@ FX_MEDIA *media_ptr;
                 cluster_count =     (file_ptr -> fx_file_consecutive_cluster - 1);
             }
 
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+            /* Find the cluster of the seek position in the extent map of the file, or the
+               last cluster the map describes.  */
+            relative_cluster =  (ULONG)((byte_offset - 1) / bytes_per_cluster);
+            if ((_fx_file_extent_map_find(file_ptr, &relative_cluster, &contents) == FX_SUCCESS) &&
+                (relative_cluster > cluster_count))
+            {
+
+                /* Start following the FAT chain at that cluster.  */
+                cluster =          contents;
+                bytes_remaining =  byte_offset - ((ULONG64)relative_cluster * bytes_per_cluster);
+                cluster_count =    relative_cluster;
+            }
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 
             /* Follow the link of FAT entries.  */
             while ((cluster >= FX_FAT_ENTRY_START) && (cluster < media_ptr -> fx_media_fat_reserved))
@@ -211,8 +253,25 @@ FX_MEDIA *media_ptr;
                 /* Increment the number of clusters.  */
                 cluster_count++;
 
-                /* Read the current cluster entry from the FAT.  */
-                status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &contents);
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+                /* Find the next cluster through the extent map of the file.  */
+                status =  _fx_file_extent_map_next(file_ptr, cluster_count - 1, cluster, &contents);
+#else
+
+                /* Read the FAT chain from the current cluster if it is past the
+                   run of consecutive clusters read last.  */
+                status =  FX_SUCCESS;
+                if ((cluster - run_start) >= run_clusters)
+                {
+                    run_start =  cluster;
+                    status =  _fx_utility_FAT_chain_read(media_ptr, cluster, (ULONG)(bytes_remaining / bytes_per_cluster) + 1,
+                                                         &run_clusters, &run_next);
+                }
+
+                /* Pickup the current cluster entry from the run.  */
+                contents =  ((cluster - run_start) < (run_clusters - 1)) ? (cluster + 1) : run_next;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 
                 /* Check the return value.  */
                 if (status != FX_SUCCESS)
@@ -63,12 +63,15 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _fx_file_extent_map_find              Find a cluster in extent map  */
+/*    _fx_file_extent_map_next              Find the next cluster         */
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
 /*    _fx_fault_tolerant_transaction_start  Start fault tolerant          */
 /*                                            transaction                 */
 /*    _fx_fault_tolerant_transaction_end    End fault tolerant transaction*/
 /*    _fx_fault_tolerant_recover            Recover FAT chain             */
 /*    _fx_fault_tolerant_reset_log_file     Reset the log file            */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -105,6 +108,10 @@ TX_TRACE_BUFFER_ENTRY *trace_event;
 ULONG                  trace_timestamp;
 #endif
 
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+ULONG                  relative_cluster;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
 
     /* First, determine if the file is still open.  */
     if (file_ptr -> fx_file_id != FX_FILE_ID)
@@ -131,6 +138,23 @@ ULONG                  trace_timestamp;
     /* Protect against other threads accessing the media.  */
     FX_PROTECT
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
     /* Make sure this file is open for writing.  */
     if (file_ptr -> fx_file_open_mode != FX_OPEN_FOR_WRITE)
     {
@@ -225,6 +249,21 @@ ULONG                  trace_timestamp;
         last_cluster =      0;
         cluster_count =     0;
 
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+        /* Find the cluster of the new size in the extent map of the file, or the
+           last cluster the map describes.  */
+        relative_cluster =  (ULONG)(size / bytes_per_cluster);
+        if (_fx_file_extent_map_find(file_ptr, &relative_cluster, &contents) == FX_SUCCESS)
+        {
+
+            /* Start following the FAT chain at that cluster.  */
+            cluster =          contents;
+            bytes_remaining =  size - ((ULONG64)relative_cluster * bytes_per_cluster);
+            cluster_count =    relative_cluster;
+        }
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
         /* Follow the link of FAT entries.  */
         while ((cluster >= FX_FAT_ENTRY_START) && (cluster < media_ptr -> fx_media_fat_reserved))
         {
@@ -247,8 +286,15 @@ ULONG                  trace_timestamp;
             {
 #endif /* FX_ENABLE_EXFAT */
 
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+                /* Find the next cluster through the extent map of the file.  */
+                status =  _fx_file_extent_map_next(file_ptr, cluster_count - 1, cluster, &contents);
+#else
+
                 /* Read the current cluster entry from the FAT.  */
                 status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &contents);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 
                 /* Check the return value.  */
                 if (status != FX_SUCCESS)
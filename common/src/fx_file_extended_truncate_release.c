@@ -65,6 +65,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _fx_directory_entry_write             Write directory entry         */
+/*    _fx_file_extent_map_invalidate        Invalidate file extent maps   */
 /*    _fx_utility_exFAT_bitmap_flush        Flush exFAT allocation bitmap */
 /*    _fx_utility_exFAT_cluster_state_set   Set cluster state             */
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
@@ -76,6 +77,7 @@
 /*    _fx_fault_tolerant_recover            Recover FAT chain             */
 /*    _fx_fault_tolerant_reset_log_file     Reset the log file            */
 /*    _fx_fault_tolerant_set_FAT_chain      Set data of FAT chain         */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -145,6 +147,23 @@ ULONG                  trace_timestamp;
     /* Protect against other threads accessing the media.  */
     FX_PROTECT
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
 #ifdef FX_ENABLE_FAULT_TOLERANT
     /* Start transaction. */
     _fx_fault_tolerant_transaction_start(media_ptr);
@@ -682,6 +701,13 @@ ULONG                  trace_timestamp;
         cluster =  contents;
     }
 
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+    /* The released clusters may still be described by the extent map of this
+       file or of other handles on it, so rebuild them from the FAT.  */
+    _fx_file_extent_map_invalidate(file_ptr);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
     /* Determine if we need to adjust the number of leading consecutive clusters.  */
     if (file_ptr -> fx_file_consecutive_cluster > file_ptr -> fx_file_total_clusters)
     {
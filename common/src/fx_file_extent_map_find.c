@@ -0,0 +1,160 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+#include "fx_file.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_extent_map_find                            PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function finds the physical cluster of a relative cluster of   */
+/*    the file in its extent map with a binary search. If the map does    */
+/*    not reach the relative cluster, the last cluster the map describes  */
+/*    is returned instead, together with its relative cluster. An empty   */
+/*    map is started with the leading consecutive clusters of the file.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*    relative_cluster                      Pointer to the relative       */
+/*                                            cluster, returns the        */
+/*                                            relative cluster found      */
+/*    cluster                               Pointer to return the physical*/
+/*                                            cluster                     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    FX_SUCCESS                            A cluster was found           */
+/*    FX_NOT_FOUND                          The extent map is not         */
+/*                                            available or empty          */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_extended_seek                Seek to specified position    */
+/*    _fx_file_extended_truncate            Truncate a file               */
+/*    _fx_file_extent_map_next              Find the next cluster of a    */
+/*                                            file                        */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_file_extent_map_find(FX_FILE *file_ptr, ULONG *relative_cluster, ULONG *cluster)
+{
+
+FX_FILE_EXTENT *extent_ptr;
+ULONG           low;
+ULONG           high;
+ULONG           middle;
+ULONG           target;
+
+
+    /* Determine if the file has an extent map.  */
+    extent_ptr =  file_ptr -> fx_file_extent_map;
+    if (extent_ptr == FX_NULL)
+    {
+
+        /* No, nothing can be found.  */
+        return(FX_NOT_FOUND);
+    }
+
+    /* Determine if the extent map is empty.  */
+    if (file_ptr -> fx_file_extent_map_count == 0)
+    {
+
+        /* Make sure the file has clusters.  */
+        if ((file_ptr -> fx_file_first_physical_cluster < FX_FAT_ENTRY_START) ||
+            (file_ptr -> fx_file_first_physical_cluster >= file_ptr -> fx_file_media_ptr -> fx_media_fat_reserved))
+        {
+
+            /* No, nothing can be found.  */
+            return(FX_NOT_FOUND);
+        }
+
+        /* Start the map with the leading consecutive clusters of the file.  */
+        extent_ptr -> fx_file_extent_relative_cluster =  0;
+        extent_ptr -> fx_file_extent_physical_cluster =  file_ptr -> fx_file_first_physical_cluster;
+        extent_ptr -> fx_file_extent_clusters =          file_ptr -> fx_file_consecutive_cluster;
+        file_ptr -> fx_file_extent_map_count =           1;
+        file_ptr -> fx_file_extent_map_clusters =        file_ptr -> fx_file_consecutive_cluster;
+    }
+
+    /* Limit the search to the clusters the map describes.  */
+    target =  *relative_cluster;
+    if (target >= file_ptr -> fx_file_extent_map_clusters)
+    {
+        target =  file_ptr -> fx_file_extent_map_clusters - 1;
+    }
+
+    /* Find the last extent that starts at or before the target.  */
+    low =   0;
+    high =  file_ptr -> fx_file_extent_map_count - 1;
+    while (low < high)
+    {
+
+        /* Look at the middle extent, rounded up so the search always moves.  */
+        middle =  (low + high + 1) / 2;
+        if (extent_ptr[middle].fx_file_extent_relative_cluster <= target)
+        {
+            low =  middle;
+        }
+        else
+        {
+            high =  middle - 1;
+        }
+    }
+
+    /* Return the cluster found.  */
+    *relative_cluster =  target;
+    *cluster =  extent_ptr[low].fx_file_extent_physical_cluster +
+        (target - extent_ptr[low].fx_file_extent_relative_cluster);
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
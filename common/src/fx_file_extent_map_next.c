@@ -0,0 +1,187 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+#include "fx_file.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_extent_map_next                            PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the cluster that follows the specified        */
+/*    cluster of the file. If the extent map of the file describes the    */
+/*    next cluster it is returned without reading the FAT. Otherwise the  */
+/*    FAT chain is read from the cluster and, if the map ends with the    */
+/*    specified cluster, the run of consecutive clusters read and the     */
+/*    cluster that follows it are added to the map.                       */
+/*                                                                        */
+/*    The caller checks the cluster returned, just as if it had read the  */
+/*    FAT entry itself.                                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*    relative_cluster                      Relative cluster of the file  */
+/*    cluster                               Physical cluster of the       */
+/*                                            relative cluster            */
+/*    next_cluster                          Pointer to return the next    */
+/*                                            cluster                     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_file_extent_map_find              Find a cluster in the extent  */
+/*                                            map                         */
+/*    _fx_utility_FAT_chain_read            Read a run of the FAT chain   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_extended_seek                Seek to specified position    */
+/*    _fx_file_extended_truncate            Truncate a file               */
+/*    _fx_file_read                         Read from a file              */
+/*    _fx_file_read_ahead                   Read ahead of sequential reads*/
+/*    _fx_file_read_borrow                  Borrow data from the cache    */
+/*    _fx_file_write                        Write to a file               */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_file_extent_map_next(FX_FILE *file_ptr, ULONG relative_cluster, ULONG cluster, ULONG *next_cluster)
+{
+
+FX_FILE_EXTENT *extent_ptr;
+ULONG           found_relative;
+ULONG           found_cluster;
+ULONG           run_clusters;
+ULONG           last_cluster;
+UINT            extend;
+UINT            status;
+
+
+    /* Determine if the extent map describes the next cluster.  */
+    found_relative =  relative_cluster + 1;
+    if ((_fx_file_extent_map_find(file_ptr, &found_relative, &found_cluster) == FX_SUCCESS) &&
+        (found_relative == relative_cluster + 1))
+    {
+
+        /* Yes, return it without reading the FAT.  */
+        *next_cluster =  found_cluster;
+        return(FX_SUCCESS);
+    }
+
+    /* Determine if the clusters read can be added to the extent map, which requires
+       the map to end with the cluster given.  */
+    extend =  (file_ptr -> fx_file_extent_map_count != 0) &&
+              (found_relative == relative_cluster) && (found_cluster == cluster);
+
+    /* Read the run of consecutive clusters that starts with the cluster, or only
+       its FAT entry if the run can't be added to the map.  */
+    status =  _fx_utility_FAT_chain_read(file_ptr -> fx_file_media_ptr, cluster, extend ? 0xFFFFFFFF : 1,
+                                         &run_clusters, next_cluster);
+    if ((status != FX_SUCCESS) || (!extend))
+    {
+
+        /* Return the status of the FAT read.  */
+        return(status);
+    }
+
+    /* Return the cluster that follows the cluster given, and keep the one that
+       follows the run.  */
+    last_cluster =  *next_cluster;
+    if (run_clusters > 1)
+    {
+        *next_cluster =  cluster + 1;
+    }
+
+    /* The consecutive clusters of the run continue the last extent.  */
+    extent_ptr =  &(file_ptr -> fx_file_extent_map[file_ptr -> fx_file_extent_map_count - 1]);
+    extent_ptr -> fx_file_extent_clusters =   extent_ptr -> fx_file_extent_clusters + (run_clusters - 1);
+    file_ptr -> fx_file_extent_map_clusters =  file_ptr -> fx_file_extent_map_clusters + (run_clusters - 1);
+    relative_cluster =  relative_cluster + (run_clusters - 1);
+    cluster =           cluster + (run_clusters - 1);
+
+    /* Determine if the cluster that follows the run can be added to the map.  */
+    if ((last_cluster < FX_FAT_ENTRY_START) ||
+        (last_cluster >= file_ptr -> fx_file_media_ptr -> fx_media_fat_reserved))
+    {
+
+        /* No, the map ends with the run.  */
+        return(FX_SUCCESS);
+    }
+
+    /* Determine if the next cluster continues the last extent.  */
+    if (last_cluster == cluster + 1)
+    {
+
+        /* Yes, make the last extent longer.  */
+        extent_ptr -> fx_file_extent_clusters++;
+    }
+    else if (file_ptr -> fx_file_extent_map_count < file_ptr -> fx_file_extent_map_size)
+    {
+
+        /* Start a new extent with the next cluster.  */
+        extent_ptr++;
+        extent_ptr -> fx_file_extent_relative_cluster =  relative_cluster + 1;
+        extent_ptr -> fx_file_extent_physical_cluster =  last_cluster;
+        extent_ptr -> fx_file_extent_clusters =          1;
+        file_ptr -> fx_file_extent_map_count++;
+    }
+    else
+    {
+
+        /* The extent map is full.  */
+        return(FX_SUCCESS);
+    }
+
+    /* The map describes one more cluster.  */
+    file_ptr -> fx_file_extent_map_clusters++;
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_file.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_extent_map_set                             PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function gives the file an array of extents that remembers     */
+/*    the runs of consecutive clusters of the file. The map is filled as  */
+/*    the cluster chain of the file is followed, and is then used by      */
+/*    seek, read, write and truncate to find clusters without reading     */
+/*    the FAT.                                                            */
+/*                                                                        */
+/*    The memory must hold at least one FX_FILE_EXTENT. A NULL memory     */
+/*    pointer removes the extent map from the file.                       */
+/*                                                                        */
+/*    This service requires FX_ENABLE_FILE_EXTENT_MAP, otherwise          */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*    memory_ptr                            Pointer to memory for the     */
+/*                                            extent map, NULL removes the*/
+/*                                            extent map                  */
+/*    memory_size                           Size of the memory in bytes   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_file_extent_map_set(FX_FILE *file_ptr, VOID *memory_ptr, ULONG memory_size)
+{
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+ULONG       extents;
+ALIGN_TYPE  address;
+FX_MEDIA   *media_ptr;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+
+    /* First, determine if the file is still open.  */
+    if (file_ptr -> fx_file_id != FX_FILE_ID)
+    {
+
+        /* Return the file not open error status.  */
+        return(FX_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_FILE_EXTENT_MAP
+
+    FX_PARAMETER_NOT_USED(memory_ptr);
+    FX_PARAMETER_NOT_USED(memory_size);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Setup pointer to media structure.  */
+    media_ptr =  file_ptr -> fx_file_media_ptr;
+
+    /* The media pointer is only used for protection, which single-thread builds leave out.  */
+    FX_PARAMETER_NOT_USED(media_ptr);
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Assume the extent map is removed.  */
+    extents =  0;
+
+    /* Determine if a new extent map is supplied.  */
+    if (memory_ptr != FX_NULL)
+    {
+
+        /* Align the extent map to a word boundary.  */
+        address =  (ALIGN_TYPE)memory_ptr;
+        address =  (address + (sizeof(ULONG) - 1)) & ~((ALIGN_TYPE)(sizeof(ULONG) - 1));
+
+        /* Calculate the number of extents that fit in the memory.  */
+        if (memory_size > (ULONG)(address - (ALIGN_TYPE)memory_ptr))
+        {
+            extents =  (memory_size - (ULONG)(address - (ALIGN_TYPE)memory_ptr)) / (ULONG)sizeof(FX_FILE_EXTENT);
+        }
+
+        /* Make sure the memory holds at least one extent.  */
+        if (extents == 0)
+        {
+
+            /* Release media protection.  */
+            FX_UNPROTECT
+
+            /* Return the buffer error.  */
+            return(FX_BUFFER_ERROR);
+        }
+
+        /* Use the aligned memory.  */
+        memory_ptr =  (VOID *)address;
+    }
+
+    /* Setup the new extent map, which is empty.  */
+    file_ptr -> fx_file_extent_map =           (FX_FILE_EXTENT *)memory_ptr;
+    file_ptr -> fx_file_extent_map_size =      extents;
+    file_ptr -> fx_file_extent_map_count =     0;
+    file_ptr -> fx_file_extent_map_clusters =  0;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+}
@@ -517,6 +517,31 @@ UCHAR    not_a_file_attr;
     file_ptr -> fx_file_current_file_size =         file_ptr -> fx_file_dir_entry.fx_dir_entry_file_size;
     file_ptr -> fx_file_current_available_size =    bytes_available;
     file_ptr -> fx_file_disable_burst_cache =       FX_FALSE;
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+    file_ptr -> fx_file_read_ahead_max_sectors =    FX_FILE_READ_AHEAD_SECTORS;
+    file_ptr -> fx_file_read_ahead_window =         0;
+    file_ptr -> fx_file_read_ahead_offset =         0;
+    file_ptr -> fx_file_read_ahead_start_sector =   0;
+    file_ptr -> fx_file_read_ahead_end_sector =     0;
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+    file_ptr -> fx_file_write_buffer =              FX_NULL;
+    file_ptr -> fx_file_write_buffer_size =         0;
+    file_ptr -> fx_file_write_buffer_bytes =        0;
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+#ifdef FX_ENABLE_FILE_READ_BORROW
+    file_ptr -> fx_file_borrowed_sector =           FX_NULL;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+    file_ptr -> fx_file_extent_map =                FX_NULL;
+    file_ptr -> fx_file_extent_map_size =           0;
+    file_ptr -> fx_file_extent_map_count =          0;
+    file_ptr -> fx_file_extent_map_clusters =       0;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+    file_ptr -> fx_file_reserved_cluster =          0;
+    file_ptr -> fx_file_reserved_clusters =         0;
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
 
     /* Set the current settings based on how the file was opened.  */
     if (open_type == FX_OPEN_FOR_READ)
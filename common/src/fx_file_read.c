@@ -63,9 +63,14 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_file_extent_map_next              Find the next cluster         */
+/*    _fx_file_read_ahead                   Read ahead sequential reads   */
+/*    _fx_utility_FAT_chain_read            Read a run of the FAT chain   */
 /*    _fx_utility_logical_sector_read       Read a logical sector         */
+/*    _fx_utility_logical_sector_scatter_gather                           */
+/*                                          Read sectors of several runs  */
 /*    _fx_utility_memory_copy               Fast memory copy routine      */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -89,8 +94,20 @@ ULONG                  bytes_remaining, i;
 ULONG                  copy_bytes;
 UCHAR                 *destination_ptr;
 ULONG                  cluster, next_cluster;
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+ULONG                  relative_cluster;
+#else
+ULONG                  run_start = 0;
+ULONG                  run_clusters = 0;
+ULONG                  run_next = 0;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 UINT                   sectors;
 FX_MEDIA              *media_ptr;
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+ULONG                  segments;
+ULONG                  segment_start;
+FX_DRIVER_SEGMENT     *segment_ptr;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
 
 #ifdef TX_ENABLE_EVENT_TRACE
 TX_TRACE_BUFFER_ENTRY *trace_event;
@@ -123,6 +140,23 @@ ULONG                  trace_timestamp;
     /* Protect against other threads accessing the media.  */
     FX_PROTECT
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
     /* Next, determine if there is any more bytes to read in the file.  */
     if (file_ptr -> fx_file_current_file_offset >=
         file_ptr -> fx_file_current_file_size)
@@ -155,6 +189,37 @@ ULONG                  trace_timestamp;
     /* Setup the remaining number of bytes to read.  */
     bytes_remaining =  request_size;
 
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+    /* Determine if this read continues the previous read of the file.  */
+    if ((file_ptr -> fx_file_current_file_offset == file_ptr -> fx_file_read_ahead_offset) &&
+        (file_ptr -> fx_file_read_ahead_max_sectors))
+    {
+
+        /* Yes, open the read-ahead window or double its size.  */
+        if (file_ptr -> fx_file_read_ahead_window == 0)
+        {
+            file_ptr -> fx_file_read_ahead_window =  2;
+        }
+        else if (file_ptr -> fx_file_read_ahead_window < file_ptr -> fx_file_read_ahead_max_sectors)
+        {
+            file_ptr -> fx_file_read_ahead_window =  file_ptr -> fx_file_read_ahead_window << 1;
+        }
+
+        /* Limit the window to the maximum of the file.  */
+        if (file_ptr -> fx_file_read_ahead_window > file_ptr -> fx_file_read_ahead_max_sectors)
+        {
+            file_ptr -> fx_file_read_ahead_window =  file_ptr -> fx_file_read_ahead_max_sectors;
+        }
+    }
+    else
+    {
+
+        /* No, close the read-ahead window.  */
+        file_ptr -> fx_file_read_ahead_window =  0;
+    }
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+
     /* Loop to read all of the bytes.  */
     while (bytes_remaining)
     {
@@ -166,6 +231,15 @@ ULONG                  trace_timestamp;
 
             /* A partial sector read is required.  */
 
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+            /* Read the following sectors of a sequential read into the cache.  */
+            if (file_ptr -> fx_file_read_ahead_window)
+            {
+                _fx_file_read_ahead(file_ptr);
+            }
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+
             /* Read the current logical sector.  */
             status =  _fx_utility_logical_sector_read(media_ptr,
                                                       file_ptr -> fx_file_current_logical_sector,
@@ -222,6 +296,20 @@ ULONG                  trace_timestamp;
 
 
             next_cluster = cluster = file_ptr -> fx_file_current_physical_cluster;
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+            relative_cluster =  file_ptr -> fx_file_current_relative_cluster;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+            /* The first segment starts at the current logical sector.  */
+            segments =       1;
+            segment_start =  0;
+            segment_ptr =    media_ptr -> fx_media_driver_segment_list;
+            segment_ptr -> fx_driver_segment_logical_sector =  file_ptr -> fx_file_current_logical_sector;
+            segment_ptr -> fx_driver_segment_buffer =          destination_ptr;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
+
             for (i = (media_ptr -> fx_media_sectors_per_cluster -
                       file_ptr -> fx_file_current_relative_sector); i < sectors; i += media_ptr -> fx_media_sectors_per_cluster)
             {
@@ -233,7 +321,27 @@ ULONG                  trace_timestamp;
                 else
                 {
 #endif /* FX_ENABLE_EXFAT */
-                    status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &next_cluster);
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+                    /* Find the next cluster through the extent map of the file.  */
+                    status =  _fx_file_extent_map_next(file_ptr, relative_cluster, cluster, &next_cluster);
+                    relative_cluster++;
+#else
+
+                    /* Read the FAT chain from this cluster if it is past the
+                       run of consecutive clusters read last.  */
+                    status =  FX_SUCCESS;
+                    if ((cluster - run_start) >= run_clusters)
+                    {
+                        run_start =  cluster;
+                        status =  _fx_utility_FAT_chain_read(media_ptr, cluster,
+                                                             ((sectors - i) / media_ptr -> fx_media_sectors_per_cluster) + 1,
+                                                             &run_clusters, &run_next);
+                    }
+
+                    /* Pickup the next cluster from the run.  */
+                    next_cluster =  ((cluster - run_start) < (run_clusters - 1)) ? (cluster + 1) : run_next;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 
                     /* Determine if an error is present.  */
                     if ((status != FX_SUCCESS) || (next_cluster < FX_FAT_ENTRY_START) ||
@@ -256,6 +364,26 @@ ULONG                  trace_timestamp;
 
                     if (next_cluster != cluster + 1)
                     {
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+                        /* Determine if the read can continue in another segment.  */
+                        if ((media_ptr -> fx_media_driver_scatter_gather_supported) &&
+                            (segments < FX_SCATTER_GATHER_SEGMENTS))
+                        {
+
+                            /* Yes, end the current segment and start the next one at the
+                               first sector of the next cluster.  */
+                            segment_ptr -> fx_driver_segment_sectors =  i - segment_start;
+                            segment_ptr++;
+                            segments++;
+                            segment_start =  i;
+                            segment_ptr -> fx_driver_segment_logical_sector =  media_ptr -> fx_media_data_sector_start +
+                                (((ULONG64)next_cluster - FX_FAT_ENTRY_START) * media_ptr -> fx_media_sectors_per_cluster);
+                            segment_ptr -> fx_driver_segment_buffer =  destination_ptr + (i * media_ptr -> fx_media_bytes_per_sector);
+                            cluster =  next_cluster;
+                            continue;
+                        }
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
                         break;
                     }
                     else
@@ -272,11 +400,26 @@ ULONG                  trace_timestamp;
                 sectors = i;
             }
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+            /* The last segment ends with the last sector to read.  */
+            segment_ptr -> fx_driver_segment_sectors =  sectors - segment_start;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
+
             /* Determine if this is a single sector read request.  If so, read the sector so it will
                come from the internal cache.  */
             if (sectors == 1)
             {
 
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+                /* Read the following sectors of a sequential read into the cache.  */
+                if (file_ptr -> fx_file_read_ahead_window)
+                {
+                    _fx_file_read_ahead(file_ptr);
+                }
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+
                 /* Read the current logical sector.  */
                 status =  _fx_utility_logical_sector_read(media_ptr,
                                                           file_ptr -> fx_file_current_logical_sector,
@@ -304,6 +447,17 @@ ULONG                  trace_timestamp;
                 /* Perform the data read directly into the user's buffer of
                    the appropriate number of sectors.  */
                 media_ptr -> fx_media_disable_burst_cache = file_ptr -> fx_file_disable_burst_cache;
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+                /* Determine if the sectors are in more than one run.  */
+                if (segments > 1)
+                {
+
+                    /* Yes, read all runs with one scatter-gather request.  */
+                    status =  _fx_utility_logical_sector_scatter_gather(media_ptr, FX_DRIVER_READ, segments, FX_DATA_SECTOR);
+                }
+                else
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
                 status =  _fx_utility_logical_sector_read(media_ptr, file_ptr -> fx_file_current_logical_sector,
                                                           destination_ptr, (ULONG) sectors, FX_DATA_SECTOR);
                 media_ptr -> fx_media_disable_burst_cache = FX_FALSE;
@@ -325,9 +479,15 @@ ULONG                  trace_timestamp;
             /* Increment the current logical sector.  Subtract one from
                the sector count because we are going to use the logical
                offset to do additional sector/cluster arithmetic below.  */
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+            file_ptr -> fx_file_current_logical_sector =
+                segment_ptr -> fx_driver_segment_logical_sector +
+                (segment_ptr -> fx_driver_segment_sectors - 1);
+#else
             file_ptr -> fx_file_current_logical_sector =
                 file_ptr -> fx_file_current_logical_sector +
                 (sectors - 1);
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
 
             /* Move the relative sector and cluster as well.  */
             file_ptr -> fx_file_current_relative_cluster = file_ptr -> fx_file_current_relative_cluster +
@@ -391,10 +551,28 @@ ULONG                  trace_timestamp;
                 {
 #endif /* FX_ENABLE_EXFAT */
 
-                    /* Read the FAT entry of the current cluster to find
-                       the next cluster.  */
-                    status =  _fx_utility_FAT_entry_read(media_ptr,
-                                                         file_ptr -> fx_file_current_physical_cluster, &next_cluster);
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+                    /* Find the next cluster through the extent map of the file.  */
+                    status =  _fx_file_extent_map_next(file_ptr, file_ptr -> fx_file_current_relative_cluster,
+                                                       file_ptr -> fx_file_current_physical_cluster, &next_cluster);
+#else
+                    /* Read the FAT chain from the current cluster if it is past
+                       the run of consecutive clusters read last.  */
+                    status =  FX_SUCCESS;
+                    if ((file_ptr -> fx_file_current_physical_cluster - run_start) >= run_clusters)
+                    {
+                        run_start =  file_ptr -> fx_file_current_physical_cluster;
+                        status =  _fx_utility_FAT_chain_read(media_ptr, run_start,
+                                                             ((bytes_remaining / media_ptr -> fx_media_bytes_per_sector) /
+                                                              media_ptr -> fx_media_sectors_per_cluster) + 1,
+                                                             &run_clusters, &run_next);
+                    }
+
+                    /* Pickup the next cluster from the run.  */
+                    next_cluster =  ((file_ptr -> fx_file_current_physical_cluster - run_start) < (run_clusters - 1)) ?
+                        (file_ptr -> fx_file_current_physical_cluster + 1) : run_next;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 
                     /* Determine if an error is present.  */
                     if ((status != FX_SUCCESS) || (next_cluster < FX_FAT_ENTRY_START) ||
@@ -445,6 +623,12 @@ ULONG                  trace_timestamp;
     file_ptr -> fx_file_current_file_offset =
         file_ptr -> fx_file_current_file_offset + (ULONG64)request_size;
 
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+    /* Remember where the next sequential read of the file starts.  */
+    file_ptr -> fx_file_read_ahead_offset =  file_ptr -> fx_file_current_file_offset;
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+
     /* Store the number of bytes actually read.  */
     *actual_size =  request_size;
 
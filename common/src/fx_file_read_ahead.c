@@ -0,0 +1,226 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+#include "fx_system.h"
+#include "fx_file.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_read_ahead                                 PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reads the sectors that follow the current position    */
+/*    of a file that is read sequentially into the logical sector cache.  */
+/*    The read-ahead starts at the current logical sector and covers the  */
+/*    rest of the current cluster and the following clusters of the       */
+/*    file, as long as they are contiguous on the media, up to the read-  */
+/*    ahead window of the file. All these sectors are read with a single  */
+/*    driver request.                                                     */
+/*                                                                        */
+/*    Nothing is done if the current sector was already read ahead.       */
+/*    Errors are ignored, since fx_file_read reads the sectors it needs   */
+/*    again.                                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_file_extent_map_next              Find the next cluster         */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_utility_logical_sector_read       Read sectors into the cache   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_read                         File read                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_file_read_ahead(FX_FILE *file_ptr)
+{
+
+UINT      status;
+FX_MEDIA *media_ptr;
+ULONG64   logical_sector;
+ULONG     sectors;
+ULONG     max_sectors;
+ULONG     clusters;
+ULONG     cluster, next_cluster;
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+ULONG     relative_cluster;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+
+    /* Setup pointer to associated media control block.  */
+    media_ptr =  file_ptr -> fx_file_media_ptr;
+
+    /* Pickup the sector the read continues with.  */
+    logical_sector =  file_ptr -> fx_file_current_logical_sector;
+
+    /* Determine if this sector was read ahead already.  */
+    if ((logical_sector >= file_ptr -> fx_file_read_ahead_start_sector) &&
+        (logical_sector < file_ptr -> fx_file_read_ahead_end_sector))
+    {
+
+        /* Yes, nothing to do.  */
+        return;
+    }
+
+    /* Limit the read-ahead to the window of the file, to the read-ahead buffer and to
+       the number of sectors a direct read places into the logical sector cache.  */
+    max_sectors =  file_ptr -> fx_file_read_ahead_window;
+    if (max_sectors > (((ULONG)sizeof(media_ptr -> fx_media_read_ahead_buffer)) / media_ptr -> fx_media_bytes_per_sector))
+    {
+        max_sectors =  ((ULONG)sizeof(media_ptr -> fx_media_read_ahead_buffer)) / media_ptr -> fx_media_bytes_per_sector;
+    }
+    if (max_sectors >= (media_ptr -> fx_media_sector_cache_size / 4))
+    {
+        max_sectors =  media_ptr -> fx_media_sector_cache_size / 4;
+        if (max_sectors)
+        {
+            max_sectors--;
+        }
+    }
+
+    /* Start with the rest of the current cluster.  */
+    sectors =  media_ptr -> fx_media_sectors_per_cluster - file_ptr -> fx_file_current_relative_sector;
+
+    /* Calculate the number of clusters of the file that follow the current cluster.  */
+    clusters =  0;
+    if (file_ptr -> fx_file_total_clusters > (file_ptr -> fx_file_current_relative_cluster + 1))
+    {
+        clusters =  file_ptr -> fx_file_total_clusters - (file_ptr -> fx_file_current_relative_cluster + 1);
+    }
+
+    /* Add the following clusters as long as they are contiguous.  */
+    cluster =  file_ptr -> fx_file_current_physical_cluster;
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+    relative_cluster =  file_ptr -> fx_file_current_relative_cluster;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+    while ((sectors < max_sectors) && (clusters))
+    {
+#ifdef FX_ENABLE_EXFAT
+        if (file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1)
+        {
+
+            /* The clusters of the file are contiguous.  */
+            next_cluster =  cluster + 1;
+        }
+        else
+        {
+#endif /* FX_ENABLE_EXFAT */
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+            /* Find the next cluster through the extent map of the file.  */
+            status =  _fx_file_extent_map_next(file_ptr, relative_cluster, cluster, &next_cluster);
+#else
+
+            /* Read the FAT entry of the cluster to find the next cluster.  */
+            status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &next_cluster);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+            /* Determine if an error is present.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Give up on the read-ahead.  */
+                return;
+            }
+#ifdef FX_ENABLE_EXFAT
+        }
+#endif /* FX_ENABLE_EXFAT */
+
+        /* Determine if the next cluster is contiguous.  */
+        if (next_cluster != (cluster + 1))
+        {
+            break;
+        }
+
+        /* Add the sectors of the next cluster.  */
+        cluster =  next_cluster;
+        clusters--;
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+        relative_cluster++;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+        sectors =  sectors + media_ptr -> fx_media_sectors_per_cluster;
+    }
+
+    /* Limit the read-ahead to the window.  */
+    if (sectors > max_sectors)
+    {
+        sectors =  max_sectors;
+    }
+
+    /* A single sector is simply read through the cache by the caller.  */
+    if (sectors < 2)
+    {
+        return;
+    }
+
+    /* Read the sectors through the read-ahead buffer, which places them into the
+       logical sector cache.  Sectors already in the cache at the beginning or at the
+       end of the range are not read again.  */
+    media_ptr -> fx_media_disable_burst_cache =  file_ptr -> fx_file_disable_burst_cache;
+    status =  _fx_utility_logical_sector_read(media_ptr, logical_sector,
+                                              media_ptr -> fx_media_read_ahead_buffer, sectors, FX_DATA_SECTOR);
+    media_ptr -> fx_media_disable_burst_cache =  FX_FALSE;
+
+    /* Determine if the read was successful.  */
+    if (status == FX_SUCCESS)
+    {
+
+        /* Remember the sectors read ahead.  */
+        file_ptr -> fx_file_read_ahead_start_sector =  logical_sector;
+        file_ptr -> fx_file_read_ahead_end_sector =    logical_sector + sectors;
+    }
+}
+
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
@@ -0,0 +1,387 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_file.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_read_borrow                                PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns a pointer to the file data at the current     */
+/*    offset inside the logical sector cache instead of copying it into   */
+/*    a buffer of the caller. The data ends at the end of the current     */
+/*    sector or at the end of the file, whichever comes first, and the    */
+/*    file offset is advanced past it.                                    */
+/*                                                                        */
+/*    The cache entry that holds the sector is pinned, so it is not       */
+/*    replaced until the file calls fx_file_read_release, borrows again   */
+/*    or is closed. Any sector the file borrowed before is released       */
+/*    first. At most half of the cache entries available to data sectors  */
+/*    can be pinned at the same time, otherwise FX_NOT_AVAILABLE is       */
+/*    returned.                                                           */
+/*                                                                        */
+/*    This service requires FX_ENABLE_FILE_READ_BORROW, otherwise         */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*    data_ptr                              Pointer to the destination for*/
+/*                                            the pointer to the data     */
+/*    data_size                             Pointer to the destination for*/
+/*                                            the number of bytes of data */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_file_extent_map_next              Find the next cluster         */
+/*    _fx_file_read_ahead                   Read ahead sequential reads   */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_utility_logical_sector_cache_lookup                             */
+/*                                          Lookup logical sector in the  */
+/*                                            cache hash table            */
+/*    _fx_utility_logical_sector_read       Read a logical sector         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_file_read_borrow(FX_FILE *file_ptr, UCHAR **data_ptr, ULONG *data_size)
+{
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+UINT              status;
+ULONG             bytes;
+ULONG             next_cluster;
+FX_MEDIA         *media_ptr;
+FX_CACHED_SECTOR *cache_entry;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+
+    /* First, determine if the file is still open.  */
+    if (file_ptr -> fx_file_id != FX_FILE_ID)
+    {
+
+        /* Return the file not open error status.  */
+        return(FX_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_FILE_READ_BORROW
+
+    FX_PARAMETER_NOT_USED(data_ptr);
+    FX_PARAMETER_NOT_USED(data_size);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Setup pointer to associated media control block.  */
+    media_ptr =  file_ptr -> fx_file_media_ptr;
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+    /* Increment the number of times a file is read.  */
+    media_ptr -> fx_media_file_reads++;
+#endif
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Write the data gathered in the write buffer of the file first.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
+    /* Determine if the file still holds a borrowed sector.  */
+    cache_entry =  file_ptr -> fx_file_borrowed_sector;
+    if (cache_entry)
+    {
+
+        /* Yes, unpin its cache entry.  */
+        cache_entry -> fx_cached_sector_pin_count--;
+        if (cache_entry -> fx_cached_sector_pin_count == 0)
+        {
+            media_ptr -> fx_media_sector_cache_pinned_count--;
+        }
+        file_ptr -> fx_file_borrowed_sector =  FX_NULL;
+    }
+
+    /* Next, determine if there is any more bytes to read in the file.  */
+    if (file_ptr -> fx_file_current_file_offset >=
+        file_ptr -> fx_file_current_file_size)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* The file is at the end, return the proper status and no data.  */
+        *data_ptr =   FX_NULL;
+        *data_size =  0;
+        return(FX_END_OF_FILE);
+    }
+
+    /* Determine if all bytes of the current logical sector have been read.  */
+    if (file_ptr -> fx_file_current_logical_offset >= media_ptr -> fx_media_bytes_per_sector)
+    {
+
+        /* Yes, move to the next logical sector.  Increment the current relative
+           sector in the cluster.  */
+        file_ptr -> fx_file_current_relative_sector++;
+
+        /* Determine if this is in a new cluster.  */
+        if (file_ptr -> fx_file_current_relative_sector >=
+            media_ptr -> fx_media_sectors_per_cluster)
+        {
+#ifdef FX_ENABLE_EXFAT
+            if (file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1)
+            {
+                next_cluster = file_ptr -> fx_file_current_physical_cluster + 1;
+            }
+            else
+            {
+#endif /* FX_ENABLE_EXFAT */
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+                /* Find the next cluster through the extent map of the file.  */
+                status =  _fx_file_extent_map_next(file_ptr, file_ptr -> fx_file_current_relative_cluster,
+                                                   file_ptr -> fx_file_current_physical_cluster, &next_cluster);
+#else
+
+                /* Read the FAT entry of the current cluster to find
+                   the next cluster.  */
+                status =  _fx_utility_FAT_entry_read(media_ptr,
+                                                     file_ptr -> fx_file_current_physical_cluster, &next_cluster);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+                /* Determine if an error is present.  */
+                if ((status != FX_SUCCESS) || (next_cluster < FX_FAT_ENTRY_START) ||
+                    (next_cluster > media_ptr -> fx_media_fat_reserved))
+                {
+
+                    /* Restore the relative sector.  */
+                    file_ptr -> fx_file_current_relative_sector--;
+
+                    /* Release media protection.  */
+                    FX_UNPROTECT
+
+                    /* Send error message back to caller.  */
+                    if (status != FX_SUCCESS)
+                    {
+                        return(status);
+                    }
+                    else
+                    {
+                        return(FX_FILE_CORRUPT);
+                    }
+                }
+#ifdef FX_ENABLE_EXFAT
+            }
+#endif /* FX_ENABLE_EXFAT */
+
+            /* Otherwise, we have a new cluster.  Save it in the file
+               control block and calculate a new logical sector value.  */
+            file_ptr -> fx_file_current_physical_cluster =  next_cluster;
+            file_ptr -> fx_file_current_relative_cluster++;
+            file_ptr -> fx_file_current_logical_sector = ((ULONG)media_ptr -> fx_media_data_sector_start) +
+                ((((ULONG64)next_cluster) - FX_FAT_ENTRY_START) *
+                 ((ULONG)media_ptr -> fx_media_sectors_per_cluster));
+            file_ptr -> fx_file_current_relative_sector =  0;
+        }
+        else
+        {
+
+            /* Still within the same cluster so just increment the
+               logical sector.  */
+            file_ptr -> fx_file_current_logical_sector++;
+        }
+
+        /* In either case, we are now positioned at a new sector so
+           clear the logical sector offset.  */
+        file_ptr -> fx_file_current_logical_offset =  0;
+    }
+
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+    /* Determine if this read continues the previous read of the file.  */
+    if ((file_ptr -> fx_file_current_file_offset == file_ptr -> fx_file_read_ahead_offset) &&
+        (file_ptr -> fx_file_read_ahead_max_sectors))
+    {
+
+        /* Yes, open the read-ahead window or double its size.  */
+        if (file_ptr -> fx_file_read_ahead_window == 0)
+        {
+            file_ptr -> fx_file_read_ahead_window =  2;
+        }
+        else if (file_ptr -> fx_file_read_ahead_window < file_ptr -> fx_file_read_ahead_max_sectors)
+        {
+            file_ptr -> fx_file_read_ahead_window =  file_ptr -> fx_file_read_ahead_window << 1;
+        }
+
+        /* Limit the window to the maximum of the file.  */
+        if (file_ptr -> fx_file_read_ahead_window > file_ptr -> fx_file_read_ahead_max_sectors)
+        {
+            file_ptr -> fx_file_read_ahead_window =  file_ptr -> fx_file_read_ahead_max_sectors;
+        }
+
+        /* Read the following sectors of a sequential read into the cache.  */
+        _fx_file_read_ahead(file_ptr);
+    }
+    else
+    {
+
+        /* No, close the read-ahead window.  */
+        file_ptr -> fx_file_read_ahead_window =  0;
+    }
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+
+    /* Read the current logical sector into the logical sector cache.  */
+    status =  _fx_utility_logical_sector_read(media_ptr,
+                                              file_ptr -> fx_file_current_logical_sector,
+                                              media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_DATA_SECTOR);
+
+    /* Check for good completion status.  */
+    if (status !=  FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+    /* Pickup the cache entry that holds the sector.  */
+    cache_entry =  _fx_utility_logical_sector_cache_lookup(media_ptr, file_ptr -> fx_file_current_logical_sector);
+
+    /* Determine if the entry is pinned by another file already.  */
+    if ((cache_entry) && (cache_entry -> fx_cached_sector_pin_count == 0))
+    {
+
+        /* No, make sure enough entries remain for the data sectors that are
+           read while the entry is pinned.  */
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+        if (media_ptr -> fx_media_sector_cache_pinned_count >=
+            (media_ptr -> fx_media_sector_cache_partition_size[FX_SECTOR_CACHE_PARTITION_DATA] / 2))
+#else
+        if (media_ptr -> fx_media_sector_cache_pinned_count >=
+            (media_ptr -> fx_media_sector_cache_size / 2))
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+        {
+            cache_entry =  FX_NULL;
+        }
+        else
+        {
+
+            /* Increment the number of pinned cache entries.  */
+            media_ptr -> fx_media_sector_cache_pinned_count++;
+        }
+    }
+
+    /* Determine if the sector can be borrowed.  */
+    if (cache_entry == FX_NULL)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the not available error.  */
+        return(FX_NOT_AVAILABLE);
+    }
+
+    /* Pin the cache entry for this file.  */
+    cache_entry -> fx_cached_sector_pin_count++;
+    file_ptr -> fx_file_borrowed_sector =  cache_entry;
+
+    /* Calculate the number of bytes up to the end of the sector or of the file.  */
+    bytes =  media_ptr -> fx_media_bytes_per_sector - file_ptr -> fx_file_current_logical_offset;
+    if ((ULONG64)bytes > (file_ptr -> fx_file_current_file_size - file_ptr -> fx_file_current_file_offset))
+    {
+        bytes =  (ULONG)(file_ptr -> fx_file_current_file_size - file_ptr -> fx_file_current_file_offset);
+    }
+
+    /* Return the data to the caller.  */
+    *data_ptr =   cache_entry -> fx_cached_sector_memory_buffer + file_ptr -> fx_file_current_logical_offset;
+    *data_size =  bytes;
+
+    /* Advance the logical sector byte offset and the file offset past the data.
+       The next read moves to the following sector when the end of this sector
+       has been reached.  */
+    file_ptr -> fx_file_current_logical_offset =  file_ptr -> fx_file_current_logical_offset + bytes;
+    file_ptr -> fx_file_current_file_offset =     file_ptr -> fx_file_current_file_offset + (ULONG64)bytes;
+
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+
+    /* Remember where the next sequential read of the file starts.  */
+    file_ptr -> fx_file_read_ahead_offset =  file_ptr -> fx_file_current_file_offset;
+#endif /* FX_ENABLE_FILE_READ_AHEAD */
+
+    /* Update the last accessed date.  */
+    file_ptr -> fx_file_dir_entry.fx_dir_entry_last_accessed_date =  _fx_system_date;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return a successful status to the caller.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+}
@@ -0,0 +1,125 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_file.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_read_release                               PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function releases the sector the file borrowed with            */
+/*    fx_file_read_borrow. The pointer returned by fx_file_read_borrow    */
+/*    must not be used afterwards. Nothing is done if the file does not   */
+/*    hold a borrowed sector.                                             */
+/*                                                                        */
+/*    This service requires FX_ENABLE_FILE_READ_BORROW, otherwise         */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_file_read_release(FX_FILE *file_ptr)
+{
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+FX_MEDIA         *media_ptr;
+FX_CACHED_SECTOR *cache_entry;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+
+    /* First, determine if the file is still open.  */
+    if (file_ptr -> fx_file_id != FX_FILE_ID)
+    {
+
+        /* Return the file not open error status.  */
+        return(FX_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_FILE_READ_BORROW
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Setup pointer to associated media control block.  */
+    media_ptr =  file_ptr -> fx_file_media_ptr;
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Determine if the file holds a borrowed sector.  */
+    cache_entry =  file_ptr -> fx_file_borrowed_sector;
+    if (cache_entry)
+    {
+
+        /* Yes, unpin its cache entry.  */
+        cache_entry -> fx_cached_sector_pin_count--;
+        if (cache_entry -> fx_cached_sector_pin_count == 0)
+        {
+            media_ptr -> fx_media_sector_cache_pinned_count--;
+        }
+        file_ptr -> fx_file_borrowed_sector =  FX_NULL;
+    }
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+}
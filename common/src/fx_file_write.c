@@ -64,17 +64,28 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    _fx_directory_entry_write             Update the file's size        */
+/*    _fx_file_extent_map_invalidate        Invalidate file extent maps   */
+/*    _fx_file_extent_map_next              Find the next cluster         */
 /*    _fx_utility_exFAT_bitmap_flush        Flush exFAT allocation bitmap */
 /*    _fx_utility_exFAT_bitmap_free_cluster_find                          */
 /*                                          Find exFAT free cluster       */
 /*    _fx_utility_exFAT_cluster_state_get   Get cluster state             */
 /*    _fx_utility_exFAT_cluster_state_set   Set cluster state             */
+/*    _fx_utility_exFAT_reserved_cluster_get                              */
+/*                                          Get a reserved cluster        */
+/*    _fx_utility_FAT_bitmap_free_cluster_find                            */
+/*                                          Find free cluster in bitmap   */
+/*    _fx_utility_FAT_chain_write           Link a run of clusters        */
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
 /*    _fx_utility_FAT_entry_write           Write a FAT entry             */
 /*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*    _fx_utility_FAT_free_cluster_count    Count the free clusters       */
+/*    _fx_utility_FAT_free_run_find         Find a run of free clusters   */
 /*    _fx_utility_logical_sector_flush      Flush written logical sectors */
 /*    _fx_utility_logical_sector_read       Read a logical sector         */
 /*    _fx_utility_logical_sector_write      Write a logical sector        */
+/*    _fx_utility_logical_sector_scatter_gather                           */
+/*                                          Write sectors of several runs */
 /*    _fx_utility_memory_copy               Fast memory copy routine      */
 /*    _fx_fault_tolerant_transaction_start  Start fault tolerant          */
 /*                                            transaction                 */
@@ -82,6 +93,7 @@
 /*    _fx_fault_tolerant_recover            Recover FAT chain             */
 /*    _fx_fault_tolerant_reset_log_file     Reset the log file            */
 /*    _fx_fault_tolerant_set_FAT_chain      Set data of FAT chain         */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -108,17 +120,29 @@ ULONG                  bytes_per_cluster;
 UCHAR                 *source_ptr;
 ULONG                  first_new_cluster;
 ULONG                  last_cluster;
+ULONG                  run_start;
 ULONG                  cluster, next_cluster;
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+ULONG                  kept_bytes;
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+ULONG                  relative_cluster;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 ULONG                  FAT_index;
 ULONG                  FAT_value;
 ULONG                  clusters;
 ULONG                  total_clusters;
 UINT                   sectors;
 FX_MEDIA              *media_ptr;
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+ULONG                  segments;
+ULONG                  segment_start;
+FX_DRIVER_SEGMENT     *segment_ptr;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
 
-#ifdef FX_ENABLE_EXFAT
+#if defined(FX_ENABLE_EXFAT) && !defined(FX_ENABLE_EXFAT_CLUSTER_RESERVATION)
 UCHAR                  cluster_state;
-#endif /* FX_ENABLE_EXFAT */
+#endif /* FX_ENABLE_EXFAT && !FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
 
 #ifdef FX_FAULT_TOLERANT_DATA
 FX_INT_SAVE_AREA
@@ -212,6 +236,89 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
         return(FX_ACCESS_ERROR);
     }
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Determine if the file has a write buffer.  */
+    if (file_ptr -> fx_file_write_buffer)
+    {
+
+        /* Determine if the data is appended to the file and is not larger than the
+           write buffer, unless the buffer already holds data.  */
+        if ((file_ptr -> fx_file_current_file_offset == file_ptr -> fx_file_current_file_size) &&
+            ((file_ptr -> fx_file_write_buffer_bytes) || (size < file_ptr -> fx_file_write_buffer_size)))
+        {
+
+            /* Calculate the free space of the write buffer and the bytes kept in it after the
+               complete sectors of the full buffer are written.  */
+            copy_bytes =  file_ptr -> fx_file_write_buffer_size - file_ptr -> fx_file_write_buffer_bytes;
+            kept_bytes =  (ULONG)((file_ptr -> fx_file_current_file_offset + file_ptr -> fx_file_write_buffer_size) %
+                                  media_ptr -> fx_media_bytes_per_sector);
+            if (kept_bytes >= file_ptr -> fx_file_write_buffer_size)
+            {
+                kept_bytes =  0;
+            }
+
+            /* Determine if the data does not fit into the write buffer, but the rest of it fits
+               once the full buffer is written. The buffer is written at most once, so if this
+               fails, the data of this write taken into the buffer is discarded with the rest of
+               the buffer and none of the data of this write is stored.  */
+            if ((size > copy_bytes) &&
+                ((size - copy_bytes) <= (file_ptr -> fx_file_write_buffer_size - kept_bytes)))
+            {
+
+                /* Yes, fill the write buffer.  */
+                _fx_utility_memory_copy((UCHAR *)buffer_ptr, file_ptr -> fx_file_write_buffer + file_ptr -> fx_file_write_buffer_bytes, copy_bytes); /* Use case of memcpy is verified. */
+                file_ptr -> fx_file_write_buffer_bytes =  file_ptr -> fx_file_write_buffer_size;
+                buffer_ptr =  (UCHAR *)buffer_ptr + copy_bytes;
+                size =        size - copy_bytes;
+
+                /* Write the complete sectors of the buffer to the file and keep the rest.  */
+                status =  _fx_file_write_buffer_flush(file_ptr, FX_FALSE);
+
+                /* Determine if the write was successful.  */
+                if (status != FX_SUCCESS)
+                {
+
+                    /* Release media protection.  */
+                    FX_UNPROTECT
+
+                    /* Return the error status.  */
+                    return(status);
+                }
+            }
+
+            /* Determine if the data fits into the write buffer.  */
+            if (size <= file_ptr -> fx_file_write_buffer_size - file_ptr -> fx_file_write_buffer_bytes)
+            {
+
+                /* Yes, gather the data in the write buffer.  */
+                _fx_utility_memory_copy((UCHAR *)buffer_ptr, file_ptr -> fx_file_write_buffer + file_ptr -> fx_file_write_buffer_bytes, size); /* Use case of memcpy is verified. */
+                file_ptr -> fx_file_write_buffer_bytes =  file_ptr -> fx_file_write_buffer_bytes + size;
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+
+                /* Return successful status.  */
+                return(FX_SUCCESS);
+            }
+        }
+
+        /* Otherwise, write the data gathered in the write buffer before this data.  */
+        status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+        /* Determine if the write was successful.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Release media protection.  */
+            FX_UNPROTECT
+
+            /* Return the error status.  */
+            return(status);
+        }
+    }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
 #ifdef FX_ENABLE_FAULT_TOLERANT
 
     /* Start transaction. */
@@ -508,6 +615,27 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
         }
 #endif /* FX_ENABLE_FAULT_TOLERANT */
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+        /* Make sure the free clusters of the media have been counted.  */
+        status =  _fx_utility_FAT_free_cluster_count(media_ptr);
+
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+            FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+            /* Release media protection.  */
+            FX_UNPROTECT
+
+            /* Return the bad status.  */
+            return(status);
+        }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+
         /* Determine if we have enough space left.  */
 #ifdef FX_ENABLE_FAULT_TOLERANT
         if (clusters + replace_clusters > media_ptr -> fx_media_available_clusters)
@@ -588,26 +716,9 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
                 file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat &= (CHAR)0xfe; /* Clear bit 0.  */
 
                 /* Build FAT chain.  */
-                for (i = file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster; i < file_ptr -> fx_file_last_physical_cluster; ++i)
-                {
-
-                    status = _fx_utility_FAT_entry_write(media_ptr, i, i + 1);
-
-                    if (status != FX_SUCCESS)
-                    {
-
-                        FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
-
-                        /* Release media protection.  */
-                        FX_UNPROTECT
-
-                        /* Return the bad status.  */
-                        return(status);
-                    }
-                }
-
-                /* Write the last cluster FAT entry.  */
-                status = _fx_utility_FAT_entry_write(media_ptr, i, FX_LAST_CLUSTER_exFAT);
+                status = _fx_utility_FAT_chain_write(media_ptr, file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster,
+                                                     file_ptr -> fx_file_last_physical_cluster - file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster + 1,
+                                                     FX_LAST_CLUSTER_exFAT);
                 if (status != FX_SUCCESS)
                 {
 
@@ -628,8 +739,56 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
             last_cluster =   file_ptr -> fx_file_last_physical_cluster;
         }
 
+#ifdef FX_ENABLE_FILE_DELAYED_ALLOCATION
+
+        /* Determine if the media is FAT12/16/32.  */
+#ifdef FX_ENABLE_EXFAT
+        if (media_ptr -> fx_media_FAT_type != FX_exFAT)
+#endif /* FX_ENABLE_EXFAT */
+        {
+
+            /* Find a run of free clusters for all the clusters needed, after the last cluster of
+               the file if possible, and start the search there. Only the FAT entries near the
+               search start are searched, so a write is not slowed down by reading the whole FAT
+               when no run is long enough.  */
+            status =  _fx_utility_FAT_free_run_find(media_ptr, last_cluster, clusters,
+                                                    FX_FILE_DELAYED_ALLOCATION_SEARCH_CLUSTERS, &FAT_index);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+                FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Determine if a run was found.  */
+            if (FAT_index)
+            {
+
+                /* Yes, the clusters are taken from it.  */
+                media_ptr -> fx_media_cluster_search_start =  FAT_index;
+            }
+        }
+#endif /* FX_ENABLE_FILE_DELAYED_ALLOCATION */
+
         FAT_index    =       media_ptr -> fx_media_cluster_search_start;
 
+        /* No new cluster links are pending yet.  Clusters of a pending run still
+           read as free in the FAT until the run is written.  Each search moves
+           forward from the cluster after the last one taken, so it only comes
+           back to the pending run after it wrapped around all other clusters,
+           which happens when the available cluster count is too high.  The
+           searches below treat the pending run as used.  */
+        run_start =  0;
+
         /* Loop to find the needed clusters.  */
         while (clusters)
         {
@@ -640,6 +799,33 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
             if (media_ptr -> fx_media_FAT_type == FX_exFAT)
             {
 
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+                /* Take the next cluster from the clusters reserved for the file.  */
+                status = _fx_utility_exFAT_reserved_cluster_get(media_ptr, file_ptr, last_cluster, clusters + 1, &FAT_index);
+
+                /* Check if the cluster continues a file that does not use FAT.  */
+                if ((status == FX_SUCCESS) && (file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1) && (last_cluster))
+                {
+
+                    if (FAT_index == last_cluster + 1)
+                    {
+
+                        /* Clusters are still consecutive.  */
+                        file_ptr -> fx_file_consecutive_cluster++;
+                    }
+                    else
+                    {
+
+                        /* Now we should use FAT.  */
+                        file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat &= (CHAR)0xfe; /* Clear bit 0.  */
+
+                        /* Build FAT chain.  */
+                        status = _fx_utility_FAT_chain_write(media_ptr, file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster,
+                                                             last_cluster - file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster + 1,
+                                                             FX_LAST_CLUSTER_exFAT);
+                    }
+                }
+#else
                 /* Find a free cluster.  */
                 if (file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1)
                 {
@@ -685,28 +871,9 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
                             file_ptr -> fx_file_dir_entry.fx_dir_entry_dont_use_fat &= (CHAR)0xfe; /* Clear bit 0.  */
 
                             /* Build FAT chain.  */
-                            for (i = file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster; i < last_cluster; ++i)
-                            {
-
-                                status = _fx_utility_FAT_entry_write(media_ptr, i, i + 1);
-
-                                if (status != FX_SUCCESS)
-                                {
-
-#ifdef FX_ENABLE_FAULT_TOLERANT
-                                    FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
-#endif /* FX_ENABLE_FAULT_TOLERANT */
-
-                                    /* Release media protection.  */
-                                    FX_UNPROTECT
-
-                                    /* Return the bad status.  */
-                                    return(status);
-                                }
-                            }
-
-                            /* Write the last cluster FAT entry.  */
-                            status = _fx_utility_FAT_entry_write(media_ptr, last_cluster, FX_LAST_CLUSTER_exFAT);
+                            status = _fx_utility_FAT_chain_write(media_ptr, file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster,
+                                                                 last_cluster - file_ptr -> fx_file_dir_entry.fx_dir_entry_cluster + 1,
+                                                                 FX_LAST_CLUSTER_exFAT);
                             if (status != FX_SUCCESS)
                             {
 
@@ -744,6 +911,7 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
                                                                         media_ptr -> fx_media_cluster_search_start,
                                                                         &FAT_index);
                 }
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
 
                 if (status != FX_SUCCESS)
                 {
@@ -763,6 +931,58 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
             {
 #endif /* FX_ENABLE_EXFAT */
 
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+                /* Determine if the free cluster bitmap is available.  */
+                if (media_ptr -> fx_media_cluster_bitmap)
+                {
+
+                    /* Yes, find the next free cluster in the bitmap instead of reading the FAT.  */
+                    status =  _fx_utility_FAT_bitmap_free_cluster_find(media_ptr, FAT_index, &FAT_index);
+
+                    /* Check for a bad status.  */
+                    if (status != FX_SUCCESS)
+                    {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+                        FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+                        /* Release media protection.  */
+                        FX_UNPROTECT
+
+                        /* Return the bad status.  */
+                        return(status);
+                    }
+
+                    /* Determine if the search wrapped around to the pending run.  */
+                    if ((run_start) && (FAT_index >= run_start) && (FAT_index <= last_cluster))
+                    {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+                        FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+                        /* Release media protection.  */
+                        FX_UNPROTECT
+
+                        /* Yes, no other cluster is free.  */
+                        return(FX_NO_MORE_SPACE);
+                    }
+
+                    /* Move cluster search pointer forward.  */
+                    media_ptr -> fx_media_cluster_search_start =  FAT_index + 1;
+
+                    /* Determine if this needs to be wrapped.  */
+                    if (media_ptr -> fx_media_cluster_search_start >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
+                    {
+
+                        /* Wrap the search to the beginning FAT entry.  */
+                        media_ptr -> fx_media_cluster_search_start =  FX_FAT_ENTRY_START;
+                    }
+                }
+                else
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
                 /* Loop to find the first available cluster.  */
                 do
                 {
@@ -804,8 +1024,9 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
                     /* Decrement the total cluster count.  */
                     total_clusters--;
 
-                    /* Determine if the FAT entry is free.  */
-                    if (FAT_value == FX_FREE_CLUSTER)
+                    /* Determine if the FAT entry is free and not in the pending run.  */
+                    if ((FAT_value == FX_FREE_CLUSTER) &&
+                        ((run_start == 0) || (FAT_index < run_start) || (FAT_index > last_cluster)))
                     {
 
                         /* Move cluster search pointer forward.  */
@@ -907,8 +1128,14 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
 #endif /* FX_ENABLE_EXFAT */
 
                         /* Normal condition - link the last cluster with the new
-                           found cluster.  */
-                        status = _fx_utility_FAT_entry_write(media_ptr, last_cluster, FAT_index);
+                           found cluster.  Links between consecutive new clusters are
+                           deferred and written one run at a time.  Before the first
+                           run starts, the last cluster is the insertion point, which
+                           is linked to the first new cluster after the search.  */
+                        if ((run_start != 0) && (FAT_index != (last_cluster + 1)))
+                        {
+                            status = _fx_utility_FAT_chain_write(media_ptr, run_start, last_cluster - run_start + 1, FAT_index);
+                        }
 #ifdef FX_ENABLE_EXFAT
                     }
 #endif /* FX_ENABLE_EXFAT */
@@ -1005,6 +1232,12 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
             }
 #endif /* FX_ENABLE_EXFAT */
 
+            /* Start a new run of pending links unless this cluster extends the current one.  */
+            if ((run_start == 0) || (FAT_index != (last_cluster + 1)))
+            {
+                run_start =  FAT_index;
+            }
+
             /* Otherwise, remember the new FAT index as the last.  */
             last_cluster =  FAT_index;
 
@@ -1020,19 +1253,27 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
         {
 #endif /* FX_ENABLE_EXFAT */
 
+            /* Determine if any new clusters were found.  */
+            if (run_start == 0)
+            {
+
+                /* No, only the last cluster needs its entry.  */
+                run_start =  last_cluster;
+            }
+
 #ifdef FX_ENABLE_FAULT_TOLERANT
             if (media_ptr -> fx_media_fault_tolerant_enabled)
             {
 
-                /* Link the last cluster back to original FAT.  */
-                status = _fx_utility_FAT_entry_write(media_ptr, last_cluster, insertion_back);
+                /* Write the pending links and link the last cluster back to original FAT.  */
+                status = _fx_utility_FAT_chain_write(media_ptr, run_start, last_cluster - run_start + 1, insertion_back);
             }
             else
 #endif /* FX_ENABLE_FAULT_TOLERANT */
             {
 
-                /* Place an end-of-file marker on the last cluster.  */
-                status = _fx_utility_FAT_entry_write(media_ptr, last_cluster, media_ptr -> fx_media_fat_last);
+                /* Write the pending links and place an end-of-file marker on the last cluster.  */
+                status = _fx_utility_FAT_chain_write(media_ptr, run_start, last_cluster - run_start + 1, media_ptr -> fx_media_fat_last);
             }
 
             /* Check for a bad FAT write status.  */
@@ -1160,6 +1401,13 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
     if (replace_clusters > 0)
     {
 
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+        /* The replaced clusters are no longer part of the file, so the extent map
+           of this file and of any other handle on it must be rebuilt.  */
+        _fx_file_extent_map_invalidate(file_ptr);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
         /* Force update current cluster and sector. */
         file_ptr -> fx_file_current_physical_cluster = first_new_cluster;
         file_ptr -> fx_file_current_logical_sector =    ((ULONG)media_ptr -> fx_media_data_sector_start) +
@@ -1336,6 +1584,19 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
             sectors =  (UINT)(bytes_remaining / media_ptr -> fx_media_bytes_per_sector);
 
             next_cluster = cluster = file_ptr -> fx_file_current_physical_cluster;
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+            relative_cluster =  file_ptr -> fx_file_current_relative_cluster;
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+            /* The first segment starts at the current logical sector.  */
+            segments =       1;
+            segment_start =  0;
+            segment_ptr =    media_ptr -> fx_media_driver_segment_list;
+            segment_ptr -> fx_driver_segment_logical_sector =  file_ptr -> fx_file_current_logical_sector;
+            segment_ptr -> fx_driver_segment_buffer =          source_ptr;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
 
             for (i = (media_ptr -> fx_media_sectors_per_cluster -
                       file_ptr -> fx_file_current_relative_sector); i < sectors; i += media_ptr -> fx_media_sectors_per_cluster)
@@ -1348,7 +1609,14 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
                 else
                 {
 #endif /* FX_ENABLE_EXFAT */
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+                    /* Find the next cluster through the extent map of the file.  */
+                    status =  _fx_file_extent_map_next(file_ptr, relative_cluster, cluster, &next_cluster);
+                    relative_cluster++;
+#else
                     status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &next_cluster);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 
                     /* Determine if an error is present.  */
                     if ((status != FX_SUCCESS) || (next_cluster < FX_FAT_ENTRY_START) ||
@@ -1374,6 +1642,26 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
 
                     if (next_cluster != cluster + 1)
                     {
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+                        /* Determine if the write can continue in another segment.  */
+                        if ((media_ptr -> fx_media_driver_scatter_gather_supported) &&
+                            (segments < FX_SCATTER_GATHER_SEGMENTS))
+                        {
+
+                            /* Yes, end the current segment and start the next one at the
+                               first sector of the next cluster.  */
+                            segment_ptr -> fx_driver_segment_sectors =  i - segment_start;
+                            segment_ptr++;
+                            segments++;
+                            segment_start =  i;
+                            segment_ptr -> fx_driver_segment_logical_sector =  media_ptr -> fx_media_data_sector_start +
+                                (((ULONG64)next_cluster - FX_FAT_ENTRY_START) * media_ptr -> fx_media_sectors_per_cluster);
+                            segment_ptr -> fx_driver_segment_buffer =  source_ptr + (i * media_ptr -> fx_media_bytes_per_sector);
+                            cluster =  next_cluster;
+                            continue;
+                        }
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
                         break;
                     }
                     else
@@ -1390,6 +1678,21 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
                 sectors = i;
             }
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+            /* The last segment ends with the last sector to write.  */
+            segment_ptr -> fx_driver_segment_sectors =  sectors - segment_start;
+
+            /* Determine if the sectors are in more than one run.  */
+            if (segments > 1)
+            {
+
+                /* Yes, write all runs with one scatter-gather request.  */
+                status =  _fx_utility_logical_sector_scatter_gather(media_ptr, FX_DRIVER_WRITE, segments, FX_DATA_SECTOR);
+            }
+            else
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
+
             /* Perform the data write directly from the user's buffer of
                the appropriate number of sectors.  */
             status =  _fx_utility_logical_sector_write(media_ptr, file_ptr -> fx_file_current_logical_sector,
@@ -1414,9 +1717,15 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
             /* Increment the current logical sector.  Subtract one from
                the sector count because we are going to use the logical
                offset to do additional sector/cluster arithmetic below.  */
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+            file_ptr -> fx_file_current_logical_sector =
+                segment_ptr -> fx_driver_segment_logical_sector +
+                (segment_ptr -> fx_driver_segment_sectors - 1);
+#else
             file_ptr -> fx_file_current_logical_sector =
                 file_ptr -> fx_file_current_logical_sector +
                 (sectors - 1);
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
 
             /* Move the relative cluster and sector as well.  */
             file_ptr -> fx_file_current_relative_cluster = file_ptr -> fx_file_current_relative_cluster +
@@ -1484,10 +1793,17 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
                 {
 #endif /* FX_ENABLE_EXFAT */
 
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+
+                    /* Find the next cluster through the extent map of the file.  */
+                    status =  _fx_file_extent_map_next(file_ptr, file_ptr -> fx_file_current_relative_cluster,
+                                                       file_ptr -> fx_file_current_physical_cluster, &next_cluster);
+#else
                     /* Read the FAT entry of the current cluster to find
                        the next cluster.  */
                     status =  _fx_utility_FAT_entry_read(media_ptr,
                                                          file_ptr -> fx_file_current_physical_cluster, &next_cluster);
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
 
                     /* Determine if an error is present.  */
                     if ((status != FX_SUCCESS) || (next_cluster < FX_FAT_ENTRY_START) ||
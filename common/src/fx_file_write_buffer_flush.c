@@ -0,0 +1,177 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+#include "fx_system.h"
+#include "fx_file.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_write_buffer_flush                         PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function writes the data gathered in the write buffer of the   */
+/*    file at the current offset, which is the end of the file. If all    */
+/*    bytes are not requested, only the data up to the last complete      */
+/*    sector of the file is written and the remaining bytes are moved to  */
+/*    the beginning of the buffer, so the next write of the buffer        */
+/*    starts on a sector boundary.                                        */
+/*                                                                        */
+/*    If the write fails, all data in the buffer is discarded and the     */
+/*    error is returned, so the error is reported only once and later     */
+/*    services of the file do not fail again because of the same data.    */
+/*    The file then ends where the failed write left it.                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*    all_bytes                             FX_TRUE writes all buffered   */
+/*                                            bytes                       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_file_write                        Write data to file            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_close                        Close file                    */
+/*    _fx_file_extended_allocate            Allocate space for file       */
+/*    _fx_file_extended_best_effort_allocate                              */
+/*                                          Allocate space for file       */
+/*    _fx_file_extended_relative_seek       Seek relative to position     */
+/*    _fx_file_extended_seek                Seek to position in file      */
+/*    _fx_file_extended_truncate            Truncate file                 */
+/*    _fx_file_extended_truncate_release    Truncate file and release     */
+/*                                            clusters                    */
+/*    _fx_file_read                         Read data from file           */
+/*    _fx_file_write                        Write data to file            */
+/*    _fx_file_write_buffer_set             Set file write buffer         */
+/*    _fx_media_close                       Close media                   */
+/*    _fx_media_flush                       Flush media                   */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_file_write_buffer_flush(FX_FILE *file_ptr, UINT all_bytes)
+{
+
+UINT      status;
+ULONG     bytes;
+ULONG     remaining_bytes;
+ULONG     i;
+UCHAR    *buffer_ptr;
+FX_MEDIA *media_ptr;
+
+
+    /* Determine if the file is open and has buffered data.  */
+    if ((file_ptr -> fx_file_id != FX_FILE_ID) || (file_ptr -> fx_file_write_buffer_bytes == 0))
+    {
+
+        /* Nothing to write, return successful status.  */
+        return(FX_SUCCESS);
+    }
+
+    /* Setup pointer to media structure.  */
+    media_ptr =  file_ptr -> fx_file_media_ptr;
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Pickup the number of buffered bytes.  */
+    bytes =  file_ptr -> fx_file_write_buffer_bytes;
+
+    /* Determine if only complete sectors are written.  */
+    if ((all_bytes == FX_FALSE) && (media_ptr -> fx_media_bytes_per_sector))
+    {
+
+        /* Calculate the number of bytes past the last complete sector of the file.  */
+        remaining_bytes =  (ULONG)((file_ptr -> fx_file_current_file_offset + bytes) %
+                                   media_ptr -> fx_media_bytes_per_sector);
+
+        /* Keep these bytes in the buffer, unless that leaves nothing to write.  */
+        if (remaining_bytes < bytes)
+        {
+            bytes =  bytes - remaining_bytes;
+        }
+    }
+
+    /* Detach the buffer from the file, so the data is written directly.  */
+    buffer_ptr =  file_ptr -> fx_file_write_buffer;
+    file_ptr -> fx_file_write_buffer =  FX_NULL;
+
+    /* Write the buffered data at the end of the file.  */
+    status =  _fx_file_write(file_ptr, buffer_ptr, bytes);
+
+    /* Attach the buffer again.  */
+    file_ptr -> fx_file_write_buffer =  buffer_ptr;
+
+    /* Determine if the write was unsuccessful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Discard the data that could not be written.  */
+        file_ptr -> fx_file_write_buffer_bytes =  0;
+    }
+    else
+    {
+
+        /* Move the remaining bytes to the beginning of the buffer.  */
+        remaining_bytes =  file_ptr -> fx_file_write_buffer_bytes - bytes;
+        for (i = 0; i < remaining_bytes; i++)
+        {
+            buffer_ptr[i] =  buffer_ptr[bytes + i];
+        }
+        file_ptr -> fx_file_write_buffer_bytes =  remaining_bytes;
+    }
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return status to the caller.  */
+    return(status);
+}
+
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
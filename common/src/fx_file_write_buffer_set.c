@@ -0,0 +1,174 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   File                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_file.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_file_write_buffer_set                           PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the buffer that gathers the data appended to     */
+/*    the file. Small appends are copied into this buffer and are         */
+/*    written to the file in whole sectors when the buffer is full, or    */
+/*    completely when the file is read, seeked, truncated, allocated or   */
+/*    closed, or when the media is flushed or closed. Data that is still  */
+/*    in the buffer is not part of the file yet and is lost if power      */
+/*    fails or the media is aborted.                                      */
+/*                                                                        */
+/*    The buffer must hold at least one sector. Any data in the previous  */
+/*    buffer is written to the file first. A NULL buffer pointer removes  */
+/*    the write buffer from the file.                                     */
+/*                                                                        */
+/*    This service requires FX_ENABLE_FILE_WRITE_BUFFER, otherwise        */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    file_ptr                              File control block pointer    */
+/*    buffer_ptr                            Write buffer pointer, NULL    */
+/*                                            removes the write buffer    */
+/*    buffer_size                           Size of the write buffer in   */
+/*                                            bytes                       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_file_write_buffer_flush           Write buffered data to file   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_file_write_buffer_set(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG buffer_size)
+{
+
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+UINT      status;
+FX_MEDIA *media_ptr;
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
+
+    /* First, determine if the file is still open.  */
+    if (file_ptr -> fx_file_id != FX_FILE_ID)
+    {
+
+        /* Return the file not open error status.  */
+        return(FX_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_FILE_WRITE_BUFFER
+
+    FX_PARAMETER_NOT_USED(buffer_ptr);
+    FX_PARAMETER_NOT_USED(buffer_size);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Setup pointer to media structure.  */
+    media_ptr =  file_ptr -> fx_file_media_ptr;
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Make sure this file is open for writing.  */
+    if (file_ptr -> fx_file_open_mode != FX_OPEN_FOR_WRITE)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the access error exception.  */
+        return(FX_ACCESS_ERROR);
+    }
+
+    /* Make sure the new buffer can hold at least one sector.  */
+    if ((buffer_ptr != FX_NULL) && (buffer_size < media_ptr -> fx_media_bytes_per_sector))
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the buffer error.  */
+        return(FX_BUFFER_ERROR);
+    }
+
+    /* Write any data still in the previous write buffer to the file.  */
+    status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+
+    /* Determine if the write was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+    /* Determine if the write buffer is removed.  */
+    if (buffer_ptr == FX_NULL)
+    {
+
+        /* Yes, clear the size as well.  */
+        buffer_size =  0;
+    }
+
+    /* Setup the new write buffer, which is empty.  */
+    file_ptr -> fx_file_write_buffer =        (UCHAR *)buffer_ptr;
+    file_ptr -> fx_file_write_buffer_size =   buffer_size;
+    file_ptr -> fx_file_write_buffer_bytes =  0;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+}
@@ -58,6 +58,8 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _fx_utility_logical_sector_cache_pool_release                       */
+/*                                          Return cache entries to pool  */
 /*    tx_mutex_delete                       Delete the mutex              */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -115,6 +117,17 @@ FX_FILE *file_ptr;
         open_count--;
     }
 
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+
+    /* Determine if the media is attached to a cache pool.  */
+    if (media_ptr -> fx_media_sector_cache_pool)
+    {
+
+        /* Yes, return its cache entries to the pool, dirty sectors are discarded.  */
+        _fx_utility_logical_sector_cache_pool_release(media_ptr);
+    }
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
     /* Build the "abort" I/O driver request.  */
     media_ptr -> fx_media_driver_request =      FX_DRIVER_ABORT;
     media_ptr -> fx_media_driver_status =       FX_IO_ERROR;
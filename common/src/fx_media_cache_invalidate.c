@@ -76,8 +76,10 @@
 UINT  _fx_media_cache_invalidate(FX_MEDIA *media_ptr)
 {
 
-UINT status;
-UINT i;
+UINT                status;
+ULONG               i;
+ULONG               cache_size;
+FX_FAT_CACHE_ENTRY *cache_ptr;
 
 
 #ifndef FX_MEDIA_STATISTICS_DISABLE
@@ -105,13 +107,25 @@ UINT i;
     /* Flush changed sector(s) in the primary FAT to secondary FATs.  */
     _fx_utility_FAT_map_flush(media_ptr);
 
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    /* Pickup the FAT cache in use.  */
+    cache_ptr =   media_ptr -> fx_media_fat_cache_entries;
+    cache_size =  media_ptr -> fx_media_fat_cache_size;
+#else
+
+    /* Pickup the FAT cache of the media.  */
+    cache_ptr =   media_ptr -> fx_media_fat_cache;
+    cache_size =  FX_MAX_FAT_CACHE;
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+
     /* Clear the FAT cache entry array.  */
-    for (i = 0; i < FX_MAX_FAT_CACHE; i++)
+    for (i = 0; i < cache_size; i++)
     {
 
         /* Clear entry in the FAT cache.  */
-        media_ptr -> fx_media_fat_cache[i].fx_fat_cache_entry_cluster =   0;
-        media_ptr -> fx_media_fat_cache[i].fx_fat_cache_entry_value   =   0;
+        cache_ptr[i].fx_fat_cache_entry_cluster =   0;
+        cache_ptr[i].fx_fat_cache_entry_value   =   0;
     }
 
     /* Clear the secondary FAT update map.  */
@@ -121,6 +135,16 @@ UINT i;
         /* Clear bit map entry for secondary FAT update.  */
         media_ptr -> fx_media_fat_secondary_update_map[i] =  0;
     }
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+
+    /* Clear the ranges of FAT sectors to mirror, unless they are kept in the record sector.  */
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+    if (media_ptr -> fx_media_fat_mirror_deferred == FX_FALSE)
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+    {
+        media_ptr -> fx_media_fat_mirror_ranges =  0;
+    }
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
 
     /* Call the logical sector flush to invalidate the logical sector cache.  */
     status =  _fx_utility_logical_sector_flush(media_ptr, ((ULONG64) 1), (ULONG64) (media_ptr -> fx_media_total_sectors), FX_TRUE);
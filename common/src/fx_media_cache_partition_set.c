@@ -0,0 +1,273 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_cache_partition_set                       PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reserves the specified percentages of the logical     */
+/*    sector cache for FAT sectors, directory sectors and data sectors.   */
+/*    Boot and unknown sectors are cached in the directory partition.     */
+/*    Each partition is replaced in least recently used order on its      */
+/*    own. If all percentages are zero, the whole cache is shared by all  */
+/*    sector types again.                                                 */
+/*                                                                        */
+/*    The data partition gets the entries the FAT and directory           */
+/*    partitions leave, so it also gets rounding differences and any      */
+/*    percentages not given. Percentages that add up to more than 100 or  */
+/*    no percentage for data sectors return FX_INVALID_OPTION. Each       */
+/*    partition gets at least one cache entry. All dirty sectors are      */
+/*    written to the media and the cache is invalidated before the        */
+/*    entries are assigned to their new partitions.                       */
+/*                                                                        */
+/*    The partitions cannot change while files hold sectors borrowed with */
+/*    fx_file_read_borrow, FX_NOT_AVAILABLE is returned in that case.     */
+/*                                                                        */
+/*    This service requires FX_ENABLE_SECTOR_CACHE_PARTITION, otherwise   */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    fat_percent                           Percentage of the cache for   */
+/*                                            FAT sectors                 */
+/*    directory_percent                     Percentage of the cache for   */
+/*                                            directory sectors           */
+/*    data_percent                          Percentage of the cache for   */
+/*                                            data sectors                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_flush      Flush and invalidate sectors  */
+/*    _fx_utility_logical_sector_cache_entry_link                         */
+/*                                          Link cache entry into list    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_cache_partition_set(FX_MEDIA *media_ptr, UINT fat_percent, UINT directory_percent, UINT data_percent)
+{
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+UINT              status;
+ULONG             cache_size;
+ULONG             fat_size;
+ULONG             directory_size;
+ULONG             i;
+FX_CACHED_SECTOR *cache_entry;
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    FX_PARAMETER_NOT_USED(fat_percent);
+    FX_PARAMETER_NOT_USED(directory_percent);
+    FX_PARAMETER_NOT_USED(data_percent);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Pickup the number of cached sectors.  */
+    cache_size =  media_ptr -> fx_media_sector_cache_size;
+
+    /* Determine if the cache should be partitioned.  */
+    if (fat_percent | directory_percent | data_percent)
+    {
+
+        /* Yes, make sure the percentages fit in the cache and leave a share for data sectors.  */
+        if ((fat_percent > 100) || (directory_percent > 100) || (data_percent > 100) ||
+            ((fat_percent + directory_percent + data_percent) > 100) || (data_percent == 0))
+        {
+
+            /* Return the invalid option error.  */
+            return(FX_INVALID_OPTION);
+        }
+
+        /* Make sure each partition can have at least one entry.  */
+        if (cache_size < FX_SECTOR_CACHE_PARTITIONS)
+        {
+
+            /* Return the not enough memory error.  */
+            return(FX_NOT_ENOUGH_MEMORY);
+        }
+
+        /* Calculate the number of entries of the FAT and directory partitions, the
+           remaining entries are reserved for data sectors, whatever data_percent is.  */
+        fat_size =        (cache_size * fat_percent) / 100;
+        directory_size =  (cache_size * directory_percent) / 100;
+        if (fat_size == 0)
+        {
+            fat_size =  1;
+        }
+        if (directory_size == 0)
+        {
+            directory_size =  1;
+        }
+
+        /* Leave at least one entry for the data partition.  */
+        while ((fat_size + directory_size) >= cache_size)
+        {
+            if (fat_size > directory_size)
+            {
+                fat_size--;
+            }
+            else
+            {
+                directory_size--;
+            }
+        }
+    }
+    else
+    {
+
+        /* No, all entries are shared through the data partition.  */
+        fat_size =        0;
+        directory_size =  0;
+    }
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+    /* Determine if files have borrowed sectors from the cache.  */
+    if (media_ptr -> fx_media_sector_cache_pinned_count)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* The pinned entries cannot change partitions, return the not available error.  */
+        return(FX_NOT_AVAILABLE);
+    }
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+    /* Write out all dirty sectors and invalidate the logical sector cache, since the
+       entries are about to change partitions.  */
+    status =  _fx_utility_logical_sector_flush(media_ptr, ((ULONG64) 0), (ULONG64) (media_ptr -> fx_media_total_sectors), FX_TRUE);
+
+    /* Determine if the flush was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+    /* Clear the list of each partition.  */
+    for (i = 0; i < FX_SECTOR_CACHE_PARTITIONS; i++)
+    {
+        media_ptr -> fx_media_sector_cache_partition_ptr[i] =   FX_NULL;
+        media_ptr -> fx_media_sector_cache_partition_tail[i] =  FX_NULL;
+    }
+
+    /* Assign each cache entry to its partition.  */
+    cache_entry =  media_ptr -> fx_media_sector_cache;
+    for (i = 0; i < cache_size; i++)
+    {
+
+        /* The entries of each partition are contiguous.  */
+        if (i < fat_size)
+        {
+            cache_entry -> fx_cached_sector_partition =  FX_SECTOR_CACHE_PARTITION_FAT;
+        }
+        else if (i < (fat_size + directory_size))
+        {
+            cache_entry -> fx_cached_sector_partition =  FX_SECTOR_CACHE_PARTITION_DIRECTORY;
+        }
+        else
+        {
+            cache_entry -> fx_cached_sector_partition =  FX_SECTOR_CACHE_PARTITION_DATA;
+        }
+
+        /* Place the entry at the end of the list of its partition.  */
+        _fx_utility_logical_sector_cache_entry_link(media_ptr, cache_entry, FX_TRUE);
+
+        /* Move to the next cache entry.  */
+        cache_entry++;
+    }
+
+    /* Remember the size of each partition.  */
+    media_ptr -> fx_media_sector_cache_partition_size[FX_SECTOR_CACHE_PARTITION_FAT] =        fat_size;
+    media_ptr -> fx_media_sector_cache_partition_size[FX_SECTOR_CACHE_PARTITION_DIRECTORY] =  directory_size;
+    media_ptr -> fx_media_sector_cache_partition_size[FX_SECTOR_CACHE_PARTITION_DATA] =       cache_size - fat_size - directory_size;
+
+    /* Remember if the cache is partitioned.  */
+    if (fat_size)
+    {
+        media_ptr -> fx_media_sector_cache_partitioned =  FX_TRUE;
+    }
+    else
+    {
+        media_ptr -> fx_media_sector_cache_partitioned =  FX_FALSE;
+    }
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+}
@@ -0,0 +1,270 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_cache_pool_attach                         PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function attaches an open media to a logical sector cache      */
+/*    pool. All dirty sectors are written to the media first. From then   */
+/*    on the media caches its sectors in entries of the pool instead of   */
+/*    the memory supplied to fx_media_open, which is used again when the  */
+/*    media is detached or closed.                                        */
+/*                                                                        */
+/*    A media that needs another cache entry takes a free entry of the    */
+/*    pool. If there is none, it takes the least recently used clean      */
+/*    entry of all attached media that hold more entries than they        */
+/*    reserved, including itself. The reserved sectors are the number of  */
+/*    entries other media cannot take from this media, the reservations   */
+/*    of all attached media must fit in the pool.                         */
+/*                                                                        */
+/*    This service requires FX_ENABLE_SECTOR_CACHE_POOL, otherwise        */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    pool_ptr                              Cache pool control block      */
+/*                                            pointer                     */
+/*    reserved_sectors                      Number of entries reserved for*/
+/*                                            the media                   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_pool_entry_get                     */
+/*                                          Get cache entry from pool     */
+/*    _fx_utility_logical_sector_cache_pool_release                       */
+/*                                          Return cache entries to pool  */
+/*    _fx_utility_logical_sector_flush      Flush logical sectors         */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Release protection mutex      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_cache_pool_attach(FX_MEDIA *media_ptr, FX_SECTOR_CACHE_POOL *pool_ptr, ULONG reserved_sectors)
+{
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+UINT              status;
+ULONG             i;
+ULONG             hash_size;
+FX_CACHED_SECTOR *cache_entry;
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_SECTOR_CACHE_POOL
+
+    FX_PARAMETER_NOT_USED(pool_ptr);
+    FX_PARAMETER_NOT_USED(reserved_sectors);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Determine if the pool was built for the sector size of this media.  */
+    if (pool_ptr -> fx_sector_cache_pool_bytes_per_sector != media_ptr -> fx_media_bytes_per_sector)
+    {
+
+        /* Return the sector size error.  */
+        return(FX_SECTOR_INVALID);
+    }
+
+    /* At least one entry is always reserved for the media.  */
+    if (reserved_sectors == 0)
+    {
+        reserved_sectors =  1;
+    }
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Determine if the media is already attached to a pool.  */
+    if (media_ptr -> fx_media_sector_cache_pool)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the invalid state error.  */
+        return(FX_INVALID_STATE);
+    }
+
+    /* Write all dirty sectors of the media's own cache.  */
+    status =  _fx_utility_logical_sector_flush(media_ptr, ((ULONG64) 1), (ULONG64) (media_ptr -> fx_media_total_sectors), FX_FALSE);
+
+    /* Determine if the flush was unsuccessful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+#ifndef FX_SINGLE_THREAD
+
+    /* Protect against other media accessing the pool.  */
+    tx_mutex_get(&(pool_ptr -> fx_sector_cache_pool_protect), TX_WAIT_FOREVER);
+#endif
+
+    /* Find a free media slot of the pool.  */
+    for (i = 0; i < FX_SECTOR_CACHE_POOL_MEDIA; i++)
+    {
+        if (pool_ptr -> fx_sector_cache_pool_media[i] == FX_NULL)
+        {
+            break;
+        }
+    }
+
+    /* Determine if the media and its reservation fit in the pool.  */
+    if ((i == FX_SECTOR_CACHE_POOL_MEDIA) ||
+        (reserved_sectors > (pool_ptr -> fx_sector_cache_pool_size - pool_ptr -> fx_sector_cache_pool_reserved)))
+    {
+
+#ifndef FX_SINGLE_THREAD
+
+        /* Release pool protection.  */
+        tx_mutex_put(&(pool_ptr -> fx_sector_cache_pool_protect));
+#endif
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the not enough memory error.  */
+        return(FX_NOT_ENOUGH_MEMORY);
+    }
+
+    /* Add the media and its reservation to the pool.  */
+    pool_ptr -> fx_sector_cache_pool_media[i] =  media_ptr;
+    pool_ptr -> fx_sector_cache_pool_reserved +=  reserved_sectors;
+
+#ifndef FX_SINGLE_THREAD
+
+    /* Release pool protection.  */
+    tx_mutex_put(&(pool_ptr -> fx_sector_cache_pool_protect));
+#endif
+
+    /* Remember the memory of the media's own cache, it is used again when the
+       media is detached from the pool.  */
+    media_ptr -> fx_media_sector_cache_private_memory =  media_ptr -> fx_media_sector_cache[0].fx_cached_sector_memory_buffer;
+    media_ptr -> fx_media_sector_cache_private_size =    media_ptr -> fx_media_memory_size;
+
+    /* The cache entries of the media are now found in the pool. The media starts out
+       without entries and takes them from the pool as it needs them.  */
+    media_ptr -> fx_media_sector_cache =               pool_ptr -> fx_sector_cache_pool_entries;
+    media_ptr -> fx_media_sector_cache_size =          pool_ptr -> fx_sector_cache_pool_size;
+    media_ptr -> fx_media_sector_cache_end =           pool_ptr -> fx_sector_cache_pool_memory_end;
+    media_ptr -> fx_media_sector_cache_list_ptr =      FX_NULL;
+    media_ptr -> fx_media_sector_cache_list_tail =     FX_NULL;
+    media_ptr -> fx_media_sector_cache_hashed_sector_valid =  0;
+    media_ptr -> fx_media_sector_cache_dirty_count =   0;
+    media_ptr -> fx_media_sector_cache_pool =          pool_ptr;
+    media_ptr -> fx_media_sector_cache_pool_entries =  0;
+    media_ptr -> fx_media_sector_cache_pool_reserved = reserved_sectors;
+
+    /* Use the hash buckets built into the media control block, as many as there are
+       pool entries if possible.  */
+    media_ptr -> fx_media_sector_cache_hash_table =  media_ptr -> fx_media_sector_cache_hash_built_in;
+    hash_size =  1;
+    while ((hash_size < pool_ptr -> fx_sector_cache_pool_size) && ((hash_size << 1) <= FX_MAX_SECTOR_CACHE))
+    {
+        hash_size =  hash_size << 1;
+    }
+
+    /* Clear the hash buckets.  */
+    for (i = 0; i < hash_size; i++)
+    {
+        media_ptr -> fx_media_sector_cache_hash_table[i] =  FX_NULL;
+    }
+
+    /* Save the mask used to compute the hash bucket of a logical sector.  */
+    media_ptr -> fx_media_sector_cache_hash_mask =  hash_size - 1;
+
+    /* Take the first cache entry of the media, which also serves as its memory buffer.  */
+    cache_entry =  _fx_utility_logical_sector_cache_pool_entry_get(media_ptr);
+
+    /* Determine if an entry was available.  */
+    if (cache_entry == FX_NULL)
+    {
+
+        /* No, go back to the media's own cache.  */
+        _fx_utility_logical_sector_cache_pool_release(media_ptr);
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the not available error.  */
+        return(FX_NOT_AVAILABLE);
+    }
+
+    /* Setup the memory buffer pointer of the media.  */
+    media_ptr -> fx_media_memory_buffer =  cache_entry -> fx_cached_sector_memory_buffer;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+}
@@ -0,0 +1,189 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_cache_pool_create                         PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function builds a logical sector cache pool in the supplied    */
+/*    memory. The memory holds the sector buffers followed by the cache   */
+/*    control structures of the pool entries. All entries are free until  */
+/*    media attached with fx_media_cache_pool_attach take them.           */
+/*                                                                        */
+/*    This service requires FX_ENABLE_SECTOR_CACHE_POOL, otherwise        */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                              Cache pool control block      */
+/*                                            pointer                     */
+/*    memory_ptr                            Pointer to memory used by the */
+/*                                            pool                        */
+/*    memory_size                           Size of the memory            */
+/*    bytes_per_sector                      Sector size of the media      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_create                       Create protection mutex       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_cache_pool_create(FX_SECTOR_CACHE_POOL *pool_ptr, VOID *memory_ptr, ULONG memory_size, UINT bytes_per_sector)
+{
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+FX_CACHED_SECTOR *cache_entry;
+ULONG             cache_size;
+ULONG             i;
+ALIGN_TYPE        control_ptr;
+ALIGN_TYPE        address_mask;
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+
+#ifndef FX_ENABLE_SECTOR_CACHE_POOL
+
+    FX_PARAMETER_NOT_USED(pool_ptr);
+    FX_PARAMETER_NOT_USED(memory_ptr);
+    FX_PARAMETER_NOT_USED(memory_size);
+    FX_PARAMETER_NOT_USED(bytes_per_sector);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Determine if the sector size is valid.  */
+    if (bytes_per_sector == 0)
+    {
+
+        /* Return the sector size error.  */
+        return(FX_SECTOR_INVALID);
+    }
+
+    /* Determine how many sectors fit, each needs a sector buffer and a control block.
+       The control blocks follow the sector buffers and must be aligned.  */
+    cache_size =  0;
+    if (memory_size > (sizeof(ULONG64) - 1))
+    {
+        cache_size =  (memory_size - (ULONG)(sizeof(ULONG64) - 1)) / (bytes_per_sector + (ULONG)sizeof(FX_CACHED_SECTOR));
+    }
+
+    /* Is there at least one?  */
+    if (cache_size == 0)
+    {
+
+        /* Error in the buffer size supplied by user.  */
+        return(FX_BUFFER_ERROR);
+    }
+
+    /* Setup address mask to align the control blocks.  */
+    address_mask =  sizeof(ULONG64) - 1;
+    address_mask =  ~address_mask;
+
+    /* The control blocks immediately follow the sector buffers.  */
+    control_ptr =  ((ALIGN_TYPE)memory_ptr) + (cache_size * bytes_per_sector) + (sizeof(ULONG64) - 1);
+    control_ptr =  control_ptr & address_mask;
+
+    /* Setup the pool control block.  */
+    pool_ptr -> fx_sector_cache_pool_bytes_per_sector =  bytes_per_sector;
+    pool_ptr -> fx_sector_cache_pool_entries =           (FX_CACHED_SECTOR *)control_ptr;
+    pool_ptr -> fx_sector_cache_pool_size =              cache_size;
+    pool_ptr -> fx_sector_cache_pool_memory_end =        ((UCHAR *)memory_ptr) + (cache_size * bytes_per_sector) - 1;
+    pool_ptr -> fx_sector_cache_pool_free_list =         pool_ptr -> fx_sector_cache_pool_entries;
+    pool_ptr -> fx_sector_cache_pool_free_count =        cache_size;
+    pool_ptr -> fx_sector_cache_pool_reserved =          0;
+    pool_ptr -> fx_sector_cache_pool_clock =             0;
+    pool_ptr -> fx_sector_cache_pool_steals =            0;
+    for (i = 0; i < FX_SECTOR_CACHE_POOL_MEDIA; i++)
+    {
+        pool_ptr -> fx_sector_cache_pool_media[i] =  FX_NULL;
+    }
+
+    /* Initialize the cache entries and place all of them on the free list.  */
+    cache_entry =  pool_ptr -> fx_sector_cache_pool_entries;
+    for (i = 0; i < cache_size; i++)
+    {
+
+        /* Initialize each of the cache entries.  */
+        cache_entry -> fx_cached_sector_memory_buffer =  ((UCHAR *)memory_ptr) + (i * bytes_per_sector);
+        cache_entry -> fx_cached_sector =                (~(ULONG64)0);
+        cache_entry -> fx_cached_sector_buffer_dirty =   FX_FALSE;
+        cache_entry -> fx_cached_sector_valid =          FX_FALSE;
+        cache_entry -> fx_cached_sector_type =           FX_UNKNOWN_SECTOR;
+        cache_entry -> fx_cached_sector_next_used =      cache_entry + 1;
+        cache_entry -> fx_cached_sector_previous_used =  FX_NULL;
+        cache_entry -> fx_cached_sector_hash_next =      FX_NULL;
+        cache_entry -> fx_cached_sector_hash_key =       (~(ULONG64)0);
+        cache_entry -> fx_cached_sector_media =          FX_NULL;
+        cache_entry -> fx_cached_sector_last_used =      0;
+
+        /* Move to the next cache sector entry.  */
+        cache_entry++;
+    }
+
+    /* Backup to the last cache entry to terminate the free list.  */
+    cache_entry--;
+    cache_entry -> fx_cached_sector_next_used =  FX_NULL;
+
+#ifndef FX_SINGLE_THREAD
+
+    /* Create ThreadX mutex for protection of the pool.  */
+    tx_mutex_create(&(pool_ptr -> fx_sector_cache_pool_protect), "FileX Cache Pool Mutex", TX_NO_INHERIT);
+#endif
+
+    /* The pool is ready to be used.  */
+    pool_ptr -> fx_sector_cache_pool_id =  FX_SECTOR_CACHE_POOL_ID;
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+}
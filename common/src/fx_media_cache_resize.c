@@ -0,0 +1,315 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_cache_resize                              PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function moves the logical sector cache of an open media to    */
+/*    the supplied memory, which may be larger or smaller than the        */
+/*    memory given to fx_media_open. All dirty sectors are written to     */
+/*    the media first and the cache control structures are rebuilt for    */
+/*    the new memory. After the call, the memory previously used by the   */
+/*    cache is no longer accessed by FileX.                               */
+/*                                                                        */
+/*    If FX_ENABLE_LRU_SECTOR_CACHE is defined and the new memory does    */
+/*    not overlap the current cache memory, the valid sectors are moved   */
+/*    to the new cache, most recently used first, as far as they fit.     */
+/*    Otherwise the new cache starts out empty. A partitioned cache is    */
+/*    shared by all sector types again after the resize.                  */
+/*                                                                        */
+/*    The cache cannot be resized while files hold sectors borrowed with  */
+/*    fx_file_read_borrow or while the media is attached to a cache pool, */
+/*    FX_NOT_AVAILABLE is returned in that case.                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    memory_ptr                            Pointer to memory used by the */
+/*                                            cache                       */
+/*    memory_size                           Size of the memory            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_insert                       */
+/*                                          Insert cache entry into hash  */
+/*                                            table and list              */
+/*    _fx_utility_logical_sector_cache_initialize                         */
+/*                                          Build logical sector cache    */
+/*    _fx_utility_logical_sector_flush      Flush logical sectors         */
+/*    _fx_utility_memory_copy               Copy memory                   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_cache_resize(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size)
+{
+
+UINT              status;
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+UCHAR            *old_memory_ptr;
+UCHAR            *old_memory_end;
+ULONG64          *sector_list;
+UCHAR            *type_list;
+FX_CACHED_SECTOR *cache_entry;
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+FX_CACHED_SECTOR *list_head[FX_SECTOR_CACHE_PARTITIONS];
+#else
+FX_CACHED_SECTOR *list_head[2];
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+ULONG             lists;
+ULONG             list;
+ULONG             pass;
+ULONG             sectors;
+ULONG             count;
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+    /* Determine if the memory can hold at least one sector.  */
+    if (memory_size < media_ptr -> fx_media_bytes_per_sector)
+    {
+
+        /* Error in the buffer size supplied by user.  */
+        return(FX_BUFFER_ERROR);
+    }
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+    /* Determine if files have borrowed sectors from the cache.  */
+    if (media_ptr -> fx_media_sector_cache_pinned_count)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* The borrowed sectors must stay in place, return the not available error.  */
+        return(FX_NOT_AVAILABLE);
+    }
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+
+    /* Determine if the media is attached to a cache pool.  */
+    if (media_ptr -> fx_media_sector_cache_pool)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* The cache entries belong to the pool, return the not available error.  */
+        return(FX_NOT_AVAILABLE);
+    }
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+    /* Write out all dirty sectors, the sectors remain valid in the cache.  */
+    status =  _fx_utility_logical_sector_flush(media_ptr, ((ULONG64) 0), (ULONG64) (media_ptr -> fx_media_total_sectors), FX_FALSE);
+
+    /* Determine if the flush was successful.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+    /* Pickup the memory of the current cache. The sector buffers are at its beginning,
+       followed by the control blocks and hash buckets unless the control blocks built
+       into the media control block are used.  */
+    old_memory_ptr =  (media_ptr -> fx_media_sector_cache) -> fx_cached_sector_memory_buffer;
+    if (media_ptr -> fx_media_sector_cache == media_ptr -> fx_media_sector_cache_built_in)
+    {
+        old_memory_end =  media_ptr -> fx_media_sector_cache_end + 1;
+    }
+    else
+    {
+        old_memory_end =  (UCHAR *)&(media_ptr -> fx_media_sector_cache_hash_table[media_ptr -> fx_media_sector_cache_hash_mask + 1]);
+    }
+
+    /* Collect the lists of the cache in the order their sectors should be kept.  */
+    lists =  0;
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+    for (list = 0; list < FX_SECTOR_CACHE_PARTITIONS; list++)
+    {
+        list_head[lists++] =  media_ptr -> fx_media_sector_cache_partition_ptr[list];
+    }
+#else
+    list_head[lists++] =  media_ptr -> fx_media_sector_cache_list_ptr;
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+    list_head[lists++] =  media_ptr -> fx_media_sector_cache_probation_ptr;
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+    /* The sector numbers and types of the moved sectors are kept at the beginning of the
+       old memory, once all sector buffers have been copied.  */
+    sector_list =  (ULONG64 *)((((ALIGN_TYPE)old_memory_ptr) + (sizeof(ULONG64) - 1)) & ~((ALIGN_TYPE)(sizeof(ULONG64) - 1)));
+    type_list =    FX_NULL;
+    count =        0;
+
+    /* Determine if the new memory is separate from the current cache memory.  */
+    if ((((UCHAR *)memory_ptr) >= old_memory_end) || ((((UCHAR *)memory_ptr) + memory_size) <= old_memory_ptr))
+    {
+
+        /* Yes, the valid sectors can be moved. Calculate how many sector buffers the new
+           memory can hold at most.  */
+        sectors =  memory_size / media_ptr -> fx_media_bytes_per_sector;
+
+        /* The first pass copies the valid sectors to consecutive sector buffers of the new
+           memory, the second pass records their sector numbers and types.  */
+        for (pass = 0; pass < 2; pass++)
+        {
+
+            /* Walk each list from its most recently used entry.  */
+            count =  0;
+            for (list = 0; list < lists; list++)
+            {
+
+                cache_entry =  list_head[list];
+                while ((cache_entry) && (count < sectors))
+                {
+
+                    /* Determine if this entry holds a sector.  */
+                    if (cache_entry -> fx_cached_sector_valid)
+                    {
+
+                        if (pass == 0)
+                        {
+
+                            /* Copy the sector to the sector buffer of the new memory.  */
+                            _fx_utility_memory_copy(cache_entry -> fx_cached_sector_memory_buffer,
+                                                    ((UCHAR *)memory_ptr) + (count * media_ptr -> fx_media_bytes_per_sector),
+                                                    media_ptr -> fx_media_bytes_per_sector);
+                        }
+                        else
+                        {
+
+                            /* Record the sector number and type.  */
+                            sector_list[count] =  cache_entry -> fx_cached_sector;
+                            type_list[count] =    cache_entry -> fx_cached_sector_type;
+                        }
+                        count++;
+                    }
+
+                    /* Move to the next entry.  */
+                    cache_entry =  cache_entry -> fx_cached_sector_next_used;
+                }
+            }
+
+            /* The sector types follow the sector numbers.  */
+            type_list =  (UCHAR *)(sector_list + count);
+        }
+    }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+
+    /* Build the logical sector cache in the new memory.  */
+    status =  _fx_utility_logical_sector_cache_initialize(media_ptr, memory_ptr, memory_size);
+
+    /* Determine if the cache was built successfully.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+    /* Remember the memory supplied for the cache.  */
+    media_ptr -> fx_media_memory_buffer =  (UCHAR *)memory_ptr;
+    media_ptr -> fx_media_memory_size =    memory_size;
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+    /* Only the sectors that were copied to a sector buffer of the new cache are kept.  */
+    if (count > media_ptr -> fx_media_sector_cache_size)
+    {
+        count =  media_ptr -> fx_media_sector_cache_size;
+    }
+
+    /* Each moved sector is in the buffer of the cache entry with the same index. Insert
+       the least recently used sector first, so the most recently used one ends up at the
+       head of the list.  */
+    while (count)
+    {
+
+        count--;
+        cache_entry =  &(media_ptr -> fx_media_sector_cache[count]);
+        cache_entry -> fx_cached_sector =       sector_list[count];
+        cache_entry -> fx_cached_sector_type =  type_list[count];
+        cache_entry -> fx_cached_sector_valid = FX_TRUE;
+        _fx_utility_logical_sector_cache_entry_insert(media_ptr, cache_entry);
+    }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
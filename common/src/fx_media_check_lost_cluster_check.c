@@ -222,6 +222,7 @@ ULONG cached_bitmap_bytes = media_ptr -> fx_media_exfat_bitmap_cache_size_in_sec
 ULONG cached_bitmap_bits = cached_bitmap_bytes << 3;
 ULONG offset = 0;
 UINT status, i;
+UCHAR *bitmap_ptr;
 
     /* This parameter has not been supported yet. */
     FX_PARAMETER_NOT_USED(error_correction_option);
@@ -245,21 +246,29 @@ UINT status, i;
             return(status);
         }
 
+        /* Pickup the cached bitmap.  */
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+        bitmap_ptr = media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_buffer;
+#else
+        bitmap_ptr = media_ptr -> fx_media_exfat_bitmap_cache;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
+
         if (total_clusters >= cached_bitmap_bits)
         {
             total_clusters -= cached_bitmap_bits;
 
             /* Compare cached bitmap with logical_fat. */
-            for (i = 0; i < media_ptr -> fx_media_bytes_per_sector; i++)
+            for (i = 0; i < cached_bitmap_bytes; i++)
             {
-                if (logical_fat[offset + i] != ((UCHAR *)(media_ptr -> fx_media_exfat_bitmap_cache))[i])
+                if (logical_fat[offset + i] != bitmap_ptr[i])
                 {
                     return(FX_LOST_CLUSTER_ERROR);
                 }
-
-                offset += cached_bitmap_bytes;
-                cluster += cached_bitmap_bits;
             }
+
+            /* Move to the next part of the bitmap.  */
+            offset += cached_bitmap_bytes;
+            cluster += cached_bitmap_bits;
         }
         else
         {
@@ -267,7 +276,7 @@ UINT status, i;
             /* Compare cached bitmap with logical_fat. */
             for (i = 0; i < ((total_clusters + 7) >> 3); i++)
             {
-                if (logical_fat[offset + i] != ((UCHAR *)(media_ptr -> fx_media_exfat_bitmap_cache))[i])
+                if (logical_fat[offset + i] != bitmap_ptr[i])
                 {
                     return(FX_LOST_CLUSTER_ERROR);
                 }
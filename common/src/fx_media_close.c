@@ -53,6 +53,9 @@
 /*    Finally, this media control block is removed from the list of       */
 /*    opened media control blocks and is marked as closed.                */
 /*                                                                        */
+/*    If the data in the write buffer of a file cannot be written, it is  */
+/*    discarded, the media is still closed and the error is returned.     */
+/*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    media_ptr                             Media control block pointer   */
@@ -69,11 +72,15 @@
 /*    _fx_utility_FAT_flush                 Flush cached FAT entries      */
 /*    _fx_utility_FAT_map_flush             Flush primary FAT changes to  */
 /*                                            secondary FAT(s)            */
+/*    _fx_utility_FAT_mirror_sync           Mirror deferred FAT sectors   */
+/*    _fx_utility_logical_sector_cache_pool_release                       */
+/*                                          Return cache entries to pool  */
 /*    _fx_utility_logical_sector_flush      Flush logical sector cache    */
 /*    _fx_utility_16_unsigned_read          Read a 16-bit value           */
 /*    _fx_utility_32_unsigned_read          Read a 32-bit value           */
 /*    _fx_utility_32_unsigned_write         Write a 32-bit value          */
 /*    tx_mutex_delete                       Delete protection mutex       */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -101,6 +108,9 @@ ULONG    open_count;
 FX_FILE *file_ptr;
 #endif /* FX_DISABLE_FILE_CLOSE */
 UINT     status;
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+UINT     buffer_status =  FX_SUCCESS;
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
 
 
     /* Check the media to make sure it is open.  */
@@ -127,6 +137,18 @@ UINT     status;
     while (open_count)
     {
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+        /* Write the data gathered in the write buffer of the file. If this fails, the data is
+           discarded and the media is still closed, so the other files and the dirty sectors
+           are not lost. The first such error is returned at the end.  */
+        status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+        if (buffer_status == FX_SUCCESS)
+        {
+            buffer_status =  status;
+        }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
         /* Look at each opened file to see if the same file is opened
            for writing and has been written to.  */
         if ((file_ptr -> fx_file_open_mode == FX_OPEN_FOR_WRITE) &&
@@ -195,6 +217,31 @@ UINT     status;
     /* Flush changed sector(s) in the primary FAT to secondary FATs.  */
     _fx_utility_FAT_map_flush(media_ptr);
 
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+
+    /* Determine if the mirroring of the secondary FATs is deferred.  */
+    if (media_ptr -> fx_media_fat_mirror_deferred)
+    {
+
+        /* Yes, mirror the recorded FAT sectors and clear the record sector.  */
+        status =  _fx_utility_FAT_mirror_sync(media_ptr);
+
+        /* Determine if the mirroring was unsuccessful. */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Release media protection.  */
+            FX_UNPROTECT
+
+            /* Call the media abort routine.  */
+            _fx_media_abort(media_ptr);
+
+            /* Return the error status.  */
+            return(FX_IO_ERROR);
+        }
+    }
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+
 #ifdef FX_ENABLE_EXFAT
     if ((media_ptr -> fx_media_FAT_type == FX_exFAT) &&
         (FX_TRUE == media_ptr -> fx_media_exfat_bitmap_cache_dirty))
@@ -222,6 +269,27 @@ UINT     status;
         return(FX_IO_ERROR);
     }
 
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+
+    /* Determine if the media is attached to a cache pool.  */
+    if (media_ptr -> fx_media_sector_cache_pool)
+    {
+
+        /* Yes, return its cache entries to the pool.  */
+        _fx_utility_logical_sector_cache_pool_release(media_ptr);
+    }
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* While the free clusters have not been counted, the additional information sector
+       reports the free cluster count as unknown.  */
+    if (media_ptr -> fx_media_free_cluster_count_pending)
+    {
+        media_ptr -> fx_media_available_clusters =  0xFFFFFFFF;
+    }
+
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
     /* Determine if the media needs to have the additional information sector updated. This will
        only be the case for 32-bit FATs. The logic here only needs to be done if the last reported
        available cluster count is different that the currently available clusters.  */
@@ -441,7 +509,14 @@ UINT     status;
     FX_UNPROTECT
 #endif
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Return the status of writing the buffered file data to the caller.  */
+    return(buffer_status);
+#else
+
     /* Return success status to the caller.  */
     return(FX_SUCCESS);
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
 }
 
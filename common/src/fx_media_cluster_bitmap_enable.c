@@ -0,0 +1,293 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_cluster_bitmap_enable                     PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function builds the free cluster bitmap of a FAT12/16/32       */
+/*    media in the supplied memory. Each bit represents a cluster,        */
+/*    starting with cluster 2, and is set if the FAT entry of the         */
+/*    cluster is not free. The memory must hold one ULONG for every 32    */
+/*    clusters of the media, plus the bytes needed to align it.           */
+/*                                                                        */
+/*    Once the bitmap is built, it is updated with every FAT entry        */
+/*    written, and cluster allocation searches it instead of the FAT.     */
+/*    The bitmap is used until the media is closed, so this service is    */
+/*    typically called right after fx_media_open. Calling it again        */
+/*    rebuilds the bitmap.                                                */
+/*                                                                        */
+/*    This service requires FX_ENABLE_FAT_CLUSTER_BITMAP, otherwise       */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    memory_ptr                            Pointer to memory for the     */
+/*                                            bitmap                      */
+/*    memory_size                           Size of the memory            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_16_unsigned_read          Read a UINT from memory       */
+/*    _fx_utility_32_unsigned_read          Read a ULONG from memory      */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*    _fx_utility_logical_sector_read       Read a FAT sector             */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_cluster_bitmap_enable(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size)
+{
+
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+ULONG      *bitmap;
+ULONG       words;
+ULONG       bit;
+ULONG       cluster;
+ULONG       FAT_entry;
+ULONG64     FAT_sector;
+ULONG       entry_size;
+ULONG       i;
+ALIGN_TYPE  address;
+UINT        status;
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_FAT_CLUSTER_BITMAP
+
+    FX_PARAMETER_NOT_USED(memory_ptr);
+    FX_PARAMETER_NOT_USED(memory_size);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+#ifdef FX_ENABLE_EXFAT
+
+    /* exFAT media already have an allocation bitmap.  */
+    if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the not available error.  */
+        return(FX_NOT_AVAILABLE);
+    }
+#endif /* FX_ENABLE_EXFAT */
+
+    /* Calculate the number of 32-bit words needed.  */
+    words =  (media_ptr -> fx_media_total_clusters + 31) / 32;
+
+    /* Align the bitmap to a word boundary.  */
+    address =  (ALIGN_TYPE)memory_ptr;
+    address =  (address + (sizeof(ULONG) - 1)) & ~((ALIGN_TYPE)(sizeof(ULONG) - 1));
+
+    /* Determine if the bitmap fits in the supplied memory.  */
+    if ((memory_size < (ULONG)(address - (ALIGN_TYPE)memory_ptr)) ||
+        ((memory_size - (ULONG)(address - (ALIGN_TYPE)memory_ptr)) / sizeof(ULONG) < words))
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the not enough memory error.  */
+        return(FX_NOT_ENOUGH_MEMORY);
+    }
+    bitmap =  (ULONG *)address;
+
+    /* Stop using a previous bitmap while the new one is built.  */
+    media_ptr -> fx_media_cluster_bitmap =  FX_NULL;
+
+    /* Write the cached FAT entries to the FAT sectors, so the sectors are up to date.  */
+    status =  _fx_utility_FAT_flush(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Clear the bitmap.  */
+    for (i = 0; i < words; i++)
+    {
+        bitmap[i] =  0;
+    }
+
+    /* Mark the bits past the last cluster as used, so they are never found free.  */
+    bit =  media_ptr -> fx_media_total_clusters & 31;
+    if (bit)
+    {
+        bitmap[words - 1] =  ((ULONG)0xFFFFFFFF) & ~((((ULONG)1) << bit) - 1);
+    }
+
+    /* Determine what type of FAT is present.  */
+    if (media_ptr -> fx_media_12_bit_FAT)
+    {
+
+        /* A 12-bit FAT is present, entries can span sectors. Utilize the FAT entry
+           read utility to pickup each FAT entry's contents.  */
+        for (cluster = FX_FAT_ENTRY_START; cluster < (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START); cluster++)
+        {
+
+            /* Read a FAT entry.  */
+            status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &FAT_entry);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Determine if the cluster is used.  */
+            if (FAT_entry != FX_FREE_CLUSTER)
+            {
+
+                /* Yes, set its bit.  */
+                bit =  cluster - FX_FAT_ENTRY_START;
+                bitmap[bit >> 5] |=  ((ULONG)1) << (bit & 31);
+            }
+        }
+    }
+    else
+    {
+
+        /* A 16 or 32-bit FAT is present, examine the primary FAT a sector at a time.  */
+        entry_size =  (media_ptr -> fx_media_32_bit_FAT) ? 4 : 2;
+        FAT_sector =  (ULONG64)media_ptr -> fx_media_reserved_sectors;
+        cluster =     0;
+        while (cluster < (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
+        {
+
+            /* Read the next FAT sector.  */
+            status =  _fx_utility_logical_sector_read(media_ptr, FAT_sector,
+                                                      media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Walk through the entries of this sector.  */
+            for (i = 0; (i < media_ptr -> fx_media_bytes_per_sector) &&
+                        (cluster < (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START)); i =  i + entry_size)
+            {
+
+                /* Pickup the FAT entry.  */
+                if (entry_size == 4)
+                {
+                    FAT_entry =  _fx_utility_32_unsigned_read(&(media_ptr -> fx_media_memory_buffer[i])) & 0x0FFFFFFF;
+                }
+                else
+                {
+                    FAT_entry =  _fx_utility_16_unsigned_read(&(media_ptr -> fx_media_memory_buffer[i]));
+                }
+
+                /* Determine if this is a used cluster. The first two entries are reserved.  */
+                if ((cluster >= FX_FAT_ENTRY_START) && (FAT_entry != FX_FREE_CLUSTER))
+                {
+
+                    /* Yes, set its bit.  */
+                    bit =  cluster - FX_FAT_ENTRY_START;
+                    bitmap[bit >> 5] |=  ((ULONG)1) << (bit & 31);
+                }
+
+                /* Move to the next cluster.  */
+                cluster++;
+            }
+
+            /* Move to the next FAT sector.  */
+            FAT_sector++;
+        }
+    }
+
+    /* Start using the bitmap.  */
+    media_ptr -> fx_media_cluster_bitmap_words =  words;
+    media_ptr -> fx_media_cluster_bitmap =        bitmap;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+}
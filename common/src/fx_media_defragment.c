@@ -0,0 +1,442 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_directory.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_defragment                                PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function moves the clusters of the fragmented files of a       */
+/*    FAT12/16/32 media to runs of free clusters, going through the       */
+/*    directory tree in steps. Each call continues where the previous     */
+/*    one stopped and returns once the clusters it moved reach the        */
+/*    budget, or when it has gone through all directories, in which case  */
+/*    FX_NO_MORE_ENTRIES is returned and the next call starts a new       */
+/*    pass. A budget of zero goes through the rest of the pass.           */
+/*                                                                        */
+/*    The data is copied through the scratch memory, or through the       */
+/*    logical sector cache if the scratch memory holds less than one      */
+/*    sector. Files that are open are skipped, fx_file_defragment moves   */
+/*    them. Directories are not moved.                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    scratch_ptr                           Memory to copy the data       */
+/*                                            through                     */
+/*    scratch_size                          Size of the scratch memory    */
+/*    budget                                Number of clusters to move    */
+/*                                            before returning, zero for  */
+/*                                            the whole pass              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_directory_entry_read              Read a directory entry        */
+/*    _fx_utility_FAT_chain_read            Read a run of the FAT chain   */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_utility_FAT_chain_relocate        Move a FAT chain to one run   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_defragment(FX_MEDIA *media_ptr, VOID *scratch_ptr, ULONG scratch_size, ULONG budget)
+{
+
+#ifdef FX_ENABLE_MEDIA_DEFRAGMENT
+UINT          status;
+UINT          setup;
+ULONG         directory_cluster;
+ULONG         directory_entries;
+ULONG         entry_index;
+ULONG         index;
+ULONG         skip_cluster;
+ULONG         cluster;
+ULONG         next_cluster;
+ULONG         run_clusters;
+ULONG         clusters;
+ULONG         clusters_moved;
+ULONG         moved;
+ULONG         open_count;
+FX_FILE      *search_ptr;
+FX_DIR_ENTRY *directory_ptr;
+FX_DIR_ENTRY  directory;
+FX_DIR_ENTRY  entry;
+#endif /* FX_ENABLE_MEDIA_DEFRAGMENT */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_MEDIA_DEFRAGMENT
+
+    FX_PARAMETER_NOT_USED(scratch_ptr);
+    FX_PARAMETER_NOT_USED(scratch_size);
+    FX_PARAMETER_NOT_USED(budget);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Check for write protect at the media level (set by driver).  */
+    if (media_ptr -> fx_media_driver_write_protect)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return write protect error.  */
+        return(FX_WRITE_PROTECT);
+    }
+
+#ifdef FX_ENABLE_EXFAT
+
+    /* Only the FAT chains of FAT12/16/32 media are moved.  */
+    if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the not implemented error.  */
+        return(FX_NOT_IMPLEMENTED);
+    }
+#endif /* FX_ENABLE_EXFAT */
+
+    /* Setup pointers to media name buffers.  */
+    entry.fx_dir_entry_name =      media_ptr -> fx_media_name_buffer + FX_MAX_LONG_NAME_LEN;
+    directory.fx_dir_entry_name =  media_ptr -> fx_media_name_buffer + FX_MAX_LONG_NAME_LEN * 2;
+
+    /* Clear the short name strings.  */
+    entry.fx_dir_entry_short_name[0] =      0;
+    directory.fx_dir_entry_short_name[0] =  0;
+
+    /* The sub-directories scanned are only known by their first cluster.  */
+    directory.fx_dir_entry_name[0] =      0;
+    directory.fx_dir_entry_log_sector =   0;
+    directory.fx_dir_entry_byte_offset =  0;
+
+    /* Pickup where the previous call stopped.  */
+    directory_cluster =  media_ptr -> fx_media_defragment_directory;
+    entry_index =        media_ptr -> fx_media_defragment_entry;
+
+    /* Determine if the previous call stopped in a sub-directory.  */
+    if (directory_cluster)
+    {
+
+        /* Yes, make sure it still is a sub-directory: its first cluster is used and its
+           first entry is its dot entry.  */
+        status =        FX_FILE_CORRUPT;
+        next_cluster =  FX_FREE_CLUSTER;
+        if ((directory_cluster >= FX_FAT_ENTRY_START) && (directory_cluster < media_ptr -> fx_media_fat_reserved))
+        {
+
+            /* Read the FAT entry of the first cluster.  */
+            status =  _fx_utility_FAT_entry_read(media_ptr, directory_cluster, &next_cluster);
+        }
+
+        /* Determine if the first cluster is used.  */
+        if ((status == FX_SUCCESS) && (next_cluster != FX_FREE_CLUSTER))
+        {
+
+            /* Read the first entry of the sub-directory.  */
+            directory.fx_dir_entry_cluster =              directory_cluster;
+            directory.fx_dir_entry_last_search_cluster =  0;
+            index =   0;
+            status =  _fx_directory_entry_read(media_ptr, &directory, &index, &entry);
+        }
+
+        /* Determine if the sub-directory is gone.  */
+        if ((status != FX_SUCCESS) || (next_cluster == FX_FREE_CLUSTER) ||
+            (entry.fx_dir_entry_name[0] != '.') || (entry.fx_dir_entry_name[1] != 0) ||
+            (entry.fx_dir_entry_cluster != directory_cluster))
+        {
+
+            /* Yes, start the pass again from the root directory.  */
+            directory_cluster =  0;
+            entry_index =        0;
+        }
+    }
+
+    /* Go through the directory tree until the budget is used or the pass is complete.  */
+    status =             FX_SUCCESS;
+    setup =              FX_TRUE;
+    skip_cluster =       0;
+    moved =              0;
+    directory_ptr =      FX_NULL;
+    directory_entries =  0;
+    for (;;)
+    {
+
+        /* Determine if the directory to scan has changed.  */
+        if (setup)
+        {
+
+            /* Determine if it is the root directory.  */
+            setup =  FX_FALSE;
+            if (directory_cluster == 0)
+            {
+
+                /* Yes, its size is the number of entries in the root directory.  */
+                directory_ptr =      FX_NULL;
+                directory_entries =  (ULONG)media_ptr -> fx_media_root_directory_entries;
+            }
+            else
+            {
+
+                /* No, calculate the size of the sub-directory by counting its clusters.  */
+                clusters =  0;
+                cluster =   directory_cluster;
+                while ((cluster >= FX_FAT_ENTRY_START) && (cluster < media_ptr -> fx_media_fat_reserved))
+                {
+
+                    /* Read the run of consecutive clusters from this cluster.  */
+                    status =  _fx_utility_FAT_chain_read(media_ptr, cluster, media_ptr -> fx_media_total_clusters, &run_clusters, &next_cluster);
+
+                    /* Check for a bad status.  */
+                    if (status != FX_SUCCESS)
+                    {
+                        break;
+                    }
+
+                    /* Count the run and move to the next one.  */
+                    clusters =  clusters + run_clusters;
+                    cluster =   next_cluster;
+
+                    /* Check for a chain longer than the media, which can only be a loop.  */
+                    if (clusters > media_ptr -> fx_media_total_clusters)
+                    {
+                        status =  FX_FAT_READ_ERROR;
+                        break;
+                    }
+                }
+
+                /* Check for a bad status.  */
+                if (status != FX_SUCCESS)
+                {
+                    break;
+                }
+
+                /* Now we can calculate the directory size.  */
+                directory.fx_dir_entry_cluster =              directory_cluster;
+                directory.fx_dir_entry_last_search_cluster =  0;
+                directory_ptr =                               &directory;
+                directory_entries =  (ULONG)((((ULONG64)media_ptr -> fx_media_bytes_per_sector) *
+                                              ((ULONG64)media_ptr -> fx_media_sectors_per_cluster) * clusters) /
+                                             (ULONG64)FX_DIR_ENTRY_SIZE);
+            }
+        }
+
+        /* Determine if the end of the directory is reached.  */
+        if (entry_index >= directory_entries)
+        {
+
+            /* Determine if this is the root directory.  */
+            if (directory_ptr == FX_NULL)
+            {
+
+                /* Yes, the pass is complete. The next call starts a new pass.  */
+                directory_cluster =  0;
+                entry_index =        0;
+                status =             FX_NO_MORE_ENTRIES;
+                break;
+            }
+
+            /* Read the dot dot entry of the sub-directory, which holds the first cluster of its parent.  */
+            index =   1;
+            status =  _fx_directory_entry_read(media_ptr, directory_ptr, &index, &entry);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+                break;
+            }
+
+            /* Continue in the parent directory after the entry of this sub-directory.  */
+            skip_cluster =       directory_cluster;
+            directory_cluster =  entry.fx_dir_entry_cluster;
+            entry_index =        0;
+            setup =              FX_TRUE;
+
+            /* The parent may be the FAT32 root directory.  */
+            if ((media_ptr -> fx_media_32_bit_FAT) && (directory_cluster == media_ptr -> fx_media_root_cluster_32))
+            {
+                directory_cluster =  0;
+            }
+            continue;
+        }
+
+        /* Read the next entry of the directory.  */
+        status =  _fx_directory_entry_read(media_ptr, directory_ptr, &entry_index, &entry);
+
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
+            break;
+        }
+
+        /* Determine if the entry ends the directory.  */
+        if ((UCHAR)entry.fx_dir_entry_name[0] == (UCHAR)FX_DIR_ENTRY_DONE)
+        {
+
+            /* Yes, no more entries are used.  */
+            entry_index =  directory_entries;
+            continue;
+        }
+
+        /* Move to the next entry.  */
+        entry_index++;
+
+        /* Skip free entries, the volume label and the dot entries.  */
+        if ((((UCHAR)entry.fx_dir_entry_name[0] == (UCHAR)FX_DIR_ENTRY_FREE) && (entry.fx_dir_entry_short_name[0] == 0)) ||
+            (entry.fx_dir_entry_attributes & FX_VOLUME) ||
+            ((entry.fx_dir_entry_name[0] == '.') &&
+             ((entry.fx_dir_entry_name[1] == 0) || ((entry.fx_dir_entry_name[1] == '.') && (entry.fx_dir_entry_name[2] == 0)))))
+        {
+            continue;
+        }
+
+        /* Determine if the entry of the sub-directory just scanned is still to be found.  */
+        if (skip_cluster)
+        {
+
+            /* Yes, the entries up to it have been scanned already.  */
+            if ((entry.fx_dir_entry_attributes & FX_DIRECTORY) && (entry.fx_dir_entry_cluster == skip_cluster))
+            {
+                skip_cluster =  0;
+            }
+            continue;
+        }
+
+        /* Determine if the entry is a sub-directory.  */
+        if (entry.fx_dir_entry_attributes & FX_DIRECTORY)
+        {
+
+            /* Yes, scan it before the rest of this directory.  */
+            if (entry.fx_dir_entry_cluster >= FX_FAT_ENTRY_START)
+            {
+                directory_cluster =  entry.fx_dir_entry_cluster;
+                entry_index =        0;
+                setup =              FX_TRUE;
+            }
+            continue;
+        }
+
+        /* Search the opened files to see if this file is currently opened.  */
+        open_count =  media_ptr -> fx_media_opened_file_count;
+        search_ptr =  media_ptr -> fx_media_opened_file_list;
+        while (open_count)
+        {
+
+            /* Look at each opened file to see if the same file is opened.  */
+            if ((search_ptr -> fx_file_dir_entry.fx_dir_entry_log_sector == entry.fx_dir_entry_log_sector) &&
+                (search_ptr -> fx_file_dir_entry.fx_dir_entry_byte_offset == entry.fx_dir_entry_byte_offset))
+            {
+                break;
+            }
+
+            /* Adjust the pointer and decrement the search count.  */
+            search_ptr =  search_ptr -> fx_file_opened_next;
+            open_count--;
+        }
+
+        /* Skip the file if it is open.  */
+        if (open_count)
+        {
+            continue;
+        }
+
+        /* Move the clusters of the file if they are fragmented.  */
+        status =  _fx_utility_FAT_chain_relocate(media_ptr, &entry, scratch_ptr, scratch_size, &clusters_moved);
+
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
+            break;
+        }
+
+        /* Determine if the budget is used.  */
+        moved =  moved + clusters_moved;
+        if ((budget) && (moved >= budget))
+        {
+            break;
+        }
+    }
+
+    /* Determine if an error stopped the pass.  */
+    if ((status != FX_SUCCESS) && (status != FX_NO_MORE_ENTRIES))
+    {
+
+        /* Yes, the next call starts a new pass.  */
+        directory_cluster =  0;
+        entry_index =        0;
+    }
+
+    /* Remember where the next call continues.  */
+    media_ptr -> fx_media_defragment_directory =  directory_cluster;
+    media_ptr -> fx_media_defragment_entry =      entry_index;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return the status.  */
+    return(status);
+#endif /* FX_ENABLE_MEDIA_DEFRAGMENT */
+}
@@ -0,0 +1,258 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_EXFAT
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_exfat_bitmap_cache_configure              PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets up the allocation bitmap cache of an opened      */
+/*    exFAT media in the supplied memory, or in the bitmap cache of the   */
+/*    media control block if the memory pointer is FX_NULL. The memory    */
+/*    holds a summary with one bit for each bitmap sector, followed by    */
+/*    as many windows of the given number of bitmap sectors as fit. When  */
+/*    a sector that is not cached is needed, the least recently used      */
+/*    window is written if dirty and reloaded.                            */
+/*                                                                        */
+/*    The dirty windows of the previous cache are written to the media    */
+/*    first. The cache is used until the media is closed, so this         */
+/*    service is typically called right after fx_media_open.              */
+/*                                                                        */
+/*    This service requires FX_ENABLE_EXFAT_BITMAP_WINDOWS, otherwise     */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    memory_ptr                            Pointer to memory for the     */
+/*                                            bitmap cache                */
+/*    memory_size                           Size of the memory            */
+/*    window_sectors                        Number of bitmap sectors in   */
+/*                                            each window                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_flush        Flush exFAT allocation bitmap */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_exfat_bitmap_cache_configure(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size, ULONG window_sectors)
+{
+
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+FX_EXFAT_BITMAP_WINDOW *windows_ptr;
+ULONG                  *summary_ptr;
+UCHAR                  *buffer_ptr;
+ULONG                   bitmap_sectors;
+ULONG                   summary_size;
+ULONG                   window_size;
+ULONG                   available;
+ULONG                   windows;
+ULONG                   i;
+ALIGN_TYPE              address;
+UINT                    status;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+
+    FX_PARAMETER_NOT_USED(memory_ptr);
+    FX_PARAMETER_NOT_USED(memory_size);
+    FX_PARAMETER_NOT_USED(window_sectors);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Only exFAT media have an allocation bitmap.  */
+    if (media_ptr -> fx_media_FAT_type != FX_exFAT)
+    {
+
+        /* Error, return to caller.  */
+        return(FX_NOT_IMPLEMENTED);
+    }
+
+    /* Calculate the number of bitmap sectors.  */
+    bitmap_sectors =  (media_ptr -> fx_media_total_clusters +
+                       (((ULONG)1) << media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift) - 1) >>
+        media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift;
+
+    /* A window does not need more sectors than the bitmap has.  */
+    if (window_sectors > bitmap_sectors)
+    {
+        window_sectors =  bitmap_sectors;
+    }
+
+    /* Determine if the cache of the media control block is used.  */
+    if (memory_ptr == FX_NULL)
+    {
+
+        /* Yes, use its one window without a summary.  */
+        windows_ptr =     &media_ptr -> fx_media_exfat_bitmap_window;
+        summary_ptr =     FX_NULL;
+        buffer_ptr =      media_ptr -> fx_media_exfat_bitmap_cache;
+        windows =         1;
+        window_sectors =  FX_EXFAT_BIT_MAP_NUM_OF_CACHED_SECTORS;
+        summary_size =    0;
+    }
+    else
+    {
+
+        /* Align the memory to a 64-bit boundary.  */
+        address =  (ALIGN_TYPE)memory_ptr;
+        address =  (address + (sizeof(ULONG64) - 1)) & ~((ALIGN_TYPE)(sizeof(ULONG64) - 1));
+
+        /* Calculate the memory left after the alignment.  */
+        if (memory_size < (ULONG)(address - (ALIGN_TYPE)memory_ptr))
+        {
+            available =  0;
+        }
+        else
+        {
+            available =  memory_size - (ULONG)(address - (ALIGN_TYPE)memory_ptr);
+        }
+
+        /* Calculate the size of the summary, one bit for each bitmap sector.  */
+        summary_size =  ((bitmap_sectors + 31) >> 5) * (ULONG)sizeof(ULONG);
+        summary_size =  (summary_size + (ULONG)(sizeof(ULONG64) - 1)) & ~((ULONG)(sizeof(ULONG64) - 1));
+        summary_ptr =   (ULONG *)address;
+
+        /* Calculate the number of windows that fit after the summary.  */
+        window_size =  window_sectors << media_ptr -> fx_media_exfat_bytes_per_sector_shift;
+        if (available < summary_size)
+        {
+            windows =  0;
+        }
+        else
+        {
+            windows =  (available - summary_size) / ((ULONG)sizeof(FX_EXFAT_BITMAP_WINDOW) + window_size);
+        }
+
+        /* Determine if the memory holds at least one window.  */
+        if (windows == 0)
+        {
+
+            /* Return the not enough memory error.  */
+            return(FX_NOT_ENOUGH_MEMORY);
+        }
+
+        /* The windows follow the summary, and their buffers follow the windows.  */
+        windows_ptr =  (FX_EXFAT_BITMAP_WINDOW *)(address + summary_size);
+        buffer_ptr =   (UCHAR *)(windows_ptr + windows);
+    }
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Write the dirty windows of the current bitmap cache to the media.  */
+    status =  _fx_utility_exFAT_bitmap_flush(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Setup the windows of the new bitmap cache, none of them in use.  */
+    window_size =  window_sectors << media_ptr -> fx_media_exfat_bytes_per_sector_shift;
+    for (i = 0; i < windows; i++)
+    {
+        windows_ptr[i].fx_exfat_bitmap_window_buffer =         buffer_ptr + (i * window_size);
+        windows_ptr[i].fx_exfat_bitmap_window_start_cluster =  0;
+        windows_ptr[i].fx_exfat_bitmap_window_end_cluster =    0;
+        windows_ptr[i].fx_exfat_bitmap_window_sectors =        0;
+        windows_ptr[i].fx_exfat_bitmap_window_last_used =      0;
+        windows_ptr[i].fx_exfat_bitmap_window_dirty =          FX_FALSE;
+    }
+
+    /* Clear the summary, no sector is known to be full yet.  */
+    for (i = 0; i < (summary_size / (ULONG)sizeof(ULONG)); i++)
+    {
+        summary_ptr[i] =  0;
+    }
+
+    /* Use the new bitmap cache.  */
+    media_ptr -> fx_media_exfat_bitmap_windows =                windows_ptr;
+    media_ptr -> fx_media_exfat_bitmap_windows_count =          windows;
+    media_ptr -> fx_media_exfat_bitmap_window_current =         windows_ptr;
+    media_ptr -> fx_media_exfat_bitmap_window_clock =           0;
+    media_ptr -> fx_media_exfat_bitmap_summary =                summary_ptr;
+    media_ptr -> fx_media_exfat_bitmap_cache_size_in_sectors =  window_sectors;
+    media_ptr -> fx_media_exfat_bitmap_cache_start_cluster =    0;
+    media_ptr -> fx_media_exfat_bitmap_cache_end_cluster =      0;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
+}
+
+#endif /* FX_ENABLE_EXFAT */
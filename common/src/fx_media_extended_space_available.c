@@ -28,6 +28,7 @@
 #include "fx_api.h"
 #include "fx_system.h"
 #include "fx_media.h"
+#include "fx_utility.h"
 
 
 /**************************************************************************/
@@ -57,7 +58,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    _fx_utility_FAT_free_cluster_count    Count the free clusters       */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -78,6 +79,9 @@ UINT  _fx_media_extended_space_available(FX_MEDIA *media_ptr, ULONG64 *available
 ULONG64 available_bytes;
 ULONG   bytes_per_cluster;
 ULONG   available_clusters;
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+UINT    status;
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
 
 
     /* Check the media to make sure it is open.  */
@@ -94,6 +98,23 @@ ULONG   available_clusters;
     /* Protect against other threads accessing the media.  */
     FX_PROTECT
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* Make sure the free clusters of the media have been counted.  */
+    status =  _fx_utility_FAT_free_cluster_count(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the bad status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+
     /* Pickup the number of free clusters.  */
     available_clusters =  media_ptr -> fx_media_available_clusters;
 
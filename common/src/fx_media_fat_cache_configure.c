@@ -0,0 +1,201 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_fat_cache_configure                       PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the size and the number of ways of the FAT       */
+/*    entry cache of an opened media. The cache is placed in the          */
+/*    supplied memory, or in the FAT cache of the media control block if  */
+/*    the memory pointer is FX_NULL. The entries are divided in sets of   */
+/*    the given number of ways, and the number of sets is the largest     */
+/*    power of 2 that fits. A cluster is cached in the set selected by    */
+/*    its low bits, and each set is kept in least recently used order.    */
+/*                                                                        */
+/*    The dirty entries of the previous cache are written to the media    */
+/*    first. The cache is used until the media is closed, so this         */
+/*    service is typically called right after fx_media_open.              */
+/*                                                                        */
+/*    This service requires FX_ENABLE_CONFIGURABLE_FAT_CACHE, otherwise   */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    memory_ptr                            Pointer to memory for the FAT */
+/*                                            cache                       */
+/*    memory_size                           Size of the memory            */
+/*    ways                                  Number of entries in each set */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_fat_cache_configure(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size, UINT ways)
+{
+
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+FX_FAT_CACHE_ENTRY *cache_ptr;
+ULONG               entries;
+ULONG               sets;
+ULONG               i;
+ALIGN_TYPE          address;
+UINT                status;
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    FX_PARAMETER_NOT_USED(memory_ptr);
+    FX_PARAMETER_NOT_USED(memory_size);
+    FX_PARAMETER_NOT_USED(ways);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Determine if the FAT entry cache of the media control block is used.  */
+    if (memory_ptr == FX_NULL)
+    {
+
+        /* Yes, use all of its entries.  */
+        cache_ptr =  media_ptr -> fx_media_fat_cache;
+        entries =    FX_MAX_FAT_CACHE;
+    }
+    else
+    {
+
+        /* Align the cache to a word boundary.  */
+        address =  (ALIGN_TYPE)memory_ptr;
+        address =  (address + (sizeof(ULONG) - 1)) & ~((ALIGN_TYPE)(sizeof(ULONG) - 1));
+        cache_ptr =  (FX_FAT_CACHE_ENTRY *)address;
+
+        /* Calculate the number of entries that fit in the supplied memory.  */
+        if (memory_size < (ULONG)(address - (ALIGN_TYPE)memory_ptr))
+        {
+            entries =  0;
+        }
+        else
+        {
+            entries =  (memory_size - (ULONG)(address - (ALIGN_TYPE)memory_ptr)) / (ULONG)sizeof(FX_FAT_CACHE_ENTRY);
+        }
+    }
+
+    /* Determine if the memory holds at least one set.  */
+    if (entries < ways)
+    {
+
+        /* Return the not enough memory error.  */
+        return(FX_NOT_ENOUGH_MEMORY);
+    }
+
+    /* Calculate the number of sets, the largest power of 2 that fits.  */
+    sets =  1;
+    while ((sets << 1) <= (entries / ways))
+    {
+        sets =  sets << 1;
+    }
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Write the dirty entries of the current FAT cache to the media.  */
+    status =  _fx_utility_FAT_flush(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Clear the entries of the new FAT cache.  */
+    entries =  sets * ways;
+    for (i = 0; i < entries; i++)
+    {
+
+        /* Clear entry in the FAT cache.  */
+        cache_ptr[i].fx_fat_cache_entry_cluster =  0;
+        cache_ptr[i].fx_fat_cache_entry_value =    0;
+        cache_ptr[i].fx_fat_cache_entry_dirty =    0;
+    }
+
+    /* Use the new FAT cache.  */
+    media_ptr -> fx_media_fat_cache_entries =   cache_ptr;
+    media_ptr -> fx_media_fat_cache_size =      entries;
+    media_ptr -> fx_media_fat_cache_ways =      ways;
+    media_ptr -> fx_media_fat_cache_set_mask =  sets - 1;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+}
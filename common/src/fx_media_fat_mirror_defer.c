@@ -0,0 +1,332 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_fat_mirror_defer                          PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function defers the copy of the primary FAT to the secondary   */
+/*    FATs of an opened media. While mirroring is deferred, a FAT flush   */
+/*    keeps the ranges of written primary FAT sectors and writes them to  */
+/*    the supplied record sector as new FAT sectors are written. The      */
+/*    record sector is an unused reserved sector, or a sector of a file   */
+/*    that the application keeps for the record and does not access       */
+/*    otherwise. The ranges are mirrored and the record cleared when the  */
+/*    media is closed, and with FX_ENABLE_BACKGROUND_WRITEBACK when the   */
+/*    FAT was not written for the given number of polls. An idle poll     */
+/*    count of 0 waits for the close.                                     */
+/*                                                                        */
+/*    Ranges recorded by a previous mount that did not close the media    */
+/*    are mirrored first. A record sector of 0 mirrors the pending        */
+/*    ranges and stops deferring. Deferral always stops when the media    */
+/*    is opened, so this service is typically called right after          */
+/*    fx_media_open.                                                      */
+/*                                                                        */
+/*    This service requires FX_ENABLE_FAT_MIRROR_DEFER, otherwise         */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    record_sector                         Sector for the record, 0 to   */
+/*                                            stop deferring              */
+/*    idle_polls                            Idle polls before mirroring   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*    _fx_utility_FAT_map_flush             Flush primary FAT changes to  */
+/*                                            secondary FAT(s)            */
+/*    _fx_utility_FAT_map_set               Mark written FAT sectors      */
+/*    _fx_utility_FAT_mirror_sync           Mirror deferred FAT sectors   */
+/*    _fx_utility_logical_sector_flush      Flush and invalidate record   */
+/*                                            sector in the cache         */
+/*    _fx_utility_32_unsigned_read          Read a ULONG from buffer      */
+/*    I/O Driver                                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_fat_mirror_defer(FX_MEDIA *media_ptr, ULONG record_sector, ULONG idle_polls)
+{
+
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+UCHAR *buffer_ptr;
+ULONG  FAT_start;
+ULONG  start, end;
+ULONG  ranges;
+ULONG  i;
+UINT   status;
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_FAT_MIRROR_DEFER
+
+    FX_PARAMETER_NOT_USED(record_sector);
+    FX_PARAMETER_NOT_USED(idle_polls);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+#ifdef FX_ENABLE_EXFAT
+
+    /* exFAT media keep a single FAT.  */
+    if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+    {
+
+        /* Error, return to caller.  */
+        return(FX_NOT_IMPLEMENTED);
+    }
+#endif /* FX_ENABLE_EXFAT */
+
+    /* Determine if a record sector is supplied.  */
+    if (record_sector)
+    {
+
+        /* The record sector must not be the boot sector, the FAT32 additional information
+           sector, a FAT sector or a sector of the FAT12/16 root directory, so below the data
+           sectors only spare reserved sectors are allowed.  */
+        if ((record_sector >= media_ptr -> fx_media_total_sectors) ||
+            (record_sector == media_ptr -> fx_media_FAT32_additional_info_sector) ||
+            ((record_sector >= media_ptr -> fx_media_reserved_sectors) &&
+             (record_sector < media_ptr -> fx_media_data_sector_start)))
+        {
+
+            /* Return the sector invalid error.  */
+            return(FX_SECTOR_INVALID);
+        }
+
+        /* The record is built in the mirror buffer.  */
+        if (media_ptr -> fx_media_bytes_per_sector > FX_FAT_MIRROR_BUFFER_SIZE)
+        {
+
+            /* Return the not enough memory error.  */
+            return(FX_NOT_ENOUGH_MEMORY);
+        }
+    }
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Check for write protect at the media level (set by driver).  */
+    if (media_ptr -> fx_media_driver_write_protect)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return write protect error.  */
+        return(FX_WRITE_PROTECT);
+    }
+
+    /* Move the written FAT entries to the logical sector cache, which records their FAT sectors.  */
+    status =  _fx_utility_FAT_flush(media_ptr);
+
+    /* Determine if mirroring is deferred already.  */
+    if ((status == FX_SUCCESS) && (media_ptr -> fx_media_fat_mirror_deferred))
+    {
+
+        /* Yes, mirror the FAT sectors of the current record sector and clear it.  */
+        status =  _fx_utility_FAT_mirror_sync(media_ptr);
+    }
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Save the new settings.  */
+    media_ptr -> fx_media_fat_mirror_deferred =       FX_FALSE;
+    media_ptr -> fx_media_fat_mirror_record_sector =  record_sector;
+    media_ptr -> fx_media_fat_mirror_idle_polls =     idle_polls;
+
+    /* Determine if mirroring is to be deferred.  */
+    if (record_sector == 0)
+    {
+
+        /* No, each FAT flush mirrors the written FAT sectors again.  */
+        status =  _fx_utility_FAT_map_flush(media_ptr);
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the status.  */
+        return(status);
+    }
+
+    /* Write out and invalidate any copy of the record sector in the logical sector cache.
+       The record is only read and written directly from now on.  */
+    status =  _fx_utility_logical_sector_flush(media_ptr, (ULONG64) record_sector, ((ULONG64) 1), FX_TRUE);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Do not defer with a record sector that cannot be flushed.  */
+        media_ptr -> fx_media_fat_mirror_record_sector =  0;
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Read the record sector, which lists the ranges not mirrored before the media
+       was last used without being closed.  */
+    buffer_ptr =  (UCHAR *)media_ptr -> fx_media_fat_mirror_buffer;
+    media_ptr -> fx_media_driver_request =          FX_DRIVER_READ;
+    media_ptr -> fx_media_driver_status =           FX_IO_ERROR;
+    media_ptr -> fx_media_driver_buffer =           buffer_ptr;
+    media_ptr -> fx_media_driver_logical_sector =   record_sector;
+    media_ptr -> fx_media_driver_sectors =          1;
+    media_ptr -> fx_media_driver_sector_type =      FX_BOOT_SECTOR;
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+    /* Increment the number of driver read sector(s) requests.  */
+    media_ptr -> fx_media_driver_read_requests++;
+#endif
+
+    /* If trace is enabled, insert this event into the trace buffer.  */
+    FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_IO_DRIVER_READ, media_ptr, record_sector, 1, buffer_ptr, FX_TRACE_INTERNAL_EVENTS, 0, 0)
+
+    /* Invoke the driver to read the record sector.  */
+    (media_ptr -> fx_media_driver_entry) (media_ptr);
+
+    /* Determine if the record sector was read correctly.  */
+    if (media_ptr -> fx_media_driver_status != FX_SUCCESS)
+    {
+
+        /* Do not defer with a record sector that cannot be read.  */
+        media_ptr -> fx_media_fat_mirror_record_sector =  0;
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return the sector IO error status.  */
+        return(FX_IO_ERROR);
+    }
+
+    /* Determine if the sector holds a record.  */
+    FAT_start =  media_ptr -> fx_media_reserved_sectors;
+    if (_fx_utility_32_unsigned_read(&buffer_ptr[0]) == FX_FAT_MIRROR_RECORD_SIGNATURE)
+    {
+
+        /* Yes, add the recorded ranges to the ranges to mirror.  */
+        ranges =  _fx_utility_32_unsigned_read(&buffer_ptr[4]);
+        for (i = 0; (status == FX_SUCCESS) && (i < ranges); i++)
+        {
+
+            /* Pickup the range, unless the record is damaged.  */
+            if (ranges <= (ULONG)((media_ptr -> fx_media_bytes_per_sector - 8) / 8))
+            {
+                start =  _fx_utility_32_unsigned_read(&buffer_ptr[8 + (i * 8)]);
+                end =    _fx_utility_32_unsigned_read(&buffer_ptr[12 + (i * 8)]);
+            }
+            else
+            {
+                start =  0;
+                end =    0;
+            }
+
+            /* Determine if the range is within the FAT.  */
+            if ((start >= end) || (end > media_ptr -> fx_media_sectors_per_FAT))
+            {
+
+                /* No, mirror the whole FAT.  */
+                start =  0;
+                end =    media_ptr -> fx_media_sectors_per_FAT;
+                ranges =  i + 1;
+            }
+
+            /* Add the range.  */
+            status =  _fx_utility_FAT_map_set(media_ptr, FAT_start + start, end - start);
+        }
+    }
+
+    /* Start to defer the mirroring.  */
+    media_ptr -> fx_media_fat_mirror_deferred =  FX_TRUE;
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+    media_ptr -> fx_media_fat_mirror_time =      media_ptr -> fx_media_writeback_clock;
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
+
+    /* Mirror the recorded ranges and any FAT sectors written before, so that the
+       record sector starts clear.  */
+    if (status == FX_SUCCESS)
+    {
+        status =  _fx_utility_FAT_mirror_sync(media_ptr);
+    }
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return the status.  */
+    return(status);
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+}
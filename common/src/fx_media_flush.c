@@ -51,6 +51,9 @@
 /*    flushed.  Finally, the attached driver is sent a flush command so   */
 /*    that it can flush its sector cache (if any) to the media.           */
 /*                                                                        */
+/*    If the data in the write buffer of a file cannot be written, it is  */
+/*    discarded, the media is still flushed and the error is returned.    */
+/*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    media_ptr                             Media control block pointer   */
@@ -68,6 +71,7 @@
 /*    _fx_utility_logical_sector_flush      Flush logical sector cache    */
 /*    _fx_utility_32_unsigned_read          Read 32-bit unsigned          */
 /*    _fx_utility_32_unsigned_write         Write 32-bit unsigned         */
+/*    _fx_file_write_buffer_flush           Write buffered file data      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -88,6 +92,9 @@ UINT  _fx_media_flush(FX_MEDIA  *media_ptr)
 {
 
 UINT     status;
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+UINT     buffer_status =  FX_SUCCESS;
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
 ULONG    open_count;
 FX_FILE *file_ptr;
 FX_INT_SAVE_AREA
@@ -130,6 +137,18 @@ FX_INT_SAVE_AREA
     while (open_count)
     {
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+        /* Write the data gathered in the write buffer of the file. If this fails, the data is
+           discarded and the other files are still flushed. The first such error is returned
+           at the end.  */
+        status =  _fx_file_write_buffer_flush(file_ptr, FX_TRUE);
+        if (buffer_status == FX_SUCCESS)
+        {
+            buffer_status =  status;
+        }
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
+
         /* Look at each opened file to see if the same file is opened
            for writing and has been written to.  */
         if ((file_ptr -> fx_file_open_mode == FX_OPEN_FOR_WRITE) &&
@@ -215,6 +234,16 @@ FX_INT_SAVE_AREA
         return(status);
     }
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* While the free clusters have not been counted, the additional information sector
+       reports the free cluster count as unknown.  */
+    if (media_ptr -> fx_media_free_cluster_count_pending)
+    {
+        media_ptr -> fx_media_available_clusters =  0xFFFFFFFF;
+    }
+
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
     /* Determine if the media needs to have the additional information sector updated. This will
        only be the case for 32-bit FATs. The logic here only needs to be done if the last reported
        available cluster count is different that the currently available clusters.  */
@@ -367,7 +396,14 @@ FX_INT_SAVE_AREA
     /* Release media protection.  */
     FX_UNPROTECT
 
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+
+    /* Return the status of writing the buffered file data to the caller.  */
+    return(buffer_status);
+#else
+
     /* If we get here, return successful status to the caller.  */
     return(FX_SUCCESS);
+#endif /* FX_ENABLE_FILE_WRITE_BUFFER */
 }
 
@@ -106,10 +106,13 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _fx_utility_FAT_free_entries_count    Count free FAT entries        */
 /*    I/O Driver                                                          */
 /*    _fx_utility_exFAT_bitmap_initialize   Initialize exFAT bitmap       */
 /*    _fx_utility_16_unsigned_read          Read 16-bit unsigned value    */
 /*    _fx_utility_32_unsigned_read          Read 32-bit unsigned value    */
+/*    _fx_utility_logical_sector_cache_initialize                         */
+/*                                          Build logical sector cache    */
 /*    _fx_utility_logical_sector_flush      Invalidate log sector cache   */
 /*    _fx_media_boot_info_extract           Extract media information     */
 /*    _fx_utility_FAT_entry_read            Pickup FAT entry contents     */
@@ -145,15 +148,17 @@ UINT  _fx_media_open(FX_MEDIA *media_ptr, CHAR *media_name,
 
 FX_MEDIA_PTR      tail_ptr;
 ULONG             cluster_number;
-ULONG             FAT_entry, FAT_sector, FAT_read_sectors;
-ULONG             i, j;
-#ifndef FX_DISABLE_CACHE
-FX_CACHED_SECTOR *cache_entry_ptr;
-#endif /* FX_DISABLE_CACHE */
+ULONG             FAT_entry;
+ULONG             i;
 UINT              status;
 UINT              additional_info_sector;
+#ifndef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+ULONG             FAT_sector, FAT_read_sectors;
+ULONG             FAT_entries, free_entries, first_free_entry;
+UINT              entry_size;
 UCHAR            *original_memory_ptr;
 ULONG             bytes_in_buffer;
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
 FX_INT_SAVE_AREA
 
 
@@ -185,8 +190,11 @@ FX_INT_SAVE_AREA
     media_ptr -> fx_media_FAT_type =                    0;
 #endif /* FX_DISABLE_FORCE_MEMORY_OPERATION */
 
+#ifndef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
     /* Save the original memory pointer.  */
     original_memory_ptr =  (UCHAR *)memory_ptr;
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
 
 #ifndef FX_MEDIA_STATISTICS_DISABLE
 
@@ -247,6 +255,15 @@ FX_INT_SAVE_AREA
     media_ptr -> fx_media_logical_sector_writes =  0;
     media_ptr -> fx_media_logical_sector_cache_read_hits =  0;
     media_ptr -> fx_media_logical_sector_cache_read_misses =  0;
+    media_ptr -> fx_media_logical_sector_cache_metadata_read_hits =  0;
+    media_ptr -> fx_media_logical_sector_cache_metadata_read_misses =  0;
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+    for (i = 0; i < FX_SECTOR_CACHE_PARTITIONS; i++)
+    {
+        media_ptr -> fx_media_logical_sector_cache_partition_read_hits[i] =    0;
+        media_ptr -> fx_media_logical_sector_cache_partition_read_misses[i] =  0;
+    }
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
     media_ptr -> fx_media_driver_read_requests =  0;
     media_ptr -> fx_media_driver_write_requests =  0;
     media_ptr -> fx_media_driver_boot_read_requests =  0;
@@ -270,6 +287,13 @@ FX_INT_SAVE_AREA
     media_ptr -> fx_media_driver_write_protect =        FX_FALSE;
     media_ptr -> fx_media_driver_free_sector_update =   FX_FALSE;
     media_ptr -> fx_media_driver_data_sector_read =     FX_FALSE;
+#ifdef FX_ENABLE_ASYNC_DRIVER
+    media_ptr -> fx_media_driver_async_supported =      FX_FALSE;
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+    media_ptr -> fx_media_driver_scatter_gather_supported =  FX_FALSE;
+    media_ptr -> fx_media_driver_segments =             0;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
 
     /* If trace is enabled, insert this event into the trace buffer.  */
     FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_IO_DRIVER_INIT, media_ptr, 0, 0, 0, FX_TRACE_INTERNAL_EVENTS, 0, 0)
@@ -285,6 +309,19 @@ FX_INT_SAVE_AREA
         return(FX_IO_ERROR);
     }
 
+#ifdef FX_ENABLE_ASYNC_DRIVER
+
+    /* Place all asynchronous request descriptors on the free list.  */
+    media_ptr -> fx_media_driver_async_free_list =    FX_NULL;
+    for (i = 0; i < FX_ASYNC_DRIVER_QUEUE_DEPTH; i++)
+    {
+        media_ptr -> fx_media_driver_async_requests[i].fx_driver_request_next =  media_ptr -> fx_media_driver_async_free_list;
+        media_ptr -> fx_media_driver_async_free_list =  &(media_ptr -> fx_media_driver_async_requests[i]);
+    }
+    media_ptr -> fx_media_driver_async_outstanding =  0;
+    media_ptr -> fx_media_driver_async_status =       FX_SUCCESS;
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+
 #ifndef FX_MEDIA_STATISTICS_DISABLE
 
     /* Increment the number of driver boot read requests.  */
@@ -362,85 +399,52 @@ FX_INT_SAVE_AREA
         return(FX_BUFFER_ERROR);
     }
 
-#ifndef FX_DISABLE_CACHE
-    /* Determine how many logical sectors can be cached with user's supplied
-       buffer area - there must be at least enough for one sector!  */
-    media_ptr -> fx_media_sector_cache_size =  memory_size / media_ptr -> fx_media_bytes_per_sector;
+    /* Build the logical sector cache in the user's supplied buffer area.  */
+    status =  _fx_utility_logical_sector_cache_initialize(media_ptr, memory_ptr, memory_size);
 
-    /* If trace is enabled, register this object.  */
-    FX_TRACE_OBJECT_REGISTER(FX_TRACE_OBJECT_TYPE_MEDIA, media_ptr, media_name, FX_MAX_FAT_CACHE, media_ptr -> fx_media_sector_cache_size)
-    
-    /* Adjust the internal cache to fit the fixed number of sector cache control blocks
-       built into the media control block.  */
-    if (media_ptr -> fx_media_sector_cache_size > FX_MAX_SECTOR_CACHE)
+    /* Determine if the cache was built.  */
+    if (status != FX_SUCCESS)
     {
 
-        /* Adjust the number of cache sectors downward.  If this is insufficient,
-           the FX_MAX_SECTOR_CACHE constant in FX_API.H must be changed and the FileX
-           library must be rebuilt.  */
-        media_ptr -> fx_media_sector_cache_size =  FX_MAX_SECTOR_CACHE;
-    }
-
-    /* Otherwise, everything is okay.  Initialize the data structures for managing the
-       logical sector cache.  */
-    i =  (UINT)media_ptr -> fx_media_sector_cache_size;
-    cache_entry_ptr =  media_ptr -> fx_media_sector_cache;
-    while (i--)
-    {
+        /* Build the "uninitialize" I/O driver request.  */
+        media_ptr -> fx_media_driver_request =      FX_DRIVER_UNINIT;
+        media_ptr -> fx_media_driver_status =       FX_IO_ERROR;
 
-        /* Initialize each of the cache entries.  */
-        cache_entry_ptr -> fx_cached_sector_memory_buffer =  (UCHAR *)memory_ptr;
-        cache_entry_ptr -> fx_cached_sector =                (~(ULONG64)0);
-        cache_entry_ptr -> fx_cached_sector_buffer_dirty =   FX_FALSE;
-        cache_entry_ptr -> fx_cached_sector_valid =          FX_FALSE;
-        cache_entry_ptr -> fx_cached_sector_next_used =      cache_entry_ptr + 1;
+        /* If trace is enabled, insert this event into the trace buffer.  */
+        FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_IO_DRIVER_UNINIT, media_ptr, 0, 0, 0, FX_TRACE_INTERNAL_EVENTS, 0, 0)
 
-        /* Move to the next cache sector entry.  */
-        cache_entry_ptr++;
+        /* Call the specified I/O driver with the uninitialize request.  */
+        (media_ptr -> fx_media_driver_entry) (media_ptr);
 
-        /* Update the memory pointer to the next buffer slot.  */
-        memory_ptr =  (VOID *)(((UCHAR *)memory_ptr) + media_ptr -> fx_media_bytes_per_sector);
+        /* Return the error status.  */
+        return(status);
     }
 
-    /* Backup to the last cache entry to set its next pointer to NULL.  */
-    cache_entry_ptr--;
-    cache_entry_ptr -> fx_cached_sector_next_used =  FX_NULL;
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
 
-    /* Remember the last memory address used by the caching logic.  */
-    media_ptr -> fx_media_sector_cache_end =  ((UCHAR *)memory_ptr) - 1;
+    /* Setup the default writeback policy of the media.  */
+    media_ptr -> fx_media_writeback_max_age =     FX_WRITEBACK_MAX_AGE;
+    media_ptr -> fx_media_writeback_high_water =  FX_WRITEBACK_HIGH_WATER_PERCENT;
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
 
-    /* Setup the head pointer of the list.  */
-    media_ptr -> fx_media_sector_cache_list_ptr =  media_ptr -> fx_media_sector_cache;
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
 
-    /* Setup the bit map that keeps track of the valid hashed cache logical sectors.  */
-    media_ptr -> fx_media_sector_cache_hashed_sector_valid =  0;
+    /* The free cluster bitmap is not used until it is built again.  */
+    media_ptr -> fx_media_cluster_bitmap =  FX_NULL;
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
 
-    /* Clear the counter of the number of outstanding dirty sectors.  */
-    media_ptr -> fx_media_sector_cache_dirty_count =  0;
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
 
-    /* Determine if the logical sector cache should be managed by the hash function
-       instead of the linear search. The cache must be a power of 2 that is between the
-       minimum and maximum cache size.  */
-    if ((media_ptr -> fx_media_sector_cache_size >= FX_SECTOR_CACHE_HASH_ENABLE) &&
-        ((media_ptr -> fx_media_sector_cache_size ^ (media_ptr -> fx_media_sector_cache_size - 1)) ==
-         (media_ptr -> fx_media_sector_cache_size | (media_ptr -> fx_media_sector_cache_size - 1))))
-    {
-
-
-        /* Set the logical sector cache hash flag. When this flag is set, the logical
-           sector cache is accessed with a hash function instead of a linear search.  */
-        media_ptr -> fx_media_sector_cache_hashed =  FX_TRUE;
-        media_ptr -> fx_media_sector_cache_hash_mask =
-            ((media_ptr -> fx_media_sector_cache_size / FX_SECTOR_CACHE_DEPTH) - 1);
-    }
-    else
-    {
+    /* Use the FAT entry cache of the media control block until it is configured again.  */
+    media_ptr -> fx_media_fat_cache_entries =   media_ptr -> fx_media_fat_cache;
+    media_ptr -> fx_media_fat_cache_size =      FX_MAX_FAT_CACHE;
+    media_ptr -> fx_media_fat_cache_ways =      FX_FAT_CACHE_DEPTH;
+    media_ptr -> fx_media_fat_cache_set_mask =  FX_FAT_CACHE_HASH_MASK;
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
 
-        /* Clear the logical sector cache flag.  */
-        media_ptr -> fx_media_sector_cache_hashed =  FX_FALSE;
-    }
-#else
-    media_ptr -> fx_media_memory_buffer = memory_ptr;
+#ifndef FX_DISABLE_CACHE
+    /* If trace is enabled, register this object.  */
+    FX_TRACE_OBJECT_REGISTER(FX_TRACE_OBJECT_TYPE_MEDIA, media_ptr, media_name, FX_MAX_FAT_CACHE, media_ptr -> fx_media_sector_cache_size)
 #endif /* FX_DISABLE_CACHE */
 
 #ifndef FX_DISABLE_FORCE_MEMORY_OPERATION
@@ -463,6 +467,20 @@ FX_INT_SAVE_AREA
     }
 #endif /* FX_DISABLE_FORCE_MEMORY_OPERATION */
 
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+
+    /* No FAT sectors need to be mirrored yet.  */
+    media_ptr -> fx_media_fat_mirror_ranges =  0;
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+
+    /* The secondary FATs are mirrored on each FAT flush until fx_media_fat_mirror_defer is called.  */
+    media_ptr -> fx_media_fat_mirror_record_sector =  0;
+    media_ptr -> fx_media_fat_mirror_idle_polls =     0;
+    media_ptr -> fx_media_fat_mirror_time =           0;
+    media_ptr -> fx_media_fat_mirror_deferred =       FX_FALSE;
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+
 #ifdef FX_ENABLE_EXFAT
     if (media_ptr -> fx_media_FAT_type != FX_exFAT)
     {
@@ -638,6 +656,19 @@ FX_INT_SAVE_AREA
     media_ptr -> fx_media_cluster_search_start =  0;
 #endif /* FX_DISABLE_FORCE_MEMORY_OPERATION */
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* Assume the free clusters are counted when they are first needed.  */
+    media_ptr -> fx_media_free_cluster_count_pending =  FX_TRUE;
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+
+#ifdef FX_ENABLE_MEDIA_DEFRAGMENT
+
+    /* The first defragment pass starts at the root directory.  */
+    media_ptr -> fx_media_defragment_directory =  0;
+    media_ptr -> fx_media_defragment_entry =      0;
+#endif /* FX_ENABLE_MEDIA_DEFRAGMENT */
+
     /* Determine if there is 32-bit FAT additional information sector. */
     if (media_ptr -> fx_media_FAT32_additional_info_sector)
     {
@@ -727,6 +758,14 @@ FX_INT_SAVE_AREA
 
                         /* We don't invalidate the additional info sector here because only the data is bad.  */
                     }
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+                    else
+                    {
+
+                        /* The count of the additional information sector is used as it is.  */
+                        media_ptr -> fx_media_free_cluster_count_pending =  FX_FALSE;
+                    }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
                 }
                 else
                 {
@@ -750,6 +789,8 @@ FX_INT_SAVE_AREA
         }
     }
 
+#ifndef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
     /* Search the media to find the first available cluster as well as the total
        available clusters.  */
 
@@ -884,67 +925,50 @@ FX_INT_SAVE_AREA
             /* Calculate the number of bytes in the buffer.  */
             bytes_in_buffer =  (media_ptr -> fx_media_bytes_per_sector * FAT_read_sectors);
 
-            /* Walk through the sector cache memory to search for available clusters and the first
-               available if not already found.  */
-            for (j = 0; j < bytes_in_buffer;)
-            {
-
-                /* Check for a 32-bit FAT.  */
-                if (media_ptr -> fx_media_32_bit_FAT)
-                {
-
-                    /* Pickup 32-bit FAT entry.  */
-                    FAT_entry =  *((ULONG *)&(media_ptr -> fx_media_memory_buffer[j]));
-
-                    /* Advance to next FAT entry.  */
-                    j = j + 4;
-                }
-                else
-                {
-
-                    /* Process a 16-bit FAT entry.  */
-                    FAT_entry =  (((ULONG)(media_ptr -> fx_media_memory_buffer[j])) & 0xFF) |
-                        ((((ULONG)(media_ptr -> fx_media_memory_buffer[j + 1])) & 0xFF) << 8);
+            /* Calculate the number of FAT entries in the buffer.  */
+            entry_size =   (media_ptr -> fx_media_32_bit_FAT) ? 4 : 2;
+            FAT_entries =  bytes_in_buffer / entry_size;
 
-                    /* Advance to next FAT entry.  */
-                    j =  j + 2;
-                }
-
-                /* Determine if the FAT entry is free.  */
-                if (FAT_entry == FX_FREE_CLUSTER)
-                {
-
-                    /* Entry is free, increment available clusters.  */
-                    media_ptr -> fx_media_available_clusters++;
-
-                    /* Determine if the starting free cluster has been found yet.  */
-                    if (media_ptr -> fx_media_cluster_search_start == 0)
-                    {
+            /* Determine if the buffer reaches the last FAT entry.  */
+            if (FAT_entries >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START - cluster_number))
+            {
 
-                        /* Remember the first free cluster to start further searches from.  */
-                        media_ptr -> fx_media_cluster_search_start =  cluster_number;
-                    }
-                }
+                /* Yes, only examine the FAT entries up to the last one.  */
+                FAT_entries =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START - cluster_number;
 
-                /* Increment the cluster number.  */
-                cluster_number++;
+                /* Ensure that the outer loop terminates as well.  */
+                i = media_ptr -> fx_media_sectors_per_FAT;
+            }
 
-                /* Determine if we have reviewed all FAT entries.  */
-                if (cluster_number >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
-                {
+            /* Count the available clusters in the sector cache memory and find the first
+               available if not already found.  */
+            free_entries =  _fx_utility_FAT_free_entries_count(media_ptr -> fx_media_memory_buffer, FAT_entries, entry_size, &first_free_entry);
+            media_ptr -> fx_media_available_clusters =  media_ptr -> fx_media_available_clusters + free_entries;
 
-                    /* Yes, we have looked at all the FAT entries.  */
+            /* Determine if the starting free cluster has been found yet.  */
+            if ((free_entries) && (media_ptr -> fx_media_cluster_search_start == 0))
+            {
 
-                    /* Ensure that the outer loop terminates as well.  */
-                    i = media_ptr -> fx_media_sectors_per_FAT;
-                    break;
-                }
+                /* Remember the first free cluster to start further searches from.  */
+                media_ptr -> fx_media_cluster_search_start =  cluster_number + first_free_entry;
             }
+
+            /* Move to the cluster of the next FAT entry.  */
+            cluster_number =  cluster_number + FAT_entries;
         }
     }
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
 #ifdef FX_ENABLE_EXFAT
-    else if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+#ifndef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+    else
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+    if (media_ptr -> fx_media_FAT_type == FX_exFAT)
     {
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+        /* The allocation bitmap of exFAT is examined now.  */
+        media_ptr -> fx_media_free_cluster_count_pending =  FX_FALSE;
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
         status = _fx_utility_exFAT_bitmap_initialize(media_ptr);
 
         if ((FX_SUCCESS         != status)  &&
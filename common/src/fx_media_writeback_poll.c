@@ -0,0 +1,399 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_writeback_poll                            PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function advances the writeback clock of the media and writes  */
+/*    out the changes that are due according to the writeback policy of   */
+/*    the media. First, changes held in the FAT cache for at least the    */
+/*    maximum age are moved to the logical sector cache, and the FAT and  */
+/*    directory sectors that are dirty are written out with them. Then    */
+/*    every dirty sector that was first written at least the maximum age  */
+/*    ago is written out.                                                 */
+/*                                                                        */
+/*    Finally, if more than the high-water percentage of the cache is     */
+/*    still dirty, the oldest dirty sectors are written out until half    */
+/*    of that percentage is left. Writing the changes out in small steps  */
+/*    between the requests of the application keeps them from piling up   */
+/*    until a replacement or a flush has to write many sectors at once.   */
+/*                                                                        */
+/*    Unless FX_SINGLE_THREAD is defined, this function is called by the  */
+/*    FileX writeback thread for every opened media. Otherwise the        */
+/*    application calls it periodically.                                  */
+/*                                                                        */
+/*    This service requires FX_ENABLE_BACKGROUND_WRITEBACK, otherwise     */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_flush        Flush exFAT allocation bitmap */
+/*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*    _fx_utility_FAT_map_flush             Flush primary FAT changes to  */
+/*                                            secondary FAT(s)            */
+/*    _fx_utility_FAT_mirror_sync           Mirror deferred FAT sectors   */
+/*    _fx_utility_logical_sector_flush      Flush logical sector          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*    _fx_system_writeback_thread_entry     FileX writeback thread        */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_writeback_poll(FX_MEDIA *media_ptr)
+{
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+FX_CACHED_SECTOR   *cache_entry;
+FX_CACHED_SECTOR   *oldest_entry;
+ULONG               cache_size;
+ULONG               clock;
+ULONG               max_age;
+ULONG               age;
+ULONG               oldest_age;
+ULONG               high_water;
+ULONG               low_water;
+ULONG               i;
+FX_FAT_CACHE_ENTRY *fat_cache_ptr;
+ULONG               fat_cache_size;
+UINT                fat_pending;
+UINT                system_sectors;
+UINT                status;
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_BACKGROUND_WRITEBACK
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Check for write protect at the media level (set by driver).  */
+    if (media_ptr -> fx_media_driver_write_protect)
+    {
+
+        /* Release media protection.  */
+        FX_UNPROTECT
+
+        /* Return write protect error.  */
+        return(FX_WRITE_PROTECT);
+    }
+
+    /* Advance the writeback clock, ages are counted in polls of the media.  */
+    media_ptr -> fx_media_writeback_clock++;
+    clock =    media_ptr -> fx_media_writeback_clock;
+    max_age =  media_ptr -> fx_media_writeback_max_age;
+
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    /* Pickup the FAT cache in use.  */
+    fat_cache_ptr =   media_ptr -> fx_media_fat_cache_entries;
+    fat_cache_size =  media_ptr -> fx_media_fat_cache_size;
+#else
+
+    /* Pickup the FAT cache of the media.  */
+    fat_cache_ptr =   media_ptr -> fx_media_fat_cache;
+    fat_cache_size =  FX_MAX_FAT_CACHE;
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+
+    /* Determine if the FAT cache holds changes.  */
+    fat_pending =  FX_FALSE;
+    for (i = 0; i < fat_cache_size; i++)
+    {
+        if (fat_cache_ptr[i].fx_fat_cache_entry_dirty)
+        {
+            fat_pending =  FX_TRUE;
+            break;
+        }
+    }
+
+    /* Determine if primary FAT sectors still have to be copied to the secondary FATs.  */
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+    if ((media_ptr -> fx_media_fat_mirror_ranges) && (media_ptr -> fx_media_fat_mirror_deferred == FX_FALSE))
+#else
+    if (media_ptr -> fx_media_fat_mirror_ranges)
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+    {
+        fat_pending =  FX_TRUE;
+    }
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+    for (i = 0; (fat_pending == FX_FALSE) && (i < FX_FAT_MAP_SIZE); i++)
+    {
+        if (media_ptr -> fx_media_fat_secondary_update_map[i])
+        {
+            fat_pending =  FX_TRUE;
+        }
+    }
+
+#ifdef FX_ENABLE_EXFAT
+
+    /* Determine if the exFAT allocation bitmap cache holds changes.  */
+    if ((media_ptr -> fx_media_FAT_type == FX_exFAT) &&
+        (media_ptr -> fx_media_exfat_bitmap_cache_dirty))
+    {
+        fat_pending =  FX_TRUE;
+    }
+#endif /* FX_ENABLE_EXFAT */
+
+    /* Determine if the FAT changes have reached the maximum age.  */
+    system_sectors =  FX_FALSE;
+    if (fat_pending == FX_FALSE)
+    {
+
+        /* Nothing to age.  */
+        media_ptr -> fx_media_writeback_fat_pending =  FX_FALSE;
+    }
+    else if (media_ptr -> fx_media_writeback_fat_pending == FX_FALSE)
+    {
+
+        /* The changes are new, remember when they were seen first.  */
+        media_ptr -> fx_media_writeback_fat_pending =  FX_TRUE;
+        media_ptr -> fx_media_writeback_fat_time =     clock;
+    }
+    else if ((max_age) && ((clock - media_ptr -> fx_media_writeback_fat_time) >= max_age))
+    {
+
+        /* Yes, move the written FAT entries to the logical sector cache.  */
+        status =  _fx_utility_FAT_flush(media_ptr);
+
+        /* Copy the changed primary FAT sectors to the secondary FATs.  */
+        if (status == FX_SUCCESS)
+        {
+            status =  _fx_utility_FAT_map_flush(media_ptr);
+        }
+
+#ifdef FX_ENABLE_EXFAT
+
+        /* Move the allocation bitmap changes to the logical sector cache.  */
+        if ((status == FX_SUCCESS) &&
+            (media_ptr -> fx_media_FAT_type == FX_exFAT) &&
+            (media_ptr -> fx_media_exfat_bitmap_cache_dirty))
+        {
+            status =  _fx_utility_exFAT_bitmap_flush(media_ptr);
+        }
+#endif /* FX_ENABLE_EXFAT */
+
+        /* Check for a good status.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Release media protection.  */
+            FX_UNPROTECT
+
+            /* Return the error status.  */
+            return(status);
+        }
+
+        /* The FAT changes are now in the sector cache, write the system sectors out with them.  */
+        media_ptr -> fx_media_writeback_fat_pending =  FX_FALSE;
+        system_sectors =  FX_TRUE;
+    }
+
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+
+    /* Determine if the deferred FAT sectors have not been written for the idle polls.  */
+    if ((media_ptr -> fx_media_fat_mirror_deferred) &&
+        (media_ptr -> fx_media_fat_mirror_ranges) &&
+        (media_ptr -> fx_media_fat_mirror_idle_polls) &&
+        ((clock - media_ptr -> fx_media_fat_mirror_time) >= media_ptr -> fx_media_fat_mirror_idle_polls))
+    {
+
+        /* Yes, mirror them and clear the record sector.  */
+        status =  _fx_utility_FAT_mirror_sync(media_ptr);
+
+        /* Check for a good status.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Release media protection.  */
+            FX_UNPROTECT
+
+            /* Return the error status.  */
+            return(status);
+        }
+    }
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+
+    /* Determine if any sector could be due.  */
+    if ((max_age) || (system_sectors))
+    {
+
+        /* Examine every cache entry of the media.  */
+        cache_entry =  media_ptr -> fx_media_sector_cache;
+        cache_size =   media_ptr -> fx_media_sector_cache_size;
+        while ((cache_size) && (media_ptr -> fx_media_sector_cache_dirty_count))
+        {
+
+            /* Determine if this entry is a dirty sector of this media.  */
+            if ((cache_entry -> fx_cached_sector_valid) &&
+                (cache_entry -> fx_cached_sector_buffer_dirty) &&
+                (FX_CACHED_SECTOR_OWNED(media_ptr, cache_entry)))
+            {
+
+                /* Determine if the sector is old enough, or is a system sector to write with the FAT changes.  */
+                age =  clock - cache_entry -> fx_cached_sector_dirty_time;
+                if (((max_age) && (age >= max_age)) ||
+                    ((system_sectors) && (cache_entry -> fx_cached_sector_type != FX_DATA_SECTOR)))
+                {
+
+                    /* Yes, write the sector out. It remains valid in the cache.  */
+                    status =  _fx_utility_logical_sector_flush(media_ptr, cache_entry -> fx_cached_sector, ((ULONG64) 1), FX_FALSE);
+
+                    /* Check for a good status.  */
+                    if (status != FX_SUCCESS)
+                    {
+
+                        /* Release media protection.  */
+                        FX_UNPROTECT
+
+                        /* Return the error status.  */
+                        return(status);
+                    }
+                }
+            }
+
+            /* Move to the next cache entry.  */
+            cache_entry++;
+            cache_size--;
+        }
+    }
+
+    /* Pickup the number of cache entries of the media.  */
+    cache_size =  media_ptr -> fx_media_sector_cache_size;
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+    if (media_ptr -> fx_media_sector_cache_pool)
+    {
+        cache_size =  media_ptr -> fx_media_sector_cache_pool_entries;
+    }
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+    /* Calculate the high-water and low-water marks of the dirty sectors.  */
+    high_water =  (cache_size * media_ptr -> fx_media_writeback_high_water) / 100;
+    low_water =   high_water / 2;
+
+    /* Determine if too many sectors are dirty.  */
+    if ((high_water) && (media_ptr -> fx_media_sector_cache_dirty_count >= high_water))
+    {
+
+        /* Yes, write out the oldest dirty sectors until the low-water mark is reached.  */
+        while (media_ptr -> fx_media_sector_cache_dirty_count > low_water)
+        {
+
+            /* Find the dirty sector of the media that was changed first.  */
+            oldest_entry =  FX_NULL;
+            oldest_age =    0;
+            cache_entry =   media_ptr -> fx_media_sector_cache;
+            for (i = 0; i < media_ptr -> fx_media_sector_cache_size; i++)
+            {
+
+                /* Determine if this entry is an older dirty sector of this media.  */
+                if ((cache_entry -> fx_cached_sector_valid) &&
+                    (cache_entry -> fx_cached_sector_buffer_dirty) &&
+                    (FX_CACHED_SECTOR_OWNED(media_ptr, cache_entry)))
+                {
+                    age =  clock - cache_entry -> fx_cached_sector_dirty_time;
+                    if ((oldest_entry == FX_NULL) || (age > oldest_age))
+                    {
+                        oldest_entry =  cache_entry;
+                        oldest_age =    age;
+                    }
+                }
+
+                /* Move to the next cache entry.  */
+                cache_entry++;
+            }
+
+            /* Determine if a dirty sector was found.  */
+            if (oldest_entry == FX_NULL)
+            {
+                break;
+            }
+
+            /* Write the sector out. It remains valid in the cache.  */
+            status =  _fx_utility_logical_sector_flush(media_ptr, oldest_entry -> fx_cached_sector, ((ULONG64) 1), FX_FALSE);
+
+            /* Check for a good status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+
+                /* Return the error status.  */
+                return(status);
+            }
+        }
+    }
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
+}
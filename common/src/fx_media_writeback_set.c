@@ -0,0 +1,117 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Media                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_media.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_media_writeback_set                             PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the background writeback policy of the media.    */
+/*    Dirty sectors are written out once they reach the maximum age,      */
+/*    counted in polls of the media by fx_media_writeback_poll. When      */
+/*    more than the high-water percentage of the logical sector cache is  */
+/*    dirty, the oldest dirty sectors are written out until half of that  */
+/*    percentage is left. A value of zero disables the corresponding      */
+/*    policy.                                                             */
+/*                                                                        */
+/*    This service requires FX_ENABLE_BACKGROUND_WRITEBACK, otherwise     */
+/*    FX_NOT_IMPLEMENTED is returned.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    max_age                               Age in polls after which a    */
+/*                                            dirty sector is written out */
+/*    high_water_percent                    Percentage of the cache that  */
+/*                                            may be dirty                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_media_writeback_set(FX_MEDIA *media_ptr, ULONG max_age, ULONG high_water_percent)
+{
+
+
+    /* Check the media to make sure it is open.  */
+    if (media_ptr -> fx_media_id != FX_MEDIA_ID)
+    {
+
+        /* Return the media not opened error.  */
+        return(FX_MEDIA_NOT_OPEN);
+    }
+
+#ifndef FX_ENABLE_BACKGROUND_WRITEBACK
+
+    FX_PARAMETER_NOT_USED(max_age);
+    FX_PARAMETER_NOT_USED(high_water_percent);
+
+    /* Error, return to caller.  */
+    return(FX_NOT_IMPLEMENTED);
+#else
+
+    /* Protect against other threads accessing the media.  */
+    FX_PROTECT
+
+    /* Setup the new writeback policy, it is applied on the next poll.  */
+    media_ptr -> fx_media_writeback_max_age =     max_age;
+    media_ptr -> fx_media_writeback_high_water =  high_water_percent;
+
+    /* Release media protection.  */
+    FX_UNPROTECT
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
+}
@@ -116,6 +116,10 @@ VOID  _fx_ram_driver(FX_MEDIA *media_ptr)
 UCHAR *source_buffer;
 UCHAR *destination_buffer;
 UINT   bytes_per_sector;
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+ULONG  i;
+FX_DRIVER_SEGMENT *segment_ptr;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
 
 
     /* There are several useful/important pieces of information contained in 
@@ -137,6 +141,8 @@ UINT   bytes_per_sector;
                                                     FX_DRIVER_RELEASE_SECTORS
                                                     FX_DRIVER_BOOT_WRITE
                                                     FX_DRIVER_UNINIT
+                                                    FX_DRIVER_SCATTER_READ
+                                                    FX_DRIVER_GATHER_WRITE
 
         fx_media_driver_status              This value is RETURNED by the driver. 
                                             If the operation is successful, this 
@@ -153,6 +159,14 @@ UINT   bytes_per_sector;
 
         fx_media_driver_sectors             Number of sectors FileX is requesting.
 
+        fx_media_driver_segment_list        List of segments of a scatter-gather 
+                                            request. Each segment holds a logical 
+                                            sector, a number of sectors and a 
+                                            buffer.
+
+        fx_media_driver_segments            Number of segments of a scatter-gather 
+                                            request.
+
 
        The following is a summary of the optional FX_MEDIA structure members:
 
@@ -175,6 +189,12 @@ UINT   bytes_per_sector;
                                             released. This is important for FLASH 
                                             wear-leveling drivers.
 
+        fx_media_driver_scatter_gather_supported
+                                            The DRIVER sets this to FX_TRUE during 
+                                            initialization when it accepts 
+                                            FX_DRIVER_SCATTER_READ and 
+                                            FX_DRIVER_GATHER_WRITE requests.
+
         fx_media_driver_system_write        FileX sets this flag to FX_TRUE if the 
                                             sector being written is a system sector, 
                                             e.g., a boot, FAT, or directory sector. 
@@ -243,6 +263,64 @@ UINT   bytes_per_sector;
         break;
     }
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+    case FX_DRIVER_SCATTER_READ:
+    {
+
+        /* Copy the RAM sectors of each segment into the segment buffer.  */
+        segment_ptr =  media_ptr -> fx_media_driver_segment_list;
+        for (i = 0; i < media_ptr -> fx_media_driver_segments; i++)
+        {
+
+            /* Calculate the RAM disk sector offset of the segment.  */
+            source_buffer =  ((UCHAR *)media_ptr -> fx_media_driver_info) +
+                ((segment_ptr -> fx_driver_segment_logical_sector + 
+                  media_ptr -> fx_media_hidden_sectors) * 
+                 media_ptr -> fx_media_bytes_per_sector);
+
+            /* Copy the RAM sectors into the destination.  */
+            _fx_utility_memory_copy(source_buffer, segment_ptr -> fx_driver_segment_buffer, 
+                                    segment_ptr -> fx_driver_segment_sectors * 
+                                    media_ptr -> fx_media_bytes_per_sector);
+
+            /* Move to the next segment.  */
+            segment_ptr++;
+        }
+
+        /* Successful driver request.  */
+        media_ptr -> fx_media_driver_status =  FX_SUCCESS;
+        break;
+    }
+
+    case FX_DRIVER_GATHER_WRITE:
+    {
+
+        /* Copy the buffer of each segment to its RAM sectors.  */
+        segment_ptr =  media_ptr -> fx_media_driver_segment_list;
+        for (i = 0; i < media_ptr -> fx_media_driver_segments; i++)
+        {
+
+            /* Calculate the RAM disk sector offset of the segment.  */
+            destination_buffer =  ((UCHAR *)media_ptr -> fx_media_driver_info) +
+                ((segment_ptr -> fx_driver_segment_logical_sector + 
+                  media_ptr -> fx_media_hidden_sectors) * 
+                 media_ptr -> fx_media_bytes_per_sector);
+
+            /* Copy the source to the RAM sectors.  */
+            _fx_utility_memory_copy(segment_ptr -> fx_driver_segment_buffer, destination_buffer,
+                                    segment_ptr -> fx_driver_segment_sectors * 
+                                    media_ptr -> fx_media_bytes_per_sector);
+
+            /* Move to the next segment.  */
+            segment_ptr++;
+        }
+
+        /* Successful driver request.  */
+        media_ptr -> fx_media_driver_status =  FX_SUCCESS;
+        break;
+    }
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
+
     case FX_DRIVER_FLUSH:
     {
 
@@ -280,6 +358,13 @@ UINT   bytes_per_sector;
         /* Perform basic initialization here... since the boot record is going
            to be read subsequently and again for volume name requests.  */
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+
+        /* The RAM disk transfers the segments of fragmented reads and writes
+           in one request.  */
+        media_ptr -> fx_media_driver_scatter_gather_supported =  FX_TRUE;
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
+
         /* Successful driver request.  */
         media_ptr -> fx_media_driver_status =  FX_SUCCESS;
         break;
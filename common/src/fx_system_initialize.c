@@ -59,6 +59,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    tx_thread_create                      Create writeback thread       */
 /*    tx_timer_create                       Create system timer           */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -106,6 +107,22 @@ VOID  _fx_system_initialize(VOID)
                     FX_UPDATE_RATE_IN_TICKS, FX_UPDATE_RATE_IN_TICKS, TX_AUTO_ACTIVATE);
 #endif
 
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+#ifndef FX_SINGLE_THREAD
+
+    /* Create the FileX writeback thread.  It writes out the dirty sectors of
+       the opened media every FX_WRITEBACK_INTERVAL_TICKS, so the application
+       threads seldom have to wait for them.  The thread is only created once,
+       even if the system is initialized again.  */
+    if (_fx_system_writeback_thread.tx_thread_id != TX_THREAD_ID)
+    {
+        tx_thread_create(&_fx_system_writeback_thread, "FileX Writeback Thread", _fx_system_writeback_thread_entry,
+                         FX_WRITEBACK_THREAD_ID, _fx_system_writeback_thread_stack, sizeof(_fx_system_writeback_thread_stack),
+                         FX_WRITEBACK_THREAD_PRIORITY, FX_WRITEBACK_THREAD_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+    }
+#endif
+#endif
+
 #ifndef FX_DISABLE_BUILD_OPTIONS
     /* Setup the build options variables.  */
 
@@ -127,6 +144,21 @@ VOID  _fx_system_initialize(VOID)
         _fx_system_build_options_1 =  _fx_system_build_options_1 | (((ULONG)(FX_MAX_LAST_NAME_LEN & 0xFF)) << 24);
     }
 
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+    _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 15);
+#endif
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+    _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 14);
+#endif
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+    _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 13);
+#endif
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+    _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 12);
+#endif
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+    _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 11);
+#endif
 #ifdef FX_NO_TIMER
     _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 10);
 #endif
@@ -142,7 +174,9 @@ VOID  _fx_system_initialize(VOID)
 #ifdef FX_MEDIA_STATISTICS_DISABLE
     _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 6);
 #endif
-
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+    _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 5);
+#endif
 #ifdef FX_SINGLE_OPEN_LEGACY
     _fx_system_build_options_1 = _fx_system_build_options_1 | (((ULONG)1) << 4);
 #endif
@@ -202,6 +236,30 @@ VOID  _fx_system_initialize(VOID)
     {
         _fx_system_build_options_3 =  _fx_system_build_options_3 | ((ULONG)FX_UPDATE_RATE_IN_TICKS);
     }
+#ifdef FX_ENABLE_ASYNC_DRIVER
+    _fx_system_build_options_3 = _fx_system_build_options_3 | (((ULONG)1) << 24);
+#endif
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+    _fx_system_build_options_3 = _fx_system_build_options_3 | (((ULONG)1) << 25);
+#endif
+#ifdef FX_ENABLE_FILE_READ_BORROW
+    _fx_system_build_options_3 = _fx_system_build_options_3 | (((ULONG)1) << 26);
+#endif
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+    _fx_system_build_options_3 = _fx_system_build_options_3 | (((ULONG)1) << 27);
+#endif
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+    _fx_system_build_options_3 = _fx_system_build_options_3 | (((ULONG)1) << 28);
+#endif
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+    _fx_system_build_options_3 = _fx_system_build_options_3 | (((ULONG)1) << 29);
+#endif
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+    _fx_system_build_options_3 = _fx_system_build_options_3 | (((ULONG)1) << 30);
+#endif
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+    _fx_system_build_options_3 = _fx_system_build_options_3 | (((ULONG)1) << 31);
+#endif
 #endif /* FX_DISABLE_BUILD_OPTIONS */
 }
 
@@ -0,0 +1,154 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   System                                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+#include "fx_system.h"
+#include "fx_media.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_system_writeback_thread_entry                   PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is the entry of the FileX writeback thread. Every     */
+/*    FX_WRITEBACK_INTERVAL_TICKS it polls each opened media, which       */
+/*    writes out the dirty sectors that are due according to the          */
+/*    writeback policy of the media. Each media is checked to be still    */
+/*    open once it is protected, so a media closed after it was found in  */
+/*    the opened media list is skipped.                                   */
+/*                                                                        */
+/*    The thread is not present if FX_SINGLE_THREAD is defined.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    id                                    Not used                      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_media_writeback_poll              Write out due dirty sectors   */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Release protection mutex      */
+/*    tx_thread_sleep                       Wait for the next poll        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    ThreadX                                                             */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_system_writeback_thread_entry(ULONG id)
+{
+
+#ifndef FX_SINGLE_THREAD
+FX_MEDIA *media_ptr;
+ULONG     index;
+ULONG     i;
+FX_INT_SAVE_AREA
+
+
+    FX_PARAMETER_NOT_USED(id);
+
+    /* Loop forever.  */
+    while (1)
+    {
+
+        /* Wait for the next poll.  */
+        tx_thread_sleep(FX_WRITEBACK_INTERVAL_TICKS);
+
+        /* Poll each opened media.  */
+        index =  0;
+        while (1)
+        {
+
+            /* Protect against changes of the opened media list.  */
+            FX_DISABLE_INTS
+
+            /* Determine if all opened media have been polled.  */
+            if (index >= _fx_system_media_opened_count)
+            {
+
+                /* Restore interrupts.  */
+                FX_RESTORE_INTS
+                break;
+            }
+
+            /* Find the next media in the opened media list.  */
+            media_ptr =  _fx_system_media_opened_ptr;
+            for (i = 0; i < index; i++)
+            {
+                media_ptr =  media_ptr -> fx_media_opened_next;
+            }
+
+            /* Restore interrupts.  */
+            FX_RESTORE_INTS
+
+            /* Protect against other threads accessing the media.  Closing the media
+               deletes the protection, which makes this call return without it.  */
+            FX_PROTECT
+
+            /* Determine if the media is still open now that it is protected.  */
+            if (media_ptr -> fx_media_id == FX_MEDIA_ID)
+            {
+
+                /* Yes, write out the due dirty sectors of this media.  */
+                _fx_media_writeback_poll(media_ptr);
+
+                /* Release media protection.  */
+                FX_UNPROTECT
+            }
+
+            /* Move to the next media.  */
+            index++;
+        }
+    }
+#else
+
+    FX_PARAMETER_NOT_USED(id);
+#endif /* FX_SINGLE_THREAD */
+}
+
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
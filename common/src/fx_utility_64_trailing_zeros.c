@@ -0,0 +1,101 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_64_trailing_zeros                       PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the number of trailing zero bits of a 64-bit  */
+/*    value, which must not be zero. It is the default of                 */
+/*    FX_TRAILING_ZEROS_64 for compilers without a built-in for it.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    value                                 64-bit value, not zero        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    count                                 Number of trailing zero bits  */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_free_run_find                              */
+/*                                          Find free clusters in bitmap  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_64_trailing_zeros(ULONG64 value)
+{
+
+UINT count;
+
+
+    /* Skip the zero bytes first.  */
+    count =  0;
+    while ((value & ((ULONG64)0xFF)) == 0)
+    {
+        value =  value >> 8;
+        count =  count + 8;
+    }
+
+    /* Now skip the zero bits.  */
+    while ((value & ((ULONG64)1)) == 0)
+    {
+        value =  value >> 1;
+        count++;
+    }
+
+    /* Return the number of trailing zero bits.  */
+    return(count);
+}
+
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
@@ -0,0 +1,195 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+#include "fx_utility.h"
+#ifdef FX_ENABLE_FAULT_TOLERANT
+#include "fx_fault_tolerant.h"
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_bitmap_free_cluster_find            PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function searches the free cluster bitmap of the media for     */
+/*    the next free cluster, starting at the specified cluster and        */
+/*    wrapping around at the end of the media. Words without a clear bit  */
+/*    are skipped as a whole. The FAT entry of the cluster found is read  */
+/*    to make sure it is really free, if it is not, its bit is corrected  */
+/*    and the search continues. Bits are not corrected while a fault      */
+/*    tolerant transaction is started.                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    search_start_cluster                  Cluster number to begin search*/
+/*    free_cluster                          ULONG pointer to store cluster*/
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_create                  Create a directory            */
+/*    _fx_directory_free_search             Search for a free directory   */
+/*                                            entry                       */
+/*    _fx_file_write                        Write to a file               */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_bitmap_free_cluster_find(FX_MEDIA *media_ptr, ULONG search_start_cluster, ULONG *free_cluster)
+{
+
+ULONG *bitmap;
+ULONG  total_bits;
+ULONG  remaining_bits;
+ULONG  examined_bits;
+ULONG  bit;
+ULONG  next_bit;
+ULONG  word;
+ULONG  FAT_value;
+UINT   status;
+
+
+    /* Setup the search.  */
+    bitmap =          media_ptr -> fx_media_cluster_bitmap;
+    total_bits =      media_ptr -> fx_media_total_clusters;
+    remaining_bits =  total_bits;
+
+    /* Start at the search start cluster, or at the first cluster if it is out of range.  */
+    bit =  0;
+    if ((search_start_cluster >= FX_FAT_ENTRY_START) && (search_start_cluster < (total_bits + FX_FAT_ENTRY_START)))
+    {
+        bit =  search_start_cluster - FX_FAT_ENTRY_START;
+    }
+
+    /* Loop until every cluster has been examined once.  */
+    while (remaining_bits)
+    {
+
+        /* Pickup the word of the current bit, and treat the bits before it as used.  */
+        word =  bitmap[bit >> 5] | ((((ULONG)1) << (bit & 31)) - 1);
+
+        /* Determine if the rest of the word is used.  */
+        if ((word & ((ULONG)0xFFFFFFFF)) == ((ULONG)0xFFFFFFFF))
+        {
+
+            /* Yes, move to the start of the next word.  */
+            next_bit =  (bit | 31) + 1;
+            if (next_bit > total_bits)
+            {
+                next_bit =  total_bits;
+            }
+            examined_bits =  next_bit - bit;
+        }
+        else
+        {
+
+            /* Find the first clear bit of the word.  */
+            next_bit =  bit & ~((ULONG)31);
+            while (word & 1)
+            {
+                word =  word >> 1;
+                next_bit++;
+            }
+            examined_bits =  next_bit - bit + 1;
+
+            /* Read the FAT entry of this cluster to make sure it is free.  */
+            status =  _fx_utility_FAT_entry_read(media_ptr, next_bit + FX_FAT_ENTRY_START, &FAT_value);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Determine if the cluster is free.  */
+            if (FAT_value == FX_FREE_CLUSTER)
+            {
+
+                /* Yes, return it.  */
+                *free_cluster =  next_bit + FX_FAT_ENTRY_START;
+                return(FX_SUCCESS);
+            }
+
+            /* The bit was out of date, correct it and continue after this cluster.  While a fault
+               tolerant transaction is started, the FAT entry may only be logged and the transaction
+               may still fail, so the bit is left for the log to update.  */
+#ifdef FX_ENABLE_FAULT_TOLERANT
+            if (!(media_ptr -> fx_media_fault_tolerant_enabled &&
+                  (media_ptr -> fx_media_fault_tolerant_state & FX_FAULT_TOLERANT_STATE_STARTED)))
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+            {
+                bitmap[next_bit >> 5] |=  ((ULONG)1) << (next_bit & 31);
+            }
+            next_bit++;
+        }
+
+        /* Determine if every cluster has been examined.  */
+        if (examined_bits >= remaining_bits)
+        {
+            break;
+        }
+        remaining_bits =  remaining_bits - examined_bits;
+
+        /* Move to the next bit, wrapping to the first cluster at the end of the media.  */
+        bit =  next_bit;
+        if (bit >= total_bits)
+        {
+            bit =  0;
+        }
+    }
+
+    /* No free cluster is left.  */
+    return(FX_NO_MORE_SPACE);
+}
+
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
@@ -0,0 +1,215 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_bitmap_free_run_find                PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function searches the free cluster bitmap of the media for     */
+/*    the first run of the requested number of consecutive free           */
+/*    clusters. Words that are completely used or completely free are     */
+/*    handled as a whole. If there is no run long enough, the longest     */
+/*    run is returned.                                                    */
+/*                                                                        */
+/*    The FAT entries of the clusters returned are read to make sure      */
+/*    they are really free. If one of them is not, its bit is corrected   */
+/*    and the search is repeated.                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    clusters                              Number of consecutive clusters*/
+/*    start_cluster                         ULONG pointer to store first  */
+/*                                            cluster                     */
+/*    run_clusters                          ULONG pointer to store number */
+/*                                            of clusters found, at most  */
+/*                                            clusters                    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_extended_allocate            Allocate space for a file     */
+/*    _fx_file_extended_best_effort_allocate                              */
+/*                                          Allocate space for a file     */
+/*    _fx_utility_FAT_free_run_find         Find a run of free clusters   */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_bitmap_free_run_find(FX_MEDIA *media_ptr, ULONG clusters, ULONG *start_cluster, ULONG *run_clusters)
+{
+
+ULONG *bitmap;
+ULONG  total_bits;
+ULONG  bit;
+ULONG  word;
+ULONG  run_start;
+ULONG  run_length;
+ULONG  best_start;
+ULONG  best_length;
+ULONG  i;
+ULONG  FAT_value;
+UINT   status;
+
+
+    /* Setup the search.  */
+    bitmap =      media_ptr -> fx_media_cluster_bitmap;
+    total_bits =  media_ptr -> fx_media_total_clusters;
+
+    /* Loop until the run found is confirmed by the FAT.  */
+    do
+    {
+
+        /* Search the bitmap from the first cluster.  */
+        run_start =    0;
+        run_length =   0;
+        best_start =   0;
+        best_length =  0;
+        bit =          0;
+        while ((bit < total_bits) && (best_length < clusters))
+        {
+
+            /* Pickup the word of the current bit.  */
+            word =  bitmap[bit >> 5] & ((ULONG)0xFFFFFFFF);
+
+            /* Determine if a whole word can be handled at once.  */
+            if (((bit & 31) == 0) && (word == 0) && ((bit + 32) <= total_bits))
+            {
+
+                /* All 32 clusters are free, extend the current run.  */
+                if (run_length == 0)
+                {
+                    run_start =  bit;
+                }
+                run_length =  run_length + 32;
+                bit =         bit + 32;
+            }
+            else if (((bit & 31) == 0) && (word == ((ULONG)0xFFFFFFFF)))
+            {
+
+                /* All 32 clusters are used, end the current run.  */
+                run_length =  0;
+                bit =         bit + 32;
+            }
+            else
+            {
+
+                /* Examine a single bit.  */
+                if (word & (((ULONG)1) << (bit & 31)))
+                {
+
+                    /* The cluster is used, end the current run.  */
+                    run_length =  0;
+                }
+                else
+                {
+
+                    /* The cluster is free, extend the current run.  */
+                    if (run_length == 0)
+                    {
+                        run_start =  bit;
+                    }
+                    run_length++;
+                }
+                bit++;
+            }
+
+            /* Remember the longest run.  */
+            if (run_length > best_length)
+            {
+                best_start =   run_start;
+                best_length =  run_length;
+            }
+        }
+
+        /* Return no more than the requested number of clusters.  */
+        if (best_length > clusters)
+        {
+            best_length =  clusters;
+        }
+
+        /* Read the FAT entries of the run to make sure the clusters are free.  */
+        for (i = 0; i < best_length; i++)
+        {
+
+            /* Read the FAT entry.  */
+            status =  _fx_utility_FAT_entry_read(media_ptr, best_start + i + FX_FAT_ENTRY_START, &FAT_value);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Determine if the cluster is used.  */
+            if (FAT_value != FX_FREE_CLUSTER)
+            {
+
+                /* Yes, the bit was out of date, correct it and search again.  */
+                bitmap[(best_start + i) >> 5] |=  ((ULONG)1) << ((best_start + i) & 31);
+                break;
+            }
+        }
+    } while (i < best_length);
+
+    /* Return the run found.  */
+    *start_cluster =  best_start + FX_FAT_ENTRY_START;
+    *run_clusters =   best_length;
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
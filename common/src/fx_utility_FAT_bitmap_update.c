@@ -0,0 +1,108 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_bitmap_update                       PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the bit of a cluster in the free cluster      */
+/*    bitmap of the media when its FAT entry is written. The bit is       */
+/*    cleared if the cluster becomes free and set otherwise.              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cluster                               Cluster entry number          */
+/*    next_cluster                          New value of the FAT entry    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_FAT_entry_write           Write a FAT entry             */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_FAT_bitmap_update(FX_MEDIA *media_ptr, ULONG cluster, ULONG next_cluster)
+{
+
+ULONG bit;
+
+
+    /* Determine if the cluster is outside of the bitmap.  */
+    if ((cluster < FX_FAT_ENTRY_START) || (cluster >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START)))
+    {
+
+        /* Yes, nothing to update.  */
+        return;
+    }
+
+    /* Calculate the bit of the cluster.  */
+    bit =  cluster - FX_FAT_ENTRY_START;
+
+    /* Determine if the cluster is released.  */
+    if (next_cluster == FX_FREE_CLUSTER)
+    {
+
+        /* Yes, clear its bit.  */
+        media_ptr -> fx_media_cluster_bitmap[bit >> 5] &=  ~(((ULONG)1) << (bit & 31));
+    }
+    else
+    {
+
+        /* No, the cluster is used, set its bit.  */
+        media_ptr -> fx_media_cluster_bitmap[bit >> 5] |=  ((ULONG)1) << (bit & 31);
+    }
+}
+
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
@@ -0,0 +1,292 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+#ifdef FX_ENABLE_FAULT_TOLERANT
+#include "fx_fault_tolerant.h"
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_chain_read                          PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reads the FAT chain starting at the supplied cluster  */
+/*    and returns the run of consecutive clusters it starts with,         */
+/*    together with the FAT entry of the last cluster of the run. The     */
+/*    FAT entry of the first cluster is read through the FAT entry        */
+/*    cache. The following FAT entries are decoded directly from one FAT  */
+/*    sector, unless the FAT entry cache holds them. 12-bit, 16-bit and   */
+/*    32-bit FAT reading is supported.                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cluster                               First cluster of the run      */
+/*    max_clusters                          Maximum clusters of the run   */
+/*    run_clusters_ptr                      Pointer to the number of      */
+/*                                            consecutive clusters        */
+/*    next_cluster_ptr                      Pointer to the FAT entry of   */
+/*                                            the last cluster of the run */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_16_unsigned_read          Read a UINT from FAT buffer   */
+/*    _fx_utility_32_unsigned_read          Read a ULONG from FAT buffer  */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_utility_logical_sector_read       Read FAT sector into memory   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_entry_read              Directory entry read          */
+/*    _fx_file_extended_seek                Seek to a file position       */
+/*    _fx_file_extent_map_next              Find the next cluster         */
+/*    _fx_file_read                         File read                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_chain_read(FX_MEDIA *media_ptr, ULONG cluster, ULONG max_clusters,
+                                 ULONG *run_clusters_ptr, ULONG *next_cluster_ptr)
+{
+
+ULONG               FAT_sector;
+ULONG               loaded_sector;
+ULONG               byte_offset;
+ULONG               entry;
+ULONG               run_clusters;
+ULONG               ways, i;
+UCHAR              *FAT_ptr;
+UINT                status;
+FX_FAT_CACHE_ENTRY *cache_entry_ptr;
+
+
+    /* Read the FAT entry of the first cluster through the FAT entry cache.  */
+    status =  _fx_utility_FAT_entry_read(media_ptr, cluster, next_cluster_ptr);
+
+    /* Determine if an error occurred.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+    /* The run starts with the first cluster.  */
+    entry =         *next_cluster_ptr;
+    run_clusters =  1;
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+    if (media_ptr -> fx_media_fault_tolerant_enabled &&
+        (media_ptr -> fx_media_fault_tolerant_state & FX_FAULT_TOLERANT_STATE_STARTED))
+    {
+
+        /* FAT entries may be redirected to the log file, so only read one
+           FAT entry at a time.  */
+        max_clusters =  1;
+    }
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+    /* No FAT sector has been read yet. Sector 0 is the boot record and is
+       never a FAT sector.  */
+    loaded_sector =  0;
+
+    /* Loop to extend the run while the FAT entries link consecutive clusters.  */
+    while ((run_clusters < max_clusters) && (entry == cluster + 1) &&
+           (entry < media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
+    {
+
+        /* Move to the next cluster of the run.  */
+        cluster =  entry;
+
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+        /* Build a pointer to the set of the FAT cache for this FAT entry.  */
+        ways =  media_ptr -> fx_media_fat_cache_ways;
+        cache_entry_ptr =  &media_ptr -> fx_media_fat_cache_entries[(cluster & media_ptr -> fx_media_fat_cache_set_mask) * ways];
+#else
+
+        /* Build a pointer to the area of the FAT cache for this FAT entry.  */
+        ways =  FX_FAT_CACHE_DEPTH;
+        cache_entry_ptr =  &media_ptr -> fx_media_fat_cache[(cluster & FX_FAT_CACHE_HASH_MASK) * FX_FAT_CACHE_DEPTH];
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+
+        /* Determine if the FAT entry is in the cache. A cached entry may not
+           have been written to the FAT sector yet.  */
+        for (i = 0; i < ways; i++)
+        {
+            if ((cache_entry_ptr + i) -> fx_fat_cache_entry_cluster == cluster)
+            {
+                break;
+            }
+        }
+
+        /* Was the FAT entry found in the cache?  */
+        if (i < ways)
+        {
+
+            /* Yes, use the cached value.  */
+            entry =  (cache_entry_ptr + i) -> fx_fat_cache_entry_value;
+            run_clusters++;
+            continue;
+        }
+
+        /* Calculate the byte offset to the cluster entry.  */
+        if (media_ptr -> fx_media_12_bit_FAT)
+        {
+            byte_offset =  (((ULONG)cluster << 1) + cluster) >> 1;
+        }
+#ifdef FX_ENABLE_EXFAT
+        else if (FX_FAT16  == media_ptr -> fx_media_FAT_type)
+#else
+        else if (!media_ptr -> fx_media_32_bit_FAT)
+#endif /* FX_ENABLE_EXFAT */
+        {
+            byte_offset =  (((ULONG)cluster) * 2);
+        }
+        else
+        {
+            byte_offset =  (((ULONG)cluster) * 4);
+        }
+
+        /* Calculate the FAT sector the FAT entry resides in and the byte
+           offset into this FAT sector.  */
+        FAT_sector =   (byte_offset / media_ptr -> fx_media_bytes_per_sector) +
+            (ULONG)media_ptr -> fx_media_reserved_sectors;
+        byte_offset =  byte_offset % media_ptr -> fx_media_bytes_per_sector;
+
+        /* Determine if the FAT sector has to be read.  */
+        if (FAT_sector != loaded_sector)
+        {
+
+            /* Only one FAT sector is read for each run.  */
+            if (loaded_sector)
+            {
+                break;
+            }
+
+            /* Read the FAT sector in.  */
+            status =  _fx_utility_logical_sector_read(media_ptr, (ULONG64) FAT_sector,
+                                                      media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            /* Remember the FAT sector in the buffer.  */
+            loaded_sector =  FAT_sector;
+        }
+
+        /* Setup a pointer into the buffer.  */
+        FAT_ptr =  (UCHAR *)media_ptr -> fx_media_memory_buffer + (UINT)byte_offset;
+
+        /* Pickup the FAT entry.  */
+        if (media_ptr -> fx_media_12_bit_FAT)
+        {
+
+            /* A 12-bit FAT entry may span two FAT sectors, end the run there.  */
+            if (byte_offset == (ULONG)(media_ptr -> fx_media_bytes_per_sector - 1))
+            {
+                break;
+            }
+
+            /* Determine if the cluster entry is odd or even.  */
+            if (cluster & 1)
+            {
+                entry =  ((((ULONG)*FAT_ptr) & 0xF0) >> 4) | (((ULONG)*(FAT_ptr + 1)) << 4);
+            }
+            else
+            {
+                entry =  (((ULONG)*FAT_ptr) & 0xFF) | ((((ULONG)*(FAT_ptr + 1)) & 0x0F) << 8);
+            }
+
+            /* Determine if we need to do sign extension on the 12-bit eof value.  */
+            if (entry >= FX_MAX_12BIT_CLUST)
+            {
+
+                /* Yes, we need to sign extend.  */
+                entry =  entry | FX_SIGN_EXTEND;
+            }
+        }
+#ifdef FX_ENABLE_EXFAT
+        else if (FX_FAT16  == media_ptr -> fx_media_FAT_type)
+#else
+        else if (!media_ptr -> fx_media_32_bit_FAT)
+#endif /* FX_ENABLE_EXFAT */
+        {
+            entry =  _fx_utility_16_unsigned_read(FAT_ptr);
+        }
+        else
+        {
+            entry =  _fx_utility_32_unsigned_read(FAT_ptr);
+
+#ifdef FX_ENABLE_EXFAT
+            /* FAT32 uses 28 bit cluster addressing but  exFAT uses 32 bit.  */
+            if (media_ptr -> fx_media_FAT_type == FX_FAT32)
+            {
+#endif /* FX_ENABLE_EXFAT */
+
+                /* Clear upper nibble.  */
+                entry =  entry & 0x0FFFFFFF;
+#ifdef FX_ENABLE_EXFAT
+            }
+#endif /* FX_ENABLE_EXFAT */
+        }
+
+        /* The cluster is part of the run.  */
+        run_clusters++;
+    }
+
+    /* Return the run and the FAT entry of its last cluster.  */
+    *run_clusters_ptr =  run_clusters;
+    *next_cluster_ptr =  entry;
+
+    /* Return success to the caller.  */
+    return(FX_SUCCESS);
+}
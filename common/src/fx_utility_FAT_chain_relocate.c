@@ -0,0 +1,449 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_MEDIA_DEFRAGMENT
+#include "fx_system.h"
+#include "fx_directory.h"
+#include "fx_utility.h"
+#ifdef FX_ENABLE_FAULT_TOLERANT
+#include "fx_fault_tolerant.h"
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_chain_relocate                      PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function moves the clusters of a fragmented file on a          */
+/*    FAT12/16/32 media to one run of free clusters. The data is copied   */
+/*    through the scratch memory, several sectors per request, or         */
+/*    through the logical sector cache one sector at a time if the        */
+/*    scratch memory holds less than one sector. The new chain is linked  */
+/*    and flushed before the directory entry is changed to it, within a   */
+/*    fault tolerant transaction if fault tolerance is enabled, and only  */
+/*    then is the old chain released. A power loss therefore leaves the   */
+/*    file on one of the two chains, and the clusters of the other one    */
+/*    as lost clusters.                                                   */
+/*                                                                        */
+/*    Nothing is moved if the file has no clusters, if its clusters are   */
+/*    already consecutive, or if there is no run of free clusters long    */
+/*    enough.                                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    entry_ptr                             Directory entry of the file   */
+/*    scratch_ptr                           Memory to copy the data       */
+/*                                            through                     */
+/*    scratch_size                          Size of the scratch memory    */
+/*    clusters_moved                        ULONG pointer to store the    */
+/*                                            number of clusters moved    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_directory_entry_write             Write the directory entry     */
+/*    _fx_fault_tolerant_transaction_end    End fault tolerant transaction*/
+/*    _fx_fault_tolerant_transaction_start  Start fault tolerant          */
+/*                                            transaction                 */
+/*    _fx_utility_FAT_chain_read            Read a run of the FAT chain   */
+/*    _fx_utility_FAT_chain_write           Link a run of clusters        */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_utility_FAT_entry_write           Write a FAT entry             */
+/*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*    _fx_utility_FAT_free_run_find         Find a run of free clusters   */
+/*    _fx_utility_FAT_map_flush             Flush primary FAT changes to  */
+/*                                            secondary FAT(s)            */
+/*    _fx_utility_logical_sector_flush      Flush written logical sectors */
+/*    _fx_utility_logical_sector_read       Read a logical sector         */
+/*    _fx_utility_logical_sector_write      Write a logical sector        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_defragment                   Defragment a file             */
+/*    _fx_media_defragment                  Defragment the media          */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_chain_relocate(FX_MEDIA *media_ptr, FX_DIR_ENTRY *entry_ptr, VOID *scratch_ptr, ULONG scratch_size,
+                                      ULONG *clusters_moved)
+{
+
+UINT    status;
+ULONG   cluster;
+ULONG   next_cluster;
+ULONG   run_clusters;
+ULONG   clusters;
+ULONG   runs;
+ULONG   new_cluster;
+ULONG   old_cluster;
+ULONG   scratch_sectors;
+ULONG   sectors;
+ULONG   count;
+ULONG64 source_sector;
+ULONG64 destination_sector;
+
+
+    /* Nothing is moved yet.  */
+    *clusters_moved =  0;
+
+    /* Count the clusters of the file and the runs of consecutive clusters they form.  */
+    clusters =  0;
+    runs =      0;
+    cluster =   entry_ptr -> fx_dir_entry_cluster;
+    while ((cluster >= FX_FAT_ENTRY_START) && (cluster < media_ptr -> fx_media_fat_reserved))
+    {
+
+        /* Read the run of consecutive clusters from this cluster.  */
+        status =  _fx_utility_FAT_chain_read(media_ptr, cluster, media_ptr -> fx_media_total_clusters, &run_clusters, &next_cluster);
+
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the bad status.  */
+            return(status);
+        }
+
+        /* Count the run.  */
+        clusters =  clusters + run_clusters;
+        runs++;
+
+        /* Check for a chain longer than the media, which can only be a loop.  */
+        if (clusters > media_ptr -> fx_media_total_clusters)
+        {
+
+            /* Return the FAT read error.  */
+            return(FX_FAT_READ_ERROR);
+        }
+
+        /* Move to the next run.  */
+        cluster =  next_cluster;
+    }
+
+    /* Determine if the chain ends properly.  */
+    if ((clusters) && (cluster < media_ptr -> fx_media_fat_reserved))
+    {
+
+        /* Return the file corrupt error.  */
+        return(FX_FILE_CORRUPT);
+    }
+
+    /* Determine if the file is fragmented at all.  */
+    if (runs < 2)
+    {
+
+        /* No, there is nothing to move.  */
+        return(FX_SUCCESS);
+    }
+
+    /* Find a run of free clusters for the whole file, searching the whole FAT.  */
+    status =  _fx_utility_FAT_free_run_find(media_ptr, 0, clusters, media_ptr -> fx_media_total_clusters, &new_cluster);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Determine if there is such a run.  */
+    if (new_cluster == 0)
+    {
+
+        /* No, the file stays where it is.  */
+        return(FX_SUCCESS);
+    }
+
+    /* Calculate the number of sectors the scratch memory holds.  */
+    scratch_sectors =  0;
+    if (scratch_ptr)
+    {
+        scratch_sectors =  scratch_size / media_ptr -> fx_media_bytes_per_sector;
+    }
+
+    /* Calculate the first sector of the run.  */
+    destination_sector =  media_ptr -> fx_media_data_sector_start +
+        (((ULONG64)new_cluster - FX_FAT_ENTRY_START) * ((ULONG64)media_ptr -> fx_media_sectors_per_cluster));
+
+    /* Determine if the data is copied through the logical sector cache.  */
+    if (scratch_sectors == 0)
+    {
+
+        /* Yes, make sure the cache holds none of the sectors of the run, since
+           writing a cache buffer to a sector that is cached only marks that
+           sector as written.  */
+        status =  _fx_utility_logical_sector_flush(media_ptr, destination_sector,
+                                                   ((ULONG64)clusters) * ((ULONG64)media_ptr -> fx_media_sectors_per_cluster), FX_TRUE);
+
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the bad status.  */
+            return(status);
+        }
+    }
+
+    /* Copy the data of each run of the file to the run of free clusters.  */
+    cluster =  entry_ptr -> fx_dir_entry_cluster;
+    while ((cluster >= FX_FAT_ENTRY_START) && (cluster < media_ptr -> fx_media_fat_reserved))
+    {
+
+        /* Read the run of consecutive clusters from this cluster.  */
+        status =  _fx_utility_FAT_chain_read(media_ptr, cluster, media_ptr -> fx_media_total_clusters, &run_clusters, &next_cluster);
+
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the bad status.  */
+            return(status);
+        }
+
+        /* Calculate the sectors of the run.  */
+        source_sector =  media_ptr -> fx_media_data_sector_start +
+            (((ULONG64)cluster - FX_FAT_ENTRY_START) * ((ULONG64)media_ptr -> fx_media_sectors_per_cluster));
+        sectors =  run_clusters * media_ptr -> fx_media_sectors_per_cluster;
+
+        /* Copy the sectors of the run.  */
+        while (sectors)
+        {
+
+            /* Determine if the scratch memory is used.  */
+            if (scratch_sectors)
+            {
+
+                /* Yes, copy as many sectors as it holds.  */
+                count =  sectors;
+                if (count > scratch_sectors)
+                {
+                    count =  scratch_sectors;
+                }
+
+                /* Read the sectors directly into the scratch memory.  */
+                status =  _fx_utility_logical_sector_read(media_ptr, source_sector, scratch_ptr, count, FX_DATA_SECTOR);
+
+                /* Check for a good status.  */
+                if (status == FX_SUCCESS)
+                {
+
+                    /* Write them to the run.  */
+                    status =  _fx_utility_logical_sector_write(media_ptr, destination_sector, scratch_ptr, count, FX_DATA_SECTOR);
+                }
+            }
+            else
+            {
+
+                /* No, copy one sector through the logical sector cache.  */
+                count =  1;
+
+                /* Read the sector into the cache.  */
+                status =  _fx_utility_logical_sector_read(media_ptr, source_sector,
+                                                          media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_DATA_SECTOR);
+
+                /* Check for a good status.  */
+                if (status == FX_SUCCESS)
+                {
+
+                    /* Write the cache buffer to the sector of the run, which is not cached.  */
+                    status =  _fx_utility_logical_sector_write(media_ptr, destination_sector,
+                                                               media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_DATA_SECTOR);
+                }
+            }
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Move to the next sectors.  */
+            source_sector =       source_sector + count;
+            destination_sector =  destination_sector + count;
+            sectors =             sectors - count;
+        }
+
+        /* Move to the next run.  */
+        cluster =  next_cluster;
+    }
+
+    /* Link the clusters of the new chain.  */
+    status =  _fx_utility_FAT_chain_write(media_ptr, new_cluster, clusters, media_ptr -> fx_media_fat_last);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Write the new chain to the media before the directory entry points to it.  */
+    status =  _fx_utility_FAT_flush(media_ptr);
+
+    /* Check for a good status.  */
+    if (status == FX_SUCCESS)
+    {
+
+        /* Copy the primary FAT changes to the secondary FAT(s).  */
+        status =  _fx_utility_FAT_map_flush(media_ptr);
+    }
+
+    /* Check for a good status.  */
+    if (status == FX_SUCCESS)
+    {
+
+        /* Write all the written sectors.  */
+        status =  _fx_utility_logical_sector_flush(media_ptr, ((ULONG64) 1), (ULONG64)(media_ptr -> fx_media_total_sectors), FX_FALSE);
+    }
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+
+    /* Start transaction.  */
+    _fx_fault_tolerant_transaction_start(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+    /* Change the directory entry to the new chain.  */
+    old_cluster =  entry_ptr -> fx_dir_entry_cluster;
+    entry_ptr -> fx_dir_entry_cluster =  new_cluster;
+    status =  _fx_directory_entry_write(media_ptr, entry_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+        FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+        /* The file is still on its old chain.  */
+        entry_ptr -> fx_dir_entry_cluster =  old_cluster;
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+
+    /* End transaction.  */
+    status =  _fx_fault_tolerant_transaction_end(media_ptr);
+
+    /* Check for a good status.  */
+    if (status == FX_SUCCESS)
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+    {
+
+        /* Write the directory sector.  */
+        status =  _fx_utility_logical_sector_flush(media_ptr, (ULONG64)(entry_ptr -> fx_dir_entry_log_sector), ((ULONG64) 1), FX_FALSE);
+    }
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Release the clusters of the old chain.  */
+    cluster =  old_cluster;
+    for (count = 0; count < clusters; count++)
+    {
+
+        /* Read the next cluster of the old chain.  */
+        status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &next_cluster);
+
+        /* Check for a good status.  */
+        if (status == FX_SUCCESS)
+        {
+
+            /* Release the cluster.  */
+            status =  _fx_utility_FAT_entry_write(media_ptr, cluster, FX_FREE_CLUSTER);
+        }
+
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the bad status.  */
+            return(status);
+        }
+
+        /* Move to the next cluster.  */
+        cluster =  next_cluster;
+    }
+
+    /* Flush the released FAT entries.  */
+    status =  _fx_utility_FAT_flush(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Return the number of clusters moved.  */
+    *clusters_moved =  clusters;
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_MEDIA_DEFRAGMENT */
@@ -0,0 +1,307 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+#ifdef FX_ENABLE_FAULT_TOLERANT
+#include "fx_fault_tolerant.h"
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_chain_write                         PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function links a run of consecutive clusters in the FAT and    */
+/*    writes the supplied value into the FAT entry of the last cluster    */
+/*    of the run. FAT sectors that only hold links of the run are filled  */
+/*    and written directly, and the FAT sector update map is marked once  */
+/*    for all of them. The other FAT entries are written through the FAT  */
+/*    entry cache.                                                        */
+/*                                                                        */
+/*    12-bit FAT entries, and all FAT entries while fault tolerant is     */
+/*    started, are written one at a time through the FAT entry cache.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cluster                               First cluster of the run      */
+/*    clusters                              Number of clusters of the run */
+/*    last_entry                            FAT entry of the last cluster */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_16_unsigned_write         Write a UINT into buffer      */
+/*    _fx_utility_32_unsigned_write         Write a ULONG into buffer     */
+/*    _fx_utility_FAT_bitmap_update         Update free cluster bitmap    */
+/*    _fx_utility_FAT_entry_write           Write a FAT entry             */
+/*    _fx_utility_FAT_map_set               Mark written FAT sectors      */
+/*    _fx_utility_logical_sector_read       Read FAT sector into memory   */
+/*    _fx_utility_logical_sector_write      Write FAT sector back to disk */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_extended_allocate            Allocate space for a file     */
+/*    _fx_file_extended_best_effort_allocate                              */
+/*                                          Allocate space for a file     */
+/*    _fx_file_write                        Write to a file               */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_chain_write(FX_MEDIA *media_ptr, ULONG cluster, ULONG clusters, ULONG last_entry)
+{
+
+ULONG               last_cluster;
+ULONG               entries_per_sector = 0;
+ULONG               first_full_cluster;
+ULONG               end_full_cluster;
+ULONG               FAT_sector;
+ULONG               first_sector;
+ULONG               cache_size;
+ULONG               i;
+UCHAR              *FAT_ptr;
+UINT                entry_size;
+UINT                status;
+FX_FAT_CACHE_ENTRY *cache_ptr;
+
+
+    /* Calculate the last cluster of the run.  */
+    last_cluster =  cluster + clusters - 1;
+
+    /* Determine the size of a FAT entry. 12-bit FAT entries may span two FAT
+       sectors, so they are always written through the FAT entry cache.  */
+    entry_size =  0;
+#ifdef FX_ENABLE_EXFAT
+    if (media_ptr -> fx_media_FAT_type == FX_FAT16)
+#else
+    if ((!media_ptr -> fx_media_12_bit_FAT) && (!media_ptr -> fx_media_32_bit_FAT))
+#endif /* FX_ENABLE_EXFAT */
+    {
+        entry_size =  2;
+    }
+#ifdef FX_ENABLE_EXFAT
+    else if (media_ptr -> fx_media_FAT_type != FX_FAT12)
+#else
+    else if (media_ptr -> fx_media_32_bit_FAT)
+#endif /* FX_ENABLE_EXFAT */
+    {
+        entry_size =  4;
+    }
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+    if (media_ptr -> fx_media_fault_tolerant_enabled &&
+        (media_ptr -> fx_media_fault_tolerant_state & FX_FAULT_TOLERANT_STATE_STARTED))
+    {
+
+        /* FAT entries are logged and flushed in the order of the FAT chain, so
+           write them one at a time.  */
+        entry_size =  0;
+    }
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+    /* Find the FAT sectors that only hold links of the run.  */
+    first_full_cluster =  last_cluster;
+    end_full_cluster =    last_cluster;
+    if (entry_size)
+    {
+        entries_per_sector =  media_ptr -> fx_media_bytes_per_sector / entry_size;
+        first_full_cluster =  ((cluster + entries_per_sector - 1) / entries_per_sector) * entries_per_sector;
+        end_full_cluster =    (last_cluster / entries_per_sector) * entries_per_sector;
+        if (first_full_cluster >= end_full_cluster)
+        {
+
+            /* No, the run does not fill a FAT sector.  */
+            first_full_cluster =  last_cluster;
+            end_full_cluster =    last_cluster;
+        }
+    }
+
+    /* Link the clusters before the first whole FAT sector through the FAT entry cache.  */
+    for (; cluster < first_full_cluster; cluster++)
+    {
+
+        /* Link the cluster to the next one.  */
+        status =  _fx_utility_FAT_entry_write(media_ptr, cluster, cluster + 1);
+
+        /* Determine if an error occurred.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the error status.  */
+            return(status);
+        }
+    }
+
+    /* Determine if whole FAT sectors are written.  */
+    if (cluster < end_full_cluster)
+    {
+
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+        /* Pickup the FAT cache in use.  */
+        cache_ptr =   media_ptr -> fx_media_fat_cache_entries;
+        cache_size =  media_ptr -> fx_media_fat_cache_size;
+#else
+
+        /* Pickup the FAT cache of the media.  */
+        cache_ptr =   media_ptr -> fx_media_fat_cache;
+        cache_size =  FX_MAX_FAT_CACHE;
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+
+        /* The FAT sectors are written directly, so drop the FAT cache entries
+           of their clusters.  */
+        for (i = 0; i < cache_size; i++)
+        {
+            if ((cache_ptr[i].fx_fat_cache_entry_cluster >= cluster) &&
+                (cache_ptr[i].fx_fat_cache_entry_cluster < end_full_cluster))
+            {
+                cache_ptr[i].fx_fat_cache_entry_cluster =  0;
+                cache_ptr[i].fx_fat_cache_entry_dirty =    0;
+            }
+        }
+
+        /* Calculate the first FAT sector.  */
+        FAT_sector =  (cluster / entries_per_sector) + (ULONG)media_ptr -> fx_media_reserved_sectors;
+        first_sector =  FAT_sector;
+
+        /* Loop to fill the FAT sectors.  */
+        while (cluster < end_full_cluster)
+        {
+
+            /* Read the FAT sector into the memory buffer of the sector cache.  */
+            status =  _fx_utility_logical_sector_read(media_ptr, (ULONG64) FAT_sector,
+                                                      media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            /* Link each cluster of the FAT sector to the next one.  */
+            FAT_ptr =  (UCHAR *)media_ptr -> fx_media_memory_buffer;
+            for (i = 0; i < entries_per_sector; i++)
+            {
+                if (entry_size == 2)
+                {
+                    _fx_utility_16_unsigned_write(FAT_ptr, (UINT)(cluster + 1));
+                }
+                else
+                {
+                    _fx_utility_32_unsigned_write(FAT_ptr, cluster + 1);
+                }
+                FAT_ptr =  FAT_ptr + entry_size;
+
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+
+                /* Keep the free cluster bitmap in sync with the new FAT entry.  */
+                if (media_ptr -> fx_media_cluster_bitmap)
+                {
+                    _fx_utility_FAT_bitmap_update(media_ptr, cluster, cluster + 1);
+                }
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
+                cluster++;
+            }
+
+            /* Write the FAT sector.  */
+            status =  _fx_utility_logical_sector_write(media_ptr, (ULONG64) FAT_sector,
+                                                       media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            /* Move to the next FAT sector.  */
+            FAT_sector++;
+        }
+
+#ifdef FX_ENABLE_EXFAT
+        /* We are not using fx_media_fat_secondary_update_map for exFAT.  */
+        if (media_ptr -> fx_media_FAT_type != FX_exFAT)
+#endif /* FX_ENABLE_EXFAT */
+        {
+
+            /* Mark the whole range of FAT sectors written in the FAT sector update map.  */
+            status =  _fx_utility_FAT_map_set(media_ptr, first_sector, FAT_sector - first_sector);
+
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+        }
+    }
+
+    /* Link the remaining clusters through the FAT entry cache.  */
+    for (; cluster < last_cluster; cluster++)
+    {
+
+        /* Link the cluster to the next one.  */
+        status =  _fx_utility_FAT_entry_write(media_ptr, cluster, cluster + 1);
+
+        /* Determine if an error occurred.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the error status.  */
+            return(status);
+        }
+    }
+
+    /* Write the FAT entry of the last cluster.  */
+    status =  _fx_utility_FAT_entry_write(media_ptr, last_cluster, last_entry);
+
+    /* Return the status.  */
+    return(status);
+}
@@ -64,6 +64,8 @@
 /*    _fx_utility_16_unsigned_read          Read a UINT from FAT buffer   */
 /*    _fx_utility_32_unsigned_read          Read a ULONG form FAT buffer  */
 /*    _fx_utility_FAT_flush                 Flush FAT entry cache         */
+/*    _fx_utility_FAT_sector_flush          Write a FAT sector of the     */
+/*                                            FAT cache                   */
 /*    _fx_utility_logical_sector_read       Read FAT sector into memory   */
 /*    _fx_fault_tolerant_read_FAT           Read FAT entry from log file  */
 /*                                                                        */
@@ -97,6 +99,9 @@ FX_FAT_CACHE_ENTRY *cache_entry_ptr;
 #ifndef FX_DISABLE_FAT_ENTRY_REFRESH
 FX_FAT_CACHE_ENTRY  temp_cache_entry;
 #endif /* FX_DISABLE_FAT_ENTRY_REFRESH */
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+ULONG               ways, i;
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
 
 
 #ifdef FX_ENABLE_FAULT_TOLERANT
@@ -124,6 +129,66 @@ FX_FAT_CACHE_ENTRY  temp_cache_entry;
     /* Extended port-specific processing macro, which is by default defined to white space.  */
     FX_UTILITY_FAT_ENTRY_READ_EXTENSION
 
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    /* Pickup the number of entries in each set of the FAT cache.  */
+    ways =  media_ptr -> fx_media_fat_cache_ways;
+
+    /* Calculate the set of the cache for this FAT entry.  */
+    index =  (UINT)((cluster & media_ptr -> fx_media_fat_cache_set_mask) * ways);
+
+    /* Build a pointer to the first cache entry of the set.  */
+    cache_entry_ptr =  &media_ptr -> fx_media_fat_cache_entries[index];
+
+    /* Determine if the FAT entry is in the set.  */
+    for (i = 0; i < ways; i++)
+    {
+
+        /* Is this the requested FAT entry?  */
+        if (((cache_entry_ptr + i) -> fx_fat_cache_entry_cluster) == cluster)
+        {
+
+            /* Yes, return the cached value.  */
+            *entry_ptr =  (cache_entry_ptr + i) -> fx_fat_cache_entry_value;
+
+#ifndef FX_DISABLE_FAT_ENTRY_REFRESH
+
+            /* Move the entry to the top and the newer entries down, so the set
+               stays in least recently used order.  */
+            if (i)
+            {
+                temp_cache_entry =  *(cache_entry_ptr + i);
+                for (; i > 0; i--)
+                {
+                    *(cache_entry_ptr + i) =  *(cache_entry_ptr + i - 1);
+                }
+                *(cache_entry_ptr) =  temp_cache_entry;
+            }
+#endif /* FX_DISABLE_FAT_ENTRY_REFRESH */
+
+            /* Return a successful status.  */
+            return(FX_SUCCESS);
+        }
+    }
+
+    /* Determine if the oldest entry of the set was modified, i.e. whether or
+       not it is dirty.  */
+    if ((cache_entry_ptr + ways - 1) -> fx_fat_cache_entry_dirty)
+    {
+
+        /* Yes, write out the FAT sector of the entry so it can be replaced.  */
+        status =  _fx_utility_FAT_sector_flush(media_ptr, index + ways - 1);
+
+        /* Check for completion status.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return error status.  */
+            return(status);
+        }
+    }
+#else
+
     /* Calculate the area of the cache for this FAT entry.  */
     index =  (cluster & FX_FAT_CACHE_HASH_MASK) * FX_FAT_CACHE_DEPTH;
 
@@ -218,6 +283,7 @@ FX_FAT_CACHE_ENTRY  temp_cache_entry;
             return(status);
         }
     }
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
 
     /* If we get here, the entry was not found in the FAT entry cache.  We need to
        actually read the FAT entry.  */
@@ -435,10 +501,20 @@ FX_FAT_CACHE_ENTRY  temp_cache_entry;
         *entry_ptr =  entry32;
     }
 
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    /* Move all the entries of the set down so the oldest is replaced.  */
+    for (i = ways - 1; i > 0; i--)
+    {
+        *(cache_entry_ptr + i) =  *(cache_entry_ptr + i - 1);
+    }
+#else
+
     /* Move all the cache entries down so the oldest is at the bottom.  */
     *(cache_entry_ptr + 3) =  *(cache_entry_ptr + 2);
     *(cache_entry_ptr + 2) =  *(cache_entry_ptr + 1);
     *(cache_entry_ptr + 1) =  *(cache_entry_ptr);
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
 
     /* Setup the new FAT entry in the cache.  */
     cache_entry_ptr -> fx_fat_cache_entry_cluster =  cluster;
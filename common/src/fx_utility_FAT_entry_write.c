@@ -62,7 +62,10 @@
 /*                                                                        */
 /*    _fx_utility_FAT_flush                 FLUSH dirty entries in the    */
 /*                                            FAT cache                   */
+/*    _fx_utility_FAT_sector_flush          Write a FAT sector of the     */
+/*                                            FAT cache                   */
 /*    _fx_fault_tolerant_add_fat_log        Add FAT redo log              */
+/*    _fx_utility_FAT_bitmap_update         Update free cluster bitmap    */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -82,8 +85,18 @@ UINT  _fx_utility_FAT_entry_write(FX_MEDIA *media_ptr, ULONG cluster, ULONG next
 
 UINT                status, index, i;
 FX_FAT_CACHE_ENTRY *cache_entry_ptr;
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+UINT                ways;
+#ifndef FX_DISABLE_FAT_ENTRY_REFRESH
+FX_FAT_CACHE_ENTRY  temp_cache_entry;
+#endif /* FX_DISABLE_FAT_ENTRY_REFRESH */
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
 #ifdef FX_ENABLE_FAULT_TOLERANT
 ULONG               FAT_sector;
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
 
     /* While fault_tolerant is enabled, only FAT entries in the same sector are allowed to be cached. */
     /* We must flush FAT sectors in the order of FAT chains. */
@@ -129,6 +142,18 @@ ULONG               FAT_sector;
     }
 #endif /* FX_ENABLE_FAULT_TOLERANT */
 
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+
+    /* Determine if the free cluster bitmap is used.  */
+    if (media_ptr -> fx_media_cluster_bitmap)
+    {
+
+        /* Yes, keep it in sync with the new FAT entry.  An entry that is only logged by a
+           fault tolerant transaction updates the bitmap when the log is applied.  */
+        _fx_utility_FAT_bitmap_update(media_ptr, cluster, next_cluster);
+    }
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
 #ifndef FX_MEDIA_STATISTICS_DISABLE
     /* Increment the number of FAT entry writes and cache hits.  */
     media_ptr -> fx_media_fat_entry_writes++;
@@ -138,6 +163,21 @@ ULONG               FAT_sector;
     /* Extended port-specific processing macro, which is by default defined to white space.  */
     FX_UTILITY_FAT_ENTRY_WRITE_EXTENSION
 
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    /* Pickup the number of entries in each set of the FAT cache.  */
+    ways =  (UINT)media_ptr -> fx_media_fat_cache_ways;
+
+    /* Calculate the set of the cache for this FAT entry.  */
+    index =  (UINT)(cluster & media_ptr -> fx_media_fat_cache_set_mask) * ways;
+
+    /* Build a pointer to the first cache entry of the set.  */
+    cache_entry_ptr =  &media_ptr -> fx_media_fat_cache_entries[index];
+
+    /* First search for the entry in the set.  */
+    for (i = 0; i < ways; i++)
+#else
+
     /* Calculate the area of the cache for this FAT entry.  */
     index =  (cluster & FX_FAT_CACHE_HASH_MASK) * FX_FAT_CACHE_DEPTH;
 
@@ -146,6 +186,7 @@ ULONG               FAT_sector;
 
     /* First search for the entry in the FAT entry cache.  */
     for (i = 0; i < FX_FAT_CACHE_DEPTH; i++)
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
     {
 
         /* See if the entry matches the write request.  */
@@ -157,6 +198,23 @@ ULONG               FAT_sector;
             (cache_entry_ptr + i) -> fx_fat_cache_entry_value =     next_cluster;
             (cache_entry_ptr + i) -> fx_fat_cache_entry_dirty =     1;
 
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+#ifndef FX_DISABLE_FAT_ENTRY_REFRESH
+
+            /* Move the entry to the top and the newer entries down, so the set
+               stays in least recently used order.  */
+            if (i)
+            {
+                temp_cache_entry =  *(cache_entry_ptr + i);
+                for (; i > 0; i--)
+                {
+                    *(cache_entry_ptr + i) =  *(cache_entry_ptr + i - 1);
+                }
+                *(cache_entry_ptr) =  temp_cache_entry;
+            }
+#endif /* FX_DISABLE_FAT_ENTRY_REFRESH */
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+
             /* Determine if the driver has requested notification when data sectors in the media
                become free.  This can be useful to FLASH manager software.  */
             if ((media_ptr -> fx_media_driver_free_sector_update) && (next_cluster == FX_FREE_CLUSTER))
@@ -202,6 +260,32 @@ ULONG               FAT_sector;
     media_ptr -> fx_media_fat_entry_cache_write_misses++;
 #endif
 
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    /* Determine if the oldest entry of the set is dirty and needs to be written.  */
+    if ((cache_entry_ptr + ways - 1) -> fx_fat_cache_entry_dirty == 1)
+    {
+
+        /* Write out the FAT sector of the dirty entry so it can be used to hold
+           the current FAT entry write request.  */
+        status =  _fx_utility_FAT_sector_flush(media_ptr, index + ways - 1);
+
+        /* Determine if the write was successful.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* No, return error status to caller.  */
+            return(status);
+        }
+    }
+
+    /* Move all the entries of the set down so the oldest is replaced.  */
+    for (i = ways - 1; i > 0; i--)
+    {
+        *(cache_entry_ptr + i) =  *(cache_entry_ptr + i - 1);
+    }
+#else
+
     /* Determine if the oldest entry is dirty and needs to be flushed.  */
     if (media_ptr -> fx_media_fat_cache[index + 3].fx_fat_cache_entry_dirty == 1)
     {
@@ -224,6 +308,7 @@ ULONG               FAT_sector;
     *(cache_entry_ptr + 3) =  *(cache_entry_ptr + 2);
     *(cache_entry_ptr + 2) =  *(cache_entry_ptr + 1);
     *(cache_entry_ptr + 1) =  *(cache_entry_ptr);
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
 
     /* Save the current FAT entry write request and mark as dirty.  */
     cache_entry_ptr -> fx_fat_cache_entry_dirty =    1;
@@ -0,0 +1,225 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_free_cluster_count                  PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function counts the free clusters of a FAT12/16/32 media and   */
+/*    finds the first free cluster, if this has not been done since the   */
+/*    media was opened. The count is left for later by fx_media_open      */
+/*    when the FAT32 additional information sector does not supply it,    */
+/*    so the time to open the media does not depend on the size of the    */
+/*    FAT.                                                                */
+/*                                                                        */
+/*    The function is called before the number of available clusters is   */
+/*    used. It returns immediately once the clusters are counted.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_utility_FAT_flush                 Flush written FAT entries     */
+/*    _fx_utility_FAT_free_entries_count    Count free FAT entries        */
+/*    _fx_utility_logical_sector_read       Read a logical sector         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_create                  Create a directory            */
+/*    _fx_directory_free_search             Search for a free directory   */
+/*                                            entry                       */
+/*    _fx_fault_tolerant_create_log_file    Create a log file             */
+/*    _fx_file_extended_allocate            Allocate clusters to a file   */
+/*    _fx_file_extended_best_effort_allocate                              */
+/*                                          Best effort allocate clusters */
+/*                                            to a file                   */
+/*    _fx_file_write                        Write to a file               */
+/*    _fx_media_extended_space_available    Get the available space       */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_free_cluster_count(FX_MEDIA *media_ptr)
+{
+
+ULONG       cluster;
+ULONG       FAT_entry;
+ULONG64     FAT_sector;
+UINT        entry_size;
+ULONG       available_clusters;
+ULONG       search_start;
+ULONG       FAT_entries;
+ULONG       free_entries;
+ULONG       first_free_entry;
+UINT        status;
+
+
+    /* Determine if the free clusters have already been counted.  */
+    if (media_ptr -> fx_media_free_cluster_count_pending == FX_FALSE)
+    {
+
+        /* Yes, the available cluster count is valid.  */
+        return(FX_SUCCESS);
+    }
+
+    /* Write the cached FAT entries to the FAT sectors, so the sectors are up to date.  */
+    status =  _fx_utility_FAT_flush(media_ptr);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Start with no free clusters found.  */
+    available_clusters =  0;
+    search_start =        0;
+
+    /* Determine what type of FAT is present.  */
+    if (media_ptr -> fx_media_12_bit_FAT)
+    {
+
+        /* A 12-bit FAT is present, entries can span sectors. Utilize the FAT entry
+           read utility to pickup each FAT entry's contents.  */
+        for (cluster = FX_FAT_ENTRY_START; cluster < (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START); cluster++)
+        {
+
+            /* Read a FAT entry.  */
+            status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &FAT_entry);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Determine if the cluster is free.  */
+            if (FAT_entry == FX_FREE_CLUSTER)
+            {
+
+                /* Yes, count it and remember the first one.  */
+                available_clusters++;
+                if (search_start == 0)
+                {
+                    search_start =  cluster;
+                }
+            }
+        }
+    }
+    else
+    {
+
+        /* A 16 or 32-bit FAT is present, examine the primary FAT a sector at a time.  */
+        entry_size =  (media_ptr -> fx_media_32_bit_FAT) ? 4 : 2;
+        FAT_sector =  (ULONG64)media_ptr -> fx_media_reserved_sectors;
+        cluster =     0;
+        while (cluster < (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
+        {
+
+            /* Read the next FAT sector.  */
+            status =  _fx_utility_logical_sector_read(media_ptr, FAT_sector,
+                                                      media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Determine how many FAT entries of this sector are examined.  */
+            FAT_entries =  media_ptr -> fx_media_bytes_per_sector / entry_size;
+            if (FAT_entries > (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START - cluster))
+            {
+                FAT_entries =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START - cluster;
+            }
+
+            /* Count the free entries of this sector. The first two entries are reserved and never free.  */
+            free_entries =  _fx_utility_FAT_free_entries_count(media_ptr -> fx_media_memory_buffer, FAT_entries, entry_size, &first_free_entry);
+            available_clusters =  available_clusters + free_entries;
+
+            /* Remember the first free cluster.  */
+            if ((free_entries) && (search_start == 0))
+            {
+                search_start =  cluster + first_free_entry;
+            }
+
+            /* Move to the cluster of the next sector.  */
+            cluster =  cluster + FAT_entries;
+
+            /* Move to the next FAT sector.  */
+            FAT_sector++;
+        }
+    }
+
+    /* If there are no free clusters, just set the search pointer to the first cluster number.  */
+    if (search_start == 0)
+    {
+        search_start =  FX_FAT_ENTRY_START;
+    }
+
+    /* Save the results, the available cluster count is now valid.  */
+    media_ptr -> fx_media_available_clusters =          available_clusters;
+    media_ptr -> fx_media_cluster_search_start =        search_start;
+    media_ptr -> fx_media_free_cluster_count_pending =  FX_FALSE;
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
@@ -0,0 +1,247 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_free_entries_count                  PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function counts the free entries in a buffer of 16-bit or      */
+/*    32-bit FAT entries and returns the index of the first free entry.   */
+/*    The entries are examined a ULONG word at a time: a word of free     */
+/*    entries is counted with a single compare, and the free entries of   */
+/*    other words are counted without examining each entry. Only the      */
+/*    word that holds the first free entry is examined entry by entry.    */
+/*                                                                        */
+/*    The reserved upper four bits of 32-bit FAT entries are ignored, as  */
+/*    they are when a FAT entry is read.                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    buffer_ptr                            Pointer to the FAT entries    */
+/*    entries                               Number of FAT entries         */
+/*    entry_size                            Size of a FAT entry in bytes, */
+/*                                            either 2 or 4               */
+/*    first_free_entry                      Destination for the index of  */
+/*                                            the first free entry, or    */
+/*                                            entries if there is none    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    free_entries                          Number of free FAT entries    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_16_unsigned_read          Read a UINT from memory       */
+/*    _fx_utility_32_unsigned_read          Read a ULONG from memory      */
+/*    _fx_utility_memory_copy               Copy a memory block           */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_fault_tolerant_enable             Enable fault tolerant         */
+/*    _fx_media_open                        Open media                    */
+/*    _fx_utility_FAT_free_cluster_count    Count the free clusters       */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+ULONG  _fx_utility_FAT_free_entries_count(UCHAR *buffer_ptr, ULONG entries, UINT entry_size, ULONG *first_free_entry)
+{
+
+ULONG       free_entries;
+ULONG       used_entries;
+ULONG       index;
+ULONG       entry;
+ULONG       word;
+ULONG       word_mask;
+ULONG      *word_ptr;
+ULONG       words;
+ULONG       lanes;
+ULONG       lane_ones;
+ULONG       lane_low;
+ULONG       lane_high;
+ULONG       lane_shift;
+ULONG       sum_shift;
+UCHAR       mask_bytes[sizeof(ULONG)];
+UINT        i;
+
+
+    /* No free entry has been found yet.  */
+    free_entries =       0;
+    *first_free_entry =  entries;
+
+    /* Setup the constants of the word examination. Each word holds a number of lanes, one lane
+       for each FAT entry. The constants are derived from the size of a word, so the same code
+       examines 32-bit and 64-bit words.  */
+    lanes =       sizeof(ULONG) / entry_size;
+    lane_shift =  (entry_size * 8) - 1;
+    sum_shift =   (sizeof(ULONG) - entry_size) * 8;
+    if (entry_size == 2)
+    {
+        lane_ones =  ((ULONG)~((ULONG)0)) / 0xFFFF;
+    }
+    else
+    {
+        lane_ones =  ((ULONG)~((ULONG)0)) / 0xFFFFFFFF;
+    }
+    lane_low =   lane_ones * ((((ULONG)1) << lane_shift) - 1);
+    lane_high =  lane_ones << lane_shift;
+
+    /* Build the mask that removes the reserved bits of 32-bit FAT entries. The mask is built in
+       memory order, so it fits the FAT entries regardless of the endian of the processor.  */
+    for (i = 0; i < sizeof(ULONG); i++)
+    {
+
+        /* The last byte of a 32-bit FAT entry holds the reserved bits.  */
+        if ((entry_size == 4) && ((i & 3) == 3))
+        {
+            mask_bytes[i] =  0x0F;
+        }
+        else
+        {
+            mask_bytes[i] =  0xFF;
+        }
+    }
+    _fx_utility_memory_copy(mask_bytes, (UCHAR *)&word_mask, sizeof(ULONG)); /* Use case of memcpy is verified. */
+
+    /* Loop through the FAT entries.  */
+    index =  0;
+    while (index < entries)
+    {
+
+        /* Determine if the FAT entry starts an aligned word of FAT entries.  */
+        if ((((ALIGN_TYPE)(buffer_ptr + (index * entry_size))) & (sizeof(ULONG) - 1)) == 0)
+        {
+
+            /* Setup a pointer to the whole words of FAT entries.  */
+            word_ptr =  (ULONG *)(buffer_ptr + (index * entry_size));
+            words =     (entries - index) / lanes;
+
+            /* Skip the words without a free entry until the first free entry is found.  */
+            while ((words) && (*first_free_entry == entries))
+            {
+
+                /* Pickup the word of FAT entries. Since we are looking for values of zero,
+                   endian issues are not important.  */
+                word =  *word_ptr & word_mask;
+
+                /* Set the top bit of each lane that is not zero.  */
+                word =  (word | ((word & lane_low) + lane_low)) & lane_high;
+
+                /* Determine if any entry of the word is free.  */
+                if (word != lane_high)
+                {
+
+                    /* Yes, leave the entries of this word to be examined one at a time.  */
+                    break;
+                }
+
+                /* Move to the next word.  */
+                word_ptr++;
+                words--;
+                index =  index + lanes;
+            }
+
+            /* Determine if the first free entry has been found.  */
+            if (*first_free_entry != entries)
+            {
+
+                /* Yes, count the entries of the remaining words as free, less the used entries.
+                   The top bits of the lanes are added up in the top lane.  */
+                used_entries =  0;
+                free_entries =  free_entries + (words * lanes);
+                index =         index + (words * lanes);
+                while (words)
+                {
+
+                    /* Pickup the word of FAT entries.  */
+                    word =  *word_ptr & word_mask;
+
+                    /* Set the top bit of each lane that is not zero, and add them up.  */
+                    word =          (word | ((word & lane_low) + lane_low)) & lane_high;
+                    used_entries =  used_entries + (((word >> lane_shift) * lane_ones) >> sum_shift);
+
+                    /* Move to the next word.  */
+                    word_ptr++;
+                    words--;
+                }
+
+                /* Remove the used entries from the count.  */
+                free_entries =  free_entries - used_entries;
+            }
+
+            /* Determine if all the FAT entries have been examined.  */
+            if (index >= entries)
+            {
+                break;
+            }
+        }
+
+        /* Pickup a single FAT entry.  */
+        if (entry_size == 4)
+        {
+            entry =  _fx_utility_32_unsigned_read(buffer_ptr + (index * 4)) & 0x0FFFFFFF;
+        }
+        else
+        {
+            entry =  _fx_utility_16_unsigned_read(buffer_ptr + (index * 2));
+        }
+
+        /* Determine if the FAT entry is free.  */
+        if (entry == FX_FREE_CLUSTER)
+        {
+
+            /* Yes, count it and remember the first one.  */
+            free_entries++;
+            if (*first_free_entry == entries)
+            {
+                *first_free_entry =  index;
+            }
+        }
+
+        /* Move to the next FAT entry.  */
+        index++;
+    }
+
+    /* Return the number of free entries.  */
+    return(free_entries);
+}
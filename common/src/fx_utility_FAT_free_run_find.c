@@ -0,0 +1,237 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#if defined(FX_ENABLE_FILE_DELAYED_ALLOCATION) || defined(FX_ENABLE_MEDIA_DEFRAGMENT)
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_free_run_find                       PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function finds where the clusters needed by a write to a       */
+/*    FAT12/16/32 file are taken from, so they are allocated as one run   */
+/*    of consecutive free clusters. If the clusters after the last        */
+/*    cluster of the file are free, the file continues in them.           */
+/*    Otherwise the first run of free clusters long enough is returned,   */
+/*    searched in the free cluster bitmap if there is one, or else in at  */
+/*    most the given number of FAT entries from the free cluster search   */
+/*    start. If there is no such run, zero is returned and the clusters   */
+/*    are allocated one by one as before.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    last_cluster                          Last cluster of the file, or  */
+/*                                            zero if it has none         */
+/*    clusters                              Number of clusters needed     */
+/*    search_clusters                       Number of FAT entries to      */
+/*                                            search at most              */
+/*    start_cluster                         ULONG pointer to store first  */
+/*                                            cluster of the run, or 0    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_bitmap_free_run_find  Find free clusters in bitmap  */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_write                        Write data to file            */
+/*    _fx_utility_FAT_chain_relocate        Move a FAT chain to one run   */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_free_run_find(FX_MEDIA *media_ptr, ULONG last_cluster, ULONG clusters, ULONG search_clusters, ULONG *start_cluster)
+{
+
+UINT  status;
+ULONG end_cluster;
+ULONG FAT_index;
+ULONG FAT_value;
+ULONG run_start;
+ULONG run_length;
+ULONG searched;
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+ULONG run_clusters;
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
+
+    /* No run is found yet.  */
+    *start_cluster =  0;
+
+    /* Calculate the end of the FAT entries.  */
+    end_cluster =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START;
+
+    /* Determine if the file has clusters and the clusters needed fit after the last one.  */
+    if ((last_cluster >= FX_FAT_ENTRY_START) && (last_cluster < end_cluster) &&
+        (clusters < end_cluster - last_cluster))
+    {
+
+        /* Check if the clusters after the last cluster of the file are free.  */
+        for (FAT_index = last_cluster + 1; FAT_index <= last_cluster + clusters; FAT_index++)
+        {
+
+            /* Read the FAT entry.  */
+            status =  _fx_utility_FAT_entry_read(media_ptr, FAT_index, &FAT_value);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Stop at the first cluster used.  */
+            if (FAT_value != FX_FREE_CLUSTER)
+            {
+                break;
+            }
+        }
+
+        /* Determine if all of them are free.  */
+        if (FAT_index > last_cluster + clusters)
+        {
+
+            /* Yes, the file continues in them.  */
+            *start_cluster =  last_cluster + 1;
+
+            /* Return successful status.  */
+            return(FX_SUCCESS);
+        }
+    }
+
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+    /* Determine if the free cluster bitmap is available.  */
+    if (media_ptr -> fx_media_cluster_bitmap)
+    {
+
+        /* Yes, find the first run in the bitmap instead of reading the FAT.  */
+        status =  _fx_utility_FAT_bitmap_free_run_find(media_ptr, clusters, &FAT_index, &run_clusters);
+
+        /* Determine if the run is long enough.  */
+        if ((status == FX_SUCCESS) && (run_clusters >= clusters))
+        {
+
+            /* Yes, return its first cluster.  */
+            *start_cluster =  FAT_index;
+        }
+
+        /* Return the status.  */
+        return(status);
+    }
+#endif /* FX_ENABLE_FAT_CLUSTER_BITMAP */
+
+    /* Search the FAT from the free cluster search start, once through it at most. Runs do not wrap around.  */
+    if (search_clusters > media_ptr -> fx_media_total_clusters)
+    {
+        search_clusters =  media_ptr -> fx_media_total_clusters;
+    }
+    FAT_index =   media_ptr -> fx_media_cluster_search_start;
+    run_start =   0;
+    run_length =  0;
+    for (searched = 0; searched < search_clusters; searched++)
+    {
+
+        /* Determine if the search needs to be wrapped.  */
+        if ((FAT_index < FX_FAT_ENTRY_START) || (FAT_index >= end_cluster))
+        {
+
+            /* Wrap the search to the beginning FAT entry.  */
+            FAT_index =   FX_FAT_ENTRY_START;
+            run_length =  0;
+        }
+
+        /* Read the FAT entry.  */
+        status =  _fx_utility_FAT_entry_read(media_ptr, FAT_index, &FAT_value);
+
+        /* Check for a bad status.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the bad status.  */
+            return(status);
+        }
+
+        /* Determine if the cluster is free.  */
+        if (FAT_value == FX_FREE_CLUSTER)
+        {
+
+            /* Yes, extend the current run.  */
+            if (run_length == 0)
+            {
+                run_start =  FAT_index;
+            }
+            run_length++;
+
+            /* Determine if the run is long enough.  */
+            if (run_length >= clusters)
+            {
+
+                /* Yes, return its first cluster.  */
+                *start_cluster =  run_start;
+                break;
+            }
+        }
+        else
+        {
+
+            /* The cluster is used, end the current run.  */
+            run_length =  0;
+        }
+
+        /* Move to the next FAT entry.  */
+        FAT_index++;
+    }
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_FILE_DELAYED_ALLOCATION || FX_ENABLE_MEDIA_DEFRAGMENT */
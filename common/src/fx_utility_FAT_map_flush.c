@@ -45,6 +45,13 @@
 /*    This function updates mirrors changes in the primary FAT to each of */
 /*    secondary FATs in the media.                                        */
 /*                                                                        */
+/*    If FX_ENABLE_FAT_MIRROR_RANGES is defined, each range of written    */
+/*    FAT sectors is read into the FAT mirror buffer of the media and     */
+/*    written to each secondary FAT with one request per buffer.          */
+/*                                                                        */
+/*    While fx_media_fat_mirror_defer defers the mirroring, the ranges    */
+/*    are kept for _fx_utility_FAT_mirror_sync instead.                   */
+/*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
 /*    media_ptr                             Media control block pointer   */
@@ -76,8 +83,105 @@ UINT  _fx_utility_FAT_map_flush(FX_MEDIA *media_ptr)
 
 ULONG FAT_sector, last_sector;
 UINT  i, status, FATs;
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+ULONG sectors, buffer_sectors;
+UCHAR *buffer_ptr;
+#else
 UCHAR sectors_per_bit;
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+
+
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+
+    /* Determine if mirroring is deferred.  */
+    if (media_ptr -> fx_media_fat_mirror_deferred)
+    {
+
+        /* Yes, the ranges are in the record sector until they are mirrored.  */
+        return(FX_SUCCESS);
+    }
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+
+    /* Calculate how many FAT sectors fit in the mirror buffer.  */
+    buffer_sectors =  FX_FAT_MIRROR_BUFFER_SIZE / media_ptr -> fx_media_bytes_per_sector;
+
+    /* Loop through the ranges of written FAT sectors.  */
+    for (i = 0; i < media_ptr -> fx_media_fat_mirror_ranges; i++)
+    {
+
+        /* Setup the parameters for performing the update.  */
+        FAT_sector =   media_ptr -> fx_media_fat_mirror_range_start[i];
+        last_sector =  media_ptr -> fx_media_fat_mirror_range_end[i];
+
+        /* Loop to mirror the range as many sectors at a time as the buffer holds.  */
+        while (FAT_sector < last_sector)
+        {
+
+            /* Determine if the mirror buffer holds a sector.  */
+            if (buffer_sectors)
+            {
+
+                /* Yes, read as many FAT sectors as it holds.  */
+                sectors =  last_sector - FAT_sector;
+                if (sectors > buffer_sectors)
+                {
+                    sectors =  buffer_sectors;
+                }
+                buffer_ptr =  (UCHAR *)media_ptr -> fx_media_fat_mirror_buffer;
+            }
+            else
+            {
+
+                /* No, mirror one FAT sector at a time through the memory buffer.  */
+                sectors =  1;
+                buffer_ptr =  media_ptr -> fx_media_memory_buffer;
+            }
+
+            /* Read the FAT sectors.  */
+            status =  _fx_utility_logical_sector_read(media_ptr, (ULONG64) FAT_sector,
+                                                      buffer_ptr, sectors, FX_FAT_SECTOR);
+
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            /* The memory buffer may have been moved to another cache entry.  */
+            if (buffer_sectors == 0)
+            {
+                buffer_ptr =  media_ptr -> fx_media_memory_buffer;
+            }
+
+            /* Loop to write the sectors to each secondary FAT.  */
+            for (FATs = media_ptr -> fx_media_number_of_FATs - 1; FATs; FATs--)
+            {
+
+                /* Mirror the main FAT sectors into the additional FAT.  */
+                status =  _fx_utility_logical_sector_write(media_ptr,
+                                                           ((ULONG64) FAT_sector) + ((ULONG64)FATs * (ULONG64)(media_ptr -> fx_media_sectors_per_FAT)),
+                                                           buffer_ptr, sectors, FX_FAT_SECTOR);
+
+                /* Determine if an error occurred.  */
+                if (status != FX_SUCCESS)
+                {
+
+                    /* Return the error status.  */
+                    return(status);
+                }
+            }
+
+            /* Move to the next FAT sectors of the range.  */
+            FAT_sector =  FAT_sector + sectors;
+        }
+    }
 
+    /* All the ranges have been mirrored.  */
+    media_ptr -> fx_media_fat_mirror_ranges =  0;
+#else
 
     /* Determine how many FAT sectors each bit in the bit map represents.  Depending on
        the number of sectors in the primary FAT, each bit in this map may represent one
@@ -165,6 +269,7 @@ UCHAR sectors_per_bit;
         /* Clear each entry in the bit map.  */
         media_ptr -> fx_media_fat_secondary_update_map[i] =  0;
     }
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
 
     /* Return a successful completion.  */
     return(FX_SUCCESS);
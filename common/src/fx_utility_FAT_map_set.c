@@ -0,0 +1,255 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_map_set                             PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function records that the given primary FAT sectors have been  */
+/*    written, so the next FAT map flush mirrors them to the secondary    */
+/*    FATs.                                                               */
+/*                                                                        */
+/*    By default, the bits of the sectors are set in the FAT sector       */
+/*    update bit map, where each bit may stand for several FAT sectors.   */
+/*    If FX_ENABLE_FAT_MIRROR_RANGES is defined, the sectors are merged   */
+/*    into a sorted list of up to FX_FAT_MIRROR_RANGES ranges instead,    */
+/*    so only the sectors actually written are mirrored. When the list    */
+/*    is full, the closest range is extended over the new sectors.        */
+/*                                                                        */
+/*    While mirroring is deferred, the ranges are rounded to granules of  */
+/*    FX_FAT_MIRROR_DEFER_GRANULE sectors and written to the record       */
+/*    sector whenever the list changes.                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    FAT_sector                            Logical sector of the first   */
+/*                                            written FAT sector          */
+/*    sectors                               Number of written FAT sectors */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_mirror_record_write   Write the record sector       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_FAT_chain_write           Link a run of clusters        */
+/*    _fx_utility_FAT_sector_flush          Flush a FAT sector            */
+/*    _fx_media_fat_mirror_defer            Defer secondary FAT mirroring */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_map_set(FX_MEDIA *media_ptr, ULONG FAT_sector, ULONG sectors)
+{
+
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+ULONG *range_start;
+ULONG *range_end;
+ULONG  end_sector;
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+ULONG  FAT_start;
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+UINT   ranges;
+UINT   first, last, i;
+#else
+ULONG  first_bit, last_bit;
+UCHAR  sectors_per_bit;
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+
+
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+
+    /* Pickup the list of ranges.  */
+    range_start =  media_ptr -> fx_media_fat_mirror_range_start;
+    range_end =    media_ptr -> fx_media_fat_mirror_range_end;
+    ranges =       media_ptr -> fx_media_fat_mirror_ranges;
+    end_sector =   FAT_sector + sectors;
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+
+    /* Determine if mirroring is deferred.  */
+    if (media_ptr -> fx_media_fat_mirror_deferred)
+    {
+
+        /* Yes, round the range to whole granules, so the record sector is only written
+           again when a new granule of the FAT is written.  */
+        FAT_start =   media_ptr -> fx_media_reserved_sectors;
+        FAT_sector =  FAT_start + (((FAT_sector - FAT_start) / FX_FAT_MIRROR_DEFER_GRANULE) * FX_FAT_MIRROR_DEFER_GRANULE);
+        end_sector =  FAT_start + (((end_sector - FAT_start + FX_FAT_MIRROR_DEFER_GRANULE - 1) / FX_FAT_MIRROR_DEFER_GRANULE) * FX_FAT_MIRROR_DEFER_GRANULE);
+        if (end_sector > FAT_start + media_ptr -> fx_media_sectors_per_FAT)
+        {
+            end_sector =  FAT_start + media_ptr -> fx_media_sectors_per_FAT;
+        }
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+
+        /* Remember when the FAT was last written.  */
+        media_ptr -> fx_media_fat_mirror_time =  media_ptr -> fx_media_writeback_clock;
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
+    }
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+
+    /* Determine if the sectors are recorded already.  */
+    for (i = 0; i < ranges; i++)
+    {
+        if ((range_start[i] <= FAT_sector) && (range_end[i] >= end_sector))
+        {
+
+            /* Yes, nothing changes.  */
+            return(FX_SUCCESS);
+        }
+    }
+
+    /* Find the first range that ends at or after the start of the new range.  */
+    first =  0;
+    while ((first < ranges) && (range_end[first] < FAT_sector))
+    {
+        first++;
+    }
+
+    /* Find the ranges that overlap or touch the new range.  */
+    last =  first;
+    while ((last < ranges) && (range_start[last] <= end_sector))
+    {
+
+        /* Merge the range into the new range.  */
+        if (range_start[last] < FAT_sector)
+        {
+            FAT_sector =  range_start[last];
+        }
+        if (range_end[last] > end_sector)
+        {
+            end_sector =  range_end[last];
+        }
+        last++;
+    }
+
+    /* Determine if the new range was merged with existing ranges.  */
+    if (last > first)
+    {
+
+        /* Yes, the merged ranges are replaced by one range.  */
+        range_start[first] =  FAT_sector;
+        range_end[first] =    end_sector;
+        for (i = 0; last + i < ranges; i++)
+        {
+            range_start[first + 1 + i] =  range_start[last + i];
+            range_end[first + 1 + i] =    range_end[last + i];
+        }
+        media_ptr -> fx_media_fat_mirror_ranges =  ranges - (last - first - 1);
+    }
+    else if (ranges < FX_FAT_MIRROR_RANGES)
+    {
+
+        /* Insert the new range in sector order.  */
+        for (i = ranges; i > first; i--)
+        {
+            range_start[i] =  range_start[i - 1];
+            range_end[i] =    range_end[i - 1];
+        }
+        range_start[first] =  FAT_sector;
+        range_end[first] =    end_sector;
+        media_ptr -> fx_media_fat_mirror_ranges =  ranges + 1;
+    }
+    else
+    {
+
+        /* The list is full, so extend the range closest to the new range over it.
+           The sectors in between are mirrored without being changed.  */
+        if ((first == ranges) ||
+            ((first > 0) && ((FAT_sector - range_end[first - 1]) <= (range_start[first] - end_sector))))
+        {
+            range_end[first - 1] =  end_sector;
+        }
+        else
+        {
+            range_start[first] =  FAT_sector;
+        }
+    }
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+
+    /* Determine if mirroring is deferred.  */
+    if (media_ptr -> fx_media_fat_mirror_deferred)
+    {
+
+        /* Yes, record the changed ranges before the FAT sectors leave the sector cache.  */
+        return(_fx_utility_FAT_mirror_record_write(media_ptr));
+    }
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
+#else
+
+    /* Determine how many FAT sectors each bit in the bit map represents.  */
+    if (media_ptr -> fx_media_sectors_per_FAT % (FX_FAT_MAP_SIZE << 3) == 0)
+    {
+        sectors_per_bit =  (UCHAR)(media_ptr -> fx_media_sectors_per_FAT / (FX_FAT_MAP_SIZE << 3));
+    }
+    else
+    {
+        sectors_per_bit =  (UCHAR)((media_ptr -> fx_media_sectors_per_FAT / (FX_FAT_MAP_SIZE << 3)) + 1);
+    }
+
+    /* Check for invalid value.  */
+    if (sectors_per_bit == 0)
+    {
+
+        /* Invalid media, return error.  */
+        return(FX_MEDIA_INVALID);
+    }
+
+    /* Mark the bits of the FAT sectors in the bit map.  */
+    first_bit =  (FAT_sector - media_ptr -> fx_media_reserved_sectors) / sectors_per_bit;
+    last_bit =   (FAT_sector + sectors - 1 - media_ptr -> fx_media_reserved_sectors) / sectors_per_bit;
+    for (; first_bit <= last_bit; first_bit++)
+    {
+        media_ptr -> fx_media_fat_secondary_update_map[first_bit >> 3] =
+            (UCHAR)(media_ptr -> fx_media_fat_secondary_update_map[first_bit >> 3] | (1 << (first_bit & 7)));
+    }
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
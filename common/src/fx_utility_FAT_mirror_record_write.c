@@ -0,0 +1,177 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_mirror_record_write                 PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function writes the ranges of primary FAT sectors that are     */
+/*    not yet copied to the secondary FATs to the record sector of the    */
+/*    media. Each range is stored relative to the start of the primary    */
+/*    FAT, after a signature and the number of ranges. If the ranges do   */
+/*    not fit in the sector, the whole FAT is recorded. A record without  */
+/*    ranges marks the secondary FATs as up to date.                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_flush      Flush and invalidate record   */
+/*                                            sector in the cache         */
+/*    _fx_utility_memory_set                Clear the record              */
+/*    _fx_utility_32_unsigned_write         Write a ULONG into buffer     */
+/*    I/O Driver                                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_FAT_map_set               Mark written FAT sectors      */
+/*    _fx_utility_FAT_mirror_sync           Mirror deferred FAT sectors   */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_mirror_record_write(FX_MEDIA *media_ptr)
+{
+
+UCHAR *buffer_ptr;
+ULONG  FAT_start;
+ULONG  capacity;
+UINT   ranges;
+UINT   i;
+UINT   status;
+
+
+    /* Setup a pointer to the mirror buffer, which is not in use outside of a FAT map flush.  */
+    buffer_ptr =  (UCHAR *)media_ptr -> fx_media_fat_mirror_buffer;
+
+    /* Calculate the number of ranges the record sector holds.  */
+    capacity =  (media_ptr -> fx_media_bytes_per_sector - 8) / 8;
+
+    /* Clear the record.  */
+    _fx_utility_memory_set(buffer_ptr, 0, media_ptr -> fx_media_bytes_per_sector);
+
+    /* Build the record, the ranges are stored relative to the start of the primary FAT.  */
+    FAT_start =  media_ptr -> fx_media_reserved_sectors;
+    ranges =     media_ptr -> fx_media_fat_mirror_ranges;
+    _fx_utility_32_unsigned_write(&buffer_ptr[0], FX_FAT_MIRROR_RECORD_SIGNATURE);
+    if (ranges > capacity)
+    {
+
+        /* The ranges do not fit, record the whole FAT instead.  */
+        _fx_utility_32_unsigned_write(&buffer_ptr[4], 1);
+        _fx_utility_32_unsigned_write(&buffer_ptr[8], 0);
+        _fx_utility_32_unsigned_write(&buffer_ptr[12], media_ptr -> fx_media_sectors_per_FAT);
+    }
+    else
+    {
+
+        /* Store each range.  */
+        _fx_utility_32_unsigned_write(&buffer_ptr[4], ranges);
+        for (i = 0; i < ranges; i++)
+        {
+            _fx_utility_32_unsigned_write(&buffer_ptr[8 + (i * 8)], media_ptr -> fx_media_fat_mirror_range_start[i] - FAT_start);
+            _fx_utility_32_unsigned_write(&buffer_ptr[12 + (i * 8)], media_ptr -> fx_media_fat_mirror_range_end[i] - FAT_start);
+        }
+    }
+
+    /* Write out and invalidate any copy of the record sector in the logical sector cache, so
+       that the cache neither overwrites nor hides the record written directly below.  */
+    status =  _fx_utility_logical_sector_flush(media_ptr, (ULONG64) media_ptr -> fx_media_fat_mirror_record_sector, ((ULONG64) 1), FX_TRUE);
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the bad status.  */
+        return(status);
+    }
+
+    /* Write the record sector directly to the media.  */
+    media_ptr -> fx_media_driver_request =          FX_DRIVER_WRITE;
+    media_ptr -> fx_media_driver_status =           FX_IO_ERROR;
+    media_ptr -> fx_media_driver_buffer =           buffer_ptr;
+    media_ptr -> fx_media_driver_logical_sector =   media_ptr -> fx_media_fat_mirror_record_sector;
+    media_ptr -> fx_media_driver_sectors =          1;
+    media_ptr -> fx_media_driver_sector_type =      FX_BOOT_SECTOR;
+
+    /* Set the system write flag since we are writing a reserved sector.  */
+    media_ptr -> fx_media_driver_system_write =  FX_TRUE;
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+    /* Increment the number of driver write sector(s) requests.  */
+    media_ptr -> fx_media_driver_write_requests++;
+#endif
+
+    /* If trace is enabled, insert this event into the trace buffer.  */
+    FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_IO_DRIVER_WRITE, media_ptr, media_ptr -> fx_media_fat_mirror_record_sector, 1, buffer_ptr, FX_TRACE_INTERNAL_EVENTS, 0, 0)
+
+    /* Invoke the driver to write the record sector.  */
+    (media_ptr -> fx_media_driver_entry) (media_ptr);
+
+    /* Clear the system write flag.  */
+    media_ptr -> fx_media_driver_system_write =  FX_FALSE;
+
+    /* Determine if the record sector was written correctly.  */
+    if (media_ptr -> fx_media_driver_status != FX_SUCCESS)
+    {
+
+        /* Return the sector IO error status.  */
+        return(FX_IO_ERROR);
+    }
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_mirror_sync                         PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function copies the primary FAT sectors recorded while         */
+/*    mirroring is deferred to the secondary FATs. Once the secondary     */
+/*    FAT sectors are written to the media, the record sector is          */
+/*    cleared.                                                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_map_flush             Flush primary FAT changes to  */
+/*                                            secondary FAT(s)            */
+/*    _fx_utility_FAT_mirror_record_write   Write the record sector       */
+/*    _fx_utility_logical_sector_flush      Flush logical sector cache    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_media_close                       Close media                   */
+/*    _fx_media_fat_mirror_defer            Defer secondary FAT mirroring */
+/*    _fx_media_writeback_poll              Write out due dirty sectors   */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_mirror_sync(FX_MEDIA *media_ptr)
+{
+
+UINT status;
+
+
+    /* Determine if any FAT sectors wait to be mirrored.  */
+    if (media_ptr -> fx_media_fat_mirror_ranges == 0)
+    {
+
+        /* No, the record sector is already clear.  */
+        return(FX_SUCCESS);
+    }
+
+    /* Copy the recorded ranges to the secondary FATs now.  */
+    media_ptr -> fx_media_fat_mirror_deferred =  FX_FALSE;
+    status =  _fx_utility_FAT_map_flush(media_ptr);
+    media_ptr -> fx_media_fat_mirror_deferred =  FX_TRUE;
+
+    /* Determine if an error occurred.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+    /* Write the secondary FAT sectors to the media before the record is cleared.  */
+    status =  _fx_utility_logical_sector_flush(media_ptr, ((ULONG64) 1), (ULONG64) (media_ptr -> fx_media_total_sectors), FX_FALSE);
+
+    /* Determine if an error occurred.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Return the error status.  */
+        return(status);
+    }
+
+    /* Clear the record sector.  */
+    status =  _fx_utility_FAT_mirror_record_write(media_ptr);
+
+    /* Return the status.  */
+    return(status);
+}
+
+#endif /* FX_ENABLE_FAT_MIRROR_DEFER */
@@ -0,0 +1,527 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_sector_flush                        PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function writes the FAT sector that holds the dirty FAT cache  */
+/*    entry at the supplied index to the media. All other dirty entries   */
+/*    of the FAT cache that are in the same FAT sector are written with   */
+/*    it. 12-bit, 16-bit and 32-bit FAT writing is supported.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    index                                 Index of the dirty FAT cache  */
+/*                                            entry                       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_16_unsigned_write         Write a UINT into buffer      */
+/*    _fx_utility_32_unsigned_write         Write a ULONG into buffer     */
+/*    _fx_utility_FAT_map_set               Mark written FAT sectors      */
+/*    _fx_utility_logical_sector_read       Read FAT sector into memory   */
+/*    _fx_utility_logical_sector_write      Write FAT sector back to disk */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*    _fx_utility_FAT_entry_write           Write a FAT entry             */
+/*    _fx_utility_FAT_flush                 Flush FAT entry cache         */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_sector_flush(FX_MEDIA *media_ptr, ULONG index)
+{
+
+ULONG               FAT_sector;
+ULONG               byte_offset;
+UCHAR              *FAT_ptr;
+UINT                temp, i;
+UINT                status;
+ULONG               cluster, next_cluster;
+INT                 multi_sector_entry;
+ULONG               sector;
+FX_FAT_CACHE_ENTRY *cache_ptr;
+ULONG               cache_size;
+
+
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+
+    /* Pickup the FAT cache in use.  */
+    cache_ptr =   media_ptr -> fx_media_fat_cache_entries;
+    cache_size =  media_ptr -> fx_media_fat_cache_size;
+#else
+
+    /* Pickup the FAT cache of the media.  */
+    cache_ptr =   media_ptr -> fx_media_fat_cache;
+    cache_size =  FX_MAX_FAT_CACHE;
+#endif /* FX_ENABLE_CONFIGURABLE_FAT_CACHE */
+
+    /* Pickup the contents of the FAT cache entry.  */
+    cluster =       cache_ptr[index].fx_fat_cache_entry_cluster;
+
+    /* Determine which type of FAT is present.  */
+#ifdef FX_ENABLE_EXFAT
+    if (media_ptr -> fx_media_FAT_type == FX_FAT12)
+#else
+    if (media_ptr -> fx_media_12_bit_FAT)
+#endif /* FX_ENABLE_EXFAT */
+    {
+
+        /* Calculate the byte offset to the cluster entry.  */
+        byte_offset =  (((ULONG)cluster << 1) + cluster) >> 1;
+
+        /* Calculate the FAT sector the requested FAT entry resides in.  */
+        FAT_sector =  (byte_offset / media_ptr -> fx_media_bytes_per_sector) +
+            (ULONG)media_ptr -> fx_media_reserved_sectors;
+
+        /* Initialize as not written.  */
+        multi_sector_entry = -1;
+
+        for (;;)
+        {
+
+            /* Pickup the FAT sector.  */
+            status =  _fx_utility_logical_sector_read(media_ptr, (ULONG64) FAT_sector,
+                                                      media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            /* Determine if a mulit-sector FAT update is present.  */
+            if (multi_sector_entry != -1)
+            {
+
+                /* Yes, store the remaining portion of the new FAT entry in the
+                   next FAT sector.  */
+
+                /* Setup a pointer into the buffer.  */
+                FAT_ptr =  (UCHAR *)media_ptr -> fx_media_memory_buffer;
+
+                /* Pickup the cluster and next cluster.  */
+                cluster = (cache_ptr[multi_sector_entry].fx_fat_cache_entry_cluster);
+                next_cluster = cache_ptr[multi_sector_entry].fx_fat_cache_entry_value;
+
+                /* Determine if the cluster entry is odd or even.  */
+                if (cluster & 1)
+                {
+
+                    /* Store the upper 8 bits of the FAT entry.  */
+                    *FAT_ptr =  (UCHAR)((next_cluster >> 4) & 0xFF);
+                }
+                else
+                {
+
+                    /* Store the upper 4 bits of the FAT entry.  */
+                    temp =  ((UINT)*FAT_ptr) & 0xF0;
+                    *FAT_ptr =  (UCHAR)(temp | ((next_cluster >> 8) & 0xF));
+                }
+
+                /* Clear the multi-sector flag.  */
+                multi_sector_entry = -1;
+            }
+
+            /* Loop through the cache to check for multiple entries within the same
+               FAT sector being written out.  */
+            for (i = 0; i < cache_size; i++)
+            {
+
+                /* Is the cache entry dirty?  */
+                if ((cache_ptr[i].fx_fat_cache_entry_dirty) == 0)
+                {
+
+                    /* Not dirty, does not need to be flushed.  */
+                    continue;
+                }
+
+                /* Isolate the cluster.  */
+                cluster = (cache_ptr[i].fx_fat_cache_entry_cluster);
+
+                /* Calculate the byte offset to the cluster entry.  */
+                byte_offset =  (((ULONG)cluster << 1) + cluster) >> 1;
+
+                /* Pickup the sector.  */
+                sector =  (byte_offset / media_ptr -> fx_media_bytes_per_sector) +
+                    (ULONG)media_ptr -> fx_media_reserved_sectors;
+
+                /* Is it the current FAT sector?  */
+                if (sector != FAT_sector)
+                {
+
+                    /* Different FAT sector - not in this pass of the loop.  */
+                    continue;
+                }
+
+                /* Pickup new value for this FAT entry.  */
+                next_cluster =  cache_ptr[i].fx_fat_cache_entry_value;
+
+                /* Now calculate the byte offset into this FAT sector.  */
+                byte_offset =  byte_offset -
+                    ((FAT_sector - (ULONG)media_ptr -> fx_media_reserved_sectors) *
+                     media_ptr -> fx_media_bytes_per_sector);
+
+                /* Determine if we are now past the end of the FAT buffer in memory.  */
+                if (byte_offset == (ULONG)(media_ptr -> fx_media_bytes_per_sector - 1))
+                {
+
+                    /* Yes, we need to read the next sector */
+                    multi_sector_entry = (INT)i;
+                }
+
+                /* Setup a pointer into the buffer.  */
+                FAT_ptr =  (UCHAR *)media_ptr -> fx_media_memory_buffer + (UINT)byte_offset;
+
+                /* Clear the dirty flag.  */
+                cache_ptr[i].fx_fat_cache_entry_dirty = 0;
+
+                /* Determine if the cluster entry is odd or even.  */
+                if (cluster & 1)
+                {
+
+                    /* Odd cluster number.  */
+
+                    /* Pickup the upper nibble of the FAT entry.  */
+
+                    /* First, set the lower nibble of the FAT entry.  */
+                    temp =      (((UINT)*FAT_ptr) & 0x0F);
+                    *FAT_ptr =  (UCHAR)(temp | ((next_cluster << 4) & 0xF0));
+
+                    /* Determine if this is a mulit-sector entry.  */
+                    if ((multi_sector_entry) == (INT)i)
+                    {
+
+                        /* Yes, requires multiple sector - will write rest of the part later.  */
+                        continue;
+                    }
+
+                    /* Move to the next byte of the FAT entry.  */
+                    FAT_ptr++;
+
+                    /* Store the upper 8 bits of the FAT entry.  */
+                    *FAT_ptr =  (UCHAR)((next_cluster >> 4) & 0xFF);
+                }
+                else
+                {
+
+                    /* Even cluster number.  */
+
+                    /* Store the lower byte of the FAT entry.  */
+                    *FAT_ptr =  (UCHAR)(next_cluster & 0xFF);
+
+                    /* Determine if this is a mulit-sector entry.  */
+                    if ((multi_sector_entry) == (INT)i)
+                    {
+
+                        /* Yes, requires multiple sector - will write rest of the part later.  */
+                        continue;
+                    }
+
+                    /* Move to the next nibble of the FAT entry.  */
+                    FAT_ptr++;
+
+                    /* Store the upper 4 bits of the FAT entry.  */
+                    temp =  ((UINT)*FAT_ptr) & 0xF0;
+                    *FAT_ptr =  (UCHAR)(temp | ((next_cluster >> 8) & 0xF));
+                }
+            }
+
+            /* First, write out the current sector. */
+            status =  _fx_utility_logical_sector_write(media_ptr, (ULONG64) FAT_sector,
+                                                       media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            /* Mark the FAT sector update bit map to indicate this sector has been written.  */
+            status =  _fx_utility_FAT_map_set(media_ptr, FAT_sector, 1);
+
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            /* Determine if the multi-sector flag is set.  */
+            if (multi_sector_entry != -1)
+            {
+
+                /* Yes, position to the next sector and read it in.  */
+                FAT_sector++;
+            }
+            else
+            {
+
+                /* No, we are finished with this loop.   */
+                break;
+            }
+        }
+    }
+#ifdef FX_ENABLE_EXFAT
+    else if (media_ptr -> fx_media_FAT_type == FX_FAT16)
+#else
+    else if (!media_ptr -> fx_media_32_bit_FAT)
+#endif /* FX_ENABLE_EXFAT */
+    {
+
+        /* 16-bit FAT is present.  */
+
+        /* Calculate the byte offset to the cluster entry.  */
+        byte_offset =  (((ULONG)cluster) << 1);
+
+        /* Calculate the FAT sector the requested FAT entry resides in.  */
+        FAT_sector =  (byte_offset / media_ptr -> fx_media_bytes_per_sector) +
+            (ULONG)media_ptr -> fx_media_reserved_sectors;
+
+        /* Read the FAT sector.  */
+        status =  _fx_utility_logical_sector_read(media_ptr, (ULONG64) FAT_sector,
+                                                  media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+        /* Determine if an error occurred.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the error status.  */
+            return(status);
+        }
+
+        /* Loop through the remainder of the cache to check for multiple entries
+           within the same FAT sector being written out.  */
+        for (i = 0; i < cache_size; i++)
+        {
+
+            /* Determine if the entry is dirty.  */
+            if (cache_ptr[i].fx_fat_cache_entry_dirty == 0)
+            {
+
+                /* Not dirty, does not need to be flushed.  */
+                continue;
+            }
+
+            /* Isolate the cluster.  */
+            cluster = (cache_ptr[i].fx_fat_cache_entry_cluster);
+
+            /* Calculate the byte offset to the cluster entry.  */
+            byte_offset =  (((ULONG)cluster) * 2);
+
+            /* Pickup the sector.  */
+            sector =  (byte_offset / media_ptr -> fx_media_bytes_per_sector) +
+                (ULONG)media_ptr -> fx_media_reserved_sectors;
+
+            /* Is it the current FAT sector?  */
+            if (sector != FAT_sector)
+            {
+
+                /* Different FAT sector - not in this pass of the loop.  */
+                continue;
+            }
+
+            /* Now calculate the byte offset into this FAT sector.  */
+            byte_offset =  byte_offset -
+                ((FAT_sector - (ULONG)media_ptr -> fx_media_reserved_sectors) *
+                 media_ptr -> fx_media_bytes_per_sector);
+
+            /* Setup a pointer into the buffer.  */
+            FAT_ptr =  (UCHAR *)media_ptr -> fx_media_memory_buffer + (UINT)byte_offset;
+
+            /* Pickup new value for this FAT entry.  */
+            next_cluster =  cache_ptr[i].fx_fat_cache_entry_value;
+
+            /* Store the FAT entry.  */
+            _fx_utility_16_unsigned_write(FAT_ptr, (UINT)next_cluster);
+
+            /* Clear the dirty flag.  */
+            cache_ptr[i].fx_fat_cache_entry_dirty = 0;
+        }
+
+        /* Write the last written FAT sector out.  */
+        status =  _fx_utility_logical_sector_write(media_ptr, (ULONG64) FAT_sector,
+                                                   media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+        /* Determine if an error occurred.  */
+        if (status != FX_SUCCESS)
+        {
+            /* Return the error status.  */
+            return(status);
+        }
+
+        /* Mark the FAT sector update bit map to indicate this sector has been
+           written.  */
+        status =  _fx_utility_FAT_map_set(media_ptr, FAT_sector, 1);
+
+        /* Determine if an error occurred.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the error status.  */
+            return(status);
+        }
+    }
+    else
+    {
+
+        /* 32-bit FAT or exFAT are present.  */
+
+        /* Calculate the byte offset to the cluster entry.  */
+        byte_offset =  (((ULONG)cluster) * 4);
+
+        /* Calculate the FAT sector the requested FAT entry resides in.  */
+        FAT_sector =  (byte_offset / media_ptr -> fx_media_bytes_per_sector) +
+            (ULONG)media_ptr -> fx_media_reserved_sectors;
+
+        /* Read the FAT sector.  */
+        status =  _fx_utility_logical_sector_read(media_ptr, (ULONG64) FAT_sector,
+                                                  media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+        /* Determine if an error occurred.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the error status.  */
+            return(status);
+        }
+
+        /* Loop through the remainder of the cache to check for multiple entries
+           within the same FAT sector being written out.  */
+        for (i = 0; i < cache_size; i++)
+        {
+
+            /* Determine if the entry is dirty.  */
+            if (cache_ptr[i].fx_fat_cache_entry_dirty == 0)
+            {
+
+                /* Not dirty, does not need to be flushed.  */
+                continue;
+            }
+
+            /* Isolate the cluster.  */
+            cluster = (cache_ptr[i].fx_fat_cache_entry_cluster);
+
+            /* Calculate the byte offset to the cluster entry.  */
+            byte_offset =  (((ULONG)cluster) * 4);
+
+            /* Pickup the sector.  */
+            sector =  (byte_offset / media_ptr -> fx_media_bytes_per_sector) +
+                (ULONG)media_ptr -> fx_media_reserved_sectors;
+
+            /* Is it the current FAT sector?  */
+            if (sector != FAT_sector)
+            {
+
+                /* Different FAT sector - not in this pass of the loop.  */
+                continue;
+            }
+
+            /* Now calculate the byte offset into this FAT sector.  */
+            byte_offset =  byte_offset -
+                ((FAT_sector - (ULONG)media_ptr -> fx_media_reserved_sectors) *
+                 media_ptr -> fx_media_bytes_per_sector);
+
+            /* Setup a pointer into the buffer.  */
+            FAT_ptr =  (UCHAR *)media_ptr -> fx_media_memory_buffer + (UINT)byte_offset;
+
+            /* Pickup new value for this FAT entry.  */
+            next_cluster =  cache_ptr[i].fx_fat_cache_entry_value;
+
+            /* Store the FAT entry.  */
+            _fx_utility_32_unsigned_write(FAT_ptr, next_cluster);
+
+            /* Clear the dirty flag.  */
+            cache_ptr[i].fx_fat_cache_entry_dirty = 0;
+        }
+
+        /* Write the last written FAT sector out.  */
+        status =  _fx_utility_logical_sector_write(media_ptr, (ULONG64) FAT_sector,
+                                                   media_ptr -> fx_media_memory_buffer, ((ULONG) 1), FX_FAT_SECTOR);
+
+        /* Determine if an error occurred.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Return the error status.  */
+            return(status);
+        }
+
+#ifdef FX_ENABLE_EXFAT
+        /* We are not using fx_media_fat_secondary_update_map for exFAT.  */
+        if (media_ptr -> fx_media_FAT_type == FX_FAT32)
+        {
+#endif /* FX_ENABLE_EXFAT */
+
+            /* Mark the FAT sector update bit map to indicate this sector has been
+               written.  */
+            status =  _fx_utility_FAT_map_set(media_ptr, FAT_sector, 1);
+
+            /* Determine if an error occurred.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+#ifdef FX_ENABLE_EXFAT
+        }
+#endif /* FX_ENABLE_EXFAT */
+    }
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
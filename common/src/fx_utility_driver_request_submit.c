@@ -0,0 +1,236 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_ASYNC_DRIVER
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_driver_request_submit                   PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function submits a read or write request to the I/O driver.    */
+/*    If the driver accepts asynchronous requests, the request is         */
+/*    described by a free request descriptor and is passed to the driver  */
+/*    with FX_DRIVER_ASYNC_SUBMIT, without waiting for the transfer. If   */
+/*    all descriptors are outstanding, the oldest completions are         */
+/*    processed first. The completion function is called by               */
+/*    _fx_utility_driver_request_wait once the driver has completed the   */
+/*    request.                                                            */
+/*                                                                        */
+/*    Otherwise, the request is performed synchronously through the       */
+/*    driver entry and the completion function is called before this      */
+/*    function returns.                                                   */
+/*                                                                        */
+/*    The caller must wait for all outstanding requests before the        */
+/*    buffer is used again and before the media is accessed with          */
+/*    synchronous driver requests.                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    request_type                          FX_DRIVER_READ or             */
+/*                                            FX_DRIVER_WRITE             */
+/*    logical_sector                        Logical sector number         */
+/*    buffer_ptr                            Pointer of sector buffer      */
+/*    sectors                               Number of sectors             */
+/*    sector_type                           Type of sectors               */
+/*    request_complete                      Function called when the      */
+/*                                            request is complete         */
+/*    context_ptr                           Context of completion function*/
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_driver_request_wait       Wait for driver requests      */
+/*    I/O Driver                                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_logical_sector_flush_coalesced                          */
+/*                                          Write dirty sectors in runs   */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_driver_request_submit(FX_MEDIA *media_ptr, UINT request_type, ULONG64 logical_sector, VOID *buffer_ptr,
+                                        ULONG sectors, UINT sector_type,
+                                        VOID (*request_complete)(FX_MEDIA *, FX_DRIVER_REQUEST *), VOID *context_ptr)
+{
+
+UINT               status;
+FX_DRIVER_REQUEST *request_ptr;
+
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+    /* Increment the number of driver read or write sector(s) requests.  */
+    if (request_type == FX_DRIVER_READ)
+    {
+        media_ptr -> fx_media_driver_read_requests++;
+    }
+    else
+    {
+        media_ptr -> fx_media_driver_write_requests++;
+    }
+#endif
+
+    /* Determine if a request descriptor is available.  */
+    if (media_ptr -> fx_media_driver_async_free_list == FX_NULL)
+    {
+
+        /* No, wait until the oldest outstanding request is complete.  */
+        status =  _fx_utility_driver_request_wait(media_ptr, media_ptr -> fx_media_driver_async_outstanding - 1);
+
+        /* Determine if a descriptor has been returned.  */
+        if (media_ptr -> fx_media_driver_async_free_list == FX_NULL)
+        {
+
+            /* No, return the error status.  */
+            return(status);
+        }
+    }
+
+    /* Remove a descriptor from the free list.  */
+    request_ptr =  media_ptr -> fx_media_driver_async_free_list;
+    media_ptr -> fx_media_driver_async_free_list =  request_ptr -> fx_driver_request_next;
+
+    /* Build the request descriptor.  */
+    request_ptr -> fx_driver_request_type =            request_type;
+    request_ptr -> fx_driver_request_status =          FX_IO_ERROR;
+    request_ptr -> fx_driver_request_buffer =          (UCHAR *)buffer_ptr;
+    request_ptr -> fx_driver_request_logical_sector =  logical_sector;
+    request_ptr -> fx_driver_request_sectors =         sectors;
+    request_ptr -> fx_driver_request_sector_type =     sector_type;
+    request_ptr -> fx_driver_request_complete =        request_complete;
+    request_ptr -> fx_driver_request_context =         context_ptr;
+    request_ptr -> fx_driver_request_next =            FX_NULL;
+
+    /* Determine if the driver accepts asynchronous requests.  */
+    if (media_ptr -> fx_media_driver_async_supported)
+    {
+
+        /* Yes, build the submit request to the driver.  */
+        media_ptr -> fx_media_driver_request =        FX_DRIVER_ASYNC_SUBMIT;
+        media_ptr -> fx_media_driver_status =         FX_IO_ERROR;
+        media_ptr -> fx_media_driver_async_request =  request_ptr;
+
+        /* If trace is enabled, insert this event into the trace buffer.  */
+        FX_TRACE_IN_LINE_INSERT(((request_type == FX_DRIVER_READ) ? FX_TRACE_INTERNAL_IO_DRIVER_READ : FX_TRACE_INTERNAL_IO_DRIVER_WRITE), media_ptr, logical_sector, sectors, buffer_ptr, FX_TRACE_INTERNAL_EVENTS, 0, 0)
+
+        /* Invoke the driver to queue the request.  */
+        (media_ptr -> fx_media_driver_entry) (media_ptr);
+
+        /* Determine if the driver has accepted the request.  */
+        if (media_ptr -> fx_media_driver_status == FX_SUCCESS)
+        {
+
+            /* Yes, the request is outstanding until the driver completes it.  */
+            media_ptr -> fx_media_driver_async_outstanding++;
+
+            /* Return successful status.  */
+            return(FX_SUCCESS);
+        }
+
+        /* The request was rejected, return the descriptor to the free list.  */
+        request_ptr -> fx_driver_request_next =         media_ptr -> fx_media_driver_async_free_list;
+        media_ptr -> fx_media_driver_async_free_list =  request_ptr;
+
+        /* Return the error status.  */
+        return(media_ptr -> fx_media_driver_status);
+    }
+
+    /* Build the synchronous request to the driver.  */
+    media_ptr -> fx_media_driver_request =          request_type;
+    media_ptr -> fx_media_driver_status =           FX_IO_ERROR;
+    media_ptr -> fx_media_driver_buffer =           (UCHAR *)buffer_ptr;
+#ifdef FX_DRIVER_USE_64BIT_LBA
+    media_ptr -> fx_media_driver_logical_sector =   logical_sector;
+#else
+    media_ptr -> fx_media_driver_logical_sector =   (ULONG)logical_sector;
+#endif
+    media_ptr -> fx_media_driver_sectors =          sectors;
+    media_ptr -> fx_media_driver_sector_type =      sector_type;
+
+    /* Sectors other than FX_DATA_SECTOR will never be dirty when FX_FAULT_TOLERANT is defined. */
+#ifndef FX_FAULT_TOLERANT
+    /* Determine if the system write flag needs to be set.  */
+    if ((request_type == FX_DRIVER_WRITE) && (sector_type != FX_DATA_SECTOR))
+    {
+
+        /* Yes, a system sector write is present so set the flag.  The driver
+           can use this flag to make extra safeguards in writing the sector
+           out, yielding more fault tolerance.  */
+        media_ptr -> fx_media_driver_system_write =  FX_TRUE;
+    }
+#endif /* FX_FAULT_TOLERANT */
+
+    /* If trace is enabled, insert this event into the trace buffer.  */
+    FX_TRACE_IN_LINE_INSERT(((request_type == FX_DRIVER_READ) ? FX_TRACE_INTERNAL_IO_DRIVER_READ : FX_TRACE_INTERNAL_IO_DRIVER_WRITE), media_ptr, logical_sector, sectors, buffer_ptr, FX_TRACE_INTERNAL_EVENTS, 0, 0)
+
+    /* Invoke the driver to perform the request.  */
+    (media_ptr -> fx_media_driver_entry) (media_ptr);
+
+    /* Clear the system write flag.  */
+    media_ptr -> fx_media_driver_system_write =  FX_FALSE;
+
+    /* The request is complete, call the completion function.  */
+    status =  media_ptr -> fx_media_driver_status;
+    request_ptr -> fx_driver_request_status =  status;
+    if (request_complete)
+    {
+        request_complete(media_ptr, request_ptr);
+    }
+
+    /* Return the descriptor to the free list.  */
+    request_ptr -> fx_driver_request_next =         media_ptr -> fx_media_driver_async_free_list;
+    media_ptr -> fx_media_driver_async_free_list =  request_ptr;
+
+    /* Return the driver status.  */
+    return(status);
+}
+
+#endif /* FX_ENABLE_ASYNC_DRIVER */
@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_ASYNC_DRIVER
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_driver_request_wait                     PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function waits until no more than the specified number of      */
+/*    asynchronous driver requests are outstanding. For each request the  */
+/*    driver completes, the completion function of the request is called  */
+/*    and its descriptor is returned to the free list.                    */
+/*                                                                        */
+/*    The first error any request completed with is returned. This error  */
+/*    is cleared once no request is outstanding anymore. If the driver    */
+/*    fails to return a completed request, FX_IO_ERROR is returned.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    outstanding                           Number of requests that may   */
+/*                                            still be outstanding        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    I/O Driver                                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_driver_request_submit     Submit driver request         */
+/*    _fx_utility_logical_sector_flush_coalesced                          */
+/*                                          Write dirty sectors in runs   */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_driver_request_wait(FX_MEDIA *media_ptr, ULONG outstanding)
+{
+
+UINT               status;
+FX_DRIVER_REQUEST *request_ptr;
+
+
+    /* Loop until enough requests are complete.  */
+    while (media_ptr -> fx_media_driver_async_outstanding > outstanding)
+    {
+
+        /* Build the wait request to the driver.  */
+        media_ptr -> fx_media_driver_request =        FX_DRIVER_ASYNC_WAIT;
+        media_ptr -> fx_media_driver_status =         FX_IO_ERROR;
+        media_ptr -> fx_media_driver_async_request =  FX_NULL;
+
+        /* Invoke the driver to wait for the next completed request.  */
+        (media_ptr -> fx_media_driver_entry) (media_ptr);
+
+        /* Pickup the completed request.  */
+        request_ptr =  media_ptr -> fx_media_driver_async_request;
+
+        /* Determine if the driver has returned a completed request.  */
+        if ((media_ptr -> fx_media_driver_status != FX_SUCCESS) || (request_ptr == FX_NULL))
+        {
+
+            /* No, return an I/O error.  */
+            return(FX_IO_ERROR);
+        }
+
+        /* One less request is outstanding.  */
+        media_ptr -> fx_media_driver_async_outstanding--;
+
+        /* Remember the first error.  */
+        if ((request_ptr -> fx_driver_request_status != FX_SUCCESS) &&
+            (media_ptr -> fx_media_driver_async_status == FX_SUCCESS))
+        {
+            media_ptr -> fx_media_driver_async_status =  request_ptr -> fx_driver_request_status;
+        }
+
+        /* Call the completion function of the request.  */
+        if (request_ptr -> fx_driver_request_complete)
+        {
+            (request_ptr -> fx_driver_request_complete)(media_ptr, request_ptr);
+        }
+
+        /* Return the descriptor to the free list.  */
+        request_ptr -> fx_driver_request_next =         media_ptr -> fx_media_driver_async_free_list;
+        media_ptr -> fx_media_driver_async_free_list =  request_ptr;
+    }
+
+    /* Pickup the first error of the requests.  */
+    status =  media_ptr -> fx_media_driver_async_status;
+
+    /* Clear the error once all requests are complete.  */
+    if (media_ptr -> fx_media_driver_async_outstanding == 0)
+    {
+        media_ptr -> fx_media_driver_async_status =  FX_SUCCESS;
+    }
+
+    /* Return status to the caller.  */
+    return(status);
+}
+
+#endif /* FX_ENABLE_ASYNC_DRIVER */
@@ -67,6 +67,7 @@
 /*    _fx_utility_exFAT_bitmap_free_cluster_find                          */
 /*                                          Find free cluster             */
 /*    _fx_utility_exFAT_cluster_state_get   Get cluster state             */
+/*    _fx_utility_exFAT_reservation_mask    Get reserved clusters         */
 /*    _fx_utility_FAT_entry_read            Read FAT entry                */
 /*    _fx_utility_FAT_entry_write           Write FAT entry               */
 /*                                                                        */
@@ -131,6 +132,14 @@ UCHAR cluster_state = FX_EXFAT_BITMAP_CLUSTER_OCCUPIED;
                     /* Return the bad status.  */
                     return(status);
                 }
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+
+                /* A cluster reserved for an open file is not free either.  */
+                if (_fx_utility_exFAT_reservation_mask(media_ptr, *cluster, 1))
+                {
+                    cluster_state =  FX_EXFAT_BITMAP_CLUSTER_OCCUPIED;
+                }
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
             }
 
             /* Is the next cluster free?  */
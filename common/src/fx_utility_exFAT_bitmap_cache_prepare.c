@@ -62,6 +62,7 @@
 /*                                                                        */
 /*    _fx_utility_exFAT_bitmap_flush        Flush bitmap cache            */
 /*    _fx_utility_exFAT_bitmap_cache_update Read bitmap to cache          */
+/*    _fx_utility_exFAT_bitmap_window_flush Flush bitmap window           */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -80,11 +81,112 @@ UINT  _fx_utility_exFAT_bitmap_cache_prepare(FX_MEDIA *media_ptr, ULONG cluster)
 {
 
 UINT status;
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+FX_EXFAT_BITMAP_WINDOW *window_ptr;
+FX_EXFAT_BITMAP_WINDOW *victim_ptr;
+ULONG                   i;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 
 
     /* Default the status to no more space.  */
     status = FX_NO_MORE_SPACE;
 
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+
+    /* Make sure the cluster does not exceed the total count.  */
+    if (cluster < media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START)
+    {
+
+        /* Check if the request cluster is in the window in use.  */
+        window_ptr =  media_ptr -> fx_media_exfat_bitmap_window_current;
+        if ((window_ptr -> fx_exfat_bitmap_window_sectors) &&
+            (cluster >= window_ptr -> fx_exfat_bitmap_window_start_cluster) &&
+            (cluster <= window_ptr -> fx_exfat_bitmap_window_end_cluster))
+        {
+
+            /* Cluster already cached.  */
+            return(FX_SUCCESS);
+        }
+
+        /* Look for the cluster in the other windows, and for the window to replace,
+           an unused window or else the least recently used one.  */
+        victim_ptr =  FX_NULL;
+        for (i = 0; i < media_ptr -> fx_media_exfat_bitmap_windows_count; i++)
+        {
+
+            /* Pickup the window.  */
+            window_ptr =  &media_ptr -> fx_media_exfat_bitmap_windows[i];
+
+            /* The window in use is not replaced.  */
+            if (window_ptr == media_ptr -> fx_media_exfat_bitmap_window_current)
+            {
+                continue;
+            }
+
+            /* Determine if the window holds the cluster.  */
+            if ((window_ptr -> fx_exfat_bitmap_window_sectors) &&
+                (cluster >= window_ptr -> fx_exfat_bitmap_window_start_cluster) &&
+                (cluster <= window_ptr -> fx_exfat_bitmap_window_end_cluster))
+            {
+                break;
+            }
+
+            /* Determine if the window is a better one to replace.  */
+            if ((victim_ptr == FX_NULL) ||
+                (window_ptr -> fx_exfat_bitmap_window_sectors == 0) ||
+                ((victim_ptr -> fx_exfat_bitmap_window_sectors) &&
+                 (window_ptr -> fx_exfat_bitmap_window_last_used < victim_ptr -> fx_exfat_bitmap_window_last_used)))
+            {
+                victim_ptr =  window_ptr;
+            }
+        }
+
+        /* Determine if the cluster was not found.  */
+        if (i == media_ptr -> fx_media_exfat_bitmap_windows_count)
+        {
+
+            /* Replace the window in use if it is the only one.  */
+            if (victim_ptr == FX_NULL)
+            {
+                victim_ptr =  media_ptr -> fx_media_exfat_bitmap_window_current;
+            }
+
+            /* Write the window to replace if it is dirty.  */
+            status =  _fx_utility_exFAT_bitmap_window_flush(media_ptr, victim_ptr);
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            window_ptr =  victim_ptr;
+        }
+
+        /* Remember when the window in use was last used, and switch to the window.  */
+        media_ptr -> fx_media_exfat_bitmap_window_clock++;
+        media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_last_used =
+            media_ptr -> fx_media_exfat_bitmap_window_clock;
+        media_ptr -> fx_media_exfat_bitmap_window_current =  window_ptr;
+
+        /* Determine if the window must be read.  */
+        if (i == media_ptr -> fx_media_exfat_bitmap_windows_count)
+        {
+
+            /* Call utility function to read the window.  */
+            status =  _fx_utility_exFAT_bitmap_cache_update(media_ptr, cluster);
+        }
+        else
+        {
+
+            /* Use the cached clusters of the window.  */
+            media_ptr -> fx_media_exfat_bitmap_cache_start_cluster =  window_ptr -> fx_exfat_bitmap_window_start_cluster;
+            media_ptr -> fx_media_exfat_bitmap_cache_end_cluster =    window_ptr -> fx_exfat_bitmap_window_end_cluster;
+            status =  FX_SUCCESS;
+        }
+    }
+#else
+
     /* Make sure the cluster does not exceed the total count.  */
     if (cluster < media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START)
     {
@@ -111,6 +213,7 @@ UINT status;
             }
         }
     }
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 
     /* Return status.  */
     return(status);
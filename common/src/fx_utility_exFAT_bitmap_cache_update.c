@@ -77,6 +77,77 @@
 UINT   _fx_utility_exFAT_bitmap_cache_update(FX_MEDIA *media_ptr, ULONG cluster)
 {
 
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+FX_EXFAT_BITMAP_WINDOW *window_ptr;
+ULONG                   sector;
+ULONG                   sectors;
+ULONG                   bitmap_sectors;
+ULONG                   start_cluster;
+ULONG                   i;
+
+
+    /* Calculate the first bitmap sector of the window, a multiple of the window size.  */
+    sector =  (cluster - FX_FAT_ENTRY_START) >> media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift;
+    sector =  sector - (sector % media_ptr -> fx_media_exfat_bitmap_cache_size_in_sectors);
+    start_cluster =  (sector << media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift) + FX_FAT_ENTRY_START;
+
+    /* Do not read beyond the last bitmap sector.  */
+    bitmap_sectors =  (media_ptr -> fx_media_total_clusters +
+                       (((ULONG)1) << media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift) - 1) >>
+        media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift;
+    sectors =  media_ptr -> fx_media_exfat_bitmap_cache_size_in_sectors;
+    if (sectors > bitmap_sectors - sector)
+    {
+        sectors =  bitmap_sectors - sector;
+    }
+
+    /* Read into the window that already holds these sectors, otherwise into the window in use.  */
+    window_ptr =  media_ptr -> fx_media_exfat_bitmap_window_current;
+    for (i = 0; i < media_ptr -> fx_media_exfat_bitmap_windows_count; i++)
+    {
+        if ((media_ptr -> fx_media_exfat_bitmap_windows[i].fx_exfat_bitmap_window_sectors) &&
+            (media_ptr -> fx_media_exfat_bitmap_windows[i].fx_exfat_bitmap_window_start_cluster == start_cluster))
+        {
+            window_ptr =  &media_ptr -> fx_media_exfat_bitmap_windows[i];
+            break;
+        }
+    }
+
+    /* Read exFAT bitmap to the window.  */
+    media_ptr -> fx_media_driver_request        =  FX_DRIVER_READ;
+    media_ptr -> fx_media_driver_buffer         =  window_ptr -> fx_exfat_bitmap_window_buffer;
+    media_ptr -> fx_media_driver_logical_sector =  media_ptr -> fx_media_exfat_bitmap_start_sector + sector;
+    media_ptr -> fx_media_driver_sectors        =  sectors;
+    media_ptr -> fx_media_driver_status         =  FX_IO_ERROR;
+
+    /* Invoke the driver to read the bitmap sectors.  */
+    (media_ptr -> fx_media_driver_entry)(media_ptr);
+
+    /* Setup the window, which is not in use if the read failed.  */
+    window_ptr -> fx_exfat_bitmap_window_start_cluster =  start_cluster;
+    window_ptr -> fx_exfat_bitmap_window_end_cluster =    start_cluster +
+        ((sectors << media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift) - 1);
+    window_ptr -> fx_exfat_bitmap_window_sectors =        sectors;
+    window_ptr -> fx_exfat_bitmap_window_dirty =          FX_FALSE;
+    if (media_ptr -> fx_media_driver_status != FX_SUCCESS)
+    {
+        window_ptr -> fx_exfat_bitmap_window_sectors =  0;
+    }
+
+    /* Switch to the window.  */
+    if (window_ptr != media_ptr -> fx_media_exfat_bitmap_window_current)
+    {
+        media_ptr -> fx_media_exfat_bitmap_window_clock++;
+        media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_last_used =
+            media_ptr -> fx_media_exfat_bitmap_window_clock;
+        media_ptr -> fx_media_exfat_bitmap_window_current =  window_ptr;
+    }
+
+    /* Calculate new cached clusters.  */
+    media_ptr -> fx_media_exfat_bitmap_cache_start_cluster =  window_ptr -> fx_exfat_bitmap_window_start_cluster;
+    media_ptr -> fx_media_exfat_bitmap_cache_end_cluster =    window_ptr -> fx_exfat_bitmap_window_end_cluster;
+#else
+
     /* Read exFAT bitmap to cache.  */
     cluster -= FX_FAT_ENTRY_START;
     media_ptr -> fx_media_driver_request        =  FX_DRIVER_READ;
@@ -98,6 +169,7 @@ UINT   _fx_utility_exFAT_bitmap_cache_update(FX_MEDIA *media_ptr, ULONG cluster)
     media_ptr -> fx_media_exfat_bitmap_cache_end_cluster = media_ptr -> fx_media_exfat_bitmap_cache_start_cluster +
         ((media_ptr -> fx_media_exfat_bitmap_cache_size_in_sectors << media_ptr -> fx_media_exfat_bytes_per_sector_shift) <<
          BITS_PER_BYTE_SHIFT) - 1;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 
     /* Return driver status.  */
     return(media_ptr -> fx_media_driver_status);
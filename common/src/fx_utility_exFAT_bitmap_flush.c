@@ -59,6 +59,7 @@
 /*  CALLS                                                                 */
 /*                                                                        */
 /*    Media driver                                                        */
+/*    _fx_utility_exFAT_bitmap_window_flush Flush bitmap window           */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -76,6 +77,49 @@
 UINT  _fx_utility_exFAT_bitmap_flush(FX_MEDIA *media_ptr)
 {
 
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+ULONG i;
+UINT  status;
+
+
+    /* Check if the bitmap cache is dirty.  */
+    if (FX_TRUE == media_ptr -> fx_media_exfat_bitmap_cache_dirty)
+    {
+
+        /* The dirty flag of the cache also stands for the window in use, as it did
+           for the single window, so the window is written even if changed directly.  */
+        if (media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_sectors)
+        {
+            media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_dirty =  FX_TRUE;
+        }
+
+        /* Write each dirty window.  */
+        for (i = 0; i < media_ptr -> fx_media_exfat_bitmap_windows_count; i++)
+        {
+
+            /* Write the window if it is dirty.  */
+            status =  _fx_utility_exFAT_bitmap_window_flush(media_ptr, &media_ptr -> fx_media_exfat_bitmap_windows[i]);
+
+            /* Determine if the write was successful.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+        }
+
+        /* Set bitmap cache dirty flag to false.  */
+        media_ptr -> fx_media_exfat_bitmap_cache_dirty =  FX_FALSE;
+    }
+    else
+    {
+
+        /* Initialize return status to success.  */
+        media_ptr -> fx_media_driver_status =  FX_SUCCESS;
+    }
+#else
+
     /* Check if the bitmap cache is dirty.  */
     if (FX_TRUE == media_ptr -> fx_media_exfat_bitmap_cache_dirty)
     {
@@ -107,6 +151,7 @@ UINT  _fx_utility_exFAT_bitmap_flush(FX_MEDIA *media_ptr)
         /* Initialize return status to success.  */
         media_ptr -> fx_media_driver_status =  FX_SUCCESS;
     }
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 
     return(media_ptr -> fx_media_driver_status);
 }
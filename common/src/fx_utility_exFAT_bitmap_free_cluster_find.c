@@ -60,7 +60,10 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _fx_utility_exFAT_bitmap_free_run_find                              */
+/*                                          Find free clusters in bitmap  */
 /*    _fx_utility_exFAT_cluster_state_get   Get cluster state             */
+/*    _fx_utility_exFAT_reservation_release Release reserved clusters     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -78,6 +81,61 @@
 UINT  _fx_utility_exFAT_bitmap_free_cluster_find(FX_MEDIA *media_ptr, ULONG search_start_cluster, ULONG *free_cluster)
 {
 
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+UINT  status;
+ULONG run_start;
+ULONG run_clusters;
+
+
+    /* Search for a free cluster a word at a time, from the start cluster to the end.  */
+    status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, search_start_cluster,
+                                                     media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START,
+                                                     1, &run_start, &run_clusters);
+
+    /* Determine if there was no free cluster and there is anything to search in the beginning.  */
+    if ((status == FX_SUCCESS) && (run_clusters == 0) && (search_start_cluster > FX_FAT_ENTRY_START))
+    {
+
+        /* Search from the beginning to the start cluster.  */
+        status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, FX_FAT_ENTRY_START, search_start_cluster,
+                                                         1, &run_start, &run_clusters);
+    }
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+
+    /* Determine if only the clusters reserved for open files are free.  */
+    if ((status == FX_SUCCESS) && (run_clusters == 0) && (_fx_utility_exFAT_reservation_release(media_ptr)))
+    {
+
+        /* Search again with the reservations released.  */
+        status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, FX_FAT_ENTRY_START,
+                                                         media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START,
+                                                         1, &run_start, &run_clusters);
+    }
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
+
+    /* Check for a bad status.  */
+    if (status != FX_SUCCESS)
+    {
+
+        /* Media error - stop searching.  */
+        return(status);
+    }
+
+    /* Determine if a free cluster was found.  */
+    if (run_clusters)
+    {
+
+        /* Return the cluster.  */
+        *free_cluster =  run_start;
+
+        /* Return success.  */
+        return(FX_SUCCESS);
+    }
+
+    /* No more free clusters, return error.  */
+    return(FX_NO_MORE_SPACE);
+#else
 UINT  status;
 UCHAR cluster_state;
 ULONG cluster = search_start_cluster;
@@ -155,6 +213,7 @@ ULONG cluster = search_start_cluster;
 
     /* No more free clusters, return error.  */
     return(FX_NO_MORE_SPACE);
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 }
 
 #endif /* FX_ENABLE_EXFAT */
@@ -0,0 +1,389 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+#include "fx_directory_exFAT.h"
+#ifdef FX_ENABLE_FAULT_TOLERANT
+#include "fx_fault_tolerant.h"
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_free_run_find              PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function searches the exFAT allocation bitmap from the first   */
+/*    cluster up to, but not including, the last cluster for the first    */
+/*    run of the requested number of consecutive free clusters. The       */
+/*    bitmap is examined 64 clusters at a time, the used clusters before  */
+/*    a run and the free clusters of a run are counted with               */
+/*    FX_TRAILING_ZEROS_64. If there is no run long enough, the longest   */
+/*    run is returned, which has no clusters if none is free.             */
+/*                                                                        */
+/*    Bitmap sectors the summary shows as fully used are skipped without  */
+/*    being read, and a sector found fully used is added to the summary.  */
+/*    While a fault tolerant transaction is started the state of each     */
+/*    cluster is read instead, so the changes held in the log are seen.   */
+/*    Clusters reserved for open files are not counted as free.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    first_cluster                         First cluster to search       */
+/*    last_cluster                          Cluster after the last one to */
+/*                                            search                      */
+/*    clusters                              Number of consecutive clusters*/
+/*    start_cluster                         ULONG pointer to store first  */
+/*                                            cluster                     */
+/*    run_clusters                          ULONG pointer to store number */
+/*                                            of clusters found, at most  */
+/*                                            clusters                    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_cache_prepare                              */
+/*                                          Prepare bitmap cache          */
+/*    _fx_utility_exFAT_cluster_state_get   Get cluster state             */
+/*    _fx_utility_32_unsigned_read          Read a ULONG from memory      */
+/*    _fx_utility_exFAT_reservation_mask    Get reserved clusters         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_extended_allocate            Allocate space for a file     */
+/*    _fx_file_extended_best_effort_allocate                              */
+/*                                          Allocate space for a file     */
+/*    _fx_utility_exFAT_bitmap_free_cluster_find                          */
+/*                                          Find free cluster             */
+/*    _fx_utility_exFAT_reserved_cluster_get                              */
+/*                                          Get a reserved cluster        */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_exFAT_bitmap_free_run_find(FX_MEDIA *media_ptr, ULONG first_cluster, ULONG last_cluster, ULONG clusters,
+                                             ULONG *start_cluster, ULONG *run_clusters)
+{
+
+UINT    status;
+UINT    direct;
+UINT    sector_whole;
+UINT    sector_free;
+UCHAR   cluster_state;
+UCHAR  *buffer_ptr;
+ULONG  *summary_ptr;
+ULONG   cluster;
+ULONG   sector;
+ULONG   sector_start;
+ULONG   sector_end;
+ULONG   offset;
+ULONG   bits;
+ULONG   count;
+ULONG   run_start;
+ULONG   run_length;
+ULONG   best_start;
+ULONG   best_length;
+ULONG64 free_bits;
+
+
+    /* Default to reading the cached bitmap directly and using the summary.  */
+    direct =       FX_TRUE;
+    summary_ptr =  media_ptr -> fx_media_exfat_bitmap_summary;
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+    if (media_ptr -> fx_media_fault_tolerant_enabled &&
+        (media_ptr -> fx_media_fault_tolerant_state & FX_FAULT_TOLERANT_STATE_STARTED))
+    {
+
+        /* The cluster states changed by the current transaction are in the fault tolerant
+           log, so get each state and neither use nor update the summary.  */
+        direct =       FX_FALSE;
+        summary_ptr =  FX_NULL;
+    }
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+    /* Do not search beyond the last cluster of the media.  */
+    if (last_cluster > media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START)
+    {
+        last_cluster =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START;
+    }
+
+    /* Setup the search.  */
+    run_start =    first_cluster;
+    run_length =   0;
+    best_start =   first_cluster;
+    best_length =  0;
+    cluster =      first_cluster;
+    buffer_ptr =   FX_NULL;
+
+    /* Loop through the bitmap sectors until a run long enough is found.  */
+    while ((cluster < last_cluster) && (best_length < clusters))
+    {
+
+        /* Calculate the bitmap sector of the cluster and its clusters.  */
+        sector =        (cluster - FX_FAT_ENTRY_START) >> media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift;
+        sector_start =  (sector << media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift) + FX_FAT_ENTRY_START;
+        sector_end =    sector_start + (((ULONG)1) << media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift);
+        if (sector_end > media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START)
+        {
+            sector_end =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START;
+        }
+
+        /* Determine if the summary shows all clusters of the sector are used.  */
+        if ((summary_ptr) && (summary_ptr[sector >> 5] & (((ULONG)1) << (sector & 31))))
+        {
+
+            /* Yes, skip the sector without reading it.  */
+            run_length =  0;
+            cluster =     sector_end;
+            continue;
+        }
+
+        /* The summary is only updated for a sector that is searched completely.  */
+        sector_whole =  FX_FALSE;
+        if ((cluster == sector_start) && (sector_end <= last_cluster))
+        {
+            sector_whole =  FX_TRUE;
+        }
+        else if (sector_end > last_cluster)
+        {
+            sector_end =  last_cluster;
+        }
+
+        /* Determine if the cached bitmap is read directly.  */
+        if (direct)
+        {
+
+            /* Bring the bitmap sector into a window of the cache.  */
+            status =  _fx_utility_exFAT_bitmap_cache_prepare(media_ptr, cluster);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Pickup the buffer of the window.  */
+            buffer_ptr =  media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_buffer;
+        }
+
+        /* Loop through the 64 cluster words of the sector.  */
+        sector_free =  FX_FALSE;
+        while ((cluster < sector_end) && (best_length < clusters))
+        {
+
+            /* Calculate the number of clusters of the word from this cluster on.  */
+            bits =  64 - ((cluster - FX_FAT_ENTRY_START) & 63);
+            if (bits > sector_end - cluster)
+            {
+                bits =  sector_end - cluster;
+            }
+
+            /* Build the word of free clusters, bit 0 for this cluster.  */
+            if (direct)
+            {
+
+                /* Read the 64 bits of the word from the window.  */
+                offset =  ((cluster - media_ptr -> fx_media_exfat_bitmap_cache_start_cluster) >> 6) << 3;
+                free_bits =  (ULONG64)_fx_utility_32_unsigned_read(buffer_ptr + offset) |
+                             (((ULONG64)_fx_utility_32_unsigned_read(buffer_ptr + offset + 4)) << 32);
+                free_bits =  (~free_bits) >> ((cluster - FX_FAT_ENTRY_START) & 63);
+            }
+            else
+            {
+
+                /* Get the state of each cluster.  */
+                free_bits =  0;
+                for (count = 0; count < bits; count++)
+                {
+
+                    /* Get the cluster state.  */
+                    status =  _fx_utility_exFAT_cluster_state_get(media_ptr, cluster + count, &cluster_state);
+
+                    /* Check for a bad status.  */
+                    if (status != FX_SUCCESS)
+                    {
+
+                        /* Return the bad status.  */
+                        return(status);
+                    }
+
+                    /* Determine if the cluster is free.  */
+                    if (cluster_state == FX_EXFAT_BITMAP_CLUSTER_FREE)
+                    {
+                        free_bits =  free_bits | (((ULONG64)1) << count);
+                    }
+                }
+            }
+
+            /* Clear the bits beyond the clusters to search.  */
+            if (bits < 64)
+            {
+                free_bits =  free_bits & ((((ULONG64)1) << bits) - 1);
+            }
+
+            /* Remember if the sector has a free cluster.  */
+            if (free_bits)
+            {
+                sector_free =  FX_TRUE;
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+
+                /* The clusters reserved for open files are not free to others.  */
+                free_bits =  free_bits & ~_fx_utility_exFAT_reservation_mask(media_ptr, cluster, bits);
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
+            }
+
+            /* Walk the runs of free clusters in the word.  */
+            while (bits)
+            {
+
+                /* Determine if a new run must be started.  */
+                if (run_length == 0)
+                {
+
+                    /* Determine if the word has no more free clusters.  */
+                    if (free_bits == 0)
+                    {
+
+                        /* Move to the next word.  */
+                        cluster =  cluster + bits;
+                        break;
+                    }
+
+                    /* Skip the used clusters to the next free cluster.  */
+                    count =      FX_TRAILING_ZEROS_64(free_bits);
+                    cluster =    cluster + count;
+                    bits =       bits - count;
+                    free_bits =  free_bits >> count;
+                    run_start =  cluster;
+                }
+
+                /* Count the free clusters that extend the run.  */
+                if (~free_bits == 0)
+                {
+                    count =  64;
+                }
+                else
+                {
+                    count =  FX_TRAILING_ZEROS_64(~free_bits);
+                }
+                if (count > bits)
+                {
+                    count =  bits;
+                }
+
+                /* Determine if the next cluster is used.  */
+                if (count == 0)
+                {
+
+                    /* Yes, end the run.  */
+                    run_length =  0;
+                    continue;
+                }
+
+                /* Extend the run.  */
+                run_length =  run_length + count;
+                cluster =     cluster + count;
+                bits =        bits - count;
+                if (count < 64)
+                {
+                    free_bits =  free_bits >> count;
+                }
+                else
+                {
+                    free_bits =  0;
+                }
+
+                /* Remember the longest run.  */
+                if (run_length > best_length)
+                {
+                    best_start =   run_start;
+                    best_length =  run_length;
+                }
+
+                /* Determine if the run is long enough.  */
+                if (best_length >= clusters)
+                {
+                    break;
+                }
+
+                /* A used cluster ends the run within the word.  */
+                if (bits)
+                {
+                    run_length =  0;
+                }
+            }
+        }
+
+        /* Determine if all clusters of the sector were found used.  */
+        if ((summary_ptr) && (sector_whole) && (sector_free == FX_FALSE))
+        {
+
+            /* Yes, mark the sector in the summary.  */
+            summary_ptr[sector >> 5] =  summary_ptr[sector >> 5] | (((ULONG)1) << (sector & 31));
+        }
+    }
+
+    /* Return no more than the requested number of clusters.  */
+    if (best_length > clusters)
+    {
+        best_length =  clusters;
+    }
+
+    /* Return the run found.  */
+    *start_cluster =  best_start;
+    *run_clusters =   best_length;
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
@@ -128,6 +128,20 @@ ULONG bitmap_total_size_in_bytes;
             media_ptr -> fx_media_exfat_bytes_per_sector_shift +
             BITS_PER_BYTE_SHIFT;
 
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+
+        /* Use the one window of the media control block until the cache is configured.  */
+        media_ptr -> fx_media_exfat_bitmap_window.fx_exfat_bitmap_window_buffer =     media_ptr -> fx_media_exfat_bitmap_cache;
+        media_ptr -> fx_media_exfat_bitmap_window.fx_exfat_bitmap_window_sectors =    0;
+        media_ptr -> fx_media_exfat_bitmap_window.fx_exfat_bitmap_window_last_used =  0;
+        media_ptr -> fx_media_exfat_bitmap_window.fx_exfat_bitmap_window_dirty =      FX_FALSE;
+        media_ptr -> fx_media_exfat_bitmap_windows =         &media_ptr -> fx_media_exfat_bitmap_window;
+        media_ptr -> fx_media_exfat_bitmap_windows_count =   1;
+        media_ptr -> fx_media_exfat_bitmap_window_current =  &media_ptr -> fx_media_exfat_bitmap_window;
+        media_ptr -> fx_media_exfat_bitmap_window_clock =    0;
+        media_ptr -> fx_media_exfat_bitmap_summary =         FX_NULL;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
+
         /* Start at initial cluster.  */
         cluster =  FX_FAT_ENTRY_START;
 
@@ -0,0 +1,118 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_utility.h"
+#include "fx_directory_exFAT.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_window_flush               PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function writes a window of the exFAT bitmap cache to the      */
+/*    media if it is dirty.                                               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    window_ptr                            Bitmap window pointer         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    Media driver                                                        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_cache_prepare                              */
+/*                                          Prepare bitmap cache          */
+/*    _fx_utility_exFAT_bitmap_flush        Flush exFAT allocation bitmap */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_exFAT_bitmap_window_flush(FX_MEDIA *media_ptr, FX_EXFAT_BITMAP_WINDOW *window_ptr)
+{
+
+    /* Check if the window is dirty.  */
+    if (window_ptr -> fx_exfat_bitmap_window_dirty)
+    {
+
+        /* Write the bitmap sectors of the window.  */
+        media_ptr -> fx_media_driver_request =  FX_DRIVER_WRITE;
+        media_ptr -> fx_media_driver_status =   FX_IO_ERROR;
+        media_ptr -> fx_media_driver_buffer  =  window_ptr -> fx_exfat_bitmap_window_buffer;
+        media_ptr -> fx_media_driver_sectors =  window_ptr -> fx_exfat_bitmap_window_sectors;
+
+        media_ptr -> fx_media_driver_logical_sector =  media_ptr -> fx_media_exfat_bitmap_start_sector +
+            ((window_ptr -> fx_exfat_bitmap_window_start_cluster - FX_FAT_ENTRY_START) >>
+             media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift);
+
+        /* Invoke the driver to write the bitmap sectors.  */
+        (media_ptr -> fx_media_driver_entry)(media_ptr);
+
+        /* Determine if the write was successful.  */
+        if (media_ptr -> fx_media_driver_status == FX_SUCCESS)
+        {
+
+            /* Set the window dirty flag to false.  */
+            window_ptr -> fx_exfat_bitmap_window_dirty =  FX_FALSE;
+        }
+    }
+    else
+    {
+
+        /* Initialize return status to success.  */
+        media_ptr -> fx_media_driver_status =  FX_SUCCESS;
+    }
+
+    /* Return driver status.  */
+    return(media_ptr -> fx_media_driver_status);
+}
+
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
@@ -123,7 +123,11 @@ ULONG value;
         bitmap_offset = (UINT)(cluster - media_ptr -> fx_media_exfat_bitmap_cache_start_cluster) >> BITS_PER_BYTE_SHIFT;
 
         /* Pickup the 8 cluster block.  */
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+        eight_clusters_block = *(media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_buffer + bitmap_offset);
+#else
         eight_clusters_block = *(media_ptr -> fx_media_exfat_bitmap_cache + bitmap_offset);
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 
         /* Check all 8 bits for 0x00 (all clusters in the block are free).  */
         if (eight_clusters_block == 0x00)
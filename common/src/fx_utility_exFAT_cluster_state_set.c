@@ -86,6 +86,10 @@ UINT  status;
 UCHAR cluster_state;
 UINT  bitmap_offset;
 UCHAR cluster_shift;
+UCHAR *bitmap_ptr;
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+ULONG sector;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
 
 #ifdef FX_ENABLE_FAULT_TOLERANT
     if (media_ptr -> fx_media_fault_tolerant_enabled &&
@@ -119,18 +123,38 @@ UCHAR cluster_shift;
             /* Calculate where the cluster is located.  */
             cluster_shift =  (UCHAR)((cluster - FX_FAT_ENTRY_START) % BITS_PER_BYTE);
 
+            /* Pickup the cached bitmap.  */
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+            bitmap_ptr =  media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_buffer;
+
+            /* Mark the window as dirty.  */
+            media_ptr -> fx_media_exfat_bitmap_window_current -> fx_exfat_bitmap_window_dirty =  FX_TRUE;
+#else
+            bitmap_ptr =  media_ptr -> fx_media_exfat_bitmap_cache;
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
+
             /* Is occupied the new state?  */
             if (FX_EXFAT_BITMAP_CLUSTER_OCCUPIED == new_cluster_state)
             {
 
                 /* Yes, mark this cluster as occupied.  */
-                *(media_ptr -> fx_media_exfat_bitmap_cache + bitmap_offset) = (UCHAR)(*(media_ptr -> fx_media_exfat_bitmap_cache + bitmap_offset) | (1 << cluster_shift));
+                *(bitmap_ptr + bitmap_offset) = (UCHAR)(*(bitmap_ptr + bitmap_offset) | (1 << cluster_shift));
             }
             else
             {
 
                 /* No, mark this cluster as not occupied.  */
-                *(media_ptr -> fx_media_exfat_bitmap_cache + bitmap_offset) &=  (UCHAR)~(1 << cluster_shift);
+                *(bitmap_ptr + bitmap_offset) &=  (UCHAR)~(1 << cluster_shift);
+
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+
+                /* The bitmap sector of the cluster is no longer full.  */
+                if (media_ptr -> fx_media_exfat_bitmap_summary)
+                {
+                    sector =  (cluster - FX_FAT_ENTRY_START) >> media_ptr -> fx_media_exfat_bitmap_clusters_per_sector_shift;
+                    media_ptr -> fx_media_exfat_bitmap_summary[sector >> 5] &=  ~(((ULONG)1) << (sector & 31));
+                }
+#endif /* FX_ENABLE_EXFAT_BITMAP_WINDOWS */
             }
 
             /* Mark the cache as dirty.  */
@@ -0,0 +1,146 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_file.h"
+#include "fx_utility.h"
+#include "fx_directory_exFAT.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_exFAT_reservation_mask                  PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns which of up to 64 clusters, starting at the   */
+/*    cluster given, are in the window of free clusters reserved for an   */
+/*    open file. Bit 0 of the mask stands for the cluster given.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cluster                               First cluster                 */
+/*    clusters                              Number of clusters, 1 to 64   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    mask                                  Reserved clusters             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_extended_allocate            Allocate space for a file     */
+/*    _fx_file_extended_best_effort_allocate                              */
+/*                                          Best effort allocate space    */
+/*    _fx_utility_exFAT_allocate_new_cluster                              */
+/*                                          Allocate a new cluster        */
+/*    _fx_utility_exFAT_bitmap_free_run_find                              */
+/*                                          Find free clusters in bitmap  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+ULONG64  _fx_utility_exFAT_reservation_mask(FX_MEDIA *media_ptr, ULONG cluster, ULONG clusters)
+{
+
+ULONG64  mask;
+FX_FILE *file_ptr;
+ULONG    open_count;
+ULONG    first_cluster;
+ULONG    end_cluster;
+
+
+    /* No cluster is reserved yet.  */
+    mask =  0;
+
+    /* Loop through the open files of the media.  */
+    file_ptr =    media_ptr -> fx_media_opened_file_list;
+    open_count =  media_ptr -> fx_media_opened_file_count;
+    while (open_count)
+    {
+
+        /* Determine if the file has reserved clusters.  */
+        if (file_ptr -> fx_file_reserved_clusters)
+        {
+
+            /* Calculate the reserved clusters within the clusters given.  */
+            first_cluster =  file_ptr -> fx_file_reserved_cluster;
+            end_cluster =    first_cluster + file_ptr -> fx_file_reserved_clusters;
+            if (first_cluster < cluster)
+            {
+                first_cluster =  cluster;
+            }
+            if (end_cluster > cluster + clusters)
+            {
+                end_cluster =  cluster + clusters;
+            }
+
+            /* Determine if any of them are reserved.  */
+            if (first_cluster < end_cluster)
+            {
+
+                /* Set the bits of the reserved clusters.  */
+                if (end_cluster - first_cluster == 64)
+                {
+                    mask =  ~((ULONG64)0);
+                }
+                else
+                {
+                    mask =  mask | (((((ULONG64)1) << (end_cluster - first_cluster)) - 1) << (first_cluster - cluster));
+                }
+            }
+        }
+
+        /* Move to the next open file.  */
+        file_ptr =  file_ptr -> fx_file_opened_next;
+        open_count--;
+    }
+
+    /* Return the reserved clusters.  */
+    return(mask);
+}
+
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
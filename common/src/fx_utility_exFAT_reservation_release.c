@@ -0,0 +1,108 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_file.h"
+#include "fx_utility.h"
+#include "fx_directory_exFAT.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_exFAT_reservation_release               PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function releases the windows of free clusters reserved for    */
+/*    all open files of the media, when no other free cluster is left.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    clusters                              Number of clusters released   */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_free_cluster_find                          */
+/*                                          Find exFAT free cluster       */
+/*    _fx_utility_exFAT_reserved_cluster_get                              */
+/*                                          Get a reserved cluster        */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+ULONG  _fx_utility_exFAT_reservation_release(FX_MEDIA *media_ptr)
+{
+
+FX_FILE *file_ptr;
+ULONG    open_count;
+ULONG    clusters;
+
+
+    /* Loop through the open files of the media.  */
+    clusters =    0;
+    file_ptr =    media_ptr -> fx_media_opened_file_list;
+    open_count =  media_ptr -> fx_media_opened_file_count;
+    while (open_count)
+    {
+
+        /* Release the reserved clusters of the file.  */
+        clusters =  clusters + file_ptr -> fx_file_reserved_clusters;
+        file_ptr -> fx_file_reserved_clusters =  0;
+
+        /* Move to the next open file.  */
+        file_ptr =  file_ptr -> fx_file_opened_next;
+        open_count--;
+    }
+
+    /* Return the number of clusters released.  */
+    return(clusters);
+}
+
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
@@ -0,0 +1,217 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+#include "fx_system.h"
+#include "fx_media.h"
+#include "fx_file.h"
+#include "fx_utility.h"
+#include "fx_directory_exFAT.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_exFAT_reserved_cluster_get              PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the next cluster for a file written on an     */
+/*    exFAT media, from the window of free clusters reserved for the      */
+/*    file. When the window is used up, or does not continue the file, a  */
+/*    new window of FX_EXFAT_RESERVATION_CLUSTERS, or of the clusters     */
+/*    still needed if more, is reserved. The new window continues the     */
+/*    file if the clusters after it are free, otherwise it is the first   */
+/*    run of that many free clusters, or the longest run if there is      */
+/*    none that long.                                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    file_ptr                              File control block pointer    */
+/*    last_cluster                          Last cluster of the file, or  */
+/*                                            0 if it has no cluster      */
+/*    clusters                              Number of clusters still      */
+/*                                            needed                      */
+/*    cluster                               Pointer to the cluster        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_exFAT_bitmap_free_run_find                              */
+/*                                          Find free clusters in bitmap  */
+/*    _fx_utility_exFAT_reservation_release                               */
+/*                                          Release reserved clusters     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_write                        Write data to file            */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_exFAT_reserved_cluster_get(FX_MEDIA *media_ptr, FX_FILE *file_ptr, ULONG last_cluster, ULONG clusters,
+                                             ULONG *cluster)
+{
+
+UINT  status;
+ULONG end_cluster;
+ULONG stop_cluster;
+ULONG start_cluster;
+ULONG run_clusters;
+ULONG other_start_cluster;
+ULONG other_run_clusters;
+
+
+    /* A window that does not continue the file is given up.  */
+    if ((file_ptr -> fx_file_reserved_clusters) && (last_cluster) &&
+        (file_ptr -> fx_file_reserved_cluster != last_cluster + 1))
+    {
+        file_ptr -> fx_file_reserved_clusters =  0;
+    }
+
+    /* Determine if a new window must be reserved.  */
+    if (file_ptr -> fx_file_reserved_clusters == 0)
+    {
+
+        /* Reserve at least the default number of clusters.  */
+        if (clusters < FX_EXFAT_RESERVATION_CLUSTERS)
+        {
+            clusters =  FX_EXFAT_RESERVATION_CLUSTERS;
+        }
+        end_cluster =   media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START;
+        start_cluster = 0;
+        run_clusters =  0;
+
+        /* Determine if the clusters after the file can continue it.  */
+        if ((last_cluster) && (last_cluster + 1 < end_cluster))
+        {
+
+            /* Look for the free clusters after the file.  */
+            stop_cluster =  last_cluster + 1 + clusters;
+            if ((stop_cluster > end_cluster) || (stop_cluster <= last_cluster))
+            {
+                stop_cluster =  end_cluster;
+            }
+            status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, last_cluster + 1, stop_cluster, clusters,
+                                                             &start_cluster, &run_clusters);
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+
+            /* Only a run right after the file continues it.  */
+            if (start_cluster != last_cluster + 1)
+            {
+                run_clusters =  0;
+            }
+        }
+
+        /* Determine if the file cannot be continued.  */
+        if (run_clusters == 0)
+        {
+
+            /* Find the first run of free clusters from the search start to the end.  */
+            status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, media_ptr -> fx_media_cluster_search_start,
+                                                             end_cluster, clusters, &start_cluster, &run_clusters);
+
+            /* Determine if the run is not long enough and the clusters before the search start
+               are still to be searched.  */
+            if ((status == FX_SUCCESS) && (run_clusters < clusters) &&
+                (media_ptr -> fx_media_cluster_search_start > FX_FAT_ENTRY_START))
+            {
+
+                /* Search the whole media and keep the longer run.  */
+                status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, FX_FAT_ENTRY_START, end_cluster, clusters,
+                                                                 &other_start_cluster, &other_run_clusters);
+                if ((status == FX_SUCCESS) && (other_run_clusters > run_clusters))
+                {
+                    start_cluster =  other_start_cluster;
+                    run_clusters =   other_run_clusters;
+                }
+            }
+
+            /* Determine if only the clusters reserved for other files are free.  */
+            if ((status == FX_SUCCESS) && (run_clusters == 0) && (_fx_utility_exFAT_reservation_release(media_ptr)))
+            {
+
+                /* Search again with the reservations released.  */
+                status =  _fx_utility_exFAT_bitmap_free_run_find(media_ptr, FX_FAT_ENTRY_START, end_cluster, clusters,
+                                                                 &start_cluster, &run_clusters);
+            }
+
+            /* Check for a bad status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the bad status.  */
+                return(status);
+            }
+        }
+
+        /* Determine if there is no free cluster.  */
+        if (run_clusters == 0)
+        {
+
+            /* Return the no more space error.  */
+            return(FX_NO_MORE_SPACE);
+        }
+
+        /* Reserve the clusters for the file.  */
+        file_ptr -> fx_file_reserved_cluster =   start_cluster;
+        file_ptr -> fx_file_reserved_clusters =  run_clusters;
+    }
+
+    /* Take the first cluster of the window.  */
+    *cluster =  file_ptr -> fx_file_reserved_cluster;
+    file_ptr -> fx_file_reserved_cluster++;
+    file_ptr -> fx_file_reserved_clusters--;
+
+    /* Return success.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_EXFAT_CLUSTER_RESERVATION */
@@ -0,0 +1,97 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_demote       PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function moves the specified cache entry to the tail of the    */
+/*    doubly-linked cached sector list, or of the probationary queue the  */
+/*    entry is on, so that it is the first entry to be reused. This is    */
+/*    used for entries that have been invalidated.                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cache_entry                           Cache entry to move           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_link                         */
+/*                                          Link cache entry into list    */
+/*    _fx_utility_logical_sector_cache_entry_unlink                       */
+/*                                          Unlink cache entry from list  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_logical_sector_flush      Flush and invalidate sectors  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_logical_sector_cache_entry_demote(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry)
+{
+
+
+    /* Determine if the entry is already at the tail of its list.  */
+    if (cache_entry -> fx_cached_sector_next_used == FX_NULL)
+    {
+
+        /* Yes, nothing to do.  */
+        return;
+    }
+
+    /* Unlink the entry from its current position and place it at the tail of the list.  */
+    _fx_utility_logical_sector_cache_entry_unlink(media_ptr, cache_entry);
+    _fx_utility_logical_sector_cache_entry_link(media_ptr, cache_entry, FX_TRUE);
+}
+
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
@@ -0,0 +1,170 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_insert       PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is called after a cache entry has been filled with a  */
+/*    new logical sector. The entry is moved from the hash bucket of the  */
+/*    sector it previously held to the hash bucket of its new sector and  */
+/*    is placed at the head of the cached sector list.                    */
+/*                                                                        */
+/*    If FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE is defined, data sectors   */
+/*    are placed at the head of the probationary queue instead. When the  */
+/*    queue grows beyond its limit, its oldest entry is moved to the      */
+/*    tail of the list, where it is the next entry to be replaced.        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cache_entry                           Cache entry that was filled   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_link                         */
+/*                                          Link cache entry into list    */
+/*    _fx_utility_logical_sector_cache_entry_promote                      */
+/*                                          Move cache entry to head of   */
+/*                                            list                        */
+/*    _fx_utility_logical_sector_cache_entry_unlink                       */
+/*                                          Unlink cache entry from list  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_media_cache_resize                Media cache resize function   */
+/*    _fx_utility_logical_sector_read       Logical sector read function  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_logical_sector_cache_entry_insert(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry)
+{
+
+FX_CACHED_SECTOR **bucket_ptr;
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+FX_CACHED_SECTOR  *oldest_entry;
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+
+    /* Determine if the entry is indexed under a different sector.  */
+    if (cache_entry -> fx_cached_sector_hash_key != cache_entry -> fx_cached_sector)
+    {
+
+        /* Determine if the entry is currently in the hash table.  */
+        if (cache_entry -> fx_cached_sector_hash_key != (~(ULONG64)0))
+        {
+
+            /* Yes, find the link to this entry in its old hash bucket.  */
+            bucket_ptr =  &(media_ptr -> fx_media_sector_cache_hash_table[(ULONG)(cache_entry -> fx_cached_sector_hash_key & media_ptr -> fx_media_sector_cache_hash_mask)]);
+            while ((*bucket_ptr) && (*bucket_ptr != cache_entry))
+            {
+
+                /* Move to the next link in the bucket.  */
+                bucket_ptr =  &((*bucket_ptr) -> fx_cached_sector_hash_next);
+            }
+
+            /* Remove the entry from the old hash bucket.  */
+            if (*bucket_ptr)
+            {
+                *bucket_ptr =  cache_entry -> fx_cached_sector_hash_next;
+            }
+        }
+
+        /* Add the entry to the front of the hash bucket of its new sector.  */
+        bucket_ptr =  &(media_ptr -> fx_media_sector_cache_hash_table[(ULONG)(cache_entry -> fx_cached_sector & media_ptr -> fx_media_sector_cache_hash_mask)]);
+        cache_entry -> fx_cached_sector_hash_next =  *bucket_ptr;
+        *bucket_ptr =  cache_entry;
+
+        /* Remember the sector this entry is indexed under.  */
+        cache_entry -> fx_cached_sector_hash_key =  cache_entry -> fx_cached_sector;
+    }
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* Remove the entry from the list or queue it is currently on.  */
+    _fx_utility_logical_sector_cache_entry_unlink(media_ptr, cache_entry);
+
+    /* Determine if this is a data sector that should be placed on probation.  */
+    if ((cache_entry -> fx_cached_sector_type == FX_DATA_SECTOR) &&
+        (media_ptr -> fx_media_sector_cache_probation_limit))
+    {
+
+        /* Yes, place the entry at the head of the probationary queue.  */
+        cache_entry -> fx_cached_sector_probation =  FX_TRUE;
+        _fx_utility_logical_sector_cache_entry_link(media_ptr, cache_entry, FX_FALSE);
+
+        /* Determine if the probationary queue is too long.  */
+        if (media_ptr -> fx_media_sector_cache_probation_count > media_ptr -> fx_media_sector_cache_probation_limit)
+        {
+
+            /* Yes, move the oldest probationary entry to the tail of the list.  */
+            oldest_entry =  media_ptr -> fx_media_sector_cache_probation_tail;
+            _fx_utility_logical_sector_cache_entry_unlink(media_ptr, oldest_entry);
+            oldest_entry -> fx_cached_sector_probation =  FX_FALSE;
+            _fx_utility_logical_sector_cache_entry_link(media_ptr, oldest_entry, FX_TRUE);
+        }
+    }
+    else
+    {
+
+        /* No, make this entry the most recently used entry of the list.  */
+        cache_entry -> fx_cached_sector_probation =  FX_FALSE;
+        _fx_utility_logical_sector_cache_entry_link(media_ptr, cache_entry, FX_FALSE);
+    }
+#else
+
+    /* Make this entry the most recently used entry.  */
+    _fx_utility_logical_sector_cache_entry_promote(media_ptr, cache_entry);
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+}
+
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
@@ -0,0 +1,160 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_link         PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function links the specified cache entry at the head or at     */
+/*    the tail of the doubly-linked cached sector list. If                */
+/*    FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE is defined and the entry is   */
+/*    marked as probationary, it is linked into the probationary queue    */
+/*    instead. If FX_ENABLE_SECTOR_CACHE_PARTITION is defined, each       */
+/*    cache partition has its own list.                                   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cache_entry                           Cache entry to link           */
+/*    append                                If FX_TRUE, link at the tail, */
+/*                                            otherwise at the head       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_demote                       */
+/*                                          Move cache entry to end of    */
+/*                                            list                        */
+/*    _fx_utility_logical_sector_cache_entry_insert                       */
+/*                                          Index logical sector cache    */
+/*                                            entry                       */
+/*    _fx_utility_logical_sector_cache_entry_promote                      */
+/*                                          Move cache entry to head of   */
+/*                                            list                        */
+/*    _fx_utility_logical_sector_cache_pool_entry_get                     */
+/*                                          Get cache entry from pool     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_logical_sector_cache_entry_link(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry, UINT append)
+{
+
+FX_CACHED_SECTOR **head_ptr;
+FX_CACHED_SECTOR **tail_ptr;
+
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    /* Setup pointers to the head and tail of the list of the entry's partition.  */
+    head_ptr =  &(media_ptr -> fx_media_sector_cache_partition_ptr[cache_entry -> fx_cached_sector_partition]);
+    tail_ptr =  &(media_ptr -> fx_media_sector_cache_partition_tail[cache_entry -> fx_cached_sector_partition]);
+#else
+
+    /* Setup pointers to the head and tail of the list.  */
+    head_ptr =  &(media_ptr -> fx_media_sector_cache_list_ptr);
+    tail_ptr =  &(media_ptr -> fx_media_sector_cache_list_tail);
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* Determine if the entry belongs to the probationary queue.  */
+    if (cache_entry -> fx_cached_sector_probation)
+    {
+
+        /* Yes, use the probationary queue instead.  */
+        head_ptr =  &(media_ptr -> fx_media_sector_cache_probation_ptr);
+        tail_ptr =  &(media_ptr -> fx_media_sector_cache_probation_tail);
+
+        /* Increment the number of entries on the probationary queue.  */
+        media_ptr -> fx_media_sector_cache_probation_count++;
+    }
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+    /* Determine where to place the entry.  */
+    if (append)
+    {
+
+        /* Place this entry at the tail of the list.  */
+        cache_entry -> fx_cached_sector_next_used =      FX_NULL;
+        cache_entry -> fx_cached_sector_previous_used =  *tail_ptr;
+        if (*tail_ptr)
+        {
+            (*tail_ptr) -> fx_cached_sector_next_used =  cache_entry;
+        }
+        else
+        {
+            *head_ptr =  cache_entry;
+        }
+        *tail_ptr =  cache_entry;
+    }
+    else
+    {
+
+        /* Place this entry at the head of the list.  */
+        cache_entry -> fx_cached_sector_previous_used =  FX_NULL;
+        cache_entry -> fx_cached_sector_next_used =      *head_ptr;
+        if (*head_ptr)
+        {
+            (*head_ptr) -> fx_cached_sector_previous_used =  cache_entry;
+        }
+        else
+        {
+            *tail_ptr =  cache_entry;
+        }
+        *head_ptr =  cache_entry;
+    }
+}
+
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_promote      PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function moves the specified cache entry to the head of the    */
+/*    doubly-linked cached sector list, making it the most recently used  */
+/*    entry. If FX_ENABLE_SECTOR_CACHE_PARTITION is defined, this is the  */
+/*    list of the entry's cache partition.                                */
+/*                                                                        */
+/*    If FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE is defined, an entry on    */
+/*    the probationary queue is only moved to the list when it is not     */
+/*    the most recently cached data sector. Repeated references to that   */
+/*    sector come from partial sector accesses of a sequential read and   */
+/*    do not indicate that the sector is reused.                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cache_entry                           Cache entry to move           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_link                         */
+/*                                          Link cache entry into list    */
+/*    _fx_utility_logical_sector_cache_entry_unlink                       */
+/*                                          Unlink cache entry from list  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_insert                       */
+/*                                          Index logical sector cache    */
+/*                                            entry                       */
+/*    _fx_utility_logical_sector_cache_entry_read                         */
+/*                                          Read logical sector cache     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_logical_sector_cache_entry_promote(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry)
+{
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+
+    /* Record the use of the entry, so the oldest entry of all media attached to the
+       cache pool can be found.  */
+    if (media_ptr -> fx_media_sector_cache_pool)
+    {
+        cache_entry -> fx_cached_sector_last_used =  ++(media_ptr -> fx_media_sector_cache_pool -> fx_sector_cache_pool_clock);
+    }
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+    /* Determine if the entry is already at the head of its list. For an entry on the
+       probationary queue, this means it is the most recently cached data sector and
+       stays on probation.  */
+    if (cache_entry -> fx_cached_sector_previous_used == FX_NULL)
+    {
+
+        /* Yes, nothing to do.  */
+        return;
+    }
+
+    /* Unlink the entry from its current position.  */
+    _fx_utility_logical_sector_cache_entry_unlink(media_ptr, cache_entry);
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* The entry has been reused, so it is no longer on probation.  */
+    cache_entry -> fx_cached_sector_probation =  FX_FALSE;
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+    /* Place this entry at the head of the list.  */
+    _fx_utility_logical_sector_cache_entry_link(media_ptr, cache_entry, FX_FALSE);
+}
+
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
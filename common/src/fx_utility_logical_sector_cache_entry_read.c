@@ -45,7 +45,8 @@
 /*    This function handles logical sector cache read requests for the    */
 /*    logical sector read function. If the function finds the requested   */
 /*    sector in the cache, it setup the appropriate pointers and          */
-/*    returns a FX_NULL.                                                  */
+/*    returns a FX_NULL. Otherwise the entry to be replaced is returned,  */
+/*    the caller skips it if it is pinned by fx_file_read_borrow.         */
 /*                                                                        */
 /*  INPUT                                                                 */
 /*                                                                        */
@@ -60,7 +61,14 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    _fx_utility_logical_sector_cache_lookup                             */
+/*                                          Lookup logical sector in the  */
+/*                                            cache hash table            */
+/*    _fx_utility_logical_sector_cache_entry_promote                      */
+/*                                          Move cache entry to head of   */
+/*                                            list                        */
+/*    _fx_utility_logical_sector_cache_pool_entry_get                     */
+/*                                          Get cache entry from pool     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -86,11 +94,86 @@ FX_CACHED_SECTOR  *_fx_utility_logical_sector_cache_entry_read(FX_MEDIA *media_p
 
 #ifndef FX_DISABLE_CACHE
 FX_CACHED_SECTOR *cache_entry;
+#ifndef FX_ENABLE_LRU_SECTOR_CACHE
 FX_CACHED_SECTOR  temp_storage;
 ULONG             cache_size;
 ULONG             index;
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 
 
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+    /* The cached sector list is maintained by the insert and promote functions, so
+       the previous entry is never needed by the caller.  */
+    *previous_cache_entry =  FX_NULL;
+
+    /* Lookup the logical sector in the hash table.  */
+    cache_entry =  _fx_utility_logical_sector_cache_lookup(media_ptr, logical_sector);
+
+    /* Determine if the logical sector is in the cache.  */
+    if (cache_entry)
+    {
+
+        /* Yes, we found a match.  Simply setup the pointer to this
+           buffer and return.  */
+        media_ptr -> fx_media_memory_buffer =  cache_entry -> fx_cached_sector_memory_buffer;
+
+        /* Make this entry the most recently used entry.  */
+        _fx_utility_logical_sector_cache_entry_promote(media_ptr, cache_entry);
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+        /* Increment the number of logical sectors cache read hits.  */
+        media_ptr -> fx_media_logical_sector_cache_read_hits++;
+#endif
+
+        /* Success, return to caller immediately!  */
+        return(FX_NULL);
+    }
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+
+    /* Determine if the media takes its cache entries from a cache pool.  */
+    if (media_ptr -> fx_media_sector_cache_pool)
+    {
+
+        /* Yes, pickup the entry to be replaced from the pool.  */
+        return(_fx_utility_logical_sector_cache_pool_entry_get(media_ptr));
+    }
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    /* The requested sector is not in cache, pickup the least recently used entry of the
+       data partition. The caller replaces it with the entry of the partition of the
+       sector type if the cache is partitioned.  */
+    cache_entry =  media_ptr -> fx_media_sector_cache_partition_tail[FX_SECTOR_CACHE_PARTITION_DATA];
+#else
+
+    /* The requested sector is not in cache, pickup the least recently used entry.  */
+    cache_entry =  media_ptr -> fx_media_sector_cache_list_tail;
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* Determine if the oldest probationary data sector should be replaced instead. This
+       is the case if the probationary queue is full or its oldest entry is unused, unless
+       the least recently used entry of the list is unused itself.  */
+    if ((cache_entry -> fx_cached_sector_valid) &&
+        (media_ptr -> fx_media_sector_cache_probation_tail) &&
+        ((media_ptr -> fx_media_sector_cache_probation_count >= media_ptr -> fx_media_sector_cache_probation_limit) ||
+         ((media_ptr -> fx_media_sector_cache_probation_tail) -> fx_cached_sector_valid == FX_FALSE)))
+    {
+
+        /* Yes, replace the oldest probationary entry.  */
+        cache_entry =  media_ptr -> fx_media_sector_cache_probation_tail;
+    }
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+    /* Return the entry to be replaced.  */
+    return(cache_entry);
+#else
+
     /* Determine if the logical sector cache access should use the hash function.  */
     if (media_ptr -> fx_media_sector_cache_hashed)
     {
@@ -349,6 +432,7 @@ ULONG             index;
 
     /* The requested sector is not in cache, return the last cache entry.  */
     return(cache_entry);
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 #else
     FX_PARAMETER_NOT_USED(media_ptr);
     FX_PARAMETER_NOT_USED(logical_sector);
@@ -0,0 +1,115 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_unpinned     PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the cache entry that replaces the specified   */
+/*    entry, which is the least recently used entry of a list. Entries    */
+/*    pinned by fx_file_read_borrow are skipped towards the head of the   */
+/*    list. If FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE is defined and all   */
+/*    entries of the probationary queue are pinned, the least recently    */
+/*    used entry of the list that is not pinned is returned instead.      */
+/*                                                                        */
+/*    If every entry that could be replaced is pinned, FX_NULL is         */
+/*    returned, which the caller must not take for a cache hit.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cache_entry                           Least recently used entry     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    FX_CACHED_SECTOR *                    Cache entry to replace, or    */
+/*                                            FX_NULL if all are pinned   */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_logical_sector_read       Read a logical sector         */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+FX_CACHED_SECTOR  *_fx_utility_logical_sector_cache_entry_unpinned(FX_MEDIA *media_ptr, FX_CACHED_SECTOR *cache_entry)
+{
+
+
+    /* Move towards the head of the list past the pinned entries.  */
+    while ((cache_entry) && (cache_entry -> fx_cached_sector_pin_count))
+    {
+        cache_entry =  cache_entry -> fx_cached_sector_previous_used;
+    }
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* Determine if all entries of the probationary queue are pinned.  */
+    if (cache_entry == FX_NULL)
+    {
+
+        /* Yes, search the list from its least recently used entry instead.  */
+        cache_entry =  media_ptr -> fx_media_sector_cache_list_tail;
+        while ((cache_entry) && (cache_entry -> fx_cached_sector_pin_count))
+        {
+            cache_entry =  cache_entry -> fx_cached_sector_previous_used;
+        }
+    }
+#else
+
+    FX_PARAMETER_NOT_USED(media_ptr);
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+    /* Return the entry to replace.  */
+    return(cache_entry);
+}
+
+#endif /* FX_ENABLE_FILE_READ_BORROW */
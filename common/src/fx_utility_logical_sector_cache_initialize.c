@@ -0,0 +1,354 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_initialize         PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function builds the logical sector cache of the media from the */
+/*    memory supplied by the application. Each sector of the cache is     */
+/*    given one sector sized slot at the beginning of the memory area.    */
+/*                                                                        */
+/*    If FX_ENABLE_LRU_SECTOR_CACHE is defined and the memory holds more  */
+/*    than FX_MAX_SECTOR_CACHE sectors, the cache control blocks and hash */
+/*    buckets are allocated from the memory that follows the sector       */
+/*    buffers instead of using the control blocks built into the media    */
+/*    control block, so the cache size is only limited by the supplied    */
+/*    memory.                                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    memory_ptr                            Pointer to memory used by the */
+/*                                            cache                       */
+/*    memory_size                           Size of the memory            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_media_cache_resize                Media cache resize function   */
+/*    _fx_media_open                        Media open function           */
+/*    _fx_utility_logical_sector_cache_pool_release                       */
+/*                                          Return cache entries to pool  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_logical_sector_cache_initialize(FX_MEDIA *media_ptr, VOID *memory_ptr, ULONG memory_size)
+{
+
+#ifndef FX_DISABLE_CACHE
+FX_CACHED_SECTOR *cache_entry_ptr;
+ULONG             i;
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+ULONG             cache_size;
+ULONG             hash_size;
+ALIGN_TYPE        control_ptr;
+ALIGN_TYPE        address_mask;
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+
+
+    /* Determine how many logical sectors can be cached with user's supplied
+       buffer area - there must be at least enough for one sector!  */
+    media_ptr -> fx_media_sector_cache_size =  memory_size / media_ptr -> fx_media_bytes_per_sector;
+
+    /* Is there at least one?  */
+    if (media_ptr -> fx_media_sector_cache_size == 0)
+    {
+
+        /* Error in the buffer size supplied by user.  */
+        return(FX_BUFFER_ERROR);
+    }
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+    /* By default, use the cache control blocks and hash buckets built into the media
+       control block.  */
+    media_ptr -> fx_media_sector_cache =             media_ptr -> fx_media_sector_cache_built_in;
+    media_ptr -> fx_media_sector_cache_hash_table =  media_ptr -> fx_media_sector_cache_hash_built_in;
+
+    /* Determine if the built-in control blocks are insufficient.  */
+    if (media_ptr -> fx_media_sector_cache_size > FX_MAX_SECTOR_CACHE)
+    {
+
+        /* Yes, the control blocks and hash buckets must come from the supplied memory as
+           well.  Estimate the number of sectors assuming each needs a sector buffer,
+           a control block and at most two hash buckets.  */
+        cache_size =  memory_size / (media_ptr -> fx_media_bytes_per_sector +
+                                     (ULONG)sizeof(FX_CACHED_SECTOR) + (2 * (ULONG)sizeof(FX_CACHED_SECTOR *)));
+
+        /* Setup address mask to align the control blocks.  */
+        address_mask =  sizeof(ULONG64) - 1;
+        address_mask =  ~address_mask;
+
+        /* Adjust the number of sectors downward until everything fits.  */
+        control_ptr =  0;
+        while (cache_size > FX_MAX_SECTOR_CACHE)
+        {
+
+            /* The number of hash buckets is the power of 2 that is equal to or
+               greater than the number of sectors.  */
+            hash_size =  FX_MAX_SECTOR_CACHE;
+            while (hash_size < cache_size)
+            {
+                hash_size =  hash_size << 1;
+            }
+
+            /* The control blocks immediately follow the sector buffers.  */
+            control_ptr =  ((ALIGN_TYPE)memory_ptr) + (cache_size * media_ptr -> fx_media_bytes_per_sector) + (sizeof(ULONG64) - 1);
+            control_ptr =  control_ptr & address_mask;
+
+            /* Determine if the control blocks and the hash buckets fit.  */
+            if ((control_ptr + (cache_size * sizeof(FX_CACHED_SECTOR)) + (hash_size * sizeof(FX_CACHED_SECTOR *))) <=
+                (((ALIGN_TYPE)memory_ptr) + memory_size))
+            {
+                break;
+            }
+
+            /* Try one sector less.  */
+            cache_size--;
+        }
+
+        /* Determine if more sectors than the built-in control blocks can manage fit.  */
+        if (cache_size > FX_MAX_SECTOR_CACHE)
+        {
+
+            /* Yes, setup the control blocks and hash buckets in the supplied memory.  */
+            media_ptr -> fx_media_sector_cache =             (FX_CACHED_SECTOR *)control_ptr;
+            media_ptr -> fx_media_sector_cache_hash_table =  (FX_CACHED_SECTOR **)(control_ptr + (cache_size * sizeof(FX_CACHED_SECTOR)));
+            media_ptr -> fx_media_sector_cache_size =        cache_size;
+        }
+        else
+        {
+
+            /* No, use the built-in control blocks.  */
+            media_ptr -> fx_media_sector_cache_size =  FX_MAX_SECTOR_CACHE;
+        }
+    }
+
+    /* Calculate the number of hash buckets, the power of 2 that is equal to or
+       greater than the number of sectors.  */
+    hash_size =  1;
+    while (hash_size < media_ptr -> fx_media_sector_cache_size)
+    {
+        hash_size =  hash_size << 1;
+    }
+
+    /* Clear the hash buckets.  */
+    for (i = 0; i < hash_size; i++)
+    {
+        media_ptr -> fx_media_sector_cache_hash_table[i] =  FX_NULL;
+    }
+
+    /* Save the mask used to compute the hash bucket of a logical sector.  */
+    media_ptr -> fx_media_sector_cache_hash_mask =  hash_size - 1;
+#else
+
+    /* Adjust the internal cache to fit the fixed number of sector cache control blocks
+       built into the media control block.  */
+    if (media_ptr -> fx_media_sector_cache_size > FX_MAX_SECTOR_CACHE)
+    {
+
+        /* Adjust the number of cache sectors downward.  If this is insufficient,
+           the FX_MAX_SECTOR_CACHE constant in FX_API.H must be changed and the FileX
+           library must be rebuilt.  */
+        media_ptr -> fx_media_sector_cache_size =  FX_MAX_SECTOR_CACHE;
+    }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+
+    /* Otherwise, everything is okay.  Initialize the data structures for managing the
+       logical sector cache.  */
+    cache_entry_ptr =  media_ptr -> fx_media_sector_cache;
+    for (i = 0; i < media_ptr -> fx_media_sector_cache_size; i++)
+    {
+
+        /* Initialize each of the cache entries.  */
+        cache_entry_ptr -> fx_cached_sector_memory_buffer =  (UCHAR *)memory_ptr;
+        cache_entry_ptr -> fx_cached_sector =                (~(ULONG64)0);
+        cache_entry_ptr -> fx_cached_sector_buffer_dirty =   FX_FALSE;
+        cache_entry_ptr -> fx_cached_sector_valid =          FX_FALSE;
+        cache_entry_ptr -> fx_cached_sector_next_used =      cache_entry_ptr + 1;
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+        /* Link the entry back to the previous entry and mark it as not hashed.  */
+        if (i)
+        {
+            cache_entry_ptr -> fx_cached_sector_previous_used =  cache_entry_ptr - 1;
+        }
+        else
+        {
+            cache_entry_ptr -> fx_cached_sector_previous_used =  FX_NULL;
+        }
+        cache_entry_ptr -> fx_cached_sector_hash_next =      FX_NULL;
+        cache_entry_ptr -> fx_cached_sector_hash_key =       (~(ULONG64)0);
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+        cache_entry_ptr -> fx_cached_sector_probation =      FX_FALSE;
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+        cache_entry_ptr -> fx_cached_sector_partition =      FX_SECTOR_CACHE_PARTITION_DATA;
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+#ifdef FX_ENABLE_FILE_READ_BORROW
+        cache_entry_ptr -> fx_cached_sector_pin_count =      0;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+        cache_entry_ptr -> fx_cached_sector_media =          media_ptr;
+        cache_entry_ptr -> fx_cached_sector_last_used =      0;
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
+
+        /* Move to the next cache sector entry.  */
+        cache_entry_ptr++;
+
+        /* Update the memory pointer to the next buffer slot.  */
+        memory_ptr =  (VOID *)(((UCHAR *)memory_ptr) + media_ptr -> fx_media_bytes_per_sector);
+    }
+
+    /* Backup to the last cache entry to set its next pointer to NULL.  */
+    cache_entry_ptr--;
+    cache_entry_ptr -> fx_cached_sector_next_used =  FX_NULL;
+
+    /* Remember the last memory address used by the caching logic.  */
+    media_ptr -> fx_media_sector_cache_end =  ((UCHAR *)memory_ptr) - 1;
+
+    /* Setup the head pointer of the list.  */
+    media_ptr -> fx_media_sector_cache_list_ptr =  media_ptr -> fx_media_sector_cache;
+
+    /* Setup the bit map that keeps track of the valid hashed cache logical sectors.  */
+    media_ptr -> fx_media_sector_cache_hashed_sector_valid =  0;
+
+    /* Clear the counter of the number of outstanding dirty sectors.  */
+    media_ptr -> fx_media_sector_cache_dirty_count =  0;
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+    /* No cache entry is pinned yet.  */
+    media_ptr -> fx_media_sector_cache_pinned_count =  0;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+    /* Setup the tail pointer of the list.  */
+    media_ptr -> fx_media_sector_cache_list_tail =  cache_entry_ptr;
+
+    /* The 4-way hashed cache is not used, all lookups go through the hash table.  */
+    media_ptr -> fx_media_sector_cache_hashed =  FX_FALSE;
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    /* The cache is not partitioned initially, all entries are on the list of the
+       data partition.  */
+    for (i = 0; i < FX_SECTOR_CACHE_PARTITIONS; i++)
+    {
+        media_ptr -> fx_media_sector_cache_partition_ptr[i] =   FX_NULL;
+        media_ptr -> fx_media_sector_cache_partition_tail[i] =  FX_NULL;
+        media_ptr -> fx_media_sector_cache_partition_size[i] =  0;
+    }
+    media_ptr -> fx_media_sector_cache_partition_ptr[FX_SECTOR_CACHE_PARTITION_DATA] =   media_ptr -> fx_media_sector_cache_list_ptr;
+    media_ptr -> fx_media_sector_cache_partition_tail[FX_SECTOR_CACHE_PARTITION_DATA] =  media_ptr -> fx_media_sector_cache_list_tail;
+    media_ptr -> fx_media_sector_cache_partition_size[FX_SECTOR_CACHE_PARTITION_DATA] =  media_ptr -> fx_media_sector_cache_size;
+    media_ptr -> fx_media_sector_cache_partitioned =  FX_FALSE;
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* The probationary queue starts out empty.  */
+    media_ptr -> fx_media_sector_cache_probation_ptr =    FX_NULL;
+    media_ptr -> fx_media_sector_cache_probation_tail =   FX_NULL;
+    media_ptr -> fx_media_sector_cache_probation_count =  0;
+
+    /* Calculate the maximum number of entries on the probationary queue. At least one
+       entry must remain on the list.  */
+    media_ptr -> fx_media_sector_cache_probation_limit =  media_ptr -> fx_media_sector_cache_size >> FX_SECTOR_CACHE_PROBATION_SHIFT;
+    if (media_ptr -> fx_media_sector_cache_probation_limit >= media_ptr -> fx_media_sector_cache_size)
+    {
+        media_ptr -> fx_media_sector_cache_probation_limit =  media_ptr -> fx_media_sector_cache_size - 1;
+    }
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+#else
+
+    /* Determine if the logical sector cache should be managed by the hash function
+       instead of the linear search. The cache must be a power of 2 that is between the
+       minimum and maximum cache size.  */
+    if ((media_ptr -> fx_media_sector_cache_size >= FX_SECTOR_CACHE_HASH_ENABLE) &&
+        ((media_ptr -> fx_media_sector_cache_size ^ (media_ptr -> fx_media_sector_cache_size - 1)) ==
+         (media_ptr -> fx_media_sector_cache_size | (media_ptr -> fx_media_sector_cache_size - 1))))
+    {
+
+
+        /* Set the logical sector cache hash flag. When this flag is set, the logical
+           sector cache is accessed with a hash function instead of a linear search.  */
+        media_ptr -> fx_media_sector_cache_hashed =  FX_TRUE;
+        media_ptr -> fx_media_sector_cache_hash_mask =
+            ((media_ptr -> fx_media_sector_cache_size / FX_SECTOR_CACHE_DEPTH) - 1);
+    }
+    else
+    {
+
+        /* Clear the logical sector cache flag.  */
+        media_ptr -> fx_media_sector_cache_hashed =  FX_FALSE;
+    }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+#else
+
+    /* Without the logical sector cache, the memory is used as a single sector buffer.  */
+    if (memory_size < media_ptr -> fx_media_bytes_per_sector)
+    {
+
+        /* Error in the buffer size supplied by user.  */
+        return(FX_BUFFER_ERROR);
+    }
+    media_ptr -> fx_media_memory_buffer =  (UCHAR *)memory_ptr;
+    media_ptr -> fx_media_memory_buffer_sector =  (ULONG64)-1;
+#endif /* FX_DISABLE_CACHE */
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
@@ -0,0 +1,111 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_lookup             PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function searches the logical sector cache hash table for the  */
+/*    specified logical sector. Only valid entries that currently hold    */
+/*    the sector are returned.                                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    logical_sector                        Logical sector number         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    FX_CACHED_SECTOR *                    Cache entry of the sector, or */
+/*                                            FX_NULL if not cached       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_read                         */
+/*                                          Read logical sector cache     */
+/*    _fx_utility_logical_sector_flush      Flush and invalidate sectors  */
+/*    _fx_utility_logical_sector_write      Logical sector write function */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+FX_CACHED_SECTOR  *_fx_utility_logical_sector_cache_lookup(FX_MEDIA *media_ptr, ULONG64 logical_sector)
+{
+
+FX_CACHED_SECTOR *cache_entry;
+
+
+    /* Pickup the first cache entry in the hash bucket of this logical sector.  */
+    cache_entry =  media_ptr -> fx_media_sector_cache_hash_table[(ULONG)(logical_sector & media_ptr -> fx_media_sector_cache_hash_mask)];
+
+    /* Walk the entries of this hash bucket.  */
+    while (cache_entry)
+    {
+
+        /* Determine if the requested sector has been found.  Entries stay in the bucket
+           of the sector they were last read for until they are reused, so the
+           sector number and valid flag must be checked as well.  */
+        if ((cache_entry -> fx_cached_sector_valid) && (cache_entry -> fx_cached_sector == logical_sector))
+        {
+
+            /* Yes, return the cache entry.  */
+            return(cache_entry);
+        }
+
+        /* Move to the next entry in this hash bucket.  */
+        cache_entry =  cache_entry -> fx_cached_sector_hash_next;
+    }
+
+    /* The logical sector is not in the cache.  */
+    return(FX_NULL);
+}
+
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
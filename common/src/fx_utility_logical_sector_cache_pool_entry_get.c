@@ -0,0 +1,279 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_pool_entry_get     PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the cache entry a media attached to a cache   */
+/*    pool uses for a sector that is not in its cache. An unused entry    */
+/*    of the media is returned first, then a free entry of the pool.      */
+/*                                                                        */
+/*    Otherwise, the least recently used entry of the media is compared   */
+/*    with the least recently used entries of the other attached media    */
+/*    that hold more entries than they reserved, and the oldest of them   */
+/*    is returned. If the media holds fewer entries than it reserved, an  */
+/*    entry of another media is preferred. Only clean entries of other    */
+/*    media are taken, and only from media that are not busy, so the      */
+/*    sectors of a media are always written by that media.                */
+/*                                                                        */
+/*    An entry taken from the pool or another media is invalid and        */
+/*    placed at the end of the list of the media. The caller writes the   */
+/*    returned entry out if it is dirty, just like the least recently     */
+/*    used entry of a private cache.                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    cache_entry                           Cache entry to use for the    */
+/*                                            sector, FX_NULL if the media*/
+/*                                            has none and none could be  */
+/*                                            taken                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_entry_link                         */
+/*                                          Link cache entry into list    */
+/*    _fx_utility_logical_sector_cache_entry_unlink                       */
+/*                                          Unlink cache entry from list  */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Release protection mutex      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_media_cache_pool_attach           Attach media to cache pool    */
+/*    _fx_utility_logical_sector_cache_entry_read                         */
+/*                                          Read logical sector cache     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+FX_CACHED_SECTOR  *_fx_utility_logical_sector_cache_pool_entry_get(FX_MEDIA *media_ptr)
+{
+
+FX_SECTOR_CACHE_POOL *pool_ptr;
+FX_CACHED_SECTOR     *cache_entry;
+FX_CACHED_SECTOR     *candidate_entry;
+FX_CACHED_SECTOR    **bucket_ptr;
+FX_MEDIA             *owner_ptr;
+FX_MEDIA             *other_media_ptr;
+ULONG                 i;
+
+
+    /* Determine if the least recently used entry of the media is unused.  */
+    cache_entry =  media_ptr -> fx_media_sector_cache_list_tail;
+    if ((cache_entry) && (cache_entry -> fx_cached_sector_valid == FX_FALSE))
+    {
+
+        /* Yes, simply reuse it.  */
+        return(cache_entry);
+    }
+
+    /* Pickup the pool of the media.  */
+    pool_ptr =  media_ptr -> fx_media_sector_cache_pool;
+
+#ifndef FX_SINGLE_THREAD
+
+    /* Protect against other media accessing the pool.  */
+    tx_mutex_get(&(pool_ptr -> fx_sector_cache_pool_protect), TX_WAIT_FOREVER);
+#endif
+
+    /* Determine if the pool has a free entry.  */
+    if (pool_ptr -> fx_sector_cache_pool_free_list)
+    {
+
+        /* Yes, remove it from the free list.  */
+        cache_entry =  pool_ptr -> fx_sector_cache_pool_free_list;
+        pool_ptr -> fx_sector_cache_pool_free_list =  cache_entry -> fx_cached_sector_next_used;
+        pool_ptr -> fx_sector_cache_pool_free_count--;
+        owner_ptr =  FX_NULL;
+    }
+    else
+    {
+
+        /* The least recently used entry of the media is the default choice, unless
+           the media holds fewer entries than it reserved.  */
+        owner_ptr =  media_ptr;
+        if (media_ptr -> fx_media_sector_cache_pool_entries < media_ptr -> fx_media_sector_cache_pool_reserved)
+        {
+            cache_entry =  FX_NULL;
+        }
+
+        /* Examine the least recently used entries of the other media.  */
+        for (i = 0; i < FX_SECTOR_CACHE_POOL_MEDIA; i++)
+        {
+
+            /* Pickup the next attached media.  */
+            other_media_ptr =  pool_ptr -> fx_sector_cache_pool_media[i];
+            if ((other_media_ptr == FX_NULL) || (other_media_ptr == media_ptr))
+            {
+                continue;
+            }
+
+#ifndef FX_SINGLE_THREAD
+
+            /* Skip the media if it is busy, its cache can't be changed now.  */
+            if (tx_mutex_get(&(other_media_ptr -> fx_media_protect), TX_NO_WAIT) != TX_SUCCESS)
+            {
+                continue;
+            }
+#endif
+
+            /* Determine if the oldest entry of the other media can be taken. The media must
+               hold more entries than it reserved and the entry must be clean and must not be
+               the current memory buffer of the media.  */
+            candidate_entry =  other_media_ptr -> fx_media_sector_cache_list_tail;
+            if ((other_media_ptr -> fx_media_sector_cache_pool_entries > other_media_ptr -> fx_media_sector_cache_pool_reserved) &&
+                (candidate_entry -> fx_cached_sector_buffer_dirty == FX_FALSE) &&
+                (candidate_entry -> fx_cached_sector_memory_buffer != other_media_ptr -> fx_media_memory_buffer) &&
+                ((cache_entry == FX_NULL) ||
+                 (candidate_entry -> fx_cached_sector_valid == FX_FALSE) ||
+                 ((cache_entry -> fx_cached_sector_valid) &&
+                  (((LONG)(candidate_entry -> fx_cached_sector_last_used - cache_entry -> fx_cached_sector_last_used)) < 0))))
+            {
+
+#ifndef FX_SINGLE_THREAD
+
+                /* Release the media that owns the entry chosen so far.  */
+                if ((owner_ptr) && (owner_ptr != media_ptr) && (cache_entry))
+                {
+                    tx_mutex_put(&(owner_ptr -> fx_media_protect));
+                }
+#endif
+
+                /* Choose the entry of this media, which stays protected.  */
+                cache_entry =  candidate_entry;
+                owner_ptr =    other_media_ptr;
+            }
+#ifndef FX_SINGLE_THREAD
+            else
+            {
+
+                /* Release the other media.  */
+                tx_mutex_put(&(other_media_ptr -> fx_media_protect));
+            }
+#endif
+        }
+
+        /* If nothing better was found, fall back to the least recently used entry of the
+           media itself.  */
+        if (cache_entry == FX_NULL)
+        {
+            cache_entry =  media_ptr -> fx_media_sector_cache_list_tail;
+            owner_ptr =    media_ptr;
+        }
+
+        /* Determine if the entry is taken from another media.  */
+        if ((cache_entry) && (owner_ptr != media_ptr))
+        {
+
+            /* Determine if the entry is in the hash table of the other media.  */
+            if (cache_entry -> fx_cached_sector_hash_key != (~(ULONG64)0))
+            {
+
+                /* Yes, find the link to this entry in its hash bucket.  */
+                bucket_ptr =  &(owner_ptr -> fx_media_sector_cache_hash_table[(ULONG)(cache_entry -> fx_cached_sector_hash_key & owner_ptr -> fx_media_sector_cache_hash_mask)]);
+                while ((*bucket_ptr) && (*bucket_ptr != cache_entry))
+                {
+
+                    /* Move to the next link in the bucket.  */
+                    bucket_ptr =  &((*bucket_ptr) -> fx_cached_sector_hash_next);
+                }
+
+                /* Remove the entry from the hash bucket.  */
+                if (*bucket_ptr)
+                {
+                    *bucket_ptr =  cache_entry -> fx_cached_sector_hash_next;
+                }
+            }
+
+            /* Remove the entry from the list of the other media.  */
+            _fx_utility_logical_sector_cache_entry_unlink(owner_ptr, cache_entry);
+            owner_ptr -> fx_media_sector_cache_pool_entries--;
+
+            /* Increment the number of entries taken from another media.  */
+            pool_ptr -> fx_sector_cache_pool_steals++;
+
+#ifndef FX_SINGLE_THREAD
+
+            /* Release the other media.  */
+            tx_mutex_put(&(owner_ptr -> fx_media_protect));
+#endif
+        }
+    }
+
+    /* Determine if the entry is new to the media.  */
+    if ((cache_entry) && (owner_ptr != media_ptr))
+    {
+
+        /* Yes, setup the entry as an unused entry of the media.  */
+        cache_entry -> fx_cached_sector =               (~(ULONG64)0);
+        cache_entry -> fx_cached_sector_valid =         FX_FALSE;
+        cache_entry -> fx_cached_sector_buffer_dirty =  FX_FALSE;
+        cache_entry -> fx_cached_sector_hash_next =     FX_NULL;
+        cache_entry -> fx_cached_sector_hash_key =      (~(ULONG64)0);
+        cache_entry -> fx_cached_sector_media =         media_ptr;
+
+        /* Place the entry at the end of the list of the media.  */
+        _fx_utility_logical_sector_cache_entry_link(media_ptr, cache_entry, FX_TRUE);
+        media_ptr -> fx_media_sector_cache_pool_entries++;
+    }
+
+#ifndef FX_SINGLE_THREAD
+
+    /* Release pool protection.  */
+    tx_mutex_put(&(pool_ptr -> fx_sector_cache_pool_protect));
+#endif
+
+    /* Return the entry to be used.  */
+    return(cache_entry);
+}
+
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
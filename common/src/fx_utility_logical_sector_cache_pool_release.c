@@ -0,0 +1,152 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_pool_release       PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns all cache entries of a media to the free      */
+/*    list of its cache pool, removes the media from the pool and         */
+/*    rebuilds the logical sector cache of the media in the memory        */
+/*    supplied to fx_media_open. The caller must write dirty sectors out  */
+/*    first, if they are to be kept.                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_initialize                         */
+/*                                          Build logical sector cache    */
+/*    tx_mutex_get                          Get protection mutex          */
+/*    tx_mutex_put                          Release protection mutex      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_media_abort                       Abort media                   */
+/*    _fx_media_cache_pool_attach           Attach media to cache pool    */
+/*    _fx_media_cache_pool_detach           Detach media from cache pool  */
+/*    _fx_media_close                       Close media                   */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_logical_sector_cache_pool_release(FX_MEDIA *media_ptr)
+{
+
+FX_SECTOR_CACHE_POOL *pool_ptr;
+FX_CACHED_SECTOR     *cache_entry;
+FX_CACHED_SECTOR     *next_cache_entry;
+ULONG                 i;
+
+
+    /* Pickup the pool of the media.  */
+    pool_ptr =  media_ptr -> fx_media_sector_cache_pool;
+
+#ifndef FX_SINGLE_THREAD
+
+    /* Protect against other media accessing the pool.  */
+    tx_mutex_get(&(pool_ptr -> fx_sector_cache_pool_protect), TX_WAIT_FOREVER);
+#endif
+
+    /* Place all entries of the media on the free list of the pool.  */
+    cache_entry =  media_ptr -> fx_media_sector_cache_list_ptr;
+    while (cache_entry)
+    {
+
+        /* Pickup the next entry of the media before the entry is relinked.  */
+        next_cache_entry =  cache_entry -> fx_cached_sector_next_used;
+
+        /* Setup the entry as a free entry.  */
+        cache_entry -> fx_cached_sector =                (~(ULONG64)0);
+        cache_entry -> fx_cached_sector_valid =          FX_FALSE;
+        cache_entry -> fx_cached_sector_buffer_dirty =   FX_FALSE;
+        cache_entry -> fx_cached_sector_previous_used =  FX_NULL;
+        cache_entry -> fx_cached_sector_hash_next =      FX_NULL;
+        cache_entry -> fx_cached_sector_hash_key =       (~(ULONG64)0);
+        cache_entry -> fx_cached_sector_media =          FX_NULL;
+        cache_entry -> fx_cached_sector_next_used =      pool_ptr -> fx_sector_cache_pool_free_list;
+        pool_ptr -> fx_sector_cache_pool_free_list =     cache_entry;
+        pool_ptr -> fx_sector_cache_pool_free_count++;
+
+        /* Move to the next entry of the media.  */
+        cache_entry =  next_cache_entry;
+    }
+
+    /* Remove the media and its reservation from the pool.  */
+    for (i = 0; i < FX_SECTOR_CACHE_POOL_MEDIA; i++)
+    {
+        if (pool_ptr -> fx_sector_cache_pool_media[i] == media_ptr)
+        {
+            pool_ptr -> fx_sector_cache_pool_media[i] =  FX_NULL;
+        }
+    }
+    pool_ptr -> fx_sector_cache_pool_reserved -=  media_ptr -> fx_media_sector_cache_pool_reserved;
+
+#ifndef FX_SINGLE_THREAD
+
+    /* Release pool protection.  */
+    tx_mutex_put(&(pool_ptr -> fx_sector_cache_pool_protect));
+#endif
+
+    /* The media is no longer attached.  */
+    media_ptr -> fx_media_sector_cache_pool =           FX_NULL;
+    media_ptr -> fx_media_sector_cache_pool_entries =   0;
+    media_ptr -> fx_media_sector_cache_pool_reserved =  0;
+
+    /* Rebuild the media's own cache.  */
+    _fx_utility_logical_sector_cache_initialize(media_ptr, media_ptr -> fx_media_sector_cache_private_memory,
+                                                media_ptr -> fx_media_sector_cache_private_size);
+    media_ptr -> fx_media_memory_buffer =  media_ptr -> fx_media_sector_cache_private_memory;
+}
+
+#endif /* FX_ENABLE_SECTOR_CACHE_POOL */
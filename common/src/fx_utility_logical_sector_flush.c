@@ -61,6 +61,14 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _fx_utility_logical_sector_cache_lookup                             */
+/*                                          Lookup logical sector in the  */
+/*                                            cache hash table            */
+/*    _fx_utility_logical_sector_cache_entry_demote                       */
+/*                                          Move cache entry to end of    */
+/*                                            list                        */
+/*    _fx_utility_logical_sector_flush_coalesced                          */
+/*                                          Write dirty sectors in runs   */
 /*    I/O Driver                                                          */
 /*                                                                        */
 /*  CALLED BY                                                             */
@@ -87,12 +95,21 @@ UINT  _fx_utility_logical_sector_flush(FX_MEDIA *media_ptr, ULONG64 starting_sec
 #ifndef FX_DISABLE_CACHE
 FX_CACHED_SECTOR *cache_entry;
 UINT              cache_size;
-UINT              i, bit_set, use_starting_sector;
+UINT              use_starting_sector;
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+FX_CACHED_SECTOR *next_cache_entry;
+ULONG64           logical_sector;
+#else
+UINT              i, bit_set;
 ULONG             index;
 ULONG             remaining_valid;
+ULONG             valid_bit_map;
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 ULONG             remaining_dirty;
 ULONG64           ending_sector;
-ULONG             valid_bit_map;
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+UINT              status;
+#endif /* FX_ENABLE_COALESCED_SECTOR_FLUSH */
 
 
     /* Extended port-specific processing macro, which is by default defined to white space.  */
@@ -107,6 +124,212 @@ ULONG             valid_bit_map;
     /* If trace is enabled, insert this event into the trace buffer.  */
     FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_MEDIA_FLUSH, media_ptr, media_ptr -> fx_media_sector_cache_dirty_count, 0, 0, FX_TRACE_INTERNAL_EVENTS, 0, 0)
 
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+
+    /* Determine if more than one dirty sector could be written.  */
+    if ((remaining_dirty > 1) && (sectors > 1) && (media_ptr -> fx_media_driver_write_protect == FX_FALSE))
+    {
+
+        /* Yes, write the dirty sectors of the range in runs of consecutive sectors first.  */
+        status =  _fx_utility_logical_sector_flush_coalesced(media_ptr, starting_sector, sectors);
+
+        /* Check for successful completion.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Error writing the cached sectors out.  Return the
+               error status.  */
+            return(status);
+        }
+
+        /* Pickup the number of sectors that are still dirty, which are outside the range.  */
+        remaining_dirty =  media_ptr -> fx_media_sector_cache_dirty_count;
+    }
+#endif /* FX_ENABLE_COALESCED_SECTOR_FLUSH */
+
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+    /* Pickup the cache size.  */
+    cache_size =  (UINT)media_ptr -> fx_media_sector_cache_size;
+
+    /* Determine how to find the cached sectors of the range. If the range is smaller
+       than the cache, simply lookup each sector of the range in the hash table.
+       Otherwise, examine every cache entry.  */
+    logical_sector =  starting_sector;
+    if (sectors < cache_size)
+    {
+        use_starting_sector =  FX_TRUE;
+        cache_entry =  FX_NULL;
+    }
+    else
+    {
+        use_starting_sector =  FX_FALSE;
+        cache_entry =  media_ptr -> fx_media_sector_cache;
+    }
+
+    /* Loop to process the cached sectors of the range.  */
+    while (sectors)
+    {
+
+        /* Determine if invalidation is not required and there are no
+           more dirty sectors. */
+        if ((remaining_dirty == 0) && (invalidate == FX_FALSE))
+        {
+
+            /* Yes, nothing left to do.  */
+            break;
+        }
+
+        /* Determine how to find the next cache entry.  */
+        if (use_starting_sector)
+        {
+
+            /* Determine if the whole range has been examined.  */
+            if (logical_sector > ending_sector)
+            {
+                break;
+            }
+
+            /* Lookup this sector in the hash table and move to the next sector.  */
+            cache_entry =  _fx_utility_logical_sector_cache_lookup(media_ptr, logical_sector);
+            logical_sector++;
+            next_cache_entry =  FX_NULL;
+
+            /* Determine if this sector is in the cache.  */
+            if (cache_entry == FX_NULL)
+            {
+                continue;
+            }
+        }
+        else
+        {
+
+            /* Determine if all cache entries have been examined.  */
+            if (cache_size == 0)
+            {
+                break;
+            }
+            cache_size--;
+
+            /* The entries are examined in memory order, since invalidated entries are
+               moved to the end of the list.  */
+            next_cache_entry =  cache_entry + 1;
+        }
+
+        /* Determine if this cached sector is within the specified range, is valid and
+           belongs to this media.  */
+        if ((cache_entry -> fx_cached_sector_valid) &&
+            (cache_entry -> fx_cached_sector >= starting_sector) &&
+            (cache_entry -> fx_cached_sector <= ending_sector) &&
+            (FX_CACHED_SECTOR_OWNED(media_ptr, cache_entry)))
+        {
+
+            /* Yes, the cache entry is valid and within the specified range. Determine if
+               the requested sector has been written to.  */
+            if (cache_entry -> fx_cached_sector_buffer_dirty)
+            {
+
+                /* Yes, write the cached sector out to the media.  */
+
+                /* Check for write protect at the media level (set by driver).  */
+                if (media_ptr -> fx_media_driver_write_protect == FX_FALSE)
+                {
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+                    /* Increment the number of driver write sector(s) requests.  */
+                    media_ptr -> fx_media_driver_write_requests++;
+#endif
+
+                    /* Build write request to the driver.  */
+                    media_ptr -> fx_media_driver_request =          FX_DRIVER_WRITE;
+                    media_ptr -> fx_media_driver_status =           FX_IO_ERROR;
+                    media_ptr -> fx_media_driver_buffer =           cache_entry -> fx_cached_sector_memory_buffer;
+#ifdef FX_DRIVER_USE_64BIT_LBA
+                    media_ptr -> fx_media_driver_logical_sector =   cache_entry -> fx_cached_sector;
+#else
+                    media_ptr -> fx_media_driver_logical_sector =   (ULONG)cache_entry -> fx_cached_sector;
+#endif
+                    media_ptr -> fx_media_driver_sectors =          1;
+                    media_ptr -> fx_media_driver_sector_type =      cache_entry -> fx_cached_sector_type;
+
+                    /* Sectors other than FX_DATA_SECTOR will never be dirty when FX_FAULT_TOLERANT is defined. */
+#ifndef FX_FAULT_TOLERANT
+                    /* Determine if the system write flag needs to be set.  */
+                    if (cache_entry -> fx_cached_sector_type != FX_DATA_SECTOR)
+                    {
+
+                        /* Yes, a system sector write is present so set the flag.  The driver
+                           can use this flag to make extra safeguards in writing the sector
+                           out, yielding more fault tolerance.  */
+                        media_ptr -> fx_media_driver_system_write =  FX_TRUE;
+                    }
+#endif /* FX_FAULT_TOLERANT */
+
+                    /* If trace is enabled, insert this event into the trace buffer.  */
+                    FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_IO_DRIVER_WRITE, media_ptr, cache_entry -> fx_cached_sector, 1, cache_entry -> fx_cached_sector_memory_buffer, FX_TRACE_INTERNAL_EVENTS, 0, 0)
+
+                    /* Invoke the driver to write the sector.  */
+                    (media_ptr -> fx_media_driver_entry) (media_ptr);
+
+                    /* Clear the system write flag.  */
+                    media_ptr -> fx_media_driver_system_write =  FX_FALSE;
+
+                    /* Check for successful completion.  */
+                    if (media_ptr -> fx_media_driver_status)
+                    {
+
+                        /* Error writing a cached sector out.  Return the
+                           error status.  */
+                        return(media_ptr -> fx_media_driver_status);
+                    }
+
+                    /* Clear the buffer dirty flag since it has been flushed
+                       out.  */
+                    cache_entry -> fx_cached_sector_buffer_dirty =  FX_FALSE;
+
+                    /* Decrement the number of dirty sectors currently in the cache.  */
+                    media_ptr -> fx_media_sector_cache_dirty_count--;
+                    remaining_dirty--;
+                }
+            }
+
+            /* Determine if the invalidate option is specified.  */
+            if (invalidate)
+            {
+
+                /* Invalidate the cache entry.  */
+                cache_entry -> fx_cached_sector_valid =  FX_FALSE;
+
+                /* Place all ones in the sector number.  */
+                cache_entry -> fx_cached_sector =  (~(ULONG64)0);
+
+                /* Determine if this sector is still dirty, this could be the case if
+                   write protection was turned on.  */
+                if (cache_entry -> fx_cached_sector_buffer_dirty)
+                {
+
+                    /* Yes, clear the dirty flag.  */
+                    cache_entry -> fx_cached_sector_buffer_dirty =  FX_FALSE;
+
+                    /* Decrement the number of dirty sectors currently in the cache.  */
+                    media_ptr -> fx_media_sector_cache_dirty_count--;
+                    remaining_dirty--;
+                }
+
+                /* Move the entry to the end of the list so it is reused first.  */
+                _fx_utility_logical_sector_cache_entry_demote(media_ptr, cache_entry);
+            }
+
+            /* Decrement the number of sectors in the range that have been processed.  */
+            sectors--;
+        }
+
+        /* Move to the next entry in the sector cache.  */
+        cache_entry =  next_cache_entry;
+    }
+#else
+
     /* Determine what type of cache configuration we have.  */
     if (media_ptr -> fx_media_sector_cache_hashed == FX_FALSE)
     {
@@ -509,6 +732,7 @@ ULONG             valid_bit_map;
             }
         }
     }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 #else
     FX_PARAMETER_NOT_USED(media_ptr);
     FX_PARAMETER_NOT_USED(starting_sector);
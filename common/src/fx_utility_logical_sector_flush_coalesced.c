@@ -0,0 +1,381 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_flush_coalesced          PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function writes the dirty logical sectors of the cache within  */
+/*    the specified range to the media. Up to FX_SECTOR_FLUSH_BATCH       */
+/*    dirty sectors are gathered at a time and sorted by logical sector,  */
+/*    so each run of consecutive sectors of the same type is written      */
+/*    with a single driver request.                                       */
+/*                                                                        */
+/*    If the cache buffers of a run are adjacent in memory, the run is    */
+/*    written directly from the cache. Otherwise, the run is copied into  */
+/*    the bounce buffer of the media and written from there, in which     */
+/*    case the run is limited to the size of the bounce buffer. The       */
+/*    sectors stay valid in the cache and are only marked as clean.       */
+/*                                                                        */
+/*    If FX_ENABLE_ASYNC_DRIVER is defined, the runs of a batch are       */
+/*    submitted to the driver without waiting for each write, and the     */
+/*    batch is complete once all its requests are complete.               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    starting_sector                       Starting sector number        */
+/*    sectors                               Number of sectors             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_cache_lookup                             */
+/*                                          Lookup logical sector in the  */
+/*                                            cache hash table            */
+/*    _fx_utility_memory_copy               Copy sector memory            */
+/*    _fx_utility_driver_request_submit     Submit driver request         */
+/*    _fx_utility_driver_request_wait       Wait for driver requests      */
+/*    I/O Driver                                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_logical_sector_flush      Flush and invalidate sectors  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_logical_sector_flush_coalesced(FX_MEDIA *media_ptr, ULONG64 starting_sector, ULONG64 sectors)
+{
+
+FX_CACHED_SECTOR  *cache_entry;
+FX_CACHED_SECTOR **flush_list;
+ULONG64            ending_sector;
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+ULONG64            logical_sector;
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+ULONG              count;
+ULONG              index;
+ULONG              i, j;
+ULONG              run;
+ULONG              bytes_per_sector;
+UINT               bounce;
+UCHAR             *buffer_ptr;
+#ifdef FX_ENABLE_ASYNC_DRIVER
+UINT               status;
+UINT               bounce_pending =  FX_FALSE;
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+
+
+    /* Calculate the ending sector.  */
+    ending_sector =  starting_sector + sectors - 1;
+
+    /* Setup local pointers to the list of dirty sectors.  */
+    flush_list =  media_ptr -> fx_media_sector_flush_list;
+    bytes_per_sector =  media_ptr -> fx_media_bytes_per_sector;
+
+    /* Loop until all dirty sectors of the range have been written.  */
+    do
+    {
+
+        /* Gather the next batch of dirty sectors within the range.  */
+        count =  0;
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+        /* If the range is smaller than the cache, lookup each sector of the range in the
+           hash table. The sectors are found in order in this case.  */
+        if (sectors < media_ptr -> fx_media_sector_cache_size)
+        {
+            for (logical_sector = starting_sector; logical_sector <= ending_sector; logical_sector++)
+            {
+
+                /* Lookup this sector in the hash table.  */
+                cache_entry =  _fx_utility_logical_sector_cache_lookup(media_ptr, logical_sector);
+                if ((cache_entry) && (cache_entry -> fx_cached_sector_buffer_dirty))
+                {
+
+                    /* Add this entry to the list.  */
+                    flush_list[count++] =  cache_entry;
+                    if (count == FX_SECTOR_FLUSH_BATCH)
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+        else
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+        {
+
+            /* Examine every cache entry and keep the lowest dirty sectors in the list,
+               so consecutive sectors are written by the same batch.  */
+            cache_entry =  media_ptr -> fx_media_sector_cache;
+            for (index = 0; index < media_ptr -> fx_media_sector_cache_size; index++)
+            {
+
+                /* Determine if this entry is a dirty sector within the range.  */
+                if ((cache_entry -> fx_cached_sector_valid) &&
+                    (cache_entry -> fx_cached_sector_buffer_dirty) &&
+                    (cache_entry -> fx_cached_sector >= starting_sector) &&
+                    (cache_entry -> fx_cached_sector <= ending_sector) &&
+                    (FX_CACHED_SECTOR_OWNED(media_ptr, cache_entry)))
+                {
+
+                    /* Determine if this sector belongs to the lowest sectors found so far.  */
+                    if (count < FX_SECTOR_FLUSH_BATCH)
+                    {
+
+                        /* Yes, there is room for another entry in the list.  */
+                        i =  count;
+                        count++;
+                    }
+                    else if (cache_entry -> fx_cached_sector < flush_list[count - 1] -> fx_cached_sector)
+                    {
+
+                        /* Yes, replace the highest sector of the full list, which is
+                           written by the next batch instead.  */
+                        i =  count - 1;
+                    }
+                    else
+                    {
+
+                        /* No, this sector is written by the next batch.  */
+                        i =  FX_SECTOR_FLUSH_BATCH;
+                    }
+
+                    /* Insert this entry into the list in logical sector order.  */
+                    if (i < FX_SECTOR_FLUSH_BATCH)
+                    {
+                        for (; (i > 0) && (flush_list[i - 1] -> fx_cached_sector > cache_entry -> fx_cached_sector); i--)
+                        {
+                            flush_list[i] =  flush_list[i - 1];
+                        }
+                        flush_list[i] =  cache_entry;
+                    }
+                }
+
+                /* Move to the next cache entry.  */
+                cache_entry++;
+            }
+        }
+
+        /* Loop to write the runs of consecutive sectors in the list.  */
+        for (i = 0; i < count; i =  i + run)
+        {
+
+            /* Extend the run as long as the sectors are consecutive and of the same type.  */
+            cache_entry =  flush_list[i];
+            bounce =  FX_FALSE;
+            for (run = 1; (i + run) < count; run++)
+            {
+
+                /* Determine if the next sector continues the run.  */
+                if ((flush_list[i + run] -> fx_cached_sector != (cache_entry -> fx_cached_sector + run)) ||
+                    (flush_list[i + run] -> fx_cached_sector_type != cache_entry -> fx_cached_sector_type))
+                {
+                    break;
+                }
+
+                /* Determine if the bounce buffer is needed for the next sector.  */
+                if ((bounce) ||
+                    (flush_list[i + run] -> fx_cached_sector_memory_buffer !=
+                     (flush_list[i + run - 1] -> fx_cached_sector_memory_buffer + bytes_per_sector)))
+                {
+
+                    /* Yes, make sure the run fits into the bounce buffer.  */
+                    if (((run + 1) * bytes_per_sector) > (ULONG)sizeof(media_ptr -> fx_media_sector_flush_buffer))
+                    {
+                        break;
+                    }
+                    bounce =  FX_TRUE;
+                }
+            }
+
+            /* Determine if the run must be copied into the bounce buffer.  */
+            if (bounce)
+            {
+
+#ifdef FX_ENABLE_ASYNC_DRIVER
+
+                /* Determine if the bounce buffer is still being written.  */
+                if (bounce_pending)
+                {
+
+                    /* Yes, wait for all outstanding requests.  */
+                    status =  _fx_utility_driver_request_wait(media_ptr, 0);
+
+                    /* Check for successful completion.  */
+                    if (status != FX_SUCCESS)
+                    {
+
+                        /* Error writing the cached sectors out.  Return the
+                           error status.  */
+                        return(status);
+                    }
+                }
+                bounce_pending =  FX_TRUE;
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+
+                /* Copy each sector of the run into the bounce buffer.  */
+                buffer_ptr =  (UCHAR *)media_ptr -> fx_media_sector_flush_buffer;
+                for (j = 0; j < run; j++)
+                {
+                    _fx_utility_memory_copy(flush_list[i + j] -> fx_cached_sector_memory_buffer,
+                                            buffer_ptr + (j * bytes_per_sector), bytes_per_sector);
+                }
+            }
+            else
+            {
+
+                /* The run is written directly from the cache buffers.  */
+                buffer_ptr =  cache_entry -> fx_cached_sector_memory_buffer;
+            }
+
+#ifdef FX_ENABLE_ASYNC_DRIVER
+
+            /* Submit the write request of the run. The sectors are marked as clean when
+               the request completes, which may be after this request has returned.  */
+            status =  _fx_utility_driver_request_submit(media_ptr, FX_DRIVER_WRITE, cache_entry -> fx_cached_sector, buffer_ptr,
+                                                        run, cache_entry -> fx_cached_sector_type,
+                                                        _fx_utility_logical_sector_flush_complete, &flush_list[i]);
+
+            /* Check for successful submission.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Complete the outstanding requests before returning the error status.  */
+                _fx_utility_driver_request_wait(media_ptr, 0);
+                return(status);
+            }
+#else
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+            /* Increment the number of driver write sector(s) requests.  */
+            media_ptr -> fx_media_driver_write_requests++;
+#endif
+
+            /* Build write request to the driver.  */
+            media_ptr -> fx_media_driver_request =          FX_DRIVER_WRITE;
+            media_ptr -> fx_media_driver_status =           FX_IO_ERROR;
+            media_ptr -> fx_media_driver_buffer =           buffer_ptr;
+#ifdef FX_DRIVER_USE_64BIT_LBA
+            media_ptr -> fx_media_driver_logical_sector =   cache_entry -> fx_cached_sector;
+#else
+            media_ptr -> fx_media_driver_logical_sector =   (ULONG)cache_entry -> fx_cached_sector;
+#endif
+            media_ptr -> fx_media_driver_sectors =          run;
+            media_ptr -> fx_media_driver_sector_type =      cache_entry -> fx_cached_sector_type;
+
+            /* Sectors other than FX_DATA_SECTOR will never be dirty when FX_FAULT_TOLERANT is defined. */
+#ifndef FX_FAULT_TOLERANT
+            /* Determine if the system write flag needs to be set.  */
+            if (cache_entry -> fx_cached_sector_type != FX_DATA_SECTOR)
+            {
+
+                /* Yes, a system sector write is present so set the flag.  The driver
+                   can use this flag to make extra safeguards in writing the sector
+                   out, yielding more fault tolerance.  */
+                media_ptr -> fx_media_driver_system_write =  FX_TRUE;
+            }
+#endif /* FX_FAULT_TOLERANT */
+
+            /* If trace is enabled, insert this event into the trace buffer.  */
+            FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_IO_DRIVER_WRITE, media_ptr, cache_entry -> fx_cached_sector, run, buffer_ptr, FX_TRACE_INTERNAL_EVENTS, 0, 0)
+
+            /* Invoke the driver to write the sectors.  */
+            (media_ptr -> fx_media_driver_entry) (media_ptr);
+
+            /* Clear the system write flag.  */
+            media_ptr -> fx_media_driver_system_write =  FX_FALSE;
+
+            /* Check for successful completion.  */
+            if (media_ptr -> fx_media_driver_status)
+            {
+
+                /* Error writing the cached sectors out.  Return the
+                   error status.  */
+                return(media_ptr -> fx_media_driver_status);
+            }
+
+            /* Clear the buffer dirty flags since the sectors have been flushed out.  */
+            for (j = 0; j < run; j++)
+            {
+                flush_list[i + j] -> fx_cached_sector_buffer_dirty =  FX_FALSE;
+            }
+
+            /* Decrement the number of dirty sectors currently in the cache.  */
+            media_ptr -> fx_media_sector_cache_dirty_count =  media_ptr -> fx_media_sector_cache_dirty_count - run;
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+        }
+
+#ifdef FX_ENABLE_ASYNC_DRIVER
+
+        /* Wait for the writes of this batch, since the list is reused by the next batch.  */
+        status =  _fx_utility_driver_request_wait(media_ptr, 0);
+
+        /* Check for successful completion.  */
+        if (status != FX_SUCCESS)
+        {
+
+            /* Error writing the cached sectors out.  Return the
+               error status.  */
+            return(status);
+        }
+        bounce_pending =  FX_FALSE;
+#endif /* FX_ENABLE_ASYNC_DRIVER */
+
+        /* A full batch means there could be more dirty sectors in the range.  */
+    } while ((count == FX_SECTOR_FLUSH_BATCH) && (media_ptr -> fx_media_sector_cache_dirty_count));
+
+    /* Return successful status.  */
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_COALESCED_SECTOR_FLUSH */
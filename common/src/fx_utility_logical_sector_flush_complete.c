@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#if defined(FX_ENABLE_COALESCED_SECTOR_FLUSH) && defined(FX_ENABLE_ASYNC_DRIVER)
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_flush_complete           PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is called when the write request of a run of dirty    */
+/*    sectors is complete. If the sectors were written successfully, the  */
+/*    cache entries of the run are marked as clean. The context of the    */
+/*    request points to the first entry of the run in the flush list of   */
+/*    the media.                                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    request_ptr                           Completed request pointer     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_driver_request_submit     Submit driver request         */
+/*    _fx_utility_driver_request_wait       Wait for driver requests      */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_logical_sector_flush_complete(FX_MEDIA *media_ptr, FX_DRIVER_REQUEST *request_ptr)
+{
+
+FX_CACHED_SECTOR **flush_list;
+ULONG              i;
+
+
+    /* Determine if the sectors were written successfully.  */
+    if (request_ptr -> fx_driver_request_status != FX_SUCCESS)
+    {
+
+        /* No, the sectors stay dirty.  */
+        return;
+    }
+
+    /* Clear the buffer dirty flags since the sectors have been flushed out.  */
+    flush_list =  (FX_CACHED_SECTOR **)request_ptr -> fx_driver_request_context;
+    for (i = 0; i < request_ptr -> fx_driver_request_sectors; i++)
+    {
+        flush_list[i] -> fx_cached_sector_buffer_dirty =  FX_FALSE;
+    }
+
+    /* Decrement the number of dirty sectors currently in the cache.  */
+    media_ptr -> fx_media_sector_cache_dirty_count =  media_ptr -> fx_media_sector_cache_dirty_count -
+                                                      request_ptr -> fx_driver_request_sectors;
+}
+
+#endif /* FX_ENABLE_COALESCED_SECTOR_FLUSH && FX_ENABLE_ASYNC_DRIVER */
@@ -71,6 +71,11 @@
 /*                                                                        */
 /*    _fx_utility_logical_sector_cache_entry_read                         */
 /*                                          Read logical sector cache     */
+/*    _fx_utility_logical_sector_cache_entry_insert                       */
+/*                                          Index logical sector cache    */
+/*                                            entry                       */
+/*    _fx_utility_logical_sector_cache_entry_unpinned                     */
+/*                                          Skip pinned cache entries     */
 /*    _fx_utility_logical_sector_flush      Flush and invalidate sectors  */
 /*                                          that overlap with non-cache   */
 /*                                          sector I/O.                   */
@@ -148,6 +153,22 @@ UINT              status;
         if (cache_entry == FX_NULL)
         {
 
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+            /* Determine if the request is for a FAT, directory or boot sector.  */
+            if (sector_type != FX_DATA_SECTOR)
+            {
+
+                /* Increment the number of metadata sector cache read hits.  */
+                media_ptr -> fx_media_logical_sector_cache_metadata_read_hits++;
+            }
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+            /* Increment the number of cache read hits of the partition of this sector type.  */
+            media_ptr -> fx_media_logical_sector_cache_partition_read_hits[FX_SECTOR_CACHE_PARTITION_OF(sector_type)]++;
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+#endif
+
             /* Yes, the sector was found. Return success!  */
             return(FX_SUCCESS);
         }
@@ -158,8 +179,41 @@ UINT              status;
 
         /* Increment the number of logical sectors cache read misses.  */
         media_ptr -> fx_media_logical_sector_cache_read_misses++;
+
+        /* Determine if the request is for a FAT, directory or boot sector.  */
+        if (sector_type != FX_DATA_SECTOR)
+        {
+
+            /* Increment the number of metadata sector cache read misses.  */
+            media_ptr -> fx_media_logical_sector_cache_metadata_read_misses++;
+        }
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+        /* Increment the number of cache read misses of the partition of this sector type.  */
+        media_ptr -> fx_media_logical_sector_cache_partition_read_misses[FX_SECTOR_CACHE_PARTITION_OF(sector_type)]++;
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
 #endif
 
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+        /* Replace the least recently used entry of the partition reserved for this sector type.  */
+        cache_entry =  media_ptr -> fx_media_sector_cache_partition_tail[FX_SECTOR_CACHE_PARTITION_GET(media_ptr, sector_type)];
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+        /* Entries pinned by borrowing files must not be replaced.  */
+        cache_entry =  _fx_utility_logical_sector_cache_entry_unpinned(media_ptr, cache_entry);
+
+        /* Determine if every entry that could be replaced is pinned.  */
+        if (cache_entry == FX_NULL)
+        {
+
+            /* Yes, the sector cannot be read into the cache, return the not available error.  */
+            return(FX_NOT_AVAILABLE);
+        }
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
 #ifndef FX_MEDIA_STATISTICS_DISABLE
 
         /* If trace is enabled, insert this event into the trace buffer.  */
@@ -291,6 +345,13 @@ UINT              status;
             /* Place this entry that the head of the cached sector
                list.  */
 
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+            /* Index this entry under the new sector and make it the most
+               recently used entry.  */
+            _fx_utility_logical_sector_cache_entry_insert(media_ptr, cache_entry);
+#else
+
             /* Determine if we need to update the last used list.  */
             if (previous_cache_entry)
             {
@@ -307,6 +368,7 @@ UINT              status;
                     media_ptr -> fx_media_sector_cache_list_ptr;
                 media_ptr -> fx_media_sector_cache_list_ptr =  cache_entry;
             }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 
 #ifdef FX_ENABLE_FAULT_TOLERANT
             if (media_ptr -> fx_media_fault_tolerant_enabled &&
@@ -531,6 +593,26 @@ UINT              status;
                     return(FX_SUCCESS);
                 }
 
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+                /* Replace the least recently used entry of the partition reserved for this sector type.  */
+                cache_entry =  media_ptr -> fx_media_sector_cache_partition_tail[FX_SECTOR_CACHE_PARTITION_GET(media_ptr, sector_type)];
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+                /* Entries pinned by borrowing files must not be replaced.  */
+                cache_entry =  _fx_utility_logical_sector_cache_entry_unpinned(media_ptr, cache_entry);
+
+                /* Determine if every entry that could be replaced is pinned.  */
+                if (cache_entry == FX_NULL)
+                {
+
+                    /* Yes, the sectors were read directly, simply don't update the cache.  */
+                    return(FX_SUCCESS);
+                }
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
                 /* Determine if the cache entry is dirty and needs to be written out before it is used.  */
                 if ((cache_entry -> fx_cached_sector_valid) &&
                     (cache_entry -> fx_cached_sector_buffer_dirty))
@@ -608,6 +690,13 @@ UINT              status;
                 /* Place this entry that the head of the cached sector
                    list.  */
 
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+                /* Index this entry under the new sector and make it the most
+                   recently used entry.  */
+                _fx_utility_logical_sector_cache_entry_insert(media_ptr, cache_entry);
+#else
+
                 /* Determine if we need to update the last used list.  */
                 if (previous_cache_entry)
                 {
@@ -624,6 +713,7 @@ UINT              status;
                         media_ptr -> fx_media_sector_cache_list_ptr;
                     media_ptr -> fx_media_sector_cache_list_ptr =  cache_entry;
                 }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 
                 /* Copy the data from the destination buffer to the cache entry.  */
                 _fx_utility_memory_copy(buffer_ptr, /* Use case of memcpy is verified. */
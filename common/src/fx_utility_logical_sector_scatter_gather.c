@@ -0,0 +1,245 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+
+
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_logical_sector_scatter_gather           PORTABLE C      */
+/*                                                           6.4.1        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Microsoft Corporation                                               */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reads or writes the segments in the segment list of   */
+/*    the media directly from or to the application buffers. If the       */
+/*    driver accepts scatter-gather requests, all segments are            */
+/*    transferred with a single FX_DRIVER_SCATTER_READ or                 */
+/*    FX_DRIVER_GATHER_WRITE request. Otherwise each segment is           */
+/*    transferred with its own logical sector read or write.              */
+/*                                                                        */
+/*    Cached copies of the sectors are flushed and invalidated first, as  */
+/*    for any other direct transfer.                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    request_type                          FX_DRIVER_READ or             */
+/*                                            FX_DRIVER_WRITE             */
+/*    segments                              Number of segments            */
+/*    sector_type                           Type of sectors               */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_logical_sector_flush      Flush and invalidate sectors  */
+/*    _fx_utility_logical_sector_read       Read a logical sector         */
+/*    _fx_utility_logical_sector_write      Write a logical sector        */
+/*    I/O Driver                                                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_read                         File read                     */
+/*    _fx_file_write                        File write                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     Microsoft Corporation    Initial Version 6.4.1         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_logical_sector_scatter_gather(FX_MEDIA *media_ptr, UINT request_type, ULONG segments, UCHAR sector_type)
+{
+
+UINT               status;
+ULONG              i;
+ULONG              sectors;
+FX_DRIVER_SEGMENT *segment_ptr;
+
+
+    /* Setup a pointer to the first segment.  */
+    segment_ptr =  media_ptr -> fx_media_driver_segment_list;
+
+    /* Determine if the driver accepts scatter-gather requests.  */
+    if ((media_ptr -> fx_media_driver_scatter_gather_supported == FX_FALSE) || (segments == 1))
+    {
+
+        /* No, transfer each segment with its own request.  */
+        for (i = 0; i < segments; i++)
+        {
+
+            /* Read or write the sectors of the segment.  */
+            if (request_type == FX_DRIVER_READ)
+            {
+                status =  _fx_utility_logical_sector_read(media_ptr, segment_ptr -> fx_driver_segment_logical_sector,
+                                                          segment_ptr -> fx_driver_segment_buffer,
+                                                          segment_ptr -> fx_driver_segment_sectors, sector_type);
+            }
+            else
+            {
+                status =  _fx_utility_logical_sector_write(media_ptr, segment_ptr -> fx_driver_segment_logical_sector,
+                                                           segment_ptr -> fx_driver_segment_buffer,
+                                                           segment_ptr -> fx_driver_segment_sectors, sector_type);
+            }
+
+            /* Check for good completion status.  */
+            if (status != FX_SUCCESS)
+            {
+
+                /* Return the error status.  */
+                return(status);
+            }
+
+            /* Move to the next segment.  */
+            segment_ptr++;
+        }
+
+        /* Return successful status.  */
+        return(FX_SUCCESS);
+    }
+
+    /* Check each segment and remove its sectors from the cache.  */
+    sectors =  0;
+    for (i = 0; i < segments; i++)
+    {
+
+        /* Is the logical sector valid? */
+        if ((segment_ptr -> fx_driver_segment_logical_sector == 0) ||
+            ((segment_ptr -> fx_driver_segment_logical_sector + segment_ptr -> fx_driver_segment_sectors - 1) >= media_ptr -> fx_media_total_sectors))
+        {
+            return(FX_SECTOR_INVALID);
+        }
+
+#ifndef FX_DISABLE_CACHE
+
+        /* Flush and invalidate any entries in the cache that are in the range of this segment.  */
+        _fx_utility_logical_sector_flush(media_ptr, segment_ptr -> fx_driver_segment_logical_sector,
+                                         (ULONG64) segment_ptr -> fx_driver_segment_sectors, FX_TRUE);
+#else
+
+        /* Invalidate the sector in the memory buffer if it is overwritten.  */
+        if ((request_type == FX_DRIVER_WRITE) &&
+            (segment_ptr -> fx_driver_segment_logical_sector <= media_ptr -> fx_media_memory_buffer_sector) &&
+            (segment_ptr -> fx_driver_segment_logical_sector + segment_ptr -> fx_driver_segment_sectors > media_ptr -> fx_media_memory_buffer_sector))
+        {
+            media_ptr -> fx_media_memory_buffer_sector = (ULONG64)-1;
+        }
+#endif /* FX_DISABLE_CACHE */
+
+        /* Accumulate the total number of sectors.  */
+        sectors =  sectors + segment_ptr -> fx_driver_segment_sectors;
+
+        /* Move to the next segment.  */
+        segment_ptr++;
+    }
+
+    /* Build the scatter-gather request to the driver. The logical sector, buffer and
+       sectors describe the first segment and the total of the request.  */
+    segment_ptr =  media_ptr -> fx_media_driver_segment_list;
+    media_ptr -> fx_media_driver_status =           FX_IO_ERROR;
+    media_ptr -> fx_media_driver_buffer =           segment_ptr -> fx_driver_segment_buffer;
+#ifdef FX_DRIVER_USE_64BIT_LBA
+    media_ptr -> fx_media_driver_logical_sector =   segment_ptr -> fx_driver_segment_logical_sector;
+#else
+    media_ptr -> fx_media_driver_logical_sector =   (ULONG)segment_ptr -> fx_driver_segment_logical_sector;
+#endif
+    media_ptr -> fx_media_driver_sectors =          sectors;
+    media_ptr -> fx_media_driver_sector_type =      sector_type;
+    media_ptr -> fx_media_driver_segments =         segments;
+
+    /* Determine if this is a read or a write request.  */
+    if (request_type == FX_DRIVER_READ)
+    {
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+        /* Increment the number of driver read sector(s) requests.  */
+        media_ptr -> fx_media_driver_read_requests++;
+#endif
+
+        media_ptr -> fx_media_driver_request =  FX_DRIVER_SCATTER_READ;
+
+        /* Determine if the sectors are data sectors.  */
+        if (sector_type == FX_DATA_SECTOR)
+        {
+
+            /* Data sector is present.  */
+            media_ptr -> fx_media_driver_data_sector_read =  FX_TRUE;
+        }
+
+        /* If trace is enabled, insert this event into the trace buffer.  */
+        FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_IO_DRIVER_READ, media_ptr, segment_ptr -> fx_driver_segment_logical_sector, sectors, segment_ptr -> fx_driver_segment_buffer, FX_TRACE_INTERNAL_EVENTS, 0, 0)
+    }
+    else
+    {
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+        /* Increment the number of driver write sector(s) requests.  */
+        media_ptr -> fx_media_driver_write_requests++;
+#endif
+
+        media_ptr -> fx_media_driver_request =  FX_DRIVER_GATHER_WRITE;
+
+        /* Determine if the system write flag needs to be set.  */
+        if (sector_type != FX_DATA_SECTOR)
+        {
+
+            /* Yes, a system sector write is present so set the flag.  */
+            media_ptr -> fx_media_driver_system_write =  FX_TRUE;
+        }
+
+        /* If trace is enabled, insert this event into the trace buffer.  */
+        FX_TRACE_IN_LINE_INSERT(FX_TRACE_INTERNAL_IO_DRIVER_WRITE, media_ptr, segment_ptr -> fx_driver_segment_logical_sector, sectors, segment_ptr -> fx_driver_segment_buffer, FX_TRACE_INTERNAL_EVENTS, 0, 0)
+    }
+
+    /* Invoke the driver to transfer all segments.  */
+    (media_ptr -> fx_media_driver_entry) (media_ptr);
+
+    /* Clear the data sector and system write flags.  */
+    media_ptr -> fx_media_driver_data_sector_read =  FX_FALSE;
+    media_ptr -> fx_media_driver_system_write =      FX_FALSE;
+
+    /* Return driver status.  */
+    return(media_ptr -> fx_media_driver_status);
+}
+
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
@@ -69,6 +69,9 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
+/*    _fx_utility_logical_sector_cache_lookup                             */
+/*                                          Lookup logical sector in the  */
+/*                                            cache hash table            */
 /*    _fx_utility_logical_sector_flush      Flush and invalidate sectors  */
 /*                                          that overlap with non-cache   */
 /*                                          sector I/O.                   */
@@ -99,9 +102,13 @@ UINT  _fx_utility_logical_sector_write(FX_MEDIA *media_ptr, ULONG64 logical_sect
 
 #ifndef FX_DISABLE_CACHE
 FX_CACHED_SECTOR *cache_entry;
+#if !defined(FX_ENABLE_LRU_SECTOR_CACHE) || defined(FX_ENABLE_FAULT_TOLERANT)
 UINT              cache_size;
+#endif
+#ifndef FX_ENABLE_LRU_SECTOR_CACHE
 UINT              index;
 UINT              i;
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 UCHAR             cache_found = FX_FALSE;
 #endif /* FX_DISABLE_CACHE */
 
@@ -130,6 +137,16 @@ UCHAR             cache_found = FX_FALSE;
 
         /* Internal cache buffer is requested.  */
 
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+
+        /* Lookup the logical sector in the hash table.  */
+        cache_entry =  _fx_utility_logical_sector_cache_lookup(media_ptr, logical_sector);
+        if (cache_entry)
+        {
+            cache_found = FX_TRUE;
+        }
+#else
+
         /* Determine if the logical sector cache access should use the hash function.  */
         if (media_ptr -> fx_media_sector_cache_hashed)
         {
@@ -183,6 +200,7 @@ UCHAR             cache_found = FX_FALSE;
                 }
             }
         }
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
 
 #ifdef FX_ENABLE_FAULT_TOLERANT
         if (media_ptr -> fx_media_fault_tolerant_enabled &&
@@ -295,6 +313,12 @@ UCHAR             cache_found = FX_FALSE;
 
                 /* Simply mark this entry as dirty.  */
                 cache_entry -> fx_cached_sector_buffer_dirty =  FX_TRUE;
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+
+                /* Remember when the entry became dirty, so the writeback can find the oldest changes.  */
+                cache_entry -> fx_cached_sector_dirty_time =  media_ptr -> fx_media_writeback_clock;
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
             }
 
             /* Don't bother updating the cache linked list since writes are
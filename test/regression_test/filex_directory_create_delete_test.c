@@ -484,6 +484,13 @@ FX_DIR_ENTRY    search_directory;
     status = fx_directory_create(&ram_disk, name);
     return_if_fail( status == FX_INVALID_NAME);
     
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* Count the free clusters before the total cluster count is changed.  */
+    status =  fx_media_space_available(&ram_disk, &temp);
+    return_if_fail( status == FX_SUCCESS);
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
+
     /* Attempt to create a directory with no more clusters.  */
     temp =  ram_disk.fx_media_total_clusters;
     ram_disk.fx_media_total_clusters =  0;
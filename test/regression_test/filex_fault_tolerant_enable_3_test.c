@@ -1028,11 +1028,20 @@ FX_DIR_ENTRY dir_entry;
     status += fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, CACHE_SIZE);
     return_if_fail( status == FX_SUCCESS);
 
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* Make an IO error while reading FAT chain, which happens after the boot sector is read.  */
+    _fx_ram_driver_io_error_request = 2;
+    status = fx_fault_tolerant_enable( &ram_disk, fault_tolerant_buffer, FAULT_TOLERANT_SIZE);
+    _fx_ram_driver_io_error_request = 0;
+    return_if_fail( status == FX_IO_ERROR);
+#else
     /* Make an IO error while reading FAT chain. */
     _fx_ram_driver_io_error_request = 1;
     status = fx_fault_tolerant_enable( &ram_disk, fault_tolerant_buffer, FAULT_TOLERANT_SIZE);
     _fx_ram_driver_io_error_request = 0;
     return_if_fail( status == FX_FAT_READ_ERROR);
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
 
     status = fx_media_close( &ram_disk);
     return_if_fail( status == FX_SUCCESS);
@@ -202,6 +202,12 @@ UINT        size;
         status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory_large, cache_buffer, CACHE_SIZE);
         return_if_fail( status == FX_SUCCESS);
         return_if_fail(ram_disk.fx_media_fault_tolerant_enabled != FX_TRUE);
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+        /* Count the free clusters before the media control block is changed.  */
+        status =  fx_media_space_available(&ram_disk, &temp);
+        return_if_fail( status == FX_SUCCESS);
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
 
         /* Read the boot sector.  */
         source_buffer = ((UCHAR *) ram_disk.fx_media_driver_info);
@@ -0,0 +1,364 @@
+/* This FileX test concentrates on the delayed allocation of runs of clusters on FAT media.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_FILE_DELAYED_ALLOCATION
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           8000
+#define     CACHE_SECTORS           16
+#define     HOLE_FILES              64
+#define     WRITE_BUFFER_SIZE       (8 * SECTOR_SIZE)
+#define     RECORD_SIZE             100
+#define     FILE_CLUSTERS           64
+#define     FILE_BYTES              (FILE_CLUSTERS * SECTOR_SIZE)
+#define     CHUNK_CLUSTERS          16
+#define     PATTERN(f, o)           ((UCHAR)((f) * 41 + ((o) / SECTOR_SIZE) + ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 file_a;
+static FX_FILE                 file_b;
+static FX_FILE                 file_c;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   write_buffer_a[WRITE_BUFFER_SIZE];
+static UCHAR                   write_buffer_b[WRITE_BUFFER_SIZE];
+static UCHAR                   data_buffer[CHUNK_CLUSTERS * SECTOR_SIZE];
+static UCHAR                   read_buffer[SECTOR_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_file_delayed_allocation_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_delayed_allocation_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Append a record of the file's pattern.  */
+
+static UINT  record_write(FX_FILE *file_ptr, ULONG file_id, ULONG offset, ULONG size)
+{
+
+ULONG       i;
+
+
+    for (i = 0; i < size; i++)
+    {
+        data_buffer[i] =  PATTERN(file_id, offset + i);
+    }
+    return(fx_file_write(file_ptr, data_buffer, size));
+}
+
+
+/* Follow the cluster chain of a file, counting its runs of consecutive clusters and its lowest cluster.  */
+
+static UINT  file_runs_get(ULONG first_cluster, ULONG clusters, ULONG *runs, ULONG *lowest_cluster)
+{
+
+UINT        status;
+ULONG       cluster;
+ULONG       next_cluster;
+ULONG       i;
+
+
+    cluster =          first_cluster;
+    *runs =            1;
+    *lowest_cluster =  first_cluster;
+    for (i = 1; i < clusters; i++)
+    {
+        status =  _fx_utility_FAT_entry_read(&ram_disk, cluster, &next_cluster);
+        if (status != FX_SUCCESS)
+            return(status);
+        if (next_cluster != cluster + 1)
+            *runs =  *runs + 1;
+        if (next_cluster < *lowest_cluster)
+            *lowest_cluster =  next_cluster;
+        cluster =  next_cluster;
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Read a file back and compare it with its pattern.  */
+
+static UINT  file_verify(CHAR *name, ULONG file_id, ULONG size)
+{
+
+UINT        status;
+ULONG       offset;
+ULONG       actual;
+ULONG       i;
+
+
+    status =  fx_file_open(&ram_disk, &file_a, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    if (file_a.fx_file_current_file_size != size)
+        return(FX_IO_ERROR);
+    for (offset = 0; offset < size; offset += SECTOR_SIZE)
+    {
+        status =  fx_file_read(&file_a, read_buffer, SECTOR_SIZE, &actual);
+        if ((status != FX_SUCCESS) || (actual != SECTOR_SIZE))
+            return(FX_IO_ERROR);
+        for (i = 0; i < SECTOR_SIZE; i++)
+        {
+            if (read_buffer[i] != PATTERN(file_id, offset + i))
+                return(FX_IO_ERROR);
+        }
+    }
+    return(fx_file_close(&file_a));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       offset;
+ULONG       size;
+ULONG       holes_end;
+ULONG       runs;
+ULONG       lowest_cluster;
+ULONG       first_cluster;
+ULONG       errors_detected;
+ULONG       fat_entry_reads;
+CHAR        name[16];
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File delayed allocation test...........................");
+
+    /* Format a FAT media with one sector per cluster.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            256,                    // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Age the media: fill its beginning with files of one cluster and delete every other one, so the
+       free clusters there are holes of one cluster.  */
+    holes_end =  0;
+    for (i = 0; i < HOLE_FILES; i++)
+    {
+        sprintf(name, "H%02lu.BIN", (unsigned long)i);
+        status =  fx_file_create(&ram_disk, name);
+        status += fx_file_open(&ram_disk, &file_a, name, FX_OPEN_FOR_WRITE);
+        status += record_write(&file_a, 0, 0, SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+        if (((i & 1) == 0) && (file_a.fx_file_first_physical_cluster > holes_end))
+            holes_end =  file_a.fx_file_first_physical_cluster;
+        status =  fx_file_close(&file_a);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    for (i = 1; i < HOLE_FILES; i += 2)
+    {
+        sprintf(name, "H%02lu.BIN", (unsigned long)i);
+        status =  fx_file_delete(&ram_disk, name);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    /* Open the media again, so the free cluster search starts at the first hole.  */
+    status =  fx_media_close(&ram_disk);
+    status += fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_cluster_search_start < holes_end);
+
+    /* Append small records to two files with write buffers, one file after the other.  */
+    status =  fx_file_create(&ram_disk, "A.BIN");
+    status += fx_file_create(&ram_disk, "B.BIN");
+    status += fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_open(&ram_disk, &file_b, "B.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_write_buffer_set(&file_a, write_buffer_a, sizeof(write_buffer_a));
+    status += fx_file_write_buffer_set(&file_b, write_buffer_b, sizeof(write_buffer_b));
+    return_if_fail(status == FX_SUCCESS);
+    for (offset = 0; offset < FILE_BYTES; offset += RECORD_SIZE)
+    {
+        size =  FILE_BYTES - offset;
+        if (size > RECORD_SIZE)
+            size =  RECORD_SIZE;
+        status =  record_write(&file_a, 1, offset, size);
+        status += record_write(&file_b, 2, offset, size);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    status =  fx_file_close(&file_a);
+    status += fx_file_close(&file_b);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The clusters of each write of a buffer were allocated as one run, none of them in a hole.  */
+    status =  file_runs_get(file_a.fx_file_first_physical_cluster, FILE_CLUSTERS, &runs, &lowest_cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((runs <= (FILE_CLUSTERS / ((WRITE_BUFFER_SIZE / SECTOR_SIZE) - 1)) + 1) && (lowest_cluster > holes_end));
+    status =  file_runs_get(file_b.fx_file_first_physical_cluster, FILE_CLUSTERS, &runs, &lowest_cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((runs <= (FILE_CLUSTERS / ((WRITE_BUFFER_SIZE / SECTOR_SIZE) - 1)) + 1) && (lowest_cluster > holes_end));
+
+    /* Without a write buffer, a write takes one run and the next write continues it.  */
+    status =  fx_file_create(&ram_disk, "C.BIN");
+    status += fx_file_open(&ram_disk, &file_c, "C.BIN", FX_OPEN_FOR_WRITE);
+    status += record_write(&file_c, 3, 0, CHUNK_CLUSTERS * SECTOR_SIZE);
+    status += record_write(&file_c, 3, CHUNK_CLUSTERS * SECTOR_SIZE, CHUNK_CLUSTERS * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_runs_get(file_c.fx_file_first_physical_cluster, 2 * CHUNK_CLUSTERS, &runs, &lowest_cluster);
+    return_if_fail((status == FX_SUCCESS) && (runs == 1) && (lowest_cluster > holes_end));
+    status =  fx_file_close(&file_c);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Gather a record in the write buffer of another file, whose clusters are allocated only
+       when the buffer is written.  */
+    status =  fx_file_create(&ram_disk, "E.BIN");
+    status += fx_file_open(&ram_disk, &file_b, "E.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_write_buffer_set(&file_b, write_buffer_b, sizeof(write_buffer_b));
+    status += record_write(&file_b, 5, 0, RECORD_SIZE);
+    return_if_fail((status == FX_SUCCESS) && (file_b.fx_file_write_buffer_bytes == RECORD_SIZE));
+
+    /* Fill the media. Once no run is long enough, the holes are allocated one by one.  */
+    status =  fx_file_create(&ram_disk, "D.BIN");
+    status += fx_file_open(&ram_disk, &file_c, "D.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    first_cluster =  0;
+    offset =         0;
+    while (ram_disk.fx_media_available_clusters)
+    {
+        size =  ram_disk.fx_media_available_clusters;
+        if (size > CHUNK_CLUSTERS)
+            size =  CHUNK_CLUSTERS;
+        status =  record_write(&file_c, 4, offset, size * SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+        if (first_cluster == 0)
+            first_cluster =  file_c.fx_file_first_physical_cluster;
+        offset +=  size * SECTOR_SIZE;
+    }
+    status =  file_runs_get(first_cluster, offset / SECTOR_SIZE, &runs, &lowest_cluster);
+    return_if_fail((status == FX_SUCCESS) && (lowest_cluster < holes_end));
+    status =  record_write(&file_c, 4, offset, SECTOR_SIZE);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+
+    /* With no run long enough, a write searches only some of the FAT entries for one.  */
+    return_if_fail(ram_disk.fx_media_total_clusters > 2 * FX_FILE_DELAYED_ALLOCATION_SEARCH_CLUSTERS);
+    fat_entry_reads =  _fx_utility_fat_entry_read_count;
+    status =  _fx_utility_FAT_free_run_find(&ram_disk, 0, 2, FX_FILE_DELAYED_ALLOCATION_SEARCH_CLUSTERS, &first_cluster);
+    return_if_fail((status == FX_SUCCESS) && (first_cluster == 0));
+    return_if_fail(_fx_utility_fat_entry_read_count - fat_entry_reads <= FX_FILE_DELAYED_ALLOCATION_SEARCH_CLUSTERS);
+
+    /* The buffered record cannot be allocated any more. Closing its file discards it, returns
+       the error and still closes the file.  */
+    status =  fx_file_close(&file_b);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+    status =  fx_file_close(&file_b);
+    return_if_fail(status == FX_NOT_OPEN);
+
+    /* Closing the media with a buffered record that cannot be allocated returns the error, but
+       does not abort the media, so the file that filled it and is still open is kept.  */
+    status =  fx_file_open(&ram_disk, &file_b, "E.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_write_buffer_set(&file_b, write_buffer_b, sizeof(write_buffer_b));
+    status += record_write(&file_b, 5, 0, RECORD_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+
+    /* Check the media, then read the files back after it is opened again.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_check(&ram_disk, ram_disk_memory + TOTAL_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+    status =  fx_file_open(&ram_disk, &file_b, "E.BIN", FX_OPEN_FOR_READ);
+    return_if_fail((status == FX_SUCCESS) && (file_b.fx_file_current_file_size == 0));
+    status =  fx_file_close(&file_b);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_verify("A.BIN", 1, FILE_BYTES);
+    status += file_verify("B.BIN", 2, FILE_BYTES);
+    status += file_verify("C.BIN", 3, 2 * CHUNK_CLUSTERS * SECTOR_SIZE);
+    status += file_verify("D.BIN", 4, offset);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_delayed_allocation_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File delayed allocation test...........................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,301 @@
+/* This FileX test concentrates on the clusters reserved for exFAT files written at the same time.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_EXFAT_CLUSTER_RESERVATION
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     CACHE_SECTORS           16
+#define     ROUNDS                  (3 * FX_EXFAT_RESERVATION_CLUSTERS)
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 file_a;
+static FX_FILE                 file_b;
+static FX_FILE                 file_c;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE];
+static UCHAR                   read_buffer[SECTOR_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_file_exfat_cluster_reservation_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_exfat_cluster_reservation_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Fill the data buffer with the pattern of a cluster of a file.  */
+
+static VOID  data_fill(ULONG file_id, ULONG round)
+{
+
+ULONG       i;
+
+
+    for (i = 0; i < SECTOR_SIZE; i++)
+    {
+        data_buffer[i] =  (UCHAR)(file_id * 31 + round + i);
+    }
+}
+
+
+/* Write one cluster to a file and count the times a new cluster did not follow the last cluster of the file.  */
+
+static UINT  cluster_write(FX_FILE *file_ptr, ULONG file_id, ULONG round, ULONG *jumps)
+{
+
+UINT        status;
+ULONG       last_cluster;
+
+
+    last_cluster =  file_ptr -> fx_file_last_physical_cluster;
+    data_fill(file_id, round);
+    status =  fx_file_write(file_ptr, data_buffer, SECTOR_SIZE);
+    if ((status == FX_SUCCESS) && (last_cluster) && (file_ptr -> fx_file_last_physical_cluster != last_cluster) &&
+        (file_ptr -> fx_file_last_physical_cluster != last_cluster + 1))
+    {
+        *jumps =  *jumps + 1;
+    }
+    return(status);
+}
+
+
+/* Read a file back and compare it with the data written.  */
+
+static UINT  file_verify(CHAR *name, ULONG file_id, ULONG rounds)
+{
+
+UINT        status;
+ULONG       round;
+ULONG       actual;
+
+
+    status =  fx_file_open(&ram_disk, &file_a, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    if (file_a.fx_file_current_file_size != rounds * SECTOR_SIZE)
+        return(FX_IO_ERROR);
+    for (round = 0; round < rounds; round++)
+    {
+        data_fill(file_id, round);
+        status =  fx_file_read(&file_a, read_buffer, SECTOR_SIZE, &actual);
+        if ((status != FX_SUCCESS) || (actual != SECTOR_SIZE) ||
+            (memcmp(read_buffer, data_buffer, SECTOR_SIZE) != 0))
+            return(FX_IO_ERROR);
+    }
+    return(fx_file_close(&file_a));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       round;
+ULONG       jumps_a;
+ULONG       jumps_b;
+ULONG       jumps_c;
+ULONG       rounds_c;
+ULONG       available_clusters;
+ULONG       errors_detected;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File exFAT cluster reservation test....................");
+
+    /* Format an exFAT media.  */
+    status =  fx_media_exFAT_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // exFAT Sectors per cluster
+                            12345,                  // Volume ID
+                            0);                     // Boundary unit
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_FAT_type == FX_exFAT);
+    available_clusters =  ram_disk.fx_media_available_clusters;
+
+    /* Open two files and write them a cluster at a time, one after the other.  */
+    status =  fx_file_create(&ram_disk, "A.BIN");
+    status += fx_file_create(&ram_disk, "B.BIN");
+    status += fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_open(&ram_disk, &file_b, "B.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((file_a.fx_file_reserved_clusters == 0) && (file_b.fx_file_reserved_clusters == 0));
+    jumps_a =  0;
+    jumps_b =  0;
+    for (round = 0; round < FX_EXFAT_RESERVATION_CLUSTERS; round++)
+    {
+        status =  cluster_write(&file_a, 0, round, &jumps_a);
+        status += cluster_write(&file_b, 1, round, &jumps_b);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    /* Each file took a window of its own and stayed contiguous, without a FAT chain.  */
+    return_if_fail((jumps_a == 0) && (jumps_b == 0));
+    return_if_fail(file_a.fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1);
+    return_if_fail(file_b.fx_file_dir_entry.fx_dir_entry_dont_use_fat & 1);
+    return_if_fail(file_b.fx_file_first_physical_cluster >= file_a.fx_file_first_physical_cluster + FX_EXFAT_RESERVATION_CLUSTERS);
+    return_if_fail((file_a.fx_file_reserved_clusters == 0) && (file_b.fx_file_reserved_clusters == 0));
+
+    /* Writing on, a file moves to a new window once the clusters after it are another file's,
+       so the files are made of whole windows.  */
+    for (round = FX_EXFAT_RESERVATION_CLUSTERS; round < ROUNDS; round++)
+    {
+        status =  cluster_write(&file_a, 0, round, &jumps_a);
+        status += cluster_write(&file_b, 1, round, &jumps_b);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail((jumps_a <= (ROUNDS / FX_EXFAT_RESERVATION_CLUSTERS) - 1) &&
+                   (jumps_b <= (ROUNDS / FX_EXFAT_RESERVATION_CLUSTERS) - 1));
+
+    /* Write one more cluster to each, so both hold a window.  */
+    status =  cluster_write(&file_a, 0, ROUNDS, &jumps_a);
+    status += cluster_write(&file_b, 1, ROUNDS, &jumps_b);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_a.fx_file_reserved_clusters == FX_EXFAT_RESERVATION_CLUSTERS - 1);
+    return_if_fail(file_b.fx_file_reserved_clusters == FX_EXFAT_RESERVATION_CLUSTERS - 1);
+
+    /* Closing a file releases its window, the reserved clusters were never marked in the bitmap.  */
+    status =  fx_file_close(&file_a);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_a.fx_file_reserved_clusters == 0);
+    return_if_fail(file_b.fx_file_reserved_clusters == FX_EXFAT_RESERVATION_CLUSTERS - 1);
+    return_if_fail(ram_disk.fx_media_available_clusters == available_clusters - 2 * (ROUNDS + 1));
+
+    /* Allocating ahead takes the clusters of the file's own window.  */
+    status =  fx_file_allocate(&file_b, (FX_EXFAT_RESERVATION_CLUSTERS / 2) * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_b.fx_file_reserved_clusters == 0);
+    for (round = ROUNDS + 1; round < ROUNDS + 1 + (FX_EXFAT_RESERVATION_CLUSTERS / 2); round++)
+    {
+        status =  cluster_write(&file_b, 1, round, &jumps_b);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(jumps_b <= ROUNDS / FX_EXFAT_RESERVATION_CLUSTERS);
+
+    /* Write B on so it holds a window again, then fill the media with another file. The last
+       free clusters are those reserved for B, released when nothing else is left.  */
+    status =  cluster_write(&file_b, 1, round, &jumps_b);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_b.fx_file_reserved_clusters == FX_EXFAT_RESERVATION_CLUSTERS - 1);
+    status =  fx_file_create(&ram_disk, "C.BIN");
+    status += fx_file_open(&ram_disk, &file_c, "C.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    jumps_c =   0;
+    rounds_c =  0;
+    while (ram_disk.fx_media_available_clusters)
+    {
+        status =  cluster_write(&file_c, 2, rounds_c, &jumps_c);
+        return_if_fail(status == FX_SUCCESS);
+        rounds_c++;
+    }
+    return_if_fail(file_b.fx_file_reserved_clusters == 0);
+    status =  cluster_write(&file_c, 2, rounds_c, &jumps_c);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+    status =  cluster_write(&file_b, 1, round + 1, &jumps_b);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+    status =  fx_file_close(&file_b);
+    status += fx_file_close(&file_c);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Check the media, then read the files back after it is opened again.  */
+    status =  fx_media_check(&ram_disk, ram_disk_memory + TOTAL_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_available_clusters == 0);
+    status =  file_verify("A.BIN", 0, ROUNDS + 1);
+    status += file_verify("B.BIN", 1, round + 1);
+    status += file_verify("C.BIN", 2, rounds_c);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_exfat_cluster_reservation_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File exFAT cluster reservation test....................N/A\n");
+
+    test_control_return(255);
+}
+#endif
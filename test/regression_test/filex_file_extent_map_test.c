@@ -0,0 +1,404 @@
+/* This FileX test concentrates on the extent map of files.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_fault_tolerant.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           8192
+#define     CACHE_SECTORS           8
+#define     FRAGMENTS               1000
+#define     RUN_CLUSTERS            50
+#define     FILE_CLUSTERS           (FRAGMENTS + RUN_CLUSTERS)
+#define     EXTENTS                 (FRAGMENTS + 8)
+#define     SMALL_EXTENTS           10
+#define     RANDOM_ACCESSES         200
+#define     WORDS                   (SECTOR_SIZE / sizeof(UINT))
+#define     FAULT_TOLERANT_SIZE     FX_FAULT_TOLERANT_MINIMAL_BUFFER_SIZE
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 file_a;
+static FX_FILE                 file_b;
+static FX_FILE                 reader;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   disk_memory[TOTAL_SECTORS * SECTOR_SIZE];
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UINT                    data_buffer[WORDS];
+static FX_FILE_EXTENT          extent_memory[EXTENTS + 1];
+static FX_FILE_EXTENT          reader_memory[EXTENTS];
+#ifdef FX_ENABLE_FAULT_TOLERANT
+static UCHAR                   fault_tolerant_buffer[FAULT_TOLERANT_SIZE];
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+static ULONG                   random_seed;
+
+
+/* Define thread prototypes.  */
+
+void    filex_file_extent_map_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_extent_map_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Return a pseudo random number below the limit.  */
+
+static ULONG  random_get(ULONG limit)
+{
+
+    random_seed =  random_seed * 1103515245 + 12345;
+    return((random_seed >> 8) % limit);
+}
+
+
+/* Write sectors whose words hold the tag and the index of the sector.  */
+
+static void  sectors_write(FX_FILE *file_ptr, UINT tag, ULONG index, ULONG count)
+{
+
+UINT        status;
+ULONG       i;
+
+
+    while (count--)
+    {
+        for (i = 0; i < WORDS; i++)
+        {
+            data_buffer[i] =  (tag << 20) | (UINT)index;
+        }
+        status =  fx_file_write(file_ptr, data_buffer, SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+        index++;
+    }
+}
+
+
+/* Seek to a sector of the file and make sure it holds the tag and the index.  */
+
+static void  sector_check(FX_FILE *file_ptr, UINT tag, ULONG index)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       i;
+
+
+    status =  fx_file_seek(file_ptr, index * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    memset(data_buffer, 0, sizeof(data_buffer));
+    status =  fx_file_read(file_ptr, data_buffer, SECTOR_SIZE, &actual);
+    return_if_fail((status == FX_SUCCESS) && (actual == SECTOR_SIZE));
+    for (i = 0; i < WORDS; i++)
+    {
+        return_if_fail(data_buffer[i] == ((tag << 20) | (UINT)index));
+    }
+}
+
+
+/* Read random sectors of the file and return the number of FAT entries read.  */
+
+static ULONG  random_check(FX_FILE *file_ptr, UINT tag, ULONG sectors)
+{
+
+ULONG       fat_reads;
+ULONG       i;
+
+
+    random_seed =  1;
+    fat_reads =  ram_disk.fx_media_fat_entry_reads;
+    for (i = 0; i < RANDOM_ACCESSES; i++)
+    {
+        sector_check(file_ptr, tag, random_get(sectors));
+    }
+    return(ram_disk.fx_media_fat_entry_reads - fat_reads);
+}
+
+
+/* Run the test on a freshly formatted media.  */
+
+static void  extent_map_test(UINT exfat)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       index;
+ULONG       reads_fat;
+ULONG       reads_map;
+
+
+    /* Format the media with one sector per cluster.  */
+#ifdef FX_ENABLE_EXFAT
+    if (exfat)
+    {
+        status =  fx_media_exFAT_format(&ram_disk,
+                                _fx_ram_driver,         // Driver entry
+                                disk_memory,            // RAM disk memory pointer
+                                cache_buffer,           // Media buffer pointer
+                                sizeof(cache_buffer),   // Media buffer size
+                                "MY_RAM_DISK",          // Volume Name
+                                1,                      // Number of FATs
+                                0,                      // Hidden sectors
+                                TOTAL_SECTORS,          // Total sectors
+                                SECTOR_SIZE,            // Sector size
+                                1,                      // exFAT Sectors per cluster
+                                12345,                  // Volume ID
+                                0);                     // Boundary unit
+    }
+    else
+#else
+    FX_PARAMETER_NOT_USED(exfat);
+#endif /* FX_ENABLE_EXFAT */
+    {
+        status =  fx_media_format(&ram_disk,
+                                _fx_ram_driver,         // Driver entry
+                                disk_memory,            // RAM disk memory pointer
+                                cache_buffer,           // Media buffer pointer
+                                sizeof(cache_buffer),   // Media buffer size
+                                "MY_RAM_DISK",          // Volume Name
+                                1,                      // Number of FATs
+                                32,                     // Directory Entries
+                                0,                      // Hidden sectors
+                                TOTAL_SECTORS,          // Total sectors
+                                SECTOR_SIZE,            // Sector size
+                                1,                      // Sectors per cluster
+                                1,                      // Heads
+                                1);                     // Sectors per track
+    }
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+#ifdef FX_ENABLE_FAULT_TOLERANT
+    status =  fx_fault_tolerant_enable(&ram_disk, fault_tolerant_buffer, FAULT_TOLERANT_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+    /* Interleave the clusters of two files, so every cluster of the first file is an
+       extent of its own, then finish the first file with a run of clusters.  */
+    status =  fx_file_create(&ram_disk, "A.BIN");
+    status += fx_file_create(&ram_disk, "B.BIN");
+    status += fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_open(&ram_disk, &file_b, "B.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < FRAGMENTS; i++)
+    {
+        sectors_write(&file_a, 1, i, 1);
+        sectors_write(&file_b, 2, i, 1);
+    }
+    sectors_write(&file_a, 1, FRAGMENTS, RUN_CLUSTERS);
+    status =  fx_file_close(&file_a);
+    status += fx_file_close(&file_b);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Random reads follow the cluster chain through the FAT.  */
+    status =  fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_a.fx_file_extent_map == FX_NULL);
+    reads_fat =  random_check(&file_a, 1, FILE_CLUSTERS);
+
+    /* The memory must hold an extent.  */
+    status =  fx_file_extent_map_set(&file_a, extent_memory, sizeof(FX_FILE_EXTENT) - 1);
+    return_if_fail(status == FX_BUFFER_ERROR);
+    return_if_fail(file_a.fx_file_extent_map == FX_NULL);
+
+    /* Give the file an extent map, seeking from the beginning to the end fills it.  */
+    status =  fx_file_extent_map_set(&file_a, ((UCHAR *)extent_memory) + 1, sizeof(extent_memory) - 1);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_a.fx_file_extent_map == (FX_FILE_EXTENT *)(((UCHAR *)extent_memory) + sizeof(ULONG)));
+    return_if_fail(file_a.fx_file_extent_map_size == EXTENTS);
+    return_if_fail(file_a.fx_file_extent_map_count == 0);
+    status =  fx_file_seek(&file_a, 0);
+    status += fx_file_seek(&file_a, FILE_CLUSTERS * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_a.fx_file_extent_map_count == FRAGMENTS + 1);
+    return_if_fail(file_a.fx_file_extent_map_clusters == FILE_CLUSTERS);
+    return_if_fail(file_a.fx_file_extent_map[FRAGMENTS].fx_file_extent_clusters == RUN_CLUSTERS);
+
+    /* The same random reads no longer read the FAT.  */
+    reads_map =  random_check(&file_a, 1, FILE_CLUSTERS);
+    return_if_fail(reads_map == 0);
+    return_if_fail(reads_fat > RANDOM_ACCESSES * 100);
+
+    /* Overwrite random sectors, which replaces clusters with fault tolerance.  */
+    random_seed =  7;
+    for (i = 0; i < RANDOM_ACCESSES / 4; i++)
+    {
+        index =  random_get(FILE_CLUSTERS);
+        status =  fx_file_seek(&file_a, index * SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+        sectors_write(&file_a, 1, index, 1);
+        sector_check(&file_a, 1, index);
+    }
+    random_check(&file_a, 1, FILE_CLUSTERS);
+
+    /* A full map still finds the clusters it does not describe in the FAT.  */
+    status =  fx_file_extent_map_set(&file_a, extent_memory, SMALL_EXTENTS * sizeof(FX_FILE_EXTENT));
+    return_if_fail(status == FX_SUCCESS);
+    random_check(&file_a, 1, FILE_CLUSTERS);
+    return_if_fail(file_a.fx_file_extent_map_count == SMALL_EXTENTS);
+
+    /* Truncate without releasing the clusters.  */
+    status =  fx_file_extent_map_set(&file_a, extent_memory, sizeof(extent_memory));
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_truncate(&file_a, (FILE_CLUSTERS - 10) * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    random_check(&file_a, 1, FILE_CLUSTERS - 10);
+
+    /* Releasing clusters clears the maps of every handle of the file.  */
+    status =  fx_file_open(&ram_disk, &reader, "A.BIN", FX_OPEN_FOR_READ);
+    status += fx_file_extent_map_set(&reader, reader_memory, sizeof(reader_memory));
+    return_if_fail(status == FX_SUCCESS);
+    random_check(&reader, 1, FILE_CLUSTERS - 10);
+    return_if_fail(reader.fx_file_extent_map_count != 0);
+    status =  fx_file_truncate_release(&file_a, (FRAGMENTS / 2) * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((file_a.fx_file_extent_map_count == 0) && (reader.fx_file_extent_map_count == 0));
+
+    /* The released clusters are reused for other files and the file grows again.  */
+    status =  fx_file_open(&ram_disk, &file_b, "B.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_seek(&file_b, FRAGMENTS * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    ram_disk.fx_media_cluster_search_start =  FX_FAT_ENTRY_START;
+    for (i = FRAGMENTS / 2; i < FRAGMENTS; i++)
+    {
+        sectors_write(&file_b, 2, FRAGMENTS + i, 1);
+        sectors_write(&file_a, 3, i, 1);
+    }
+    status =  fx_file_close(&file_b);
+    return_if_fail(status == FX_SUCCESS);
+    random_check(&file_a, 1, FRAGMENTS / 2);
+    random_seed =  3;
+    for (i = 0; i < RANDOM_ACCESSES; i++)
+    {
+        index =  random_get(FRAGMENTS);
+        sector_check(&reader, (index < FRAGMENTS / 2) ? 1 : 3, index);
+    }
+
+    /* Remove the extent maps.  */
+    status =  fx_file_extent_map_set(&file_a, FX_NULL, 0);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((file_a.fx_file_extent_map == FX_NULL) && (file_a.fx_file_extent_map_size == 0));
+    sector_check(&file_a, 3, FRAGMENTS - 1);
+
+    /* A closed file can not get an extent map.  */
+    status =  fx_file_close(&reader);
+    status += fx_file_close(&file_a);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_extent_map_set(&file_a, extent_memory, sizeof(extent_memory));
+    return_if_fail(status == FX_NOT_OPEN);
+
+    /* The map is gone when the file is opened again.  */
+    status =  fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_a.fx_file_extent_map == FX_NULL);
+    status =  fx_file_close(&file_a);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The FAT chains are intact.  */
+    if (!exfat)
+    {
+        status =  fx_media_check(&ram_disk, (UCHAR *)extent_memory, sizeof(extent_memory), FX_FAT_CHAIN_ERROR | FX_LOST_CLUSTER_ERROR, &i);
+        return_if_fail((status == FX_SUCCESS) && (i == 0));
+    }
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+UINT        status;
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File extent map test...................................");
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_file_extent_map_set(FX_NULL, extent_memory, sizeof(extent_memory));
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* Run the test on FAT and on exFAT media.  */
+    extent_map_test(FX_FALSE);
+#ifdef FX_ENABLE_EXFAT
+    extent_map_test(FX_TRUE);
+#endif /* FX_ENABLE_EXFAT */
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_extent_map_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File extent map test...................................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,299 @@
+/* This FileX test concentrates on the sequential read-ahead of files.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_FILE_READ_AHEAD
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     CACHE_SECTORS           64
+#define     FILE_SECTORS            200
+#define     FRAGMENTED_CLUSTERS     40
+#define     PATTERN(o)              ((UCHAR)(((o) / SECTOR_SIZE) ^ ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+static FX_FILE                 other_file;
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE];
+static UCHAR                   write_buffer[2 * SECTOR_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_file_read_ahead_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_read_ahead_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Fill the buffer with the pattern of the file at the specified offset.  */
+
+static void  pattern_fill(UCHAR *buffer, ULONG offset, ULONG size)
+{
+
+ULONG       i;
+
+
+    for (i = 0; i < size; i++)
+    {
+        buffer[i] =  PATTERN(offset + i);
+    }
+}
+
+
+/* Read the whole file in pieces of the specified size with an empty cache, verify its content
+   and return the number of driver read requests.  */
+
+static UINT  file_stream(CHAR *name, ULONG chunk, ULONG max_sectors, ULONG *read_requests)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       offset;
+ULONG       i;
+ULONG       start_requests;
+
+
+    status =  fx_media_cache_invalidate(&ram_disk);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+
+    /* Tune the read-ahead of this file.  */
+    my_file.fx_file_read_ahead_max_sectors =  max_sectors;
+
+    start_requests =  ram_disk.fx_media_driver_read_requests;
+    offset =  0;
+    while (offset < my_file.fx_file_current_file_size)
+    {
+        status =  fx_file_read(&my_file, data_buffer, chunk, &actual);
+        if ((status != FX_SUCCESS) || (actual == 0))
+            return(FX_IO_ERROR);
+        for (i = 0; i < actual; i++)
+        {
+            if (data_buffer[i] != PATTERN(offset + i))
+                return(FX_IO_ERROR);
+        }
+        offset +=  actual;
+    }
+    *read_requests =  ram_disk.fx_media_driver_read_requests - start_requests;
+
+    /* The window never grows beyond the maximum of the file.  */
+    if (my_file.fx_file_read_ahead_window > max_sectors)
+        return(FX_IO_ERROR);
+
+    return(fx_file_close(&my_file));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       actual;
+ULONG       offset;
+ULONG       single_requests;
+ULONG       read_ahead_requests;
+ULONG       requests;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File read ahead test...................................");
+
+    /* Format the media with two sectors per cluster.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            256,                    // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            2,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Create a contiguous file.  */
+    status =  fx_file_create(&ram_disk, "CONTIG.BIN");
+    status += fx_file_open(&ram_disk, &my_file, "CONTIG.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(my_file.fx_file_read_ahead_max_sectors == FX_FILE_READ_AHEAD_SECTORS);
+    for (i = 0; i < FILE_SECTORS; i++)
+    {
+        pattern_fill(write_buffer, i * SECTOR_SIZE, SECTOR_SIZE);
+        status =  fx_file_write(&my_file, write_buffer, SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Create a file whose clusters alternate with the clusters of another file.  */
+    status =  fx_file_create(&ram_disk, "FRAG.BIN");
+    status += fx_file_create(&ram_disk, "OTHER.BIN");
+    status += fx_file_open(&ram_disk, &my_file, "FRAG.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_open(&ram_disk, &other_file, "OTHER.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < FRAGMENTED_CLUSTERS; i++)
+    {
+        pattern_fill(write_buffer, i * 2 * SECTOR_SIZE, 2 * SECTOR_SIZE);
+        status =  fx_file_write(&my_file, write_buffer, 2 * SECTOR_SIZE);
+        status += fx_file_write(&other_file, write_buffer, 2 * SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    status =  fx_file_close(&my_file);
+    status += fx_file_close(&other_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Before: without read-ahead, every sector of small sequential reads is a driver request.  */
+    status =  file_stream("CONTIG.BIN", 100, 0, &single_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(single_requests >= FILE_SECTORS);
+
+    /* After: the read-ahead fetches many sectors with each driver request.  */
+    status =  file_stream("CONTIG.BIN", 100, FX_FILE_READ_AHEAD_SECTORS, &read_ahead_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(read_ahead_requests < (single_requests / 4));
+
+    /* Whole sector reads are read ahead as well.  */
+    status =  file_stream("CONTIG.BIN", SECTOR_SIZE, FX_FILE_READ_AHEAD_SECTORS, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(requests < (single_requests / 4));
+
+    /* A window of one sector is the same as no read-ahead.  */
+    status =  file_stream("CONTIG.BIN", 100, 1, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(requests >= FILE_SECTORS);
+
+    /* The read-ahead of a fragmented file stops at the end of each contiguous cluster.  */
+    status =  file_stream("FRAG.BIN", 100, 0, &single_requests);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_stream("FRAG.BIN", 100, FX_FILE_READ_AHEAD_SECTORS, &read_ahead_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(read_ahead_requests < single_requests);
+    return_if_fail(read_ahead_requests >= FRAGMENTED_CLUSTERS);
+
+    /* Random reads close the window.  */
+    status =  fx_media_cache_invalidate(&ram_disk);
+    status += fx_file_open(&ram_disk, &my_file, "CONTIG.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_read(&my_file, data_buffer, 100, &actual);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_read_ahead_window == 2));
+    status =  fx_file_read(&my_file, data_buffer, 100, &actual);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_read_ahead_window == 4));
+    for (i = 0; i < 20; i++)
+    {
+        offset =  ((i * 7919) % FILE_SECTORS) * SECTOR_SIZE + ((i * 131) % SECTOR_SIZE);
+        status =  fx_file_seek(&my_file, offset);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_file_read(&my_file, data_buffer, 200, &actual);
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail(my_file.fx_file_read_ahead_window == 0);
+        for (requests = 0; requests < actual; requests++)
+        {
+            return_if_fail(data_buffer[requests] == PATTERN(offset + requests));
+        }
+    }
+
+    /* Reading on from the last position opens the window again.  */
+    status =  fx_file_read(&my_file, data_buffer, 100, &actual);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_read_ahead_window == 2));
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_read_ahead_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File read ahead test...................................N/A\n");
+
+    test_control_return(255);
+}
+#endif
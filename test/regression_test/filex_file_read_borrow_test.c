@@ -0,0 +1,498 @@
+/* This FileX test concentrates on the zero-copy file read that lends logical sector cache entries to the caller.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     CACHE_SECTORS           16
+#define     FILE_SIZE               (20 * SECTOR_SIZE + 100)
+#define     OTHER_SIZE              (40 * SECTOR_SIZE)
+#define     RECORD_SIZE             64
+#define     BORROW_FILES            (CACHE_SECTORS / 2 + 1)
+#define     PATTERN(o)              ((UCHAR)(((o) / SECTOR_SIZE) ^ ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+static FX_FILE                 other_file;
+static FX_FILE                 borrow_files[BORROW_FILES];
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[OTHER_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_file_read_borrow_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_read_borrow_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Create a file filled with the test pattern.  */
+
+static UINT  file_create(CHAR *name, ULONG size)
+{
+
+UINT        status;
+ULONG       i;
+
+
+    for (i = 0; i < size; i++)
+    {
+        data_buffer[i] =  PATTERN(i);
+    }
+    status =  fx_file_create(&ram_disk, name);
+    status += fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_WRITE);
+    status += fx_file_write(&my_file, data_buffer, size);
+    status += fx_file_close(&my_file);
+    return(status);
+}
+
+
+/* Check that the data matches the test pattern at the specified file offset.  */
+
+static UINT  data_check(UCHAR *data_ptr, ULONG offset, ULONG size)
+{
+
+ULONG       i;
+
+
+    for (i = 0; i < size; i++)
+    {
+        if (data_ptr[i] != PATTERN(offset + i))
+            return(FX_IO_ERROR);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Parse the file in records with fx_file_read or fx_file_read_borrow and return the
+   number of driver read requests.  */
+
+static UINT  records_parse(UINT borrow, ULONG *requests)
+{
+
+UINT        status;
+ULONG       offset;
+ULONG       size;
+ULONG       start_requests;
+UCHAR      *data_ptr;
+UCHAR       record[RECORD_SIZE];
+
+
+    status =  fx_media_cache_invalidate(&ram_disk);
+    status += fx_file_open(&ram_disk, &my_file, "RECORDS.BIN", FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(FX_IO_ERROR);
+
+    start_requests =  ram_disk.fx_media_driver_read_requests;
+    offset =  0;
+    while (offset < FILE_SIZE)
+    {
+        if (borrow)
+        {
+            status =  fx_file_read_borrow(&my_file, &data_ptr, &size);
+        }
+        else
+        {
+            data_ptr =  record;
+            status =  fx_file_read(&my_file, record, RECORD_SIZE, &size);
+        }
+        if (status != FX_SUCCESS)
+            return(status);
+        status =  data_check(data_ptr, offset, size);
+        if (status != FX_SUCCESS)
+            return(status);
+        offset +=  size;
+    }
+    *requests =  ram_disk.fx_media_driver_read_requests - start_requests;
+
+    if (offset != FILE_SIZE)
+        return(FX_IO_ERROR);
+    return(fx_file_close(&my_file));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT                status;
+ULONG               i;
+ULONG               size;
+ULONG               offset;
+ULONG               actual;
+ULONG               copy_requests;
+ULONG               borrow_requests;
+UCHAR              *data_ptr;
+UCHAR              *other_ptr;
+FX_CACHED_SECTOR   *cache_entry;
+ULONG64             logical_sector;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File read borrow test..................................");
+
+    /* Format the media.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            256,                    // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            2,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  file_create("RECORDS.BIN", FILE_SIZE);
+    status += file_create("OTHER.BIN", OTHER_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The file must be open.  */
+    status =  fx_file_read_borrow(&my_file, &data_ptr, &size);
+    return_if_fail(status == FX_NOT_OPEN);
+    status =  fx_file_read_release(&my_file);
+    return_if_fail(status == FX_NOT_OPEN);
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_file_read_borrow(FX_NULL, &data_ptr, &size);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_file_read_borrow(&my_file, FX_NULL, &size);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_file_read_borrow(&my_file, &data_ptr, FX_NULL);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_file_read_release(FX_NULL);
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* Borrow the whole file sector by sector, crossing clusters.  */
+    status =  fx_file_open(&ram_disk, &my_file, "RECORDS.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_read_release(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+    offset =  0;
+    while (offset < FILE_SIZE)
+    {
+        status =  fx_file_read_borrow(&my_file, &data_ptr, &size);
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail(size == ((FILE_SIZE - offset) < SECTOR_SIZE ? (FILE_SIZE - offset) : SECTOR_SIZE));
+        return_if_fail(data_check(data_ptr, offset, size) == FX_SUCCESS);
+
+        /* The data is inside the pinned cache entry.  */
+        cache_entry =  my_file.fx_file_borrowed_sector;
+        return_if_fail(cache_entry != FX_NULL);
+        return_if_fail(data_ptr == cache_entry -> fx_cached_sector_memory_buffer);
+        return_if_fail(cache_entry -> fx_cached_sector_pin_count == 1);
+        return_if_fail(ram_disk.fx_media_sector_cache_pinned_count == 1);
+        offset +=  size;
+        return_if_fail(my_file.fx_file_current_file_offset == offset);
+    }
+
+    /* The end of the file releases the sector.  */
+    status =  fx_file_read_borrow(&my_file, &data_ptr, &size);
+    return_if_fail((status == FX_END_OF_FILE) && (data_ptr == FX_NULL) && (size == 0));
+    return_if_fail((my_file.fx_file_borrowed_sector == FX_NULL) && (ram_disk.fx_media_sector_cache_pinned_count == 0));
+
+    /* A borrow after a seek starts in the middle of the sector, and fx_file_read continues after it.  */
+    status =  fx_file_seek(&my_file, 700);
+    status += fx_file_read_borrow(&my_file, &data_ptr, &size);
+    return_if_fail((status == FX_SUCCESS) && (size == 2 * SECTOR_SIZE - 700));
+    return_if_fail(data_check(data_ptr, 700, size) == FX_SUCCESS);
+    status =  fx_file_read(&my_file, data_buffer, 100, &actual);
+    return_if_fail((status == FX_SUCCESS) && (actual == 100));
+    return_if_fail(data_check(data_buffer, 2 * SECTOR_SIZE, 100) == FX_SUCCESS);
+
+    /* A borrow after fx_file_read continues after it as well.  */
+    status =  fx_file_read_borrow(&my_file, &data_ptr, &size);
+    return_if_fail((status == FX_SUCCESS) && (size == SECTOR_SIZE - 100));
+    return_if_fail(data_check(data_ptr, 2 * SECTOR_SIZE + 100, size) == FX_SUCCESS);
+
+    /* The pinned sector stays in the cache while many other sectors are read.  */
+    status =  fx_file_seek(&my_file, 0);
+    status += fx_file_read_borrow(&my_file, &data_ptr, &size);
+    return_if_fail(status == FX_SUCCESS);
+    cache_entry =  my_file.fx_file_borrowed_sector;
+    logical_sector =  cache_entry -> fx_cached_sector;
+    status =  fx_file_open(&ram_disk, &other_file, "OTHER.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < OTHER_SIZE / SECTOR_SIZE; i++)
+    {
+        status =  fx_file_seek(&other_file, i * SECTOR_SIZE + 10);
+        status += fx_file_read(&other_file, data_buffer, 10, &actual);
+        return_if_fail((status == FX_SUCCESS) && (actual == 10));
+        return_if_fail(data_check(data_buffer, i * SECTOR_SIZE + 10, 10) == FX_SUCCESS);
+    }
+    return_if_fail((cache_entry -> fx_cached_sector == logical_sector) && (cache_entry -> fx_cached_sector_valid));
+    return_if_fail(data_check(data_ptr, 0, SECTOR_SIZE) == FX_SUCCESS);
+
+    /* Without the pin, the sector is replaced.  */
+    status =  fx_file_read_release(&my_file);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_sector_cache_pinned_count == 0));
+    for (i = 0; i < OTHER_SIZE / SECTOR_SIZE; i++)
+    {
+        status =  fx_file_seek(&other_file, i * SECTOR_SIZE + 10);
+        status += fx_file_read(&other_file, data_buffer, 10, &actual);
+        return_if_fail(status == FX_SUCCESS);
+    }
+#ifndef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* The scan-resistant cache keeps the sector anyway, since it was referenced twice.  */
+    return_if_fail(cache_entry -> fx_cached_sector != logical_sector);
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+    /* Data written through the cache is visible in the borrowed sector.  */
+    status =  fx_file_seek(&my_file, 0);
+    status += fx_file_read_borrow(&my_file, &data_ptr, &size);
+    status += fx_file_close(&other_file);
+    status += fx_file_open(&ram_disk, &other_file, "RECORDS.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_seek(&other_file, 5);
+    status += fx_file_write(&other_file, "BORROWED", 8);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(memcmp(data_ptr + 5, "BORROWED", 8) == 0);
+    for (i = 0; i < 8; i++)
+    {
+        data_buffer[i] =  PATTERN(5 + i);
+    }
+    status =  fx_file_seek(&other_file, 5);
+    status += fx_file_write(&other_file, data_buffer, 8);
+    status += fx_file_close(&other_file);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(data_check(data_ptr, 0, SECTOR_SIZE) == FX_SUCCESS);
+
+    /* Closing the file releases the sector.  */
+    status =  fx_file_close(&my_file);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_sector_cache_pinned_count == 0));
+    return_if_fail(cache_entry -> fx_cached_sector_pin_count == 0);
+
+    /* At most half of the cache can be pinned, files that borrow a pinned sector share its entry.  */
+    for (i = 0; i < BORROW_FILES; i++)
+    {
+        status =  fx_file_open(&ram_disk, &borrow_files[i], "RECORDS.BIN", FX_OPEN_FOR_READ);
+        status += fx_file_seek(&borrow_files[i], i * SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_file_read_borrow(&borrow_files[i], &data_ptr, &size);
+        if (i < (CACHE_SECTORS / 2))
+        {
+            return_if_fail((status == FX_SUCCESS) && (data_check(data_ptr, i * SECTOR_SIZE, size) == FX_SUCCESS));
+        }
+        else
+        {
+            return_if_fail(status == FX_NOT_AVAILABLE);
+        }
+    }
+    return_if_fail(ram_disk.fx_media_sector_cache_pinned_count == CACHE_SECTORS / 2);
+    status =  fx_file_seek(&borrow_files[BORROW_FILES - 1], SECTOR_SIZE + 3);
+    status += fx_file_read_borrow(&borrow_files[BORROW_FILES - 1], &other_ptr, &size);
+    return_if_fail((status == FX_SUCCESS) && (size == SECTOR_SIZE - 3));
+    return_if_fail(borrow_files[BORROW_FILES - 1].fx_file_borrowed_sector == borrow_files[1].fx_file_borrowed_sector);
+    return_if_fail(borrow_files[1].fx_file_borrowed_sector -> fx_cached_sector_pin_count == 2);
+    return_if_fail(data_check(other_ptr, SECTOR_SIZE + 3, size) == FX_SUCCESS);
+
+    /* Data sectors are still read through the remaining entries.  */
+    status =  fx_file_open(&ram_disk, &other_file, "OTHER.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < OTHER_SIZE / SECTOR_SIZE; i++)
+    {
+        status =  fx_file_seek(&other_file, i * SECTOR_SIZE + 20);
+        status += fx_file_read(&other_file, data_buffer, 30, &actual);
+        return_if_fail((status == FX_SUCCESS) && (data_check(data_buffer, i * SECTOR_SIZE + 20, 30) == FX_SUCCESS));
+    }
+    status =  fx_file_read(&other_file, data_buffer, OTHER_SIZE, &actual);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_close(&other_file);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < CACHE_SECTORS / 2; i++)
+    {
+        return_if_fail(data_check(borrow_files[i].fx_file_borrowed_sector -> fx_cached_sector_memory_buffer,
+                                  i * SECTOR_SIZE, SECTOR_SIZE) == FX_SUCCESS);
+    }
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    /* The partitions cannot change while sectors are pinned.  */
+    status =  fx_media_cache_partition_set(&ram_disk, 25, 25, 50);
+    return_if_fail(status == FX_NOT_AVAILABLE);
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+    /* Releasing one of two borrowers keeps the entry pinned.  */
+    status =  fx_file_read_release(&borrow_files[1]);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_sector_cache_pinned_count == CACHE_SECTORS / 2));
+    status =  fx_file_read_release(&borrow_files[1]);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < BORROW_FILES; i++)
+    {
+        status =  fx_file_close(&borrow_files[i]);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(ram_disk.fx_media_sector_cache_pinned_count == 0);
+
+    /* A sector is not read into the cache when every entry that could be replaced is pinned.  */
+    logical_sector =  ram_disk.fx_media_total_sectors - 1;
+    status =  fx_media_cache_invalidate(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < ram_disk.fx_media_sector_cache_size; i++)
+        ram_disk.fx_media_sector_cache[i].fx_cached_sector_pin_count =  1;
+    status =  _fx_utility_logical_sector_read(&ram_disk, logical_sector, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail(status == FX_NOT_AVAILABLE);
+    status =  _fx_utility_logical_sector_read(&ram_disk, logical_sector, data_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < ram_disk.fx_media_sector_cache_size; i++)
+        ram_disk.fx_media_sector_cache[i].fx_cached_sector_pin_count =  0;
+    status =  _fx_utility_logical_sector_read(&ram_disk, logical_sector, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(memcmp(ram_disk.fx_media_memory_buffer, ram_disk_memory + logical_sector * SECTOR_SIZE, SECTOR_SIZE) == 0);
+    return_if_fail(memcmp(data_buffer, ram_disk_memory + logical_sector * SECTOR_SIZE, SECTOR_SIZE) == 0);
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    /* Borrowing is limited to half of the data partition.  */
+    status =  fx_media_cache_partition_set(&ram_disk, 25, 25, 50);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < BORROW_FILES; i++)
+    {
+        status =  fx_file_open(&ram_disk, &borrow_files[i], "RECORDS.BIN", FX_OPEN_FOR_READ);
+        status += fx_file_seek(&borrow_files[i], i * SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_file_read_borrow(&borrow_files[i], &data_ptr, &size);
+        if (i < (ram_disk.fx_media_sector_cache_partition_size[FX_SECTOR_CACHE_PARTITION_DATA] / 2))
+        {
+            return_if_fail(status == FX_SUCCESS);
+        }
+        else
+        {
+            return_if_fail(status == FX_NOT_AVAILABLE);
+        }
+    }
+    status =  fx_file_read(&borrow_files[BORROW_FILES - 1], data_buffer, OTHER_SIZE, &actual);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < BORROW_FILES; i++)
+    {
+        status =  fx_file_close(&borrow_files[i]);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    status =  fx_media_cache_partition_set(&ram_disk, 0, 0, 0);
+    return_if_fail(status == FX_SUCCESS);
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+    /* Before: records are copied out of the cache with fx_file_read.  */
+    status =  records_parse(FX_FALSE, &copy_requests);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* After: whole sectors are borrowed without copying and without extra driver requests.  */
+    status =  records_parse(FX_TRUE, &borrow_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(borrow_requests <= copy_requests);
+
+    /* Closing the media with a borrowed sector and opening it again clears the pins.  */
+    status =  fx_file_open(&ram_disk, &my_file, "RECORDS.BIN", FX_OPEN_FOR_READ);
+    status += fx_file_read_borrow(&my_file, &data_ptr, &size);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_sector_cache_pinned_count == 0));
+    status =  fx_file_read_release(&my_file);
+    return_if_fail(status == FX_NOT_OPEN);
+    status =  fx_file_open(&ram_disk, &my_file, "RECORDS.BIN", FX_OPEN_FOR_READ);
+    status += fx_file_seek(&my_file, FILE_SIZE - 100);
+    status += fx_file_read_borrow(&my_file, &data_ptr, &size);
+    return_if_fail((status == FX_SUCCESS) && (size == 100));
+    return_if_fail(data_check(data_ptr, FILE_SIZE - 100, size) == FX_SUCCESS);
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_read_borrow_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File read borrow test..................................N/A\n");
+
+    test_control_return(255);
+}
+#endif
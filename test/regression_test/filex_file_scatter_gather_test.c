@@ -0,0 +1,316 @@
+/* This FileX test concentrates on scatter-gather driver requests for fragmented files.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     SECTORS_PER_CLUSTER     2
+#define     CLUSTER_SIZE            (SECTOR_SIZE * SECTORS_PER_CLUSTER)
+#define     TOTAL_SECTORS           4096
+#define     CACHE_SECTORS           16
+#define     FRAGMENTS               (2 * FX_SCATTER_GATHER_SEGMENTS)
+#define     FILE_SIZE               (FRAGMENTS * CLUSTER_SIZE)
+#define     PATTERN(o, s)           ((UCHAR)(((o) / SECTOR_SIZE) ^ ((o) % 251) ^ (s)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 fragmented_file;
+static FX_FILE                 other_file;
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[FILE_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_file_scatter_gather_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_scatter_gather_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Fill the buffer with the pattern of the file content.  */
+
+static VOID  pattern_fill(ULONG offset, ULONG size, UCHAR seed)
+{
+
+ULONG       i;
+
+
+    for (i = 0; i < size; i++)
+        data_buffer[i] =  PATTERN(offset + i, seed);
+}
+
+
+/* Read the file from the offset with the cache invalidated, check the content and return
+   the number of driver read requests.  */
+
+static UINT  file_check(ULONG offset, ULONG size, UCHAR seed, ULONG *requests)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       start_requests;
+ULONG       i;
+
+
+    status =  fx_media_cache_invalidate(&ram_disk);
+    status += fx_file_seek(&fragmented_file, offset);
+    if (status != FX_SUCCESS)
+        return(FX_IO_ERROR);
+    memset(data_buffer, 0, sizeof(data_buffer));
+    start_requests =  ram_disk.fx_media_driver_read_requests;
+    status =  fx_file_read(&fragmented_file, data_buffer, size, &actual);
+    if ((status != FX_SUCCESS) || (actual != size))
+        return(FX_IO_ERROR);
+    *requests =  ram_disk.fx_media_driver_read_requests - start_requests;
+    for (i = 0; i < size; i++)
+    {
+        if (data_buffer[i] != PATTERN(offset + i, seed))
+            return(FX_IO_ERROR);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Overwrite the file from the offset and return the number of driver write requests.  */
+
+static UINT  file_overwrite(ULONG offset, ULONG size, UCHAR seed, ULONG *requests)
+{
+
+UINT        status;
+ULONG       start_requests;
+
+
+    status =  fx_file_seek(&fragmented_file, offset);
+    if (status != FX_SUCCESS)
+        return(status);
+    pattern_fill(offset, size, seed);
+    start_requests =  ram_disk.fx_media_driver_write_requests;
+    status =  fx_file_write(&fragmented_file, data_buffer, size);
+    if (status != FX_SUCCESS)
+        return(status);
+    *requests =  ram_disk.fx_media_driver_write_requests - start_requests;
+    return(fx_media_flush(&ram_disk));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       direct_requests;
+ULONG       gather_requests;
+ULONG       requests;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File scatter-gather test...............................");
+
+    /* Format the media.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            SECTORS_PER_CLUSTER,    // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_driver_scatter_gather_supported == FX_TRUE);
+
+    /* Append a cluster to each of the two files in turn, so every cluster of the
+       fragmented file is a run of its own.  */
+    status =  fx_file_create(&ram_disk, "FRAGMENT.BIN");
+    status += fx_file_create(&ram_disk, "OTHER.BIN");
+    status += fx_file_open(&ram_disk, &fragmented_file, "FRAGMENT.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_open(&ram_disk, &other_file, "OTHER.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < FRAGMENTS; i++)
+    {
+        pattern_fill(i * CLUSTER_SIZE, CLUSTER_SIZE, 0);
+        status =  fx_file_write(&fragmented_file, data_buffer, CLUSTER_SIZE);
+        status += fx_file_write(&other_file, data_buffer, CLUSTER_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    status =  fx_file_close(&other_file);
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Before: a direct read stops at the end of each cluster run.  */
+    ram_disk.fx_media_driver_scatter_gather_supported =  FX_FALSE;
+    status =  file_check(0, FILE_SIZE, 0, &direct_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(direct_requests >= FRAGMENTS);
+
+    /* After: each request holds up to FX_SCATTER_GATHER_SEGMENTS runs.  */
+    ram_disk.fx_media_driver_scatter_gather_supported =  FX_TRUE;
+    status =  file_check(0, FILE_SIZE, 0, &gather_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(gather_requests < (direct_requests / 4));
+    return_if_fail(gather_requests <= (direct_requests - FRAGMENTS) + (FRAGMENTS / FX_SCATTER_GATHER_SEGMENTS));
+
+    /* A read that starts and ends inside a sector reads the whole sectors between
+       them with scatter-gather requests.  */
+    status =  file_check(100, FILE_SIZE - 200, 0, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(requests < (direct_requests / 4));
+
+    /* Reads that start in the second sector of a cluster.  */
+    status =  file_check(SECTOR_SIZE, 4 * CLUSTER_SIZE, 0, &requests);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Sequential reads continue at the right sector after a scatter-gather request.  */
+    status =  file_check(0, 3 * CLUSTER_SIZE, 0, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_read(&fragmented_file, data_buffer, 2 * CLUSTER_SIZE + 10, &i);
+    return_if_fail((status == FX_SUCCESS) && (i == 2 * CLUSTER_SIZE + 10));
+    for (i = 0; i < 2 * CLUSTER_SIZE + 10; i++)
+    {
+        return_if_fail(data_buffer[i] == PATTERN(3 * CLUSTER_SIZE + i, 0));
+    }
+
+    /* Before: a direct write stops at the end of each cluster run.  */
+    ram_disk.fx_media_driver_scatter_gather_supported =  FX_FALSE;
+    status =  file_overwrite(0, FILE_SIZE, 1, &direct_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(direct_requests >= FRAGMENTS);
+    status =  file_check(0, FILE_SIZE, 1, &requests);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* After: the runs are gathered into a few requests.  */
+    ram_disk.fx_media_driver_scatter_gather_supported =  FX_TRUE;
+    status =  file_overwrite(0, FILE_SIZE, 2, &gather_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(gather_requests < (direct_requests / 4));
+    status =  file_check(0, FILE_SIZE, 2, &requests);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* A write inside the file that starts in the middle of a sector.  */
+    status =  file_overwrite(CLUSTER_SIZE + 50, 6 * CLUSTER_SIZE, 3, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_check(CLUSTER_SIZE + 50, 6 * CLUSTER_SIZE, 3, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_check(0, CLUSTER_SIZE + 50, 2, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_check(7 * CLUSTER_SIZE + 50, FILE_SIZE - (7 * CLUSTER_SIZE + 50), 2, &requests);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Dirty sectors in the cache are written before they are overwritten by a scatter-gather request.  */
+    status =  fx_file_seek(&fragmented_file, 0);
+    return_if_fail(status == FX_SUCCESS);
+    pattern_fill(0, 10, 4);
+    status =  fx_file_write(&fragmented_file, data_buffer, 10);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_overwrite(20, FILE_SIZE - 20, 4, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_check(0, 10, 4, &requests);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_check(20, FILE_SIZE - 20, 4, &requests);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* An I/O error of the scatter-gather request is returned.  */
+    status =  fx_file_seek(&fragmented_file, 0);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_cache_invalidate(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    _fx_ram_driver_io_error_request =  1;
+    status =  fx_file_read(&fragmented_file, data_buffer, FILE_SIZE, &i);
+    _fx_ram_driver_io_error_request =  0;
+    return_if_fail(status == FX_IO_ERROR);
+
+    status =  fx_file_close(&fragmented_file);
+    status += fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_scatter_gather_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File scatter-gather test...............................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,524 @@
+/* This FileX test concentrates on the write buffer that gathers small appends to a file.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_FILE_WRITE_BUFFER
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     CACHE_SECTORS           16
+#define     WRITE_BUFFER_SIZE       (4 * SECTOR_SIZE)
+#define     LOG_RECORDS             500
+#define     RECORD_SIZE(i)          (20 + (((i) * 37) % 181))
+#define     SHADOW_SIZE             65536
+#define     PATTERN(o)              ((UCHAR)(((o) / SECTOR_SIZE) ^ ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+static FX_FILE                 read_file;
+static FX_FILE                 big_file;
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   write_buffer[WRITE_BUFFER_SIZE];
+static UCHAR                   record_buffer[3 * WRITE_BUFFER_SIZE];
+static UCHAR                   shadow[SHADOW_SIZE];
+static UCHAR                   read_buffer[SHADOW_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_file_write_buffer_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_write_buffer_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Append records to the file and keep a copy of the file content in the shadow buffer.  */
+
+static UINT  record_append(FX_FILE *file_ptr, ULONG size)
+{
+
+ULONG       offset;
+ULONG       i;
+
+
+    /* Buffered data is not included in the file size yet.  */
+    offset =  (ULONG)file_ptr -> fx_file_current_file_size + file_ptr -> fx_file_write_buffer_bytes;
+    if ((offset + size) > SHADOW_SIZE)
+        return(FX_NO_MORE_SPACE);
+    for (i = 0; i < size; i++)
+    {
+        record_buffer[i] =  PATTERN(offset + i);
+        shadow[offset + i] =  record_buffer[i];
+    }
+    return(fx_file_write(file_ptr, record_buffer, size));
+}
+
+
+/* Verify the file content against the shadow buffer.  */
+
+static UINT  file_verify(CHAR *name, ULONG size)
+{
+
+UINT        status;
+ULONG       actual;
+
+
+    status =  fx_file_open(&ram_disk, &read_file, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    if (read_file.fx_file_current_file_size != size)
+        return(FX_IO_ERROR);
+    status =  fx_file_read(&read_file, read_buffer, SHADOW_SIZE, &actual);
+    if ((status != FX_SUCCESS) || (actual != size) || (memcmp(read_buffer, shadow, size) != 0))
+        return(FX_IO_ERROR);
+    return(fx_file_close(&read_file));
+}
+
+
+/* Fill the media with the pattern written directly to a file, a cluster at a time at the end.  */
+
+static UINT  media_fill(FX_FILE *file_ptr, ULONG *size)
+{
+
+UINT        status;
+ULONG       chunk;
+ULONG       i;
+
+
+    *size =  0;
+    chunk =  sizeof(record_buffer);
+    while (chunk >= SECTOR_SIZE)
+    {
+        for (i = 0; i < chunk; i++)
+        {
+            record_buffer[i] =  PATTERN(*size + i);
+        }
+        status =  fx_file_write(file_ptr, record_buffer, chunk);
+        if (status == FX_NO_MORE_SPACE)
+        {
+            chunk =  chunk / 2;
+            continue;
+        }
+        if (status != FX_SUCCESS)
+            return(status);
+        *size =  *size + chunk;
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Verify a file written by media_fill.  */
+
+static UINT  fill_verify(CHAR *name, ULONG size)
+{
+
+UINT        status;
+ULONG       offset;
+ULONG       actual;
+ULONG       i;
+
+
+    status =  fx_file_open(&ram_disk, &read_file, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    if (read_file.fx_file_current_file_size != size)
+        return(FX_IO_ERROR);
+    for (offset = 0; offset < size; offset += actual)
+    {
+        status =  fx_file_read(&read_file, read_buffer, SHADOW_SIZE, &actual);
+        if (status != FX_SUCCESS)
+            return(status);
+        for (i = 0; i < actual; i++)
+        {
+            if (read_buffer[i] != PATTERN(offset + i))
+                return(FX_IO_ERROR);
+        }
+    }
+    return(fx_file_close(&read_file));
+}
+
+
+/* Append the log records to a new file with the specified write buffer, verify the file and
+   return the number of driver requests.  */
+
+static UINT  log_write(CHAR *name, UCHAR *buffer, ULONG buffer_size, ULONG *requests)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       size;
+ULONG       start_requests;
+
+
+    status =  fx_file_create(&ram_disk, name);
+    status += fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_WRITE);
+    if (status != FX_SUCCESS)
+        return(FX_IO_ERROR);
+    if (buffer)
+    {
+        status =  fx_file_write_buffer_set(&my_file, buffer, buffer_size);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+
+    start_requests =  ram_disk.fx_media_driver_write_requests + ram_disk.fx_media_driver_read_requests;
+    size =  0;
+    for (i = 0; i < LOG_RECORDS; i++)
+    {
+        status =  record_append(&my_file, RECORD_SIZE(i));
+        if (status != FX_SUCCESS)
+            return(status);
+        size +=  RECORD_SIZE(i);
+    }
+    status =  fx_file_close(&my_file);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_media_flush(&ram_disk);
+    if (status != FX_SUCCESS)
+        return(status);
+    *requests =  ram_disk.fx_media_driver_write_requests + ram_disk.fx_media_driver_read_requests - start_requests;
+
+    return(file_verify(name, size));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       size;
+ULONG64     offset;
+ULONG       direct_requests;
+ULONG       buffered_requests;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File write buffer test.................................");
+
+    /* Format the media.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            256,                    // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            2,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The file must be open.  */
+    status =  fx_file_write_buffer_set(&my_file, write_buffer, sizeof(write_buffer));
+    return_if_fail(status == FX_NOT_OPEN);
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_file_write_buffer_set(FX_NULL, write_buffer, sizeof(write_buffer));
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* The file must be open for writing and the buffer must hold a sector.  */
+    status =  fx_file_create(&ram_disk, "ERROR.BIN");
+    status += fx_file_open(&ram_disk, &my_file, "ERROR.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_write_buffer_set(&my_file, write_buffer, sizeof(write_buffer));
+    return_if_fail(status == FX_ACCESS_ERROR);
+    status =  fx_file_close(&my_file);
+    status += fx_file_open(&ram_disk, &my_file, "ERROR.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(my_file.fx_file_write_buffer == FX_NULL);
+    status =  fx_file_write_buffer_set(&my_file, write_buffer, SECTOR_SIZE - 1);
+    return_if_fail(status == FX_BUFFER_ERROR);
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Before: small appends rewrite the same partial sector through the cache.  */
+    status =  log_write("DIRECT.LOG", FX_NULL, 0, &direct_requests);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* After: the appends are gathered and written in whole sectors.  */
+    status =  log_write("BUFFER.LOG", write_buffer, sizeof(write_buffer), &buffered_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(buffered_requests < (direct_requests / 4));
+
+    /* A buffer of one sector still combines the appends.  */
+    status =  log_write("SECTOR.LOG", write_buffer, SECTOR_SIZE, &buffered_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(buffered_requests < direct_requests);
+
+    /* Buffered data is not part of the file until it is written.  */
+    status =  fx_file_create(&ram_disk, "MIXED.LOG");
+    status += fx_file_open(&ram_disk, &my_file, "MIXED.LOG", FX_OPEN_FOR_WRITE);
+    status += fx_file_write_buffer_set(&my_file, write_buffer, sizeof(write_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    status =  record_append(&my_file, 100);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((my_file.fx_file_current_file_size == 0) && (my_file.fx_file_write_buffer_bytes == 100));
+
+    /* A relative seek writes the buffer first.  */
+    status =  fx_file_extended_relative_seek(&my_file, 0, FX_SEEK_END);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((my_file.fx_file_current_file_size == 100) && (my_file.fx_file_write_buffer_bytes == 0));
+    return_if_fail(my_file.fx_file_current_file_offset == 100);
+
+    /* A full buffer is kept until an append does not fit, which writes the complete sectors
+       first and keeps the rest.  */
+    status =  record_append(&my_file, WRITE_BUFFER_SIZE - 100);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(my_file.fx_file_write_buffer_bytes == WRITE_BUFFER_SIZE - 100);
+    status =  record_append(&my_file, 100);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(my_file.fx_file_current_file_size == 100);
+    return_if_fail(my_file.fx_file_write_buffer_bytes == WRITE_BUFFER_SIZE);
+    status =  record_append(&my_file, 100);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(my_file.fx_file_current_file_size == WRITE_BUFFER_SIZE);
+    return_if_fail(my_file.fx_file_write_buffer_bytes == 200);
+
+    /* Overwriting data inside the file writes the buffer first and is not buffered.  */
+    status =  fx_file_seek(&my_file, 10);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(my_file.fx_file_current_file_size == WRITE_BUFFER_SIZE + 200);
+    memset(record_buffer, 0xA5, 30);
+    memset(shadow + 10, 0xA5, 30);
+    status =  fx_file_write(&my_file, record_buffer, 30);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 0));
+
+    /* Appends after a seek to the end are buffered again.  */
+    status =  fx_file_seek(&my_file, WRITE_BUFFER_SIZE + 200);
+    status += record_append(&my_file, 50);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 50));
+
+    /* Reading the file writes the buffer first.  */
+    status =  fx_file_seek(&my_file, 0);
+    status += fx_file_read(&my_file, read_buffer, 40, &actual);
+    return_if_fail((status == FX_SUCCESS) && (actual == 40) && (memcmp(read_buffer, shadow, 40) == 0));
+    return_if_fail(my_file.fx_file_current_file_size == WRITE_BUFFER_SIZE + 250);
+
+    /* Media flush writes the buffer.  */
+    status =  fx_file_relative_seek(&my_file, 0, FX_SEEK_END);
+    status += record_append(&my_file, 60);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 60));
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 0));
+    return_if_fail(my_file.fx_file_current_file_size == WRITE_BUFFER_SIZE + 310);
+
+    /* Appends larger than the buffer are written directly when the buffer is empty.  */
+    status =  record_append(&my_file, sizeof(record_buffer));
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 0));
+    return_if_fail(my_file.fx_file_current_file_size == WRITE_BUFFER_SIZE + 310 + sizeof(record_buffer));
+
+    /* Large appends to a buffer that holds data write the buffer first and are then written directly.  */
+    status =  record_append(&my_file, 70);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 70));
+    status =  record_append(&my_file, sizeof(record_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    size =  WRITE_BUFFER_SIZE + 380 + 2 * sizeof(record_buffer);
+    return_if_fail((my_file.fx_file_current_file_size == size) && (my_file.fx_file_write_buffer_bytes == 0));
+
+    /* Truncate writes the buffer first.  */
+    status =  fx_file_extended_truncate(&my_file, size - 20);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 0));
+    size -=  20;
+    return_if_fail(my_file.fx_file_current_file_size == size);
+
+    /* Removing the buffer writes the buffered data.  */
+    status =  fx_file_relative_seek(&my_file, 0, FX_SEEK_END);
+    status += record_append(&my_file, 80);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 80));
+    status =  fx_file_write_buffer_set(&my_file, FX_NULL, 0);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer == FX_NULL));
+    size +=  80;
+    return_if_fail(my_file.fx_file_current_file_size == size);
+    status =  record_append(&my_file, 20);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_current_file_size == size + 20));
+    size +=  20;
+
+    /* Allocating space writes the buffer first.  */
+    status =  fx_file_write_buffer_set(&my_file, write_buffer, sizeof(write_buffer));
+    status += record_append(&my_file, 90);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 90));
+    status =  fx_file_extended_allocate(&my_file, SECTOR_SIZE * 4);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 0));
+    size +=  90;
+    offset =  my_file.fx_file_current_file_offset;
+    return_if_fail(offset == size);
+
+    /* The allocation may have been added to the file size, remove it again.  */
+    status =  fx_file_extended_truncate(&my_file, size);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_current_file_size == size));
+
+    /* Closing the media writes the buffer of a file that is still open.  */
+    status =  record_append(&my_file, 110);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 110));
+    size +=  110;
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_verify("MIXED.LOG", size);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Aborting the media discards the buffered data.  */
+    status =  fx_file_open(&ram_disk, &my_file, "MIXED.LOG", FX_OPEN_FOR_WRITE);
+    status += fx_file_write_buffer_set(&my_file, write_buffer, sizeof(write_buffer));
+    status += fx_file_relative_seek(&my_file, 0, FX_SEEK_END);
+    status += record_append(&my_file, 120);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_abort(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_verify("MIXED.LOG", size);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Fill the media with a file that stays open, then append to a new buffered file.  */
+    status =  fx_file_create(&ram_disk, "FULL.LOG");
+    status += fx_file_create(&ram_disk, "BIG");
+    status += fx_file_open(&ram_disk, &big_file, "BIG", FX_OPEN_FOR_WRITE);
+    status += fx_file_open(&ram_disk, &my_file, "FULL.LOG", FX_OPEN_FOR_WRITE);
+    status += fx_file_write_buffer_set(&my_file, write_buffer, sizeof(write_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    status =  media_fill(&big_file, &size);
+    return_if_fail((status == FX_SUCCESS) && (size > 0) && (ram_disk.fx_media_available_clusters == 0));
+    status =  record_append(&my_file, WRITE_BUFFER_SIZE - 10);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == WRITE_BUFFER_SIZE - 10));
+
+    /* An append that does not fit fails as a whole, and the data that cannot be written is
+       discarded, so the next services of the file do not fail again.  */
+    status =  record_append(&my_file, 100);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+    return_if_fail((my_file.fx_file_write_buffer_bytes == 0) && (my_file.fx_file_current_file_size == 0));
+    status =  fx_file_seek(&my_file, 0);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Media flush returns the error of the buffer and still flushes the media.  */
+    status =  record_append(&my_file, 30);
+    return_if_fail((status == FX_SUCCESS) && (my_file.fx_file_write_buffer_bytes == 30));
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail((status == FX_NO_MORE_SPACE) && (my_file.fx_file_write_buffer_bytes == 0));
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Closing the file returns the error and still closes the file.  */
+    status =  record_append(&my_file, 40);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_NOT_OPEN);
+
+    /* Closing the media returns the error and does not abort it, so the file that filled the
+       media is kept.  */
+    status =  fx_file_open(&ram_disk, &my_file, "FULL.LOG", FX_OPEN_FOR_WRITE);
+    status += fx_file_write_buffer_set(&my_file, write_buffer, sizeof(write_buffer));
+    status += record_append(&my_file, 50);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+    return_if_fail(ram_disk.fx_media_id != FX_MEDIA_ID);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    status =  fill_verify("BIG", size);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_open(&ram_disk, &read_file, "FULL.LOG", FX_OPEN_FOR_READ);
+    return_if_fail((status == FX_SUCCESS) && (read_file.fx_file_current_file_size == 0));
+    status =  fx_file_close(&read_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_file_write_buffer_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   File write buffer test.................................N/A\n");
+
+    test_control_return(255);
+}
+#endif
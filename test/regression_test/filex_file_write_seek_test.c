@@ -335,7 +335,12 @@ ULONG       i;
     ram_disk.fx_media_cluster_search_start = 0;
     _fx_utility_FAT_entry_write(&ram_disk, 0, FX_FREE_CLUSTER);
     status = fx_file_write(&my_file, write_data, 512);
+#ifndef FX_ENABLE_FILE_DELAYED_ALLOCATION
     return_if_fail(FX_SECTOR_INVALID == status);
+#else
+    /* The cluster after the last cluster of the file is taken instead.  */
+    return_if_fail(FX_SUCCESS == status);
+#endif /* FX_ENABLE_FILE_DELAYED_ALLOCATION */
 
     fx_file_close(&my_file);
     fx_media_close(&ram_disk);
@@ -0,0 +1,330 @@
+/* This FileX test concentrates on the asynchronous driver interface.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_ASYNC_DRIVER
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     CACHE_SECTORS           64
+#define     REQUESTS                (3 * FX_ASYNC_DRIVER_QUEUE_DEPTH)
+#define     REQUEST_SECTOR(i)       (2000 + ((i) * 2))
+#define     FLUSH_SECTORS           16
+#define     FLUSH_SECTOR(i)         (3000 + ((i) * 2))
+#define     PATTERN(s, o)           ((UCHAR)((s) ^ ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   request_buffers[REQUESTS][SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE];
+static ULONG                   request_contexts[REQUESTS];
+static ULONG                   completions;
+static ULONG                   completion_errors;
+static ULONG                   context_errors;
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_async_driver_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver_async(FX_MEDIA *media_ptr);
+
+extern ULONG   _fx_ram_driver_async_latency;
+extern ULONG   _fx_ram_driver_async_max_outstanding;
+extern ULONG64 _fx_ram_driver_async_error_sector;
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_async_driver_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Count the completed requests and check that the context belongs to the request.  */
+
+static VOID  request_complete(FX_MEDIA *media_ptr, FX_DRIVER_REQUEST *request_ptr)
+{
+
+ULONG   index;
+
+
+    completions++;
+    if (request_ptr -> fx_driver_request_status != FX_SUCCESS)
+        completion_errors++;
+
+    index =  *((ULONG *)request_ptr -> fx_driver_request_context);
+    if ((media_ptr != &ram_disk) || (request_ptr -> fx_driver_request_logical_sector != REQUEST_SECTOR(index)))
+        context_errors++;
+}
+
+
+/* Submit a write request for each of the request buffers.  */
+
+static UINT  requests_submit(ULONG count)
+{
+
+UINT    status;
+ULONG   i;
+ULONG   j;
+
+
+    for (i = 0; i < count; i++)
+    {
+        for (j = 0; j < SECTOR_SIZE; j++)
+            request_buffers[i][j] =  PATTERN(REQUEST_SECTOR(i), j + count);
+        request_contexts[i] =  i;
+        status =  _fx_utility_driver_request_submit(&ram_disk, FX_DRIVER_WRITE, REQUEST_SECTOR(i), request_buffers[i],
+                                                    1, FX_DATA_SECTOR, request_complete, &request_contexts[i]);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+    return(FX_SUCCESS);
+}
+
+
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+
+/* Read the sector into the cache and modify it, so it is dirty.  */
+
+static UINT  sector_dirty(ULONG logical_sector, ULONG seed)
+{
+
+UINT    status;
+ULONG   j;
+
+
+    status =  _fx_utility_logical_sector_read(&ram_disk, logical_sector, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    if (status != FX_SUCCESS)
+        return(status);
+    for (j = 0; j < SECTOR_SIZE; j++)
+        ram_disk.fx_media_memory_buffer[j] =  PATTERN(logical_sector, j + seed);
+    return(_fx_utility_logical_sector_write(&ram_disk, logical_sector, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR));
+}
+#endif /* FX_ENABLE_COALESCED_SECTOR_FLUSH */
+
+
+/* Read the sectors back through the cache and compare them with the pattern.  */
+
+static UINT  sectors_verify(ULONG first, ULONG stride, ULONG count, ULONG seed)
+{
+
+UINT    status;
+ULONG   i;
+ULONG   j;
+
+
+    status =  fx_media_cache_invalidate(&ram_disk);
+    if (status != FX_SUCCESS)
+        return(status);
+    for (i = 0; i < count; i++)
+    {
+        status =  fx_media_read(&ram_disk, first + (i * stride), data_buffer);
+        if (status != FX_SUCCESS)
+            return(status);
+        for (j = 0; j < SECTOR_SIZE; j++)
+        {
+            if (data_buffer[j] != PATTERN(first + (i * stride), j + seed))
+                return(FX_IO_ERROR);
+        }
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media async driver test................................");
+
+    /* Format the media.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver_async,   // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver_async, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The driver announced the asynchronous interface.  */
+    return_if_fail(ram_disk.fx_media_driver_async_supported == FX_TRUE);
+    return_if_fail(ram_disk.fx_media_driver_async_outstanding == 0);
+
+    /* Waiting without outstanding requests returns right away.  */
+    status =  _fx_utility_driver_request_wait(&ram_disk, 0);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Submit more requests than descriptors, each request waits for a free descriptor.  */
+    _fx_ram_driver_async_latency =  200;
+    _fx_ram_driver_async_max_outstanding =  0;
+    status =  requests_submit(REQUESTS);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_driver_async_outstanding <= FX_ASYNC_DRIVER_QUEUE_DEPTH);
+    status =  _fx_utility_driver_request_wait(&ram_disk, 0);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_driver_async_outstanding == 0);
+    return_if_fail((completions == REQUESTS) && (completion_errors == 0) && (context_errors == 0));
+    return_if_fail((_fx_ram_driver_async_max_outstanding > 1) &&
+                   (_fx_ram_driver_async_max_outstanding <= FX_ASYNC_DRIVER_QUEUE_DEPTH));
+    status =  sectors_verify(REQUEST_SECTOR(0), 2, REQUESTS, REQUESTS);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* A failed request is reported by the wait and the other requests still complete.  */
+    completions =  0;
+    _fx_ram_driver_async_error_sector =  REQUEST_SECTOR(3);
+    status =  requests_submit(FX_ASYNC_DRIVER_QUEUE_DEPTH);
+    return_if_fail(status == FX_SUCCESS);
+    status =  _fx_utility_driver_request_wait(&ram_disk, 0);
+    return_if_fail(status == FX_IO_ERROR);
+    return_if_fail((completions == FX_ASYNC_DRIVER_QUEUE_DEPTH) && (completion_errors == 1) && (context_errors == 0));
+    _fx_ram_driver_async_error_sector =  0;
+
+    /* The error is cleared once it was reported.  */
+    status =  _fx_utility_driver_request_wait(&ram_disk, 0);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Without the asynchronous interface each request completes before submit returns.  */
+    completions =  0;
+    ram_disk.fx_media_driver_async_supported =  FX_FALSE;
+    request_contexts[0] =  0;
+    status =  _fx_utility_driver_request_submit(&ram_disk, FX_DRIVER_WRITE, REQUEST_SECTOR(0), request_buffers[0],
+                                                1, FX_DATA_SECTOR, request_complete, &request_contexts[0]);
+    return_if_fail((status == FX_SUCCESS) && (completions == 1) && (context_errors == 0));
+    return_if_fail(ram_disk.fx_media_driver_async_outstanding == 0);
+    ram_disk.fx_media_driver_async_supported =  FX_TRUE;
+
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+
+    /* Dirty sectors that are not adjacent, so each one is a run of its own.  */
+    for (i = 0; i < FLUSH_SECTORS; i++)
+    {
+        status =  sector_dirty(FLUSH_SECTOR(i), 1);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == FLUSH_SECTORS);
+
+    /* The flush keeps several runs in flight at the same time.  */
+    _fx_ram_driver_async_max_outstanding =  0;
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    return_if_fail(ram_disk.fx_media_driver_async_outstanding == 0);
+    return_if_fail(_fx_ram_driver_async_max_outstanding > 1);
+    status =  sectors_verify(FLUSH_SECTOR(0), 2, FLUSH_SECTORS, 1);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* A failed run leaves its sectors dirty, the other runs are written.  */
+    status =  sector_dirty(FLUSH_SECTOR(0), 2);
+    status += sector_dirty(FLUSH_SECTOR(1), 2);
+    return_if_fail(status == FX_SUCCESS);
+    _fx_ram_driver_async_error_sector =  FLUSH_SECTOR(0);
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_IO_ERROR);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 1);
+    return_if_fail(ram_disk.fx_media_driver_async_outstanding == 0);
+    _fx_ram_driver_async_error_sector =  0;
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_sector_cache_dirty_count == 0));
+    status =  sectors_verify(FLUSH_SECTOR(0), 2, 2, 2);
+    return_if_fail(status == FX_SUCCESS);
+#else
+    FX_PARAMETER_NOT_USED(i);
+#endif /* FX_ENABLE_COALESCED_SECTOR_FLUSH */
+
+    _fx_ram_driver_async_latency =  0;
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_async_driver_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media async driver test................................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,440 @@
+/* This FileX test concentrates on the logical sector cache pool shared by several media.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_SECTOR_CACHE_POOL
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           1024
+#define     VOLUMES                 3
+#define     PRIVATE_SECTORS         16
+#define     POOL_SECTORS            (VOLUMES * PRIVATE_SECTORS)
+#define     POOL_MEMORY_SIZE        (POOL_SECTORS * (SECTOR_SIZE + sizeof(FX_CACHED_SECTOR)) + sizeof(ULONG64))
+#define     RESERVED_SECTORS        2
+#define     BUSY_SIZE               (40 * SECTOR_SIZE)
+#define     IDLE_SIZE               (4 * SECTOR_SIZE)
+#define     CHUNK_SIZE              128
+#define     PASSES                  8
+#define     PATTERN(v, o)           ((UCHAR)((v) + ((o) / SECTOR_SIZE) ^ ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk[VOLUMES];
+static FX_FILE                 my_file;
+static FX_FILE                 write_file;
+static FX_SECTOR_CACHE_POOL    cache_pool;
+static FX_SECTOR_CACHE_POOL    small_pool;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   disk_memory[VOLUMES][TOTAL_SECTORS * SECTOR_SIZE];
+static UCHAR                   private_cache[VOLUMES][PRIVATE_SECTORS * SECTOR_SIZE];
+static UCHAR                   pool_memory[POOL_MEMORY_SIZE];
+static UCHAR                   data_buffer[BUSY_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_cache_pool_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_cache_pool_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Read a file of a volume in small chunks and check it against the test pattern.  */
+
+static UINT  file_check(UINT volume, CHAR *name, ULONG size)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       offset;
+ULONG       i;
+
+
+    status =  fx_file_open(&ram_disk[volume], &my_file, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+
+    for (offset = 0; offset < size; offset += CHUNK_SIZE)
+    {
+        status =  fx_file_read(&my_file, data_buffer, CHUNK_SIZE, &actual);
+        if ((status != FX_SUCCESS) || (actual != CHUNK_SIZE))
+            return(FX_IO_ERROR);
+
+        for (i = 0; i < CHUNK_SIZE; i++)
+        {
+            if (data_buffer[i] != PATTERN(volume, offset + i))
+            {
+                fx_file_close(&my_file);
+                return(FX_IO_ERROR);
+            }
+        }
+    }
+    return(fx_file_close(&my_file));
+}
+
+
+/* Read the file of the busy volume several times and return the number of driver
+   read requests needed.  */
+
+static UINT  busy_read(ULONG *requests)
+{
+
+UINT        status;
+ULONG       start_requests;
+ULONG       pass;
+
+
+    start_requests =  ram_disk[0].fx_media_driver_read_requests;
+    for (pass = 0; pass < PASSES; pass++)
+    {
+        status =  file_check(0, "BUSY.BIN", BUSY_SIZE);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+    *requests =  ram_disk[0].fx_media_driver_read_requests - start_requests;
+    return(FX_SUCCESS);
+}
+
+
+/* Open all volumes with their own caches and read the file of each idle volume.  */
+
+static UINT  volumes_open(void)
+{
+
+UINT        status;
+UINT        volume;
+
+
+    for (volume = 0; volume < VOLUMES; volume++)
+    {
+        status =  fx_media_open(&ram_disk[volume], "RAM DISK", _fx_ram_driver, disk_memory[volume],
+                                private_cache[volume], sizeof(private_cache[volume]));
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+    for (volume = 1; volume < VOLUMES; volume++)
+    {
+        status =  file_check(volume, "IDLE.BIN", IDLE_SIZE);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+UINT        volume;
+ULONG       i;
+ULONG       size;
+ULONG       private_requests;
+ULONG       pool_requests;
+ULONG       entries;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media cache pool test..................................");
+
+    /* The pool memory must hold at least one sector.  */
+    status =  fx_media_cache_pool_create(&cache_pool, pool_memory, SECTOR_SIZE, SECTOR_SIZE);
+    return_if_fail(status == FX_BUFFER_ERROR);
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_media_cache_pool_create(FX_NULL, pool_memory, sizeof(pool_memory), SECTOR_SIZE);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_cache_pool_create(&cache_pool, FX_NULL, sizeof(pool_memory), SECTOR_SIZE);
+    return_if_fail(status == FX_PTR_ERROR);
+
+    /* The pool has not been created yet.  */
+    status =  fx_media_cache_pool_attach(&ram_disk[0], &cache_pool, RESERVED_SECTORS);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_cache_pool_detach(FX_NULL);
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    status =  fx_media_cache_pool_create(&cache_pool, pool_memory, sizeof(pool_memory), SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cache_pool.fx_sector_cache_pool_size == POOL_SECTORS);
+    return_if_fail(cache_pool.fx_sector_cache_pool_free_count == POOL_SECTORS);
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_media_cache_pool_attach(FX_NULL, &cache_pool, RESERVED_SECTORS);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_cache_pool_attach(&ram_disk[0], FX_NULL, RESERVED_SECTORS);
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* The media must be open.  */
+    status =  fx_media_cache_pool_attach(&ram_disk[0], &cache_pool, RESERVED_SECTORS);
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+    status =  fx_media_cache_pool_detach(&ram_disk[0]);
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+
+    /* Format the volumes, the first one is busy and the others are mostly idle.  */
+    for (volume = 0; volume < VOLUMES; volume++)
+    {
+        status =  fx_media_format(&ram_disk[volume],
+                                _fx_ram_driver,         // Driver entry
+                                disk_memory[volume],    // RAM disk memory pointer
+                                private_cache[volume],  // Media buffer pointer
+                                sizeof(private_cache[volume]),  // Media buffer size
+                                "MY_RAM_DISK",          // Volume Name
+                                1,                      // Number of FATs
+                                32,                     // Directory Entries
+                                0,                      // Hidden sectors
+                                TOTAL_SECTORS,          // Total sectors
+                                SECTOR_SIZE,            // Sector size
+                                1,                      // Sectors per cluster
+                                1,                      // Heads
+                                1);                     // Sectors per track
+        return_if_fail(status == FX_SUCCESS);
+
+        status =  fx_media_open(&ram_disk[volume], "RAM DISK", _fx_ram_driver, disk_memory[volume],
+                                private_cache[volume], sizeof(private_cache[volume]));
+        return_if_fail(status == FX_SUCCESS);
+
+        size =  (volume == 0) ? BUSY_SIZE : IDLE_SIZE;
+        for (i = 0; i < size; i++)
+        {
+            data_buffer[i] =  PATTERN(volume, i);
+        }
+        status =  fx_file_create(&ram_disk[volume], (volume == 0) ? "BUSY.BIN" : "IDLE.BIN");
+        status += fx_file_open(&ram_disk[volume], &my_file, (volume == 0) ? "BUSY.BIN" : "IDLE.BIN", FX_OPEN_FOR_WRITE);
+        status += fx_file_write(&my_file, data_buffer, size);
+        status += fx_file_close(&my_file);
+        status += fx_media_close(&ram_disk[volume]);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    /* Measure the busy volume with its own cache, which is smaller than its file.  */
+    status =  volumes_open();
+    return_if_fail(status == FX_SUCCESS);
+    status =  busy_read(&private_requests);
+    return_if_fail(status == FX_SUCCESS);
+    for (volume = 0; volume < VOLUMES; volume++)
+    {
+        status =  fx_media_close(&ram_disk[volume]);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    /* Now attach the volumes to a pool with the same total number of sectors.  */
+    status =  volumes_open();
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The sector size must match.  */
+    ram_disk[0].fx_media_bytes_per_sector =  SECTOR_SIZE * 2;
+    status =  fx_media_cache_pool_attach(&ram_disk[0], &cache_pool, RESERVED_SECTORS);
+    ram_disk[0].fx_media_bytes_per_sector =  SECTOR_SIZE;
+    return_if_fail(status == FX_SECTOR_INVALID);
+
+    /* The reservations must fit in the pool.  */
+    status =  fx_media_cache_pool_attach(&ram_disk[0], &cache_pool, POOL_SECTORS + 1);
+    return_if_fail(status == FX_NOT_ENOUGH_MEMORY);
+    return_if_fail(ram_disk[0].fx_media_sector_cache_pool == FX_NULL);
+
+    /* The media is not attached yet.  */
+    status =  fx_media_cache_pool_detach(&ram_disk[0]);
+    return_if_fail(status == FX_INVALID_STATE);
+
+    for (volume = 0; volume < VOLUMES; volume++)
+    {
+        status =  fx_media_cache_pool_attach(&ram_disk[volume], &cache_pool, RESERVED_SECTORS);
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail(ram_disk[volume].fx_media_sector_cache_pool_entries == 1);
+    }
+    return_if_fail(cache_pool.fx_sector_cache_pool_reserved == VOLUMES * RESERVED_SECTORS);
+
+    /* A media can only be attached once.  */
+    status =  fx_media_cache_pool_attach(&ram_disk[0], &cache_pool, RESERVED_SECTORS);
+    return_if_fail(status == FX_INVALID_STATE);
+
+    /* The cache of an attached media can't be resized.  */
+    status =  fx_media_cache_resize(&ram_disk[0], private_cache[0], sizeof(private_cache[0]));
+    return_if_fail(status == FX_NOT_AVAILABLE);
+
+    /* The private caches must no longer be used.  */
+    memset(private_cache, 0xEE, sizeof(private_cache));
+
+    /* The idle volumes fill part of the pool.  */
+    for (volume = 1; volume < VOLUMES; volume++)
+    {
+        status =  file_check(volume, "IDLE.BIN", IDLE_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail(ram_disk[volume].fx_media_sector_cache_pool_entries > RESERVED_SECTORS);
+    }
+
+    /* Keep a dirty sector on the second volume.  */
+    status =  fx_file_open(&ram_disk[1], &write_file, "IDLE.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_seek(&write_file, 10);
+    data_buffer[0] =  (UCHAR)~PATTERN(1, 10);
+    status += fx_file_write(&write_file, data_buffer, 1);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk[1].fx_media_sector_cache_dirty_count != 0);
+
+    /* The busy volume takes the free entries and the clean entries the idle volumes
+       don't need, so most of its file stays cached.  */
+    status =  busy_read(&pool_requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((pool_requests * 4) < private_requests);
+    return_if_fail(cache_pool.fx_sector_cache_pool_steals != 0);
+    return_if_fail(cache_pool.fx_sector_cache_pool_free_count == 0);
+
+    /* The reservations of the idle volumes are kept and the dirty sector is still cached.  */
+    entries =  0;
+    for (volume = 0; volume < VOLUMES; volume++)
+    {
+        return_if_fail(ram_disk[volume].fx_media_sector_cache_pool_entries >= RESERVED_SECTORS);
+        entries +=  ram_disk[volume].fx_media_sector_cache_pool_entries;
+    }
+    return_if_fail(entries == POOL_SECTORS);
+    return_if_fail(ram_disk[1].fx_media_sector_cache_dirty_count != 0);
+
+    /* The idle volumes still read their files, including the modified byte.  */
+    status =  file_check(2, "IDLE.BIN", IDLE_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_check(1, "IDLE.BIN", IDLE_SIZE);
+    return_if_fail(status == FX_IO_ERROR);
+
+    /* Restore the byte and write it to the media.  */
+    status =  fx_file_seek(&write_file, 10);
+    data_buffer[0] =  PATTERN(1, 10);
+    status += fx_file_write(&write_file, data_buffer, 1);
+    status += fx_file_close(&write_file);
+    status += fx_media_flush(&ram_disk[1]);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk[1].fx_media_sector_cache_dirty_count == 0);
+    status =  file_check(1, "IDLE.BIN", IDLE_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Detach the last volume, it uses its own cache again.  */
+    entries =  ram_disk[2].fx_media_sector_cache_pool_entries;
+    status =  fx_media_cache_pool_detach(&ram_disk[2]);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk[2].fx_media_sector_cache_pool == FX_NULL);
+    return_if_fail(ram_disk[2].fx_media_sector_cache_size == PRIVATE_SECTORS);
+    return_if_fail(cache_pool.fx_sector_cache_pool_free_count == entries);
+    return_if_fail(cache_pool.fx_sector_cache_pool_reserved == 2 * RESERVED_SECTORS);
+    status =  fx_media_cache_pool_detach(&ram_disk[2]);
+    return_if_fail(status == FX_INVALID_STATE);
+    status =  file_check(2, "IDLE.BIN", IDLE_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Write to the busy volume and close it while attached.  */
+    status =  fx_file_open(&ram_disk[0], &write_file, "BUSY.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_seek(&write_file, BUSY_SIZE - 1);
+    data_buffer[0] =  PATTERN(0, BUSY_SIZE - 1);
+    status += fx_file_write(&write_file, data_buffer, 1);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk[0]);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk[0].fx_media_sector_cache_pool == FX_NULL);
+    return_if_fail(cache_pool.fx_sector_cache_pool_free_count == POOL_SECTORS - ram_disk[1].fx_media_sector_cache_pool_entries);
+    return_if_fail(cache_pool.fx_sector_cache_pool_reserved == RESERVED_SECTORS);
+
+    /* Abort the second volume while it is attached, its entries return to the pool.  */
+    status =  fx_media_abort(&ram_disk[1]);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cache_pool.fx_sector_cache_pool_free_count == POOL_SECTORS);
+    return_if_fail(cache_pool.fx_sector_cache_pool_reserved == 0);
+
+    /* Reopen the volumes and check their files.  */
+    status =  fx_media_close(&ram_disk[2]);
+    return_if_fail(status == FX_SUCCESS);
+    status =  volumes_open();
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_check(0, "BUSY.BIN", BUSY_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* A pool holding a single entry still works.  */
+    status =  fx_media_cache_pool_create(&small_pool, pool_memory, SECTOR_SIZE + sizeof(FX_CACHED_SECTOR) + sizeof(ULONG64), SECTOR_SIZE);
+    return_if_fail((status == FX_SUCCESS) && (small_pool.fx_sector_cache_pool_size == 1));
+    status =  fx_media_cache_pool_attach(&ram_disk[0], &small_pool, 1);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_check(0, "BUSY.BIN", BUSY_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The only entry is reserved, there is none for another media.  */
+    status =  fx_media_cache_pool_attach(&ram_disk[2], &small_pool, 1);
+    return_if_fail(status == FX_NOT_ENOUGH_MEMORY);
+
+    for (volume = 0; volume < VOLUMES; volume++)
+    {
+        status =  fx_media_close(&ram_disk[volume]);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(small_pool.fx_sector_cache_pool_free_count == 1);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_cache_pool_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media cache pool test..................................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,322 @@
+/* This FileX test concentrates on resizing the logical sector cache of an open media.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     SMALL_SECTORS           8
+#define     LARGE_SECTORS           320
+#define     FILE_SIZE               (20 * SECTOR_SIZE + 300)
+#define     TAIL_OFFSET             (FILE_SIZE - 200)
+#define     TAIL_SIZE               100
+#define     PATTERN(o)              ((UCHAR)(((o) / SECTOR_SIZE) ^ ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   small_cache[SMALL_SECTORS * SECTOR_SIZE];
+static UCHAR                   large_cache[LARGE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[FILE_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_cache_resize_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_cache_resize_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Read the whole file and check it against the test pattern.  */
+
+static UINT  file_check(CHAR *name)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       i;
+
+
+    memset(data_buffer, 0, sizeof(data_buffer));
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_READ);
+    status += fx_file_read(&my_file, data_buffer, FILE_SIZE, &actual);
+    status += fx_file_close(&my_file);
+    if ((status != FX_SUCCESS) || (actual != FILE_SIZE))
+        return(FX_IO_ERROR);
+
+    for (i = 0; i < FILE_SIZE; i++)
+    {
+        if (data_buffer[i] != PATTERN(i))
+            return(FX_IO_ERROR);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Read a few bytes of the last sector of the file and return the number of driver
+   read requests needed.  */
+
+static UINT  tail_read(ULONG *requests)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       start_requests;
+ULONG       i;
+UCHAR       tail[TAIL_SIZE];
+
+
+    status =  fx_file_open(&ram_disk, &my_file, "RESIZE.BIN", FX_OPEN_FOR_READ);
+    status += fx_file_seek(&my_file, TAIL_OFFSET);
+    if (status != FX_SUCCESS)
+        return(FX_IO_ERROR);
+
+    start_requests =  ram_disk.fx_media_driver_read_requests;
+    status =  fx_file_read(&my_file, tail, TAIL_SIZE, &actual);
+    *requests =  ram_disk.fx_media_driver_read_requests - start_requests;
+    if ((status != FX_SUCCESS) || (actual != TAIL_SIZE))
+        return(FX_IO_ERROR);
+
+    for (i = 0; i < TAIL_SIZE; i++)
+    {
+        if (tail[i] != PATTERN(TAIL_OFFSET + i))
+            return(FX_IO_ERROR);
+    }
+    return(fx_file_close(&my_file));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       requests;
+#ifdef FX_ENABLE_FILE_READ_BORROW
+UCHAR      *data_ptr;
+ULONG       size;
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media cache resize test................................");
+
+    /* The media must be open.  */
+    status =  fx_media_cache_resize(&ram_disk, large_cache, sizeof(large_cache));
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+
+    /* Format the media.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            small_cache,            // Media buffer pointer
+                            sizeof(small_cache),    // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            256,                    // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            2,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, small_cache, sizeof(small_cache));
+    return_if_fail(status == FX_SUCCESS);
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_media_cache_resize(FX_NULL, large_cache, sizeof(large_cache));
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_cache_resize(&ram_disk, FX_NULL, sizeof(large_cache));
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* The memory must hold at least one sector.  */
+    status =  fx_media_cache_resize(&ram_disk, large_cache, SECTOR_SIZE - 1);
+    return_if_fail(status == FX_BUFFER_ERROR);
+
+    /* Write the file and keep it open, so its last sectors are still dirty in the cache.  */
+    for (i = 0; i < FILE_SIZE; i++)
+    {
+        data_buffer[i] =  PATTERN(i);
+    }
+    status =  fx_file_create(&ram_disk, "RESIZE.BIN");
+    status += fx_file_open(&ram_disk, &my_file, "RESIZE.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_write(&my_file, data_buffer, FILE_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Give the cache more memory, the dirty sectors are written out first.  */
+    status =  fx_media_cache_resize(&ram_disk, large_cache, sizeof(large_cache));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_memory_size == sizeof(large_cache));
+#ifndef FX_DISABLE_CACHE
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    return_if_fail(ram_disk.fx_media_sector_cache_size > SMALL_SECTORS);
+    return_if_fail(ram_disk.fx_media_sector_cache_size <= LARGE_SECTORS);
+#endif /* FX_DISABLE_CACHE */
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The old memory must no longer be used.  */
+    memset(small_cache, 0xEE, sizeof(small_cache));
+    return_if_fail(file_check("RESIZE.BIN") == FX_SUCCESS);
+
+    /* The last sector is cached now.  */
+    status =  tail_read(&requests);
+    return_if_fail(status == FX_SUCCESS);
+#ifndef FX_DISABLE_CACHE
+    return_if_fail(requests == 0);
+#endif /* FX_DISABLE_CACHE */
+
+    /* Take the memory back, the most recently used sectors move to the small cache.  */
+    status =  fx_media_cache_resize(&ram_disk, small_cache, sizeof(small_cache));
+    return_if_fail(status == FX_SUCCESS);
+#ifndef FX_DISABLE_CACHE
+    return_if_fail(ram_disk.fx_media_sector_cache_size == SMALL_SECTORS);
+#endif /* FX_DISABLE_CACHE */
+    memset(large_cache, 0xEE, sizeof(large_cache));
+    status =  tail_read(&requests);
+    return_if_fail(status == FX_SUCCESS);
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+    return_if_fail(requests == 0);
+#else
+    return_if_fail(requests != 0);
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+    return_if_fail(file_check("RESIZE.BIN") == FX_SUCCESS);
+
+    /* Grow the cache again.  */
+    status =  fx_media_cache_resize(&ram_disk, large_cache, sizeof(large_cache));
+    return_if_fail(status == FX_SUCCESS);
+    memset(small_cache, 0xEE, sizeof(small_cache));
+    status =  tail_read(&requests);
+    return_if_fail(status == FX_SUCCESS);
+#ifdef FX_ENABLE_LRU_SECTOR_CACHE
+    return_if_fail(requests == 0);
+#else
+    return_if_fail(requests != 0);
+#endif /* FX_ENABLE_LRU_SECTOR_CACHE */
+
+    /* Shrink the cache within the same memory, the cached sectors cannot be moved.  */
+    status =  fx_media_cache_resize(&ram_disk, large_cache, sizeof(large_cache) / 2);
+    return_if_fail(status == FX_SUCCESS);
+    status =  tail_read(&requests);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(requests != 0);
+    return_if_fail(file_check("RESIZE.BIN") == FX_SUCCESS);
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+
+    /* The probationary queue is sized for the new cache.  */
+    return_if_fail(ram_disk.fx_media_sector_cache_probation_limit ==
+                   (ram_disk.fx_media_sector_cache_size >> FX_SECTOR_CACHE_PROBATION_SHIFT));
+#endif /* FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE */
+
+#ifdef FX_ENABLE_SECTOR_CACHE_PARTITION
+
+    /* A partitioned cache is shared by all sector types after the resize.  */
+    status =  fx_media_cache_partition_set(&ram_disk, 20, 30, 50);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_sector_cache_partitioned == FX_TRUE));
+    status =  fx_media_cache_resize(&ram_disk, large_cache, sizeof(large_cache));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_partitioned == FX_FALSE);
+    return_if_fail(ram_disk.fx_media_sector_cache_partition_size[FX_SECTOR_CACHE_PARTITION_DATA] ==
+                   ram_disk.fx_media_sector_cache_size);
+    return_if_fail(file_check("RESIZE.BIN") == FX_SUCCESS);
+#endif /* FX_ENABLE_SECTOR_CACHE_PARTITION */
+
+#ifdef FX_ENABLE_FILE_READ_BORROW
+
+    /* The cache cannot be resized while a sector is borrowed.  */
+    status =  fx_file_open(&ram_disk, &my_file, "RESIZE.BIN", FX_OPEN_FOR_READ);
+    status += fx_file_read_borrow(&my_file, &data_ptr, &size);
+    return_if_fail((status == FX_SUCCESS) && (size == SECTOR_SIZE));
+    status =  fx_media_cache_resize(&ram_disk, small_cache, sizeof(small_cache));
+    return_if_fail(status == FX_NOT_AVAILABLE);
+    status =  fx_file_read_release(&my_file);
+    status += fx_media_cache_resize(&ram_disk, small_cache, sizeof(small_cache));
+    status += fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+#endif /* FX_ENABLE_FILE_READ_BORROW */
+
+    /* Write another file through the resized cache.  */
+    status =  fx_file_create(&ram_disk, "OTHER.BIN");
+    status += fx_file_open(&ram_disk, &my_file, "OTHER.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_write(&my_file, data_buffer, FILE_SIZE);
+    status += fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Both files must be intact on the media.  */
+    memset(large_cache, 0, sizeof(large_cache));
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, large_cache, sizeof(large_cache));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_check("RESIZE.BIN") == FX_SUCCESS);
+    return_if_fail(file_check("OTHER.BIN") == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
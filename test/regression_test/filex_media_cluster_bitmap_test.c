@@ -0,0 +1,399 @@
+/* This FileX test concentrates on the free cluster bitmap of FAT media.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#ifdef FX_ENABLE_FAULT_TOLERANT
+#include   "fx_fault_tolerant.h"
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_FAT_CLUSTER_BITMAP
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           8192
+#define     CACHE_SECTORS           8
+#define     FILES                   10
+#define     FREE_TAIL               8
+#define     RUN_CLUSTERS            4
+#define     BEST_EFFORT_CLUSTERS    100
+#define     BITMAP_WORDS            ((TOTAL_SECTORS + 31) / 32)
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file[FILES];
+static FX_FILE                 big_file;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   disk_memory[TOTAL_SECTORS * SECTOR_SIZE];
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[RUN_CLUSTERS * SECTOR_SIZE];
+static ULONG                   bitmap_memory[BITMAP_WORDS + 1];
+static CHAR                    file_name[] = "FILE0.BIN";
+#ifdef FX_ENABLE_FAULT_TOLERANT
+static UCHAR                   fault_tolerant_buffer[FX_FAULT_TOLERANT_MINIMAL_BUFFER_SIZE];
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_cluster_bitmap_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_cluster_bitmap_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Return the number of clusters the bitmap records as free.  */
+
+static ULONG  bitmap_free_count(void)
+{
+
+ULONG       count;
+ULONG       bit;
+
+
+    count =  0;
+    for (bit = 0; bit < ram_disk.fx_media_total_clusters; bit++)
+    {
+        if ((ram_disk.fx_media_cluster_bitmap[bit >> 5] & (((ULONG)1) << (bit & 31))) == 0)
+        {
+            count++;
+        }
+    }
+    return(count);
+}
+
+
+/* Return the number of clusters the bitmap records as used while their FAT entry is free.  */
+
+static ULONG  bitmap_stale_count(void)
+{
+
+ULONG       count;
+ULONG       bit;
+ULONG       FAT_value;
+
+
+    count =  0;
+    for (bit = 0; bit < ram_disk.fx_media_total_clusters; bit++)
+    {
+        if ((ram_disk.fx_media_cluster_bitmap[bit >> 5] & (((ULONG)1) << (bit & 31))) &&
+            (_fx_utility_FAT_entry_read(&ram_disk, bit + FX_FAT_ENTRY_START, &FAT_value) == FX_SUCCESS) &&
+            (FAT_value == FX_FREE_CLUSTER))
+        {
+            count++;
+        }
+    }
+    return(count);
+}
+
+
+/* Allocate contiguous clusters to the big file, return the FAT entry reads needed
+   and the first cluster allocated, and release the clusters again.  */
+
+static UINT  big_file_allocate(UINT best_effort, ULONG clusters, ULONG *reads, ULONG *first_cluster, ULONG64 *size)
+{
+
+UINT        status;
+ULONG       fat_reads;
+
+
+    /* Start with a clean FAT cache, so every FAT entry examined is counted.  */
+    status =  fx_media_flush(&ram_disk);
+    if (status != FX_SUCCESS)
+        return(status);
+    memset(ram_disk.fx_media_fat_cache, 0, sizeof(ram_disk.fx_media_fat_cache));
+
+    fat_reads =  ram_disk.fx_media_fat_entry_reads;
+    if (best_effort)
+    {
+        status =  fx_file_extended_best_effort_allocate(&big_file, (ULONG64)clusters * SECTOR_SIZE, size);
+    }
+    else
+    {
+        status =  fx_file_extended_allocate(&big_file, (ULONG64)clusters * SECTOR_SIZE);
+        *size =   (ULONG64)clusters * SECTOR_SIZE;
+    }
+    if (status != FX_SUCCESS)
+        return(status);
+    *reads =          ram_disk.fx_media_fat_entry_reads - fat_reads;
+    *first_cluster =  big_file.fx_file_first_physical_cluster;
+
+    /* Release the clusters.  */
+    return(fx_file_extended_truncate_release(&big_file, 0));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       reads_fat;
+ULONG       reads_bitmap;
+ULONG       run_cluster;
+ULONG       cluster_fat;
+ULONG       cluster_bitmap;
+ULONG64     size_fat;
+ULONG64     size_bitmap;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media cluster bitmap test..............................");
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_media_cluster_bitmap_enable(FX_NULL, bitmap_memory, sizeof(bitmap_memory));
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_cluster_bitmap_enable(&ram_disk, FX_NULL, sizeof(bitmap_memory));
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* The media must be open.  */
+    status =  fx_media_cluster_bitmap_enable(&ram_disk, bitmap_memory, sizeof(bitmap_memory));
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+
+    /* Format a FAT16 media with one sector per cluster.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            disk_memory,            // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_cluster_bitmap == FX_NULL);
+
+    /* The memory must be large enough.  */
+    status =  fx_media_cluster_bitmap_enable(&ram_disk, bitmap_memory, 4);
+    return_if_fail(status == FX_NOT_ENOUGH_MEMORY);
+    return_if_fail(ram_disk.fx_media_cluster_bitmap == FX_NULL);
+
+    /* Fill the media one cluster at a time, interleaving the files, until only a small
+       tail of free clusters is left.  */
+    memset(data_buffer, 0x5A, sizeof(data_buffer));
+    for (i = 0; i < FILES; i++)
+    {
+        file_name[4] =  (CHAR)('0' + i);
+        status =  fx_file_create(&ram_disk, file_name);
+        status += fx_file_open(&ram_disk, &my_file[i], file_name, FX_OPEN_FOR_WRITE);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    i =  0;
+    while (ram_disk.fx_media_available_clusters > FREE_TAIL)
+    {
+        status =  fx_file_write(&my_file[i], data_buffer, SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+        i =  (i + 1) % FILES;
+    }
+    for (i = 0; i < FILES; i++)
+    {
+        status =  fx_file_close(&my_file[i]);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    /* Delete the first file, which leaves every tenth cluster free.  */
+    status =  fx_file_delete(&ram_disk, "FILE0.BIN");
+    status += fx_file_create(&ram_disk, "BIG.BIN");
+    status += fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Allocate contiguous clusters by reading the FAT.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, disk_memory, cache_buffer, sizeof(cache_buffer));
+    status += fx_file_open(&ram_disk, &big_file, "BIG.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    status =  big_file_allocate(FX_FALSE, RUN_CLUSTERS, &reads_fat, &run_cluster, &size_fat);
+    return_if_fail(status == FX_SUCCESS);
+    status =  big_file_allocate(FX_TRUE, BEST_EFFORT_CLUSTERS, &i, &cluster_fat, &size_fat);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((size_fat != 0) && (size_fat < (ULONG64)BEST_EFFORT_CLUSTERS * SECTOR_SIZE));
+
+    /* Build the bitmap, it matches the free cluster count.  */
+    status =  fx_media_cluster_bitmap_enable(&ram_disk, ((UCHAR *)bitmap_memory) + 1, sizeof(bitmap_memory) - 1);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_cluster_bitmap == &bitmap_memory[1]);
+    return_if_fail(ram_disk.fx_media_cluster_bitmap_words == (ram_disk.fx_media_total_clusters + 31) / 32);
+    return_if_fail(bitmap_free_count() == ram_disk.fx_media_available_clusters);
+
+    /* The same clusters are allocated with a fraction of the FAT reads.  */
+    status =  big_file_allocate(FX_FALSE, RUN_CLUSTERS, &reads_bitmap, &cluster_bitmap, &size_bitmap);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster_bitmap == run_cluster);
+    return_if_fail(reads_bitmap <= RUN_CLUSTERS * 2);
+    return_if_fail(reads_bitmap * 100 < reads_fat);
+    status =  big_file_allocate(FX_TRUE, BEST_EFFORT_CLUSTERS, &i, &cluster_bitmap, &size_bitmap);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((cluster_bitmap == cluster_fat) && (size_bitmap == size_fat));
+    return_if_fail(bitmap_free_count() == ram_disk.fx_media_available_clusters);
+
+    /* Bits that are out of date are corrected instead of used. Clusters 3 to 5 are used,
+       which makes clusters 2 to 5 look like a free run.  */
+    ram_disk.fx_media_cluster_bitmap[0] &=  ~((ULONG)0xE);
+    status =  big_file_allocate(FX_FALSE, RUN_CLUSTERS, &reads_bitmap, &cluster_bitmap, &size_bitmap);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster_bitmap == run_cluster);
+    return_if_fail((ram_disk.fx_media_cluster_bitmap[0] & 0xE) == 0x2);
+    ram_disk.fx_media_cluster_search_start =  FX_FAT_ENTRY_START + 2;
+    status =  fx_directory_create(&ram_disk, "DIR");
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((ram_disk.fx_media_cluster_bitmap[0] & 0xE) == 0xE);
+    return_if_fail(bitmap_free_count() == ram_disk.fx_media_available_clusters);
+
+    /* Fill the remaining clusters by writing, which takes the holes one by one.  */
+    while (ram_disk.fx_media_available_clusters)
+    {
+        status =  fx_file_write(&big_file, data_buffer, SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(bitmap_free_count() == 0);
+    status =  fx_file_write(&big_file, data_buffer, SECTOR_SIZE);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+    status =  fx_file_close(&big_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Deleting files frees their bits again.  */
+    status =  fx_file_delete(&ram_disk, "BIG.BIN");
+    status += fx_file_delete(&ram_disk, "FILE1.BIN");
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(bitmap_free_count() == ram_disk.fx_media_available_clusters);
+
+    /* Check the media, then rebuild the bitmap from the FAT and compare.  */
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    memcpy(bitmap_memory, &bitmap_memory[1], sizeof(ULONG) * (BITMAP_WORDS - 1));
+    status =  fx_media_cluster_bitmap_enable(&ram_disk, bitmap_memory, sizeof(bitmap_memory));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_cluster_bitmap == bitmap_memory);
+    return_if_fail(bitmap_free_count() == ram_disk.fx_media_available_clusters);
+
+    /* The bitmap is not used after the media is reopened.  */
+    status =  fx_media_close(&ram_disk);
+    status += fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_cluster_bitmap == FX_NULL);
+
+    /* Leave three free clusters with the bitmap enabled.  */
+    status =  fx_media_cluster_bitmap_enable(&ram_disk, bitmap_memory, sizeof(bitmap_memory));
+    status += fx_file_create(&ram_disk, "BIG.BIN");
+    status += fx_file_open(&ram_disk, &big_file, "BIG.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    while (ram_disk.fx_media_available_clusters > 3)
+    {
+        status =  fx_file_extended_best_effort_allocate(&big_file, (ULONG64)(ram_disk.fx_media_available_clusters - 3) * SECTOR_SIZE, &size_bitmap);
+        return_if_fail((status == FX_SUCCESS) && (size_bitmap != 0));
+    }
+    status =  fx_file_close(&big_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* With an overstated available cluster count, a write that needs one more cluster fails
+       rather than take a cluster it found before but did not link yet.  */
+    status =  fx_file_create(&ram_disk, "OVER.BIN");
+    status += fx_file_open(&ram_disk, &my_file[0], "OVER.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    ram_disk.fx_media_available_clusters++;
+    status =  fx_file_write(&my_file[0], data_buffer, RUN_CLUSTERS * SECTOR_SIZE);
+    return_if_fail(status == FX_NO_MORE_SPACE);
+    status =  fx_media_abort(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+#ifdef FX_ENABLE_FAULT_TOLERANT
+
+    /* A fault tolerant directory create that fails after its FAT entry is logged
+       leaves no bit set for the cluster, which stays free.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, disk_memory, cache_buffer, sizeof(cache_buffer));
+    status += fx_media_cluster_bitmap_enable(&ram_disk, bitmap_memory, sizeof(bitmap_memory));
+    status += fx_file_delete(&ram_disk, "BIG.BIN");
+    status += fx_fault_tolerant_enable(&ram_disk, fault_tolerant_buffer, sizeof(fault_tolerant_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 1; ; i++)
+    {
+        _fx_directory_entry_write_error_request =  i;
+        status =  fx_directory_create(&ram_disk, "FTDIR");
+        _fx_directory_entry_write_error_request =  0;
+        return_if_fail(bitmap_stale_count() == 0);
+        if (status == FX_SUCCESS)
+            break;
+    }
+    return_if_fail(i > 1);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_cluster_bitmap_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media cluster bitmap test..............................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,430 @@
+/* This FileX test concentrates on the defragmentation of files on FAT media.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#ifdef FX_ENABLE_FAULT_TOLERANT
+#include   "fx_fault_tolerant.h"
+#endif
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_MEDIA_DEFRAGMENT
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           8000
+#define     CACHE_SECTORS           16
+#define     FILE_CLUSTERS           24
+#define     FILE_BYTES              (FILE_CLUSTERS * SECTOR_SIZE)
+#define     SCRATCH_SECTORS         4
+#define     LONG_NAME               "a_fragmented_file_with_a_long_name.bin"
+#define     PATTERN(f, o)           ((UCHAR)((f) * 41 + ((o) / SECTOR_SIZE) + ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 file_a;
+static FX_FILE                 file_b;
+static FX_FILE                 file_c;
+static FX_FILE                 file_d;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   scratch_buffer[SCRATCH_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE];
+static UCHAR                   read_buffer[SECTOR_SIZE];
+#ifdef FX_ENABLE_FAULT_TOLERANT
+static UCHAR                   fault_tolerant_buffer[FX_FAULT_TOLERANT_MINIMAL_BUFFER_SIZE];
+#endif
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_defragment_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_defragment_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Open the media, with fault tolerance if it is enabled.  */
+
+static UINT  media_open(void)
+{
+
+UINT        status;
+
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+#ifdef FX_ENABLE_FAULT_TOLERANT
+    if (status == FX_SUCCESS)
+        status =  fx_fault_tolerant_enable(&ram_disk, fault_tolerant_buffer, sizeof(fault_tolerant_buffer));
+#endif
+    return(status);
+}
+
+
+/* Append one cluster of the file's pattern.  */
+
+static UINT  cluster_write(FX_FILE *file_ptr, ULONG file_id, ULONG offset)
+{
+
+ULONG       i;
+
+
+    for (i = 0; i < SECTOR_SIZE; i++)
+    {
+        data_buffer[i] =  PATTERN(file_id, offset + i);
+    }
+    return(fx_file_write(file_ptr, data_buffer, SECTOR_SIZE));
+}
+
+
+/* Write files a cluster at a time in turn, so the clusters of each file are not consecutive.  */
+
+static UINT  files_interleave(FX_FILE **files, CHAR **names, ULONG *ids, UINT count)
+{
+
+UINT        status;
+UINT        i;
+ULONG       offset;
+
+
+    for (i = 0; i < count; i++)
+    {
+        status =  fx_file_create(&ram_disk, names[i]);
+        status += fx_file_open(&ram_disk, files[i], names[i], FX_OPEN_FOR_WRITE);
+        if (status != FX_SUCCESS)
+            return(FX_IO_ERROR);
+    }
+    for (offset = 0; offset < FILE_BYTES; offset += SECTOR_SIZE)
+    {
+        for (i = 0; i < count; i++)
+        {
+            status =  cluster_write(files[i], ids[i], offset);
+            if (status != FX_SUCCESS)
+                return(status);
+        }
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Count the runs of consecutive clusters of a file.  */
+
+static UINT  file_runs_get(CHAR *name, ULONG *runs)
+{
+
+UINT        status;
+ULONG       cluster;
+ULONG       next_cluster;
+ULONG       i;
+
+
+    status =  fx_file_open(&ram_disk, &file_d, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    cluster =  file_d.fx_file_first_physical_cluster;
+    *runs =    1;
+    for (i = 1; i < file_d.fx_file_total_clusters; i++)
+    {
+        status =  _fx_utility_FAT_entry_read(&ram_disk, cluster, &next_cluster);
+        if (status != FX_SUCCESS)
+            return(status);
+        if (next_cluster != cluster + 1)
+            *runs =  *runs + 1;
+        cluster =  next_cluster;
+    }
+    return(fx_file_close(&file_d));
+}
+
+
+/* Read a file back and compare it with its pattern.  */
+
+static UINT  file_verify(CHAR *name, ULONG file_id, ULONG size)
+{
+
+UINT        status;
+ULONG       offset;
+ULONG       actual;
+ULONG       i;
+
+
+    status =  fx_file_open(&ram_disk, &file_d, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    if (file_d.fx_file_current_file_size != size)
+        return(FX_IO_ERROR);
+    for (offset = 0; offset < size; offset += SECTOR_SIZE)
+    {
+        status =  fx_file_read(&file_d, read_buffer, SECTOR_SIZE, &actual);
+        if ((status != FX_SUCCESS) || (actual != SECTOR_SIZE))
+            return(FX_IO_ERROR);
+        for (i = 0; i < SECTOR_SIZE; i++)
+        {
+            if (read_buffer[i] != PATTERN(file_id, offset + i))
+                return(FX_IO_ERROR);
+        }
+    }
+    return(fx_file_close(&file_d));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       runs;
+ULONG       calls;
+ULONG       actual;
+ULONG       available;
+ULONG       errors_detected;
+ULONG       i;
+FX_FILE    *files[3];
+CHAR       *names[3];
+ULONG       ids[3];
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media defragment test..................................");
+
+    /* Format a FAT media with one sector per cluster.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            256,                    // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+    status =  media_open();
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Check the error checking of the services.  */
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_media_defragment(FX_NULL, scratch_buffer, sizeof(scratch_buffer), 0);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_defragment(&ram_disk, FX_NULL, sizeof(scratch_buffer), 0);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_file_defragment(FX_NULL);
+    return_if_fail(status == FX_PTR_ERROR);
+#endif
+    status =  fx_file_defragment(&file_a);
+    return_if_fail(status == FX_NOT_OPEN);
+
+    /* An empty media has nothing to move.  */
+    status =  fx_media_defragment(&ram_disk, scratch_buffer, sizeof(scratch_buffer), 1);
+    return_if_fail(status == FX_NO_MORE_ENTRIES);
+
+    /* Fragment a file with a long name and a file in a sub-directory, and a file that stays open.  */
+    status =  fx_directory_create(&ram_disk, "SUB");
+    return_if_fail(status == FX_SUCCESS);
+    files[0] =  &file_a;
+    files[1] =  &file_b;
+    files[2] =  &file_c;
+    names[0] =  "A.BIN";
+    names[1] =  LONG_NAME;
+    names[2] =  "SUB/C.BIN";
+    ids[0] =    1;
+    ids[1] =    2;
+    ids[2] =    3;
+    status =  files_interleave(files, names, ids, 3);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_close(&file_a);
+    status += fx_file_close(&file_b);
+    return_if_fail(status == FX_SUCCESS);
+    names[0] =  "D.BIN";
+    ids[0] =    4;
+    status =  files_interleave(files, names, ids, 1);
+    status += fx_file_close(&file_a);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_runs_get("A.BIN", &runs);
+    return_if_fail((status == FX_SUCCESS) && (runs == FILE_CLUSTERS));
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_runs_get("SUB/C.BIN", &runs);
+    return_if_fail((status == FX_SUCCESS) && (runs > 1));
+
+    /* Defragment the media one file per call. The open file is skipped and the contiguous
+       file is not moved.  */
+    available =  ram_disk.fx_media_available_clusters;
+    calls =      0;
+    do
+    {
+        status =  fx_media_defragment(&ram_disk, scratch_buffer, sizeof(scratch_buffer), FILE_CLUSTERS);
+        calls++;
+    } while ((status == FX_SUCCESS) && (calls < 10));
+    return_if_fail((status == FX_NO_MORE_ENTRIES) && (calls == 3));
+    return_if_fail(ram_disk.fx_media_available_clusters == available);
+    status =  file_runs_get("A.BIN", &runs);
+    return_if_fail((status == FX_SUCCESS) && (runs == 1));
+    status =  file_runs_get(LONG_NAME, &runs);
+    return_if_fail((status == FX_SUCCESS) && (runs == 1));
+    status =  file_runs_get("D.BIN", &runs);
+    return_if_fail((status == FX_SUCCESS) && (runs == 1));
+    status =  file_verify("A.BIN", 1, FILE_BYTES);
+    status += file_verify(LONG_NAME, 2, FILE_BYTES);
+    status += file_verify("D.BIN", 4, FILE_BYTES);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The open file is moved with fx_file_defragment, which needs it opened for writing.  */
+    status =  fx_file_open(&ram_disk, &file_d, "SUB/C.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_defragment(&file_d);
+    return_if_fail(status == FX_ACCESS_ERROR);
+    status =  fx_file_seek(&file_c, FILE_BYTES / 2);
+    status += fx_file_seek(&file_d, FILE_BYTES / 4);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_defragment(&file_c);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(file_d.fx_file_first_physical_cluster == file_c.fx_file_first_physical_cluster);
+
+    /* Both handles continue from their position in the new clusters.  */
+    status =  fx_file_read(&file_d, read_buffer, SECTOR_SIZE, &actual);
+    return_if_fail((status == FX_SUCCESS) && (actual == SECTOR_SIZE));
+    for (i = 0; i < SECTOR_SIZE; i++)
+    {
+        return_if_fail(read_buffer[i] == PATTERN(3, FILE_BYTES / 4 + i));
+    }
+    status =  fx_file_read(&file_c, read_buffer, SECTOR_SIZE, &actual);
+    return_if_fail((status == FX_SUCCESS) && (actual == SECTOR_SIZE));
+    for (i = 0; i < SECTOR_SIZE; i++)
+    {
+        return_if_fail(read_buffer[i] == PATTERN(3, FILE_BYTES / 2 + i));
+    }
+    status =  fx_file_seek(&file_c, FILE_BYTES);
+    status += cluster_write(&file_c, 3, FILE_BYTES);
+    status += fx_file_close(&file_c);
+    status += fx_file_close(&file_d);
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_runs_get("SUB/C.BIN", &runs);
+    return_if_fail((status == FX_SUCCESS) && (runs == 1));
+
+    /* Another pass has nothing left to move.  */
+    status =  fx_media_defragment(&ram_disk, scratch_buffer, sizeof(scratch_buffer), 0);
+    return_if_fail(status == FX_NO_MORE_ENTRIES);
+
+    /* Without scratch memory the data is copied through the cache.  */
+    names[0] =  "SUB/E.BIN";
+    names[1] =  "SUB/F.BIN";
+    ids[0] =    5;
+    ids[1] =    6;
+    status =  files_interleave(files, names, ids, 2);
+    status += fx_file_close(&file_a);
+    status += fx_file_close(&file_b);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_defragment(&ram_disk, FX_NULL, 0, 0);
+    return_if_fail(status == FX_NO_MORE_ENTRIES);
+    status =  file_runs_get("SUB/E.BIN", &runs);
+    return_if_fail((status == FX_SUCCESS) && (runs == 1));
+    status =  file_runs_get("SUB/F.BIN", &runs);
+    return_if_fail((status == FX_SUCCESS) && (runs == 1));
+
+    /* A pass that stopped in a sub-directory that is then deleted starts again from the root.  */
+    names[0] =  "SUB/G.BIN";
+    names[1] =  "SUB/H.BIN";
+    ids[0] =    7;
+    ids[1] =    8;
+    status =  files_interleave(files, names, ids, 2);
+    status += fx_file_close(&file_a);
+    status += fx_file_close(&file_b);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_defragment(&ram_disk, scratch_buffer, sizeof(scratch_buffer), 1);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_defragment_directory != 0));
+    status =  fx_file_delete(&ram_disk, "SUB/C.BIN");
+    status += fx_file_delete(&ram_disk, "SUB/E.BIN");
+    status += fx_file_delete(&ram_disk, "SUB/F.BIN");
+    status += fx_file_delete(&ram_disk, "SUB/G.BIN");
+    status += fx_file_delete(&ram_disk, "SUB/H.BIN");
+    status += fx_directory_delete(&ram_disk, "SUB");
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_defragment(&ram_disk, scratch_buffer, sizeof(scratch_buffer), 0);
+    return_if_fail(status == FX_NO_MORE_ENTRIES);
+
+    /* Check the media, then read the files back after it is opened again.  */
+    status =  fx_media_check(&ram_disk, ram_disk_memory + TOTAL_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+    status =  fx_media_close(&ram_disk);
+    status += media_open();
+    return_if_fail(status == FX_SUCCESS);
+    status =  file_verify("A.BIN", 1, FILE_BYTES);
+    status += file_verify(LONG_NAME, 2, FILE_BYTES);
+    status += file_verify("D.BIN", 4, FILE_BYTES);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_defragment_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media defragment test..................................N/A\n");
+
+    test_control_return(255);
+}
+#endif
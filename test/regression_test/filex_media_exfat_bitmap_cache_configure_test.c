@@ -0,0 +1,387 @@
+/* This FileX test concentrates on the exFAT allocation bitmap windows configured at run time.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_EXFAT_BITMAP_WINDOWS
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           40000
+#define     CACHE_SECTORS           16
+#define     FILES                   256
+#define     FILE_CLUSTERS           128
+#define     ALLOC_CLUSTERS          (FILE_CLUSTERS / 2)
+#define     FULL_SECTORS            6
+#define     WINDOWS                 2
+#define     WINDOW_MEMORY_SIZE      (2 * sizeof(ULONG64) + WINDOWS * (sizeof(FX_EXFAT_BITMAP_WINDOW) + SECTOR_SIZE))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[FILE_CLUSTERS * SECTOR_SIZE];
+static UCHAR                   read_buffer[FILE_CLUSTERS * SECTOR_SIZE];
+static ULONG64                 window_memory[(WINDOW_MEMORY_SIZE / sizeof(ULONG64)) + 1];
+static ULONG64                 large_window_memory[(16 * SECTOR_SIZE) / sizeof(ULONG64)];
+static ULONG                   first_clusters[FILES];
+static ULONG                   bitmap_reads;
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_exfat_bitmap_cache_configure_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_exfat_bitmap_cache_configure_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Count the bitmap sectors read, then pass the request to the RAM driver.  */
+
+static VOID  counting_driver(FX_MEDIA *media_ptr)
+{
+
+    if ((media_ptr -> fx_media_driver_request == FX_DRIVER_READ) &&
+        (media_ptr -> fx_media_exfat_bitmap_start_sector) &&
+        (media_ptr -> fx_media_driver_logical_sector >= media_ptr -> fx_media_exfat_bitmap_start_sector) &&
+        (media_ptr -> fx_media_driver_logical_sector < media_ptr -> fx_media_exfat_bitmap_start_sector +
+                                                        (TOTAL_SECTORS / (SECTOR_SIZE * 8)) + 1))
+    {
+        bitmap_reads +=  media_ptr -> fx_media_driver_sectors;
+    }
+    _fx_ram_driver(media_ptr);
+}
+
+
+/* Create a file and write the number of clusters given to it, returning its first cluster.  */
+
+static UINT  file_write_clusters(CHAR *name, ULONG clusters, ULONG *first_cluster)
+{
+
+UINT        status;
+
+
+    status =  fx_file_create(&ram_disk, name);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_WRITE);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_write(&my_file, data_buffer, clusters * SECTOR_SIZE);
+    if (status != FX_SUCCESS)
+        return(status);
+    *first_cluster =  my_file.fx_file_first_physical_cluster;
+    return(fx_file_close(&my_file));
+}
+
+
+/* Create a file, allocate the number of clusters given to it and fill them, returning its first cluster.  */
+
+static UINT  file_allocate_clusters(CHAR *name, ULONG clusters, ULONG *first_cluster)
+{
+
+UINT        status;
+
+
+    status =  fx_file_create(&ram_disk, name);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_WRITE);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_allocate(&my_file, clusters * SECTOR_SIZE);
+    if (status != FX_SUCCESS)
+        return(status);
+    *first_cluster =  my_file.fx_file_first_physical_cluster;
+
+    /* Write the clusters allocated, so the file size matches the clusters of the entry.  */
+    status =  fx_file_write(&my_file, data_buffer, clusters * SECTOR_SIZE);
+    if (status != FX_SUCCESS)
+        return(status);
+    return(fx_file_close(&my_file));
+}
+
+
+/* Read a file back and compare it with the data written.  */
+
+static UINT  file_verify(CHAR *name, ULONG clusters)
+{
+
+UINT        status;
+ULONG       actual;
+
+
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_read(&my_file, read_buffer, clusters * SECTOR_SIZE, &actual);
+    if ((status != FX_SUCCESS) || (actual != clusters * SECTOR_SIZE) ||
+        (memcmp(read_buffer, data_buffer, clusters * SECTOR_SIZE) != 0))
+        return(FX_IO_ERROR);
+    return(fx_file_close(&my_file));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       cluster;
+ULONG       hole;
+ULONG       default_reads;
+ULONG       available_clusters;
+ULONG64     actual_size;
+ULONG       errors_detected;
+CHAR        name[16];
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media exFAT bitmap cache configure test................");
+
+    for (i = 0; i < sizeof(data_buffer); i++)
+    {
+        data_buffer[i] =  (UCHAR)(i / SECTOR_SIZE + i);
+    }
+
+    /* Format an exFAT media with a bitmap of several sectors.  */
+    status =  fx_media_exFAT_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // exFAT Sectors per cluster
+                            12345,                  // Volume ID
+                            0);                     // Boundary unit
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The media must be open.  */
+    status =  fx_media_exfat_bitmap_cache_configure(&ram_disk, window_memory, sizeof(window_memory), 1);
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", counting_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_FAT_type == FX_exFAT);
+
+    /* The one window of the media control block is used after open.  */
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_windows == &ram_disk.fx_media_exfat_bitmap_window);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_windows_count == 1);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_window.fx_exfat_bitmap_window_buffer == ram_disk.fx_media_exfat_bitmap_cache);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_summary == FX_NULL);
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+
+    /* Check the parameters.  */
+    status =  fx_media_exfat_bitmap_cache_configure(FX_NULL, window_memory, sizeof(window_memory), 1);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_exfat_bitmap_cache_configure(&ram_disk, window_memory, sizeof(window_memory), 0);
+    return_if_fail(status == FX_INVALID_OPTION);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* The memory must hold the summary and one window.  */
+    status =  fx_media_exfat_bitmap_cache_configure(&ram_disk, window_memory, SECTOR_SIZE, 1);
+    return_if_fail(status == FX_NOT_ENOUGH_MEMORY);
+    status =  fx_media_exfat_bitmap_cache_configure(&ram_disk, window_memory, sizeof(window_memory), 4);
+    return_if_fail(status == FX_NOT_ENOUGH_MEMORY);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_windows == &ram_disk.fx_media_exfat_bitmap_window);
+
+    /* Age the media: fill the first bitmap sectors with files, then delete every other one
+       of the last files so the free space is in holes after the full sectors.  */
+    for (i = 0; i < FILES; i++)
+    {
+        sprintf(name, "F%03lu.BIN", (unsigned long)i);
+        status =  file_write_clusters(name, FILE_CLUSTERS, &first_clusters[i]);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    for (i = FILES - 32; i < FILES; i++)
+    {
+        if (i & 1)
+        {
+            sprintf(name, "F%03lu.BIN", (unsigned long)i);
+            status =  fx_file_delete(&ram_disk, name);
+            return_if_fail(status == FX_SUCCESS);
+        }
+    }
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((first_clusters[FILES - 31] - FX_FAT_ENTRY_START) >> 12 > FULL_SECTORS);
+
+    /* With a single window each allocation reads the full bitmap sectors again.  */
+    hole =  FILES - 31;
+    bitmap_reads =  0;
+    status =  file_allocate_clusters("A1.BIN", ALLOC_CLUSTERS, &cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster == first_clusters[hole]);
+    bitmap_reads =  0;
+    status =  file_allocate_clusters("A2.BIN", ALLOC_CLUSTERS, &cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster == first_clusters[hole] + ALLOC_CLUSTERS);
+    default_reads =  bitmap_reads;
+    return_if_fail(default_reads > FULL_SECTORS);
+
+    /* Use two windows of one sector, in memory that is not aligned.  */
+    status =  fx_media_exfat_bitmap_cache_configure(&ram_disk, ((UCHAR *)window_memory) + 1, sizeof(window_memory) - 1, 1);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_windows_count == WINDOWS);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_summary == (ULONG *)&window_memory[1]);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_summary[0] == 0);
+
+    /* The first allocation finds the full sectors and records them in the summary.  */
+    hole =  FILES - 29;
+    status =  file_allocate_clusters("B1.BIN", ALLOC_CLUSTERS, &cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster == first_clusters[hole]);
+    for (i = 0; i < FULL_SECTORS; i++)
+    {
+        return_if_fail(ram_disk.fx_media_exfat_bitmap_summary[0] & (((ULONG)1) << i));
+    }
+
+    /* The next allocation skips the full sectors and finds the hole in a window.  */
+    bitmap_reads =  0;
+    status =  file_allocate_clusters("B2.BIN", ALLOC_CLUSTERS, &cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster == first_clusters[hole] + ALLOC_CLUSTERS);
+    return_if_fail(bitmap_reads == 0);
+
+    /* Freeing clusters in a full sector removes the sector from the summary.  */
+    status =  fx_file_delete(&ram_disk, "F010.BIN");
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((ram_disk.fx_media_exfat_bitmap_summary[0] & (((ULONG)1) << ((first_clusters[10] - FX_FAT_ENTRY_START) >> 12))) == 0);
+    status =  file_allocate_clusters("C1.BIN", FILE_CLUSTERS, &cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster == first_clusters[10]);
+
+    /* Write a file cluster by cluster, each found by the free cluster search.  */
+    status =  file_write_clusters("D1.BIN", FILE_CLUSTERS, &cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster > first_clusters[FILES - 1]);
+
+    /* The best effort allocation returns the longest run when no run is long enough.  */
+    available_clusters =  ram_disk.fx_media_available_clusters;
+    status =  fx_file_create(&ram_disk, "E1.BIN");
+    status += fx_file_open(&ram_disk, &my_file, "E1.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_extended_best_effort_allocate(&my_file, ((ULONG64)TOTAL_SECTORS) * SECTOR_SIZE, &actual_size);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((actual_size > 0) && (actual_size < ((ULONG64)available_clusters) * SECTOR_SIZE));
+    return_if_fail(my_file.fx_file_first_physical_cluster > first_clusters[FILES - 1]);
+    for (i = 0; i < actual_size; i += SECTOR_SIZE)
+    {
+        status +=  fx_file_write(&my_file, data_buffer, SECTOR_SIZE);
+    }
+    status +=  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Use larger windows, the dirty windows are written first.  */
+    status =  fx_media_exfat_bitmap_cache_configure(&ram_disk, large_window_memory, sizeof(large_window_memory), 4);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_cache_size_in_sectors == 4);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_windows_count >= 3);
+    status =  fx_file_delete(&ram_disk, "A2.BIN");
+    status += file_allocate_clusters("A3.BIN", ALLOC_CLUSTERS, &cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster == first_clusters[FILES - 31] + ALLOC_CLUSTERS);
+    status =  fx_media_check(&ram_disk, ram_disk_memory + TOTAL_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+
+    /* Return to the window of the media control block.  */
+    status =  fx_media_exfat_bitmap_cache_configure(&ram_disk, FX_NULL, 0, 0);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_windows == &ram_disk.fx_media_exfat_bitmap_window);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_summary == FX_NULL);
+    status =  file_allocate_clusters("A4.BIN", ALLOC_CLUSTERS, &cluster);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cluster == first_clusters[FILES - 27]);
+
+    /* Check the media, and the free clusters counted from the bitmap after it is opened again.  */
+    available_clusters =  ram_disk.fx_media_available_clusters;
+    status =  fx_media_check(&ram_disk, ram_disk_memory + TOTAL_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_available_clusters == available_clusters);
+    return_if_fail(ram_disk.fx_media_exfat_bitmap_windows == &ram_disk.fx_media_exfat_bitmap_window);
+    status =  file_verify("F000.BIN", FILE_CLUSTERS);
+    status += file_verify("D1.BIN", FILE_CLUSTERS);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_exfat_bitmap_cache_configure_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media exFAT bitmap cache configure test................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,352 @@
+/* This FileX test concentrates on the FAT entry cache configured at run time.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_CONFIGURABLE_FAT_CACHE
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           8000
+#define     CACHE_SECTORS           8
+#define     CACHE_ENTRIES           (4 * FX_MAX_FAT_CACHE)
+#define     CACHE_WAYS              8
+#define     CHAIN_CLUSTERS          FX_MAX_FAT_CACHE
+#define     WRITE_CLUSTERS          (2 * FX_MAX_FAT_CACHE)
+#define     SEEK_PASSES             10
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+static FX_FILE                 gap_file;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[WRITE_CLUSTERS * SECTOR_SIZE];
+static UCHAR                   read_buffer[WRITE_CLUSTERS * SECTOR_SIZE];
+static ULONG                   fat_cache_memory[(CACHE_ENTRIES * sizeof(FX_FAT_CACHE_ENTRY) / sizeof(ULONG)) + 1];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_fat_cache_configure_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_fat_cache_configure_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Create a file and write the number of clusters given to it with a single write.  */
+
+static UINT  file_write_clusters(CHAR *name, ULONG clusters)
+{
+
+UINT        status;
+
+
+    status =  fx_file_create(&ram_disk, name);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_WRITE);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_write(&my_file, data_buffer, clusters * SECTOR_SIZE);
+    if (status != FX_SUCCESS)
+        return(status);
+    return(fx_file_close(&my_file));
+}
+
+
+/* Create a file whose clusters are not consecutive, so its cluster chain is read to seek in it.  */
+
+static UINT  file_chain_create(CHAR *name, ULONG clusters)
+{
+
+UINT        status;
+ULONG       i;
+
+
+    status =  fx_file_create(&ram_disk, name);
+    status += fx_file_create(&ram_disk, "GAP.BIN");
+    status += fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_WRITE);
+    status += fx_file_open(&ram_disk, &gap_file, "GAP.BIN", FX_OPEN_FOR_WRITE);
+    if (status != FX_SUCCESS)
+        return(FX_IO_ERROR);
+    for (i = 0; i < clusters; i++)
+    {
+        status =  fx_file_write(&my_file, data_buffer + i * SECTOR_SIZE, SECTOR_SIZE);
+        status += fx_file_write(&gap_file, data_buffer, SECTOR_SIZE);
+        if (status != FX_SUCCESS)
+            return(FX_IO_ERROR);
+    }
+    status =  fx_file_close(&gap_file);
+    status += fx_file_close(&my_file);
+    return(status);
+}
+
+
+/* Read a file back and compare it with the data written.  */
+
+static UINT  file_verify(CHAR *name, ULONG clusters)
+{
+
+UINT        status;
+ULONG       actual;
+
+
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_read(&my_file, read_buffer, clusters * SECTOR_SIZE, &actual);
+    if ((status != FX_SUCCESS) || (actual != clusters * SECTOR_SIZE) ||
+        (memcmp(read_buffer, data_buffer, clusters * SECTOR_SIZE) != 0))
+        return(FX_IO_ERROR);
+    return(fx_file_close(&my_file));
+}
+
+
+/* Walk the cluster chain of the open file from its start to its end the number of times given.  */
+
+static UINT  file_seek_passes(UINT passes)
+{
+
+UINT        status;
+
+
+    while (passes--)
+    {
+        status =  fx_file_seek(&my_file, 0);
+        if (status != FX_SUCCESS)
+            return(status);
+        status =  fx_file_seek(&my_file, (CHAIN_CLUSTERS - 1) * SECTOR_SIZE);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       errors_detected;
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+ULONG       default_misses;
+ULONG       fat_cache_flushes;
+ULONG       fat_sector_writes;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media FAT cache configure test.........................");
+
+    for (i = 0; i < sizeof(data_buffer); i++)
+    {
+        data_buffer[i] =  (UCHAR)(i / SECTOR_SIZE + i);
+    }
+
+    /* Format a FAT16 media.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The media must be open.  */
+    status =  fx_media_fat_cache_configure(&ram_disk, fat_cache_memory, sizeof(fat_cache_memory), CACHE_WAYS);
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((ram_disk.fx_media_12_bit_FAT == FX_FALSE) && (ram_disk.fx_media_32_bit_FAT == FX_FALSE));
+
+    /* The FAT cache of the media control block is used after open.  */
+    return_if_fail(ram_disk.fx_media_fat_cache_entries == ram_disk.fx_media_fat_cache);
+    return_if_fail(ram_disk.fx_media_fat_cache_size == FX_MAX_FAT_CACHE);
+    return_if_fail(ram_disk.fx_media_fat_cache_ways == FX_FAT_CACHE_DEPTH);
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+
+    /* Check the parameters.  */
+    status =  fx_media_fat_cache_configure(FX_NULL, fat_cache_memory, sizeof(fat_cache_memory), CACHE_WAYS);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_fat_cache_configure(&ram_disk, fat_cache_memory, sizeof(fat_cache_memory), 0);
+    return_if_fail(status == FX_INVALID_OPTION);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* The memory must hold one set.  */
+    status =  fx_media_fat_cache_configure(&ram_disk, fat_cache_memory, 3 * sizeof(FX_FAT_CACHE_ENTRY), 4);
+    return_if_fail(status == FX_NOT_ENOUGH_MEMORY);
+    status =  fx_media_fat_cache_configure(&ram_disk, FX_NULL, 0, FX_MAX_FAT_CACHE + 1);
+    return_if_fail(status == FX_NOT_ENOUGH_MEMORY);
+    return_if_fail(ram_disk.fx_media_fat_cache_entries == ram_disk.fx_media_fat_cache);
+
+    /* Walk a cluster chain longer than the default FAT cache.  */
+    status =  file_chain_create("CHAIN.BIN", CHAIN_CLUSTERS);
+    status += fx_file_open(&ram_disk, &my_file, "CHAIN.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+    default_misses =  ram_disk.fx_media_fat_entry_cache_read_misses;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+    status =  file_seek_passes(SEEK_PASSES);
+    return_if_fail(status == FX_SUCCESS);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+    default_misses =  ram_disk.fx_media_fat_entry_cache_read_misses - default_misses;
+    return_if_fail(default_misses >= SEEK_PASSES * (CHAIN_CLUSTERS / 2));
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+
+    /* Move the FAT cache to memory that is not aligned, with more ways per set.  */
+    status =  fx_media_fat_cache_configure(&ram_disk, ((UCHAR *)fat_cache_memory) + 1, sizeof(fat_cache_memory) - 1, CACHE_WAYS);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_cache_entries == (FX_FAT_CACHE_ENTRY *)&fat_cache_memory[1]);
+    return_if_fail(ram_disk.fx_media_fat_cache_size == CACHE_ENTRIES);
+    return_if_fail(ram_disk.fx_media_fat_cache_ways == CACHE_WAYS);
+    return_if_fail(ram_disk.fx_media_fat_cache_set_mask == (CACHE_ENTRIES / CACHE_WAYS) - 1);
+
+    /* The whole chain stays in the cache once it has been read.  */
+    status =  file_seek_passes(1);
+    return_if_fail(status == FX_SUCCESS);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+    ram_disk.fx_media_fat_entry_cache_read_misses =  0;
+    ram_disk.fx_media_fat_entry_cache_read_hits =    0;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+    status =  file_seek_passes(SEEK_PASSES);
+    return_if_fail(status == FX_SUCCESS);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+    return_if_fail(ram_disk.fx_media_fat_entry_cache_read_misses == 0);
+    return_if_fail(ram_disk.fx_media_fat_entry_cache_read_hits >= SEEK_PASSES * (CHAIN_CLUSTERS - 1));
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Write a file that fits in the configured FAT cache.  */
+    status =  file_write_clusters("FILE1.BIN", WRITE_CLUSTERS);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Return to the FAT cache of the media control block.  */
+    status =  fx_media_fat_cache_configure(&ram_disk, FX_NULL, 0, FX_FAT_CACHE_DEPTH);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_cache_entries == ram_disk.fx_media_fat_cache);
+    return_if_fail(ram_disk.fx_media_fat_cache_size == FX_MAX_FAT_CACHE);
+    return_if_fail(ram_disk.fx_media_fat_cache_set_mask == FX_FAT_CACHE_HASH_MASK);
+
+    /* Replacing dirty entries writes their FAT sector instead of flushing the whole cache.  */
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+    fat_cache_flushes =  ram_disk.fx_media_fat_cache_flushes;
+    fat_sector_writes =  ram_disk.fx_media_fat_sector_writes;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+    status =  file_write_clusters("FILE2.BIN", WRITE_CLUSTERS);
+    return_if_fail(status == FX_SUCCESS);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+    return_if_fail(ram_disk.fx_media_fat_sector_writes > fat_sector_writes);
+    return_if_fail(ram_disk.fx_media_fat_cache_flushes - fat_cache_flushes <= 1);
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+
+    /* Use a single set, then check the media.  */
+    status =  fx_media_fat_cache_configure(&ram_disk, fat_cache_memory, sizeof(fat_cache_memory), CACHE_ENTRIES);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_cache_set_mask == 0);
+    status =  file_write_clusters("FILE3.BIN", WRITE_CLUSTERS);
+    status += fx_file_delete(&ram_disk, "FILE2.BIN");
+    status += file_verify("FILE1.BIN", WRITE_CLUSTERS);
+    status += file_verify("FILE3.BIN", WRITE_CLUSTERS);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_check(&ram_disk, ram_disk_memory + TOTAL_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The files are intact after the media is opened again with the default FAT cache.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_cache_entries == ram_disk.fx_media_fat_cache);
+    status =  file_verify("CHAIN.BIN", CHAIN_CLUSTERS);
+    status += file_verify("FILE1.BIN", WRITE_CLUSTERS);
+    status += file_verify("FILE3.BIN", WRITE_CLUSTERS);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_check(&ram_disk, ram_disk_memory + TOTAL_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_fat_cache_configure_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media FAT cache configure test.........................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,402 @@
+/* This FileX test concentrates on deferring the mirroring of the secondary FATs to a record sector.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_FAT_MIRROR_DEFER
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     CACHE_SECTORS           16
+#define     TOTAL_SECTORS           70000
+#define     IDLE_POLLS              4
+#define     WRITE_CLUSTERS          300
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+static ULONG                   record_sector;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[WRITE_CLUSTERS * SECTOR_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_fat_mirror_defer_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_fat_mirror_defer_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Determine if the secondary FAT on the RAM disk matches the primary FAT.  */
+
+static UINT  fat_mirrored(void)
+{
+
+UCHAR      *primary_ptr;
+
+
+    primary_ptr =  ram_disk_memory + ram_disk.fx_media_reserved_sectors * SECTOR_SIZE;
+    return(memcmp(primary_ptr, primary_ptr + ram_disk.fx_media_sectors_per_FAT * SECTOR_SIZE,
+                  ram_disk.fx_media_sectors_per_FAT * SECTOR_SIZE) == 0);
+}
+
+
+/* Return the number of ranges in the record sector on the RAM disk, or 0xFFFFFFFF if there is no record.  */
+
+static ULONG  record_ranges(void)
+{
+
+UCHAR      *record_ptr;
+
+
+    record_ptr =  ram_disk_memory + record_sector * SECTOR_SIZE;
+    if (_fx_utility_32_unsigned_read(record_ptr) != FX_FAT_MIRROR_RECORD_SIGNATURE)
+        return(0xFFFFFFFF);
+    return(_fx_utility_32_unsigned_read(record_ptr + 4));
+}
+
+
+/* Create a file and write the number of clusters given to it.  */
+
+static UINT  file_write_clusters(CHAR *name, ULONG clusters)
+{
+
+UINT        status;
+
+
+    status =  fx_file_create(&ram_disk, name);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_WRITE);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_write(&my_file, data_buffer, clusters * SECTOR_SIZE);
+    if (status != FX_SUCCESS)
+        return(status);
+    return(fx_file_close(&my_file));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       ranges;
+ULONG       FAT_start;
+ULONG       offset;
+ULONG       cluster;
+ULONG       i;
+ULONG       errors_detected;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media FAT mirror defer test............................");
+
+    for (i = 0; i < sizeof(data_buffer); i++)
+    {
+        data_buffer[i] =  (UCHAR)i;
+    }
+
+    /* Format a FAT32 media with two FATs.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            2,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The media must be open.  */
+    status =  fx_media_fat_mirror_defer(&ram_disk, record_sector, IDLE_POLLS);
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_32_bit_FAT == FX_TRUE);
+    return_if_fail(ram_disk.fx_media_fat_mirror_deferred == FX_FALSE);
+    FAT_start =  ram_disk.fx_media_reserved_sectors;
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+
+    /* Check the parameters.  */
+    status =  fx_media_fat_mirror_defer(FX_NULL, record_sector, IDLE_POLLS);
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* The record sector cannot be a FAT sector or a system sector.  */
+    status =  fx_media_fat_mirror_defer(&ram_disk, FAT_start, IDLE_POLLS);
+    return_if_fail(status == FX_SECTOR_INVALID);
+    status =  fx_media_fat_mirror_defer(&ram_disk, FAT_start + 2 * ram_disk.fx_media_sectors_per_FAT - 1, IDLE_POLLS);
+    return_if_fail(status == FX_SECTOR_INVALID);
+    status =  fx_media_fat_mirror_defer(&ram_disk, ram_disk.fx_media_FAT32_additional_info_sector, IDLE_POLLS);
+    return_if_fail(status == FX_SECTOR_INVALID);
+    status =  fx_media_fat_mirror_defer(&ram_disk, ram_disk.fx_media_total_sectors, IDLE_POLLS);
+    return_if_fail(status == FX_SECTOR_INVALID);
+
+    /* Keep the record in the sector of a file.  */
+    status =  file_write_clusters("RECORD.BIN", 1);
+    status += fx_file_open(&ram_disk, &my_file, "RECORD.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    record_sector =  ram_disk.fx_media_data_sector_start +
+                     (my_file.fx_file_first_physical_cluster - FX_FAT_ENTRY_START) * ram_disk.fx_media_sectors_per_cluster;
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_mirror_deferred == FX_FALSE);
+
+    /* Leave a changed copy of the record sector in the logical sector cache.  */
+    status =  _fx_utility_logical_sector_read(&ram_disk, (ULONG64) record_sector, ram_disk.fx_media_memory_buffer, 1, FX_DIRECTORY_SECTOR);
+    return_if_fail(status == FX_SUCCESS);
+    memset(ram_disk.fx_media_memory_buffer, 0x5A, SECTOR_SIZE);
+    status =  _fx_utility_logical_sector_write(&ram_disk, (ULONG64) record_sector, ram_disk.fx_media_memory_buffer, 1, FX_DIRECTORY_SECTOR);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Defer the mirroring, waiting for the close.  */
+    status =  fx_media_fat_mirror_defer(&ram_disk, record_sector, 0);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_mirror_deferred == FX_TRUE);
+
+    /* A flush writes the primary FAT and the record, but not the secondary FAT.  */
+    status =  file_write_clusters("A.BIN", WRITE_CLUSTERS);
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_FALSE);
+    ranges =  record_ranges();
+    return_if_fail((ranges != 0) && (ranges != 0xFFFFFFFF));
+    return_if_fail(ranges == ram_disk.fx_media_fat_mirror_ranges);
+
+    /* The cached copy neither overwrote the record nor hides it.  */
+    status =  _fx_utility_logical_sector_read(&ram_disk, (ULONG64) record_sector, ram_disk.fx_media_memory_buffer, 1, FX_DIRECTORY_SECTOR);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(memcmp(ram_disk.fx_media_memory_buffer, ram_disk_memory + record_sector * SECTOR_SIZE, SECTOR_SIZE) == 0);
+
+    /* The ranges are whole granules within the FAT.  */
+    for (i = 0; i < ranges; i++)
+    {
+        offset =  _fx_utility_32_unsigned_read(ram_disk_memory + record_sector * SECTOR_SIZE + 8 + i * 8);
+        return_if_fail((offset % FX_FAT_MIRROR_DEFER_GRANULE) == 0);
+        return_if_fail(offset == ram_disk.fx_media_fat_mirror_range_start[i] - FAT_start);
+        offset =  _fx_utility_32_unsigned_read(ram_disk_memory + record_sector * SECTOR_SIZE + 12 + i * 8);
+        return_if_fail(offset <= ram_disk.fx_media_sectors_per_FAT);
+        return_if_fail(offset == ram_disk.fx_media_fat_mirror_range_end[i] - FAT_start);
+    }
+
+    /* Writing FAT entries in the same granules does not write the record again.  */
+    ram_disk_memory[record_sector * SECTOR_SIZE + SECTOR_SIZE - 1] =  0xA5;
+    status =  fx_file_delete(&ram_disk, "A.BIN");
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_mirror_ranges == ranges);
+    return_if_fail(ram_disk_memory[record_sector * SECTOR_SIZE + SECTOR_SIZE - 1] == 0xA5);
+    status =  file_write_clusters("A.BIN", WRITE_CLUSTERS);
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk_memory[record_sector * SECTOR_SIZE + SECTOR_SIZE - 1] == 0xA5);
+
+    /* Writing a FAT entry in a new granule does.  */
+    cluster =  FX_FAT_MIRROR_DEFER_GRANULE * (SECTOR_SIZE / 4) * 3;
+    status =  _fx_utility_FAT_entry_write(&ram_disk, cluster, ram_disk.fx_media_fat_last);
+    status += _fx_utility_FAT_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk_memory[record_sector * SECTOR_SIZE + SECTOR_SIZE - 1] == 0);
+    return_if_fail(ram_disk.fx_media_fat_mirror_ranges == ranges + 1);
+    return_if_fail(record_ranges() == ranges + 1);
+    status =  _fx_utility_FAT_entry_write(&ram_disk, cluster, FX_FREE_CLUSTER);
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    ranges =  ranges + 1;
+
+    /* Invalidating the cache keeps the ranges.  */
+    status =  fx_media_cache_invalidate(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_mirror_ranges == ranges);
+    return_if_fail(fat_mirrored() == FX_FALSE);
+
+    /* Abort the media, as if power was lost.  */
+    status =  fx_media_abort(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(record_ranges() == ranges);
+
+    /* Opening the media does not mirror the FAT.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_FALSE);
+
+    /* Deferring again copies the recorded ranges and clears the record.  */
+    status =  fx_media_fat_mirror_defer(&ram_disk, record_sector, 0);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_TRUE);
+    return_if_fail(record_ranges() == 0);
+    return_if_fail(ram_disk.fx_media_fat_mirror_ranges == 0);
+
+    /* A damaged record makes the whole FAT be copied.  */
+    status =  file_write_clusters("B.BIN", WRITE_CLUSTERS);
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_FALSE);
+    status =  fx_media_abort(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    _fx_utility_32_unsigned_write(ram_disk_memory + record_sector * SECTOR_SIZE + 12, ram_disk.fx_media_sectors_per_FAT + 1);
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    status += fx_media_fat_mirror_defer(&ram_disk, record_sector, IDLE_POLLS);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_TRUE);
+    return_if_fail(record_ranges() == 0);
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+
+    /* The FAT is mirrored once it has not been written for the idle polls.  */
+    status =  fx_file_delete(&ram_disk, "B.BIN");
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_FALSE);
+    return_if_fail(record_ranges() != 0);
+    for (i = 0; i < IDLE_POLLS; i++)
+    {
+        status =  fx_media_writeback_poll(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(fat_mirrored() == FX_TRUE);
+    return_if_fail(record_ranges() == 0);
+#endif /* FX_ENABLE_BACKGROUND_WRITEBACK */
+
+    /* Closing the media mirrors the FAT and clears the record.  */
+    status =  file_write_clusters("C.BIN", WRITE_CLUSTERS);
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(record_ranges() != 0);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_TRUE);
+    return_if_fail(record_ranges() == 0);
+
+    /* Stopping the deferral mirrors the FAT at once.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    status += fx_media_fat_mirror_defer(&ram_disk, record_sector, 0);
+    status += fx_file_delete(&ram_disk, "C.BIN");
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_FALSE);
+    status =  fx_media_fat_mirror_defer(&ram_disk, 0, 0);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_fat_mirror_deferred == FX_FALSE);
+    return_if_fail(fat_mirrored() == FX_TRUE);
+    return_if_fail(record_ranges() == 0);
+
+    /* Each flush mirrors the FAT again.  */
+    status =  file_write_clusters("D.BIN", WRITE_CLUSTERS);
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(fat_mirrored() == FX_TRUE);
+    status =  fx_media_check(&ram_disk, ram_disk_memory + TOTAL_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The record sector cannot be a sector of the FAT16 root directory either.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            2,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            8000,                   // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    status += fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_root_sector_start < ram_disk.fx_media_data_sector_start);
+    status =  fx_media_fat_mirror_defer(&ram_disk, ram_disk.fx_media_root_sector_start, IDLE_POLLS);
+    return_if_fail(status == FX_SECTOR_INVALID);
+    status =  fx_media_fat_mirror_defer(&ram_disk, ram_disk.fx_media_data_sector_start - 1, IDLE_POLLS);
+    return_if_fail(status == FX_SECTOR_INVALID);
+    return_if_fail(ram_disk.fx_media_fat_mirror_deferred == FX_FALSE);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_fat_mirror_defer_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media FAT mirror defer test............................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,275 @@
+/* This FileX test concentrates on counting the free clusters on demand instead of at open.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     FAT16_SECTORS           60000
+#define     FAT32_SECTORS           70000
+#define     CACHE_SECTORS           8
+#define     FILE_CLUSTERS           10
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_lazy_free_count_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_lazy_free_count_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Create a file and write the number of clusters given to it.  */
+
+static UINT  file_write_clusters(CHAR *name, ULONG clusters)
+{
+
+UINT        status;
+
+
+    status =  fx_file_create(&ram_disk, name);
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  fx_file_open(&ram_disk, &my_file, name, FX_OPEN_FOR_WRITE);
+    if (status != FX_SUCCESS)
+        return(status);
+    while (clusters--)
+    {
+        status =  fx_file_write(&my_file, data_buffer, SECTOR_SIZE);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+    return(fx_file_close(&my_file));
+}
+
+
+/* Return the free cluster count recorded in the FAT32 additional information sector.  */
+
+static ULONG  info_sector_free_count(ULONG info_sector)
+{
+
+UCHAR       *byte_ptr;
+
+
+    byte_ptr =  &ram_disk_memory[info_sector * SECTOR_SIZE + 488];
+    return((ULONG)byte_ptr[0] | ((ULONG)byte_ptr[1] << 8) | ((ULONG)byte_ptr[2] << 16) | ((ULONG)byte_ptr[3] << 24));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       available_bytes;
+ULONG       total_clusters;
+ULONG       free_clusters;
+ULONG       info_sector;
+ULONG       errors_detected;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media lazy free cluster count test.....................");
+
+    memset(data_buffer, 0x5A, sizeof(data_buffer));
+
+    /* Format a FAT16 media with a large FAT.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            FAT16_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Opening the media does not read the FAT.  */
+    ram_disk.fx_media_driver_read_requests =  0;
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail((ram_disk.fx_media_12_bit_FAT == FX_FALSE) && (ram_disk.fx_media_32_bit_FAT == FX_FALSE));
+    return_if_fail(ram_disk.fx_media_free_cluster_count_pending == FX_TRUE);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+    return_if_fail(ram_disk.fx_media_driver_read_requests < 4);
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+    total_clusters =  ram_disk.fx_media_total_clusters;
+
+    /* The free clusters are counted when the space available is asked for.  */
+    status =  fx_media_space_available(&ram_disk, &available_bytes);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_free_cluster_count_pending == FX_FALSE);
+    return_if_fail(available_bytes == total_clusters * SECTOR_SIZE);
+
+    /* Use some clusters, then count them again after the media is reopened.  */
+    status =  file_write_clusters("FILE.BIN", FILE_CLUSTERS);
+    status += fx_media_close(&ram_disk);
+    status += fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_free_cluster_count_pending == FX_TRUE);
+    status =  fx_media_space_available(&ram_disk, &available_bytes);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(available_bytes == (total_clusters - FILE_CLUSTERS) * SECTOR_SIZE);
+    return_if_fail(ram_disk.fx_media_cluster_search_start >= FX_FAT_ENTRY_START + FILE_CLUSTERS);
+
+    /* Writing a file counts the free clusters as well.  */
+    status =  fx_media_close(&ram_disk);
+    status += fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    status += file_write_clusters("FILE2.BIN", FILE_CLUSTERS);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_free_cluster_count_pending == FX_FALSE);
+    return_if_fail(ram_disk.fx_media_available_clusters == total_clusters - FILE_CLUSTERS * 2);
+    status =  fx_media_check(&ram_disk, ram_disk_memory + FAT32_SECTORS * SECTOR_SIZE, 200000, 0, &errors_detected);
+    return_if_fail((status == FX_SUCCESS) && (errors_detected == 0));
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Format a FAT32 media.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            FAT32_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The free cluster count of the additional information sector is trusted.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_32_bit_FAT == FX_TRUE);
+    return_if_fail(ram_disk.fx_media_free_cluster_count_pending == FX_FALSE);
+    info_sector =     ram_disk.fx_media_FAT32_additional_info_sector;
+    free_clusters =   ram_disk.fx_media_available_clusters;
+    return_if_fail((info_sector != 0) && (free_clusters == ram_disk.fx_media_total_clusters - 1));
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Mark the count unknown, it is counted on demand and stays unknown until then.  */
+    ram_disk_memory[info_sector * SECTOR_SIZE + 488] =  0xFF;
+    ram_disk_memory[info_sector * SECTOR_SIZE + 489] =  0xFF;
+    ram_disk_memory[info_sector * SECTOR_SIZE + 490] =  0xFF;
+    ram_disk_memory[info_sector * SECTOR_SIZE + 491] =  0xFF;
+    ram_disk.fx_media_driver_read_requests =  0;
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_free_cluster_count_pending == FX_TRUE);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+    return_if_fail(ram_disk.fx_media_driver_read_requests < 4);
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(info_sector_free_count(info_sector) == 0xFFFFFFFF);
+
+    /* Writing a file counts the free clusters, closing records the count.  */
+    status =  file_write_clusters("FILE.BIN", FILE_CLUSTERS);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_free_cluster_count_pending == FX_FALSE);
+    return_if_fail(ram_disk.fx_media_available_clusters == free_clusters - FILE_CLUSTERS);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(info_sector_free_count(info_sector) == free_clusters - FILE_CLUSTERS);
+
+    /* The recorded count is trusted after the media is reopened.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_free_cluster_count_pending == FX_FALSE);
+    return_if_fail(ram_disk.fx_media_available_clusters == free_clusters - FILE_CLUSTERS);
+    status =  fx_media_space_available(&ram_disk, &available_bytes);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(available_bytes == (free_clusters - FILE_CLUSTERS) * SECTOR_SIZE);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_lazy_free_count_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media lazy free cluster count test.....................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -1525,12 +1525,27 @@ ULONG       temp3;
     }
 
     /* Open the media again, but this time introduce an I/O error to cause the FAT read to fail.  */
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* The FAT is not read until the free clusters are counted.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, 128);
+    if (status == FX_SUCCESS)
+    {
+        _fx_ram_driver_io_error_request =  1;
+        status =  fx_media_space_available(&ram_disk, &actual);
+        _fx_ram_driver_io_error_request =  0;
+    }
+
+    /* Check for error.  */
+    if (status != FX_IO_ERROR)
+#else
     _fx_ram_driver_io_error_request =  5;
     status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, 128);
     _fx_ram_driver_io_error_request =  0;
 
     /* Check for error.  */
     if (status != FX_FAT_READ_ERROR)
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
     {
 
         printf("ERROR!\n");
@@ -1565,12 +1580,27 @@ ULONG       temp3;
     }
 
     /* Open the media again, but this time introduce an I/O error to cause the FAT read to fail.  */
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+
+    /* The FAT is not read until the free clusters are counted.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, 128);
+    if (status == FX_SUCCESS)
+    {
+        _fx_ram_driver_io_error_request =  1;
+        status =  fx_media_space_available(&ram_disk, &actual);
+        _fx_ram_driver_io_error_request =  0;
+    }
+
+    /* Check for error.  */
+    if (status != FX_IO_ERROR)
+#else
     _fx_ram_driver_io_error_request =  5;
     status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, 128);
     _fx_ram_driver_io_error_request =  0;
 
     /* Check for error.  */
     if (status != FX_FAT_READ_ERROR)
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
     {
 
         printf("ERROR!\n");
@@ -1741,7 +1771,20 @@ ULONG       temp3;
     status =  fx_media_close(&ram_disk);
 #else
     /* Now attemp to close the media, but with an I/O error introduced so the close will fail trying to write out the directory entry of the open file.  */
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+    /* The free clusters were counted through the sector cache, which leaves no sectors to read on close.  */
+    _fx_ram_driver_io_error_request =  1;
+#else
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+    /* Consecutive dirty sectors are written with one driver request.  */
+    _fx_ram_driver_io_error_request =  16;
+#elif defined(FX_ENABLE_FAT_MIRROR_RANGES)
+    /* Only the written FAT sectors are copied to the secondary FAT.  */
+    _fx_ram_driver_io_error_request =  4;
+#else
     _fx_ram_driver_io_error_request =  17;
+#endif
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
     status =  fx_media_close(&ram_disk);
     _fx_ram_driver_io_error_request =  0;
 #endif
@@ -1854,7 +1897,12 @@ ULONG       temp3;
 #if defined(FX_FAULT_TOLERANT) && !defined(FX_DISABLE_CACHE)
     /* While FX__FAULT_TOLERANT is defined, non data sector will flush directly in _fx_utility_logical_sector_write rather than set dirty flag. */
     /* For this reason, driver won't be called in _fx_utility_logical_sector_flush which is different from non FAULT_TOLERANT code. */
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+    /* The written FAT range is first read directly for the secondary FAT, which flushes it from the cache.  */
+    _fx_utility_logical_sector_flush_error_request = 2;
+#else
     _fx_utility_logical_sector_flush_error_request = 1;    
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
     status =  fx_media_close(&ram_disk);
 #else 
     /* Now attemp to flush the media, but with an I/O error introduced so the close will fail trying to write out the directory entry of the open file.  */
@@ -1975,7 +2023,15 @@ ULONG       temp3;
     status =  fx_media_close(&ram_disk);
 #else
     /* Now attemp to flush the media, but with an I/O error introduced so the close will fail trying to flush logical sectors out.  */
+#ifdef FX_ENABLE_LAZY_FREE_CLUSTER_COUNT
+    /* The free clusters were counted through the sector cache, which leaves no sectors to read on flush.  */
+    _fx_ram_driver_io_error_request =  1;
+#elif defined(FX_ENABLE_FAT_MIRROR_RANGES)
+    /* Only the written FAT sectors are copied to the secondary FAT.  */
+    _fx_ram_driver_io_error_request =  4;
+#else
     _fx_ram_driver_io_error_request =  17;
+#endif /* FX_ENABLE_LAZY_FREE_CLUSTER_COUNT */
     status =  fx_media_flush(&ram_disk);
     _fx_ram_driver_io_error_request =  0;
 #endif
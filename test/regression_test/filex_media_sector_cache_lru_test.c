@@ -0,0 +1,372 @@
+/* This FileX test concentrates on the hashed LRU logical sector cache.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#if defined(FX_ENABLE_LRU_SECTOR_CACHE) && !defined(FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE) && !defined(FX_ENABLE_SECTOR_CACHE_PARTITION)
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     WORKING_SET             600
+#define     FIRST_TEST_SECTOR       1000
+
+/* Large enough for more than FX_MAX_SECTOR_CACHE sector buffers plus their control blocks.  */
+#define     LARGE_CACHE_SIZE        (1024 * (SECTOR_SIZE + 128))
+#define     SMALL_CACHE_SECTORS     4
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   cache_buffer[LARGE_CACHE_SIZE];
+static UCHAR                   sector_buffer[SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE * 8];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_sector_cache_lru_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_sector_cache_lru_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Verify the cached sector list and the hash table of the media.  */
+
+static UINT  cache_check(FX_MEDIA *media_ptr)
+{
+
+FX_CACHED_SECTOR *cache_entry;
+FX_CACHED_SECTOR *previous_entry;
+FX_CACHED_SECTOR *hash_entry;
+ULONG             count;
+
+
+    /* Walk the list from the most recently used entry.  */
+    count =  0;
+    previous_entry =  FX_NULL;
+    cache_entry =  media_ptr -> fx_media_sector_cache_list_ptr;
+    while (cache_entry)
+    {
+
+        /* Each entry must link back to the entry before it.  */
+        if (cache_entry -> fx_cached_sector_previous_used != previous_entry)
+            return(1);
+
+        /* Each entry must be one of the control blocks of the media.  */
+        if ((cache_entry < media_ptr -> fx_media_sector_cache) ||
+            (cache_entry >= media_ptr -> fx_media_sector_cache + media_ptr -> fx_media_sector_cache_size))
+            return(2);
+
+        /* Each valid entry must be found in the hash bucket of its sector.  */
+        if (cache_entry -> fx_cached_sector_valid)
+        {
+            if (cache_entry -> fx_cached_sector_hash_key != cache_entry -> fx_cached_sector)
+                return(3);
+            hash_entry =  media_ptr -> fx_media_sector_cache_hash_table[(ULONG)(cache_entry -> fx_cached_sector & media_ptr -> fx_media_sector_cache_hash_mask)];
+            while ((hash_entry) && (hash_entry != cache_entry))
+                hash_entry =  hash_entry -> fx_cached_sector_hash_next;
+            if (hash_entry == FX_NULL)
+                return(4);
+        }
+
+        count++;
+        if (count > media_ptr -> fx_media_sector_cache_size)
+            return(5);
+
+        previous_entry =  cache_entry;
+        cache_entry =  cache_entry -> fx_cached_sector_next_used;
+    }
+
+    /* All entries must be in the list and the tail must be the last one.  */
+    if ((count != media_ptr -> fx_media_sector_cache_size) ||
+        (media_ptr -> fx_media_sector_cache_list_tail != previous_entry))
+        return(6);
+
+    return(FX_SUCCESS);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       i, j;
+ULONG       read_requests;
+ULONG       write_requests;
+ULONG       read_hits;
+UCHAR      *control_start;
+UCHAR      *control_end;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media sector cache LRU test............................");
+
+    /* Format the media.  This needs to be done before opening it!  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            LARGE_CACHE_SIZE,       // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Open the ram_disk with a buffer larger than FX_MAX_SECTOR_CACHE sectors.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, LARGE_CACHE_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The cache is not limited by FX_MAX_SECTOR_CACHE.  */
+    return_if_fail(ram_disk.fx_media_sector_cache_size > FX_MAX_SECTOR_CACHE);
+    return_if_fail(ram_disk.fx_media_sector_cache_size <= LARGE_CACHE_SIZE / SECTOR_SIZE);
+    return_if_fail(ram_disk.fx_media_sector_cache_size > WORKING_SET);
+    return_if_fail(ram_disk.fx_media_sector_cache != ram_disk.fx_media_sector_cache_built_in);
+
+    /* The control blocks and hash buckets must follow the sector buffers inside the supplied memory.  */
+    control_start =  (UCHAR *)ram_disk.fx_media_sector_cache;
+    control_end =  (UCHAR *)&ram_disk.fx_media_sector_cache_hash_table[ram_disk.fx_media_sector_cache_hash_mask + 1];
+    return_if_fail(ram_disk.fx_media_sector_cache_end == &cache_buffer[ram_disk.fx_media_sector_cache_size * SECTOR_SIZE - 1]);
+    return_if_fail(control_start > ram_disk.fx_media_sector_cache_end);
+    return_if_fail(control_end <= &cache_buffer[LARGE_CACHE_SIZE]);
+    return_if_fail(ram_disk.fx_media_sector_cache_hash_mask + 1 >= ram_disk.fx_media_sector_cache_size);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* Fill the working set with a known pattern.  */
+    for (i = 0; i < WORKING_SET; i++)
+    {
+        for (j = 0; j < SECTOR_SIZE; j++)
+            sector_buffer[j] =  (UCHAR)(i + j);
+        status =  fx_media_write(&ram_disk, FIRST_TEST_SECTOR + i, sector_buffer);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    /* Read the working set twice. The first pass fills the cache.  */
+    for (i = 0; i < WORKING_SET; i++)
+    {
+        status =  fx_media_read(&ram_disk, FIRST_TEST_SECTOR + i, sector_buffer);
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail(sector_buffer[0] == (UCHAR)i);
+    }
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* The second pass must be served entirely from the cache. With the cache limited to
+       FX_MAX_SECTOR_CACHE sectors, every sector of this pass would be a miss.  */
+    read_requests =  ram_disk.fx_media_driver_read_requests;
+    read_hits =  ram_disk.fx_media_logical_sector_cache_read_hits;
+    for (i = 0; i < WORKING_SET; i++)
+    {
+        status =  fx_media_read(&ram_disk, FIRST_TEST_SECTOR + i, sector_buffer);
+        return_if_fail(status == FX_SUCCESS);
+        for (j = 0; j < SECTOR_SIZE; j++)
+            return_if_fail(sector_buffer[j] == (UCHAR)(i + j));
+    }
+    return_if_fail(ram_disk.fx_media_driver_read_requests == read_requests);
+    return_if_fail(ram_disk.fx_media_logical_sector_cache_read_hits - read_hits == WORKING_SET);
+
+    /* Overwrite one sector directly, the cached copy must not be returned afterwards.  */
+    for (j = 0; j < SECTOR_SIZE; j++)
+        sector_buffer[j] =  0xA5;
+    status =  fx_media_write(&ram_disk, FIRST_TEST_SECTOR + 10, sector_buffer);
+    return_if_fail(status == FX_SUCCESS);
+    sector_buffer[0] =  0;
+    status =  fx_media_read(&ram_disk, FIRST_TEST_SECTOR + 10, sector_buffer);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(sector_buffer[0] == 0xA5);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* Create and write a file so that FAT and directory sectors become dirty in the cache.  */
+    status =  fx_file_create(&ram_disk, "TEST.TXT");
+    status += fx_file_open(&ram_disk, &my_file, "TEST.TXT", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < 64; i++)
+    {
+        for (j = 0; j < sizeof(data_buffer); j++)
+            data_buffer[j] =  (UCHAR)(i ^ j);
+        status =  fx_file_write(&my_file, data_buffer, sizeof(data_buffer));
+        return_if_fail(status == FX_SUCCESS);
+    }
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* Flush the media, all dirty sectors must be written out.  */
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* Invalidate the whole cache.  */
+    status =  fx_media_cache_invalidate(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < ram_disk.fx_media_sector_cache_size; i++)
+        return_if_fail(ram_disk.fx_media_sector_cache[i].fx_cached_sector_valid == FX_FALSE);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Open the media with a buffer slightly larger than FX_MAX_SECTOR_CACHE sectors. The built-in
+       control blocks hold more sectors than fit once control blocks come from the buffer.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, (FX_MAX_SECTOR_CACHE + 1) * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_size == FX_MAX_SECTOR_CACHE);
+    return_if_fail(ram_disk.fx_media_sector_cache == ram_disk.fx_media_sector_cache_built_in);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* Read the file back and verify its content.  */
+    status =  fx_file_open(&ram_disk, &my_file, "TEST.TXT", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < 64; i++)
+    {
+        status =  fx_file_read(&my_file, data_buffer, sizeof(data_buffer), &actual);
+        return_if_fail((status == FX_SUCCESS) && (actual == sizeof(data_buffer)));
+        for (j = 0; j < sizeof(data_buffer); j++)
+            return_if_fail(data_buffer[j] == (UCHAR)(i ^ j));
+    }
+    status =  fx_file_close(&my_file);
+    status += fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Open the media with a small cache to verify the replacement order.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, SMALL_CACHE_SECTORS * SECTOR_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_size == SMALL_CACHE_SECTORS);
+
+    /* Fill the cache with the sectors 0 to 3 of the working set. Direct media reads bypass such a
+       small cache, so read through the internal buffer like the FAT and directory logic does.  */
+    for (i = 0; i < SMALL_CACHE_SECTORS; i++)
+    {
+        status =  _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR + i, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    /* Touch sector 0 so that sector 1 becomes the least recently used one.  */
+    read_requests =  ram_disk.fx_media_driver_read_requests;
+    status =  _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_driver_read_requests == read_requests));
+
+    /* Reading sector 4 replaces sector 1.  */
+    status =  _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR + 4, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_driver_read_requests == read_requests + 1));
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* Sectors 0, 2 and 3 are still cached.  */
+    status =  _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    status += _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR + 2, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    status += _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR + 3, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_driver_read_requests == read_requests + 1));
+
+    /* Sector 1 is not.  */
+    status =  _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR + 1, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_driver_read_requests == read_requests + 2));
+    return_if_fail(ram_disk.fx_media_memory_buffer[0] == 1);
+
+    /* Dirty a cached sector through the internal buffer and make sure it is written when replaced.  */
+    write_requests =  ram_disk.fx_media_driver_write_requests;
+    status =  _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR + 20, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail(status == FX_SUCCESS);
+    ram_disk.fx_media_memory_buffer[0] =  0x5A;
+    status =  _fx_utility_logical_sector_write(&ram_disk, FIRST_TEST_SECTOR + 20, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 1);
+    for (i = 0; i < SMALL_CACHE_SECTORS; i++)
+    {
+        status =  _fx_utility_logical_sector_read(&ram_disk, FIRST_TEST_SECTOR + 30 + i, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    return_if_fail(ram_disk.fx_media_driver_write_requests == write_requests + 1);
+    status =  fx_media_read(&ram_disk, FIRST_TEST_SECTOR + 20, sector_buffer);
+    return_if_fail((status == FX_SUCCESS) && (sector_buffer[0] == 0x5A));
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_sector_cache_lru_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media sector cache LRU test............................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,389 @@
+/* This FileX test concentrates on the scan resistant logical sector cache policy.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_SCAN_RESISTANT_SECTOR_CACHE
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     CACHE_SECTORS           64
+#define     SMALL_FILES             20
+#define     LARGE_FILE_SECTORS      1200
+#define     READ_CHUNK              100
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE];
+static CHAR                    file_name[16];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_sector_cache_scan_resistant_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_sector_cache_scan_resistant_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Verify the cached sector list and the probationary queue of the media.  */
+
+static UINT  cache_check(FX_MEDIA *media_ptr)
+{
+
+FX_CACHED_SECTOR *cache_entry;
+FX_CACHED_SECTOR *previous_entry;
+ULONG             count;
+ULONG             probation_count;
+
+
+    /* Walk the list from the most recently used entry.  */
+    count =  0;
+    previous_entry =  FX_NULL;
+    cache_entry =  media_ptr -> fx_media_sector_cache_list_ptr;
+    while (cache_entry)
+    {
+        if ((cache_entry -> fx_cached_sector_previous_used != previous_entry) ||
+            (cache_entry -> fx_cached_sector_probation))
+            return(1);
+        count++;
+        if (count > media_ptr -> fx_media_sector_cache_size)
+            return(2);
+        previous_entry =  cache_entry;
+        cache_entry =  cache_entry -> fx_cached_sector_next_used;
+    }
+    if ((count == 0) || (media_ptr -> fx_media_sector_cache_list_tail != previous_entry))
+        return(3);
+
+    /* Walk the probationary queue from the most recently cached data sector.  */
+    probation_count =  0;
+    previous_entry =  FX_NULL;
+    cache_entry =  media_ptr -> fx_media_sector_cache_probation_ptr;
+    while (cache_entry)
+    {
+        if ((cache_entry -> fx_cached_sector_previous_used != previous_entry) ||
+            (cache_entry -> fx_cached_sector_probation == FX_FALSE) ||
+            (cache_entry -> fx_cached_sector_type != FX_DATA_SECTOR))
+            return(4);
+        probation_count++;
+        if (probation_count > media_ptr -> fx_media_sector_cache_size)
+            return(5);
+        previous_entry =  cache_entry;
+        cache_entry =  cache_entry -> fx_cached_sector_next_used;
+    }
+    if (media_ptr -> fx_media_sector_cache_probation_tail != previous_entry)
+        return(6);
+
+    /* Every entry must be on exactly one of them and the queue must not exceed its limit.  */
+    if ((probation_count != media_ptr -> fx_media_sector_cache_probation_count) ||
+        (probation_count > media_ptr -> fx_media_sector_cache_probation_limit) ||
+        (count + probation_count != media_ptr -> fx_media_sector_cache_size))
+        return(7);
+
+    return(FX_SUCCESS);
+}
+
+
+/* Open, read and close all small files, which mostly accesses directory and FAT sectors.  */
+
+static UINT  small_files_access(void)
+{
+
+UINT        status;
+ULONG       actual;
+UINT        i;
+
+
+    for (i = 0; i < SMALL_FILES; i++)
+    {
+        sprintf(file_name, "FILE%02u.TXT", i);
+        status =  fx_file_open(&ram_disk, &my_file, file_name, FX_OPEN_FOR_READ);
+        if (status != FX_SUCCESS)
+            return(status);
+        status =  fx_file_read(&my_file, data_buffer, 10, &actual);
+        if ((status != FX_SUCCESS) || (actual != 10) || (data_buffer[0] != (UCHAR)i))
+            return(FX_IO_ERROR);
+        status =  fx_file_close(&my_file);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+
+    return(FX_SUCCESS);
+}
+
+
+/* Read the large file in small pieces and verify its content.  */
+
+static UINT  large_file_stream(void)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       offset;
+ULONG       i;
+
+
+    status =  fx_file_open(&ram_disk, &my_file, "VIDEO.BIN", FX_OPEN_FOR_READ);
+    if (status != FX_SUCCESS)
+        return(status);
+    for (offset = 0; offset < LARGE_FILE_SECTORS * SECTOR_SIZE; offset += actual)
+    {
+        status =  fx_file_read(&my_file, data_buffer, READ_CHUNK, &actual);
+        if ((status != FX_SUCCESS) || (actual == 0))
+            return(FX_IO_ERROR);
+        for (i = 0; i < actual; i++)
+        {
+            if (data_buffer[i] != (UCHAR)((offset + i) / SECTOR_SIZE))
+                return(FX_IO_ERROR);
+        }
+    }
+
+    return(fx_file_close(&my_file));
+}
+
+
+/* Warm up the metadata, stream the large file and return the metadata misses caused by the
+   second pass over the small files.  */
+
+static UINT  metadata_misses_after_stream(ULONG *misses, ULONG *hits)
+{
+
+UINT        status;
+ULONG       start_misses;
+ULONG       start_hits;
+
+
+    status =  small_files_access();
+    if (status != FX_SUCCESS)
+        return(status);
+    status =  large_file_stream();
+    if (status != FX_SUCCESS)
+        return(status);
+    if (cache_check(&ram_disk) != FX_SUCCESS)
+        return(FX_IO_ERROR);
+
+    start_misses =  ram_disk.fx_media_logical_sector_cache_metadata_read_misses;
+    start_hits =  ram_disk.fx_media_logical_sector_cache_metadata_read_hits;
+    status =  small_files_access();
+    *misses =  ram_disk.fx_media_logical_sector_cache_metadata_read_misses - start_misses;
+    *hits =  ram_disk.fx_media_logical_sector_cache_metadata_read_hits - start_hits;
+    return(status);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       actual;
+ULONG       i;
+ULONG       lru_misses;
+ULONG       lru_hits;
+ULONG       misses;
+ULONG       hits;
+ULONG       read_requests;
+FX_CACHED_SECTOR
+           *cache_entry;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media sector cache scan resistant test.................");
+
+    /* Format the media.  This needs to be done before opening it!  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            256,                    // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_size == CACHE_SECTORS);
+    return_if_fail(ram_disk.fx_media_sector_cache_probation_limit == (CACHE_SECTORS >> FX_SECTOR_CACHE_PROBATION_SHIFT));
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* Create the small files.  */
+    for (i = 0; i < SMALL_FILES; i++)
+    {
+        sprintf(file_name, "FILE%02u.TXT", (UINT)i);
+        memset(data_buffer, (UCHAR)i, sizeof(data_buffer));
+        status =  fx_file_create(&ram_disk, file_name);
+        status += fx_file_open(&ram_disk, &my_file, file_name, FX_OPEN_FOR_WRITE);
+        status += fx_file_write(&my_file, data_buffer, 64);
+        status += fx_file_close(&my_file);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    /* Create the large file, each sector is filled with its sector number.  */
+    status =  fx_file_create(&ram_disk, "VIDEO.BIN");
+    status += fx_file_open(&ram_disk, &my_file, "VIDEO.BIN", FX_OPEN_FOR_WRITE);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < LARGE_FILE_SECTORS; i++)
+    {
+        memset(data_buffer, (UCHAR)i, sizeof(data_buffer));
+        status =  fx_file_write(&my_file, data_buffer, sizeof(data_buffer));
+        return_if_fail(status == FX_SUCCESS);
+    }
+    status =  fx_file_close(&my_file);
+    status += fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Measure the metadata hit rate without probation by disabling the probationary queue.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    ram_disk.fx_media_sector_cache_probation_limit =  0;
+    status =  metadata_misses_after_stream(&lru_misses, &lru_hits);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_probation_count == 0);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The stream pushed the directory and FAT sectors out of the cache.  */
+    return_if_fail(lru_misses > 0);
+
+    /* Measure again with the probationary queue.  */
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    status =  metadata_misses_after_stream(&misses, &hits);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* All metadata sectors survived the stream.  */
+    return_if_fail(misses == 0);
+    return_if_fail((hits > 0) && (lru_hits < hits));
+
+    /* Repeated references to the most recently cached data sector do not promote it.  */
+    status =  _fx_utility_logical_sector_read(&ram_disk, 3000, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail(status == FX_SUCCESS);
+    cache_entry =  ram_disk.fx_media_sector_cache_probation_ptr;
+    return_if_fail((cache_entry != FX_NULL) && (cache_entry -> fx_cached_sector == 3000));
+    read_requests =  ram_disk.fx_media_driver_read_requests;
+    status =  _fx_utility_logical_sector_read(&ram_disk, 3000, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_driver_read_requests == read_requests));
+    return_if_fail(cache_entry -> fx_cached_sector_probation == FX_TRUE);
+
+    /* A data sector that is referenced again later is promoted to the list.  */
+    status =  _fx_utility_logical_sector_read(&ram_disk, 3001, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    status += _fx_utility_logical_sector_read(&ram_disk, 3000, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+    return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_driver_read_requests == read_requests + 1));
+    return_if_fail(cache_entry -> fx_cached_sector_probation == FX_FALSE);
+    return_if_fail(ram_disk.fx_media_sector_cache_list_ptr == cache_entry);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* Flush with invalidation keeps the lists intact and the media readable.  */
+    status =  fx_media_cache_invalidate(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+    status =  large_file_stream();
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(cache_check(&ram_disk) == FX_SUCCESS);
+
+    /* The written data must be readable through the cache after write back.  */
+    status =  fx_file_open(&ram_disk, &my_file, "FILE00.TXT", FX_OPEN_FOR_WRITE);
+    status += fx_file_seek(&my_file, 64);
+    memset(data_buffer, 0xA5, sizeof(data_buffer));
+    status += fx_file_write(&my_file, data_buffer, 10);
+    status += fx_file_close(&my_file);
+    status += fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_open(&ram_disk, &my_file, "FILE00.TXT", FX_OPEN_FOR_READ);
+    status += fx_file_read(&my_file, data_buffer, sizeof(data_buffer), &actual);
+    status += fx_file_close(&my_file);
+    return_if_fail((status == FX_SUCCESS) && (actual == 74) && (data_buffer[0] == 0) && (data_buffer[64] == 0xA5));
+
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_sector_cache_scan_resistant_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media sector cache scan resistant test.................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,294 @@
+/* This FileX test concentrates on the coalesced flush of the logical sector cache.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_COALESCED_SECTOR_FLUSH
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           4096
+#define     CACHE_SECTORS           64
+#define     RUNS                    3
+#define     RUN_SECTORS             16
+#define     RUN_START(r)            (2000 + ((r) * 100))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+
+
+/* Define the counters used in the test application...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static UCHAR                  *ram_disk_memory;
+#endif
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_sector_flush_coalesce_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_sector_flush_coalesce_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    pointer =  pointer + DEMO_STACK_SIZE;
+
+    /* Setup memory for the RAM disk.  */
+    ram_disk_memory =  pointer;
+
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Read every sector of the runs into the cache in descending order and modify it, so the
+   sectors are dirty and their cache buffers are not in logical sector order.  */
+
+static UINT  runs_dirty(UCHAR pattern)
+{
+
+UINT        status;
+ULONG       r;
+ULONG       i;
+ULONG64     logical_sector;
+
+
+    for (r = RUNS; r > 0; r--)
+    {
+        for (i = RUN_SECTORS; i > 0; i--)
+        {
+            logical_sector =  RUN_START(r - 1) + i - 1;
+            status =  _fx_utility_logical_sector_read(&ram_disk, logical_sector, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+            if (status != FX_SUCCESS)
+                return(status);
+            memset(ram_disk.fx_media_memory_buffer, (UCHAR)(pattern + logical_sector), SECTOR_SIZE);
+            status =  _fx_utility_logical_sector_write(&ram_disk, logical_sector, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+            if (status != FX_SUCCESS)
+                return(status);
+        }
+    }
+
+    /* All sectors of the runs must be dirty in the cache.  */
+    if (ram_disk.fx_media_sector_cache_dirty_count != RUNS * RUN_SECTORS)
+        return(FX_IO_ERROR);
+
+    return(FX_SUCCESS);
+}
+
+
+/* Read the runs back from the media and verify their content.  */
+
+static UINT  runs_check(UCHAR pattern)
+{
+
+UINT        status;
+ULONG       r;
+ULONG       i;
+ULONG64     logical_sector;
+
+
+    /* Make sure the sectors are read from the media.  */
+    status =  fx_media_cache_invalidate(&ram_disk);
+    if (status != FX_SUCCESS)
+        return(status);
+
+    for (r = 0; r < RUNS; r++)
+    {
+        for (i = 0; i < RUN_SECTORS; i++)
+        {
+            logical_sector =  RUN_START(r) + i;
+            status =  fx_media_read(&ram_disk, (ULONG)logical_sector, data_buffer);
+            if ((status != FX_SUCCESS) ||
+                (data_buffer[0] != (UCHAR)(pattern + logical_sector)) ||
+                (data_buffer[SECTOR_SIZE - 1] != (UCHAR)(pattern + logical_sector)))
+                return(FX_IO_ERROR);
+        }
+    }
+
+    return(FX_SUCCESS);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       r;
+ULONG       i;
+ULONG       write_requests;
+ULONG       single_requests;
+ULONG       coalesced_requests;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media sector flush coalesce test.......................");
+
+    /* Format the media.  This needs to be done before opening it!  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            ram_disk_memory,        // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            256,                    // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_cache_invalidate(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Before: flushing the dirty sectors one by one takes one driver request per sector.  */
+    status =  runs_dirty(0x10);
+    return_if_fail(status == FX_SUCCESS);
+    write_requests =  ram_disk.fx_media_driver_write_requests;
+    for (r = 0; r < RUNS; r++)
+    {
+        for (i = 0; i < RUN_SECTORS; i++)
+        {
+            status =  _fx_utility_logical_sector_flush(&ram_disk, RUN_START(r) + i, 1, FX_FALSE);
+            return_if_fail(status == FX_SUCCESS);
+        }
+    }
+    single_requests =  ram_disk.fx_media_driver_write_requests - write_requests;
+    return_if_fail(single_requests == RUNS * RUN_SECTORS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    status =  runs_check(0x10);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* After: a media flush writes each run with at most one request per bounce buffer.  */
+    status =  runs_dirty(0x20);
+    return_if_fail(status == FX_SUCCESS);
+    write_requests =  ram_disk.fx_media_driver_write_requests;
+    status =  fx_media_flush(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    coalesced_requests =  ram_disk.fx_media_driver_write_requests - write_requests;
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    return_if_fail(coalesced_requests >= RUNS);
+    return_if_fail(coalesced_requests <= RUNS * ((RUN_SECTORS * SECTOR_SIZE + FX_SECTOR_FLUSH_BUFFER_SIZE - 1) / FX_SECTOR_FLUSH_BUFFER_SIZE));
+    return_if_fail(coalesced_requests < single_requests);
+    status =  runs_check(0x20);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Flush a range that covers part of one run only.  */
+    status =  runs_dirty(0x30);
+    return_if_fail(status == FX_SUCCESS);
+    write_requests =  ram_disk.fx_media_driver_write_requests;
+    status =  _fx_utility_logical_sector_flush(&ram_disk, RUN_START(1) + 4, 8, FX_FALSE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_driver_write_requests - write_requests <= (8 * SECTOR_SIZE + FX_SECTOR_FLUSH_BUFFER_SIZE - 1) / FX_SECTOR_FLUSH_BUFFER_SIZE + 1);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == (RUNS * RUN_SECTORS) - 8);
+
+    /* Nothing is written while the media is write protected.  */
+    ram_disk.fx_media_driver_write_protect =  FX_TRUE;
+    write_requests =  ram_disk.fx_media_driver_write_requests;
+    status =  _fx_utility_logical_sector_flush(&ram_disk, 1, ram_disk.fx_media_total_sectors, FX_FALSE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_driver_write_requests == write_requests);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == (RUNS * RUN_SECTORS) - 8);
+    ram_disk.fx_media_driver_write_protect =  FX_FALSE;
+
+    /* Flush and invalidate the rest.  */
+    status =  _fx_utility_logical_sector_flush(&ram_disk, 1, ram_disk.fx_media_total_sectors, FX_TRUE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_driver_write_requests - write_requests < (RUNS * RUN_SECTORS) - 8);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    status =  runs_check(0x30);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Dirty more sectors than fit into one batch and flush them.  */
+    for (i = 0; i < CACHE_SECTORS - 8; i++)
+    {
+        status =  _fx_utility_logical_sector_read(&ram_disk, 3000 + i, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+        return_if_fail(status == FX_SUCCESS);
+        memset(ram_disk.fx_media_memory_buffer, (UCHAR)i, SECTOR_SIZE);
+        status =  _fx_utility_logical_sector_write(&ram_disk, 3000 + i, ram_disk.fx_media_memory_buffer, 1, FX_DATA_SECTOR);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == CACHE_SECTORS - 8);
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < CACHE_SECTORS - 8; i++)
+    {
+        status =  fx_media_read(&ram_disk, 3000 + i, data_buffer);
+        return_if_fail((status == FX_SUCCESS) && (data_buffer[0] == (UCHAR)i));
+    }
+
+    status =  fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_sector_flush_coalesce_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media sector flush coalesce test.......................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,329 @@
+/* This FileX test concentrates on the background writeback of dirty sectors.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+void  test_control_return(UINT status);
+
+#ifdef FX_ENABLE_BACKGROUND_WRITEBACK
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     TOTAL_SECTORS           512
+#define     CACHE_SECTORS           32
+#define     CHUNK_SIZE              128
+#define     MAX_AGE                 3
+#define     HIGH_WATER_PERCENT      50
+#define     FILE_SIZE               (4 * SECTOR_SIZE)
+#define     BURST_SIZE              (10 * SECTOR_SIZE)
+#define     PATTERN(o)              ((UCHAR)(((o) / SECTOR_SIZE) ^ ((o) % 251)))
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   disk_memory[TOTAL_SECTORS * SECTOR_SIZE];
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[BURST_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_media_writeback_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_writeback_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Write the test pattern to the open file in small chunks, so every sector goes through the cache.  */
+
+static UINT  file_fill(ULONG start, ULONG size)
+{
+
+UINT        status;
+ULONG       offset;
+ULONG       i;
+
+
+    for (offset = start; offset < start + size; offset += CHUNK_SIZE)
+    {
+        for (i = 0; i < CHUNK_SIZE; i++)
+        {
+            data_buffer[i] =  PATTERN(offset + i);
+        }
+        status =  fx_file_write(&my_file, data_buffer, CHUNK_SIZE);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Return the number of dirty sectors that became dirty before the given writeback clock value.  */
+
+static ULONG  dirty_older_count(ULONG clock)
+{
+
+ULONG       count;
+ULONG       i;
+
+
+    count =  0;
+    for (i = 0; i < ram_disk.fx_media_sector_cache_size; i++)
+    {
+        if ((ram_disk.fx_media_sector_cache[i].fx_cached_sector_valid) &&
+            (ram_disk.fx_media_sector_cache[i].fx_cached_sector_buffer_dirty) &&
+            (ram_disk.fx_media_sector_cache[i].fx_cached_sector_dirty_time != clock))
+        {
+            count++;
+        }
+    }
+    return(count);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+ULONG       i;
+ULONG       actual;
+ULONG       dirty;
+ULONG       writes;
+ULONG       clock;
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media writeback test...................................");
+
+#ifndef FX_DISABLE_ERROR_CHECKING
+    status =  fx_media_writeback_set(FX_NULL, MAX_AGE, HIGH_WATER_PERCENT);
+    return_if_fail(status == FX_PTR_ERROR);
+    status =  fx_media_writeback_set(&ram_disk, MAX_AGE, 101);
+    return_if_fail(status == FX_INVALID_OPTION);
+    status =  fx_media_writeback_poll(FX_NULL);
+    return_if_fail(status == FX_PTR_ERROR);
+#endif /* FX_DISABLE_ERROR_CHECKING */
+
+    /* The media must be open.  */
+    status =  fx_media_writeback_set(&ram_disk, MAX_AGE, HIGH_WATER_PERCENT);
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+    status =  fx_media_writeback_poll(&ram_disk);
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+
+    /* Format the media.  */
+    status =  fx_media_format(&ram_disk,
+                            _fx_ram_driver,         // Driver entry
+                            disk_memory,            // RAM disk memory pointer
+                            cache_buffer,           // Media buffer pointer
+                            sizeof(cache_buffer),   // Media buffer size
+                            "MY_RAM_DISK",          // Volume Name
+                            1,                      // Number of FATs
+                            32,                     // Directory Entries
+                            0,                      // Hidden sectors
+                            TOTAL_SECTORS,          // Total sectors
+                            SECTOR_SIZE,            // Sector size
+                            1,                      // Sectors per cluster
+                            1,                      // Heads
+                            1);                     // Sectors per track
+    return_if_fail(status == FX_SUCCESS);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, disk_memory, cache_buffer, sizeof(cache_buffer));
+    return_if_fail(status == FX_SUCCESS);
+
+    /* The media starts with the default policy.  */
+    return_if_fail(ram_disk.fx_media_writeback_max_age == FX_WRITEBACK_MAX_AGE);
+    return_if_fail(ram_disk.fx_media_writeback_high_water == FX_WRITEBACK_HIGH_WATER_PERCENT);
+
+    /* Only write out sectors by age.  */
+    status =  fx_media_writeback_set(&ram_disk, MAX_AGE, 0);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Write a few sectors of a new file.  */
+    status =  fx_file_create(&ram_disk, "TEST.BIN");
+    status += fx_file_open(&ram_disk, &my_file, "TEST.BIN", FX_OPEN_FOR_WRITE);
+    status += file_fill(0, FILE_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    dirty =  ram_disk.fx_media_sector_cache_dirty_count;
+    return_if_fail(dirty >= FILE_SIZE / SECTOR_SIZE);
+
+    /* Nothing is written before the changes reach the maximum age.  */
+    writes =  ram_disk.fx_media_driver_write_requests;
+    for (i = 1; i < MAX_AGE; i++)
+    {
+        status =  fx_media_writeback_poll(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == dirty);
+    return_if_fail(ram_disk.fx_media_driver_write_requests == writes);
+
+    /* Now all dirty sectors are written out, the FAT changes are still younger.  */
+    status =  fx_media_writeback_poll(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    return_if_fail(ram_disk.fx_media_driver_write_requests >= writes + (FILE_SIZE / SECTOR_SIZE));
+    return_if_fail(ram_disk.fx_media_writeback_fat_pending == FX_TRUE);
+
+    /* The FAT changes follow one poll later.  */
+    writes =  ram_disk.fx_media_driver_write_requests;
+    status =  fx_media_writeback_poll(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+    return_if_fail(ram_disk.fx_media_driver_write_requests > writes);
+    return_if_fail(ram_disk.fx_media_writeback_fat_pending == FX_FALSE);
+    for (i = 0; i < FX_MAX_FAT_CACHE; i++)
+    {
+        return_if_fail(ram_disk.fx_media_fat_cache[i].fx_fat_cache_entry_dirty == 0);
+    }
+
+    /* Close the file, which changes its directory entry, and let the writeback catch up.  */
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+    for (i = 0; i < MAX_AGE; i++)
+    {
+        status =  fx_media_writeback_poll(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+    }
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == 0);
+
+    /* Everything is on the media, even when the media is not closed.  */
+    status =  fx_media_abort(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, disk_memory, cache_buffer, sizeof(cache_buffer));
+    status += fx_file_open(&ram_disk, &my_file, "TEST.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(my_file.fx_file_current_file_size == FILE_SIZE);
+    status =  fx_file_read(&my_file, data_buffer, FILE_SIZE, &actual);
+    return_if_fail((status == FX_SUCCESS) && (actual == FILE_SIZE));
+    for (i = 0; i < FILE_SIZE; i++)
+    {
+        return_if_fail(data_buffer[i] == PATTERN(i));
+    }
+    status =  fx_file_close(&my_file);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Now only write out sectors when too many are dirty.  */
+    status =  fx_media_writeback_set(&ram_disk, 0, HIGH_WATER_PERCENT);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_file_open(&ram_disk, &my_file, "TEST.BIN", FX_OPEN_FOR_WRITE);
+    status += fx_file_seek(&my_file, FILE_SIZE);
+    status += file_fill(FILE_SIZE, BURST_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+
+    /* Below the high-water mark nothing is written.  */
+    dirty =  ram_disk.fx_media_sector_cache_dirty_count;
+    return_if_fail(dirty < (CACHE_SECTORS * HIGH_WATER_PERCENT) / 100);
+    status =  fx_media_writeback_poll(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count == dirty);
+
+    /* A second burst passes the mark, the older burst is written out first.  */
+    clock =  ram_disk.fx_media_writeback_clock;
+    status =  file_fill(FILE_SIZE + BURST_SIZE, BURST_SIZE);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count >= (CACHE_SECTORS * HIGH_WATER_PERCENT) / 100);
+    status =  fx_media_writeback_poll(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count <= (CACHE_SECTORS * HIGH_WATER_PERCENT) / 200);
+    return_if_fail(ram_disk.fx_media_sector_cache_dirty_count != 0);
+    return_if_fail(dirty_older_count(clock) == 0);
+
+    /* Nothing is written by a poll of a write protected media.  */
+    ram_disk.fx_media_driver_write_protect =  FX_TRUE;
+    status =  fx_media_writeback_poll(&ram_disk);
+    ram_disk.fx_media_driver_write_protect =  FX_FALSE;
+    return_if_fail(status == FX_WRITE_PROTECT);
+
+    /* Close the file and the media, and check the whole file.  */
+    status =  fx_file_close(&my_file);
+    status += fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+    status =  fx_media_writeback_poll(&ram_disk);
+    return_if_fail(status == FX_MEDIA_NOT_OPEN);
+
+    status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, disk_memory, cache_buffer, sizeof(cache_buffer));
+    status += fx_file_open(&ram_disk, &my_file, "TEST.BIN", FX_OPEN_FOR_READ);
+    return_if_fail(status == FX_SUCCESS);
+    return_if_fail(my_file.fx_file_current_file_size == FILE_SIZE + 2 * BURST_SIZE);
+    for (i = 0; i < FILE_SIZE + 2 * BURST_SIZE; i += CHUNK_SIZE)
+    {
+        status =  fx_file_read(&my_file, data_buffer, CHUNK_SIZE, &actual);
+        return_if_fail((status == FX_SUCCESS) && (actual == CHUNK_SIZE));
+        for (actual = 0; actual < CHUNK_SIZE; actual++)
+        {
+            return_if_fail(data_buffer[actual] == PATTERN(i + actual));
+        }
+    }
+    status =  fx_file_close(&my_file);
+    status += fx_media_close(&ram_disk);
+    return_if_fail(status == FX_SUCCESS);
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
+
+#else
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_media_writeback_application_define(void *first_unused_memory)
+#endif
+{
+
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Media writeback test...................................N/A\n");
+
+    test_control_return(255);
+}
+#endif
@@ -0,0 +1,376 @@
+/* This FileX test concentrates on reading runs of consecutive clusters from the FAT.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     CACHE_SECTORS           16
+#define     FAT12_SECTORS           3000
+#define     FAT16_SECTORS           60000
+#define     FAT32_SECTORS           70000
+#define     RUN_CLUSTERS            700
+#define     MAX_CLUSTERS            1024
+#define     DIRECTORY_FILES         100
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 file_a;
+static FX_FILE                 file_b;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[SECTOR_SIZE];
+static UCHAR                   read_buffer[MAX_CLUSTERS * SECTOR_SIZE];
+static ULONG                   chain[MAX_CLUSTERS];
+static ULONG                   fragment_clusters[] = {1, 2, 5, 1, 40, 3, 1, 17, 9, 2, 64, 1, 30, 6};
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+static FX_FILE_EXTENT          extent_memory[32];
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+
+
+/* Define thread prototypes.  */
+
+void    filex_utility_fat_chain_read_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+void  test_control_return(UINT status);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_utility_fat_chain_read_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Write the number of clusters given to a file, each cluster holds its index in the file.  */
+
+static UINT  file_write_clusters(FX_FILE *file_ptr, ULONG clusters)
+{
+
+UINT        status;
+
+
+    while (clusters--)
+    {
+        memset(data_buffer, (UCHAR)(file_ptr -> fx_file_current_file_offset / SECTOR_SIZE), sizeof(data_buffer));
+        status =  fx_file_write(file_ptr, data_buffer, SECTOR_SIZE);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Compare the FAT chain read in runs with the chain read one FAT entry at a time,
+   and return the number of runs.  */
+
+static UINT  chain_check(ULONG cluster, ULONG *runs)
+{
+
+UINT        status;
+ULONG       clusters;
+ULONG       run_clusters;
+ULONG       next_cluster;
+ULONG       i, j;
+
+
+    /* Read the chain one FAT entry at a time.  */
+    clusters =  0;
+    while ((cluster >= FX_FAT_ENTRY_START) && (cluster < ram_disk.fx_media_fat_reserved))
+    {
+        if (clusters == MAX_CLUSTERS)
+            return(FX_FILE_CORRUPT);
+        chain[clusters++] =  cluster;
+        status =  _fx_utility_FAT_entry_read(&ram_disk, cluster, &cluster);
+        if (status != FX_SUCCESS)
+            return(status);
+    }
+
+    /* Read the chain in runs.  */
+    *runs =  0;
+    cluster =  chain[0];
+    for (i = 0; i < clusters; i += run_clusters)
+    {
+        status =  _fx_utility_FAT_chain_read(&ram_disk, cluster, MAX_CLUSTERS, &run_clusters, &next_cluster);
+        if (status != FX_SUCCESS)
+            return(status);
+        if ((run_clusters == 0) || (i + run_clusters > clusters))
+            return(FX_FILE_CORRUPT);
+
+        /* Each run is a part of the chain.  */
+        for (j = 0; j < run_clusters; j++)
+        {
+            if (chain[i + j] != cluster + j)
+                return(FX_FILE_CORRUPT);
+        }
+
+        /* The last FAT entry links the next run or ends the chain.  */
+        if (i + run_clusters < clusters)
+        {
+            if (chain[i + run_clusters] != next_cluster)
+                return(FX_FILE_CORRUPT);
+        }
+        else if (next_cluster < ram_disk.fx_media_fat_reserved)
+        {
+            return(FX_FILE_CORRUPT);
+        }
+        cluster =  next_cluster;
+        (*runs)++;
+    }
+
+    /* A run of one cluster returns the first FAT entry.  */
+    status =  _fx_utility_FAT_chain_read(&ram_disk, chain[0], 1, &run_clusters, &next_cluster);
+    if ((status != FX_SUCCESS) || (run_clusters != 1))
+        return(FX_FILE_CORRUPT);
+    if ((clusters > 1) && (next_cluster != chain[1]))
+        return(FX_FILE_CORRUPT);
+
+    return(FX_SUCCESS);
+}
+
+
+/* Check the data of the file read from the offset given.  */
+
+static UINT  read_check(ULONG offset, ULONG size)
+{
+
+ULONG       i;
+
+
+    for (i = 0; i < size; i++)
+    {
+        if (read_buffer[i] != (UCHAR)((offset + i) / SECTOR_SIZE))
+            return(FX_FILE_CORRUPT);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+UINT        pass;
+ULONG       total_sectors;
+ULONG       file_clusters;
+ULONG       runs;
+ULONG       run_clusters;
+ULONG       next_cluster;
+ULONG       actual;
+ULONG       offset;
+ULONG       entries;
+ULONG       i;
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+ULONG       fat_entry_reads;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+CHAR        name[FX_MAX_LONG_NAME_LEN];
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Utility FAT chain read test............................");
+
+    for (pass = 0; pass < 3; pass++)
+    {
+
+        /* Format a FAT12, FAT16 and FAT32 media.  */
+        total_sectors =  (pass == 0) ? FAT12_SECTORS : ((pass == 1) ? FAT16_SECTORS : FAT32_SECTORS);
+        status =  fx_media_format(&ram_disk,
+                                _fx_ram_driver,         // Driver entry
+                                ram_disk_memory,        // RAM disk memory pointer
+                                cache_buffer,           // Media buffer pointer
+                                sizeof(cache_buffer),   // Media buffer size
+                                "MY_RAM_DISK",          // Volume Name
+                                1,                      // Number of FATs
+                                32,                     // Directory Entries
+                                0,                      // Hidden sectors
+                                total_sectors,          // Total sectors
+                                SECTOR_SIZE,            // Sector size
+                                1,                      // Sectors per cluster
+                                1,                      // Heads
+                                1);                     // Sectors per track
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail((pass != 0) || (ram_disk.fx_media_12_bit_FAT == FX_TRUE));
+        return_if_fail((pass != 2) || (ram_disk.fx_media_32_bit_FAT == FX_TRUE));
+
+        /* Write a fragmented file by interleaving its clusters with the clusters of another file.  */
+        status =  fx_file_create(&ram_disk, "A.BIN");
+        status += fx_file_create(&ram_disk, "B.BIN");
+        status += fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_WRITE);
+        status += fx_file_open(&ram_disk, &file_b, "B.BIN", FX_OPEN_FOR_WRITE);
+        return_if_fail(status == FX_SUCCESS);
+        file_clusters =  0;
+        for (i = 0; i < sizeof(fragment_clusters) / sizeof(ULONG); i++)
+        {
+            status =  file_write_clusters(&file_a, fragment_clusters[i]);
+            status += file_write_clusters(&file_b, 1);
+            return_if_fail(status == FX_SUCCESS);
+            file_clusters += fragment_clusters[i];
+        }
+
+        /* End it with a long run that spans several FAT sectors.  */
+        status =  file_write_clusters(&file_a, RUN_CLUSTERS);
+        return_if_fail(status == FX_SUCCESS);
+        file_clusters += RUN_CLUSTERS;
+
+        /* The runs match the FAT entries while they are still in the FAT entry cache.  */
+        status =  chain_check(file_a.fx_file_first_physical_cluster, &runs);
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail(runs < file_clusters / 8);
+        status =  chain_check(file_b.fx_file_first_physical_cluster, &runs);
+        return_if_fail(status == FX_SUCCESS);
+
+        /* And after they are written to the FAT sectors.  */
+        status =  fx_file_close(&file_a);
+        status += fx_file_close(&file_b);
+        status += fx_media_flush(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_READ);
+#ifdef FX_ENABLE_FILE_EXTENT_MAP
+        status += fx_file_extent_map_set(&file_a, extent_memory, sizeof(extent_memory));
+#endif /* FX_ENABLE_FILE_EXTENT_MAP */
+        return_if_fail(status == FX_SUCCESS);
+        status =  chain_check(file_a.fx_file_first_physical_cluster, &runs);
+        return_if_fail(status == FX_SUCCESS);
+
+        /* An error reading the first FAT entry is returned.  */
+        _fx_utility_fat_entry_read_error_request =  1;
+        status =  _fx_utility_FAT_chain_read(&ram_disk, chain[file_clusters - RUN_CLUSTERS], MAX_CLUSTERS, &run_clusters, &next_cluster);
+        _fx_utility_fat_entry_read_error_request =  0;
+        return_if_fail(status == FX_IO_ERROR);
+
+        /* An error reading a FAT sector is returned, both for the sector of the first FAT entry
+           and for the sector the rest of the run is read from.  */
+        for (i = 1; ; i++)
+        {
+            status =  fx_media_cache_invalidate(&ram_disk);
+            return_if_fail(status == FX_SUCCESS);
+            _fx_utility_logical_sector_read_error_request =  i;
+            status =  _fx_utility_FAT_chain_read(&ram_disk, chain[file_clusters - RUN_CLUSTERS], MAX_CLUSTERS, &run_clusters, &next_cluster);
+            _fx_utility_logical_sector_read_error_request =  0;
+            if (status == FX_SUCCESS)
+                break;
+            return_if_fail(status == FX_IO_ERROR);
+        }
+        return_if_fail((i > 2) && (run_clusters > 1));
+
+        /* Read the whole file at once.  */
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+        fat_entry_reads =  ram_disk.fx_media_fat_entry_reads;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+        status =  fx_file_read(&file_a, read_buffer, file_clusters * SECTOR_SIZE, &actual);
+        return_if_fail((status == FX_SUCCESS) && (actual == file_clusters * SECTOR_SIZE));
+        return_if_fail(read_check(0, actual) == FX_SUCCESS);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+        return_if_fail(ram_disk.fx_media_fat_entry_reads - fat_entry_reads < file_clusters / 8);
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+
+        /* Read the file in pieces smaller than a sector.  */
+        status =  fx_file_seek(&file_a, 0);
+        return_if_fail(status == FX_SUCCESS);
+        for (offset = 0; offset < file_clusters * SECTOR_SIZE; offset += actual)
+        {
+            status =  fx_file_read(&file_a, read_buffer, SECTOR_SIZE / 2 + 3, &actual);
+            return_if_fail((status == FX_SUCCESS) && (actual != 0));
+            return_if_fail(read_check(offset, actual) == FX_SUCCESS);
+        }
+
+        /* Seek backwards through the file.  */
+        for (i = file_clusters; i > 0; i -= 37)
+        {
+            offset =  (i - 1) * SECTOR_SIZE + 7;
+            status =  fx_file_seek(&file_a, offset);
+            status += fx_file_read(&file_a, read_buffer, 1, &actual);
+            return_if_fail((status == FX_SUCCESS) && (actual == 1));
+            return_if_fail(read_check(offset, 1) == FX_SUCCESS);
+            if (i < 37)
+                break;
+        }
+        status =  fx_file_close(&file_a);
+        return_if_fail(status == FX_SUCCESS);
+
+        /* Grow a sub-directory over fragmented clusters.  */
+        status =  fx_directory_create(&ram_disk, "SUB");
+        status += fx_file_open(&ram_disk, &file_b, "B.BIN", FX_OPEN_FOR_WRITE);
+        status += fx_file_seek(&file_b, 0xFFFFFFFF);
+        return_if_fail(status == FX_SUCCESS);
+        for (i = 0; i < DIRECTORY_FILES; i++)
+        {
+            sprintf(name, "SUB/F%03lu.TXT", i);
+            status =  fx_file_create(&ram_disk, name);
+            return_if_fail(status == FX_SUCCESS);
+            if ((i % 8) == 7)
+            {
+                status =  file_write_clusters(&file_b, 1);
+                return_if_fail(status == FX_SUCCESS);
+            }
+        }
+        status =  fx_file_close(&file_b);
+        return_if_fail(status == FX_SUCCESS);
+
+        /* All the entries of the sub-directory are found.  */
+        status =  fx_directory_default_set(&ram_disk, "SUB");
+        status += fx_directory_first_entry_find(&ram_disk, name);
+        return_if_fail(status == FX_SUCCESS);
+        entries =  1;
+        while (fx_directory_next_entry_find(&ram_disk, name) == FX_SUCCESS)
+        {
+            entries++;
+        }
+        return_if_fail(entries == DIRECTORY_FILES + 2);
+        status =  fx_directory_default_set(&ram_disk, "/");
+        return_if_fail(status == FX_SUCCESS);
+
+        status =  fx_media_close(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
@@ -0,0 +1,355 @@
+/* This FileX test concentrates on linking runs of newly allocated clusters in the FAT.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     CACHE_SECTORS           16
+#define     FAT12_SECTORS           3000
+#define     FAT16_SECTORS           60000
+#define     FAT32_SECTORS           70000
+#define     ALLOCATE_CLUSTERS       1500
+#define     WRITE_CLUSTERS          600
+#define     HOLES                   20
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 file_a;
+static FX_FILE                 file_b;
+static FX_FILE                 file_c;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[WRITE_CLUSTERS * SECTOR_SIZE];
+static UCHAR                   read_buffer[WRITE_CLUSTERS * SECTOR_SIZE];
+static UCHAR                   primary_buffer[SECTOR_SIZE];
+static UCHAR                   secondary_buffer[SECTOR_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_utility_fat_chain_write_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+void  test_control_return(UINT status);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_utility_fat_chain_write_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Check that the FAT chain starting at the cluster given has the number of clusters given,
+   and return the number of runs of consecutive clusters in it.  */
+
+static UINT  chain_check(ULONG cluster, ULONG clusters, ULONG *runs)
+{
+
+UINT        status;
+ULONG       next_cluster;
+
+
+    *runs =  1;
+    while (clusters--)
+    {
+        if ((cluster < FX_FAT_ENTRY_START) || (cluster >= ram_disk.fx_media_fat_reserved))
+            return(FX_FILE_CORRUPT);
+        status =  _fx_utility_FAT_entry_read(&ram_disk, cluster, &next_cluster);
+        if (status != FX_SUCCESS)
+            return(status);
+        if ((clusters) && (next_cluster != cluster + 1))
+            (*runs)++;
+        cluster =  next_cluster;
+    }
+
+    /* The chain ends after the last cluster.  */
+    if (cluster < ram_disk.fx_media_fat_reserved)
+        return(FX_FILE_CORRUPT);
+
+    return(FX_SUCCESS);
+}
+
+
+/* Compare the primary FAT with the secondary FAT.  */
+
+static UINT  fat_compare(void)
+{
+
+UINT        status;
+ULONG       sector;
+
+
+    for (sector = 0; sector < ram_disk.fx_media_sectors_per_FAT; sector++)
+    {
+        status =  fx_media_read(&ram_disk, ram_disk.fx_media_reserved_sectors + sector, primary_buffer);
+        status += fx_media_read(&ram_disk, ram_disk.fx_media_reserved_sectors + ram_disk.fx_media_sectors_per_FAT + sector,
+                                secondary_buffer);
+        if (status != FX_SUCCESS)
+            return(FX_IO_ERROR);
+        if (memcmp(primary_buffer, secondary_buffer, SECTOR_SIZE))
+            return(FX_FILE_CORRUPT);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+UINT        pass;
+ULONG       total_sectors;
+ULONG       entries_per_sector;
+ULONG       cluster;
+ULONG       clusters;
+ULONG       next_cluster;
+ULONG       runs;
+ULONG       actual;
+ULONG       i;
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+ULONG       fat_entry_writes;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+CHAR        name[16];
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Utility FAT chain write test...........................");
+
+    for (i = 0; i < sizeof(data_buffer); i++)
+    {
+        data_buffer[i] =  (UCHAR)(i / SECTOR_SIZE + i);
+    }
+
+    for (pass = 0; pass < 3; pass++)
+    {
+
+        /* Format a FAT12, FAT16 and FAT32 media with two FATs.  */
+        total_sectors =  (pass == 0) ? FAT12_SECTORS : ((pass == 1) ? FAT16_SECTORS : FAT32_SECTORS);
+        status =  fx_media_format(&ram_disk,
+                                _fx_ram_driver,         // Driver entry
+                                ram_disk_memory,        // RAM disk memory pointer
+                                cache_buffer,           // Media buffer pointer
+                                sizeof(cache_buffer),   // Media buffer size
+                                "MY_RAM_DISK",          // Volume Name
+                                2,                      // Number of FATs
+                                32,                     // Directory Entries
+                                0,                      // Hidden sectors
+                                total_sectors,          // Total sectors
+                                SECTOR_SIZE,            // Sector size
+                                1,                      // Sectors per cluster
+                                1,                      // Heads
+                                1);                     // Sectors per track
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail((pass != 0) || (ram_disk.fx_media_12_bit_FAT == FX_TRUE));
+        return_if_fail((pass != 2) || (ram_disk.fx_media_32_bit_FAT == FX_TRUE));
+        entries_per_sector =  (pass == 1) ? (SECTOR_SIZE / 2) : (SECTOR_SIZE / 4);
+
+        /* Link runs that start and end inside a FAT sector, fill one FAT sector, and fit in one FAT sector.  */
+        cluster =  ram_disk.fx_media_total_clusters - 5 * entries_per_sector;
+        for (i = 0; i < 3; i++)
+        {
+            clusters =  (i == 0) ? (3 * entries_per_sector + 11) : ((i == 1) ? entries_per_sector : 9);
+            if (i == 1)
+            {
+
+                /* Start the run at the first entry of a FAT sector.  */
+                cluster =  ((cluster / entries_per_sector) + 1) * entries_per_sector;
+            }
+            status =  _fx_utility_FAT_chain_write(&ram_disk, cluster, clusters, ram_disk.fx_media_fat_last);
+            return_if_fail(status == FX_SUCCESS);
+            status =  chain_check(cluster, clusters, &runs);
+            return_if_fail((status == FX_SUCCESS) && (runs == 1));
+
+            /* The entries around the run are still free.  */
+            status =  _fx_utility_FAT_entry_read(&ram_disk, cluster - 1, &next_cluster);
+            return_if_fail((status == FX_SUCCESS) && (next_cluster == FX_FREE_CLUSTER));
+            status =  _fx_utility_FAT_entry_read(&ram_disk, cluster + clusters, &next_cluster);
+            return_if_fail((status == FX_SUCCESS) && (next_cluster == FX_FREE_CLUSTER));
+
+            /* Free the run again.  */
+            for (next_cluster = cluster; next_cluster < cluster + clusters; next_cluster++)
+            {
+                status =  _fx_utility_FAT_entry_write(&ram_disk, next_cluster, FX_FREE_CLUSTER);
+                return_if_fail(status == FX_SUCCESS);
+            }
+            cluster =  cluster + clusters + 1;
+        }
+
+        /* Errors reading and writing the whole FAT sectors of a run, and writing the FAT entries
+           before and after them, are returned.  */
+        for (i = 0; (pass != 0) && (i < 4); i++)
+        {
+            cluster =   ((ram_disk.fx_media_total_clusters / entries_per_sector) - 4) * entries_per_sector + ((i == 3) ? 1 : 0);
+            clusters =  2 * entries_per_sector + 5;
+            if (i == 0)
+                _fx_utility_logical_sector_read_error_request =  1;
+            else if (i == 1)
+                _fx_utility_logical_sector_write_error_request =  1;
+            else
+                _fx_utility_fat_entry_write_error_request =  1;
+            status =  _fx_utility_FAT_chain_write(&ram_disk, cluster, clusters, ram_disk.fx_media_fat_last);
+            _fx_utility_logical_sector_read_error_request =   0;
+            _fx_utility_logical_sector_write_error_request =  0;
+            _fx_utility_fat_entry_write_error_request =       0;
+            return_if_fail(status == FX_IO_ERROR);
+
+            /* Free the clusters that were linked.  */
+            for (next_cluster = cluster; next_cluster < cluster + clusters; next_cluster++)
+            {
+                status =  _fx_utility_FAT_entry_write(&ram_disk, next_cluster, FX_FREE_CLUSTER);
+                return_if_fail(status == FX_SUCCESS);
+            }
+        }
+
+        /* Allocate a large file at once.  */
+        status =  fx_file_create(&ram_disk, "A.BIN");
+        status += fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_WRITE);
+        return_if_fail(status == FX_SUCCESS);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+        fat_entry_writes =  ram_disk.fx_media_fat_entry_writes;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+        status =  fx_file_allocate(&file_a, ALLOCATE_CLUSTERS * SECTOR_SIZE);
+        return_if_fail(status == FX_SUCCESS);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+
+        /* Only the FAT sectors partially used by the file are written one FAT entry at a time.  */
+        return_if_fail((pass == 0) || (ram_disk.fx_media_fat_entry_writes - fat_entry_writes < 2 * entries_per_sector));
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+        status =  chain_check(file_a.fx_file_first_physical_cluster, ALLOCATE_CLUSTERS, &runs);
+        return_if_fail((status == FX_SUCCESS) && (runs == 1));
+
+        status =  fx_file_close(&file_a);
+        return_if_fail(status == FX_SUCCESS);
+
+        /* Leave single free clusters between the clusters of another file.  */
+        status =  fx_file_create(&ram_disk, "C.BIN");
+        status += fx_file_open(&ram_disk, &file_c, "C.BIN", FX_OPEN_FOR_WRITE);
+        return_if_fail(status == FX_SUCCESS);
+        for (i = 0; i < HOLES; i++)
+        {
+            sprintf(name, "H%02lu.BIN", i);
+            status =  fx_file_create(&ram_disk, name);
+            status += fx_file_open(&ram_disk, &file_b, name, FX_OPEN_FOR_WRITE);
+            status += fx_file_write(&file_b, data_buffer, SECTOR_SIZE);
+            status += fx_file_write(&file_c, data_buffer, SECTOR_SIZE);
+            status += fx_file_close(&file_b);
+            return_if_fail(status == FX_SUCCESS);
+        }
+        status =  fx_file_close(&file_c);
+        return_if_fail(status == FX_SUCCESS);
+        for (i = 0; i < HOLES; i++)
+        {
+            sprintf(name, "H%02lu.BIN", i);
+            status =  fx_file_delete(&ram_disk, name);
+            return_if_fail(status == FX_SUCCESS);
+        }
+
+        /* Write a file with one write that fills the holes and continues with a long run.  */
+        status =  fx_file_create(&ram_disk, "B.BIN");
+        status += fx_file_open(&ram_disk, &file_b, "B.BIN", FX_OPEN_FOR_WRITE);
+        status += fx_file_write(&file_b, data_buffer, SECTOR_SIZE / 2);
+        return_if_fail(status == FX_SUCCESS);
+        ram_disk.fx_media_cluster_search_start =  FX_FAT_ENTRY_START;
+        status =  fx_file_write(&file_b, data_buffer + SECTOR_SIZE / 2, sizeof(data_buffer) - SECTOR_SIZE / 2);
+        return_if_fail(status == FX_SUCCESS);
+        status =  chain_check(file_b.fx_file_first_physical_cluster, WRITE_CLUSTERS, &runs);
+#ifndef FX_ENABLE_FILE_DELAYED_ALLOCATION
+        return_if_fail((status == FX_SUCCESS) && (runs > HOLES));
+#else
+        /* The holes are skipped for a run long enough after the first cluster.  */
+        return_if_fail((status == FX_SUCCESS) && (runs <= 2));
+#endif /* FX_ENABLE_FILE_DELAYED_ALLOCATION */
+
+        /* Append to the file in a new run.  */
+        status =  fx_file_write(&file_b, data_buffer, sizeof(data_buffer));
+        return_if_fail(status == FX_SUCCESS);
+        status =  chain_check(file_b.fx_file_first_physical_cluster, 2 * WRITE_CLUSTERS, &runs);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_file_close(&file_b);
+        return_if_fail(status == FX_SUCCESS);
+
+        /* Read the file back.  */
+        status =  fx_file_open(&ram_disk, &file_b, "B.BIN", FX_OPEN_FOR_READ);
+        status += fx_file_read(&file_b, read_buffer, sizeof(read_buffer), &actual);
+        return_if_fail((status == FX_SUCCESS) && (actual == sizeof(read_buffer)));
+        return_if_fail(memcmp(read_buffer, data_buffer, sizeof(data_buffer)) == 0);
+        status =  fx_file_read(&file_b, read_buffer, sizeof(read_buffer), &actual);
+        return_if_fail((status == FX_SUCCESS) && (actual == sizeof(read_buffer)));
+        return_if_fail(memcmp(read_buffer, data_buffer, sizeof(data_buffer)) == 0);
+        status =  fx_file_close(&file_b);
+        return_if_fail(status == FX_SUCCESS);
+
+        /* Both FATs hold the same chains after a flush.  */
+        status =  fx_media_flush(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fat_compare();
+        return_if_fail(status == FX_SUCCESS);
+
+        /* And the chains survive closing and reopening the media.  */
+        status =  fx_media_close(&ram_disk);
+        status += fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+        status += fx_file_open(&ram_disk, &file_a, "A.BIN", FX_OPEN_FOR_READ);
+        return_if_fail(status == FX_SUCCESS);
+        status += fx_file_open(&ram_disk, &file_c, "C.BIN", FX_OPEN_FOR_READ);
+        return_if_fail(status == FX_SUCCESS);
+        status =  chain_check(file_a.fx_file_first_physical_cluster, ALLOCATE_CLUSTERS, &runs);
+        return_if_fail((status == FX_SUCCESS) && (runs == 1));
+        status =  chain_check(file_c.fx_file_first_physical_cluster, HOLES, &runs);
+        return_if_fail((status == FX_SUCCESS) && (runs == HOLES));
+        status =  fx_file_close(&file_a);
+        status += fx_file_close(&file_c);
+        status += fx_media_close(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
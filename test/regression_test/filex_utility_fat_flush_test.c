@@ -210,10 +210,14 @@ ULONG       i;
     
     /* Note: If definition of FX_FAT_MAP_SIZE is changed in future, the value checked in 
        return_value_if_fail will change for individual array element */
+#ifndef FX_ENABLE_FAT_MIRROR_RANGES
     for(i=0;i<FX_FAT_MAP_SIZE;i++)
     {
     	return_value_if_fail((ram_disk.fx_media_fat_secondary_update_map[i]==63),8)
     }   
+#else
+    return_value_if_fail((ram_disk.fx_media_fat_mirror_ranges != 0),8)
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
 
     fx_media_close(&ram_disk);
     
@@ -332,10 +336,14 @@ ULONG       i;
     
     /* Note: If definition of FX_FAT_MAP_SIZE is changed in future, the value checked in 
        return_value_if_fail will change for individual array element */
+#ifndef FX_ENABLE_FAT_MIRROR_RANGES
     for(i=0;i<FX_FAT_MAP_SIZE;i++)
     {
     	return_value_if_fail((ram_disk.fx_media_fat_secondary_update_map[i]==255),8)
     }   
+#else
+    return_value_if_fail((ram_disk.fx_media_fat_mirror_ranges != 0),8)
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
 
     fx_media_close(&ram_disk);
 
@@ -416,10 +424,14 @@ ULONG       i;
     
     /* Note: If definition of FX_FAT_MAP_SIZE is changed in future, the value checked in 
        return_value_if_fail will change for individual array element */
+#ifndef FX_ENABLE_FAT_MIRROR_RANGES
     for(i=0;i<FX_FAT_MAP_SIZE;i++)
     {
     	return_value_if_fail((ram_disk.fx_media_fat_secondary_update_map[i]==65),8)
     }   
+#else
+    return_value_if_fail((ram_disk.fx_media_fat_mirror_ranges != 0),8)
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
     
     fx_media_close(&ram_disk);  
     
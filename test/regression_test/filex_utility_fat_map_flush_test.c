@@ -0,0 +1,349 @@
+/* This FileX test concentrates on mirroring the written primary FAT sectors to the secondary FATs.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include   "tx_api.h"
+#endif
+#include   "fx_api.h"
+#include   "fx_utility.h"
+#include    <stdio.h>
+#include    <string.h>
+#include   "fx_ram_driver_test.h"
+
+#define     DEMO_STACK_SIZE         4096
+#define     SECTOR_SIZE             512
+#define     CACHE_SECTORS           16
+#define     FAT12_SECTORS           3000
+#define     FAT16_SECTORS           60000
+#define     FAT32_SECTORS           70000
+#define     ALLOCATE_CLUSTERS       2000
+
+
+/* Define the ThreadX and FileX object control blocks...  */
+
+#ifndef FX_STANDALONE_ENABLE
+static TX_THREAD               ftest_0;
+#endif
+static FX_MEDIA                ram_disk;
+static FX_FILE                 my_file;
+
+
+/* Define the counters used in the test application...  */
+
+static UCHAR                   cache_buffer[CACHE_SECTORS * SECTOR_SIZE];
+static UCHAR                   data_buffer[4 * SECTOR_SIZE];
+
+
+/* Define thread prototypes.  */
+
+void    filex_utility_fat_map_flush_application_define(void *first_unused_memory);
+static void    ftest_0_entry(ULONG thread_input);
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+void  test_control_return(UINT status);
+
+
+
+/* Define what the initial system looks like.  */
+
+#ifdef CTEST
+void test_application_define(void *first_unused_memory)
+#else
+void    filex_utility_fat_map_flush_application_define(void *first_unused_memory)
+#endif
+{
+
+#ifndef FX_STANDALONE_ENABLE
+UCHAR    *pointer;
+
+
+    /* Setup the working pointer.  */
+    pointer =  (UCHAR *) first_unused_memory;
+
+    /* Create the main thread.  */
+    tx_thread_create(&ftest_0, "thread 0", ftest_0_entry, 0,
+            pointer, DEMO_STACK_SIZE,
+            4, 4, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    FX_PARAMETER_NOT_USED(first_unused_memory);
+#endif
+
+    /* Initialize the FileX system.  */
+    fx_system_initialize();
+#ifdef FX_STANDALONE_ENABLE
+    ftest_0_entry(0);
+#endif
+}
+
+
+/* Compare the primary FAT with each secondary FAT on the RAM disk.  */
+
+static UINT  fat_compare(void)
+{
+
+UINT        status;
+UCHAR      *primary_ptr;
+ULONG       FATs;
+
+
+    /* Write the sectors in the cache to the RAM disk first.  */
+    status =  _fx_utility_logical_sector_flush(&ram_disk, ((ULONG64) 1), (ULONG64) (ram_disk.fx_media_total_sectors), FX_FALSE);
+    if (status != FX_SUCCESS)
+        return(status);
+
+    primary_ptr =  ram_disk_memory + ram_disk.fx_media_reserved_sectors * SECTOR_SIZE;
+    for (FATs = 1; FATs < ram_disk.fx_media_number_of_FATs; FATs++)
+    {
+        if (memcmp(primary_ptr, primary_ptr + FATs * ram_disk.fx_media_sectors_per_FAT * SECTOR_SIZE,
+                   ram_disk.fx_media_sectors_per_FAT * SECTOR_SIZE))
+            return(FX_FILE_CORRUPT);
+    }
+    return(FX_SUCCESS);
+}
+
+
+/* Write the FAT entry cache and the sector cache to the media, without mirroring the FAT.  */
+
+static UINT  fat_write(void)
+{
+
+UINT        status;
+
+
+    status =  _fx_utility_FAT_flush(&ram_disk);
+    if (status != FX_SUCCESS)
+        return(status);
+    return(_fx_utility_logical_sector_flush(&ram_disk, ((ULONG64) 1), (ULONG64) (ram_disk.fx_media_total_sectors), FX_FALSE));
+}
+
+
+/* Define the test threads.  */
+
+static void    ftest_0_entry(ULONG thread_input)
+{
+
+UINT        status;
+UINT        pass;
+ULONG       total_sectors;
+ULONG       entries_per_sector;
+ULONG       cluster;
+ULONG       actual;
+ULONG       i;
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+ULONG       FAT_start;
+ULONG       sectors;
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+ULONG       driver_write_requests;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    /* Print out some test information banners.  */
+    printf("FileX Test:   Utility FAT map flush test.............................");
+
+    for (i = 0; i < sizeof(data_buffer); i++)
+    {
+        data_buffer[i] =  (UCHAR)i;
+    }
+
+    for (pass = 0; pass < 3; pass++)
+    {
+
+        /* Format a FAT12 media with two FATs, a FAT16 media with three FATs and a FAT32 media with two FATs.  */
+        total_sectors =  (pass == 0) ? FAT12_SECTORS : ((pass == 1) ? FAT16_SECTORS : FAT32_SECTORS);
+        status =  fx_media_format(&ram_disk,
+                                _fx_ram_driver,         // Driver entry
+                                ram_disk_memory,        // RAM disk memory pointer
+                                cache_buffer,           // Media buffer pointer
+                                sizeof(cache_buffer),   // Media buffer size
+                                "MY_RAM_DISK",          // Volume Name
+                                (pass == 1) ? 3 : 2,    // Number of FATs
+                                32,                     // Directory Entries
+                                0,                      // Hidden sectors
+                                total_sectors,          // Total sectors
+                                SECTOR_SIZE,            // Sector size
+                                1,                      // Sectors per cluster
+                                1,                      // Heads
+                                1);                     // Sectors per track
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+        return_if_fail(status == FX_SUCCESS);
+        return_if_fail((pass != 0) || (ram_disk.fx_media_12_bit_FAT == FX_TRUE));
+        return_if_fail((pass != 2) || (ram_disk.fx_media_32_bit_FAT == FX_TRUE));
+        entries_per_sector =  (pass == 0) ? (SECTOR_SIZE * 2 / 3) : ((pass == 1) ? (SECTOR_SIZE / 2) : (SECTOR_SIZE / 4));
+
+        /* Write a small file and flush the media.  */
+        status =  fx_file_create(&ram_disk, "A.BIN");
+        status += fx_file_open(&ram_disk, &my_file, "A.BIN", FX_OPEN_FOR_WRITE);
+        status += fx_file_write(&my_file, data_buffer, sizeof(data_buffer));
+        status += fx_file_close(&my_file);
+        status += fx_media_flush(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fat_compare();
+        return_if_fail(status == FX_SUCCESS);
+
+        /* Change the FAT entries of two clusters in FAT sectors far apart.  */
+        for (i = 1; i <= 2; i++)
+        {
+            cluster =  (ram_disk.fx_media_total_clusters / 3) * i;
+            status =  _fx_utility_FAT_entry_write(&ram_disk, cluster, ram_disk.fx_media_fat_last);
+            return_if_fail(status == FX_SUCCESS);
+        }
+        status =  fat_write();
+        return_if_fail(status == FX_SUCCESS);
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+
+        /* Only the two FAT sectors are recorded.  */
+        return_if_fail(ram_disk.fx_media_fat_mirror_ranges == 2);
+        for (i = 0; i < 2; i++)
+        {
+            sectors =  ram_disk.fx_media_fat_mirror_range_end[i] - ram_disk.fx_media_fat_mirror_range_start[i];
+            return_if_fail(sectors == 1);
+        }
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+        driver_write_requests =  ram_disk.fx_media_driver_write_requests;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+        status =  _fx_utility_FAT_map_flush(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+#if defined(FX_ENABLE_FAT_MIRROR_RANGES) && !defined(FX_MEDIA_STATISTICS_DISABLE)
+
+        /* And each is written once to each secondary FAT.  */
+        return_if_fail(ram_disk.fx_media_driver_write_requests - driver_write_requests == 2 * (ram_disk.fx_media_number_of_FATs - 1U));
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES && !FX_MEDIA_STATISTICS_DISABLE */
+        status =  fat_compare();
+        return_if_fail(status == FX_SUCCESS);
+
+        /* Free the clusters again.  */
+        for (i = 1; i <= 2; i++)
+        {
+            cluster =  (ram_disk.fx_media_total_clusters / 3) * i;
+            status =  _fx_utility_FAT_entry_write(&ram_disk, cluster, FX_FREE_CLUSTER);
+            return_if_fail(status == FX_SUCCESS);
+        }
+        status =  fx_media_flush(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fat_compare();
+        return_if_fail(status == FX_SUCCESS);
+
+        /* Allocate a large file, which writes a long run of FAT sectors.  */
+        status =  fx_file_create(&ram_disk, "B.BIN");
+        status += fx_file_open(&ram_disk, &my_file, "B.BIN", FX_OPEN_FOR_WRITE);
+        status += fx_file_allocate(&my_file, ALLOCATE_CLUSTERS * SECTOR_SIZE);
+        status += fx_file_close(&my_file);
+        return_if_fail(status == FX_SUCCESS);
+        status =  fat_write();
+        return_if_fail(status == FX_SUCCESS);
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+
+        /* The FAT sectors of the file are recorded in few ranges.  */
+        return_if_fail((ram_disk.fx_media_fat_mirror_ranges > 0) && (ram_disk.fx_media_fat_mirror_ranges <= 3));
+        sectors =  0;
+        for (i = 0; i < ram_disk.fx_media_fat_mirror_ranges; i++)
+        {
+            sectors +=  ram_disk.fx_media_fat_mirror_range_end[i] - ram_disk.fx_media_fat_mirror_range_start[i];
+        }
+        return_if_fail(sectors >= ALLOCATE_CLUSTERS / entries_per_sector);
+        return_if_fail(sectors <= ALLOCATE_CLUSTERS / entries_per_sector + 4);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+        driver_write_requests =  ram_disk.fx_media_driver_write_requests;
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+        status =  _fx_utility_FAT_map_flush(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+#if defined(FX_ENABLE_FAT_MIRROR_RANGES) && !defined(FX_MEDIA_STATISTICS_DISABLE)
+
+        /* Each secondary FAT is written several sectors at a time.  */
+        return_if_fail(ram_disk.fx_media_driver_write_requests - driver_write_requests <=
+                       (ram_disk.fx_media_number_of_FATs - 1U) * (sectors / (FX_FAT_MIRROR_BUFFER_SIZE / SECTOR_SIZE) + 3));
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES && !FX_MEDIA_STATISTICS_DISABLE */
+        status =  fat_compare();
+        return_if_fail(status == FX_SUCCESS);
+#ifdef FX_ENABLE_FAT_MIRROR_RANGES
+
+        /* Record the FAT sectors of the file again.  A failed read or write of them keeps the range for a retry.  */
+        FAT_start =  ram_disk.fx_media_reserved_sectors;
+        status =  _fx_utility_FAT_map_set(&ram_disk, FAT_start, sectors);
+        return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_fat_mirror_ranges == 1));
+        _fx_utility_logical_sector_read_error_request =  1;
+        status =  _fx_utility_FAT_map_flush(&ram_disk);
+        _fx_utility_logical_sector_read_error_request =  0;
+        return_if_fail((status == FX_IO_ERROR) && (ram_disk.fx_media_fat_mirror_ranges == 1));
+        _fx_utility_logical_sector_write_error_request =  1;
+        status =  _fx_utility_FAT_map_flush(&ram_disk);
+        _fx_utility_logical_sector_write_error_request =  0;
+        return_if_fail((status == FX_IO_ERROR) && (ram_disk.fx_media_fat_mirror_ranges == 1));
+
+        /* Fail each driver request of the multi-sector copy in turn, with the FAT sectors read from the media.  */
+        for (i = 1; ; i++)
+        {
+            status =  _fx_utility_logical_sector_flush(&ram_disk, ((ULONG64) 1), (ULONG64) (ram_disk.fx_media_total_sectors), FX_TRUE);
+            return_if_fail(status == FX_SUCCESS);
+            _fx_ram_driver_io_error_request =  i;
+            status =  _fx_utility_FAT_map_flush(&ram_disk);
+            _fx_ram_driver_io_error_request =  0;
+            if (status == FX_SUCCESS)
+                break;
+            return_if_fail((status == FX_IO_ERROR) && (ram_disk.fx_media_fat_mirror_ranges == 1));
+        }
+        return_if_fail((i > 2) && (ram_disk.fx_media_fat_mirror_ranges == 0));
+        status =  fat_compare();
+        return_if_fail(status == FX_SUCCESS);
+
+        /* Adjacent and overlapping ranges are merged.  */
+        status =  _fx_utility_FAT_map_set(&ram_disk, FAT_start + 3, 1);
+        status += _fx_utility_FAT_map_set(&ram_disk, FAT_start + 10, 1);
+        status += _fx_utility_FAT_map_set(&ram_disk, FAT_start + 4, 2);
+        return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_fat_mirror_ranges == 2));
+        status =  _fx_utility_FAT_map_set(&ram_disk, FAT_start + 5, 5);
+        return_if_fail((status == FX_SUCCESS) && (ram_disk.fx_media_fat_mirror_ranges == 1));
+        return_if_fail(ram_disk.fx_media_fat_mirror_range_start[0] == FAT_start + 3);
+        return_if_fail(ram_disk.fx_media_fat_mirror_range_end[0] == FAT_start + 11);
+
+        /* A full list extends the closest range, and every sector stays covered.  */
+        for (i = 0; i < FX_FAT_MIRROR_RANGES + 4; i++)
+        {
+            status =  _fx_utility_FAT_map_set(&ram_disk, FAT_start + 20 + 3 * i, 1);
+            return_if_fail(status == FX_SUCCESS);
+        }
+        return_if_fail(ram_disk.fx_media_fat_mirror_ranges == FX_FAT_MIRROR_RANGES);
+        for (i = 1; i < ram_disk.fx_media_fat_mirror_ranges; i++)
+        {
+            return_if_fail(ram_disk.fx_media_fat_mirror_range_end[i - 1] < ram_disk.fx_media_fat_mirror_range_start[i]);
+        }
+        for (i = 0; i < FX_FAT_MIRROR_RANGES + 4; i++)
+        {
+            for (cluster = 0; cluster < ram_disk.fx_media_fat_mirror_ranges; cluster++)
+            {
+                if ((ram_disk.fx_media_fat_mirror_range_start[cluster] <= FAT_start + 20 + 3 * i) &&
+                    (ram_disk.fx_media_fat_mirror_range_end[cluster] > FAT_start + 20 + 3 * i))
+                    break;
+            }
+            return_if_fail(cluster < ram_disk.fx_media_fat_mirror_ranges);
+        }
+
+        /* The ranges above were not written, so drop them rather than mirror them.  */
+        ram_disk.fx_media_fat_mirror_ranges =  0;
+#endif /* FX_ENABLE_FAT_MIRROR_RANGES */
+
+        /* The FATs still match after the media is closed and opened again.  */
+        status =  fx_file_open(&ram_disk, &my_file, "A.BIN", FX_OPEN_FOR_WRITE);
+        status += fx_file_seek(&my_file, 0);
+        status += fx_file_truncate_release(&my_file, SECTOR_SIZE);
+        status += fx_file_close(&my_file);
+        status += fx_media_close(&ram_disk);
+        status += fx_media_open(&ram_disk, "RAM DISK", _fx_ram_driver, ram_disk_memory, cache_buffer, sizeof(cache_buffer));
+        return_if_fail(status == FX_SUCCESS);
+        status =  fat_compare();
+        return_if_fail(status == FX_SUCCESS);
+        status =  fx_file_open(&ram_disk, &my_file, "A.BIN", FX_OPEN_FOR_READ);
+        status += fx_file_read(&my_file, data_buffer, sizeof(data_buffer), &actual);
+        return_if_fail((status == FX_SUCCESS) && (actual == SECTOR_SIZE));
+        status =  fx_file_close(&my_file);
+        status += fx_media_close(&ram_disk);
+        return_if_fail(status == FX_SUCCESS);
+    }
+
+    printf("SUCCESS!\n");
+    test_control_return(0);
+}
@@ -259,6 +259,80 @@ ULONG partition_size;
 }
 
 
+/* Count the free FAT entries one at a time and compare with the counting utility.  */
+
+static UCHAR                    FAT_buffer[512 + 8];
+
+static void    FAT_free_entries_test(void)
+{
+
+UINT    entry_size;
+ULONG   offset;
+ULONG   entries;
+ULONG   index;
+ULONG   entry;
+ULONG   free_entries;
+ULONG   first_free;
+ULONG   expected_free_entries;
+ULONG   expected_first_free;
+ULONG   seed;
+
+    for (entry_size = 2; entry_size <= 4; entry_size = entry_size + 2)
+    {
+        for (offset = 0; offset < 8; offset = offset + entry_size)
+        {
+
+            /* Fill the FAT with runs of free and used entries. Some used 32-bit entries
+               only have the reserved bits set, which makes them free.  */
+            seed = 12345 + offset + entry_size;
+            for (index = 0; index < 512; index++)
+            {
+                seed = seed * 1103515245 + 12345;
+                FAT_buffer[index] = ((seed >> 16) & 0x7) ? 0 : (UCHAR)(seed >> 24);
+            }
+            for (index = 64 * entry_size; index < 128 * entry_size; index++)
+            {
+                FAT_buffer[index] = 0;
+            }
+            for (index = 200 * entry_size; index < 256 * entry_size; index++)
+            {
+                FAT_buffer[index] = 0xF0;
+            }
+
+            for (entries = 0; entries <= (512 - offset) / entry_size; entries++)
+            {
+
+                /* Count the free entries one at a time.  */
+                expected_free_entries = 0;
+                expected_first_free = entries;
+                for (index = 0; index < entries; index++)
+                {
+                    if (entry_size == 4)
+                    {
+                        entry = _fx_utility_32_unsigned_read(&FAT_buffer[offset + index * 4]) & 0x0FFFFFFF;
+                    }
+                    else
+                    {
+                        entry = _fx_utility_16_unsigned_read(&FAT_buffer[offset + index * 2]);
+                    }
+                    if (entry == FX_FREE_CLUSTER)
+                    {
+                        if (expected_free_entries == 0)
+                        {
+                            expected_first_free = index;
+                        }
+                        expected_free_entries++;
+                    }
+                }
+
+                free_entries = _fx_utility_FAT_free_entries_count(&FAT_buffer[offset], entries, entry_size, &first_free);
+                return_if_fail(free_entries == expected_free_entries);
+                return_if_fail(first_free == expected_first_free);
+            }
+        }
+    }
+}
+
 /* Define the test threads.  */
 
 static void    ftest_0_entry(ULONG thread_input)
@@ -851,6 +925,9 @@ ULONG       temp6;
     FAT_sector = _fx_utility_FAT_sector_get(&tmp_media, 400);
     return_if_fail(3 == FAT_sector);
 
+    /* Tests for utility_FAT_free_entries_count. */
+    FAT_free_entries_test();
+
     no_partition_test();
 
     printf("SUCCESS!\n");
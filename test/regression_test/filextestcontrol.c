@@ -176,8 +176,23 @@ void    filex_media_multiple_format_open_close_application_define(void *first_un
 void    filex_media_flush_application_define(void *first_unused_memory);
 void    filex_media_abort_application_define(void *first_unused_memory);
 void    filex_media_cache_invalidate_application_define(void *first_unused_memory);
+void    filex_media_cache_resize_application_define(void *first_unused_memory);
+void    filex_media_cache_pool_application_define(void *first_unused_memory);
+void    filex_media_writeback_application_define(void *first_unused_memory);
+void    filex_media_cluster_bitmap_application_define(void *first_unused_memory);
+void    filex_media_lazy_free_count_application_define(void *first_unused_memory);
+void    filex_media_fat_cache_configure_application_define(void *first_unused_memory);
+void    filex_media_fat_mirror_defer_application_define(void *first_unused_memory);
+void    filex_media_exfat_bitmap_cache_configure_application_define(void *first_unused_memory);
+void    filex_file_exfat_cluster_reservation_application_define(void *first_unused_memory);
+void    filex_media_defragment_application_define(void *first_unused_memory);
 void    filex_media_volume_get_set_application_define(void *first_unused_memory);
 void    filex_media_read_write_sector_application_define(void *first_unused_memory);
+void    filex_media_sector_cache_lru_application_define(void *first_unused_memory);
+void    filex_media_sector_cache_scan_resistant_application_define(void *first_unused_memory);
+void    filex_media_sector_cache_partition_application_define(void *first_unused_memory);
+void    filex_media_sector_flush_coalesce_application_define(void *first_unused_memory);
+void    filex_media_async_driver_application_define(void *first_unused_memory);
 void    filex_media_check_application_define(void *first_unused_memory);
 void    filex_media_hidden_sectors_test_application_define(void *first_unused_memory);
 void    filex_system_date_time_application_define(void *first_unused_memory);
@@ -193,6 +208,12 @@ void    filex_directory_attributes_read_set_application_define(void *first_unuse
 void    filex_file_create_delete_application_define(void *first_unused_memory);
 void    filex_file_naming_application_define(void *first_unused_memory);
 void    filex_file_read_write_application_define(void *first_unused_memory);
+void    filex_file_read_ahead_application_define(void *first_unused_memory);
+void    filex_file_write_buffer_application_define(void *first_unused_memory);
+void    filex_file_delayed_allocation_application_define(void *first_unused_memory);
+void    filex_file_scatter_gather_application_define(void *first_unused_memory);
+void    filex_file_read_borrow_application_define(void *first_unused_memory);
+void    filex_file_extent_map_application_define(void *first_unused_memory);
 void    filex_file_write_seek_application_define(void *first_unused_memory);
 void    filex_file_name_application_define(void *first_unused_memory);
 void    filex_file_write_notify_application_define(void *first_unused_memory);
@@ -246,7 +267,10 @@ void    filex_file_attributes_read_set_exfat_application_define(void *first_unus
 void    filex_file_date_time_set_exfat_application_define(void *first_unused_memory);
 void    filex_file_rename_exfat_application_define(void *first_unused_memory);
 void    filex_utility_application_define(void *first_unused_memory);
+void    filex_utility_fat_chain_read_application_define(void *first_unused_memory);
+void    filex_utility_fat_chain_write_application_define(void *first_unused_memory);
 void    filex_utility_fat_flush_application_define(void *first_unused_memory);
+void    filex_utility_fat_map_flush_application_define(void *first_unused_memory);
 void    filex_bitmap_flush_exfat_application_define(void *first_unused_memory);
 void    test_application_define(void *first_unused_memory);
 
@@ -351,9 +375,24 @@ TEST_ENTRY  test_control_tests[] =
     {filex_media_flush_application_define, TEST_TIMEOUT_LOW},
     {filex_media_abort_application_define, TEST_TIMEOUT_LOW},
     {filex_media_cache_invalidate_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_cache_resize_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_cache_pool_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_writeback_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_cluster_bitmap_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_lazy_free_count_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_fat_cache_configure_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_fat_mirror_defer_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_exfat_bitmap_cache_configure_application_define, TEST_TIMEOUT_LOW},
+    {filex_file_exfat_cluster_reservation_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_defragment_application_define, TEST_TIMEOUT_LOW},
     {filex_media_volume_directory_entry_application_define, TEST_TIMEOUT_LOW},
     {filex_media_volume_get_set_application_define, TEST_TIMEOUT_LOW},
     {filex_media_read_write_sector_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_sector_cache_lru_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_sector_cache_scan_resistant_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_sector_cache_partition_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_sector_flush_coalesce_application_define, TEST_TIMEOUT_LOW},
+    {filex_media_async_driver_application_define, TEST_TIMEOUT_LOW},
     {filex_media_check_application_define, TEST_TIMEOUT_LOW},
     {filex_media_hidden_sectors_test_application_define, TEST_TIMEOUT_LOW},
     {filex_system_date_time_application_define, TEST_TIMEOUT_LOW},
@@ -372,6 +411,12 @@ TEST_ENTRY  test_control_tests[] =
     {filex_file_naming_application_define, TEST_TIMEOUT_LOW},
 #if 1
     {filex_file_read_write_application_define, TEST_TIMEOUT_LOW},
+    {filex_file_read_ahead_application_define, TEST_TIMEOUT_LOW},
+    {filex_file_write_buffer_application_define, TEST_TIMEOUT_LOW},
+    {filex_file_delayed_allocation_application_define, TEST_TIMEOUT_LOW},
+    {filex_file_scatter_gather_application_define, TEST_TIMEOUT_LOW},
+    {filex_file_read_borrow_application_define, TEST_TIMEOUT_LOW},
+    {filex_file_extent_map_application_define, TEST_TIMEOUT_LOW},
     {filex_file_write_seek_application_define, TEST_TIMEOUT_LOW},
     {filex_file_name_application_define, TEST_TIMEOUT_LOW},
     {filex_file_write_notify_application_define, TEST_TIMEOUT_LOW},
@@ -430,7 +475,10 @@ TEST_ENTRY  test_control_tests[] =
     {filex_bitmap_flush_exfat_application_define, TEST_TIMEOUT_LOW},
 #endif /* FX_ENABLE_EXFAT */
     {filex_utility_application_define, TEST_TIMEOUT_LOW},
+    {filex_utility_fat_chain_read_application_define, TEST_TIMEOUT_LOW},
+    {filex_utility_fat_chain_write_application_define, TEST_TIMEOUT_LOW},
     {filex_utility_fat_flush_application_define, TEST_TIMEOUT_LOW},
+    {filex_utility_fat_map_flush_application_define, TEST_TIMEOUT_LOW},
     
 #endif /* CTEST */
     {FX_NULL, TEST_TIMEOUT_LOW}
@@ -0,0 +1,365 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Asynchronous RAM Disk Driver                                        */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+
+/* This is the reference driver for the asynchronous driver interface. It uses
+   the RAM disk of _fx_ram_driver and a few Linux threads that play the role of
+   the DMA channels of a device. FX_DRIVER_ASYNC_SUBMIT only queues the request,
+   a worker thread copies the sectors after _fx_ram_driver_async_latency
+   microseconds and FX_DRIVER_ASYNC_WAIT returns the requests in the order they
+   complete. All other requests are passed on to _fx_ram_driver. The driver
+   serves one media at a time.  */
+
+#define _POSIX_C_SOURCE 200809L
+
+/* Include necessary system files.  */
+
+#ifndef FX_STANDALONE_ENABLE
+#include "tx_api.h"
+#endif
+#include "fx_api.h"
+#include "fx_utility.h"
+#include "fx_ram_driver_test.h"
+
+#ifdef FX_ENABLE_ASYNC_DRIVER
+#include <pthread.h>
+#include <time.h>
+
+
+/* Define the number of requests the device processes in parallel.  */
+#define FX_RAM_DRIVER_ASYNC_WORKERS     4
+
+
+/* Define the settings and statistics for tests. Requests that include
+   _fx_ram_driver_async_error_sector fail, unless it is zero.  */
+
+ULONG   _fx_ram_driver_async_latency;
+ULONG   _fx_ram_driver_async_max_outstanding;
+ULONG64 _fx_ram_driver_async_error_sector;
+
+
+/* Define the state of the driver.  */
+
+static pthread_mutex_t          _fx_ram_driver_async_lock =  PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t           _fx_ram_driver_async_submitted =  PTHREAD_COND_INITIALIZER;
+static pthread_cond_t           _fx_ram_driver_async_completed =  PTHREAD_COND_INITIALIZER;
+static pthread_t                _fx_ram_driver_async_workers[FX_RAM_DRIVER_ASYNC_WORKERS];
+static UINT                     _fx_ram_driver_async_running;
+static ULONG                    _fx_ram_driver_async_outstanding;
+static FX_MEDIA                *_fx_ram_driver_async_media;
+static FX_DRIVER_REQUEST       *_fx_ram_driver_async_queue_head;
+static FX_DRIVER_REQUEST       *_fx_ram_driver_async_queue_tail;
+static FX_DRIVER_REQUEST       *_fx_ram_driver_async_done_head;
+static FX_DRIVER_REQUEST       *_fx_ram_driver_async_done_tail;
+
+
+VOID  _fx_ram_driver(FX_MEDIA *media_ptr);
+VOID  _fx_ram_driver_async(FX_MEDIA *media_ptr);
+
+
+/* Simulate the time the device needs for a request.  */
+
+static VOID  _fx_ram_driver_async_delay(VOID)
+{
+
+struct timespec delay;
+
+
+    if (_fx_ram_driver_async_latency)
+    {
+        delay.tv_sec =   (time_t)(_fx_ram_driver_async_latency / 1000000);
+        delay.tv_nsec =  (long)((_fx_ram_driver_async_latency % 1000000) * 1000);
+        nanosleep(&delay, NULL);
+    }
+}
+
+
+/* Copy the sectors of a request between the RAM disk and the buffer.  */
+
+static UINT  _fx_ram_driver_async_transfer(FX_MEDIA *media_ptr, FX_DRIVER_REQUEST *request_ptr)
+{
+
+UCHAR  *sector_ptr;
+ULONG   bytes;
+
+
+    /* Determine if this request should fail.  */
+    if ((_fx_ram_driver_async_error_sector) &&
+        (_fx_ram_driver_async_error_sector >= request_ptr -> fx_driver_request_logical_sector) &&
+        (_fx_ram_driver_async_error_sector < (request_ptr -> fx_driver_request_logical_sector + request_ptr -> fx_driver_request_sectors)))
+    {
+        return(FX_IO_ERROR);
+    }
+
+    /* Calculate the RAM disk address of the sectors.  */
+    sector_ptr =  ((UCHAR *)media_ptr -> fx_media_driver_info) +
+                  ((request_ptr -> fx_driver_request_logical_sector + media_ptr -> fx_media_hidden_sectors) * media_ptr -> fx_media_bytes_per_sector);
+    bytes =  request_ptr -> fx_driver_request_sectors * media_ptr -> fx_media_bytes_per_sector;
+
+    /* Copy the sectors.  */
+    if (request_ptr -> fx_driver_request_type == FX_DRIVER_READ)
+    {
+        _fx_utility_memory_copy(sector_ptr, request_ptr -> fx_driver_request_buffer, bytes);
+    }
+    else if (request_ptr -> fx_driver_request_type == FX_DRIVER_WRITE)
+    {
+        _fx_utility_memory_copy(request_ptr -> fx_driver_request_buffer, sector_ptr, bytes);
+    }
+    else
+    {
+        return(FX_IO_ERROR);
+    }
+
+    return(FX_SUCCESS);
+}
+
+
+/* Process the queued requests, like one DMA channel of the device.  */
+
+static void  *_fx_ram_driver_async_worker(void *thread_input)
+{
+
+FX_DRIVER_REQUEST  *request_ptr;
+UINT                status;
+
+
+    FX_PARAMETER_NOT_USED(thread_input);
+
+    pthread_mutex_lock(&_fx_ram_driver_async_lock);
+    for (;;)
+    {
+
+        /* Wait for the next request.  */
+        while ((_fx_ram_driver_async_running) && (_fx_ram_driver_async_queue_head == FX_NULL))
+        {
+            pthread_cond_wait(&_fx_ram_driver_async_submitted, &_fx_ram_driver_async_lock);
+        }
+        if (_fx_ram_driver_async_running == FX_FALSE)
+        {
+            break;
+        }
+
+        /* Remove the request from the queue.  */
+        request_ptr =  _fx_ram_driver_async_queue_head;
+        _fx_ram_driver_async_queue_head =  request_ptr -> fx_driver_request_next;
+        if (_fx_ram_driver_async_queue_head == FX_NULL)
+        {
+            _fx_ram_driver_async_queue_tail =  FX_NULL;
+        }
+
+        /* Perform the transfer without holding the lock.  */
+        pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+        _fx_ram_driver_async_delay();
+        status =  _fx_ram_driver_async_transfer(_fx_ram_driver_async_media, request_ptr);
+        pthread_mutex_lock(&_fx_ram_driver_async_lock);
+
+        /* Place the request on the list of completed requests.  */
+        request_ptr -> fx_driver_request_status =  status;
+        request_ptr -> fx_driver_request_next =  FX_NULL;
+        if (_fx_ram_driver_async_done_tail)
+        {
+            _fx_ram_driver_async_done_tail -> fx_driver_request_next =  request_ptr;
+        }
+        else
+        {
+            _fx_ram_driver_async_done_head =  request_ptr;
+        }
+        _fx_ram_driver_async_done_tail =  request_ptr;
+        pthread_cond_signal(&_fx_ram_driver_async_completed);
+    }
+    pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+
+    return(NULL);
+}
+
+
+/* Start the worker threads.  */
+
+static UINT  _fx_ram_driver_async_start(FX_MEDIA *media_ptr)
+{
+
+UINT    i;
+
+
+    /* Determine if the workers are already running, which is the case after a format.  */
+    pthread_mutex_lock(&_fx_ram_driver_async_lock);
+    _fx_ram_driver_async_media =  media_ptr;
+    if (_fx_ram_driver_async_running)
+    {
+        pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+        return(FX_SUCCESS);
+    }
+    _fx_ram_driver_async_running =      FX_TRUE;
+    _fx_ram_driver_async_outstanding =  0;
+    _fx_ram_driver_async_queue_head =   FX_NULL;
+    _fx_ram_driver_async_queue_tail =   FX_NULL;
+    _fx_ram_driver_async_done_head =    FX_NULL;
+    _fx_ram_driver_async_done_tail =    FX_NULL;
+    pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+
+    for (i = 0; i < FX_RAM_DRIVER_ASYNC_WORKERS; i++)
+    {
+        if (pthread_create(&_fx_ram_driver_async_workers[i], NULL, _fx_ram_driver_async_worker, NULL))
+        {
+            return(FX_IO_ERROR);
+        }
+    }
+
+    return(FX_SUCCESS);
+}
+
+
+/* Stop the worker threads.  */
+
+static VOID  _fx_ram_driver_async_stop(VOID)
+{
+
+UINT    i;
+
+
+    pthread_mutex_lock(&_fx_ram_driver_async_lock);
+    if (_fx_ram_driver_async_running == FX_FALSE)
+    {
+        pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+        return;
+    }
+    _fx_ram_driver_async_running =  FX_FALSE;
+    pthread_cond_broadcast(&_fx_ram_driver_async_submitted);
+    pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+
+    for (i = 0; i < FX_RAM_DRIVER_ASYNC_WORKERS; i++)
+    {
+        pthread_join(_fx_ram_driver_async_workers[i], NULL);
+    }
+}
+
+
+VOID  _fx_ram_driver_async(FX_MEDIA *media_ptr)
+{
+
+FX_DRIVER_REQUEST  *request_ptr;
+
+
+    /* Process the driver request specified in the media control block.  */
+    switch (media_ptr -> fx_media_driver_request)
+    {
+
+    case FX_DRIVER_ASYNC_SUBMIT:
+    {
+
+        /* Queue the request for the worker threads and return right away.  */
+        request_ptr =  media_ptr -> fx_media_driver_async_request;
+        request_ptr -> fx_driver_request_next =  FX_NULL;
+        pthread_mutex_lock(&_fx_ram_driver_async_lock);
+        if (_fx_ram_driver_async_queue_tail)
+        {
+            _fx_ram_driver_async_queue_tail -> fx_driver_request_next =  request_ptr;
+        }
+        else
+        {
+            _fx_ram_driver_async_queue_head =  request_ptr;
+        }
+        _fx_ram_driver_async_queue_tail =  request_ptr;
+        _fx_ram_driver_async_outstanding++;
+        if (_fx_ram_driver_async_outstanding > _fx_ram_driver_async_max_outstanding)
+        {
+            _fx_ram_driver_async_max_outstanding =  _fx_ram_driver_async_outstanding;
+        }
+        pthread_cond_signal(&_fx_ram_driver_async_submitted);
+        pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+
+        media_ptr -> fx_media_driver_status =  FX_SUCCESS;
+        break;
+    }
+
+    case FX_DRIVER_ASYNC_WAIT:
+    {
+
+        /* Wait for the next completed request.  */
+        pthread_mutex_lock(&_fx_ram_driver_async_lock);
+        if (_fx_ram_driver_async_outstanding == 0)
+        {
+            pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+            media_ptr -> fx_media_driver_status =  FX_IO_ERROR;
+            break;
+        }
+        while (_fx_ram_driver_async_done_head == FX_NULL)
+        {
+            pthread_cond_wait(&_fx_ram_driver_async_completed, &_fx_ram_driver_async_lock);
+        }
+        request_ptr =  _fx_ram_driver_async_done_head;
+        _fx_ram_driver_async_done_head =  request_ptr -> fx_driver_request_next;
+        if (_fx_ram_driver_async_done_head == FX_NULL)
+        {
+            _fx_ram_driver_async_done_tail =  FX_NULL;
+        }
+        _fx_ram_driver_async_outstanding--;
+        pthread_mutex_unlock(&_fx_ram_driver_async_lock);
+
+        /* Return the completed request to FileX.  */
+        media_ptr -> fx_media_driver_async_request =  request_ptr;
+        media_ptr -> fx_media_driver_status =  FX_SUCCESS;
+        break;
+    }
+
+    case FX_DRIVER_INIT:
+    {
+
+        /* Initialize the RAM disk, then start the worker threads.  */
+        _fx_ram_driver(media_ptr);
+        if (media_ptr -> fx_media_driver_status == FX_SUCCESS)
+        {
+            media_ptr -> fx_media_driver_status =  _fx_ram_driver_async_start(media_ptr);
+            media_ptr -> fx_media_driver_async_supported =  FX_TRUE;
+        }
+        break;
+    }
+
+    case FX_DRIVER_UNINIT:
+    {
+
+        /* Stop the worker threads.  */
+        _fx_ram_driver_async_stop();
+        _fx_ram_driver(media_ptr);
+        break;
+    }
+
+    case FX_DRIVER_READ:
+    case FX_DRIVER_WRITE:
+    {
+
+        /* Synchronous requests take as long as asynchronous requests.  */
+        _fx_ram_driver_async_delay();
+        _fx_ram_driver(media_ptr);
+        break;
+    }
+
+    default:
+    {
+
+        /* Pass all other requests on to the RAM driver.  */
+        _fx_ram_driver(media_ptr);
+        break;
+    }
+    }
+}
+#endif /* FX_ENABLE_ASYNC_DRIVER */
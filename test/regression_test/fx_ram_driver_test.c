@@ -206,6 +206,10 @@ UCHAR       *data_start;
 UINT        op = FX_OP_WRITE_NORMALLY; 
 UINT        status;    
 UINT        i;
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+UINT        request;
+ULONG       error_request;
+#endif
 #ifdef MEDIA_ATOMIC_OPERATION_BLOCK  
 UCHAR       *block_start;           
 UCHAR       buffer[BUFFER_SIZE];
@@ -236,6 +240,8 @@ UINT        offset;
                                                     FX_DRIVER_RELEASE_SECTORS
                                                     FX_DRIVER_BOOT_WRITE
                                                     FX_DRIVER_UNINIT
+                                                    FX_DRIVER_SCATTER_READ
+                                                    FX_DRIVER_GATHER_WRITE
 
         fx_media_driver_status              This value is RETURNED by the driver. If the 
                                             operation is successful, this field should be
@@ -485,6 +491,33 @@ UINT        offset;
             break;
         }
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+        case FX_DRIVER_SCATTER_READ:
+        case FX_DRIVER_GATHER_WRITE:
+        {
+
+            /* Perform each segment as a read or write request, so the write callback and the
+               atomic block logic apply to every segment. The segments are part of this request
+               and do not count as requests for the error generation logic.  */
+            request =  media_ptr -> fx_media_driver_request;
+            error_request =  _fx_ram_driver_io_error_request;
+            _fx_ram_driver_io_error_request =  0;
+            media_ptr -> fx_media_driver_status =  FX_SUCCESS;
+            for (i = 0; (i < media_ptr -> fx_media_driver_segments) && (media_ptr -> fx_media_driver_status == FX_SUCCESS); i++)
+            {
+                media_ptr -> fx_media_driver_request =  (request == FX_DRIVER_SCATTER_READ) ? FX_DRIVER_READ : FX_DRIVER_WRITE;
+                media_ptr -> fx_media_driver_logical_sector =  media_ptr -> fx_media_driver_segment_list[i].fx_driver_segment_logical_sector;
+                media_ptr -> fx_media_driver_buffer =  media_ptr -> fx_media_driver_segment_list[i].fx_driver_segment_buffer;
+                media_ptr -> fx_media_driver_sectors =  media_ptr -> fx_media_driver_segment_list[i].fx_driver_segment_sectors;
+                _fx_ram_driver(media_ptr);
+                _fx_ram_driver_io_request_count--;
+            }
+            media_ptr -> fx_media_driver_request =  request;
+            _fx_ram_driver_io_error_request =  error_request;
+            break;
+        }
+#endif /* FX_ENABLE_SCATTER_GATHER_DRIVER */
+
         case FX_DRIVER_FLUSH:
         {
 
@@ -537,6 +570,11 @@ UINT        offset;
             driver_fault_tolerant_enable_callback = FX_NULL;
             driver_fault_tolerant_apply_log_callback = FX_NULL;
 
+#ifdef FX_ENABLE_SCATTER_GATHER_DRIVER
+            /* Accept scatter-gather requests.  */
+            media_ptr -> fx_media_driver_scatter_gather_supported =  FX_TRUE;
+#endif
+
             /* Successful driver request.  */
             media_ptr -> fx_media_driver_status =  FX_SUCCESS;
             break;